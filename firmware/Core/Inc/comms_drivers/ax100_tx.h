@@ -5,6 +5,8 @@
 
 extern uint32_t AX100_enable_downlink_uart_logs;
 extern uint32_t AX100_enable_downlink_inhibited_uart_logs;
+extern uint32_t AX100_tx_dma_enabled;
+extern uint32_t AX100_tx_send_error_count;
 
 /// @brief The maximum number of CTS bytes that can be sent to the AX100 in a single downlink packet.
 /// @note This value does not include the CSP header (4 bytes), but DOES include any CTS-SAT-1 header bytes (e.g., sequence numbers).
@@ -12,6 +14,16 @@ extern uint32_t AX100_enable_downlink_inhibited_uart_logs;
 
 #define AX100_CSP_HEADER_LENGTH_BYTES 4
 
+uint8_t *AX100_acquire_tx_buffer(void);
+void AX100_release_tx_buffer(uint8_t *payload);
+uint8_t AX100_start_tx_buffer(uint8_t *payload, uint16_t payload_len);
+uint8_t AX100_finish_tx_buffer(uint8_t *payload);
+uint8_t AX100_send_tx_buffer(uint8_t *payload, uint16_t payload_len);
+uint8_t AX100_flush_tx_buffers(void);
+void AX100_wait_for_tx_idle(void);
+
 uint8_t AX100_downlink_bytes(uint8_t *data, uint16_t data_len);
 
+uint32_t AX100_get_tx_pacing_wait_ms(void);
+
 #endif // INCLUDE_GUARD__AX100_TX_H__
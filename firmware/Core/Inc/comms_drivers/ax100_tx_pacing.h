@@ -0,0 +1,82 @@
+#ifndef INCLUDE_GUARD__AX100_TX_PACING_H__
+#define INCLUDE_GUARD__AX100_TX_PACING_H__
+
+#include <stdint.h>
+
+extern uint32_t AX100_tx_pacing_enabled;
+extern uint32_t AX100_tx_bitrate_bps;
+extern uint32_t AX100_tx_overhead_bytes_per_packet;
+extern uint32_t AX100_tx_pacing_max_queued_ms;
+extern uint32_t AX100_tx_stall_i2c_duration_ms;
+extern uint32_t AX100_tx_pacing_probe_after_clean_sends;
+
+/// @brief Bounds of the learned airtime scale (learned airtime / modelled airtime), in permille.
+#define AX100_TX_PACING_MIN_RATE_SCALE_PERMILLE 250
+#define AX100_TX_PACING_MAX_RATE_SCALE_PERMILLE 4000
+
+/// @brief Steps of the learned scale: increased by 1/32 (about 3%) after a stall, and decreased by
+///     1/64 (about 1.6%) by each probe for a faster rate.
+#define AX100_TX_PACING_STALL_STEP_DIVISOR 32
+#define AX100_TX_PACING_PROBE_STEP_DIVISOR 64
+
+/// @brief After a failed probe, the clean sends needed before the next probe are multiplied by
+///     this, up to `AX100_TX_PACING_MAX_PROBE_GATE_SENDS` (about 7 minutes of sending at 9600 bps).
+#define AX100_TX_PACING_PROBE_BACKOFF_FACTOR 8
+#define AX100_TX_PACING_MAX_PROBE_GATE_SENDS 2048
+
+/// @brief Clean sends after which a scale is trusted, and a later stall is blamed on the probes
+///     since. A too-fast probe takes about 100 sends to fill the AX100's queue.
+#define AX100_TX_PACING_CONFIRM_SENDS 128
+
+/// @brief Length of the window over which the achieved packet rate is measured.
+#define AX100_TX_PACING_RATE_WINDOW_MS 10000
+
+typedef struct {
+    uint32_t packets_sent;
+    uint32_t bytes_sent; // Including the CSP header.
+
+    /// @brief I2C transfers to the AX100 which failed or were slow (radio queue full).
+    uint32_t stall_count;
+    /// @brief Stalls which were I2C errors (the packet was not accepted).
+    uint32_t i2c_error_count;
+    /// @brief Number of times `AX100_tx_pacing_get_wait_ms` asked a sender to wait.
+    uint32_t wait_count;
+
+    /// @brief Steps towards a faster rate, and those which were undone by a stall.
+    uint32_t probe_count;
+    uint32_t failed_probe_count;
+
+    /// @brief Clean sends needed before the next probe (grows with failed probes).
+    uint32_t probe_gate_sends;
+
+    /// @brief Learned airtime / modelled airtime, in permille. 1000 means the radio drains at
+    ///     exactly `AX100_tx_bitrate_bps` with `AX100_tx_overhead_bytes_per_packet`.
+    uint32_t rate_scale_permille;
+
+    /// @brief Airtime still queued in the radio, per the model, in ms.
+    uint32_t queued_ms;
+
+    uint32_t last_i2c_duration_ms;
+    uint32_t max_i2c_duration_ms;
+
+    /// @brief Packets per second (x100), over the last complete `AX100_TX_PACING_RATE_WINDOW_MS`.
+    uint32_t achieved_packets_per_sec_x100;
+} AX100_tx_pacing_stats_t;
+
+void AX100_tx_pacing_reset(void);
+
+uint32_t AX100_tx_pacing_get_packet_airtime_us(uint16_t packet_size_bytes);
+
+void AX100_tx_pacing_record_send(
+    uint16_t packet_size_bytes, uint32_t start_ms, uint32_t end_ms, uint8_t i2c_failed
+);
+
+uint32_t AX100_tx_pacing_get_wait_ms(uint32_t now_ms);
+
+void AX100_tx_pacing_get_stats(uint32_t now_ms, AX100_tx_pacing_stats_t *stats_out);
+
+int16_t AX100_tx_pacing_stats_to_json(
+    const AX100_tx_pacing_stats_t *stats, char json_output_buf[], uint16_t json_output_buf_size
+);
+
+#endif // INCLUDE_GUARD__AX100_TX_PACING_H__
@@ -5,6 +5,7 @@
 
 #include "littlefs/lfs.h" // For lfs_file_t type.
 #include "littlefs/littlefs_constants.h"
+#include "comms_drivers/comms_tx.h" // For `COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET`.
 
 typedef enum {
     COMMS_BULK_FILE_DOWNLINK_STATE_IDLE,
@@ -12,6 +13,30 @@ typedef enum {
     COMMS_BULK_FILE_DOWNLINK_STATE_PAUSED,
 } COMMS_bulk_file_downlink_state_enum_t;
 
+// Largest downlink (1 MB), for safety (to avoid a very very long-running downlink chain).
+#define COMMS_BULK_FILE_DOWNLINK_MAX_TOTAL_BYTES 1000000
+
+#define COMMS_BULK_FILE_DOWNLINK_MAX_TOTAL_SEQ_NUM ( \
+    (COMMS_BULK_FILE_DOWNLINK_MAX_TOTAL_BYTES + COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET - 1) \
+    / COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET \
+)
+
+#define COMMS_BULK_FILE_DOWNLINK_COMPRESSED_HEADER_VERSION 1
+
+#pragma pack(push, 1)
+/// @brief Header at the start of a compressed bulk downlink stream (i.e., at compressed offset 0).
+/// @details The rest of the stream is the heatshrink-compressed file data.
+typedef struct {
+    char magic[2]; // "HS"
+    uint8_t version; // COMMS_BULK_FILE_DOWNLINK_COMPRESSED_HEADER_VERSION
+    uint8_t window_sz2; // Heatshrink window size (log2), needed to decompress.
+    uint8_t lookahead_sz2; // Heatshrink lookahead size (log2), needed to decompress.
+    uint8_t reserved;
+    uint32_t source_start_offset; // Offset in the file of the first byte compressed.
+    uint32_t source_byte_count; // Number of file bytes compressed (i.e., the decompressed length).
+} COMMS_bulk_file_downlink_compressed_header_t;
+#pragma pack(pop)
+
 
 extern char COMMS_bulk_file_downlink_file_path[LFS_MAX_PATH_LENGTH];
 extern uint32_t COMMS_bulk_file_downlink_absolute_start_offset;
@@ -22,10 +47,46 @@ extern uint16_t COMMS_bulk_file_downlink_next_seq_num;
 extern uint16_t COMMS_bulk_file_downlink_total_seq_num;
 extern COMMS_bulk_file_downlink_state_enum_t COMMS_bulk_file_downlink_state;
 extern lfs_file_t COMMS_bulk_file_downlink_file;
+extern uint8_t COMMS_bulk_file_downlink_file_is_open;
+extern uint8_t COMMS_bulk_file_downlink_is_compressed;
+extern uint16_t COMMS_bulk_file_downlink_transfer_id;
+extern uint16_t COMMS_bulk_file_downlink_nack_pending_count;
+extern uint32_t COMMS_bulk_file_downlink_retransmit_count;
+extern uint32_t COMMS_bulk_file_downlink_prefetch_enabled;
 
 
+void COMMS_bulk_file_downlink_lock(void);
+void COMMS_bulk_file_downlink_unlock(void);
+
 int32_t COMMS_bulk_file_downlink_start(char *file_path, uint32_t start_offset, uint32_t max_bytes);
 
+int32_t COMMS_bulk_file_downlink_read_next_packet(
+    uint8_t dest[], uint16_t *seq_num_out, uint32_t *file_offset_out, uint16_t *data_len_out
+);
+
+uint8_t COMMS_bulk_file_downlink_packet_sent(uint16_t seq_num, uint16_t data_len);
+
+int32_t COMMS_bulk_file_downlink_prefetch(void);
+
+int32_t COMMS_bulk_file_downlink_nack(
+    uint16_t transfer_id, uint16_t first_seq_num, const uint8_t bitmap[], uint16_t bitmap_len,
+    uint16_t *nacked_count_out
+);
+
+int32_t COMMS_bulk_file_downlink_start_compressed(
+    char *file_path, uint32_t start_offset, uint32_t max_bytes, uint8_t window_sz2, uint8_t lookahead_sz2
+);
+
+int32_t COMMS_bulk_file_downlink_get_compressed_packet(
+    const uint8_t **data_out, uint16_t *data_len_out, uint8_t *is_last_packet_out
+);
+
+void COMMS_bulk_file_downlink_compressed_packet_sent(void);
+
+void COMMS_bulk_file_downlink_end_compression(void);
+
+void COMMS_bulk_file_downlink_stop(void);
+
 uint8_t COMMS_bulk_file_downlink_pause(void);
 
 uint8_t COMMS_bulk_file_downlink_resume(void);
@@ -10,7 +10,9 @@ typedef enum {
     COMMS_PACKET_TYPE_BEACON_PERIPHERAL = 0x02, // Unused, currently.
     COMMS_PACKET_TYPE_LOG_MESSAGE = 0x03,
     COMMS_PACKET_TYPE_TCMD_RESPONSE = 0x04,
+    COMMS_PACKET_TYPE_LOG_MESSAGE_BINARY = 0x05, // Binary log record (see `log_binary.c`).
     COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK = 0x10,
+    COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK_COMPRESSED = 0x11, // Heatshrink stream (see `bulk_file_downlink.c`).
     COMMS_PACKET_TYPE_BEACON_EXTENDED = 0x20,
 } COMMS_packet_type_enum_t;
 
@@ -99,12 +101,19 @@ typedef struct {
     char friendly_message[COMMS_BEACON_FRIENDLY_MESSAGE_SIZE];
 
     char end_message[4]; // "END\0"
-    
+
+    // Appended after the end message, so that the fields above keep their offsets.
+    // AX100 downlink pacing, since boot (see `ax100_tx_pacing.c`). Counts saturate at 65535.
+    uint32_t ax100_tx_packets_sent;
+    uint16_t ax100_tx_stall_count;
+    uint16_t ax100_tx_failed_probe_count;
+    uint16_t ax100_tx_rate_scale_permille; // Learned airtime / modelled airtime.
+    uint16_t ax100_tx_achieved_packets_per_sec_x100;
 } COMMS_beacon_basic_packet_t;
 
 
 typedef struct {
-    uint8_t packet_type; // COMMS_packet_type_enum_t - Always COMMS_PACKET_TYPE_LOG_MESSAGE for this packet
+    uint8_t packet_type; // COMMS_packet_type_enum_t - COMMS_PACKET_TYPE_LOG_MESSAGE or COMMS_PACKET_TYPE_LOG_MESSAGE_BINARY
 
     uint8_t data[COMMS_LOG_MESSAGE_PACKET_MAX_DATA_BYTES_PER_PACKET];
 } COMMS_log_message_packet_t;
@@ -123,9 +132,9 @@ typedef struct {
 } COMMS_tcmd_response_packet_t;
 
 typedef struct {
-    uint8_t packet_type; // COMMS_packet_type_enum_t - Always COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK for this packet
+    uint8_t packet_type; // COMMS_packet_type_enum_t - COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK or COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK_COMPRESSED
 
-    uint32_t file_offset;   // 4 bytes
+    uint32_t file_offset;   // 4 bytes. For compressed packets, the offset in the compressed stream.
 
     uint8_t data[COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET];
 } COMMS_bulk_file_downlink_packet_t;
@@ -144,10 +153,17 @@ uint8_t COMMS_downlink_tcmd_response(
 );
 
 uint8_t COMMS_downlink_log_message(const char log_message_str[]);
+uint8_t COMMS_downlink_log_record_binary(const uint8_t record_bytes[], uint16_t record_len);
 
-uint8_t COMMS_downlink_bulk_file_downlink(
-    uint16_t file_seq_num,
+COMMS_bulk_file_downlink_packet_t *COMMS_acquire_bulk_file_downlink_packet(void);
+uint8_t COMMS_start_bulk_file_downlink_packet(
+    COMMS_bulk_file_downlink_packet_t *packet,
+    COMMS_packet_type_enum_t packet_type,
     uint32_t file_offset,
+    uint16_t data_len
+);
+uint8_t COMMS_downlink_bulk_file_downlink_compressed(
+    uint32_t stream_offset,
     uint8_t data[],
     uint16_t data_len
 );
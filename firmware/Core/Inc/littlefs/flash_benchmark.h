@@ -5,4 +5,6 @@
 
 uint8_t FLASH_benchmark_erase_write_read(uint8_t chip_num, uint32_t test_data_address, uint16_t test_data_length, char* response_str, uint16_t response_str_len);
 
+uint8_t FLASH_benchmark_sequential_read(uint8_t chip_num, uint32_t start_page_address, uint32_t page_count, char* response_str, uint16_t response_str_len);
+
 #endif /* INCLUDE_GUARD__FLASH_BENCHMARK_H__ */
@@ -0,0 +1,46 @@
+#ifndef INCLUDE_GUARD__FLASH_BUSY_WAIT_H__
+#define INCLUDE_GUARD__FLASH_BUSY_WAIT_H__
+
+#include <stdint.h>
+
+// Histogram buckets are powers of two: bucket k counts busy times in [2^k, 2^(k+1)) us (bucket 0
+// also counts 0 us, and the last bucket counts everything longer).
+#define FLASH_BUSY_TIME_HISTOGRAM_BUCKET_COUNT 16
+
+/// @brief Busy time of a chip operation, from the datasheet.
+typedef struct {
+    /// @brief Typical busy time. The first status poll is made after this long.
+    uint32_t typical_us;
+
+    /// @brief Give up (with `FLASH_ERR_DEVICE_BUSY_TIMEOUT`) once the chip has been busy this long.
+    uint32_t timeout_us;
+} FLASH_busy_wait_timing_t;
+
+/// @brief Measured busy times of one operation type (e.g., page program) on one chip.
+typedef struct {
+    uint32_t count;
+    uint32_t timeout_count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+
+    /// @brief Status register reads made while waiting, over all `count` operations.
+    uint32_t status_poll_count;
+
+    uint32_t histogram[FLASH_BUSY_TIME_HISTOGRAM_BUCKET_COUNT];
+} FLASH_busy_time_stats_t;
+
+extern const FLASH_busy_wait_timing_t FLASH_PAGE_PROGRAM_TIMING;
+extern const FLASH_busy_wait_timing_t FLASH_BLOCK_ERASE_TIMING;
+
+uint32_t FLASH_busy_wait_next_poll_delay_us(const FLASH_busy_wait_timing_t *timing, uint32_t elapsed_us);
+
+uint8_t FLASH_busy_time_histogram_bucket(uint32_t busy_us);
+void FLASH_busy_time_stats_record(FLASH_busy_time_stats_t *stats, uint32_t busy_us, uint32_t status_poll_count);
+void FLASH_busy_time_stats_record_timeout(FLASH_busy_time_stats_t *stats, uint32_t status_poll_count);
+
+int16_t FLASH_busy_time_stats_to_json(
+    const FLASH_busy_time_stats_t *stats, char json_output_buf[], uint16_t json_output_buf_size
+);
+
+#endif // INCLUDE_GUARD__FLASH_BUSY_WAIT_H__
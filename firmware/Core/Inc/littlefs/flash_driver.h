@@ -5,6 +5,7 @@
 #include <stdint.h>
 
 #include "littlefs/flash_internal_spi.h"
+#include "littlefs/flash_busy_wait.h"
 
 /*----------------------------- CONFIG VARIABLES ----------------------------- */
 // Number of CS pins available. 8 FLASH + 2 optional FRAM, if used. FRAM not used.
@@ -63,6 +64,14 @@ static const uint8_t FLASH_OP_IN_PROGRESS_MASK = (1 << 0);
 static const uint8_t FLASH_SR1_WRITE_ENABLE_LATCH_MASK = (1 << 1);
 static const uint8_t FLASH_SR1_PROGRAMMING_ERROR_MASK = (1 << 3);
 static const uint8_t FLASH_SR1_ERASE_ERROR_MASK = (1 << 2);
+static const uint8_t FLASH_SR1_CACHE_READ_BUSY_MASK = (1 << 7); // CRBSY: next page still loading in cache read mode.
+
+
+/*-----------------------------DRIVER STATE-----------------------------*/
+extern uint32_t FLASH_cache_read_enabled;
+
+extern FLASH_busy_time_stats_t FLASH_program_busy_time_stats[FLASH_NUMBER_OF_FLASH_DEVICES];
+extern FLASH_busy_time_stats_t FLASH_erase_busy_time_stats[FLASH_NUMBER_OF_FLASH_DEVICES];
 
 
 /*-----------------------------DRIVER FUNCTIONS-----------------------------*/
@@ -74,6 +83,10 @@ FLASH_error_enum_t FLASH_program_page(uint8_t chip_number, FLASH_Physical_Addres
 FLASH_error_enum_t FLASH_read_page(
     uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *rx_buffer, uint32_t rx_buffer_size
 );
+FLASH_error_enum_t FLASH_start_read_page(
+    uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *rx_buffer, uint32_t rx_buffer_size
+);
+FLASH_error_enum_t FLASH_wait_for_read_page(void);
 
 
 FLASH_error_enum_t FLASH_is_reachable(uint8_t chip_number);
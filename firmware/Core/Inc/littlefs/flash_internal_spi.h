@@ -30,6 +30,11 @@ typedef enum {
     FLASH_CMD_PAGE_READ        = 0x13, // Read Page
     FLASH_CMD_READ_FROM_CACHE  = 0x03, // Read from Cache
 
+    // Cache read: the loaded page is moved to the cache, then the given page starts loading from
+    // the array while the cache is read out.
+    FLASH_CMD_PAGE_READ_CACHE_RANDOM  = 0x30, // Page Read Cache Random
+    FLASH_CMD_PAGE_READ_CACHE_LAST    = 0x3F, // Page Read Cache Last (ends cache read mode)
+
     FLASH_CMD_PROGRAM_LOAD     = 0x02, // Load Program into cache registers
     FLASH_CMD_PROGRAM_EXECUTE     = 0x10, // Send data from cache to memory
 
@@ -48,6 +53,19 @@ typedef enum {
 } FLASH_command_t;
 
 
+/// @brief State of the DMA transfer started by the `FLASH_SPI_start_*` functions.
+typedef enum {
+    FLASH_SPI_DMA_IDLE = 0,
+    FLASH_SPI_DMA_IN_PROGRESS = 1,
+    FLASH_SPI_DMA_COMPLETE = 2, // Set by the SPI transfer complete ISR.
+    FLASH_SPI_DMA_FAILED = 3, // Set by the SPI error ISR.
+} FLASH_SPI_dma_state_enum_t;
+
+
+extern uint32_t FLASH_SPI_abandoned_transfer_error_count;
+extern FLASH_error_enum_t FLASH_SPI_last_abandoned_transfer_error;
+
+
 /*-----------------------------FLASH SPI DRIVER FUNCTIONS-----------------------------*/
 FLASH_error_enum_t FLASH_SPI_send_command(const FLASH_SPI_Data_t cmd[], uint8_t chip_number);
 FLASH_error_enum_t FLASH_SPI_send_command_with_data(
@@ -57,6 +75,15 @@ FLASH_error_enum_t FLASH_SPI_send_command_receive_response(
     const FLASH_SPI_Data_t cmd[], uint8_t *response, uint16_t response_size, uint8_t chip_number
 );
 
+FLASH_error_enum_t FLASH_SPI_start_command_with_data(
+    const FLASH_SPI_Data_t cmd[], FLASH_SPI_Data_t *data, uint8_t chip_number
+);
+FLASH_error_enum_t FLASH_SPI_start_command_receive_response(
+    const FLASH_SPI_Data_t cmd[], uint8_t *response, uint16_t response_size, uint8_t chip_number
+);
+FLASH_error_enum_t FLASH_SPI_wait_for_transfer(void);
+FLASH_SPI_dma_state_enum_t FLASH_SPI_get_transfer_state(void);
+
 void FLASH_SPI_enable_then_disable_chip_select(uint8_t chip_number);
 
 #endif // INCLUDE_GUARD__FLASH_INTERNAL_SPI_H__
\ No newline at end of file
@@ -3,8 +3,51 @@
 
 #include <stdint.h>
 
+// LittleFS custom attribute type ('S') holding a file's cached SHA256 digest.
+#define LFS_CHECKSUM_DIGEST_ATTR_TYPE 0x53
+#define LFS_CHECKSUM_DIGEST_ATTR_FORMAT_VERSION 2
+
+/// @brief Contents of the `LFS_CHECKSUM_DIGEST_ATTR_TYPE` attribute.
+typedef struct {
+    uint32_t format_version;
+
+    /// @brief Bumped by each write through the `littlefs_helper.c` write helpers
+    ///     (`LFS_checksum_bump_generation`).
+    uint32_t generation;
+
+    /// @brief Value of `generation` when the digest was computed.
+    uint32_t digest_generation;
+
+    uint32_t file_size;
+    uint32_t ctz_head_block;
+
+    /// @brief `lfs_crc` of the file's last chunk (from the last multiple of 2 KiB before its end).
+    uint32_t tail_crc;
+
+    uint8_t sha256[32];
+} LFS_checksum_digest_attr_t;
+
+/// @brief Checksum counters, since boot (or the last `LFS_checksum_reset_stats`).
+typedef struct {
+    /// @brief Whole-file checksums answered from the file's digest attribute, without reading it.
+    uint32_t digest_cache_hit_count;
+
+    /// @brief Whole-file checksums computed by reading the file (no attribute, or a stale one).
+    uint32_t digest_cache_miss_count;
+
+    /// @brief Bytes read from files and hashed.
+    uint32_t bytes_hashed;
+} LFS_checksum_stats_t;
+
+extern uint32_t LFS_checksum_digest_cache_enabled;
+extern LFS_checksum_stats_t LFS_checksum_stats;
+
 int8_t LFS_read_file_checksum_sha256(
     const char filepath[], uint32_t start_offset, uint32_t max_length, uint8_t sha256_dest[32]
 );
 
+int8_t LFS_checksum_bump_generation(const char filepath[]);
+
+void LFS_checksum_reset_stats(void);
+
 #endif /* INCLUDE_GUARD__LITTLEFS_CHECKSUMS_H */
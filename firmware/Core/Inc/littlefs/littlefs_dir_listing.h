@@ -0,0 +1,56 @@
+#ifndef INCLUDE_GUARD__LITTLEFS_DIR_LISTING_H__
+#define INCLUDE_GUARD__LITTLEFS_DIR_LISTING_H__
+
+#include <stdint.h>
+
+#include "littlefs/littlefs_constants.h"
+
+// Number of directories whose entries are kept in RAM.
+#define LFS_DIR_LISTING_INDEX_SLOT_COUNT 2
+
+// Per directory. A directory with more entries (or longer names) isn't indexed; it's still listed
+// with the cursor.
+#define LFS_DIR_LISTING_INDEX_MAX_ENTRIES 256
+#define LFS_DIR_LISTING_INDEX_NAME_POOL_BYTES 4096
+
+typedef struct {
+    const char *name; // Valid until the next `LFS_dir_listing_*` call.
+    uint32_t size; // 0 for directories.
+    uint8_t type; // `LFS_TYPE_REG` or `LFS_TYPE_DIR`.
+} LFS_dir_listing_entry_t;
+
+/// @brief Directory listing counters, since boot (or the last `LFS_dir_listing_reset_stats`).
+typedef struct {
+    /// @brief Seeks served from the in-RAM index (no flash reads).
+    uint32_t index_hit_count;
+
+    /// @brief Seeks which continued the open cursor (no entries re-read).
+    uint32_t resume_count;
+
+    /// @brief Seeks which (re)opened the directory, and the entries read from flash to skip to the
+    ///     requested position.
+    uint32_t reopen_count;
+    uint32_t skipped_entry_count;
+
+    /// @brief Entries read from flash (`lfs_dir_read`), including skipped ones.
+    uint32_t flash_entry_read_count;
+
+    /// @brief Directories indexed (after a complete pass from their first entry).
+    uint32_t index_build_count;
+
+    /// @brief Indexes dropped because the filesystem was written to after they were built.
+    uint32_t index_stale_count;
+} LFS_dir_listing_stats_t;
+
+extern uint32_t LFS_dir_listing_index_max_age_ms;
+extern LFS_dir_listing_stats_t LFS_dir_listing_stats;
+
+int32_t LFS_dir_listing_seek(const char directory_path[], uint32_t position);
+int32_t LFS_dir_listing_read(LFS_dir_listing_entry_t *entry_out);
+uint32_t LFS_dir_listing_get_position(void);
+
+void LFS_dir_listing_invalidate_path(const char path[]);
+void LFS_dir_listing_reset(void);
+void LFS_dir_listing_reset_stats(void);
+
+#endif // INCLUDE_GUARD__LITTLEFS_DIR_LISTING_H__
@@ -1,17 +1,71 @@
-
 #ifndef INCLUDE_GUARD__LITTLEFS_DRIVER_H__
 #define INCLUDE_GUARD__LITTLEFS_DRIVER_H__
 
 /*-----------------------------INCLUDES-----------------------------*/
 #include "littlefs/lfs.h"
+#include "littlefs/flash_driver.h"
+
+/*----------------------------- CONFIG VARIABLES ----------------------------- */
+// Number of flash chips the filesystem spans (chips 0 to N-1).
+// Only chips 0-3 have chip select lines on the OBC (see `_chip_select_low` in `flash_internal_spi.c`),
+// even though `FLASH_NUMBER_OF_FLASH_DEVICES` is 8.
+#define LFS_NUMBER_OF_FLASH_CHIPS 4
+
+#define LFS_BLOCKS_PER_CHIP (FLASH_CHIP_SIZE_BYTES / FLASH_CHIP_BLOCK_SIZE_BYTES)
+
+// Total number of LittleFS blocks, across all chips.
+#define LFS_TOTAL_BLOCK_COUNT (LFS_BLOCKS_PER_CHIP * LFS_NUMBER_OF_FLASH_CHIPS)
+
+/// @brief How LittleFS blocks are mapped onto the flash chips.
+typedef enum {
+    /// @brief Blocks [0, 1024) are on chip 0, blocks [1024, 2048) are on chip 1, etc.
+    /// @note The first 1024 blocks are at the same place as the original single-chip layout, so an
+    ///     existing single-chip filesystem is grown in place when mounted (see `LFS_mount`).
+    LFS_CHIP_LAYOUT_CONCATENATE = 0,
+
+    /// @brief Consecutive blocks are on consecutive chips (block N is on chip N % chip_count),
+    ///     except that blocks 1 and chip_count are swapped.
+    /// @note Lets one chip erase/program while the next one is accessed. Requires a format.
+    /// @note The swap keeps the superblock pair (blocks 0 and 1, on chip 0) at the same place as the
+    ///     concatenate layout, so that the layout recorded in it reads the same whichever layout
+    ///     is tried first (see `LFS_mount`).
+    LFS_CHIP_LAYOUT_STRIPE = 1,
+} LFS_chip_layout_enum_t;
+
+/// @brief Per-chip block device counters.
+typedef struct {
+    /// @brief Number of blocks known to be bad (marked bad in flash, or failed erase/program since boot).
+    uint16_t bad_block_count;
+
+    /// @brief Number of erase/program operations which failed with a status register error.
+    uint16_t failed_erase_or_program_count;
+
+    /// @brief Whether `FLASH_init()` failed for this chip during `LFS_block_device_init()`.
+    uint8_t init_failed;
+} LFS_chip_stats_t;
+
+extern LFS_chip_layout_enum_t LFS_chip_layout;
+extern LFS_chip_stats_t LFS_chip_stats[LFS_NUMBER_OF_FLASH_CHIPS];
+extern uint32_t LFS_block_device_write_count;
 
 /*---------------------------FUNCTIONS---------------------------*/
-// uint8_t LFS_get_chip_number(lfs_block_t block_num); // Changed to a static inline.
+uint8_t LFS_block_device_init(void);
+void LFS_block_device_set_layout(LFS_chip_layout_enum_t layout);
+uint8_t LFS_block_device_is_block_bad(lfs_block_t block);
+const char* LFS_chip_layout_enum_to_str(LFS_chip_layout_enum_t layout);
 
 int LFS_block_device_read(const struct lfs_config *, lfs_block_t, lfs_off_t, void *, lfs_size_t);
 int LFS_block_device_prog(const struct lfs_config *, lfs_block_t, lfs_off_t, const void *, lfs_size_t);
 int LFS_block_device_erase(const struct lfs_config *, lfs_block_t);
 int LFS_block_device_sync(const struct lfs_config *);
 
+#ifdef LFS_THREADSAFE
+int LFS_block_device_lock(const struct lfs_config *);
+int LFS_block_device_unlock(const struct lfs_config *);
+#endif
+
+void LFS_lock_for_raw_flash_access(void);
+void LFS_unlock_for_raw_flash_access(void);
+
 
 #endif /* INCLUDE_GUARD__LITTLEFS_DRIVER_H__ */
@@ -20,6 +20,8 @@ extern lfs_t LFS_filesystem; // LittleFS filesystem object; traditionally called
 extern struct lfs_config LFS_cfg;
 extern struct lfs_file_config LFS_file_cfg;
 extern uint8_t LFS_is_lfs_mounted;
+extern uint32_t LFS_mount_count;
+extern uint32_t LFS_chip_layout_for_format;
 
 
 /*---------------------------FUNCTIONS---------------------------*/
@@ -38,5 +40,6 @@ int8_t LFS_write_file_with_offset(const char file_name[], lfs_soff_t offset, uin
 int8_t LFS_append_file(const char file_name[], uint8_t *write_buffer, uint32_t write_buffer_len);
 lfs_ssize_t LFS_read_file(const char file_name[], lfs_soff_t offset, uint8_t *read_buffer, uint32_t read_buffer_size);
 lfs_ssize_t LFS_file_size(const char file_name[], uint8_t enable_log_messages);
+uint32_t LFS_get_boot_count(void);
 
 #endif /* INCLUDE_GUARD__LITTLEFS_HELPER_H__ */
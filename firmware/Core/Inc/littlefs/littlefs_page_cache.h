@@ -0,0 +1,43 @@
+#ifndef INCLUDE_GUARD__LITTLEFS_PAGE_CACHE_H__
+#define INCLUDE_GUARD__LITTLEFS_PAGE_CACHE_H__
+
+#include <stdint.h>
+
+#include "littlefs/flash_driver.h"
+
+// Number of page buffers reserved (2 KiB each). `LFS_page_cache_page_count` selects how many are used.
+#define LFS_PAGE_CACHE_MAX_PAGE_COUNT 16
+
+/// @brief Page cache counters, since boot (or the last `LFS_page_cache_reset_stats`).
+typedef struct {
+    /// @brief Page reads served from the cache.
+    uint32_t hit_count;
+
+    /// @brief Page reads which went to the flash chip.
+    uint32_t miss_count;
+
+    /// @brief Pages loaded ahead of a sequential read, before they were requested.
+    uint32_t read_ahead_page_count;
+
+    /// @brief Read-ahead pages which were requested before being evicted.
+    uint32_t read_ahead_hit_count;
+
+    /// @brief Cached pages dropped because they were programmed or erased.
+    uint32_t invalidated_page_count;
+} LFS_page_cache_stats_t;
+
+extern uint32_t LFS_page_cache_page_count;
+extern uint32_t LFS_page_cache_read_ahead_page_count;
+extern LFS_page_cache_stats_t LFS_page_cache_stats;
+
+FLASH_error_enum_t LFS_page_cache_read(
+    uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *dest, uint32_t size
+);
+void LFS_page_cache_invalidate_page(uint8_t chip_number, uint32_t row_address);
+void LFS_page_cache_invalidate_block(uint8_t chip_number, uint32_t first_row_address);
+void LFS_page_cache_invalidate_all(void);
+
+void LFS_page_cache_reset_stats(void);
+int16_t LFS_page_cache_stats_to_json(char json_output_buf[], uint16_t json_output_buf_size);
+
+#endif // INCLUDE_GUARD__LITTLEFS_PAGE_CACHE_H__
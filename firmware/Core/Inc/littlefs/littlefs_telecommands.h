@@ -9,6 +9,12 @@ int32_t LFS_list_directory_json_dict(
     char *json_output_buf, uint16_t json_output_buf_size
 );
 
+int32_t LFS_list_directory_page_json(
+    const char root_directory[],
+    uint32_t cursor, uint16_t count,
+    char *json_output_buf, uint16_t json_output_buf_size
+);
+
 int8_t LFS_get_filesystem_stats_json(
     char *json_output_buf, uint16_t json_output_buf_size
 );
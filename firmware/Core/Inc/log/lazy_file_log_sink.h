@@ -6,6 +6,7 @@
 #include "littlefs/lfs.h"
 
 void LOG_to_file_lazy(const char filename[], const char msg[]);
+void LOG_to_file_lazy_binary(const uint8_t record_bytes[], uint16_t record_len);
 
 void LOG_subtask_handle_sync_and_close_of_current_log_file();
 
@@ -56,6 +56,8 @@ typedef enum {
 
 
 extern LOG_context_enum_t LOG_current_log_context;
+extern uint32_t LOG_deferred_formatting_enabled;
+extern volatile uint8_t LOG_logger_task_is_running;
 
 enum {
     LOG_SYSTEM_OFF = 0,
@@ -69,6 +71,8 @@ void LOG_message(
 // __attribute__ part indicates that the `fmt` arg (4th arg) is a printf format string, and the
 // 5th arg is a variable argument list. Makes compiler check that fmt matches the variable arguments.
 
+uint32_t LOG_process_queued_messages(uint32_t max_record_count);
+
 uint32_t LOG_all_sinks_except(uint32_t exceptions);
 uint8_t LOG_is_sink_enabled(LOG_sink_enum_t sink);
 void LOG_set_sink_debugging_messages_enabled_state(LOG_sink_enum_t sink, uint8_t state);
@@ -0,0 +1,54 @@
+#ifndef INCLUDE_GUARD__LOG_ARGS_H__
+#define INCLUDE_GUARD__LOG_ARGS_H__
+
+#include <stdarg.h>
+#include <stdint.h>
+
+/// @brief Class of the value consumed by one printf conversion (or `*` width/precision).
+typedef enum {
+    LOG_ARG_TYPE_NONE = 0, // `%%`, or the end of the format string.
+    LOG_ARG_TYPE_INT,
+    LOG_ARG_TYPE_LONG,
+    LOG_ARG_TYPE_LONG_LONG,
+    LOG_ARG_TYPE_SIZE,
+    LOG_ARG_TYPE_DOUBLE,
+    LOG_ARG_TYPE_LONG_DOUBLE,
+    LOG_ARG_TYPE_POINTER,
+    LOG_ARG_TYPE_STRING,
+    LOG_ARG_TYPE_UNSUPPORTED, // `%n`, or an unknown conversion.
+} LOG_arg_type_enum_t;
+
+/// @brief One printf conversion specification, as found by `LOG_args_next_conversion`.
+typedef struct {
+    /// @brief Index of the '%' in the format string.
+    uint16_t start_index;
+
+    /// @brief Number of characters in the specification, including the '%' and the conversion.
+    uint8_t length;
+
+    /// @brief Number of `*` (width and/or precision) ints which come before the value.
+    uint8_t star_count;
+
+    /// @brief 1 if the precision is given as a number (not `*`); `precision` is then valid.
+    uint8_t has_fixed_precision;
+    uint16_t precision;
+
+    /// @brief 1 if the precision is given as `*`; it is then the last of the `star_count` ints.
+    uint8_t has_star_precision;
+
+    /// @brief 1 for the signed conversions (`d`, `i`, `c`), 0 otherwise.
+    uint8_t is_signed;
+
+    LOG_arg_type_enum_t type;
+} LOG_arg_conversion_t;
+
+uint8_t LOG_args_next_conversion(const char fmt[], uint16_t *fmt_index, LOG_arg_conversion_t *conversion_out);
+uint8_t LOG_args_packed_size(LOG_arg_type_enum_t type);
+
+int16_t LOG_args_pack(const char fmt[], va_list ap, uint8_t packed_args[], uint16_t packed_args_size);
+uint16_t LOG_args_format(
+    const char fmt[], const uint8_t packed_args[], uint16_t packed_args_len,
+    char dest[], uint16_t dest_size
+);
+
+#endif // INCLUDE_GUARD__LOG_ARGS_H__
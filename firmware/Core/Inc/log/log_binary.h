@@ -0,0 +1,22 @@
+#ifndef INCLUDE_GUARD__LOG_BINARY_H__
+#define INCLUDE_GUARD__LOG_BINARY_H__
+
+#include <stdint.h>
+
+#include "log/log_queue.h"
+
+// Longest encoded record, including its length byte.
+#define LOG_BINARY_RECORD_MAX_LENGTH 256
+
+// Bytes before the varint-encoded fields: length, format ID (4), system/severity, sync source/context.
+#define LOG_BINARY_RECORD_FIXED_HEADER_LENGTH 7
+
+uint32_t LOG_binary_format_id(const char fmt[]);
+uint32_t LOG_binary_record_format_id(const uint8_t record_bytes[]);
+
+int16_t LOG_binary_encode_record(const LOG_record_t *record, uint8_t dest[], uint16_t dest_size);
+int16_t LOG_binary_decode_record(
+    const uint8_t src[], uint16_t src_len, const char fmt[], LOG_record_t *record_out
+);
+
+#endif // INCLUDE_GUARD__LOG_BINARY_H__
@@ -0,0 +1,73 @@
+#ifndef INCLUDE_GUARD__LOG_QUEUE_H__
+#define INCLUDE_GUARD__LOG_QUEUE_H__
+
+#include <stdint.h>
+
+#include "log/log.h"
+
+// Number of records which can wait for the logger task. Must be a power of 2.
+#define LOG_QUEUE_RECORD_COUNT 32
+
+// Longest a task waits in `LOG_message` for the logger task to free a slot in a full queue,
+// in waits of one tick (1 ms). Past this, the logger task is taken to be stuck, and the message
+// is dropped.
+#define LOG_QUEUE_FULL_MAX_WAIT_COUNT 1000
+
+// Room for the packed arguments of a record, or for the formatted message when the arguments
+// do not fit (see `LOG_RECORD_FLAG_PREFORMATTED`).
+#define LOG_RECORD_PACKED_ARGS_MAX_LENGTH (LOG_FORMATTED_MESSAGE_MAX_LENGTH + 1)
+
+// `packed_args` holds the formatted message (null-terminated), instead of the packed arguments.
+#define LOG_RECORD_FLAG_PREFORMATTED (1 << 0)
+
+/// @brief Everything `LOG_message` captures in the caller's context.
+typedef struct {
+    /// @brief The format string. Format strings are string literals, so only the pointer is kept.
+    const char *fmt;
+
+    /// @brief Timestamp, as the time of the last resync plus the uptime since then (see `timekeeping.h`).
+    uint64_t unix_epoch_time_at_last_time_resync_ms;
+    uint32_t ms_since_last_time_resync;
+    uint8_t sync_source; // TIME_sync_source_enum_t
+
+    uint8_t context; // LOG_context_enum_t
+    uint8_t flags;
+    uint16_t packed_args_len;
+    uint32_t system; // LOG_system_enum_t
+    uint32_t severity; // LOG_severity_enum_t
+    uint32_t sink_mask;
+
+    uint8_t packed_args[LOG_RECORD_PACKED_ARGS_MAX_LENGTH];
+} LOG_record_t;
+
+/// @brief Queue counters, since boot.
+typedef struct {
+    /// @brief Records which were queued for the logger task.
+    uint32_t enqueued_count;
+
+    /// @brief Records which found the queue full, and whose caller waited for the logger task.
+    uint32_t full_wait_count;
+
+    /// @brief Records which found the queue full, and were dropped: logged by the logger task
+    ///     itself (or with the scheduler not running), or the logger task didn't free a slot in time.
+    uint32_t dropped_count;
+
+    /// @brief Records whose arguments did not fit, and which were formatted by the caller.
+    uint32_t preformatted_count;
+
+    /// @brief Most records waiting in the queue at once.
+    uint32_t max_depth;
+} LOG_queue_stats_t;
+
+extern LOG_queue_stats_t LOG_queue_stats;
+
+LOG_record_t *LOG_queue_claim_slot(uint32_t *ticket_out);
+void LOG_queue_publish_slot(uint32_t ticket);
+LOG_record_t *LOG_queue_peek_front(void);
+void LOG_queue_release_front(void);
+uint32_t LOG_queue_depth(void);
+
+// Defined in log.c.
+void LOG_format_record_line(const LOG_record_t *record, char line[], uint16_t line_size);
+
+#endif // INCLUDE_GUARD__LOG_QUEUE_H__
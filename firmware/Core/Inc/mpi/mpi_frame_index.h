@@ -0,0 +1,81 @@
+#ifndef INCLUDE_GUARD__MPI_FRAME_INDEX_H
+#define INCLUDE_GUARD__MPI_FRAME_INDEX_H
+
+#include <stdint.h>
+
+// Length of an MPI science data frame (`MPI_dataframe_t`), which starts with the sync word.
+#define MPI_FRAME_INDEX_FRAME_SIZE_BYTES 160
+#define MPI_FRAME_INDEX_SYNC_WORD 0x0CFFFF0C
+
+// Appended to the science data file's path to get its index file's path.
+#define MPI_FRAME_INDEX_FILE_SUFFIX ".idx"
+
+// `frame_number` values of the records which start and end a recording in the index file.
+#define MPI_FRAME_INDEX_START_RECORD_MAGIC 0x5849504D // "MPIX" (little-endian).
+#define MPI_FRAME_INDEX_PARAMS_RECORD_MAGIC 0x5049504D // "MPIP" (little-endian).
+#define MPI_FRAME_INDEX_END_RECORD_MAGIC 0x4549504D // "MPIE" (little-endian).
+#define MPI_FRAME_INDEX_FORMAT_VERSION 2
+
+#pragma pack(push, 1)
+/// @brief A record of an MPI frame index file (`<science data file>.idx`). Little-endian.
+/// @details Each recording appends a start record, a params record, an entry for every Nth frame
+///     found, and an end record (missing if the recording was cut short, e.g., by a reset):
+/// - Start record: `{MPI_FRAME_INDEX_START_RECORD_MAGIC, file offset of the recording's first data
+///     byte, boot count (`LFS_get_boot_count`)}`. Uptimes only compare within one boot.
+/// - Params record: `{MPI_FRAME_INDEX_PARAMS_RECORD_MAGIC, version | (N << 16), uptime at the
+///     start}`.
+/// - Entry: `{frame number, file offset of the frame's sync word, uptime}`. The frame number is
+///     the MPI's 16-bit frame counter, extended to 32 bits across wraps. The uptime is when the
+///     frame's sync word arrived, worked back from when its buffer finished filling.
+/// - End record: `{MPI_FRAME_INDEX_END_RECORD_MAGIC, frames found, science data bytes}`.
+typedef struct {
+    uint32_t frame_number;
+    uint32_t file_offset;
+    uint32_t uptime_ms;
+} MPI_frame_index_record_t;
+#pragma pack(pop)
+
+typedef enum {
+    MPI_FRAME_INDEX_KEY_FRAME_NUMBER,
+    MPI_FRAME_INDEX_KEY_UPTIME_MS,
+} MPI_frame_index_key_enum_t;
+
+/// @brief Totals of an index file, from `MPI_frame_index_get_summary`.
+typedef struct {
+    uint32_t recording_count;
+    uint32_t entry_count;
+
+    /// @brief 1 if every recording in the index has its end record.
+    uint8_t is_complete;
+
+    /// @brief Frames found, and science data bytes, in the recordings with an end record.
+    uint32_t frames_found;
+    uint32_t data_bytes;
+
+    uint32_t first_entry_file_offset;
+    uint32_t last_entry_file_offset;
+} MPI_frame_index_summary_t;
+
+extern uint32_t MPI_frame_index_interval_frames;
+
+int8_t MPI_frame_index_get_path(const char data_file_path[], char index_path_out[], uint16_t index_path_out_size);
+
+int8_t MPI_frame_index_delete(const char data_file_path[]);
+
+int8_t MPI_frame_index_start(
+    const char data_file_path[], uint32_t data_start_file_offset, uint32_t boot_count, uint32_t uptime_ms
+);
+void MPI_frame_index_add_data(const uint8_t data[], uint32_t data_len, uint32_t data_file_offset, uint32_t uptime_ms);
+int8_t MPI_frame_index_finish(void);
+
+int8_t MPI_frame_index_find_range(
+    const char data_file_path[], MPI_frame_index_key_enum_t key, uint32_t boot_count,
+    uint32_t first, uint32_t last, uint32_t *start_offset_out, uint32_t *end_offset_out
+);
+int8_t MPI_frame_index_get_summary(const char data_file_path[], MPI_frame_index_summary_t *summary_out);
+
+int8_t MPI_frame_index_extract_range_to_file(
+    const char data_file_path[], uint32_t start_offset, uint32_t end_offset, const char output_file_path[]
+);
+
+#endif // INCLUDE_GUARD__MPI_FRAME_INDEX_H
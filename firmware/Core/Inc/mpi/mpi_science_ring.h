@@ -0,0 +1,42 @@
+#ifndef INCLUDE_GUARD__MPI_SCIENCE_RING_H
+#define INCLUDE_GUARD__MPI_SCIENCE_RING_H
+
+#include <stdint.h>
+
+// Size of each science data buffer. One flash page, so each buffer is written as whole pages.
+#define MPI_SCIENCE_RING_BUFFER_SIZE_BYTES 2048
+
+// Number of buffers allocated (40 KiB, the same RAM as the two former 20 KiB ping-pong buffers).
+#define MPI_SCIENCE_RING_MAX_BUFFER_COUNT 20
+#define MPI_SCIENCE_RING_MIN_BUFFER_COUNT 3
+
+// Length of the DMA transfers into the discard buffer when every buffer is full (one MPI frame).
+#define MPI_SCIENCE_RING_DISCARD_BUFFER_SIZE_BYTES 160
+
+/// @brief Science ring counters, since the last `MPI_science_ring_reset` (start of recording).
+typedef struct {
+    uint32_t buffers_filled;
+    uint32_t buffers_released;
+
+    /// @brief DMA transfers into the discard buffer, because every buffer was awaiting its write.
+    uint32_t discarded_transfer_count;
+
+    /// @brief Most buffers awaiting their write at once.
+    uint32_t max_pending_buffer_count;
+} MPI_science_ring_stats_t;
+
+extern uint32_t MPI_science_ring_buffer_count;
+extern uint8_t MPI_science_ring_storage[MPI_SCIENCE_RING_MAX_BUFFER_COUNT][MPI_SCIENCE_RING_BUFFER_SIZE_BYTES];
+extern MPI_science_ring_stats_t MPI_science_ring_stats;
+
+void MPI_science_ring_reset(void);
+
+uint8_t *MPI_science_ring_get_dma_target(uint16_t *target_len_out);
+uint8_t MPI_science_ring_on_dma_complete_from_isr(uint32_t uptime_ms);
+void MPI_science_ring_complete_partial(uint16_t received_len, uint32_t uptime_ms);
+
+uint32_t MPI_science_ring_pending_count(void);
+const uint8_t *MPI_science_ring_peek_full(uint16_t *len_out, uint32_t *filled_uptime_ms_out);
+void MPI_science_ring_release(void);
+
+#endif // INCLUDE_GUARD__MPI_SCIENCE_RING_H
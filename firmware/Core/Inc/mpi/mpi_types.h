@@ -17,11 +17,6 @@ typedef enum {
     MPI_RX_MODE_NOT_LISTENING_TO_MPI // MPI may be sending science data, but it is not being collected by OBC.
 } MPI_rx_mode_enum_t;
 
-typedef enum {
-    MPI_MEMORY_WRITE_STATUS_AWAITING_WRITE, // MPI buffer is waiting to be fully wrote to memory
-    MPI_MEMORY_WRITE_STATUS_READY_TO_FILL,  // MPI buffer is ready to be wrote to
-} MPI_buffer_state_enum_t;
-
 /// @brief Represents the state of the MPI transceiver chip.
 typedef enum {
     MPI_TRANSCEIVER_MODE_INACTIVE,
@@ -0,0 +1,12 @@
+#ifndef INCLUDE_GUARD__RTOS_LOGGER_TASK_H
+#define INCLUDE_GUARD__RTOS_LOGGER_TASK_H
+
+#include <stdint.h>
+
+extern uint32_t LOG_logger_task_idle_poll_period_ms;
+
+void TASK_logger_wake(void);
+uint8_t TASK_logger_wait_for_queue_space(void);
+void TASK_logger(void *argument);
+
+#endif // INCLUDE_GUARD__RTOS_LOGGER_TASK_H
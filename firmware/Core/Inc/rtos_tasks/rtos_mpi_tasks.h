@@ -1,6 +1,13 @@
 #ifndef INCLUDE_GUARD__RTOS_MPI_TASKS_H__
 #define INCLUDE_GUARD__RTOS_MPI_TASKS_H__
 
+#include <stdint.h>
+
 void TASK_service_write_mpi_data(void *argument);
+void TASK_service_write_mpi_data_wake_from_isr(void);
+
+void MPI_science_file_lock(void);
+void MPI_science_file_unlock(void);
+int32_t MPI_write_pending_science_buffers(void);
 
-#endif // INCLUDE_GUARD__RTOS_MPI_TASKS_H__`
\ No newline at end of file
+#endif // INCLUDE_GUARD__RTOS_MPI_TASKS_H__
@@ -4,6 +4,8 @@
 
 #include "cmsis_os.h"
 
+#include <stdint.h>
+
 /// @brief Register all tasks in an array to track their worst/highest stack usage.
 typedef struct {
     osThreadId_t *task_handle;
@@ -13,8 +15,20 @@ typedef struct {
     uint32_t lowest_stack_bytes_remaining;
 } FREERTOS_task_info_struct_t;
 
+/// @brief A recursive mutex which is created on first use, so that its lock/unlock functions may
+///     be called before the scheduler starts (e.g., from init code shared with the tasks).
+typedef struct {
+    osMutexId_t handle;
+    const char *name;
+} TASK_HELP_lazy_mutex_t;
+
+#define TASK_HELP_LAZY_MUTEX_INIT(mutex_name) { .handle = NULL, .name = (mutex_name) }
+
 // This function shall be called at the start of each task.
 void TASK_HELP_start_of_task(void);
 
+uint8_t TASK_HELP_lazy_mutex_lock(TASK_HELP_lazy_mutex_t *lazy_mutex);
+uint8_t TASK_HELP_lazy_mutex_unlock(TASK_HELP_lazy_mutex_t *lazy_mutex);
+
 
 #endif // INCLUDE_GUARD__RTOS_TASK_HELPERS_H__
@@ -11,6 +11,8 @@ void TASK_DEBUG_print_heartbeat(void *argument);
 
 void TASK_execute_telecommands(void *argument);
 
+void TASK_execute_telecommands_wake(void);
+
 void TASK_monitor_freertos_memory(void *argument);
 
 #endif // INCLUDE_GUARD__RTOS_TASKS_H__
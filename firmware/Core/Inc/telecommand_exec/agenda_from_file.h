@@ -5,8 +5,63 @@
 
 #include "littlefs/littlefs_constants.h"
 
+// Appended to the agenda file path to get the path of its index file.
+#define TCMD_AGENDA_FILE_INDEX_SUFFIX ".idx"
+
+// Number of bytes at the end of the agenda file which are checked to detect a changed file.
+#define TCMD_AGENDA_FILE_FINGERPRINT_TAIL_BYTES 256
+
+/// @brief Header at the start of an agenda index file.
+/// @note The index is valid for an agenda file if the size and tail CRC both match.
+typedef struct {
+    uint32_t magic;
+    uint32_t agenda_file_size;
+
+    /// @brief `lfs_crc` of the last (up to) `TCMD_AGENDA_FILE_FINGERPRINT_TAIL_BYTES` bytes of the agenda file.
+    uint32_t agenda_file_tail_crc;
+
+    uint32_t record_count;
+
+    /// @brief 1 if the records (i.e., the agenda file lines) are in non-decreasing tsexec order.
+    uint8_t is_sorted;
+    uint8_t reserved[3];
+} TCMD_agenda_file_index_header_t;
+
+/// @brief One telecommand in the agenda file. Follows the header, in agenda file order.
+typedef struct {
+    uint64_t timestamp_to_execute;
+
+    /// @brief Byte offset of the start of the telecommand (`CTS1+...`) in the agenda file.
+    uint32_t offset;
+
+    /// @brief Length of the telecommand, including the trailing `!` (but not the `\n`).
+    uint16_t length;
+    uint16_t reserved;
+} TCMD_agenda_file_index_record_t;
+
+/// @brief The index of the most-recently loaded agenda file, and the cursor into it.
+typedef struct {
+    char agenda_file_path[LFS_MAX_PATH_LENGTH];
+    TCMD_agenda_file_index_header_t header;
+
+    /// @brief 1 if `header` matches the index file of `agenda_file_path` on the filesystem.
+    uint8_t is_loaded;
+
+    /// @brief Record index to continue from, if the next call's `min_tsexec_inclusive` is `cursor_min_tsexec`.
+    uint32_t cursor_record_idx;
+    uint64_t cursor_min_tsexec;
+    uint8_t is_cursor_valid;
+
+    uint32_t index_build_count;
+
+    /// @brief Number of index records read by the most-recent call to `TCMD_parse_tcmds_from_file_and_enqueue`.
+    uint32_t last_records_read_count;
+} TCMD_agenda_file_index_state_t;
+
 extern char *TCMD_active_agenda_filename_disabled_sentinel;
 extern char TCMD_active_agenda_filename[LFS_MAX_PATH_LENGTH];
+extern uint32_t TCMD_agenda_file_use_index;
+extern TCMD_agenda_file_index_state_t TCMD_agenda_file_index_state;
 
 uint8_t TCMD_parse_tcmds_from_file_and_enqueue(
     const char *file_path,
@@ -14,4 +69,7 @@ uint8_t TCMD_parse_tcmds_from_file_and_enqueue(
     uint16_t max_enqueue_count
 );
 
+uint8_t TCMD_agenda_file_build_index(const char *file_path);
+void TCMD_agenda_file_invalidate_index(const char *file_path);
+
 #endif // INCLUDE_GUARD__AGENDA_FROM_FILE_H
@@ -0,0 +1,43 @@
+#ifndef INCLUDE_GUARD__AGENDA_STRING_ARENA_H
+#define INCLUDE_GUARD__AGENDA_STRING_ARENA_H
+
+#include <stdint.h>
+
+#include "telecommand_exec/telecommand_types.h"
+
+// Bytes of storage for the args and response filenames of all agenda entries.
+// Each entry takes `TCMD_ARENA_BLOCK_HEADER_SIZE_BYTES` + strlen(args) + strlen(resp_fname) + 2.
+// Fits all 750 agenda slots with ~77 bytes of args plus resp_fname each, but only
+// `TCMD_ARENA_MIN_ENTRY_COUNT` (199) telecommands with max-length args and resp_fname. Past that,
+// `TCMD_add_tcmd_to_agenda` rejects telecommands (returns 2) before the agenda's 750 slots are used.
+// Sizing it for 750 max-length entries would take ~226 KiB, which is what the arena saves.
+// Must stay below 64 KiB (offsets are uint16_t).
+#define TCMD_ARENA_SIZE_BYTES (60 * 1024)
+
+#define TCMD_ARENA_BLOCK_HEADER_SIZE_BYTES 4
+
+// Size of the block for an entry with max-length args and resp_fname.
+#define TCMD_ARENA_MAX_BLOCK_SIZE_BYTES ( \
+    TCMD_ARENA_BLOCK_HEADER_SIZE_BYTES + TCMD_ARGS_STR_NO_PARENS_SIZE + TCMD_MAX_RESP_FNAME_LEN \
+)
+
+// Number of agenda entries which always fit, whatever the length of their strings.
+#define TCMD_ARENA_MIN_ENTRY_COUNT (TCMD_ARENA_SIZE_BYTES / TCMD_ARENA_MAX_BLOCK_SIZE_BYTES)
+
+#if TCMD_ARENA_SIZE_BYTES > 65535
+#error "TCMD_ARENA_SIZE_BYTES must fit in the uint16_t block offsets."
+#endif
+
+uint8_t TCMD_arena_store(uint16_t handle, const char args_str[], const char resp_fname[]);
+
+const char* TCMD_arena_get_args_str(uint16_t handle);
+
+const char* TCMD_arena_get_resp_fname(uint16_t handle);
+
+void TCMD_arena_free(uint16_t handle);
+
+uint16_t TCMD_arena_get_live_bytes();
+
+extern uint32_t TCMD_arena_compaction_count;
+
+#endif // INCLUDE_GUARD__AGENDA_STRING_ARENA_H
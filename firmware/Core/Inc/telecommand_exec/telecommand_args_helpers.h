@@ -3,6 +3,40 @@
 
 #include <stdint.h>
 
+// Number of arguments whose offsets are stored by `TCMD_tokenize_args`. Arguments past this are
+// still accessible, but are found by scanning forward from the last stored argument.
+#define TCMD_ARGS_MAX_TOKENIZED_COUNT 32
+
+/// @brief Offset/length table of the comma-separated arguments in an args string.
+/// @note Fill with `TCMD_tokenize_args`, then read with the `TCMD_args_get_*` accessors.
+///     Points into `args_str`, which must outlive this struct (no copy is made).
+typedef struct {
+    const char *args_str;
+    uint16_t args_str_len;
+
+    /// @brief Total number of arguments (commas + 1), or 0 if the args string is empty.
+    uint16_t arg_count;
+
+    uint16_t arg_start[TCMD_ARGS_MAX_TOKENIZED_COUNT];
+    uint16_t arg_len[TCMD_ARGS_MAX_TOKENIZED_COUNT];
+} TCMD_args_t;
+
+void TCMD_tokenize_args(const char *args_str, uint32_t args_str_len, TCMD_args_t *args);
+uint8_t TCMD_args_get_uint64(const TCMD_args_t *args, uint8_t arg_index, uint64_t *result);
+uint8_t TCMD_args_get_int64(const TCMD_args_t *args, uint8_t arg_index, int64_t *result);
+uint8_t TCMD_args_get_double(const TCMD_args_t *args, uint8_t arg_index, double *result);
+uint8_t TCMD_args_get_string(
+    const TCMD_args_t *args, uint8_t arg_index, char *result, uint16_t result_max_len
+);
+uint8_t TCMD_args_get_hex_array(
+    const TCMD_args_t *args, uint8_t arg_index,
+    uint8_t result_array[], uint16_t result_array_size, uint16_t *result_length
+);
+uint8_t TCMD_args_get_base64_array(
+    const TCMD_args_t *args, uint8_t arg_index,
+    uint8_t result_array[], uint16_t result_array_size, uint16_t *result_length
+);
+
 uint8_t TCMD_ascii_to_uint64(const char *str, uint32_t str_len, uint64_t *result);
 uint8_t TCMD_extract_uint64_arg(const char *str, uint32_t str_len, uint8_t arg_index, uint64_t *result);
 uint8_t TCMD_extract_string_arg(const char *str, uint8_t arg_index, char *result, uint16_t result_max_len);
@@ -8,5 +8,9 @@
 extern const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[];
 extern const int16_t TCMD_NUM_TELECOMMANDS;
 
+// From the generated `telecommand_name_index.c`.
+extern const uint8_t TCMD_telecommand_name_sorted_idx[];
+extern const int16_t TCMD_telecommand_name_sorted_idx_count;
+
                         
 #endif // INCLUDE_GUARD__TELECOMMAND_DEFINITIONS_H
\ No newline at end of file
@@ -12,12 +12,10 @@
 /// Max number of tssent timestamp values that can be stored at a time (for unique telecommand tssent validation).
 #define TCMD_TIMESTAMP_RECORD_SIZE 750
 
-extern TCMD_parsed_tcmd_to_execute_t TCMD_agenda[TCMD_AGENDA_SIZE];
+extern TCMD_agenda_entry_t TCMD_agenda[TCMD_AGENDA_SIZE];
 
 extern uint8_t TCMD_agenda_is_valid[TCMD_AGENDA_SIZE];
 
-extern uint16_t TCMD_agenda_last_used_slot;
-
 typedef enum {
     TCMD_AGENDA_ENTRY_INVALID = 0, // Initial state.
     TCMD_AGENDA_ENTRY_VALID_AND_PENDING = 1,
@@ -27,6 +25,10 @@ typedef enum {
 
 uint8_t TCMD_add_tcmd_to_agenda(const TCMD_parsed_tcmd_to_execute_t *parsed_tcmd);
 
+uint8_t TCMD_agenda_delete_slot(uint16_t slot_num);
+
+uint8_t TCMD_timestamp_sent_is_recorded(uint64_t timestamp_sent);
+
 uint16_t TCMD_get_agenda_used_slots_count();
 
 int16_t TCMD_get_next_tcmd_agenda_slot_to_execute();
@@ -37,6 +39,19 @@ uint8_t TCMD_execute_telecommand_in_agenda(const uint16_t tcmd_agenda_slot_num,
 
 uint8_t TCMD_log_pending_agenda_entries();
 
+/// @brief Reception-to-execution latency of immediate telecommands, from one `TCMD_rx_source_enum_t`.
+typedef struct {
+    uint32_t sample_count;
+    uint32_t last_latency_ms;
+    uint32_t min_latency_ms;
+    uint32_t max_latency_ms;
+    uint64_t total_latency_ms;
+} TCMD_rx_latency_stats_t;
+
+extern TCMD_rx_latency_stats_t TCMD_rx_latency_stats[TCMD_RX_SOURCE_COUNT];
+
+void TCMD_record_rx_latency(TCMD_rx_source_enum_t rx_source, uint32_t latency_ms);
+
 
 extern uint32_t TCMD_total_tcmd_queued_count;
 extern uint64_t TCMD_latest_received_tcmd_timestamp_sent;
@@ -15,6 +15,8 @@ uint8_t TCMD_is_char_alphanumeric(char c);
 uint8_t TCMD_is_char_valid_telecommand_name_char(char c);
 
 uint8_t TCMD_check_starts_with_device_id(const char *tcmd_str, uint32_t tcmd_str_len);
+
+int16_t TCMD_get_telecommand_idx_by_name(const char *name, uint16_t name_len);
 int32_t TCMD_parse_telecommand_get_index(const char *tcmd_str, uint32_t tcmd_str_len);
 
 uint8_t TCMD_process_suffix_tag_tssent(const char* tcmd_suffix_tag_str, const uint16_t tcmd_suffix_tag_str_len, uint64_t *tssent_time_ms); 
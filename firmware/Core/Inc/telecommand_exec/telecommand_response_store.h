@@ -0,0 +1,42 @@
+#ifndef INCLUDE_GUARD__TELECOMMAND_RESPONSE_STORE_H
+#define INCLUDE_GUARD__TELECOMMAND_RESPONSE_STORE_H
+
+#include <stdint.h>
+
+// Number of response files kept open at once (each holds a 2 KiB LittleFS cache buffer).
+#define TCMD_RESP_STORE_HANDLE_COUNT 2
+
+/// @brief Response store counters, since boot (or the last `TCMD_resp_store_reset_stats`).
+typedef struct {
+    uint32_t entry_count;
+    uint32_t bytes_written;
+
+    /// @brief Response files opened, and closed (evicted, flushed on shutdown, or not batching).
+    uint32_t open_count;
+    uint32_t close_count;
+
+    /// @brief Syncs of open files (metadata commits), excluding closes.
+    uint32_t sync_count;
+
+    /// @brief Open files dropped without a close, because the filesystem was unmounted or
+    ///     remounted under them (unsynced entries are lost).
+    uint32_t dropped_handle_count;
+
+    uint32_t error_count;
+} TCMD_resp_store_stats_t;
+
+extern uint32_t TCMD_resp_store_batching_enabled;
+extern uint32_t TCMD_resp_store_flush_bytes;
+extern uint32_t TCMD_resp_store_flush_age_ms;
+extern TCMD_resp_store_stats_t TCMD_resp_store_stats;
+
+int8_t TCMD_resp_store_write_entry(const char resp_fname[], const char header[], const char response[]);
+
+void TCMD_resp_store_flush_if_due(void);
+int8_t TCMD_resp_store_flush_all(void);
+int8_t TCMD_resp_store_close_all(void);
+
+void TCMD_resp_store_reset_stats(void);
+int16_t TCMD_resp_store_stats_to_json(char json_output_buf[], uint16_t json_output_buf_size);
+
+#endif // INCLUDE_GUARD__TELECOMMAND_RESPONSE_STORE_H
@@ -46,16 +46,46 @@ typedef struct {
 } TCMD_TelecommandDefinition_t;
 
 
+/// @brief Where a telecommand was received from, for latency tracking.
+typedef enum {
+    // Not uplinked directly (e.g., loaded from an agenda file, or enqueued by another telecommand).
+    TCMD_RX_SOURCE_NONE = 0,
+    TCMD_RX_SOURCE_UMBILICAL_UART = 1,
+    TCMD_RX_SOURCE_AX100 = 2,
+} TCMD_rx_source_enum_t;
+
+#define TCMD_RX_SOURCE_COUNT 3
+
 typedef struct {
     /// @brief The index of the telecommand in the `TCMD_telecommand_definitions` array.
     uint8_t tcmd_idx;
-    char args_str_no_parens[TCMD_ARGS_STR_NO_PARENS_SIZE]; // TODO: consider changing this to a pointer, and storing the args somewhere else to save memory
+    char args_str_no_parens[TCMD_ARGS_STR_NO_PARENS_SIZE];
     /// @brief The value of the `@tssent` field when the telecommand was received.
     uint64_t timestamp_sent;
     /// @brief The value of the `@tsexec` field when the telecommand was received.
     uint64_t timestamp_to_execute;
     /// @brief Name of file that response should be written to, empty string otherwise
     char resp_fname[TCMD_MAX_RESP_FNAME_LEN];
+    /// @brief Where the telecommand was received from. Set by the receiver, after parsing.
+    TCMD_rx_source_enum_t rx_source;
+    /// @brief `TIME_uptime_ms()` when the telecommand was received by the UART ISR (if `rx_source` isn't NONE).
+    uint32_t uptime_at_rx_ms;
 } TCMD_parsed_tcmd_to_execute_t;
 
+/// @brief An entry in the agenda (`TCMD_agenda`).
+/// @note The args and response filename are stored at their actual length in the agenda string
+///       arena (`agenda_string_arena.h`), with the agenda slot number as the handle.
+typedef struct {
+    /// @brief The value of the `@tssent` field when the telecommand was received.
+    uint64_t timestamp_sent;
+    /// @brief The value of the `@tsexec` field when the telecommand was received.
+    uint64_t timestamp_to_execute;
+    /// @brief `TIME_uptime_ms()` when the telecommand was received by the UART ISR (if `rx_source` isn't NONE).
+    uint32_t uptime_at_rx_ms;
+    /// @brief The index of the telecommand in the `TCMD_telecommand_definitions` array.
+    uint8_t tcmd_idx;
+    /// @brief Where the telecommand was received from (`TCMD_rx_source_enum_t`).
+    uint8_t rx_source;
+} TCMD_agenda_entry_t;
+
 #endif // INCLUDE_GUARD__TELECOMMAND_TYPES_H
@@ -36,4 +36,14 @@ uint8_t TCMDEXEC_agenda_enqueue_from_file(
     char *response_output_buf, uint16_t response_output_buf_len
 );
 
+uint8_t TCMDEXEC_agenda_get_rx_latency_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
+
+uint8_t TCMDEXEC_agenda_flush_response_files(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
+
 #endif // INCLUDE_GUARD__AGENDA_TELECOMMAND_DEFINITIONS_H
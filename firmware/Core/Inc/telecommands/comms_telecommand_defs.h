@@ -20,6 +20,18 @@ uint8_t TCMDEXEC_comms_bulk_file_downlink_start(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 );
+uint8_t TCMDEXEC_comms_bulk_file_downlink_start_compressed(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
+uint8_t TCMDEXEC_comms_bulk_file_downlink_nack(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
+uint8_t TCMDEXEC_comms_get_tx_pacing_stats_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
 uint8_t TCMDEXEC_comms_bulk_file_downlink_pause(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
@@ -24,12 +24,18 @@ uint8_t TCMDEXEC_flash_erase(const char *args_str,
 uint8_t TCMDEXEC_flash_benchmark_erase_write_read(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len);
 
+uint8_t TCMDEXEC_flash_benchmark_sequential_read(const char *args_str,
+                        char *response_output_buf, uint16_t response_output_buf_len);
+
 uint8_t TCMDEXEC_flash_reset(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len);
 
 uint8_t TCMDEXEC_flash_read_status_register(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len);
 
+uint8_t TCMDEXEC_flash_get_busy_time_stats_json(const char *args_str,
+                        char *response_output_buf, uint16_t response_output_buf_len);
+
 uint8_t TCMDEXEC_flash_force_corrupt_filesystem(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
@@ -21,6 +21,11 @@ uint8_t TCMDEXEC_fs_list_directory_json(
     char *response_output_buf, uint16_t response_output_buf_len
 );
 
+uint8_t TCMDEXEC_fs_list_directory_page_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
+
 uint8_t TCMDEXEC_fs_make_directory(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len);
 
@@ -63,6 +68,11 @@ uint8_t TCMDEXEC_fs_get_filesystem_stats_json(
     char *response_output_buf, uint16_t response_output_buf_len
 );
 
+uint8_t TCMDEXEC_fs_get_page_cache_stats_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
+
 uint8_t TCMDEXEC_fs_compress_file_with_heatshrink(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
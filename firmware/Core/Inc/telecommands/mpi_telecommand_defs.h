@@ -25,4 +25,14 @@ uint8_t TCMDEXEC_mpi_enable_active_mode(const char *args_str,
 uint8_t TCMDEXEC_mpi_disable_active_mode(const char *args_str, 
     char *response_output_buf, uint16_t response_output_buf_len);
 
+uint8_t TCMDEXEC_mpi_downlink_range(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
+
+uint8_t TCMDEXEC_mpi_extract_range_to_file(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
+
 #endif /* INCLUDE_GUARD__MPI_TELECOMMAND_DEFINITIONS_H__ */
\ No newline at end of file
@@ -24,4 +24,9 @@ uint8_t TCMDEXEC_demo_os_delay(
     char *response_output_buf, uint16_t response_output_buf_len
 );
 
+uint8_t TCMDEXEC_crypto_benchmark_sha256_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+);
+
 #endif // INCLUDE_GUARD__TESTING_TELECOMMAND_DEFINITIONS_H
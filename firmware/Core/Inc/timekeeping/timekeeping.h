@@ -29,6 +29,10 @@ void TIME_format_timestamp_str(
     uint32_t uptime_ms, TIME_sync_source_enum_t sync_source
 );
 void TIME_get_current_timestamp_str(char *dest_str, size_t dest_str_size); 
+void TIME_format_resync_offset_timestamp_str(
+    char dest_str[], size_t dest_str_size,
+    uint64_t unix_epoch_time_at_resync_ms, uint32_t ms_since_resync, TIME_sync_source_enum_t sync_source
+);
 
 void TIME_format_utc_datetime_str(
     char *dest_str, size_t dest_str_size,
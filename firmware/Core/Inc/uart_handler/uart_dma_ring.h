@@ -0,0 +1,50 @@
+#ifndef INCLUDE_GUARD__UART_DMA_RING_H__
+#define INCLUDE_GUARD__UART_DMA_RING_H__
+
+#include <stdint.h>
+
+/// @brief A circular DMA receive buffer, and the consumer's position in it.
+/// @note Single producer (the UART RX event ISR), single consumer (one task, or the same ISR).
+///     The producer only writes `dma_write_pos`, `total_bytes_written`, `restart_total_bytes_written`
+///     and `rx_event_count`, and the consumer only writes `total_bytes_read` and `overrun_bytes_lost`,
+///     so no lock is needed.
+typedef struct {
+    /// @brief The circular DMA target buffer. Written by the DMA, never by the CPU.
+    volatile uint8_t *buffer;
+
+    /// @brief Length of `buffer`. Must be a power of two, so that the byte totals wrap cleanly.
+    uint16_t buffer_len;
+
+    /// @brief Index in `buffer` that the DMA will write next, as of the last RX event.
+    volatile uint16_t dma_write_pos;
+
+    /// @brief Bytes written by the DMA, as of the last RX event. Wraps at 2^32.
+    volatile uint32_t total_bytes_written;
+
+    /// @brief Value of `total_bytes_written` when the DMA was last restarted. Unread bytes from
+    ///     before this point were discarded by the restart.
+    volatile uint32_t restart_total_bytes_written;
+
+    /// @brief Number of RX events (half-transfer, transfer-complete, or IDLE line).
+    volatile uint32_t rx_event_count;
+
+    /// @brief Bytes consumed (read or discarded). Wraps at 2^32.
+    uint32_t total_bytes_read;
+
+    /// @brief Bytes overwritten by the DMA before they were read.
+    uint32_t overrun_bytes_lost;
+} UART_dma_ring_t;
+
+uint8_t UART_dma_ring_init(UART_dma_ring_t *ring, volatile uint8_t *buffer, uint16_t buffer_len);
+
+void UART_dma_ring_restart(UART_dma_ring_t *ring);
+
+uint16_t UART_dma_ring_on_rx_event(UART_dma_ring_t *ring, uint16_t dma_write_pos);
+
+uint16_t UART_dma_ring_available(const UART_dma_ring_t *ring);
+
+uint16_t UART_dma_ring_read(UART_dma_ring_t *ring, uint8_t dest[], uint16_t dest_max_len);
+
+void UART_dma_ring_discard_all(UART_dma_ring_t *ring);
+
+#endif // INCLUDE_GUARD__UART_DMA_RING_H__
@@ -5,6 +5,7 @@
 #include "stm32l4xx_hal.h"
 #include <stdint.h>
 #include "mpi/mpi_types.h"
+#include "uart_handler/uart_dma_ring.h"
 
 
 typedef enum {
@@ -25,9 +26,6 @@ extern UART_HandleTypeDef *UART_gnss_port_handle;
 extern UART_HandleTypeDef *UART_camera_port_handle;
 extern UART_HandleTypeDef *UART_eps_port_handle;
 
-extern const uint16_t UART_telecommand_buffer_len;              // Length of the UART telecommand buffer
-extern volatile uint8_t UART_telecommand_buffer[];              // Buffer for UART telecommands
-extern volatile uint16_t UART_telecommand_buffer_write_idx;     // Write index for UART telecommand buffer
 extern volatile uint32_t UART_telecommand_last_write_time_ms;   // Last write time in milliseconds for UART telecommand
 
 extern const uint16_t UART_mpi_buffer_len;                      // Length of the MPI response buffer (for telecommand responses only & NOT SCIENCE DATA)
@@ -38,9 +36,7 @@ extern volatile uint8_t UART_mpi_last_rx_byte;                  // Last received
 
 extern volatile uint32_t UART_ax100_last_write_time_ms;       // Last write time in milliseconds for AX100 response
 
-extern const uint16_t UART_gnss_buffer_len;                      // Length of the GNSS response buffer
-extern volatile uint8_t UART_gnss_buffer[];                      // Buffer for GNSS response
-extern volatile uint16_t UART_gnss_buffer_write_idx;             // Write index for GNSS response buffer
+extern UART_dma_ring_t UART_gnss_rx_ring;                       // Circular DMA buffer of GNSS data (read with `UART_dma_ring_read`)
 extern volatile uint32_t UART_gnss_last_write_time_ms;           // Last write time in milliseconds for GNSS response
 
 extern const uint16_t UART_camera_dma_buffer_len;               // Length of the CAMERA DMA buffer
@@ -56,43 +52,36 @@ extern volatile uint16_t UART_eps_buffer_write_idx;             // Write index f
 extern volatile uint32_t UART_eps_last_write_time_ms;           // Last write time in milliseconds for EPS response
 extern volatile uint8_t UART_eps_is_expecting_data;             // Set to 1 when a command is sent, and we're awaiting a response
 
-extern const uint16_t UART_gnss_buffer_len; 
-extern volatile uint8_t UART_gnss_buffer[];          
-extern volatile uint16_t UART_gnss_buffer_write_idx; 
-extern volatile uint32_t UART_gnss_last_write_time_ms; 
-extern volatile uint8_t UART_gnss_buffer_last_rx_byte;  
-extern volatile uint8_t UART_gnss_uart_interrupt_enabled; // Flag to enable or disable the UART GNSS ISR
+extern volatile uint8_t UART_gnss_uart_interrupt_enabled; // Flag to enable or disable the UART GNSS reception
 
-// UART MPI Science data buffers.
-extern const uint8_t UART_mpi_rx_dma_buffer_len;
-extern volatile uint8_t UART_mpi_rx_dma_buffer[];
-extern const uint16_t MPI_science_buffer_len;
-extern volatile uint8_t MPI_science_buffer_one[];
-extern volatile uint8_t MPI_science_buffer_two[];
 
-extern volatile MPI_buffer_state_enum_t MPI_buffer_one_state;
-extern volatile MPI_buffer_state_enum_t MPI_buffer_two_state;
-
-extern volatile uint32_t MPI_buffer_one_last_filled_uptime_ms;
-extern volatile uint32_t MPI_buffer_two_last_filled_uptime_ms;
+// Max length of a telecommand received on the umbilical UART (longer ones are discarded).
+#define UART_TELECOMMAND_MAX_FRAME_SIZE_BYTES 256
 
+/// @brief A telecommand received on the umbilical UART, as passed from the ISR to the RX task.
+typedef struct {
+    /// @brief `TIME_uptime_ms()` when the last byte of the frame was received.
+    uint32_t uptime_at_rx_ms;
+    uint8_t data[UART_TELECOMMAND_MAX_FRAME_SIZE_BYTES];
+} UART_telecommand_rx_frame_t;
 
 #define AX100_MAX_KISS_FRAMES_IN_RX_QUEUE  8
 #define AX100_MAX_KISS_FRAME_SIZE_BYTES    500 // Could be as low as 256, probably.
 
+/// @brief A KISS frame received from the AX100, as passed from the ISR to the RX task.
 typedef struct {
+    /// @brief `TIME_uptime_ms()` when the end of the frame was received.
+    uint32_t uptime_at_rx_ms;
     uint8_t data[AX100_MAX_KISS_FRAME_SIZE_BYTES];
-    uint16_t len;
 } AX100_kiss_frame_struct_t;
 
-extern volatile AX100_kiss_frame_struct_t UART_AX100_kiss_frame_queue[AX100_MAX_KISS_FRAMES_IN_RX_QUEUE];
-extern volatile uint8_t UART_AX100_kiss_frame_queue_head;
-extern volatile uint8_t UART_AX100_kiss_frame_queue_tail;
-
-
 
 void UART_init_uart_handlers(void);
 void GNSS_set_uart_interrupt_state(uint8_t new_enabled) ;
 uint8_t CAMERA_set_expecting_data(uint8_t new_enabled) ;
+HAL_StatusTypeDef UART_mpi_start_science_rx_dma(void);
+
+uint16_t UART_receive_telecommand_frame(UART_telecommand_rx_frame_t *frame_out, uint32_t timeout_ms);
+uint16_t UART_receive_ax100_kiss_frame(AX100_kiss_frame_struct_t *frame_out, uint32_t timeout_ms);
 
 #endif // INCLUDE_GUARD__UART_HANDLER_H__
@@ -8,5 +8,8 @@ uint8_t TEST_EXEC__TCMD_extract_hex_array_arg();
 uint8_t TEST_EXEC__TCMD_ascii_to_int64();
 uint8_t TEST_EXEC__TCMD_extract_int64_arg();
 
+uint8_t TEST_EXEC__TCMD_tokenize_args();
+uint8_t TEST_EXEC__TCMD_args_get_accessors();
+
 #endif // INCLUDE_GUARD__TEST_COMMAND_ARG_HELPERS_H__
 
@@ -7,6 +7,7 @@
 uint8_t TEST_EXEC__TCMD_is_char_alphanumeric();
 
 uint8_t TEST_EXEC__TCMD_check_starts_with_device_id();
+uint8_t TEST_EXEC__TCMD_get_telecommand_idx_by_name();
 uint8_t TEST_EXEC__TCMD_get_suffix_tag_uint64();
 uint8_t TEST_EXEC__TCMD_get_suffix_tag_str();
 
@@ -12,6 +12,7 @@
 #include "adcs_drivers/adcs_commands.h"
 #include "adcs_drivers/adcs_internal_drivers.h"
 #include "adcs_drivers/adcs_types_enum_to_str.h"
+#include "comms_drivers/ax100_tx.h"
 #include "timekeeping/timekeeping.h"
 #include "log/log.h"
 #include "stm32/stm32_watchdog.h"
@@ -360,6 +361,7 @@ uint8_t ADCS_get_llh_position(ADCS_llh_position_struct_t *output_struct) {
 /// @return 0 if successful, non-zero if a HAL or ADCS error occurred in transmission.
 uint8_t ADCS_bootloader_clear_errors() {
     uint8_t data_send[1] = {ADCS_COMMAND_BOOTLOADER_CLEAR_ERRORS}; // 0-byte data (from manual) input into wrapper, but one-byte here to avoid warnings
+    AX100_wait_for_tx_idle(); // I2C1 is shared with the AX100.
     const uint8_t hal_status = HAL_I2C_Master_Transmit(ADCS_i2c_HANDLE, ADCS_i2c_ADDRESS << 1, data_send, 1, ADCS_HAL_TIMEOUT);
         // The bootloader doesn't support checksum, and this is a zero-parameter command, so HAL_I2C_Mem_Write can't be used (zero length message).
     return hal_status;
@@ -2119,6 +2121,7 @@ uint8_t ADCS_erase_sd_file_by_checksum(uint16_t file_checksum) {
 /// @note This function always returns an error, because if the ADCS leaves the bootloader it can't confirm this command, which commands it to leave the bootloader
 uint8_t ADCS_bootloader_run_program() {
     uint8_t data_send[1] = {ADCS_COMMAND_BOOTLOADER_RUN_PROGRAM};
+    AX100_wait_for_tx_idle(); // I2C1 is shared with the AX100.
     const uint8_t hal_status = HAL_I2C_Master_Transmit(ADCS_i2c_HANDLE, ADCS_i2c_ADDRESS << 1, data_send, 1, ADCS_HAL_TIMEOUT);
         // The bootloader doesn't support checksum, and this is a zero-parameter command, so HAL_I2C_Mem_Write can't be used (zero length message).
     return hal_status;
@@ -4,6 +4,7 @@
 #include "adcs_drivers/adcs_types_to_json.h"
 #include "adcs_drivers/adcs_commands.h"
 #include "adcs_drivers/adcs_internal_drivers.h"
+#include "comms_drivers/ax100_tx.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
@@ -97,6 +98,8 @@ uint8_t ADCS_send_i2c_telecommand(uint8_t id, uint8_t* data, uint32_t data_lengt
     // include checksum following data if enabled
     if (include_checksum) {buf[data_length] = ADCS_calculate_crc8_checksum(data, data_length);}
 
+    // I2C1 is shared with the AX100, which may have a DMA transfer in flight.
+    AX100_wait_for_tx_idle();
     ADCS_CMD_status = HAL_I2C_Mem_Write(ADCS_i2c_HANDLE, ADCS_i2c_ADDRESS << 1, id, 1, buf, sizeof(buf), ADCS_HAL_TIMEOUT);
 
     /* When sending a command to the CubeACP, it is possible to include an 8-bit CRC checksum.
@@ -130,6 +133,8 @@ uint8_t ADCS_send_i2c_telemetry_request(uint8_t id, uint8_t* data, uint32_t data
     uint8_t temp_data[data_length + include_checksum];
         // temp data used for checksum checking
 
+    // I2C1 is shared with the AX100, which may have a DMA transfer in flight.
+    AX100_wait_for_tx_idle();
     adcs_tlm_status = HAL_I2C_Mem_Read(ADCS_i2c_HANDLE, ADCS_i2c_ADDRESS << 1, id, 1, temp_data, sizeof(temp_data), ADCS_HAL_TIMEOUT);
 
     for (uint32_t i = 0; i < data_length; i++) {
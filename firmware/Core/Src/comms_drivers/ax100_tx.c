@@ -1,6 +1,8 @@
 #include "main.h"
+#include "cmsis_os.h"
 #include "comms_drivers/ax100_tx.h"
 #include "comms_drivers/ax100_hw.h"
+#include "comms_drivers/ax100_tx_pacing.h"
 #include "log/log.h"
 #include "debug_tools/debug_uart.h"
 #include "rtos_tasks/rtos_bootup_operation_fsm_task.h"
@@ -36,13 +38,49 @@ static const uint32_t use_crc = 0; // crc
 static const uint32_t AX100_i2c_tx_timeout_ms = 100;
 
 
-/// @brief Write the csp header (4 bytes) to the beginning of the packet, then copy the rest of `data` into `destination`.
-/// @param destination where the assembled packet will be stored
-/// @param data data to place in the packet
-/// @param data_len length of data
-static void prepend_csp_header(uint8_t *destination, uint8_t *data, uint32_t data_len) {
-    // TODO: Rewrite this to do the shifting in the construction here.
-    
+/// @brief When enabled, packets are sent to the AX100 with DMA, and the sending task can keep
+///     working (or let other tasks run) while the I2C transfer is in flight.
+/// @note When disabled, the blocking (polling) HAL transmit is used.
+uint32_t AX100_tx_dma_enabled = 1;
+
+typedef enum {
+    AX100_TX_BUFFER_FREE,
+    AX100_TX_BUFFER_FILLING, // Acquired by a producer.
+    AX100_TX_BUFFER_IN_FLIGHT, // I2C transfer started.
+    AX100_TX_BUFFER_DONE, // I2C transfer ended (`status` is set).
+} AX100_tx_buffer_state_enum_t;
+
+/// @brief A packet buffer, with headroom for the CSP header before the payload.
+typedef struct {
+    uint8_t packet[AX100_CSP_HEADER_LENGTH_BYTES + AX100_DOWNLINK_MAX_BYTES];
+    volatile AX100_tx_buffer_state_enum_t state;
+    volatile HAL_StatusTypeDef status;
+    uint8_t release_on_done; // Sent with `AX100_send_tx_buffer` (nobody waits for the result).
+    uint16_t packet_size;
+    uint32_t start_ms;
+    volatile uint32_t end_ms;
+} AX100_tx_buffer_t;
+
+// Two buffers: a producer can fill one while the other is in flight.
+#define AX100_TX_BUFFER_COUNT 2
+static AX100_tx_buffer_t AX100_tx_buffers[AX100_TX_BUFFER_COUNT];
+
+// The buffer whose DMA transfer is in flight (at most one). Cleared by the I2C1 callbacks.
+static AX100_tx_buffer_t * volatile AX100_tx_in_flight_buffer = NULL;
+
+// Set while a timed-out transfer is being aborted (I2C1 isn't free yet). Cleared by the abort's callback.
+static volatile uint8_t AX100_tx_abort_in_progress = 0;
+static uint32_t AX100_tx_abort_start_ms = 0;
+
+// First failure of a transfer sent with `AX100_send_tx_buffer`, not yet returned to a caller.
+static uint8_t AX100_tx_unreported_send_error = 0;
+
+/// @brief Number of transfers sent with `AX100_send_tx_buffer` which failed after it returned.
+uint32_t AX100_tx_send_error_count = 0;
+
+
+/// @brief Write the csp header (4 bytes) into the headroom at the beginning of the packet buffer.
+static void write_csp_header(uint8_t *destination) {
     const uint32_t csp_header = (
         csp_priority | own_csp_addr | ground_station_csp_addr |
         ground_station_csp_port | own_csp_port | use_hmac | use_xtea | use_rdp | use_crc
@@ -52,15 +90,179 @@ static void prepend_csp_header(uint8_t *destination, uint8_t *data, uint32_t dat
     destination[1] = (csp_header >> 16) & 0xFF;
     destination[2] = (csp_header >> 8) & 0xFF;
     destination[3] = csp_header & 0xFF;
+}
 
-    // Copy data into packet.
-    memcpy(&destination[AX100_CSP_HEADER_LENGTH_BYTES], data, data_len);
+/// @brief Get the buffer whose payload area starts at `payload`.
+/// @return The buffer, or NULL if `payload` isn't from `AX100_acquire_tx_buffer`.
+static AX100_tx_buffer_t *get_tx_buffer_from_payload(const uint8_t *payload) {
+    for (uint8_t i = 0; i < AX100_TX_BUFFER_COUNT; i++) {
+        if (payload == &AX100_tx_buffers[i].packet[AX100_CSP_HEADER_LENGTH_BYTES]) {
+            return &AX100_tx_buffers[i];
+        }
+    }
+    return NULL;
 }
 
+/// @brief Handle the end of a buffer's transfer, in task context: update the pacing model, and log errors.
+/// @return 0 if the transfer succeeded, else the HAL status.
+static uint8_t finish_tx_buffer(AX100_tx_buffer_t *buffer) {
+    if (buffer->packet_size == 0) {
+        return 0; // Downlink was inhibited: nothing was sent.
+    }
+
+    const HAL_StatusTypeDef status = buffer->status;
+    AX100_tx_pacing_record_send(buffer->packet_size, buffer->start_ms, buffer->end_ms, (status != HAL_OK));
+
+    if (status != HAL_OK) {
+        LOG_message(
+            LOG_SYSTEM_UHF_RADIO, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_UHF_RADIO),
+            "HAL I2C transmit error: %d", status
+        );
+    }
+    return status;
+}
+
+/// @brief Check on the transfer in flight (aborting it if it timed out), and release the buffers
+///     sent with `AX100_send_tx_buffer` whose transfers have ended (latching their errors).
+static void reap_tx_buffers(void) {
+    AX100_tx_buffer_t *in_flight = AX100_tx_in_flight_buffer;
+    if ((in_flight != NULL) && ((HAL_GetTick() - in_flight->start_ms) > AX100_i2c_tx_timeout_ms)) {
+        // Clear first, so that the abort's callbacks don't touch the buffer.
+        AX100_tx_in_flight_buffer = NULL;
+        AX100_tx_abort_in_progress = 1;
+        AX100_tx_abort_start_ms = HAL_GetTick();
+        if (HAL_I2C_Master_Abort_IT(AX100_I2C_HANDLE, AX100_I2C_ADDR << 1) != HAL_OK) {
+            // Nothing to abort: the transfer ended as it timed out.
+            AX100_tx_abort_in_progress = 0;
+        }
+        in_flight->status = HAL_TIMEOUT;
+        in_flight->end_ms = HAL_GetTick();
+        in_flight->state = AX100_TX_BUFFER_DONE;
+    }
+
+    if (AX100_tx_abort_in_progress && ((HAL_GetTick() - AX100_tx_abort_start_ms) > AX100_i2c_tx_timeout_ms)) {
+        // Don't hang the senders (and the ADCS) on an abort which never completes.
+        AX100_tx_abort_in_progress = 0;
+        LOG_message(
+            LOG_SYSTEM_UHF_RADIO, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_UHF_RADIO),
+            "AX100 I2C transfer abort didn't complete. I2C state: 0x%02X", HAL_I2C_GetState(AX100_I2C_HANDLE)
+        );
+    }
+
+    for (uint8_t i = 0; i < AX100_TX_BUFFER_COUNT; i++) {
+        AX100_tx_buffer_t *buffer = &AX100_tx_buffers[i];
+        if ((buffer->state == AX100_TX_BUFFER_DONE) && buffer->release_on_done) {
+            const uint8_t result = finish_tx_buffer(buffer);
+            if (result != 0) {
+                AX100_tx_send_error_count++;
+                if (AX100_tx_unreported_send_error == 0) {
+                    AX100_tx_unreported_send_error = result;
+                }
+            }
+            buffer->state = AX100_TX_BUFFER_FREE;
+        }
+    }
+}
+
+/// @brief Get and clear the first failure of the transfers sent with `AX100_send_tx_buffer` which
+///     ended since the last call.
+/// @return 0 if none failed, else the HAL status of the first to fail.
+static uint8_t take_unreported_send_error(void) {
+    const uint8_t error = AX100_tx_unreported_send_error;
+    AX100_tx_unreported_send_error = 0;
+    return error;
+}
+
+/// @brief Wait until no transfer to the AX100 is in flight or being aborted (so I2C1 is free).
+/// @note Other tasks run while waiting. Transfers are aborted after `AX100_i2c_tx_timeout_ms`.
+/// @note Call before using I2C1 for other devices (e.g., the ADCS), as a DMA transfer to the
+///     AX100 may still be running.
+void AX100_wait_for_tx_idle(void) {
+    reap_tx_buffers();
+    while ((AX100_tx_in_flight_buffer != NULL) || AX100_tx_abort_in_progress) {
+        osDelay(1);
+        reap_tx_buffers();
+    }
+}
+
+/// @brief Wait for the transfers sent with `AX100_send_tx_buffer` to end.
+/// @return 0 if they all succeeded, else the HAL status of the first to fail (since the last
+///     `AX100_send_tx_buffer` or `AX100_flush_tx_buffers` which returned it).
+uint8_t AX100_flush_tx_buffers(void) {
+    AX100_wait_for_tx_idle();
+    return take_unreported_send_error();
+}
+
+/// @brief Get a packet buffer to write a downlink packet's payload into.
+/// @return Pointer to the payload area (`AX100_DOWNLINK_MAX_BYTES` bytes), or NULL if no buffer
+///     became free in time. The CSP header is written into headroom before it when sent.
+/// @note Pass the buffer to `AX100_send_tx_buffer`, `AX100_start_tx_buffer`, or
+///     `AX100_release_tx_buffer`.
+uint8_t *AX100_acquire_tx_buffer(void) {
+    const uint32_t start_ms = HAL_GetTick();
+    while (1) {
+        reap_tx_buffers();
+        for (uint8_t i = 0; i < AX100_TX_BUFFER_COUNT; i++) {
+            AX100_tx_buffer_t *buffer = &AX100_tx_buffers[i];
+            if (buffer->state == AX100_TX_BUFFER_FREE) {
+                buffer->state = AX100_TX_BUFFER_FILLING;
+                buffer->release_on_done = 0;
+                return &buffer->packet[AX100_CSP_HEADER_LENGTH_BYTES];
+            }
+        }
+
+        // Both buffers are being filled by other tasks, or are in flight.
+        if ((HAL_GetTick() - start_ms) > (2 * AX100_i2c_tx_timeout_ms)) {
+            LOG_message(
+                LOG_SYSTEM_UHF_RADIO, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_UHF_RADIO),
+                "No AX100 TX buffer is free."
+            );
+            return NULL;
+        }
+        osDelay(1);
+    }
+}
+
+/// @brief Give back a buffer from `AX100_acquire_tx_buffer` without sending it.
+void AX100_release_tx_buffer(uint8_t *payload) {
+    AX100_tx_buffer_t *buffer = get_tx_buffer_from_payload(payload);
+    if (buffer != NULL) {
+        buffer->state = AX100_TX_BUFFER_FREE;
+    }
+}
+
+/// @brief Start sending a packet buffer to the AX100, and return without waiting for the transfer.
+/// @param payload Payload area from `AX100_acquire_tx_buffer`.
+/// @param payload_len Number of bytes written to the payload area.
+/// @return 0 if the transfer was started (or downlink is inhibited), >0 on error.
+/// @note Must be followed by `AX100_finish_tx_buffer`, which gets the result and releases the buffer.
+uint8_t AX100_start_tx_buffer(uint8_t *payload, uint16_t payload_len) {
+    AX100_tx_buffer_t *buffer = get_tx_buffer_from_payload(payload);
+    if ((buffer == NULL) || (buffer->state != AX100_TX_BUFFER_FILLING)) {
+        return 1;
+    }
+
+    if (payload_len > AX100_DOWNLINK_MAX_BYTES) {
+        LOG_message(
+            LOG_SYSTEM_UHF_RADIO, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_UHF_RADIO),
+            "AX100 downlink data length too long: %d > %d", payload_len, AX100_DOWNLINK_MAX_BYTES
+        );
+        payload_len = AX100_DOWNLINK_MAX_BYTES;
+    }
+
+    write_csp_header(buffer->packet);
+    buffer->packet_size = payload_len + AX100_CSP_HEADER_LENGTH_BYTES;
+
+    // Any network layer (CSP) things should be done here (e.g., XTEA, CRC, etc.)
+
+    // Debugging write to UART.
+    if (AX100_enable_downlink_uart_logs) {
+        DEBUG_uart_print_mixed_array(
+            buffer->packet, buffer->packet_size,
+            ((COMMS_active_rf_switch_antenna == 1) ? "AX100 Down [ANT1]" : "AX100 Down [ANT2]")
+        );
+    }
 
-/// @brief Send a csp packet over i2c to the AX100 for downlink.
-/// @note Only use in this file.
-static uint8_t send_bytes_to_ax100(uint8_t *packet, uint16_t packet_size) {
     if (CTS1_operation_state != CTS1_OPERATION_STATE_NOMINAL_WITH_RADIO_TX) {
         // Recall: Do not transmit on the AX100 until the antenna is deployed.
         // The Bootup Operation FSM task will set the operation mode to NOMINAL_WITH_RADIO_TX
@@ -68,58 +270,145 @@ static uint8_t send_bytes_to_ax100(uint8_t *packet, uint16_t packet_size) {
         if (AX100_enable_downlink_inhibited_uart_logs) {
             DEBUG_uart_print_str("AX100 downlink inhibited because antenna not deployed.\n");
         }
-        
-        // Return success to avoid lots of errors. It's not really an error case, as this is expected during early ops.
+
+        // Succeed without sending (and without counting it as sent for pacing), to avoid lots of
+        // errors. It's not really an error case, as this is expected during early ops.
+        buffer->status = HAL_OK;
+        buffer->packet_size = 0;
+        buffer->state = AX100_TX_BUFFER_DONE;
+        return 0;
+    }
+
+    // One transfer at a time: wait for the previous packet to finish.
+    AX100_wait_for_tx_idle();
+
+    buffer->start_ms = HAL_GetTick();
+    if (!AX100_tx_dma_enabled) {
+        buffer->status = HAL_I2C_Master_Transmit(
+            AX100_I2C_HANDLE,
+            AX100_I2C_ADDR << 1,
+            buffer->packet,
+            buffer->packet_size,
+            AX100_i2c_tx_timeout_ms
+        );
+        buffer->end_ms = HAL_GetTick();
+        buffer->state = AX100_TX_BUFFER_DONE;
         return 0;
     }
 
-    const HAL_StatusTypeDef status = HAL_I2C_Master_Transmit(
+    buffer->state = AX100_TX_BUFFER_IN_FLIGHT;
+    AX100_tx_in_flight_buffer = buffer;
+    const HAL_StatusTypeDef start_status = HAL_I2C_Master_Transmit_DMA(
         AX100_I2C_HANDLE,
-        AX100_I2C_ADDR << 1, 
-        packet,
-        packet_size, 
-        AX100_i2c_tx_timeout_ms
+        AX100_I2C_ADDR << 1,
+        buffer->packet,
+        buffer->packet_size
     );
-    
-    if (status != HAL_OK) {
-        LOG_message(
-            LOG_SYSTEM_UHF_RADIO, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_UHF_RADIO),
-            "HAL I2C transmit error: %d", status
-        );
-        return status;
+    if (start_status != HAL_OK) {
+        AX100_tx_in_flight_buffer = NULL;
+        buffer->status = start_status;
+        buffer->end_ms = HAL_GetTick();
+        buffer->state = AX100_TX_BUFFER_DONE;
+        return start_status;
     }
-    
     return 0;
 }
 
-// Statically allocated packet buffer for downlink.
-// Note: Only used in `AX100_downlink_bytes`
-static uint8_t packet_buffer_including_csp_header[AX100_DOWNLINK_MAX_BYTES + AX100_CSP_HEADER_LENGTH_BYTES];
+/// @brief Wait for the transfer started by `AX100_start_tx_buffer`, and release the buffer.
+/// @return 0 on success, >0 if the transfer failed (e.g., the AX100 NACKed it because its queue was full).
+uint8_t AX100_finish_tx_buffer(uint8_t *payload) {
+    AX100_tx_buffer_t *buffer = get_tx_buffer_from_payload(payload);
+    if (buffer == NULL) {
+        return 1;
+    }
+    while (buffer->state == AX100_TX_BUFFER_IN_FLIGHT) {
+        osDelay(1);
+        reap_tx_buffers();
+    }
+    if (buffer->state != AX100_TX_BUFFER_DONE) {
+        // Not started (e.g., a bad `payload_len`).
+        buffer->state = AX100_TX_BUFFER_FREE;
+        return 1;
+    }
+
+    const uint8_t result = finish_tx_buffer(buffer);
+    buffer->state = AX100_TX_BUFFER_FREE;
+    return result;
+}
+
+/// @brief Send a packet buffer to the AX100 without waiting for the result (the buffer is released
+///     when the transfer ends, and failures are logged).
+/// @param payload Payload area from `AX100_acquire_tx_buffer`.
+/// @param payload_len Number of bytes written to the payload area.
+/// @return 0 if the transfer was started (or downlink is inhibited), >0 on error: this packet
+///     couldn't be started, or an earlier packet sent with this function failed after it returned.
+/// @note This packet's own result comes from a later call, or from `AX100_flush_tx_buffers`.
+uint8_t AX100_send_tx_buffer(uint8_t *payload, uint16_t payload_len) {
+    AX100_tx_buffer_t *buffer = get_tx_buffer_from_payload(payload);
+    const uint8_t start_result = AX100_start_tx_buffer(payload, payload_len);
+    if ((start_result != 0) || (buffer == NULL)) {
+        AX100_finish_tx_buffer(payload);
+        return (start_result != 0) ? start_result : 1;
+    }
 
-/// @brief Send data to the ax100 for downlink
+    buffer->release_on_done = 1;
+    reap_tx_buffers();
+    return take_unreported_send_error();
+}
+
+/// @brief Send data to the ax100 for downlink, and wait for the transfer.
 /// @param data pointer to the data to downlink
 /// @param data_len length of the data
 /// @return 0 on success, >0 on error/failure
+/// @note Copies `data`. Producers which can build the packet in place should use
+///     `AX100_acquire_tx_buffer` instead.
 uint8_t AX100_downlink_bytes(uint8_t *data, uint16_t data_len) {
+    uint8_t *payload = AX100_acquire_tx_buffer();
+    if (payload == NULL) {
+        return 1;
+    }
+
     if (data_len > AX100_DOWNLINK_MAX_BYTES) {
-        LOG_message(
-            LOG_SYSTEM_UHF_RADIO, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_UHF_RADIO),
-            "AX100 downlink data length too long: %d > %d", data_len, AX100_DOWNLINK_MAX_BYTES
-        );
-        data_len = AX100_DOWNLINK_MAX_BYTES;
+        data_len = AX100_DOWNLINK_MAX_BYTES; // Logged by `AX100_start_tx_buffer`.
     }
+    memcpy(payload, data, data_len);
 
-    prepend_csp_header(packet_buffer_including_csp_header, data, data_len);
+    const uint8_t start_result = AX100_start_tx_buffer(payload, data_len);
+    const uint8_t finish_result = AX100_finish_tx_buffer(payload);
+    return (start_result != 0) ? start_result : finish_result;
+}
 
-    // Any network layer (CSP) things should be done here (e.g., XTEA, CRC, etc.)
+/// @brief Get how long to wait before sending the next packet, so as not to overwhelm the AX100's queue.
+/// @return Time to wait in ms. 0 means the radio can take a packet now.
+/// @note See `ax100_tx_pacing.c`.
+uint32_t AX100_get_tx_pacing_wait_ms(void) {
+    reap_tx_buffers();
+    return AX100_tx_pacing_get_wait_ms(HAL_GetTick());
+}
 
-    // Debugging write to UART.
-    if (AX100_enable_downlink_uart_logs) {
-        DEBUG_uart_print_mixed_array(
-            packet_buffer_including_csp_header, data_len + AX100_CSP_HEADER_LENGTH_BYTES,
-            ((COMMS_active_rf_switch_antenna == 1) ? "AX100 Down [ANT1]" : "AX100 Down [ANT2]")
-        );
+// Callbacks are used when transferring with DMA (I2C1 is shared with the ADCS, which doesn't use them).
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    AX100_tx_buffer_t *buffer = AX100_tx_in_flight_buffer;
+    if ((hi2c == AX100_I2C_HANDLE) && (buffer != NULL)) {
+        AX100_tx_in_flight_buffer = NULL;
+        buffer->status = HAL_OK;
+        buffer->end_ms = HAL_GetTick();
+        buffer->state = AX100_TX_BUFFER_DONE;
+    }
+}
+
+void HAL_I2C_AbortCpltCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c == AX100_I2C_HANDLE) {
+        AX100_tx_abort_in_progress = 0;
     }
+}
 
-    return send_bytes_to_ax100(packet_buffer_including_csp_header, data_len + AX100_CSP_HEADER_LENGTH_BYTES);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    AX100_tx_buffer_t *buffer = AX100_tx_in_flight_buffer;
+    if ((hi2c == AX100_I2C_HANDLE) && (buffer != NULL)) {
+        AX100_tx_in_flight_buffer = NULL;
+        buffer->status = HAL_ERROR;
+        buffer->end_ms = HAL_GetTick();
+        buffer->state = AX100_TX_BUFFER_DONE;
+    }
 }
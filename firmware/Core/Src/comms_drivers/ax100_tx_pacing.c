@@ -0,0 +1,307 @@
+// ax100_tx_pacing.c
+// Pacing of downlink packets to the AX100, from a model of how fast the radio drains its queue.
+//
+// Each packet handed to the AX100 adds its airtime to a modelled radio queue:
+//     airtime = (packet bytes + AX100_tx_overhead_bytes_per_packet) * 8 / AX100_tx_bitrate_bps
+// scaled by a learned rate scale. Senders wait (`AX100_tx_pacing_get_wait_ms`) until no more than
+// `AX100_tx_pacing_max_queued_ms` of airtime is queued, so the radio always has the next packet
+// without being overwhelmed.
+//
+// The scale is learned from the I2C transfers: when the AX100's queue is full, it stretches the
+// clock or NACKs the transfer (a "stall"):
+// * While the sender is held back by the model and no stalls happen, the radio may be faster than
+//   modelled (e.g., a bitrate reconfigured without updating `AX100_tx_bitrate_bps`). After
+//   `AX100_tx_pacing_probe_after_clean_sends` such "clean" sends in a row, the scale is decreased a
+//   step (a "probe").
+// * A too-fast scale only shows up as a stall once the radio's queue has filled, many sends after
+//   the probe. So a stall after probes reverts the scale to the last one which had
+//   `AX100_TX_PACING_CONFIRM_SENDS` clean sends, and backs off the probing (more clean sends are
+//   needed before the next probe). At the right scale, probes fail, and end up rare.
+// * A stall with no probe since the last confirmed scale means the radio drains slower than
+//   modelled, so the scale is increased a small step.
+//
+// Times are passed in (ms, from `HAL_GetTick()`) so that the model can be run on a simulated clock.
+
+#include "comms_drivers/ax100_tx_pacing.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/// @brief When enabled, the bulk downlink task sends packets as the model says the radio can take
+///     them, instead of every `COMMS_bulk_downlink_delay_per_packet_ms`.
+uint32_t AX100_tx_pacing_enabled = 1;
+
+/// @brief Over-the-air bitrate of the AX100, in bits per second. Must match the radio's configuration.
+uint32_t AX100_tx_bitrate_bps = 9600;
+
+/// @brief Bytes sent on air per packet in addition to the I2C packet (preamble, sync word, length
+///     field, FEC, etc.).
+/// @note The default makes a full bulk downlink packet take 208 ms at 9600 bps (which was found by
+///     hand in ground testing).
+uint32_t AX100_tx_overhead_bytes_per_packet = 46;
+
+/// @brief Modelled airtime which may be queued in the AX100 before senders are made to wait, in ms.
+/// @note About one full packet at 9600 bps, so the next packet is queued while one is on air.
+///     Set to 0 to only send once the previous packet is modelled to be fully sent.
+uint32_t AX100_tx_pacing_max_queued_ms = 250;
+
+/// @brief An I2C transfer to the AX100 taking at least this long is a stall (the AX100 stretched the
+///     clock because its queue was full).
+/// @note A full packet takes about 19 ms at 100 kHz.
+uint32_t AX100_tx_stall_i2c_duration_ms = 40;
+
+/// @brief Clean sends (held back by the model, without a stall) in a row before trying a faster
+///     rate. Backed off after each failed probe.
+uint32_t AX100_tx_pacing_probe_after_clean_sends = 16;
+
+static uint32_t AX100_tx_pacing_drain_done_ms = 0;
+static uint32_t AX100_tx_pacing_drain_remainder_us = 0;
+static uint32_t AX100_tx_pacing_rate_scale_permille = 1000;
+static uint8_t AX100_tx_pacing_waited_since_last_send = 0;
+
+// Probing for a faster rate.
+static uint32_t AX100_tx_pacing_clean_send_count = 0;
+static uint32_t AX100_tx_pacing_probe_gate_sends = 0; // 0 until the first send after a reset.
+
+// The scale confirmed by `AX100_TX_PACING_CONFIRM_SENDS` clean sends, and the one being confirmed.
+static uint32_t AX100_tx_pacing_confirmed_scale_permille = 1000;
+static uint32_t AX100_tx_pacing_unconfirmed_scale_permille = 1000;
+static uint32_t AX100_tx_pacing_confirm_send_count = 0;
+
+static uint32_t AX100_tx_pacing_window_start_ms = 0;
+static uint32_t AX100_tx_pacing_window_packet_count = 0;
+static uint32_t AX100_tx_pacing_achieved_packets_per_sec_x100 = 0;
+
+static AX100_tx_pacing_stats_t AX100_tx_pacing_stats = {0};
+
+/// @brief Reset the model (learned scale, queue) and the statistics.
+void AX100_tx_pacing_reset(void) {
+    AX100_tx_pacing_drain_done_ms = 0;
+    AX100_tx_pacing_drain_remainder_us = 0;
+    AX100_tx_pacing_rate_scale_permille = 1000;
+    AX100_tx_pacing_waited_since_last_send = 0;
+    AX100_tx_pacing_clean_send_count = 0;
+    AX100_tx_pacing_probe_gate_sends = 0;
+    AX100_tx_pacing_confirmed_scale_permille = 1000;
+    AX100_tx_pacing_unconfirmed_scale_permille = 1000;
+    AX100_tx_pacing_confirm_send_count = 0;
+    AX100_tx_pacing_window_start_ms = 0;
+    AX100_tx_pacing_window_packet_count = 0;
+    AX100_tx_pacing_achieved_packets_per_sec_x100 = 0;
+    memset(&AX100_tx_pacing_stats, 0, sizeof(AX100_tx_pacing_stats));
+}
+
+/// @brief Get the modelled airtime of a packet, including the learned scale.
+/// @param packet_size_bytes Size of the packet sent to the AX100 (including the CSP header).
+/// @return Airtime in us (at least 1).
+/// @note In us, so that the sub-ms part of each packet's airtime adds up in the model.
+uint32_t AX100_tx_pacing_get_packet_airtime_us(uint16_t packet_size_bytes) {
+    const uint32_t bitrate_bps = (AX100_tx_bitrate_bps > 0) ? AX100_tx_bitrate_bps : 1;
+    const uint64_t airtime_us = (
+        ((uint64_t)packet_size_bytes + AX100_tx_overhead_bytes_per_packet) * 8 * AX100_tx_pacing_rate_scale_permille
+        * 1000 / bitrate_bps
+    );
+    return (airtime_us > 0) ? (uint32_t)airtime_us : 1;
+}
+
+/// @brief Get the modelled airtime still queued in the radio at `now_ms`.
+static uint32_t AX100_tx_pacing_get_queued_ms(uint32_t now_ms) {
+    const int32_t queued_ms = (int32_t)(AX100_tx_pacing_drain_done_ms - now_ms);
+    return (queued_ms > 0) ? (uint32_t)queued_ms : 0;
+}
+
+/// @brief Update the learned scale after a stall.
+static void AX100_tx_pacing_record_stall(void) {
+    if (AX100_tx_pacing_rate_scale_permille < AX100_tx_pacing_confirmed_scale_permille) {
+        // A probe was too fast. Undo the probes since the confirmed scale, and probe less often.
+        AX100_tx_pacing_stats.failed_probe_count++;
+        AX100_tx_pacing_rate_scale_permille = AX100_tx_pacing_confirmed_scale_permille;
+        AX100_tx_pacing_probe_gate_sends *= AX100_TX_PACING_PROBE_BACKOFF_FACTOR;
+        if (AX100_tx_pacing_probe_gate_sends > AX100_TX_PACING_MAX_PROBE_GATE_SENDS) {
+            AX100_tx_pacing_probe_gate_sends = AX100_TX_PACING_MAX_PROBE_GATE_SENDS;
+        }
+    }
+    else {
+        AX100_tx_pacing_rate_scale_permille += AX100_tx_pacing_rate_scale_permille / AX100_TX_PACING_STALL_STEP_DIVISOR;
+        if (AX100_tx_pacing_rate_scale_permille > AX100_TX_PACING_MAX_RATE_SCALE_PERMILLE) {
+            AX100_tx_pacing_rate_scale_permille = AX100_TX_PACING_MAX_RATE_SCALE_PERMILLE;
+        }
+    }
+
+    AX100_tx_pacing_clean_send_count = 0;
+    AX100_tx_pacing_confirmed_scale_permille = AX100_tx_pacing_rate_scale_permille;
+    AX100_tx_pacing_unconfirmed_scale_permille = AX100_tx_pacing_rate_scale_permille;
+    AX100_tx_pacing_confirm_send_count = 0;
+}
+
+/// @brief Update the learned scale after a clean send: confirm the scale, and probe a faster one.
+static void AX100_tx_pacing_record_clean_send(void) {
+    AX100_tx_pacing_confirm_send_count++;
+    if (AX100_tx_pacing_confirm_send_count >= AX100_TX_PACING_CONFIRM_SENDS) {
+        // The scale at the start of this window has now had at least a window of clean sends.
+        AX100_tx_pacing_confirmed_scale_permille = AX100_tx_pacing_unconfirmed_scale_permille;
+        AX100_tx_pacing_unconfirmed_scale_permille = AX100_tx_pacing_rate_scale_permille;
+        AX100_tx_pacing_confirm_send_count = 0;
+    }
+
+    AX100_tx_pacing_clean_send_count++;
+    if (AX100_tx_pacing_clean_send_count < AX100_tx_pacing_probe_gate_sends) {
+        return;
+    }
+    AX100_tx_pacing_clean_send_count = 0;
+    AX100_tx_pacing_stats.probe_count++;
+    AX100_tx_pacing_rate_scale_permille -= AX100_tx_pacing_rate_scale_permille / AX100_TX_PACING_PROBE_STEP_DIVISOR;
+    if (AX100_tx_pacing_rate_scale_permille < AX100_TX_PACING_MIN_RATE_SCALE_PERMILLE) {
+        AX100_tx_pacing_rate_scale_permille = AX100_TX_PACING_MIN_RATE_SCALE_PERMILLE;
+    }
+}
+
+/// @brief Update the model after an I2C transfer of a packet to the AX100.
+/// @param packet_size_bytes Size of the packet sent to the AX100 (including the CSP header).
+/// @param start_ms Time the I2C transfer started.
+/// @param end_ms Time the I2C transfer ended.
+/// @param i2c_failed 1 if the transfer failed (the packet was not accepted), 0 otherwise.
+void AX100_tx_pacing_record_send(
+    uint16_t packet_size_bytes, uint32_t start_ms, uint32_t end_ms, uint8_t i2c_failed
+) {
+    const uint32_t i2c_duration_ms = end_ms - start_ms;
+    AX100_tx_pacing_stats.last_i2c_duration_ms = i2c_duration_ms;
+    if (i2c_duration_ms > AX100_tx_pacing_stats.max_i2c_duration_ms) {
+        AX100_tx_pacing_stats.max_i2c_duration_ms = i2c_duration_ms;
+    }
+
+    if (AX100_tx_pacing_get_queued_ms(end_ms) == 0) {
+        // Radio is idle: the packet starts on air now.
+        AX100_tx_pacing_drain_done_ms = end_ms;
+    }
+
+    if (AX100_tx_pacing_probe_gate_sends == 0) {
+        AX100_tx_pacing_probe_gate_sends = AX100_tx_pacing_probe_after_clean_sends;
+    }
+
+    const uint8_t is_stall = i2c_failed || (i2c_duration_ms >= AX100_tx_stall_i2c_duration_ms);
+    if (is_stall) {
+        // The radio's queue was full: it drains slower than modelled.
+        AX100_tx_pacing_stats.stall_count++;
+        if (i2c_failed) {
+            AX100_tx_pacing_stats.i2c_error_count++;
+        }
+        AX100_tx_pacing_record_stall();
+
+        // The queue is (at least) full now. If the packet wasn't accepted, its airtime added below
+        // makes the next attempt wait for a packet to drain (instead of retrying into a full queue).
+        if (AX100_tx_pacing_get_queued_ms(end_ms) < AX100_tx_pacing_max_queued_ms) {
+            AX100_tx_pacing_drain_done_ms = end_ms + AX100_tx_pacing_max_queued_ms;
+            AX100_tx_pacing_drain_remainder_us = 0;
+        }
+    }
+    else if (AX100_tx_pacing_waited_since_last_send) {
+        // The model held the sender back and the radio kept up.
+        AX100_tx_pacing_record_clean_send();
+    }
+    AX100_tx_pacing_waited_since_last_send = 0;
+
+    const uint32_t airtime_us = (
+        AX100_tx_pacing_get_packet_airtime_us(packet_size_bytes) + AX100_tx_pacing_drain_remainder_us
+    );
+    AX100_tx_pacing_drain_done_ms += airtime_us / 1000;
+    AX100_tx_pacing_drain_remainder_us = airtime_us % 1000;
+    if (i2c_failed) {
+        return;
+    }
+
+    AX100_tx_pacing_stats.packets_sent++;
+    AX100_tx_pacing_stats.bytes_sent += packet_size_bytes;
+
+    // Achieved rate, over fixed windows.
+    if (AX100_tx_pacing_window_packet_count == 0) {
+        AX100_tx_pacing_window_start_ms = end_ms;
+    }
+    AX100_tx_pacing_window_packet_count++;
+    const uint32_t window_elapsed_ms = end_ms - AX100_tx_pacing_window_start_ms;
+    if (window_elapsed_ms >= AX100_TX_PACING_RATE_WINDOW_MS) {
+        // Packets sent after the window start (the first one marks the start).
+        AX100_tx_pacing_achieved_packets_per_sec_x100 = (uint32_t)(
+            (uint64_t)(AX100_tx_pacing_window_packet_count - 1) * 100000 / window_elapsed_ms
+        );
+        AX100_tx_pacing_window_start_ms = end_ms;
+        AX100_tx_pacing_window_packet_count = 1;
+    }
+}
+
+/// @brief Get how long a sender should wait before sending the next packet to the AX100.
+/// @param now_ms Current time (e.g., `HAL_GetTick()`).
+/// @return Time to wait in ms. 0 means the radio can take a packet now.
+uint32_t AX100_tx_pacing_get_wait_ms(uint32_t now_ms) {
+    const uint32_t queued_ms = AX100_tx_pacing_get_queued_ms(now_ms);
+    if (queued_ms <= AX100_tx_pacing_max_queued_ms) {
+        return 0;
+    }
+    AX100_tx_pacing_stats.wait_count++;
+    AX100_tx_pacing_waited_since_last_send = 1;
+    return queued_ms - AX100_tx_pacing_max_queued_ms;
+}
+
+/// @brief Get the pacing statistics, and the current state of the model.
+void AX100_tx_pacing_get_stats(uint32_t now_ms, AX100_tx_pacing_stats_t *stats_out) {
+    *stats_out = AX100_tx_pacing_stats;
+    stats_out->rate_scale_permille = AX100_tx_pacing_rate_scale_permille;
+    stats_out->queued_ms = AX100_tx_pacing_get_queued_ms(now_ms);
+    stats_out->probe_gate_sends = (AX100_tx_pacing_probe_gate_sends > 0)
+        ? AX100_tx_pacing_probe_gate_sends
+        : AX100_tx_pacing_probe_after_clean_sends;
+
+    stats_out->achieved_packets_per_sec_x100 = AX100_tx_pacing_achieved_packets_per_sec_x100;
+    const uint32_t window_elapsed_ms = now_ms - AX100_tx_pacing_window_start_ms;
+    if ((AX100_tx_pacing_window_packet_count > 0) && (window_elapsed_ms >= 2 * AX100_TX_PACING_RATE_WINDOW_MS)) {
+        // Sending stopped (or slowed) since the last complete window.
+        stats_out->achieved_packets_per_sec_x100 = (uint32_t)(
+            (uint64_t)(AX100_tx_pacing_window_packet_count - 1) * 100000 / window_elapsed_ms
+        );
+    }
+}
+
+/// @brief Format pacing statistics as a JSON object.
+/// @return Number of characters written (excluding the null terminator), or -1 if truncated.
+int16_t AX100_tx_pacing_stats_to_json(
+    const AX100_tx_pacing_stats_t *stats, char json_output_buf[], uint16_t json_output_buf_size
+) {
+    const int written = snprintf(
+        json_output_buf,
+        json_output_buf_size,
+        "{"
+            "\"packets_sent\":%" PRIu32 ","
+            "\"bytes_sent\":%" PRIu32 ","
+            "\"achieved_packets_per_sec\":%" PRIu32 ".%02" PRIu32 ","
+            "\"stall_count\":%" PRIu32 ","
+            "\"i2c_error_count\":%" PRIu32 ","
+            "\"wait_count\":%" PRIu32 ","
+            "\"probe_count\":%" PRIu32 ","
+            "\"failed_probe_count\":%" PRIu32 ","
+            "\"probe_gate_sends\":%" PRIu32 ","
+            "\"rate_scale_permille\":%" PRIu32 ","
+            "\"queued_ms\":%" PRIu32 ","
+            "\"last_i2c_ms\":%" PRIu32 ","
+            "\"max_i2c_ms\":%" PRIu32
+        "}",
+        stats->packets_sent,
+        stats->bytes_sent,
+        stats->achieved_packets_per_sec_x100 / 100,
+        stats->achieved_packets_per_sec_x100 % 100,
+        stats->stall_count,
+        stats->i2c_error_count,
+        stats->wait_count,
+        stats->probe_count,
+        stats->failed_probe_count,
+        stats->probe_gate_sends,
+        stats->rate_scale_permille,
+        stats->queued_ms,
+        stats->last_i2c_duration_ms,
+        stats->max_i2c_duration_ms
+    );
+    if ((written < 0) || (written >= json_output_buf_size)) {
+        return -1;
+    }
+    return (int16_t)written;
+}
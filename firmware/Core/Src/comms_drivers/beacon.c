@@ -2,6 +2,7 @@
 #include "comms_drivers/beacon.h"
 
 #include "comms_drivers/rf_antenna_switch.h"
+#include "comms_drivers/ax100_tx_pacing.h"
 #include "rtos_tasks/rtos_tasks_rx_telecommands.h"
 #include "main.h"
 
@@ -37,6 +38,11 @@ extern MPI_reason_for_stopping_active_mode_enum_t MPI_last_reason_for_stopping_a
 char COMMS_beacon_friendly_message_str[COMMS_BEACON_FRIENDLY_MESSAGE_SIZE] = "Hello from CalgaryToSpace FrontierSat";
 
 
+static inline uint16_t COMMS_saturate_to_uint16(uint32_t value) {
+    return (value > UINT16_MAX) ? UINT16_MAX : (uint16_t)value;
+}
+
+
 void COMMS_fill_beacon_basic_packet(
     COMMS_beacon_basic_packet_t *beacon_packet
 ) {
@@ -99,6 +105,19 @@ void COMMS_fill_beacon_basic_packet(
         strlen(COMMS_beacon_friendly_message_str)
     );
     memcpy(beacon_packet->end_message, "END", 4);
+
+    // AX100 downlink pacing (appended after the end message).
+    {
+        AX100_tx_pacing_stats_t pacing_stats;
+        AX100_tx_pacing_get_stats(HAL_GetTick(), &pacing_stats);
+        beacon_packet->ax100_tx_packets_sent = pacing_stats.packets_sent;
+        beacon_packet->ax100_tx_stall_count = COMMS_saturate_to_uint16(pacing_stats.stall_count);
+        beacon_packet->ax100_tx_failed_probe_count = COMMS_saturate_to_uint16(pacing_stats.failed_probe_count);
+        beacon_packet->ax100_tx_rate_scale_permille = COMMS_saturate_to_uint16(pacing_stats.rate_scale_permille);
+        beacon_packet->ax100_tx_achieved_packets_per_sec_x100 = COMMS_saturate_to_uint16(
+            pacing_stats.achieved_packets_per_sec_x100
+        );
+    }
     
     // Try to fetch the EPS system status, and store it in the beacon packet if successful.
     {
@@ -3,6 +3,9 @@
 #include "littlefs/littlefs_helper.h"
 #include "log/log.h"
 #include "comms_drivers/comms_tx.h" // For `COMMS_bulk_file_downlink_next_seq_num`
+#include "compression/heatshrink_lib/heatshrink_encoder.h"
+#include "littlefs/flash_driver.h" // For `FLASH_CHIP_PAGE_SIZE_BYTES`
+#include "rtos_tasks/rtos_task_helpers.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -17,37 +20,97 @@ uint16_t COMMS_bulk_file_downlink_next_seq_num;
 uint16_t COMMS_bulk_file_downlink_total_seq_num;
 COMMS_bulk_file_downlink_state_enum_t COMMS_bulk_file_downlink_state;
 lfs_file_t COMMS_bulk_file_downlink_file;
+uint8_t COMMS_bulk_file_downlink_file_is_open = 0;
+uint8_t COMMS_bulk_file_downlink_is_compressed;
+uint16_t COMMS_bulk_file_downlink_transfer_id;
+uint16_t COMMS_bulk_file_downlink_nack_pending_count;
+uint32_t COMMS_bulk_file_downlink_retransmit_count;
 
-static const uint32_t COMMS_bulk_file_downlink_max_allowable_total_bytes = 1000000;
+static const uint32_t COMMS_bulk_file_downlink_max_allowable_total_bytes = COMMS_BULK_FILE_DOWNLINK_MAX_TOTAL_BYTES;
 
-/// @brief Initiate a bulk file downlink over the UHF radio.
-/// @param file_path File name/path to downlink.
-/// @param start_offset The byte offset in the file to start downlinking from (0 for start).
-/// @param max_bytes The maximum number of bytes to downlink. Maximum value is 1000000 (1 MB, COMMS_bulk_file_downlink_total_bytes), for safety (to avoid a very very long-running downlink chain). Values >1 MB will be limited to 1 MB, and value 0 will be set to 1 MB.
-/// @return 0 on success. Negative LFS failure code on LFS failure. Positive error code on other (logical/request) errors.
-/// @note 1 MB takes about 15 minutes to downlink at 9600 baud.
-/// @note This function is safe to call at any point (including mid-downlink, or mid-pause).
-///       It will close the previous file and start a new downlink.
-int32_t COMMS_bulk_file_downlink_start(char *file_path, uint32_t start_offset, uint32_t max_bytes) {
-    // Check clean-up actions.
-    if (
-        (COMMS_bulk_file_downlink_state == COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING)
-        || (COMMS_bulk_file_downlink_state == COMMS_BULK_FILE_DOWNLINK_STATE_PAUSED)
-    ) {
-        // Must return to idle.
-        // Close the file.
-        const int32_t close_status = lfs_file_close(&LFS_filesystem, &COMMS_bulk_file_downlink_file);
-        if (close_status != 0) {
-            LOG_message(
-                LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
-                "During COMMS_bulk_file_downlink_start idle return, lfs_file_close() -> %ld",
-                close_status
-            );
-            // Steamroll (contain on anyway).
-        }
+// Serializes the downlink state (including the file and the encoder) between the downlink task's
+// packet actions and the telecommand task's start/NACK/pause/resume. Needed because file reads
+// yield in flash waits. Recursive.
+static TASK_HELP_lazy_mutex_t COMMS_bulk_file_downlink_mutex = TASK_HELP_LAZY_MUTEX_INIT("COMMS_bulk_file_downlink_mutex");
 
-        COMMS_bulk_file_downlink_state = COMMS_BULK_FILE_DOWNLINK_STATE_IDLE;
+// Selective-repeat state (see `COMMS_bulk_file_downlink_nack`).
+// Bit N (byte N/8, bit N%8) is set when packet seq_num N was NACKed by the ground, and not resent yet.
+static uint8_t COMMS_bulk_file_downlink_nack_bitmap[(COMMS_BULK_FILE_DOWNLINK_MAX_TOTAL_SEQ_NUM / 8) + 1];
+static uint8_t COMMS_bulk_file_downlink_transfer_supports_nack = 0;
+
+/// @brief Boolean. Whether uncompressed downlinks read the file ahead, in page-sized chunks
+///     (see `COMMS_bulk_file_downlink_prefetch`). When 0, each packet is read from the file as it is sent.
+uint32_t COMMS_bulk_file_downlink_prefetch_enabled = 1;
+
+// Read-ahead (prefetch) state. The two buffers hold consecutive chunks of the file, starting at
+// the next packet in sequence; a packet may span both. Chunks end on page-size-aligned file offsets.
+#define COMMS_BULK_FILE_DOWNLINK_PREFETCH_CHUNK_BYTES FLASH_CHIP_PAGE_SIZE_BYTES
+typedef struct {
+    uint8_t data[COMMS_BULK_FILE_DOWNLINK_PREFETCH_CHUNK_BYTES];
+    uint32_t file_offset;
+    uint16_t len; // 0 when the buffer is free.
+} COMMS_bulk_file_downlink_prefetch_buffer_t;
+static COMMS_bulk_file_downlink_prefetch_buffer_t COMMS_bulk_file_downlink_prefetch_buffers[2];
+static uint32_t COMMS_bulk_file_downlink_prefetch_next_offset = 0;
+
+// Compressed downlink state (see `COMMS_bulk_file_downlink_start_compressed`).
+// The file is read in chunks of this size, and fed to the encoder as it accepts input.
+#define COMMS_BULK_FILE_DOWNLINK_COMPRESS_READ_CHUNK_BYTES 256
+static heatshrink_encoder *COMMS_bulk_file_downlink_encoder = NULL;
+static uint8_t COMMS_bulk_file_downlink_encoder_is_finishing = 0;
+static uint8_t COMMS_bulk_file_downlink_read_chunk[COMMS_BULK_FILE_DOWNLINK_COMPRESS_READ_CHUNK_BYTES];
+static uint16_t COMMS_bulk_file_downlink_read_chunk_len = 0;
+static uint16_t COMMS_bulk_file_downlink_read_chunk_pos = 0;
+static COMMS_bulk_file_downlink_compressed_header_t COMMS_bulk_file_downlink_compressed_header;
+static uint8_t COMMS_bulk_file_downlink_compressed_header_pos = 0;
+
+// The packet being sent. The encoder's output can't be read again, so the packet is kept until
+// it is sent (e.g., if the radio refuses it, it is retried).
+static uint8_t COMMS_bulk_file_downlink_compressed_packet[COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET];
+static uint16_t COMMS_bulk_file_downlink_compressed_packet_len = 0;
+static uint8_t COMMS_bulk_file_downlink_compressed_packet_is_filled = 0;
+static uint8_t COMMS_bulk_file_downlink_compressed_packet_is_last = 0;
+
+/// @brief Take the lock on the bulk downlink state. Held by `TASK_bulk_downlink` for each packet.
+void COMMS_bulk_file_downlink_lock(void) {
+    TASK_HELP_lazy_mutex_lock(&COMMS_bulk_file_downlink_mutex);
+}
+
+/// @brief Release the lock taken by `COMMS_bulk_file_downlink_lock`.
+void COMMS_bulk_file_downlink_unlock(void) {
+    TASK_HELP_lazy_mutex_unlock(&COMMS_bulk_file_downlink_mutex);
+}
+
+/// @brief Close `COMMS_bulk_file_downlink_file`, if it's open.
+static void COMMS_bulk_file_downlink_close_file(void) {
+    if (!COMMS_bulk_file_downlink_file_is_open) {
+        return;
     }
+    COMMS_bulk_file_downlink_file_is_open = 0;
+    const int32_t close_status = lfs_file_close(&LFS_filesystem, &COMMS_bulk_file_downlink_file);
+    if (close_status != 0) {
+        LOG_message(
+            LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
+            "COMMS_bulk_file_downlink_close_file: lfs_file_close() -> %ld",
+            close_status
+        );
+        // Steamroll (contain on anyway).
+    }
+}
+
+/// @brief Stop the downlink (finished or not): free the encoder, close the file, and return to idle.
+/// @note Safe to call at any time (e.g., when idle). Call with `COMMS_bulk_file_downlink_lock` held.
+void COMMS_bulk_file_downlink_stop(void) {
+    COMMS_bulk_file_downlink_end_compression();
+    COMMS_bulk_file_downlink_close_file();
+    COMMS_bulk_file_downlink_state = COMMS_BULK_FILE_DOWNLINK_STATE_IDLE;
+}
+
+/// @brief `COMMS_bulk_file_downlink_start`, with `COMMS_bulk_file_downlink_lock` held.
+static int32_t COMMS_bulk_file_downlink_start_with_lock_held(char *file_path, uint32_t start_offset, uint32_t max_bytes) {
+    // A previous downlink (finished or not) ends here. This one is uncompressed unless
+    // `COMMS_bulk_file_downlink_start_compressed` sets it up after this returns.
+    COMMS_bulk_file_downlink_stop();
 
     // Open the new file. Implicitly checks if it exists.
     const int32_t open_result = lfs_file_open(
@@ -69,6 +132,7 @@ int32_t COMMS_bulk_file_downlink_start(char *file_path, uint32_t start_offset, u
         );
         return open_result;
     }
+    COMMS_bulk_file_downlink_file_is_open = 1;
     LOG_message(
         LOG_SYSTEM_LFS, LOG_SEVERITY_DEBUG,
         LOG_all_sinks_except(LOG_SINK_FILE),
@@ -83,6 +147,7 @@ int32_t COMMS_bulk_file_downlink_start(char *file_path, uint32_t start_offset, u
             "COMMS_bulk_file_downlink_start lfs_file_size()->%ld",
             size_bytes
         );
+        COMMS_bulk_file_downlink_close_file();
         return size_bytes;
     }
 
@@ -93,6 +158,7 @@ int32_t COMMS_bulk_file_downlink_start(char *file_path, uint32_t start_offset, u
             "COMMS_bulk_file_downlink_start: start_offset %ld bytes >= file size %ld bytes",
             start_offset, size_bytes
         );
+        COMMS_bulk_file_downlink_close_file();
         return 3; // Invalid offset
     }
 
@@ -134,6 +200,7 @@ int32_t COMMS_bulk_file_downlink_start(char *file_path, uint32_t start_offset, u
             "COMMS_bulk_file_downlink_start lfs_seek()->%ld",
             seek_result
         );
+        COMMS_bulk_file_downlink_close_file();
         return seek_result;
     }
 
@@ -147,6 +214,14 @@ int32_t COMMS_bulk_file_downlink_start(char *file_path, uint32_t start_offset, u
         (max_bytes + COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET - 1)
         / COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET
     );
+    COMMS_bulk_file_downlink_transfer_id++;
+    memset(COMMS_bulk_file_downlink_nack_bitmap, 0, sizeof(COMMS_bulk_file_downlink_nack_bitmap));
+    COMMS_bulk_file_downlink_nack_pending_count = 0;
+    COMMS_bulk_file_downlink_retransmit_count = 0;
+    COMMS_bulk_file_downlink_transfer_supports_nack = 1;
+    COMMS_bulk_file_downlink_prefetch_buffers[0].len = 0;
+    COMMS_bulk_file_downlink_prefetch_buffers[1].len = 0;
+    COMMS_bulk_file_downlink_prefetch_next_offset = start_offset;
     snprintf(
         COMMS_bulk_file_downlink_file_path,
         LFS_MAX_PATH_LENGTH,
@@ -160,24 +235,631 @@ int32_t COMMS_bulk_file_downlink_start(char *file_path, uint32_t start_offset, u
     return 0; // Return 0 for success
 }
 
+/// @brief Initiate a bulk file downlink over the UHF radio.
+/// @param file_path File name/path to downlink.
+/// @param start_offset The byte offset in the file to start downlinking from (0 for start).
+/// @param max_bytes The maximum number of bytes to downlink. Maximum value is 1000000 (1 MB, COMMS_bulk_file_downlink_total_bytes), for safety (to avoid a very very long-running downlink chain). Values >1 MB will be limited to 1 MB, and value 0 will be set to 1 MB.
+/// @return 0 on success. Negative LFS failure code on LFS failure. Positive error code on other (logical/request) errors.
+/// @note 1 MB takes about 15 minutes to downlink at 9600 baud.
+/// @note This function is safe to call at any point (including mid-downlink, or mid-pause).
+///       It will close the previous file and start a new downlink.
+int32_t COMMS_bulk_file_downlink_start(char *file_path, uint32_t start_offset, uint32_t max_bytes) {
+    COMMS_bulk_file_downlink_lock();
+    const int32_t result = COMMS_bulk_file_downlink_start_with_lock_held(file_path, start_offset, max_bytes);
+    COMMS_bulk_file_downlink_unlock();
+    return result;
+}
+
 uint8_t COMMS_bulk_file_downlink_pause(void) {
+    COMMS_bulk_file_downlink_lock();
     if (COMMS_bulk_file_downlink_state == COMMS_BULK_FILE_DOWNLINK_STATE_IDLE) {
         // Can't pause if it's not running. A resume would cause it to start downlinking invalid data.
+        COMMS_bulk_file_downlink_unlock();
         return 1; // Return 1 for failure
     }
 
     COMMS_bulk_file_downlink_state = COMMS_BULK_FILE_DOWNLINK_STATE_PAUSED;
+    COMMS_bulk_file_downlink_unlock();
     return 0; // Return 0 for success    
 }
 
 
 uint8_t COMMS_bulk_file_downlink_resume(void) {
+    COMMS_bulk_file_downlink_lock();
     if (COMMS_bulk_file_downlink_state != COMMS_BULK_FILE_DOWNLINK_STATE_PAUSED) {
         // Can't resume if it's not paused.
+        COMMS_bulk_file_downlink_unlock();
         return 1;
     }
 
     COMMS_bulk_file_downlink_state = COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING;
+    COMMS_bulk_file_downlink_unlock();
     return 0; // Return 0 for success    
 }
 
+
+/// @brief Get the offset in the file, and the length, of an uncompressed downlink packet.
+static void COMMS_bulk_file_downlink_get_packet_range(
+    uint16_t seq_num, uint32_t *file_offset_out, uint16_t *len_out
+) {
+    const uint32_t relative_offset = (uint32_t)(seq_num - 1) * COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET;
+    const uint32_t bytes_remaining = COMMS_bulk_file_downlink_total_bytes - relative_offset;
+    *file_offset_out = COMMS_bulk_file_downlink_absolute_start_offset + relative_offset;
+    *len_out = (bytes_remaining > COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET)
+        ? COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET
+        : (uint16_t)bytes_remaining;
+}
+
+/// @brief Get the lowest NACKed seq_num which hasn't been resent yet.
+/// @return The seq_num, or 0 if none are pending.
+static uint16_t COMMS_bulk_file_downlink_next_nacked_seq_num(void) {
+    if (COMMS_bulk_file_downlink_nack_pending_count == 0) {
+        return 0;
+    }
+    for (uint16_t byte_idx = 0; byte_idx < sizeof(COMMS_bulk_file_downlink_nack_bitmap); byte_idx++) {
+        const uint8_t byte = COMMS_bulk_file_downlink_nack_bitmap[byte_idx];
+        if (byte == 0) {
+            continue;
+        }
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (byte & (1 << bit)) {
+                return (byte_idx * 8) + bit;
+            }
+        }
+    }
+    return 0;
+}
+
+/// @brief Read the next chunk of the file into a free prefetch buffer.
+/// @return Number of bytes read (>0). 0 if no buffer is free, or the whole range has been read.
+///     Negative LFS error code on failure.
+static int32_t COMMS_bulk_file_downlink_prefetch_next_chunk(void) {
+    const uint32_t end_offset = COMMS_bulk_file_downlink_absolute_start_offset + COMMS_bulk_file_downlink_total_bytes;
+    if (COMMS_bulk_file_downlink_prefetch_next_offset >= end_offset) {
+        return 0;
+    }
+
+    COMMS_bulk_file_downlink_prefetch_buffer_t *buffer = NULL;
+    for (uint8_t i = 0; i < 2; i++) {
+        if (COMMS_bulk_file_downlink_prefetch_buffers[i].len == 0) {
+            buffer = &COMMS_bulk_file_downlink_prefetch_buffers[i];
+            break;
+        }
+    }
+    if (buffer == NULL) {
+        return 0;
+    }
+
+    const uint32_t chunk_offset = COMMS_bulk_file_downlink_prefetch_next_offset;
+    uint32_t chunk_end = (
+        (chunk_offset / COMMS_BULK_FILE_DOWNLINK_PREFETCH_CHUNK_BYTES) + 1
+    ) * COMMS_BULK_FILE_DOWNLINK_PREFETCH_CHUNK_BYTES;
+    if (chunk_end > end_offset) {
+        chunk_end = end_offset;
+    }
+
+    // NACKed packets are read with a seek, so the file position may have moved.
+    if (lfs_file_tell(&LFS_filesystem, &COMMS_bulk_file_downlink_file) != (lfs_soff_t)chunk_offset) {
+        const lfs_soff_t seek_result = lfs_file_seek(
+            &LFS_filesystem, &COMMS_bulk_file_downlink_file, chunk_offset, LFS_SEEK_SET
+        );
+        if (seek_result < 0) {
+            return seek_result;
+        }
+    }
+
+    const lfs_ssize_t read_result = lfs_file_read(
+        &LFS_filesystem, &COMMS_bulk_file_downlink_file, buffer->data, chunk_end - chunk_offset
+    );
+    if (read_result < 0) {
+        return read_result;
+    }
+    if (read_result == 0) {
+        // The file shrank since the start. Stop reading ahead; the packet read handles the end.
+        COMMS_bulk_file_downlink_prefetch_next_offset = end_offset;
+        return 0;
+    }
+
+    buffer->file_offset = chunk_offset;
+    buffer->len = (uint16_t)read_result;
+    COMMS_bulk_file_downlink_prefetch_next_offset += (uint32_t)read_result;
+    return read_result;
+}
+
+/// @brief Read ahead the next chunks of the file of an uncompressed downlink, into any free buffers.
+/// @return 0 on success (including when there is nothing to read). Negative LFS error code on failure.
+/// @details Call after sending a packet, so that the flash reads happen while the packet is on
+///     air (instead of before the next packet). The chunks are page-sized and page-aligned in the
+///     file (except the first and last), so a chunk is one flash transaction for ~10 packets.
+int32_t COMMS_bulk_file_downlink_prefetch(void) {
+    if (
+        !COMMS_bulk_file_downlink_prefetch_enabled
+        || COMMS_bulk_file_downlink_is_compressed
+        || (COMMS_bulk_file_downlink_state != COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING)
+    ) {
+        return 0;
+    }
+
+    int32_t result;
+    do {
+        result = COMMS_bulk_file_downlink_prefetch_next_chunk();
+    } while (result > 0);
+    return result;
+}
+
+/// @brief Copy a packet's data out of the prefetch buffers, reading chunks that aren't there yet.
+/// @param data_len_out Number of bytes copied. Less than `len` only if the file shrank.
+/// @return 0 on success. Negative LFS error code on failure.
+static int32_t COMMS_bulk_file_downlink_read_prefetched(
+    uint32_t file_offset, uint8_t dest[], uint16_t len, uint16_t *data_len_out
+) {
+    uint16_t copied = 0;
+    while (copied < len) {
+        const uint32_t pos = file_offset + copied;
+        const COMMS_bulk_file_downlink_prefetch_buffer_t *buffer = NULL;
+        for (uint8_t i = 0; i < 2; i++) {
+            const COMMS_bulk_file_downlink_prefetch_buffer_t *candidate = &COMMS_bulk_file_downlink_prefetch_buffers[i];
+            if (
+                (candidate->len > 0)
+                && (pos >= candidate->file_offset)
+                && (pos < (candidate->file_offset + candidate->len))
+            ) {
+                buffer = candidate;
+                break;
+            }
+        }
+
+        if (buffer == NULL) {
+            const int32_t prefetch_result = COMMS_bulk_file_downlink_prefetch_next_chunk();
+            if (prefetch_result < 0) {
+                return prefetch_result;
+            }
+            if (prefetch_result == 0) {
+                break; // The file shrank.
+            }
+            continue;
+        }
+
+        uint16_t count = (uint16_t)(buffer->file_offset + buffer->len - pos);
+        if (count > (len - copied)) {
+            count = len - copied;
+        }
+        memcpy(&dest[copied], &buffer->data[pos - buffer->file_offset], count);
+        copied += count;
+    }
+
+    *data_len_out = copied;
+    return 0;
+}
+
+/// @brief Read the next uncompressed downlink packet to send: a NACKed packet first (lowest
+///     seq_num), otherwise the next packet in sequence.
+/// @param dest Packet data buffer, of `COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET` bytes.
+/// @param seq_num_out Sequence number of the packet (first packet is 1).
+/// @param file_offset_out Offset in the file of the packet's data.
+/// @param data_len_out Number of bytes read into `dest`.
+/// @return 0 on success. Negative LFS error code on read failure (call again to retry). 1 if
+///     there is nothing to send.
+/// @note Call `COMMS_bulk_file_downlink_packet_sent` once the packet is sent.
+int32_t COMMS_bulk_file_downlink_read_next_packet(
+    uint8_t dest[], uint16_t *seq_num_out, uint32_t *file_offset_out, uint16_t *data_len_out
+) {
+    uint16_t seq_num = COMMS_bulk_file_downlink_next_nacked_seq_num();
+    if (seq_num == 0) {
+        if (COMMS_bulk_file_downlink_bytes_downlinked >= COMMS_bulk_file_downlink_total_bytes) {
+            return 1;
+        }
+        seq_num = COMMS_bulk_file_downlink_next_seq_num;
+    }
+
+    uint32_t file_offset;
+    uint16_t len;
+    COMMS_bulk_file_downlink_get_packet_range(seq_num, &file_offset, &len);
+
+    if (COMMS_bulk_file_downlink_prefetch_enabled && (seq_num == COMMS_bulk_file_downlink_next_seq_num)) {
+        uint16_t read_len;
+        const int32_t read_result = COMMS_bulk_file_downlink_read_prefetched(file_offset, dest, len, &read_len);
+        if (read_result < 0) {
+            return read_result;
+        }
+        if (read_len < len) {
+            // The file shrank since the start: end the downlink with what was read.
+            COMMS_bulk_file_downlink_total_bytes = file_offset + read_len - COMMS_bulk_file_downlink_absolute_start_offset;
+        }
+        *seq_num_out = seq_num;
+        *file_offset_out = file_offset;
+        *data_len_out = read_len;
+        return 0;
+    }
+
+    // Only resent packets need a seek; packets in sequence follow on from the previous read.
+    if (lfs_file_tell(&LFS_filesystem, &COMMS_bulk_file_downlink_file) != (lfs_soff_t)file_offset) {
+        const lfs_soff_t seek_result = lfs_file_seek(
+            &LFS_filesystem, &COMMS_bulk_file_downlink_file, file_offset, LFS_SEEK_SET
+        );
+        if (seek_result < 0) {
+            return seek_result;
+        }
+    }
+
+    const lfs_ssize_t read_result = lfs_file_read(
+        &LFS_filesystem, &COMMS_bulk_file_downlink_file, dest, len
+    );
+    if (read_result < 0) {
+        return read_result;
+    }
+
+    *seq_num_out = seq_num;
+    *file_offset_out = file_offset;
+    *data_len_out = (uint16_t)read_result;
+    return 0;
+}
+
+/// @brief Mark the packet from `COMMS_bulk_file_downlink_read_next_packet` as sent.
+/// @param seq_num The packet's sequence number.
+/// @param data_len The number of data bytes sent.
+/// @return 1 if the transfer is complete (all packets sent, and no NACKs pending), else 0.
+/// @details On completion, closes the file and returns to idle. A later NACK reopens it.
+uint8_t COMMS_bulk_file_downlink_packet_sent(uint16_t seq_num, uint16_t data_len) {
+    if (seq_num < COMMS_bulk_file_downlink_next_seq_num) {
+        // A resent packet.
+        const uint8_t mask = 1 << (seq_num % 8);
+        if (COMMS_bulk_file_downlink_nack_bitmap[seq_num / 8] & mask) {
+            COMMS_bulk_file_downlink_nack_bitmap[seq_num / 8] &= ~mask;
+            COMMS_bulk_file_downlink_nack_pending_count--;
+            COMMS_bulk_file_downlink_retransmit_count++;
+        }
+    }
+    else {
+        COMMS_bulk_file_downlink_bytes_downlinked += data_len;
+        COMMS_bulk_file_downlink_next_seq_num++;
+        COMMS_bulk_file_downlink_next_start_offset += data_len;
+
+        // Free the prefetch buffers which have been sent in full.
+        for (uint8_t i = 0; i < 2; i++) {
+            COMMS_bulk_file_downlink_prefetch_buffer_t *buffer = &COMMS_bulk_file_downlink_prefetch_buffers[i];
+            if ((buffer->file_offset + buffer->len) <= COMMS_bulk_file_downlink_next_start_offset) {
+                buffer->len = 0;
+            }
+        }
+    }
+
+    if (
+        (COMMS_bulk_file_downlink_bytes_downlinked >= COMMS_bulk_file_downlink_total_bytes)
+        && (COMMS_bulk_file_downlink_nack_pending_count == 0)
+    ) {
+        COMMS_bulk_file_downlink_close_file();
+        COMMS_bulk_file_downlink_state = COMMS_BULK_FILE_DOWNLINK_STATE_IDLE;
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief `COMMS_bulk_file_downlink_nack`, with `COMMS_bulk_file_downlink_lock` held.
+static int32_t COMMS_bulk_file_downlink_nack_with_lock_held(
+    uint16_t transfer_id, uint16_t first_seq_num, const uint8_t bitmap[], uint16_t bitmap_len,
+    uint16_t *nacked_count_out
+) {
+    *nacked_count_out = 0;
+    if ((transfer_id != COMMS_bulk_file_downlink_transfer_id) || (transfer_id == 0)) {
+        return 1;
+    }
+    if (!COMMS_bulk_file_downlink_transfer_supports_nack) {
+        return 2;
+    }
+    if (first_seq_num == 0) {
+        return 3;
+    }
+
+    const uint8_t was_complete = (
+        (COMMS_bulk_file_downlink_state == COMMS_BULK_FILE_DOWNLINK_STATE_IDLE)
+        && (COMMS_bulk_file_downlink_nack_pending_count == 0)
+    );
+
+    for (uint32_t bit_idx = 0; bit_idx < ((uint32_t)bitmap_len * 8); bit_idx++) {
+        if (!(bitmap[bit_idx / 8] & (1 << (bit_idx % 8)))) {
+            continue;
+        }
+        const uint32_t seq_num = first_seq_num + bit_idx;
+        if (seq_num >= COMMS_bulk_file_downlink_next_seq_num) {
+            break; // Not sent yet (and neither are any later ones).
+        }
+        const uint8_t mask = 1 << (seq_num % 8);
+        if (!(COMMS_bulk_file_downlink_nack_bitmap[seq_num / 8] & mask)) {
+            COMMS_bulk_file_downlink_nack_bitmap[seq_num / 8] |= mask;
+            COMMS_bulk_file_downlink_nack_pending_count++;
+            (*nacked_count_out)++;
+        }
+    }
+
+    if (was_complete && (COMMS_bulk_file_downlink_nack_pending_count > 0)) {
+        // Go by the open flag rather than the state: reopening an open `lfs_file_t` would
+        // corrupt LittleFS's list of open files.
+        COMMS_bulk_file_downlink_close_file();
+        const int32_t open_result = lfs_file_open(
+            &LFS_filesystem, &COMMS_bulk_file_downlink_file, COMMS_bulk_file_downlink_file_path, LFS_O_RDONLY
+        );
+        if (open_result < 0) {
+            LOG_message(
+                LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
+                "COMMS_bulk_file_downlink_nack: lfs_file_open() -> %ld",
+                open_result
+            );
+            memset(COMMS_bulk_file_downlink_nack_bitmap, 0, sizeof(COMMS_bulk_file_downlink_nack_bitmap));
+            COMMS_bulk_file_downlink_nack_pending_count = 0;
+            *nacked_count_out = 0;
+            return open_result;
+        }
+        COMMS_bulk_file_downlink_file_is_open = 1;
+        COMMS_bulk_file_downlink_state = COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING;
+    }
+    return 0;
+}
+
+/// @brief Request that packets of an uncompressed bulk downlink be sent again (selective repeat).
+/// @param transfer_id The transfer's ID (`COMMS_bulk_file_downlink_transfer_id`, given in the
+///     start telecommand's response). NACKs for any other transfer are rejected.
+/// @param first_seq_num Sequence number of bit 0 of the bitmap (first packet is 1).
+/// @param bitmap Bit N (byte N/8, LSB first) is set to request packet `first_seq_num + N`.
+/// @param bitmap_len Length of `bitmap` in bytes.
+/// @param nacked_count_out Number of packets newly queued to be resent. Bits for packets which
+///     were not sent yet (or are already queued) are ignored.
+/// @return 0 on success. Negative LFS error code if reopening the file failed. Positive error code
+///     on other errors: 1 for a different/unknown transfer ID, 2 if the transfer is compressed,
+///     3 if `first_seq_num` is 0.
+/// @details The packets are sent before continuing the downlink in sequence. If the transfer has
+///     already completed, the file is reopened and the downlink resumes with the NACKed packets.
+///     A paused downlink stays paused.
+int32_t COMMS_bulk_file_downlink_nack(
+    uint16_t transfer_id, uint16_t first_seq_num, const uint8_t bitmap[], uint16_t bitmap_len,
+    uint16_t *nacked_count_out
+) {
+    COMMS_bulk_file_downlink_lock();
+    const int32_t result = COMMS_bulk_file_downlink_nack_with_lock_held(
+        transfer_id, first_seq_num, bitmap, bitmap_len, nacked_count_out
+    );
+    COMMS_bulk_file_downlink_unlock();
+    return result;
+}
+
+
+/// @brief `COMMS_bulk_file_downlink_start_compressed`, with `COMMS_bulk_file_downlink_lock` held.
+static int32_t COMMS_bulk_file_downlink_start_compressed_with_lock_held(
+    char *file_path, uint32_t start_offset, uint32_t max_bytes, uint8_t window_sz2, uint8_t lookahead_sz2
+) {
+    if (
+        (window_sz2 < HEATSHRINK_MIN_WINDOW_BITS)
+        || (window_sz2 > HEATSHRINK_MAX_WINDOW_BITS)
+        || (lookahead_sz2 < HEATSHRINK_MIN_LOOKAHEAD_BITS)
+        || (lookahead_sz2 >= window_sz2)
+    ) {
+        return 20;
+    }
+
+    const int32_t start_result = COMMS_bulk_file_downlink_start_with_lock_held(file_path, start_offset, max_bytes);
+    if (start_result != 0) {
+        return start_result;
+    }
+
+    COMMS_bulk_file_downlink_encoder = heatshrink_encoder_alloc(window_sz2, lookahead_sz2);
+    if (COMMS_bulk_file_downlink_encoder == NULL) {
+        LOG_message(
+            LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
+            "COMMS_bulk_file_downlink_start_compressed: failed to allocate heatshrink encoder (window_sz2=%u)",
+            window_sz2
+        );
+        COMMS_bulk_file_downlink_stop();
+        return 21;
+    }
+
+    COMMS_bulk_file_downlink_compressed_header = (COMMS_bulk_file_downlink_compressed_header_t){
+        .magic = {'H', 'S'},
+        .version = COMMS_BULK_FILE_DOWNLINK_COMPRESSED_HEADER_VERSION,
+        .window_sz2 = window_sz2,
+        .lookahead_sz2 = lookahead_sz2,
+        .reserved = 0,
+        .source_start_offset = COMMS_bulk_file_downlink_absolute_start_offset,
+        .source_byte_count = COMMS_bulk_file_downlink_total_bytes,
+    };
+    COMMS_bulk_file_downlink_compressed_header_pos = 0;
+    COMMS_bulk_file_downlink_encoder_is_finishing = 0;
+    COMMS_bulk_file_downlink_read_chunk_len = 0;
+    COMMS_bulk_file_downlink_read_chunk_pos = 0;
+    COMMS_bulk_file_downlink_compressed_packet_is_filled = 0;
+    COMMS_bulk_file_downlink_next_start_offset = 0;
+    COMMS_bulk_file_downlink_total_seq_num = 0;
+    COMMS_bulk_file_downlink_is_compressed = 1;
+    // The compressed stream can't be regenerated from an arbitrary packet.
+    COMMS_bulk_file_downlink_transfer_supports_nack = 0;
+    return 0;
+}
+
+/// @brief Initiate a bulk file downlink over the UHF radio, compressing the file data on the fly.
+/// @param file_path File name/path to downlink.
+/// @param start_offset The byte offset in the file to start compressing from (0 for start).
+/// @param max_bytes The maximum number of file bytes to compress and downlink. Same limits as
+///     `COMMS_bulk_file_downlink_start` (applied to the file bytes, not the compressed bytes).
+/// @param window_sz2 Heatshrink log2 window size (like the CLI -w arg; recommended 8).
+/// @param lookahead_sz2 Heatshrink log2 lookahead size (like the CLI -l arg; recommended 4).
+/// @return 0 on success. Negative LFS failure code on LFS failure. Positive error code on other
+///     (logical/request) errors: 20 for invalid heatshrink parameters, 21 if the encoder can't be allocated.
+/// @details Packets are `COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK_COMPRESSED`, whose `file_offset` is
+///     the offset in the compressed stream. The stream starts with a
+///     `COMMS_bulk_file_downlink_compressed_header_t`, followed by the heatshrink output.
+///     Nothing is written to the filesystem (unlike `fs_compress_file_with_heatshrink`).
+/// @note `COMMS_bulk_file_downlink_bytes_downlinked` counts file bytes compressed so far, and
+///     `COMMS_bulk_file_downlink_next_start_offset` is the offset in the compressed stream.
+///     `COMMS_bulk_file_downlink_total_seq_num` is 0 until the downlink completes, as the
+///     compressed size is not known in advance.
+int32_t COMMS_bulk_file_downlink_start_compressed(
+    char *file_path, uint32_t start_offset, uint32_t max_bytes, uint8_t window_sz2, uint8_t lookahead_sz2
+) {
+    COMMS_bulk_file_downlink_lock();
+    const int32_t result = COMMS_bulk_file_downlink_start_compressed_with_lock_held(
+        file_path, start_offset, max_bytes, window_sz2, lookahead_sz2
+    );
+    COMMS_bulk_file_downlink_unlock();
+    return result;
+}
+
+/// @brief Free the compressed downlink's encoder, and return to uncompressed mode.
+/// @note Safe to call at any time (e.g., when not compressing).
+void COMMS_bulk_file_downlink_end_compression(void) {
+    if (COMMS_bulk_file_downlink_encoder != NULL) {
+        heatshrink_encoder_free(COMMS_bulk_file_downlink_encoder);
+        COMMS_bulk_file_downlink_encoder = NULL;
+    }
+    COMMS_bulk_file_downlink_is_compressed = 0;
+}
+
+/// @brief Fill the data of a compressed downlink packet, reading the file as needed.
+/// @param dest Packet data buffer.
+/// @param dest_size Bytes to fill (normally `COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET`).
+/// @param data_len_out Number of bytes filled. Only the last packet (or one cut short by a read
+///     error) is shorter than `dest_size`. The last packet may be empty, if the previous packet
+///     happened to end the stream exactly.
+/// @param is_last_packet_out Set to 1 when the compressed stream ends with this packet.
+/// @return 0 on success. Negative LFS error code if reading the file failed (nothing was consumed:
+///     call again to retry). Positive on heatshrink errors or misuse (the stream can't be continued).
+static int32_t COMMS_bulk_file_downlink_compress_packet(
+    uint8_t dest[], uint16_t dest_size, uint16_t *data_len_out, uint8_t *is_last_packet_out
+) {
+    *data_len_out = 0;
+    *is_last_packet_out = 0;
+
+    uint16_t len = 0;
+
+    // The header goes first, in the first packet.
+    const uint8_t *header_bytes = (const uint8_t *)&COMMS_bulk_file_downlink_compressed_header;
+    while (
+        (COMMS_bulk_file_downlink_compressed_header_pos < sizeof(COMMS_bulk_file_downlink_compressed_header))
+        && (len < dest_size)
+    ) {
+        dest[len++] = header_bytes[COMMS_bulk_file_downlink_compressed_header_pos++];
+    }
+
+    while (len < dest_size) {
+        size_t polled_count = 0;
+        const HSE_poll_res poll_result = heatshrink_encoder_poll(
+            COMMS_bulk_file_downlink_encoder, &dest[len], dest_size - len, &polled_count
+        );
+        if (poll_result < 0) {
+            return 2;
+        }
+        len += (uint16_t)polled_count;
+        if (poll_result == HSER_POLL_MORE) {
+            continue; // The packet is full (the loop ends), or the encoder has more output.
+        }
+
+        // The encoder has no more output until it gets more input.
+        if (COMMS_bulk_file_downlink_encoder_is_finishing) {
+            *is_last_packet_out = 1;
+            break;
+        }
+
+        if (COMMS_bulk_file_downlink_read_chunk_pos >= COMMS_bulk_file_downlink_read_chunk_len) {
+            const uint32_t bytes_remaining = (
+                COMMS_bulk_file_downlink_total_bytes - COMMS_bulk_file_downlink_bytes_downlinked
+            );
+            if (bytes_remaining == 0) {
+                // Flush the encoder's remaining output.
+                if (heatshrink_encoder_finish(COMMS_bulk_file_downlink_encoder) < 0) {
+                    return 3;
+                }
+                COMMS_bulk_file_downlink_encoder_is_finishing = 1;
+                continue;
+            }
+
+            const uint16_t read_count = (bytes_remaining > sizeof(COMMS_bulk_file_downlink_read_chunk))
+                ? sizeof(COMMS_bulk_file_downlink_read_chunk)
+                : (uint16_t)bytes_remaining;
+            const lfs_ssize_t read_result = lfs_file_read(
+                &LFS_filesystem, &COMMS_bulk_file_downlink_file, COMMS_bulk_file_downlink_read_chunk, read_count
+            );
+            if (read_result < 0) {
+                // Send what is already in the packet (packets carry their offset, so a short one
+                // is fine). The next call retries the read, and returns the error if it fails again.
+                if (len > 0) {
+                    break;
+                }
+                return read_result;
+            }
+            if (read_result == 0) {
+                // The file shrank since the start: compress what was read.
+                COMMS_bulk_file_downlink_total_bytes = COMMS_bulk_file_downlink_bytes_downlinked;
+                continue;
+            }
+            COMMS_bulk_file_downlink_read_chunk_len = (uint16_t)read_result;
+            COMMS_bulk_file_downlink_read_chunk_pos = 0;
+            COMMS_bulk_file_downlink_bytes_downlinked += (uint32_t)read_result;
+        }
+
+        size_t sunk_count = 0;
+        const HSE_sink_res sink_result = heatshrink_encoder_sink(
+            COMMS_bulk_file_downlink_encoder,
+            &COMMS_bulk_file_downlink_read_chunk[COMMS_bulk_file_downlink_read_chunk_pos],
+            COMMS_bulk_file_downlink_read_chunk_len - COMMS_bulk_file_downlink_read_chunk_pos,
+            &sunk_count
+        );
+        if (sink_result < 0) {
+            return 4;
+        }
+        COMMS_bulk_file_downlink_read_chunk_pos += (uint16_t)sunk_count;
+    }
+
+    *data_len_out = len;
+    return 0;
+}
+
+/// @brief Get the compressed downlink packet to send next (filling it, if needed).
+/// @param data_out Set to the packet data.
+/// @param data_len_out Number of bytes in the packet (0 only for an empty last packet).
+/// @param is_last_packet_out Set to 1 if the compressed stream ends with this packet.
+/// @return 0 on success. Negative LFS error code if reading the file failed (call again to retry).
+///     Positive on heatshrink errors or misuse (the stream can't be continued).
+/// @note Returns the same packet until `COMMS_bulk_file_downlink_compressed_packet_sent` is called.
+int32_t COMMS_bulk_file_downlink_get_compressed_packet(
+    const uint8_t **data_out, uint16_t *data_len_out, uint8_t *is_last_packet_out
+) {
+    if (!COMMS_bulk_file_downlink_is_compressed || (COMMS_bulk_file_downlink_encoder == NULL)) {
+        return 1;
+    }
+
+    if (!COMMS_bulk_file_downlink_compressed_packet_is_filled) {
+        const int32_t result = COMMS_bulk_file_downlink_compress_packet(
+            COMMS_bulk_file_downlink_compressed_packet,
+            sizeof(COMMS_bulk_file_downlink_compressed_packet),
+            &COMMS_bulk_file_downlink_compressed_packet_len,
+            &COMMS_bulk_file_downlink_compressed_packet_is_last
+        );
+        if (result != 0) {
+            return result;
+        }
+        COMMS_bulk_file_downlink_compressed_packet_is_filled = 1;
+    }
+
+    *data_out = COMMS_bulk_file_downlink_compressed_packet;
+    *data_len_out = COMMS_bulk_file_downlink_compressed_packet_len;
+    *is_last_packet_out = COMMS_bulk_file_downlink_compressed_packet_is_last;
+    return 0;
+}
+
+/// @brief Mark the packet from `COMMS_bulk_file_downlink_get_compressed_packet` as sent.
+/// @details Advances the sequence number and the stream offset. After the last packet, frees the
+///     encoder, closes the file, sets the total packet count, and returns to idle.
+void COMMS_bulk_file_downlink_compressed_packet_sent(void) {
+    if (!COMMS_bulk_file_downlink_compressed_packet_is_filled) {
+        return;
+    }
+    COMMS_bulk_file_downlink_compressed_packet_is_filled = 0;
+
+    if (COMMS_bulk_file_downlink_compressed_packet_len > 0) {
+        COMMS_bulk_file_downlink_next_seq_num++;
+        COMMS_bulk_file_downlink_next_start_offset += COMMS_bulk_file_downlink_compressed_packet_len;
+    }
+
+    if (COMMS_bulk_file_downlink_compressed_packet_is_last) {
+        COMMS_bulk_file_downlink_total_seq_num = COMMS_bulk_file_downlink_next_seq_num - 1;
+        COMMS_bulk_file_downlink_stop();
+    }
+}
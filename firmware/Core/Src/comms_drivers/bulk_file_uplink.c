@@ -1,6 +1,7 @@
 #include "comms_drivers/bulk_file_uplink.h"
 #include "littlefs/littlefs_helper.h"
 #include "log/log.h"
+#include "telecommand_exec/agenda_from_file.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -139,5 +140,16 @@ int32_t COMMS_bulk_file_uplink_close_file(void) {
     }
 
     COMMS_bulk_file_uplink_state = COMMS_BULK_FILE_UPLINK_STATE_IDLE;
+
+    // Index an uploaded active agenda file now, rather than in the background upkeep task's next
+    // agenda load. The upload may have changed any byte (seek, then write), so an index of any other
+    // file is dropped. The writes only become visible to readers at the close, so an index built
+    // during the upload was built from the old contents.
+    if (strcmp(COMMS_bulk_file_uplink_file_path, TCMD_active_agenda_filename) == 0) {
+        TCMD_agenda_file_build_index(COMMS_bulk_file_uplink_file_path); // Steamroll; rebuilt on load if needed.
+    }
+    else {
+        TCMD_agenda_file_invalidate_index(COMMS_bulk_file_uplink_file_path);
+    }
     return 0;
 }
@@ -2,6 +2,9 @@
 #include "comms_drivers/beacon.h"
 #include <string.h>
 
+// Packets are built in place in the AX100's TX buffers (`AX100_acquire_tx_buffer`), behind the
+// headroom for the CSP header, and sent without waiting for the I2C transfer.
+
 uint8_t COMMS_downlink_tcmd_response(
     uint64_t ts_sent, 
     uint8_t response_code, 
@@ -9,12 +12,6 @@ uint8_t COMMS_downlink_tcmd_response(
     char *response,
     uint32_t response_len
 ) {
-    COMMS_tcmd_response_packet_t packet;
-    packet.packet_type = COMMS_PACKET_TYPE_TCMD_RESPONSE;
-    packet.ts_sent = ts_sent;
-    packet.response_code = response_code;
-    packet.duration_ms = duration_ms;
-
     const uint8_t header_len = (
         AX100_DOWNLINK_MAX_BYTES - COMMS_TCMD_RESPONSE_PACKET_MAX_DATA_BYTES_PER_PACKET
     );
@@ -32,35 +29,40 @@ uint8_t COMMS_downlink_tcmd_response(
             ? COMMS_TCMD_RESPONSE_PACKET_MAX_DATA_BYTES_PER_PACKET
             : remaining_len;
 
-        packet.response_max_seq_num = max_seq_num;
-        packet.response_seq_num = response_seq_num++;
+        COMMS_tcmd_response_packet_t *packet = (COMMS_tcmd_response_packet_t *)AX100_acquire_tx_buffer();
+        if (packet == NULL) {
+            return 1;
+        }
+        packet->packet_type = COMMS_PACKET_TYPE_TCMD_RESPONSE;
+        packet->ts_sent = ts_sent;
+        packet->response_code = response_code;
+        packet->duration_ms = duration_ms;
+        packet->response_max_seq_num = max_seq_num;
+        packet->response_seq_num = response_seq_num++;
 
         // Copy the data into the packet
-        memcpy(packet.data, &response[response_start_idx], this_data_len);
+        memcpy(packet->data, &response[response_start_idx], this_data_len);
         remaining_len -= this_data_len;
         response_start_idx += this_data_len;
 
-        const uint8_t success = AX100_downlink_bytes((uint8_t *)(&packet), header_len + this_data_len);
+        const uint8_t success = AX100_send_tx_buffer((uint8_t *)packet, header_len + this_data_len);
         if (success != 0) {
             return success;
         }
     }
 
-    return 0;
+    // Get the result of the last packet too.
+    return AX100_flush_tx_buffers();
 }
 
 
-// Note: This packet is allocated in the data segment (global) to avoid requiring lots of stack space
-// in every task that emits a log. Could be stack-allocated, but would need to increase all stack sizes
-// by about 256 bytes.
-// Only used within `COMMS_downlink_log_message`.
-static COMMS_log_message_packet_t log_msg_packet;
-
 uint8_t COMMS_downlink_log_message(const char log_message_str[]) {
-    // Safety: Clear the packet because we reuse it.
-    memset(&log_msg_packet, 0, sizeof(log_msg_packet));
+    COMMS_log_message_packet_t *packet = (COMMS_log_message_packet_t *)AX100_acquire_tx_buffer();
+    if (packet == NULL) {
+        return 1;
+    }
 
-    log_msg_packet.packet_type = COMMS_PACKET_TYPE_LOG_MESSAGE;
+    packet->packet_type = COMMS_PACKET_TYPE_LOG_MESSAGE;
 
     const uint8_t header_len = (
         AX100_DOWNLINK_MAX_BYTES - COMMS_LOG_MESSAGE_PACKET_MAX_DATA_BYTES_PER_PACKET
@@ -72,28 +74,60 @@ uint8_t COMMS_downlink_log_message(const char log_message_str[]) {
         : log_message_len;
 
     // Copy the data into the packet.
-    memcpy(log_msg_packet.data, log_message_str, this_data_len);
+    memcpy(packet->data, log_message_str, this_data_len);
 
-    const uint8_t success = AX100_downlink_bytes((uint8_t *)(&log_msg_packet), header_len + this_data_len);
+    return AX100_send_tx_buffer((uint8_t *)packet, header_len + this_data_len);
+}
 
-    if (success != 0) {
-        return success;
+/// @brief Downlink one binary log record (see `log_binary.c`), in a single packet.
+/// @return 0 on success, 1 if the record does not fit in a packet, >1 on downlink error.
+uint8_t COMMS_downlink_log_record_binary(const uint8_t record_bytes[], uint16_t record_len) {
+    if (record_len > COMMS_LOG_MESSAGE_PACKET_MAX_DATA_BYTES_PER_PACKET) {
+        return 1;
     }
 
+    COMMS_log_message_packet_t *packet = (COMMS_log_message_packet_t *)AX100_acquire_tx_buffer();
+    if (packet == NULL) {
+        return 2;
+    }
+
+    packet->packet_type = COMMS_PACKET_TYPE_LOG_MESSAGE_BINARY;
+
+    const uint8_t header_len = (
+        AX100_DOWNLINK_MAX_BYTES - COMMS_LOG_MESSAGE_PACKET_MAX_DATA_BYTES_PER_PACKET
+    );
+
+    memcpy(packet->data, record_bytes, record_len);
+
+    const uint8_t result = AX100_send_tx_buffer((uint8_t *)packet, header_len + record_len);
+    if (result != 0) {
+        return result + 1;
+    }
     return 0;
 }
 
-uint8_t COMMS_downlink_bulk_file_downlink(
-    uint16_t file_seq_num,
+/// @brief Get a TX buffer to build a bulk file downlink packet in (e.g., to read the file straight
+///     into `packet->data`).
+/// @return The packet, or NULL if no TX buffer is free.
+/// @note Send with `COMMS_start_bulk_file_downlink_packet` then `AX100_finish_tx_buffer`, or give
+///     back with `AX100_release_tx_buffer`.
+COMMS_bulk_file_downlink_packet_t *COMMS_acquire_bulk_file_downlink_packet(void) {
+    return (COMMS_bulk_file_downlink_packet_t *)AX100_acquire_tx_buffer();
+}
+
+/// @brief Fill in the header of a packet from `COMMS_acquire_bulk_file_downlink_packet` (whose
+///     `data` is already written), and start sending it.
+/// @param packet_type COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK or COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK_COMPRESSED.
+/// @param file_offset Offset of the data in the file (or in the compressed stream).
+/// @return 0 if the transfer was started, >0 on error. Get the result with `AX100_finish_tx_buffer`.
+uint8_t COMMS_start_bulk_file_downlink_packet(
+    COMMS_bulk_file_downlink_packet_t *packet,
+    COMMS_packet_type_enum_t packet_type,
     uint32_t file_offset,
-    uint8_t data[],
     uint16_t data_len
 ) {
-    // Note: Used to include file_seq_num in the packet, but not necessary. Was just a waste of space.
-
-    COMMS_bulk_file_downlink_packet_t packet;
-    packet.packet_type = COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK;
-    packet.file_offset = file_offset;
+    packet->packet_type = packet_type;
+    packet->file_offset = file_offset;
 
     const uint8_t header_len = (
         AX100_DOWNLINK_MAX_BYTES - COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET
@@ -103,29 +137,44 @@ uint8_t COMMS_downlink_bulk_file_downlink(
         ? COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET
         : data_len;
 
-    // Copy the data into the packet.
-    memcpy(packet.data, data, this_data_len);
-
-    const uint8_t success = AX100_downlink_bytes((uint8_t *)(&packet), header_len + this_data_len);
+    return AX100_start_tx_buffer((uint8_t *)packet, header_len + this_data_len);
+}
 
-    if (success != 0) {
-        return success;
+/// @brief Downlink a packet of a compressed bulk file downlink, and wait for the transfer.
+/// @param stream_offset Offset of `data` in the compressed stream (not in the file).
+uint8_t COMMS_downlink_bulk_file_downlink_compressed(
+    uint32_t stream_offset,
+    uint8_t data[],
+    uint16_t data_len
+) {
+    COMMS_bulk_file_downlink_packet_t *packet = COMMS_acquire_bulk_file_downlink_packet();
+    if (packet == NULL) {
+        return 1;
     }
 
-    return 0;
-}
+    const uint16_t this_data_len = (data_len > COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET)
+        ? COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET
+        : data_len;
+
+    // Copy the data into the packet.
+    memcpy(packet->data, data, this_data_len);
 
-static COMMS_beacon_basic_packet_t beacon_basic_packet;
+    const uint8_t start_result = COMMS_start_bulk_file_downlink_packet(
+        packet, COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK_COMPRESSED, stream_offset, this_data_len
+    );
+    const uint8_t finish_result = AX100_finish_tx_buffer((uint8_t *)packet);
+    return (start_result != 0) ? start_result : finish_result;
+}
 
 uint8_t COMMS_downlink_beacon_basic_packet() {
+    COMMS_beacon_basic_packet_t *packet = (COMMS_beacon_basic_packet_t *)AX100_acquire_tx_buffer();
+    if (packet == NULL) {
+        return 1;
+    }
+
     // Pack the packet with the current system state.
     // This is a function that only reads from memory (and can't fail), so no error handling.
-    COMMS_fill_beacon_basic_packet(&beacon_basic_packet);
-
-    const uint8_t success = AX100_downlink_bytes(
-        (uint8_t *)(&beacon_basic_packet), 
-        sizeof(COMMS_beacon_basic_packet_t)
-    );
+    COMMS_fill_beacon_basic_packet(packet);
 
-    return success;
+    return AX100_send_tx_buffer((uint8_t *)packet, sizeof(COMMS_beacon_basic_packet_t));
 }
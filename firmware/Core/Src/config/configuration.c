@@ -1,5 +1,6 @@
 #include "config/configuration.h"
 #include "comms_drivers/ax100_tx.h"
+#include "comms_drivers/ax100_tx_pacing.h"
 #include "comms_drivers/comms_tx.h"
 #include "rtos_tasks/rtos_bootup_operation_fsm_task.h"
 #include "comms_drivers/rf_antenna_switch.h"
@@ -16,18 +17,33 @@ extern uint32_t EPS_max_time_deviation_for_sync_ms;
 extern uint32_t TASK_heartbeat_period_ms;
 extern uint32_t TCMD_require_valid_sha256;
 extern uint32_t CONFIG_EPS_enable_uart_debug_print;
-extern uint32_t TCMD_handle_ax100_tcmds_interval_ms;
-extern uint32_t TCMD_handle_umbilical_tcmds_interval_ms;
 extern uint32_t MPI_max_temperature_shutoff_celcius;
 extern uint32_t MPI_max_recording_duration_sec;
+extern uint32_t MPI_science_ring_buffer_count;
+extern uint32_t MPI_frame_index_interval_frames;
 extern uint32_t STM32_system_reset_interval_sec;
 extern uint32_t STM32_system_reset_no_uplink_interval_sec;
 extern uint32_t COMMS_beacon_interval_ms;
 extern uint32_t GNSS_write_cmd_mode_data_to_firehose_file;
 extern uint32_t LOG_timestamp_prefix_format;
+extern uint32_t LOG_deferred_formatting_enabled;
+extern uint32_t LOG_binary_format_sink_mask;
+extern uint32_t LOG_logger_task_idle_poll_period_ms;
 extern uint32_t TCMD_enqueue_from_agenda_file_interval_ms;
 extern uint32_t TCMD_enqueue_grace_period_ms;
+extern uint32_t TCMD_agenda_file_use_index;
 extern uint32_t TCMD_max_consecutive_burst_execution_size;
+extern uint32_t TCMD_resp_store_batching_enabled;
+extern uint32_t TCMD_resp_store_flush_bytes;
+extern uint32_t TCMD_resp_store_flush_age_ms;
+
+extern uint32_t FLASH_cache_read_enabled;
+extern uint32_t LFS_page_cache_page_count;
+extern uint32_t LFS_page_cache_read_ahead_page_count;
+extern uint32_t LFS_dir_listing_index_max_age_ms;
+extern uint32_t LFS_checksum_digest_cache_enabled;
+
+extern uint32_t COMMS_bulk_file_downlink_prefetch_enabled;
 
 extern uint32_t LOG_file_flush_interval_sec;
 extern uint32_t LOG_file_rotation_interval_sec;
@@ -105,6 +121,18 @@ CONFIG_integer_config_entry_t CONFIG_int_config_variables[] = {
         .variable_name = "LOG_timestamp_prefix_format",
         .num_config_var = &LOG_timestamp_prefix_format,
     },
+    {
+        .variable_name = "LOG_deferred_formatting_enabled",
+        .num_config_var = &LOG_deferred_formatting_enabled,
+    },
+    {
+        .variable_name = "LOG_binary_format_sink_mask",
+        .num_config_var = &LOG_binary_format_sink_mask,
+    },
+    {
+        .variable_name = "LOG_logger_task_idle_poll_period_ms",
+        .num_config_var = &LOG_logger_task_idle_poll_period_ms,
+    },
     {
         .variable_name = "TCMD_enqueue_from_agenda_file_interval_ms",
         .num_config_var = &TCMD_enqueue_from_agenda_file_interval_ms,
@@ -113,6 +141,10 @@ CONFIG_integer_config_entry_t CONFIG_int_config_variables[] = {
         .variable_name = "TCMD_enqueue_grace_period_ms",
         .num_config_var = &TCMD_enqueue_grace_period_ms,
     },
+    {
+        .variable_name = "TCMD_agenda_file_use_index",
+        .num_config_var = &TCMD_agenda_file_use_index,
+    },
     // ******** AX100 Configuration ********
     {
         .variable_name = "AX100_enable_downlink_uart_logs",
@@ -122,16 +154,36 @@ CONFIG_integer_config_entry_t CONFIG_int_config_variables[] = {
         .variable_name = "AX100_enable_downlink_inhibited_uart_logs",
         .num_config_var = &AX100_enable_downlink_inhibited_uart_logs,
     },
-    // ******** END AX100 Configuration ********
-    // ******** Telecommand Parsing and Execution ********
     {
-        .variable_name = "TCMD_handle_umbilical_tcmds_interval_ms",
-        .num_config_var = &TCMD_handle_umbilical_tcmds_interval_ms,
+        .variable_name = "AX100_tx_dma_enabled",
+        .num_config_var = &AX100_tx_dma_enabled,
     },
     {
-        .variable_name = "TCMD_handle_ax100_tcmds_interval_ms",
-        .num_config_var = &TCMD_handle_ax100_tcmds_interval_ms,
+        .variable_name = "AX100_tx_pacing_enabled",
+        .num_config_var = &AX100_tx_pacing_enabled,
     },
+    {
+        .variable_name = "AX100_tx_bitrate_bps",
+        .num_config_var = &AX100_tx_bitrate_bps,
+    },
+    {
+        .variable_name = "AX100_tx_overhead_bytes_per_packet",
+        .num_config_var = &AX100_tx_overhead_bytes_per_packet,
+    },
+    {
+        .variable_name = "AX100_tx_pacing_max_queued_ms",
+        .num_config_var = &AX100_tx_pacing_max_queued_ms,
+    },
+    {
+        .variable_name = "AX100_tx_stall_i2c_duration_ms",
+        .num_config_var = &AX100_tx_stall_i2c_duration_ms,
+    },
+    {
+        .variable_name = "AX100_tx_pacing_probe_after_clean_sends",
+        .num_config_var = &AX100_tx_pacing_probe_after_clean_sends,
+    },
+    // ******** END AX100 Configuration ********
+    // ******** Telecommand Parsing and Execution ********
     {
         .variable_name = "TCMD_require_valid_sha256",
         .num_config_var = &TCMD_require_valid_sha256,
@@ -144,11 +196,27 @@ CONFIG_integer_config_entry_t CONFIG_int_config_variables[] = {
         .variable_name = "TCMD_max_consecutive_burst_execution_size",
         .num_config_var = &TCMD_max_consecutive_burst_execution_size,
     },
+    {
+        .variable_name = "TCMD_resp_store_batching_enabled",
+        .num_config_var = &TCMD_resp_store_batching_enabled,
+    },
+    {
+        .variable_name = "TCMD_resp_store_flush_bytes",
+        .num_config_var = &TCMD_resp_store_flush_bytes,
+    },
+    {
+        .variable_name = "TCMD_resp_store_flush_age_ms",
+        .num_config_var = &TCMD_resp_store_flush_age_ms,
+    },
     // ******** COMMS Configuration ********
     {
         .variable_name = "COMMS_bulk_downlink_delay_per_packet_ms",
         .num_config_var = &COMMS_bulk_downlink_delay_per_packet_ms,
     },
+    {
+        .variable_name = "COMMS_bulk_file_downlink_prefetch_enabled",
+        .num_config_var = &COMMS_bulk_file_downlink_prefetch_enabled,
+    },
     {
         .variable_name = "COMMS_uptime_to_start_ant_deployment_sec",
         .num_config_var = &COMMS_uptime_to_start_ant_deployment_sec,
@@ -167,11 +235,44 @@ CONFIG_integer_config_entry_t CONFIG_int_config_variables[] = {
         .variable_name = "MPI_max_recording_duration_sec",
         .num_config_var = &MPI_max_recording_duration_sec,
     },
+    {
+        .variable_name = "MPI_science_ring_buffer_count",
+        .num_config_var = &MPI_science_ring_buffer_count,
+    },
+    {
+        .variable_name = "MPI_frame_index_interval_frames",
+        .num_config_var = &MPI_frame_index_interval_frames,
+    },
     // GNSS Configuration
     {
         .variable_name = "GNSS_write_cmd_mode_data_to_firehose_file",
         .num_config_var = &GNSS_write_cmd_mode_data_to_firehose_file,
     },
+    // Flash Configuration
+    {
+        .variable_name = "FLASH_cache_read_enabled",
+        .num_config_var = &FLASH_cache_read_enabled,
+    },
+    {
+        .variable_name = "LFS_chip_layout_for_format",
+        .num_config_var = &LFS_chip_layout_for_format,
+    },
+    {
+        .variable_name = "LFS_page_cache_page_count",
+        .num_config_var = &LFS_page_cache_page_count,
+    },
+    {
+        .variable_name = "LFS_page_cache_read_ahead_page_count",
+        .num_config_var = &LFS_page_cache_read_ahead_page_count,
+    },
+    {
+        .variable_name = "LFS_dir_listing_index_max_age_ms",
+        .num_config_var = &LFS_dir_listing_index_max_age_ms,
+    },
+    {
+        .variable_name = "LFS_checksum_digest_cache_enabled",
+        .num_config_var = &LFS_checksum_digest_cache_enabled,
+    },
 };
 
 // extern
@@ -13,6 +13,18 @@
               This implementation uses little endian byte order.
 *********************************************************************/
 
+// Changes from the original, for hashing large files on the Cortex-M4:
+// - Message words are loaded whole (4-byte `memcpy` and a byte swap, which GCC compiles to an
+//   unaligned `LDR` and `REV` on the target) instead of being assembled from bytes.
+// - The message schedule is a rolling 16-word window instead of a 64-word array, and the rounds
+//   are unrolled 8 at a time so that the working variables stay in registers without being
+//   shuffled each round.
+// - `sha256_update` hashes whole blocks straight from the input, instead of copying every byte
+//   through `ctx->data`.
+// - The transform is compiled at -O2 even in the -Og firmware build.
+// The same C builds for the host simulation. `SHA256_CTX` is plain data, so a hash in progress
+// can be saved and resumed later.
+
 /*************************** HEADER FILES ***************************/
 #include <stdlib.h>
 #include <memory.h>
@@ -22,13 +34,50 @@
 #define ROTLEFT(a,b) (((a) << (b)) | ((a) >> (32-(b))))
 #define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
 
-#define CH(x,y,z) (((x) & (y)) ^ (~(x) & (z)))
-#define MAJ(x,y,z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define CH(x,y,z) ((((y) ^ (z)) & (x)) ^ (z))
+#define MAJ(x,y,z) (((x) & (y)) | ((z) & ((x) | (y))))
 #define EP0(x) (ROTRIGHT(x,2) ^ ROTRIGHT(x,13) ^ ROTRIGHT(x,22))
 #define EP1(x) (ROTRIGHT(x,6) ^ ROTRIGHT(x,11) ^ ROTRIGHT(x,25))
 #define SIG0(x) (ROTRIGHT(x,7) ^ ROTRIGHT(x,18) ^ ((x) >> 3))
 #define SIG1(x) (ROTRIGHT(x,17) ^ ROTRIGHT(x,19) ^ ((x) >> 10))
 
+#if defined(__GNUC__) && !defined(__clang__)
+#define SHA256_HOT __attribute__((optimize("O2")))
+#else
+#define SHA256_HOT
+#endif
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define SHA256_FROM_BE32(x) (x)
+#else
+#define SHA256_FROM_BE32(x) __builtin_bswap32(x)
+#endif
+
+// Message word `i` (0 to 63), computed in place in the 16-word window `w`.
+#define SCHEDULE(i) \
+    (w[(i) & 15] += SIG1(w[((i) - 2) & 15]) + w[((i) - 7) & 15] + SIG0(w[((i) - 15) & 15]))
+
+// One round, with the working variables renamed instead of shifted: `d` and `h` are updated, and
+// the next round is called with the arguments rotated by one.
+#define ROUND(a,b,c,d,e,f,g,h,i,wi) do { \
+    const WORD t1 = (h) + EP1(e) + CH(e,f,g) + k[i] + (wi); \
+    (d) += t1; \
+    (h) = t1 + EP0(a) + MAJ(a,b,c); \
+} while (0)
+
+#define ROUNDS_8(i,wi) do { \
+    ROUND(a,b,c,d,e,f,g,h,(i) + 0,wi((i) + 0)); \
+    ROUND(h,a,b,c,d,e,f,g,(i) + 1,wi((i) + 1)); \
+    ROUND(g,h,a,b,c,d,e,f,(i) + 2,wi((i) + 2)); \
+    ROUND(f,g,h,a,b,c,d,e,(i) + 3,wi((i) + 3)); \
+    ROUND(e,f,g,h,a,b,c,d,(i) + 4,wi((i) + 4)); \
+    ROUND(d,e,f,g,h,a,b,c,(i) + 5,wi((i) + 5)); \
+    ROUND(c,d,e,f,g,h,a,b,(i) + 6,wi((i) + 6)); \
+    ROUND(b,c,d,e,f,g,h,a,(i) + 7,wi((i) + 7)); \
+} while (0)
+
+#define W_LOADED(i) (w[i])
+
 /**************************** VARIABLES *****************************/
 static const WORD k[64] = {
     0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
@@ -42,45 +91,47 @@ static const WORD k[64] = {
 };
 
 /*********************** FUNCTION DEFINITIONS ***********************/
-void sha256_transform(SHA256_CTX *ctx, const BYTE data[])
+/// @brief Hash `block_count` consecutive 64-byte blocks into `state`.
+/// @param data The blocks. Need not be word-aligned.
+static SHA256_HOT void sha256_transform_blocks(WORD state[8], const BYTE data[], size_t block_count)
 {
-    WORD a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
-
-    for (i = 0, j = 0; i < 16; ++i, j += 4)
-        m[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | (data[j + 3]);
-    for ( ; i < 64; ++i)
-        m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
-
-    a = ctx->state[0];
-    b = ctx->state[1];
-    c = ctx->state[2];
-    d = ctx->state[3];
-    e = ctx->state[4];
-    f = ctx->state[5];
-    g = ctx->state[6];
-    h = ctx->state[7];
-
-    for (i = 0; i < 64; ++i) {
-        t1 = h + EP1(e) + CH(e,f,g) + k[i] + m[i];
-        t2 = EP0(a) + MAJ(a,b,c);
-        h = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
-    }
+    WORD a, b, c, d, e, f, g, h, w[16];
+
+    while (block_count > 0) {
+        for (WORD i = 0; i < 16; ++i) {
+            WORD word;
+            memcpy(&word, &data[i * 4], sizeof(word));
+            w[i] = SHA256_FROM_BE32(word);
+        }
+
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        f = state[5];
+        g = state[6];
+        h = state[7];
+
+        ROUNDS_8(0, W_LOADED);
+        ROUNDS_8(8, W_LOADED);
+        for (WORD i = 16; i < 64; i += 16) {
+            ROUNDS_8(i, SCHEDULE);
+            ROUNDS_8(i + 8, SCHEDULE);
+        }
 
-    ctx->state[0] += a;
-    ctx->state[1] += b;
-    ctx->state[2] += c;
-    ctx->state[3] += d;
-    ctx->state[4] += e;
-    ctx->state[5] += f;
-    ctx->state[6] += g;
-    ctx->state[7] += h;
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+
+        data += 64;
+        block_count--;
+    }
 }
 
 void sha256_init(SHA256_CTX *ctx)
@@ -99,17 +150,33 @@ void sha256_init(SHA256_CTX *ctx)
 
 void sha256_update(SHA256_CTX *ctx, const BYTE data[], size_t len)
 {
-    WORD i;
-
-    for (i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
-        if (ctx->datalen == 64) {
-            sha256_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
+    // Complete a partially-filled block first.
+    if (ctx->datalen > 0) {
+        const size_t fill_len = ((64 - ctx->datalen) < len) ? (64 - ctx->datalen) : len;
+        memcpy(&ctx->data[ctx->datalen], data, fill_len);
+        ctx->datalen += fill_len;
+        data += fill_len;
+        len -= fill_len;
+        if (ctx->datalen < 64) {
+            return;
         }
+        sha256_transform_blocks(ctx->state, ctx->data, 1);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
     }
+
+    // Hash whole blocks directly from the input.
+    const size_t block_count = len / 64;
+    if (block_count > 0) {
+        sha256_transform_blocks(ctx->state, data, block_count);
+        ctx->bitlen += (unsigned long long)block_count * 512;
+        data += block_count * 64;
+        len -= block_count * 64;
+    }
+
+    // Keep the rest for the next update.
+    memcpy(ctx->data, data, len);
+    ctx->datalen = len;
 }
 
 void sha256_final(SHA256_CTX *ctx, BYTE hash[])
@@ -119,16 +186,13 @@ void sha256_final(SHA256_CTX *ctx, BYTE hash[])
     i = ctx->datalen;
 
     // Pad whatever data is left in the buffer.
+    ctx->data[i++] = 0x80;
     if (ctx->datalen < 56) {
-        ctx->data[i++] = 0x80;
-        while (i < 56)
-            ctx->data[i++] = 0x00;
+        memset(&ctx->data[i], 0, 56 - i);
     }
     else {
-        ctx->data[i++] = 0x80;
-        while (i < 64)
-            ctx->data[i++] = 0x00;
-        sha256_transform(ctx, ctx->data);
+        memset(&ctx->data[i], 0, 64 - i);
+        sha256_transform_blocks(ctx->state, ctx->data, 1);
         memset(ctx->data, 0, 56);
     }
 
@@ -142,19 +206,13 @@ void sha256_final(SHA256_CTX *ctx, BYTE hash[])
     ctx->data[58] = ctx->bitlen >> 40;
     ctx->data[57] = ctx->bitlen >> 48;
     ctx->data[56] = ctx->bitlen >> 56;
-    sha256_transform(ctx, ctx->data);
+    sha256_transform_blocks(ctx->state, ctx->data, 1);
 
     // Since this implementation uses little endian byte ordering and SHA uses big endian,
     // reverse all the bytes when copying the final state to the output hash.
-    for (i = 0; i < 4; ++i) {
-        hash[i]      = (ctx->state[0] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 4]  = (ctx->state[1] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 8]  = (ctx->state[2] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 12] = (ctx->state[3] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 16] = (ctx->state[4] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 20] = (ctx->state[5] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 24] = (ctx->state[6] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 28] = (ctx->state[7] >> (24 - i * 8)) & 0x000000ff;
+    for (i = 0; i < 8; ++i) {
+        const WORD word = SHA256_FROM_BE32(ctx->state[i]);
+        memcpy(&hash[i * 4], &word, sizeof(word));
     }
 }
 
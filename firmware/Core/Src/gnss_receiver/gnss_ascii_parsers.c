@@ -50,19 +50,23 @@ uint8_t GNSS_header_response_parser(const char *data_received, GNSS_header_respo
     strncpy(header_buffer, sync_char, header_length);
     header_buffer[header_length] = '\0';  // Null-terminate the substring
 
+    // Split the fields once, instead of rescanning the buffer for each field.
+    TCMD_args_t header_fields;
+    TCMD_tokenize_args(header_buffer, header_length, &header_fields);
+
     // Parse the data in the header buffer
     uint8_t parse_result;
     char token_buffer[128];
 
     // Log Name
-    parse_result = TCMD_extract_string_arg(header_buffer, 0, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&header_fields, 0, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
     strcpy(result->log_name, token_buffer + 1);
 
     // Time Status
-    parse_result = TCMD_extract_string_arg(header_buffer, 4, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&header_fields, 4, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -163,13 +167,17 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     strncpy(bestxyza_data_buffer, bestxyza_data_start, bestxyza_data_length);
     bestxyza_data_buffer[bestxyza_data_length] = '\0';
 
+    // Split the fields once, instead of rescanning the buffer for each field.
+    TCMD_args_t bestxyza_fields;
+    TCMD_tokenize_args(bestxyza_data_buffer, bestxyza_data_length, &bestxyza_fields);
+
     // Parse the data in the bestxyza data buffer
     uint8_t parse_result;
     char token_buffer[128];
     char *end_ptr;
     
     // Position Solution Status
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 0, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 0, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -180,7 +188,7 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     }
 
     // Position Type
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 1, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 1, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -191,7 +199,7 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     }
 
     // Position Coordinates 
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 2, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 2, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -212,7 +220,7 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     }
     result->position_x_mm = (int64_t) conv_result;
 
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 3, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 3, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -232,7 +240,7 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     }
     result->position_y_mm = (int64_t) conv_result;
 
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 4, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 4, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -253,7 +261,7 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     result->position_z_mm = (int64_t) conv_result;
 
     // Position Coordinates Standard Deviation
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 5, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 5, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -273,7 +281,7 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     }
     result->position_x_std_mm = (int32_t) conv_result;
 
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 6, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 6, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -293,7 +301,7 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     }
     result->position_y_std_mm = (int32_t) conv_result;
 
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 7, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 7, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -314,7 +322,7 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     result->position_z_std_mm = (int32_t) conv_result;
 
     // Differential Age
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 18, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 18, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -335,7 +343,7 @@ uint8_t GNSS_bestxyza_data_parser(const char* data_received, GNSS_bestxyza_respo
     result->differential_age_ms = (int64_t) conv_result;
 
     // Solution Age
-    parse_result = TCMD_extract_string_arg(bestxyza_data_buffer, 19, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&bestxyza_fields, 19, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -477,13 +485,17 @@ uint8_t GNSS_timea_data_parser(const char* data_received, GNSS_timea_response_t
     strncpy(timea_data_buffer, timea_data_start, timea_data_length);
     timea_data_buffer[timea_data_length] = '\0';
 
+    // Split the fields once, instead of rescanning the buffer for each field.
+    TCMD_args_t timea_fields;
+    TCMD_tokenize_args(timea_data_buffer, timea_data_length, &timea_fields);
+
     // Parse the data in the bestxyza data buffer
     uint8_t parse_result;
     char token_buffer[128];
     char *end_ptr;
     
     // Clock Model Status
-    parse_result = TCMD_extract_string_arg(timea_data_buffer, 0, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&timea_fields, 0, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -494,7 +506,7 @@ uint8_t GNSS_timea_data_parser(const char* data_received, GNSS_timea_response_t
     }
 
     // UTC Offset
-    parse_result = TCMD_extract_string_arg(timea_data_buffer, 3, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&timea_fields, 3, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
@@ -515,7 +527,7 @@ uint8_t GNSS_timea_data_parser(const char* data_received, GNSS_timea_response_t
 
 
     // UTC Status
-    parse_result = TCMD_extract_string_arg(timea_data_buffer, 10, token_buffer, sizeof(token_buffer));
+    parse_result = TCMD_args_get_string(&timea_fields, 10, token_buffer, sizeof(token_buffer));
     if (parse_result != 0) {  
         return parse_result;  
     }
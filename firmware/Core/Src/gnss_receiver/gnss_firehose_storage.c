@@ -9,6 +9,8 @@
 
 #include "gnss_receiver/gnss_internal_drivers.h"
 #include "uart_handler/uart_handler.h"
+#include "uart_handler/uart_dma_ring.h"
+#include "uart_handler/uart_error_tracking.h"
 #include "log/log.h"
 #include "littlefs/littlefs_helper.h"
 #include "timekeeping/timekeeping.h"
@@ -173,8 +175,8 @@ uint8_t GNSS_enable_firehose_storage_mode(const char output_file_path[]) {
         return 5;
     }
     
-    // Make it start writing to the start of the buffer.
-    UART_gnss_buffer_write_idx = 0;
+    // Only store data received from now on.
+    UART_dma_ring_discard_all(&UART_gnss_rx_ring);
     GNSS_current_rx_mode = GNSS_RX_MODE_FIREHOSE_MODE;
 
     // Enable GNSS receiving.
@@ -251,7 +253,7 @@ static uint32_t last_gnss_flush_uptime_ms = 0;
 uint32_t GNSS_firehose_flush_interval_ms = 30000;
 
 
-/// @brief Store pending data in the UART_gnss_buffer to the GNSS firehose file.
+/// @brief Store pending data in `UART_gnss_rx_ring` to the GNSS firehose file.
 /// @return 0 on success or no-op. Non-zero: Error.
 /// @note Intended to be called in a periodic background loop, but also can be called from telecommand.
 uint8_t GNSS_subtask_store_firehose_data_to_file() {
@@ -261,7 +263,8 @@ uint8_t GNSS_subtask_store_firehose_data_to_file() {
     }
 
     // If there's no data to write, early exit.
-    if (UART_gnss_buffer_write_idx == 0) {
+    uint16_t gnss_rx_data_len_remaining = UART_dma_ring_available(&UART_gnss_rx_ring);
+    if (gnss_rx_data_len_remaining == 0) {
         return 0;
     }
 
@@ -270,47 +273,46 @@ uint8_t GNSS_subtask_store_firehose_data_to_file() {
         return 0;
     }
 
+    // Copy out of the DMA ring in stack-sized chunks. The DMA keeps receiving into the rest of the
+    // ring meanwhile. Only what was pending at the start is written, so that this always returns.
+    const uint32_t overrun_bytes_lost_at_start = UART_gnss_rx_ring.overrun_bytes_lost;
+    uint8_t gnss_rx_chunk[512];
+    lfs_ssize_t total_write_len = 0;
+    while (gnss_rx_data_len_remaining > 0) {
+        const uint16_t chunk_len = UART_dma_ring_read(
+            &UART_gnss_rx_ring, gnss_rx_chunk,
+            (gnss_rx_data_len_remaining < sizeof(gnss_rx_chunk)) ? gnss_rx_data_len_remaining : sizeof(gnss_rx_chunk)
+        );
+        if (chunk_len == 0) {
+            break;
+        }
+        gnss_rx_data_len_remaining -= chunk_len;
 
-    // If the response is short (bestxyza, versiona, etc.), copy to a buffer. If it's too large,
-    // (e.g., ephema), then we'll just read it right out of the UART buffer, and make the assumption
-    // that there's a low chance the buffer will change while we're reading out of it.
-    const uint16_t gnss_rx_data_len_max_for_copy = 512; // Max stack-allocated buffer.
-    const uint16_t gnss_rx_data_len = UART_gnss_buffer_write_idx;
-    uint8_t gnss_rx_data_if_short[gnss_rx_data_len_max_for_copy]; // Unused if data is long.
-    uint8_t* gnss_rx_data_ptr;
-    if (gnss_rx_data_len <= gnss_rx_data_len_max_for_copy) {
-        // memcpy from the volatile:
-        for (uint16_t i = 0; i < gnss_rx_data_len; i++) { // Memcpy out of volatile.
-            gnss_rx_data_if_short[i] = UART_gnss_buffer[i];
+        const lfs_ssize_t write_result = lfs_file_write(
+            &LFS_filesystem, &GNSS_firehose_file_pointer, gnss_rx_chunk, chunk_len
+        );
+        if (write_result < 0) {
+            LOG_message(
+                LOG_SYSTEM_GNSS, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+                "GNSS firehose: Error writing to file: %ld", write_result
+            );
+            return 10;
         }
-        gnss_rx_data_ptr = gnss_rx_data_if_short;
-    }
-    else {
-        // Too long to copy to the stack.
-        gnss_rx_data_ptr = (uint8_t*) UART_gnss_buffer; // Discard volatile.
+        total_write_len += write_result;
     }
 
-    // Reset the write index so subsequent writes go back to the start.
-    UART_gnss_buffer_write_idx = 0;
-
-    // Write to the file.
-    const lfs_ssize_t write_result = lfs_file_write(
-        &LFS_filesystem, &GNSS_firehose_file_pointer,
-        gnss_rx_data_ptr, // Either `UART_gnss_buffer` directly, or a stack-allocated buffer.
-        gnss_rx_data_len // Copy of UART_gnss_buffer_write_idx
-    );
-    if (write_result < 0) {
-        LOG_message(
-            LOG_SYSTEM_GNSS, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-            "GNSS firehose: Error writing to file: %ld", write_result
-        );
-        return 10;
+    // Data overwritten by the DMA before it was read (i.e., this subtask didn't run often enough).
+    const uint32_t overrun_bytes_lost = UART_gnss_rx_ring.overrun_bytes_lost - overrun_bytes_lost_at_start;
+    if (overrun_bytes_lost > 0) {
+        // Tracking error
+        UART_error_gnss_error_info.handler_buffer_full_error_count++;
+        GNSS_firehose_bytes_lost += overrun_bytes_lost;
     }
 
     LOG_message(
         LOG_SYSTEM_GNSS, LOG_SEVERITY_DEBUG, LOG_SINK_ALL,
         "GNSS firehose: Successfully wrote %ld bytes.",
-        write_result
+        total_write_len
     );
 
     // Conditionally, flush the file to storage.
@@ -6,7 +6,7 @@
 #include "gnss_receiver/gnss_firehose_storage.h"
 #include "uart_handler/uart_handler.h"
 #include "stm32/stm32_timing_helpers.h"
-#include "uart_handler/uart_handler.h"
+#include "uart_handler/uart_dma_ring.h"
 #include "log/log.h"
 #include "timekeeping/timekeeping.h"
 
@@ -49,17 +49,10 @@ static uint8_t GNSS_send_cmd_get_response_when_firehose_storage_disabled(
     uint16_t* rx_buf_len_dest,
     uint8_t remove_null_bytes_in_middle
 ) {
-    // Reset the GNSS UART interrupt variables
-    GNSS_set_uart_interrupt_state(0); // Lock writing to the UART_gnss_buffer while we memset it
-    for (uint16_t i = 0; i < UART_gnss_buffer_len; i++) {
-        // Clear the buffer.
-        // Can't use memset because UART_gnss_buffer is volatile.
-        // Review comment: I think just setting the UART_gnss_buffer_write_idx to the start is good enough, but we'll keep this.
-        UART_gnss_buffer[i] = 0;
-    }
-    
-    // Make it start writing to the start of the buffer.
-    UART_gnss_buffer_write_idx = 0;
+    // Start listening before transmitting, so the start of the response can't be missed.
+    // Anything already in the ring (e.g., firehose data, or noise) isn't part of the response.
+    GNSS_set_uart_interrupt_state(1);
+    UART_dma_ring_discard_all(&UART_gnss_rx_ring);
 
     // TX TO GNSS
     const HAL_StatusTypeDef tx_status_1 = HAL_UART_Transmit(
@@ -81,15 +74,18 @@ static uint8_t GNSS_send_cmd_get_response_when_firehose_storage_disabled(
             "GNSS ERROR: tx_status != HAL_OK (%d, %d)",
             tx_status_1, tx_status_2
         );
+        GNSS_set_uart_interrupt_state(0);
         return 1;
     }
 
-    GNSS_set_uart_interrupt_state(1);	// We are now expecting a response
-
-    // RX FROM GNSS, into UART_gnss_buffer
+    // RX FROM GNSS, out of UART_gnss_rx_ring into rx_buf (leaving space for a null terminator)
+    const uint16_t rx_len_max = rx_buf_max_size - 1;
+    uint16_t rx_len = 0;
     const uint32_t start_rx_time = TIME_uptime_ms();
     while (1) {
-        if ((UART_gnss_buffer_write_idx == 0)) {
+        rx_len += UART_dma_ring_read(&UART_gnss_rx_ring, &rx_buf[rx_len], rx_len_max - rx_len);
+
+        if ((rx_len == 0)) {
             // Check if we've timed out (before the first byte)
             if ((TIME_uptime_ms() - start_rx_time) > GNSS_RX_TIMEOUT_BEFORE_FIRST_BYTE_MS) {
                 LOG_message(
@@ -105,7 +101,7 @@ static uint8_t GNSS_send_cmd_get_response_when_firehose_storage_disabled(
                 return 2; // Error: Timeout before receiving any data.
             }
         }
-        else { // thus, UART_gnss_buffer_write_idx > 0
+        else { // thus, rx_len > 0
             // Check if we've timed out (between bytes)
             const uint32_t cur_time = TIME_uptime_ms();
             // Note: Sometimes, because ISRs and C are fun, the UART_gnss_last_write_time_ms is
@@ -124,20 +120,20 @@ static uint8_t GNSS_send_cmd_get_response_when_firehose_storage_disabled(
             // Critical to end communication as fast as possible, especially for time-related and
             // time-sensitive commands.
             // End of message example: ...,38000,VALID*5ea733a7[\r or \n]
-            // Index offset from write_idx:   -10  -9  -8  -7  -6  -5  -4  -3  -2  -1
+            // Index offset from rx_len:      -10  -9  -8  -7  -6  -5  -4  -3  -2  -1
             // Character:                       *   H   H   H   H   H   H   H   H  \n|r
             if (
-                (UART_gnss_buffer_write_idx > 12) // Semi-arbitrary minimum length (>10).
+                (rx_len > 12) // Semi-arbitrary minimum length (>10).
                 && (
-                    (UART_gnss_buffer[UART_gnss_buffer_write_idx - 1] == '\r')
-                    || (UART_gnss_buffer[UART_gnss_buffer_write_idx - 1] == '\n')
+                    (rx_buf[rx_len - 1] == '\r')
+                    || (rx_buf[rx_len - 1] == '\n')
                 )
-                && (UART_gnss_buffer[UART_gnss_buffer_write_idx - 10] == '*')
+                && (rx_buf[rx_len - 10] == '*')
             ) {
                 // Validate the 8 chars between '*' and EOL are all hex digits.
                 uint8_t is_valid_hex = 1;
                 for (int i = 2; i <= 9; i++) {
-                    const uint8_t c = UART_gnss_buffer[UART_gnss_buffer_write_idx - i];
+                    const uint8_t c = rx_buf[rx_len - i];
                     if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
                         is_valid_hex = 0;
                         break;
@@ -149,7 +145,7 @@ static uint8_t GNSS_send_cmd_get_response_when_firehose_storage_disabled(
             }
 
             // Exit if we've received all the buffer can hold.
-            if (UART_gnss_buffer_write_idx >= rx_buf_max_size) {
+            if (rx_len >= rx_len_max) {
                 break;
             }
         }
@@ -158,38 +154,29 @@ static uint8_t GNSS_send_cmd_get_response_when_firehose_storage_disabled(
     // End Receiving
     GNSS_set_uart_interrupt_state(0); // We are no longer expecting a response
 
-    // Review comment: This next line doesn't seem necessary.
-    UART_gnss_buffer[UART_gnss_buffer_write_idx] = '\0'; // Null-terminate the string.
-
     // Check that we've received what we're expecting.
-    uint16_t bytes_received_count = 0; // Includes null bytes.
-    if (UART_gnss_buffer_write_idx >= rx_buf_max_size) {
+    if (rx_len >= rx_len_max) {
         LOG_message(
             LOG_SYSTEM_GNSS, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
             "GNSS: Received more data (>=%d bytes) than rx_buf_max_size (%d bytes)",
-            UART_gnss_buffer_write_idx,
+            rx_len + 1,
             rx_buf_max_size
         );
-        
-        bytes_received_count = rx_buf_max_size - 1;
         // No need to return here. We can still pass back the data we have.
     }
-    else {
-        bytes_received_count = UART_gnss_buffer_write_idx;
-    }
 
-    // Copy the log response from the UART gnss buffer to the rx_buf[] and clear the buffer.
+    // Remove null bytes (in place), if requested.
     uint16_t dest_write_idx = 0;
     uint16_t remove_nulls_count = 0;
-    for (uint16_t i = 0; i < bytes_received_count; i++) {
+    for (uint16_t i = 0; i < rx_len; i++) {
         if (remove_null_bytes_in_middle) {
-            if (UART_gnss_buffer[i] == '\0') {
+            if (rx_buf[i] == '\0') {
                 remove_nulls_count++;
                 continue;
             }
         }
 
-        rx_buf[dest_write_idx++] = UART_gnss_buffer[i];
+        rx_buf[dest_write_idx++] = rx_buf[i];
     }
     *rx_buf_len_dest = dest_write_idx;
 
@@ -230,8 +217,8 @@ uint8_t GNSS_send_cmd_get_response(
 ) {
     const GNSS_rx_mode_enum_t rx_mode_at_start = GNSS_current_rx_mode;
     
-    // We must first store any pending data in the UART_gnss_buffer to the file,
-    // before clearing the buffer.
+    // We must first store any pending data in the UART_gnss_rx_ring to the file,
+    // before the command discards it.
     if (rx_mode_at_start == GNSS_RX_MODE_FIREHOSE_MODE) {
         GNSS_subtask_store_firehose_data_to_file();
     }
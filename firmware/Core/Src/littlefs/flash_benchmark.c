@@ -101,3 +101,127 @@ uint8_t FLASH_benchmark_erase_write_read(uint8_t chip_num, uint32_t test_data_ad
 
     return 0;
 }
+
+
+
+/// @brief Append one line of `FLASH_benchmark_sequential_read` results to `response_str`.
+static void FLASH_benchmark_append_throughput(
+    const char label[], uint32_t bytes, uint32_t duration_ms, uint32_t sum,
+    char* response_str, uint16_t response_str_len
+) {
+    // MB/s = bytes/ms / 1000, printed with 3 decimals using integer math.
+    const uint32_t bytes_per_s = (duration_ms > 0) ? (uint32_t)(((uint64_t)bytes * 1000) / duration_ms) : 0;
+    snprintf(
+        &response_str[strlen(response_str)],
+        response_str_len - strlen(response_str),
+        "%s: %lu ms, %lu.%03lu MB/s (sum=%lu)\n",
+        label, duration_ms, bytes_per_s / 1000000, (bytes_per_s / 1000) % 1000, sum);
+}
+
+/// @brief Benchmarks reading consecutive pages: one page read at a time (before cache read mode),
+///     in cache read mode, and in cache read mode with the CPU work overlapping the next transfer.
+/// @param chip_num Chip number to use.
+/// @param start_page_address Row address (page number) of the first page to read.
+/// @param page_count Number of consecutive pages to read in each pass.
+/// @param response_str 
+/// @param response_str_len 
+/// @return 0 on success. 1 if the arguments are out of range. 2 if a read failed. 3 if the passes
+///     read different data.
+/// @details Each pass sums every byte read, standing in for the work done on the data (e.g.,
+///     a checksum or downlink packet). `FLASH_cache_read_enabled` is restored afterwards.
+uint8_t FLASH_benchmark_sequential_read(uint8_t chip_num, uint32_t start_page_address, uint32_t page_count, char* response_str, uint16_t response_str_len) {
+    response_str[0] = '\0';
+
+    const uint32_t pages_per_chip = FLASH_CHIP_SIZE_BYTES / FLASH_CHIP_PAGE_SIZE_BYTES;
+    if ((chip_num >= FLASH_NUMBER_OF_FLASH_DEVICES) || (page_count == 0) || (start_page_address >= pages_per_chip) || (page_count > (pages_per_chip - start_page_address))) {
+        snprintf(
+            &response_str[strlen(response_str)],
+            response_str_len - strlen(response_str),
+            "Error: chip or page range out of range\n");
+        return 1;
+    }
+
+    // Static: two pages is too much for the telecommand task's stack.
+    static uint8_t page_buffers[2][FLASH_CHIP_PAGE_SIZE_BYTES];
+    const uint32_t total_bytes = page_count * FLASH_CHIP_PAGE_SIZE_BYTES;
+    const uint32_t original_cache_read_enabled = FLASH_cache_read_enabled;
+    uint32_t sums[3] = {0, 0, 0};
+    uint8_t result = 0;
+
+    // Passes 0 and 1: read, then process, one page at a time (without/with cache read mode).
+    for (uint8_t pass = 0; (pass < 2) && (result == 0); pass++) {
+        FLASH_cache_read_enabled = pass;
+
+        const uint32_t start_time = TIME_uptime_ms();
+        for (uint32_t page_num = 0; page_num < page_count; page_num++) {
+            const FLASH_Physical_Address_t address = {.row_address = start_page_address + page_num, .col_address = 0};
+            if (FLASH_read_page(chip_num, address, page_buffers[0], FLASH_CHIP_PAGE_SIZE_BYTES) != FLASH_ERR_OK) {
+                result = 2;
+                break;
+            }
+            for (uint32_t i = 0; i < FLASH_CHIP_PAGE_SIZE_BYTES; i++) {
+                sums[pass] += page_buffers[0][i];
+            }
+        }
+        const uint32_t end_time = TIME_uptime_ms();
+
+        if (result == 0) {
+            FLASH_benchmark_append_throughput(
+                (pass == 0) ? "Page read" : "Cache read", total_bytes, end_time - start_time, sums[pass],
+                response_str, response_str_len
+            );
+        }
+    }
+
+    // Pass 2: cache read mode, processing each page while the next one is transferred.
+    if (result == 0) {
+        FLASH_cache_read_enabled = 1;
+
+        const uint32_t start_time = TIME_uptime_ms();
+        for (uint32_t page_num = 0; page_num <= page_count; page_num++) {
+            if (page_num < page_count) {
+                const FLASH_Physical_Address_t address = {.row_address = start_page_address + page_num, .col_address = 0};
+                if (FLASH_start_read_page(chip_num, address, page_buffers[page_num % 2], FLASH_CHIP_PAGE_SIZE_BYTES) != FLASH_ERR_OK) {
+                    result = 2;
+                    break;
+                }
+            }
+            if (page_num > 0) {
+                const uint8_t *previous_page = page_buffers[(page_num - 1) % 2];
+                for (uint32_t i = 0; i < FLASH_CHIP_PAGE_SIZE_BYTES; i++) {
+                    sums[2] += previous_page[i];
+                }
+            }
+            if ((page_num < page_count) && (FLASH_wait_for_read_page() != FLASH_ERR_OK)) {
+                result = 2;
+                break;
+            }
+        }
+        const uint32_t end_time = TIME_uptime_ms();
+
+        if (result == 0) {
+            FLASH_benchmark_append_throughput(
+                "Cache read, overlapped", total_bytes, end_time - start_time, sums[2],
+                response_str, response_str_len
+            );
+        }
+    }
+
+    FLASH_cache_read_enabled = original_cache_read_enabled;
+
+    if (result != 0) {
+        snprintf(
+            &response_str[strlen(response_str)],
+            response_str_len - strlen(response_str),
+            "Read failed.\n");
+        return result;
+    }
+    if ((sums[0] != sums[1]) || (sums[0] != sums[2])) {
+        snprintf(
+            &response_str[strlen(response_str)],
+            response_str_len - strlen(response_str),
+            "Verify failed: passes read different data.\n");
+        return 3;
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+// flash_busy_wait.c
+// Poll schedule for waiting on a long NAND operation (page program, block erase), and the
+// per-chip busy time statistics. Kept free of HAL calls, so that the host build can use it.
+//
+// Instead of reading the status register back-to-back, the waiter sleeps for the datasheet's
+// typical busy time, then polls at intervals which grow with the overshoot. The CPU is free for
+// other tasks while it sleeps, and an operation which runs long costs few extra polls.
+
+#include "littlefs/flash_busy_wait.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+// Page program (tPROG) and block erase (tBERS) busy times. Typical and max from the datasheet;
+// the timeouts leave a 2x margin over the max.
+const FLASH_busy_wait_timing_t FLASH_PAGE_PROGRAM_TIMING = {.typical_us = 200, .timeout_us = 1200};
+const FLASH_busy_wait_timing_t FLASH_BLOCK_ERASE_TIMING = {.typical_us = 2000, .timeout_us = 20000};
+
+/// @brief Get how long to wait before the next status register poll.
+/// @param elapsed_us Time since the operation was started.
+/// @return Delay before the next poll, in microseconds (at least 1).
+/// @details Until `typical_us`, wait out the rest of it. After that, wait half the overshoot so
+///     far, clamped to [typical/16, typical/2], so the polls get sparser as the operation runs long,
+///     and the ready chip is noticed at most ~50% late.
+uint32_t FLASH_busy_wait_next_poll_delay_us(const FLASH_busy_wait_timing_t *timing, uint32_t elapsed_us) {
+    if (elapsed_us < timing->typical_us) {
+        return timing->typical_us - elapsed_us;
+    }
+
+    const uint32_t min_delay_us = (timing->typical_us / 16) > 0 ? (timing->typical_us / 16) : 1;
+    const uint32_t max_delay_us = (timing->typical_us / 2) > min_delay_us ? (timing->typical_us / 2) : min_delay_us;
+    const uint32_t delay_us = (elapsed_us - timing->typical_us) / 2;
+
+    if (delay_us < min_delay_us) {
+        return min_delay_us;
+    }
+    if (delay_us > max_delay_us) {
+        return max_delay_us;
+    }
+    return delay_us;
+}
+
+/// @brief Get the histogram bucket for a busy time: floor(log2(busy_us)), clamped to the buckets.
+uint8_t FLASH_busy_time_histogram_bucket(uint32_t busy_us) {
+    uint8_t bucket = 0;
+    while ((busy_us > 1) && (bucket < (FLASH_BUSY_TIME_HISTOGRAM_BUCKET_COUNT - 1))) {
+        busy_us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/// @brief Record the busy time of an operation which completed (successfully or not).
+void FLASH_busy_time_stats_record(FLASH_busy_time_stats_t *stats, uint32_t busy_us, uint32_t status_poll_count) {
+    if ((stats->count == 0) || (busy_us < stats->min_us)) {
+        stats->min_us = busy_us;
+    }
+    if (busy_us > stats->max_us) {
+        stats->max_us = busy_us;
+    }
+    stats->count++;
+    stats->total_us += busy_us;
+    stats->status_poll_count += status_poll_count;
+    stats->histogram[FLASH_busy_time_histogram_bucket(busy_us)]++;
+}
+
+/// @brief Record an operation which was still busy at the timeout.
+void FLASH_busy_time_stats_record_timeout(FLASH_busy_time_stats_t *stats, uint32_t status_poll_count) {
+    stats->timeout_count++;
+    stats->status_poll_count += status_poll_count;
+}
+
+/// @brief Format busy time statistics as a JSON object.
+/// @return Number of characters written (excluding the null terminator), or -1 if truncated.
+int16_t FLASH_busy_time_stats_to_json(
+    const FLASH_busy_time_stats_t *stats, char json_output_buf[], uint16_t json_output_buf_size
+) {
+    // Histogram as a JSON array body (e.g., "0,0,3,12").
+    char histogram_str[FLASH_BUSY_TIME_HISTOGRAM_BUCKET_COUNT * 11 + 1];
+    histogram_str[0] = '\0';
+    for (uint8_t bucket = 0; bucket < FLASH_BUSY_TIME_HISTOGRAM_BUCKET_COUNT; bucket++) {
+        snprintf(
+            &histogram_str[strlen(histogram_str)],
+            sizeof(histogram_str) - strlen(histogram_str),
+            "%s%" PRIu32,
+            (bucket == 0) ? "" : ",",
+            stats->histogram[bucket]
+        );
+    }
+
+    const uint32_t mean_us = (stats->count > 0) ? (uint32_t)(stats->total_us / stats->count) : 0;
+    const int written = snprintf(
+        json_output_buf,
+        json_output_buf_size,
+        "{"
+            "\"count\":%" PRIu32 ","
+            "\"timeout_count\":%" PRIu32 ","
+            "\"min_us\":%" PRIu32 ","
+            "\"mean_us\":%" PRIu32 ","
+            "\"max_us\":%" PRIu32 ","
+            "\"status_poll_count\":%" PRIu32 ","
+            "\"histogram_log2_us\":[%s]"
+        "}",
+        stats->count,
+        stats->timeout_count,
+        stats->min_us,
+        mean_us,
+        stats->max_us,
+        stats->status_poll_count,
+        histogram_str
+    );
+    if ((written < 0) || (written >= json_output_buf_size)) {
+        return -1;
+    }
+    return (int16_t)written;
+}
@@ -1,3 +1,5 @@
+#include "main.h"
+#include "cmsis_os.h"
 #include "littlefs/flash_driver.h"
 #include "log/log.h"
 
@@ -5,14 +7,50 @@
 static FLASH_error_enum_t FLASH_disable_block_lock(uint8_t chip_number);
 static FLASH_error_enum_t FLASH_write_enable(uint8_t chip_number);
 static FLASH_error_enum_t FLASH_write_disable(uint8_t chip_number);
-static FLASH_error_enum_t FLASH_wait_until_ready(uint8_t chip_number);
+static FLASH_error_enum_t FLASH_wait_until_ready(uint8_t chip_number, uint8_t fail_status_mask);
+static FLASH_error_enum_t FLASH_wait_until_not_busy(uint8_t chip_number, uint8_t busy_status_mask, uint8_t fail_status_mask);
+static FLASH_error_enum_t FLASH_cache_read_advance(uint8_t chip_number, uint32_t next_row_address);
+static FLASH_error_enum_t FLASH_end_cache_read(uint8_t chip_number);
+static FLASH_error_enum_t FLASH_wait_until_ready_with_backoff(
+    uint8_t chip_number, const FLASH_busy_wait_timing_t *timing, uint8_t fail_status_mask,
+    FLASH_busy_time_stats_t *stats
+);
+
+#define FLASH_CHIP_PAGES_PER_CHIP (FLASH_CHIP_SIZE_BYTES / FLASH_CHIP_PAGE_SIZE_BYTES)
+
+/// @brief Boolean. Whether `FLASH_read_page` puts a chip in cache read mode when consecutive
+///     pages are read from it, so that each next page loads from the array while the current
+///     one is read out over SPI.
+/// @note 1 = enabled, 0 = always use a separate page read per page.
+uint32_t FLASH_cache_read_enabled = 1;
+
+// Per-chip cache read state. While a chip is in cache read mode, `FLASH_cache_read_loading_row`
+// is the page being loaded into its data register, and only status register reads and further
+// cache reads may be sent to it (see `FLASH_end_cache_read`).
+static uint8_t FLASH_cache_read_active[FLASH_NUMBER_OF_FLASH_DEVICES];
+static uint32_t FLASH_cache_read_loading_row[FLASH_NUMBER_OF_FLASH_DEVICES];
+static uint32_t FLASH_last_read_row[FLASH_NUMBER_OF_FLASH_DEVICES];
+
+// Measured busy times, per chip. See `flash_get_busy_time_stats_json` telecommand.
+FLASH_busy_time_stats_t FLASH_program_busy_time_stats[FLASH_NUMBER_OF_FLASH_DEVICES];
+FLASH_busy_time_stats_t FLASH_erase_busy_time_stats[FLASH_NUMBER_OF_FLASH_DEVICES];
 
 FLASH_error_enum_t FLASH_init(uint8_t chip_number) {
-    return FLASH_disable_block_lock(chip_number);
+    // The chip keeps its cache read mode across an MCU reset (e.g., one during a read), and only
+    // takes status register reads and cache reads in it. So end it, whether or not it's on.
+    FLASH_error_enum_t end_cache_read_result = FLASH_ERR_OK;
+    if (chip_number < FLASH_NUMBER_OF_FLASH_DEVICES) {
+        FLASH_cache_read_active[chip_number] = 1;
+        end_cache_read_result = FLASH_end_cache_read(chip_number);
+    }
+
+    const FLASH_error_enum_t block_lock_result = FLASH_disable_block_lock(chip_number);
+    return (end_cache_read_result != FLASH_ERR_OK) ? end_cache_read_result : block_lock_result;
 }
 
 
 FLASH_error_enum_t FLASH_erase_block(uint8_t chip_number, FLASH_Physical_Address_t address) {
+    FLASH_end_cache_read(chip_number);
     FLASH_write_enable(chip_number);
 
     // Send erase command along with the address of the block.
@@ -25,7 +63,10 @@ FLASH_error_enum_t FLASH_erase_block(uint8_t chip_number, FLASH_Physical_Address
         goto cleanup; 
     }
 
-    result = FLASH_wait_until_ready(chip_number);
+    result = FLASH_wait_until_ready_with_backoff(
+        chip_number, &FLASH_BLOCK_ERASE_TIMING, FLASH_SR1_ERASE_ERROR_MASK,
+        (chip_number < FLASH_NUMBER_OF_FLASH_DEVICES) ? &FLASH_erase_busy_time_stats[chip_number] : NULL
+    );
 
 cleanup:
     FLASH_write_disable(chip_number);
@@ -38,6 +79,7 @@ cleanup:
 
 FLASH_error_enum_t FLASH_program_page(uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *data, uint32_t data_len) {
 
+    FLASH_end_cache_read(chip_number);
     FLASH_write_enable(chip_number);
     
     // Send the program load command along with the address of where in the page to start writing the data.  (always 0 since we always write a full page).
@@ -65,7 +107,10 @@ FLASH_error_enum_t FLASH_program_page(uint8_t chip_number, FLASH_Physical_Addres
         goto cleanup;
     }
 
-    result = FLASH_wait_until_ready(chip_number);
+    result = FLASH_wait_until_ready_with_backoff(
+        chip_number, &FLASH_PAGE_PROGRAM_TIMING, FLASH_SR1_PROGRAMMING_ERROR_MASK,
+        (chip_number < FLASH_NUMBER_OF_FLASH_DEVICES) ? &FLASH_program_busy_time_stats[chip_number] : NULL
+    );
 
 cleanup:
     FLASH_write_disable(chip_number);
@@ -79,22 +124,70 @@ cleanup:
 FLASH_error_enum_t FLASH_read_page(
     uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *rx_buffer, uint32_t rx_buffer_size
 ) {
-    const uint64_t row_address = address.row_address;
-
-    const uint8_t cmd_buff[] = {FLASH_CMD_PAGE_READ, ((row_address >> 16) & 0xFF), ((row_address >> 8) & 0xFF), (row_address & 0xFF)};
-    const FLASH_SPI_Data_t read_cmd = {.data = cmd_buff, .len = sizeof(cmd_buff)};
-
-    FLASH_error_enum_t result = FLASH_SPI_send_command(&read_cmd, chip_number);
+    const FLASH_error_enum_t result = FLASH_start_read_page(chip_number, address, rx_buffer, rx_buffer_size);
     if (result != FLASH_ERR_OK) {
         return result;
     }
+    return FLASH_wait_for_read_page();
+}
+
+
+
 
-    // Wait until the page is read into the cache from the main array.
-    result = FLASH_wait_until_ready(chip_number);
+
+/// @brief Start reading a page: get it into the chip's cache, then start reading the cache out
+///     into `rx_buffer` with DMA, and return without waiting for the transfer.
+/// @param rx_buffer Must stay valid until `FLASH_wait_for_read_page()` returns.
+/// @details When the page follows the previous page read from this chip, the chip is put in (or
+///     kept in) cache read mode: the page after this one starts loading from the array while this
+///     one is read out, so a run of consecutive reads never waits for a page load (tRD).
+///     Callers can overlap their own work too, e.g., processing the previous page between
+///     `FLASH_start_read_page()` and `FLASH_wait_for_read_page()`.
+/// @note Only one read may be in progress at a time (all chips share SPI1).
+FLASH_error_enum_t FLASH_start_read_page(
+    uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *rx_buffer, uint32_t rx_buffer_size
+) {
+    const uint32_t row_address = address.row_address;
+    const uint8_t has_cache_read_state = (chip_number < FLASH_NUMBER_OF_FLASH_DEVICES);
+    FLASH_error_enum_t result;
+
+    if (
+        has_cache_read_state && FLASH_cache_read_enabled
+        && FLASH_cache_read_active[chip_number]
+        && (FLASH_cache_read_loading_row[chip_number] == row_address)
+    ) {
+        // The page is already loading: move it to the cache, and start loading the one after it.
+        result = FLASH_cache_read_advance(chip_number, row_address + 1);
+    }
+    else {
+        result = FLASH_end_cache_read(chip_number);
+        if (result != FLASH_ERR_OK) {
+            return result;
+        }
+
+        const uint8_t cmd_buff[] = {FLASH_CMD_PAGE_READ, ((row_address >> 16) & 0xFF), ((row_address >> 8) & 0xFF), (row_address & 0xFF)};
+        const FLASH_SPI_Data_t read_cmd = {.data = cmd_buff, .len = sizeof(cmd_buff)};
+
+        result = FLASH_SPI_send_command(&read_cmd, chip_number);
+        if (result != FLASH_ERR_OK) {
+            return result;
+        }
+
+        // Wait until the page is read into the cache from the main array.
+        result = FLASH_wait_until_ready(chip_number, 0);
+
+        const uint8_t is_sequential = has_cache_read_state && (row_address == (FLASH_last_read_row[chip_number] + 1));
+        if ((result == FLASH_ERR_OK) && FLASH_cache_read_enabled && is_sequential) {
+            result = FLASH_cache_read_advance(chip_number, row_address + 1);
+        }
+    }
     if (result != FLASH_ERR_OK) {
         return result;
     }
 
+    if (has_cache_read_state) {
+        FLASH_last_read_row[chip_number] = row_address;
+    }
 
     // Read the data from the cache into the buffer.
     const uint32_t col_address = address.col_address;
@@ -105,7 +198,16 @@ FLASH_error_enum_t FLASH_read_page(
     };
     const FLASH_SPI_Data_t read_from_cache_cmd = {.data = read_from_cache_cmd_bytes, .len = sizeof(read_from_cache_cmd_bytes)};
 
-    return FLASH_SPI_send_command_receive_response(&read_from_cache_cmd, rx_buffer, rx_buffer_size, chip_number);
+    return FLASH_SPI_start_command_receive_response(&read_from_cache_cmd, rx_buffer, rx_buffer_size, chip_number);
+}
+
+
+
+
+
+/// @brief Wait for the read started by `FLASH_start_read_page()` to finish.
+FLASH_error_enum_t FLASH_wait_for_read_page(void) {
+    return FLASH_SPI_wait_for_transfer();
 }
 
 
@@ -113,6 +215,8 @@ FLASH_error_enum_t FLASH_read_page(
 
 
 FLASH_error_enum_t FLASH_is_reachable(uint8_t chip_number) {
+    FLASH_end_cache_read(chip_number);
+
     const uint8_t read_id_cmd_bytes[] = {FLASH_CMD_READ_ID, 0x00}; // send one dummy byte (see pg. 25 of the datasheet).
     const FLASH_SPI_Data_t read_id_cmd = {.data = read_id_cmd_bytes, .len = sizeof(read_id_cmd_bytes)};
 
@@ -135,6 +239,11 @@ FLASH_error_enum_t FLASH_is_reachable(uint8_t chip_number) {
 
 
 FLASH_error_enum_t FLASH_reset(uint8_t chip_number) {
+    // A reset also ends cache read mode.
+    if (chip_number < FLASH_NUMBER_OF_FLASH_DEVICES) {
+        FLASH_cache_read_active[chip_number] = 0;
+    }
+
     const uint8_t reset_cmd_bytes[] = {FLASH_CMD_RESET};
     const FLASH_SPI_Data_t reset_cmd = {.data = reset_cmd_bytes, .len = sizeof(reset_cmd_bytes)};
 
@@ -166,8 +275,20 @@ void FLASH_enable_then_disable_chip_select(uint8_t chip_number) {
 
 /// @brief Wait until the flash chip is ready for the next command.
 /// @param chip_number the chip select line to enable.
-/// @return FLASH_ERR_OK on success, or an error code on failure.
-static FLASH_error_enum_t FLASH_wait_until_ready(uint8_t chip_number) {
+/// @param fail_status_mask Status register bits which indicate that the operation failed
+///     (e.g., `FLASH_SR1_ERASE_ERROR_MASK` after an erase). 0 to not check.
+/// @return FLASH_ERR_OK on success, FLASH_ERR_STATUS_REG_ERROR if the operation failed (i.e., the
+///     block is bad), or another error code on failure.
+static FLASH_error_enum_t FLASH_wait_until_ready(uint8_t chip_number, uint8_t fail_status_mask) {
+    return FLASH_wait_until_not_busy(chip_number, FLASH_OP_IN_PROGRESS_MASK, fail_status_mask);
+}
+
+
+
+/// @brief Wait until none of the `busy_status_mask` bits are set in the status register.
+/// @details In cache read mode, OIP clears once the cache can be read, while CRBSY stays set
+///     until the next page has loaded.
+static FLASH_error_enum_t FLASH_wait_until_not_busy(uint8_t chip_number, uint8_t busy_status_mask, uint8_t fail_status_mask) {
     // TODO: This will need to be changed if we change the clock speed.
     const uint8_t max_attempts = 20; // 10 was too low, 20 seems to work well.
 
@@ -178,8 +299,11 @@ static FLASH_error_enum_t FLASH_wait_until_ready(uint8_t chip_number) {
             return result;
         }
             
-        const uint8_t flash_is_busy = (status_register & FLASH_OP_IN_PROGRESS_MASK);
+        const uint8_t flash_is_busy = (status_register & busy_status_mask);
         if (!flash_is_busy) {
+            if (status_register & fail_status_mask) {
+                return FLASH_ERR_STATUS_REG_ERROR;
+            }
             return FLASH_ERR_OK;
         }
 
@@ -191,6 +315,169 @@ static FLASH_error_enum_t FLASH_wait_until_ready(uint8_t chip_number) {
 
 
 
+/// @brief Get the time since `start_cycle_count` (from the DWT cycle counter), in microseconds.
+/// @param start_cycle_count Value of `DWT->CYCCNT` at the start. Intervals up to 2^32 cycles
+///     (~268 s at 16 MHz) are measured correctly across the counter wrapping.
+static uint32_t FLASH_get_elapsed_us(uint32_t start_cycle_count) {
+    return (DWT->CYCCNT - start_cycle_count) / (SystemCoreClock / 1000000);
+}
+
+/// @brief Enable the DWT cycle counter (if not already), and get its value.
+static uint32_t FLASH_get_start_cycle_count(void) {
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    return DWT->CYCCNT;
+}
+
+
+
+/// @brief Wait about `delay_us`, letting other tasks run.
+/// @details Whole milliseconds are slept with `osDelay`, so that any task can run. The rest is
+///     spent yielding to other ready tasks (of the same priority) between checks of the time.
+///     Before the scheduler starts, this is a busy-wait.
+static void FLASH_busy_wait_delay_us(uint32_t delay_us) {
+    const uint32_t start_cycle_count = FLASH_get_start_cycle_count();
+    const uint8_t scheduler_is_running = (osKernelGetState() == osKernelRunning);
+
+    // osDelay(n) sleeps between n-1 and n ticks (1 ms), so the remainder is spun below.
+    if (scheduler_is_running && (delay_us >= 1000)) {
+        osDelay(delay_us / 1000);
+    }
+    while (FLASH_get_elapsed_us(start_cycle_count) < delay_us) {
+        if (scheduler_is_running) {
+            osThreadYield();
+        }
+    }
+}
+
+
+
+/// @brief Wait until a page program or block erase is done, sleeping and polling the status
+///     register on the backoff schedule of `FLASH_busy_wait_next_poll_delay_us`.
+/// @param timing Typical busy time and timeout of the operation.
+/// @param fail_status_mask Status register bits which indicate that the operation failed.
+/// @param stats Busy time statistics to record into, or NULL.
+/// @return FLASH_ERR_OK on success, FLASH_ERR_STATUS_REG_ERROR if the operation failed (i.e., the
+///     block is bad), FLASH_ERR_DEVICE_BUSY_TIMEOUT, or another error code on failure.
+/// @note Other tasks run while waiting. Every caller holds the LittleFS lock: LittleFS itself (see
+///     `LFS_block_device_lock`), and the raw `flash_*` telecommands (see
+///     `LFS_lock_for_raw_flash_access`). So, no other task can use the filesystem, the page cache,
+///     or state derived from files (the agenda index, the MPI science file) mid-operation.
+///     Log records are only queued meanwhile; the logger task writes them to file after.
+///     The SPI bus itself is idle while the chip is busy.
+static FLASH_error_enum_t FLASH_wait_until_ready_with_backoff(
+    uint8_t chip_number, const FLASH_busy_wait_timing_t *timing, uint8_t fail_status_mask,
+    FLASH_busy_time_stats_t *stats
+) {
+    const uint32_t start_cycle_count = FLASH_get_start_cycle_count();
+    uint32_t status_poll_count = 0;
+
+    while (1) {
+        const uint32_t elapsed_before_delay_us = FLASH_get_elapsed_us(start_cycle_count);
+        FLASH_busy_wait_delay_us(FLASH_busy_wait_next_poll_delay_us(timing, elapsed_before_delay_us));
+
+        uint8_t status_register;
+        const FLASH_error_enum_t result = FLASH_read_status_register(chip_number, &status_register);
+        status_poll_count++;
+        if (result != FLASH_ERR_OK) {
+            return result;
+        }
+
+        const uint32_t elapsed_us = FLASH_get_elapsed_us(start_cycle_count);
+        if (!(status_register & FLASH_OP_IN_PROGRESS_MASK)) {
+            if (stats != NULL) {
+                FLASH_busy_time_stats_record(stats, elapsed_us, status_poll_count);
+            }
+            if (status_register & fail_status_mask) {
+                return FLASH_ERR_STATUS_REG_ERROR;
+            }
+            return FLASH_ERR_OK;
+        }
+
+        if (elapsed_us >= timing->timeout_us) {
+            if (stats != NULL) {
+                FLASH_busy_time_stats_record_timeout(stats, status_poll_count);
+            }
+            return FLASH_ERR_DEVICE_BUSY_TIMEOUT;
+        }
+    }
+}
+
+
+
+/// @brief In cache read mode, move the loaded page to the cache, and start loading the next one.
+/// @param next_row_address Page to start loading. Past the end of the chip, cache read mode ends
+///     instead (with a Page Read Cache Last).
+/// @return FLASH_ERR_OK once the cache holds the previously loaded page.
+static FLASH_error_enum_t FLASH_cache_read_advance(uint8_t chip_number, uint32_t next_row_address) {
+    // The previous page must have finished loading into the data register.
+    FLASH_error_enum_t result = FLASH_wait_until_not_busy(
+        chip_number, FLASH_OP_IN_PROGRESS_MASK | FLASH_SR1_CACHE_READ_BUSY_MASK, 0
+    );
+    if (result != FLASH_ERR_OK) {
+        FLASH_cache_read_active[chip_number] = 0;
+        return result;
+    }
+
+    if (next_row_address < FLASH_CHIP_PAGES_PER_CHIP) {
+        const uint8_t cmd_buff[] = {
+            FLASH_CMD_PAGE_READ_CACHE_RANDOM,
+            ((next_row_address >> 16) & 0xFF), ((next_row_address >> 8) & 0xFF), (next_row_address & 0xFF)
+        };
+        const FLASH_SPI_Data_t cmd = {.data = cmd_buff, .len = sizeof(cmd_buff)};
+        result = FLASH_SPI_send_command(&cmd, chip_number);
+
+        FLASH_cache_read_active[chip_number] = (result == FLASH_ERR_OK);
+        FLASH_cache_read_loading_row[chip_number] = next_row_address;
+    }
+    else {
+        const uint8_t cmd_buff[] = {FLASH_CMD_PAGE_READ_CACHE_LAST};
+        const FLASH_SPI_Data_t cmd = {.data = cmd_buff, .len = sizeof(cmd_buff)};
+        result = FLASH_SPI_send_command(&cmd, chip_number);
+
+        FLASH_cache_read_active[chip_number] = 0;
+    }
+    if (result != FLASH_ERR_OK) {
+        return result;
+    }
+
+    // Wait for the cache only (tRCBSY). The next page keeps loading in the background.
+    return FLASH_wait_until_ready(chip_number, 0);
+}
+
+
+
+/// @brief Take the chip out of cache read mode (if it is in it), so that any command can be sent.
+/// @note The page loading in the background is discarded.
+static FLASH_error_enum_t FLASH_end_cache_read(uint8_t chip_number) {
+    if ((chip_number >= FLASH_NUMBER_OF_FLASH_DEVICES) || !FLASH_cache_read_active[chip_number]) {
+        return FLASH_ERR_OK;
+    }
+    FLASH_cache_read_active[chip_number] = 0;
+
+    FLASH_error_enum_t result = FLASH_wait_until_not_busy(
+        chip_number, FLASH_OP_IN_PROGRESS_MASK | FLASH_SR1_CACHE_READ_BUSY_MASK, 0
+    );
+    if (result != FLASH_ERR_OK) {
+        return result;
+    }
+
+    const uint8_t cmd_buff[] = {FLASH_CMD_PAGE_READ_CACHE_LAST};
+    const FLASH_SPI_Data_t cmd = {.data = cmd_buff, .len = sizeof(cmd_buff)};
+    result = FLASH_SPI_send_command(&cmd, chip_number);
+    if (result != FLASH_ERR_OK) {
+        return result;
+    }
+    return FLASH_wait_until_not_busy(
+        chip_number, FLASH_OP_IN_PROGRESS_MASK | FLASH_SR1_CACHE_READ_BUSY_MASK, 0
+    );
+}
+
+
+
 
 /// @brief Disable the block lock feature of the flash chip, which is enabled by default after a power cycle.
 static FLASH_error_enum_t FLASH_disable_block_lock(uint8_t chip_number) {
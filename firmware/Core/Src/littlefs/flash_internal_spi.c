@@ -1,20 +1,41 @@
 #include "main.h"
+#include "cmsis_os.h"
 #include "littlefs/flash_internal_spi.h"
 #include "timekeeping/timekeeping.h"
+#include "log/log.h"
 
 // Static functions are defined at the bottom of this file.
 static void _chip_select_low(uint8_t chip_number);
 static void _chip_select_high();
-static HAL_StatusTypeDef _SPI_fast_receive(SPI_HandleTypeDef *hspi, uint8_t *response, uint16_t response_size);
+static FLASH_error_enum_t _finish_previous_transfer(void);
 
 // The spi handle used by the flash driver.
 SPI_HandleTypeDef *hspi_flash_ptr = &hspi1;
 const uint16_t FLASH_SPI_TIMEOUT_MS = 25;
 
-// Used by SPI1 RxCpltCallback to indicate that the transfer is complete.
-volatile uint8_t SPI_DMA_receive_complete = 0;
+// The longest DMA transfer is a page plus its spare area (2176 bytes, ~2.2 ms at 8 MHz SCK).
+static const uint32_t FLASH_SPI_DMA_TIMEOUT_MS = 10;
+
+// State of the DMA transfer in progress. Set to complete/failed by the SPI1 callbacks, which also
+// release the chip select, so the chip can start its next operation before the task notices.
+static volatile FLASH_SPI_dma_state_enum_t FLASH_SPI_dma_state = FLASH_SPI_DMA_IDLE;
+static uint8_t FLASH_SPI_dma_is_receive = 0;
+static uint32_t FLASH_SPI_dma_start_time_ms = 0;
+
+// Thread flag set on the waiting task by the SPI1 callbacks. A high bit, clear of the tasks' own flags.
+#define FLASH_SPI_DMA_DONE_THREAD_FLAG 0x00010000U
+
+// Task waiting in `FLASH_SPI_wait_for_transfer` (NULL if none, or before the scheduler starts).
+static volatile osThreadId_t FLASH_SPI_dma_waiting_thread = NULL;
+
+/// @brief Number of DMA transfers which failed or timed out after their starter stopped waiting
+///     for them (found by `_finish_previous_transfer`), and the last one's error.
+uint32_t FLASH_SPI_abandoned_transfer_error_count = 0;
+FLASH_error_enum_t FLASH_SPI_last_abandoned_transfer_error = FLASH_ERR_OK;
 
 FLASH_error_enum_t FLASH_SPI_send_command(const FLASH_SPI_Data_t cmd[], uint8_t chip_number) {
+    _finish_previous_transfer();
+
     _chip_select_low(chip_number);
     const HAL_StatusTypeDef tx_result = HAL_SPI_Transmit(hspi_flash_ptr, cmd->data, cmd->len, FLASH_SPI_TIMEOUT_MS);
     _chip_select_high();
@@ -33,88 +54,175 @@ FLASH_error_enum_t FLASH_SPI_send_command(const FLASH_SPI_Data_t cmd[], uint8_t
 FLASH_error_enum_t FLASH_SPI_send_command_with_data(
     const FLASH_SPI_Data_t cmd[], FLASH_SPI_Data_t *data, uint8_t chip_number
 ) {
+    const FLASH_error_enum_t start_result = FLASH_SPI_start_command_with_data(cmd, data, chip_number);
+    if (start_result != FLASH_ERR_OK) {
+        return start_result;
+    }
+    return FLASH_SPI_wait_for_transfer();
+}
+
+
+
+
+
+FLASH_error_enum_t FLASH_SPI_send_command_receive_response(
+    const FLASH_SPI_Data_t cmd[], uint8_t *response, uint16_t response_size, uint8_t chip_number
+) {
+    const FLASH_error_enum_t start_result = FLASH_SPI_start_command_receive_response(
+        cmd, response, response_size, chip_number
+    );
+    if (start_result != FLASH_ERR_OK) {
+        return start_result;
+    }
+    return FLASH_SPI_wait_for_transfer();
+}
+
+
+
+
+
+/// @brief Send a command, then start sending `data` with DMA, and return without waiting.
+/// @note `data` must stay valid until `FLASH_SPI_wait_for_transfer()` returns.
+/// @return FLASH_ERR_OK if the transfer was started (or `data` is empty and nothing is pending).
+FLASH_error_enum_t FLASH_SPI_start_command_with_data(
+    const FLASH_SPI_Data_t cmd[], FLASH_SPI_Data_t *data, uint8_t chip_number
+) {
+    _finish_previous_transfer();
+
     _chip_select_low(chip_number);
-    HAL_StatusTypeDef tx_result = HAL_SPI_Transmit(hspi_flash_ptr, cmd->data, cmd->len, FLASH_SPI_TIMEOUT_MS);
-    if (tx_result == HAL_OK) {
-        tx_result = HAL_SPI_Transmit(hspi_flash_ptr, data->data, data->len, FLASH_SPI_TIMEOUT_MS);
+    const HAL_StatusTypeDef tx_result = HAL_SPI_Transmit(hspi_flash_ptr, cmd->data, cmd->len, FLASH_SPI_TIMEOUT_MS);
+    if ((tx_result != HAL_OK) || (data->len == 0)) {
+        _chip_select_high();
+        return (tx_result == HAL_OK) ? FLASH_ERR_OK : FLASH_ERR_SPI_TRANSMIT_FAILED;
     }
-    _chip_select_high();
 
-    if (tx_result == HAL_OK) {
-        return FLASH_ERR_OK;
-    } else {
+    // Set before starting, as the callback may run before `HAL_SPI_Transmit_DMA` returns.
+    FLASH_SPI_dma_is_receive = 0;
+    FLASH_SPI_dma_start_time_ms = TIME_uptime_ms();
+    FLASH_SPI_dma_state = FLASH_SPI_DMA_IN_PROGRESS;
+
+    if (HAL_SPI_Transmit_DMA(hspi_flash_ptr, data->data, data->len) != HAL_OK) {
+        FLASH_SPI_dma_state = FLASH_SPI_DMA_IDLE;
+        _chip_select_high();
         return FLASH_ERR_SPI_TRANSMIT_FAILED;
     }
+    return FLASH_ERR_OK;
 }
 
 
 
 
 
-FLASH_error_enum_t FLASH_SPI_send_command_receive_response(
+/// @brief Send a command, then start receiving the response into `response` with DMA, and return
+///     without waiting. At least 3x faster than HAL_SPI_Receive when transferring 2048 bytes, and
+///     the CPU is free to do other work until `FLASH_SPI_wait_for_transfer()`.
+/// @note `response` must stay valid (e.g., not a stack buffer of a returned function) until
+///     `FLASH_SPI_wait_for_transfer()` returns.
+FLASH_error_enum_t FLASH_SPI_start_command_receive_response(
     const FLASH_SPI_Data_t cmd[], uint8_t *response, uint16_t response_size, uint8_t chip_number
 ) {
-    HAL_StatusTypeDef  rx_result;
+    _finish_previous_transfer();
 
     _chip_select_low(chip_number);
-
     const HAL_StatusTypeDef tx_result = HAL_SPI_Transmit(hspi_flash_ptr, cmd->data, cmd->len, FLASH_SPI_TIMEOUT_MS);
-    if (tx_result == HAL_OK) {
-        rx_result = _SPI_fast_receive(hspi_flash_ptr, response, response_size);
+    if (tx_result != HAL_OK) {
+        _chip_select_high();
+        return FLASH_ERR_SPI_TRANSMIT_FAILED;
     }
 
-    _chip_select_high();
+    // Set before starting, as the callback may run before `HAL_SPI_Receive_DMA` returns.
+    FLASH_SPI_dma_is_receive = 1;
+    FLASH_SPI_dma_start_time_ms = TIME_uptime_ms();
+    FLASH_SPI_dma_state = FLASH_SPI_DMA_IN_PROGRESS;
 
-    if (tx_result != HAL_OK) {
-        return FLASH_ERR_SPI_TRANSMIT_FAILED;
-    } else if (rx_result != HAL_OK) {
+    if (HAL_SPI_Receive_DMA(hspi_flash_ptr, response, response_size) != HAL_OK) {
+        FLASH_SPI_dma_state = FLASH_SPI_DMA_IDLE;
+        _chip_select_high();
         return FLASH_ERR_SPI_RECEIVE_FAILED;
-    } else {
-        return FLASH_ERR_OK;
     }
+    return FLASH_ERR_OK;
 }
 
 
 
 
 
-void FLASH_SPI_enable_then_disable_chip_select(uint8_t chip_number) {
+/// @brief Wait for the transfer started by a `FLASH_SPI_start_*` function to complete.
+/// @return FLASH_ERR_OK if it completed (or none was started), otherwise a receive/transmit
+///     failed or timeout error. The transfer is aborted on timeout.
+/// @note Once the scheduler is running, the task blocks until the SPI1 callback notifies it, so
+///     other tasks run during the transfer. Before then, this is a busy-wait. No other task may
+///     start using SPI1 mid-transfer.
+FLASH_error_enum_t FLASH_SPI_wait_for_transfer(void) {
+    const uint8_t scheduler_is_running = (osKernelGetState() == osKernelRunning);
+    if (scheduler_is_running) {
+        FLASH_SPI_dma_waiting_thread = osThreadGetId();
+    }
+    while (FLASH_SPI_dma_state == FLASH_SPI_DMA_IN_PROGRESS) {
+        const uint32_t elapsed_ms = TIME_uptime_ms() - FLASH_SPI_dma_start_time_ms;
+        if (elapsed_ms >= FLASH_SPI_DMA_TIMEOUT_MS) {
+            FLASH_SPI_dma_waiting_thread = NULL;
+            HAL_SPI_Abort(hspi_flash_ptr);
+            _chip_select_high();
+            FLASH_SPI_dma_state = FLASH_SPI_DMA_IDLE;
+            return FLASH_SPI_dma_is_receive ? FLASH_ERR_SPI_RECEIVE_TIMEOUT : FLASH_ERR_SPI_TRANSMIT_TIMEOUT;
+        }
+        if (scheduler_is_running) {
+            // A flag left from an earlier transfer just makes this loop check the state again.
+            osThreadFlagsWait(FLASH_SPI_DMA_DONE_THREAD_FLAG, osFlagsWaitAny, FLASH_SPI_DMA_TIMEOUT_MS - elapsed_ms);
+        }
+    }
+    FLASH_SPI_dma_waiting_thread = NULL;
 
-    _chip_select_high();
+    const FLASH_SPI_dma_state_enum_t final_state = FLASH_SPI_dma_state;
+    FLASH_SPI_dma_state = FLASH_SPI_DMA_IDLE;
 
-    _chip_select_low(chip_number);
-    HAL_Delay(1000);
-    _chip_select_high();
+    if (final_state == FLASH_SPI_DMA_FAILED) {
+        return FLASH_SPI_dma_is_receive ? FLASH_ERR_SPI_RECEIVE_FAILED : FLASH_ERR_SPI_TRANSMIT_FAILED;
+    }
+    return FLASH_ERR_OK;
 }
 
-/// @brief Use DMA to speed up receiving. At least 3x faster than HAL_SPI_Receive when transferring 2048 bytes.
-static HAL_StatusTypeDef _SPI_fast_receive(SPI_HandleTypeDef *hspi, uint8_t *response, uint16_t response_size) {
-    const uint32_t start_time = TIME_uptime_ms();
-    uint32_t time_elapsed_ms = 0;
 
-    // Set the receive complete flag to false.
-    SPI_DMA_receive_complete = 0;
 
-    // Start the receiving with DMA.
-    const HAL_StatusTypeDef rx_result = HAL_SPI_Receive_DMA(hspi_flash_ptr, response, response_size);
 
 
-    // Be careful here, we are writing into stack memory with DMA. This function should not return until the transfer is complete.
-    // TODO: We could use a static buffer then memcpy to the response buffer, but that adds 1ms overhead. Probably not necessary.
-    // Wait for DMA transfer to complete.
-    while ((rx_result == HAL_OK) && !SPI_DMA_receive_complete && (time_elapsed_ms < 10)) {
-        time_elapsed_ms = TIME_uptime_ms() - start_time;
-    }
+/// @brief Get the state of the last started DMA transfer, without waiting.
+FLASH_SPI_dma_state_enum_t FLASH_SPI_get_transfer_state(void) {
+    return FLASH_SPI_dma_state;
+}
+
+
+
 
-    SPI_DMA_receive_complete = 0;
 
-    if (time_elapsed_ms >= 10) {
-        HAL_SPI_Abort(hspi);
-        return HAL_TIMEOUT;
-    } else if (rx_result != HAL_OK) {
-        return rx_result;
-    }  
-    return HAL_OK;
+void FLASH_SPI_enable_then_disable_chip_select(uint8_t chip_number) {
+
+    _chip_select_high();
+
+    _chip_select_low(chip_number);
+    HAL_Delay(1000);
+    _chip_select_high();
+}
+
+/// @brief Wait out a transfer whose starter did not wait for it, so the bus is free.
+/// @return The transfer's result. Its failure is latched in `FLASH_SPI_abandoned_transfer_error_count`
+///     and `FLASH_SPI_last_abandoned_transfer_error`, and logged, rather than failing the new
+///     command (which would, e.g., make LittleFS treat a good block as bad).
+static FLASH_error_enum_t _finish_previous_transfer(void) {
+    if (FLASH_SPI_dma_state == FLASH_SPI_DMA_IDLE) {
+        return FLASH_ERR_OK;
+    }
+    const FLASH_error_enum_t result = FLASH_SPI_wait_for_transfer();
+    if (result != FLASH_ERR_OK) {
+        FLASH_SPI_abandoned_transfer_error_count++;
+        FLASH_SPI_last_abandoned_transfer_error = result;
+        LOG_message(
+            LOG_SYSTEM_FLASH, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE),
+            "Flash SPI DMA transfer failed after its starter stopped waiting: %d", result
+        );
+    }
+    return result;
 }
 
 
@@ -154,9 +262,35 @@ static inline void _chip_select_high() {
     HAL_GPIO_WritePin(PIN_MEM_NCS_FRAM_1_GPIO_Port, PIN_MEM_NCS_FRAM_1_Pin, GPIO_PIN_SET);
 }
 
-// Callback is used when using DMA to receive data.
+/// @brief Wake the task waiting in `FLASH_SPI_wait_for_transfer`, if any. Called from the SPI1 ISRs.
+static void _notify_waiting_thread(void) {
+    const osThreadId_t waiting_thread = FLASH_SPI_dma_waiting_thread;
+    if (waiting_thread != NULL) {
+        osThreadFlagsSet(waiting_thread, FLASH_SPI_DMA_DONE_THREAD_FLAG);
+    }
+}
+
+// Callbacks are used when transferring data with DMA.
 void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi) {
     if (hspi == hspi_flash_ptr) {
-        SPI_DMA_receive_complete = 1;
+        _chip_select_high();
+        FLASH_SPI_dma_state = FLASH_SPI_DMA_COMPLETE;
+        _notify_waiting_thread();
     }
-}
\ No newline at end of file
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+    if (hspi == hspi_flash_ptr) {
+        _chip_select_high();
+        FLASH_SPI_dma_state = FLASH_SPI_DMA_COMPLETE;
+        _notify_waiting_thread();
+    }
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
+    if (hspi == hspi_flash_ptr) {
+        _chip_select_high();
+        FLASH_SPI_dma_state = FLASH_SPI_DMA_FAILED;
+        _notify_waiting_thread();
+    }
+}
@@ -1,36 +1,163 @@
+// littlefs_checksums.c
+// SHA256 checksums of LittleFS files, with each file's whole-file digest cached in a custom
+// attribute on the file, so that re-verifying an unchanged file doesn't read it.
+//
+// LittleFS has no per-file modification counter, so the attribute keeps its own: a generation,
+// bumped by the write helpers in `littlefs_helper.c` (`LFS_checksum_bump_generation`). Many modules
+// also write files directly with `lfs_file_write`, so the digest is also keyed on the file's size
+// and a CRC of its last chunk (appends and most rewrites change one or the other), and on the head
+// block of its data (CTZ list), which moves on every committed write unless the block allocator
+// has wrapped around to the same block. Small inline files (stored in their directory's metadata,
+// without a head block) are cheap to hash, and aren't cached.
+
 #include "littlefs/littlefs_checksums.h"
 
 #include "littlefs/lfs.h"
 #include "littlefs/littlefs_helper.h"
+#include "littlefs/littlefs_driver.h"
+#include "littlefs/lfs_util.h"
 #include "crypto/sha256.h"
 #include "log/log.h"
 #include "debug_tools/debug_uart.h"
 #include "timekeeping/timekeeping.h"
 
+#include <string.h>
+
+/// @brief Files are hashed in chunks of this size. The last chunk (the "tail") is also CRC'd.
+#define LFS_CHECKSUM_CHUNK_SIZE_BYTES 2048
+
+/// @brief Use and store the digest attribute for whole-file checksums. 0 always reads the file
+///     (and leaves any existing attributes alone).
+uint32_t LFS_checksum_digest_cache_enabled = 1;
+
+LFS_checksum_stats_t LFS_checksum_stats;
+
+/// @brief Get the offset of the last chunk of a file, which the tail CRC covers.
+static inline uint32_t LFS_checksum_get_tail_offset(uint32_t file_size) {
+    if (file_size == 0) {
+        return 0;
+    }
+    return ((file_size - 1) / LFS_CHECKSUM_CHUNK_SIZE_BYTES) * LFS_CHECKSUM_CHUNK_SIZE_BYTES;
+}
+
+/// @brief Compute the CRC of an open file's last chunk.
+/// @param buffer Scratch buffer of `LFS_CHECKSUM_CHUNK_SIZE_BYTES`.
+/// @return 0 on success, or a negative LFS error code.
+static int32_t LFS_checksum_read_tail_crc(
+    lfs_file_t *file, uint32_t file_size, uint8_t buffer[], uint32_t *crc_out
+) {
+    const lfs_soff_t seek_result = lfs_file_seek(
+        &LFS_filesystem, file, LFS_checksum_get_tail_offset(file_size), LFS_SEEK_SET
+    );
+    if (seek_result < 0) {
+        return seek_result;
+    }
+    const lfs_ssize_t read_result = lfs_file_read(&LFS_filesystem, file, buffer, LFS_CHECKSUM_CHUNK_SIZE_BYTES);
+    if (read_result < 0) {
+        return read_result;
+    }
+    *crc_out = lfs_crc(0xFFFFFFFF, buffer, (size_t)read_result);
+    return 0;
+}
+
+/// @brief Invalidate a file's cached digest, if it has one, by bumping its generation.
+/// @param filepath Path of the file which is about to be written to.
+/// @return 0 on success (including when the file has no digest attribute), or a negative LFS error code.
+/// @note Called by the write helpers in `littlefs_helper.c` once the file is open. Modules which
+///     write with `lfs_file_write` directly rely on the size, tail CRC, and head block checks instead.
+int8_t LFS_checksum_bump_generation(const char filepath[]) {
+    LFS_checksum_digest_attr_t digest_attr;
+
+    // Held across the get and set, so that a checksum can't store its digest in between.
+    LFS_lock_for_raw_flash_access();
+    const lfs_ssize_t getattr_result = lfs_getattr(
+        &LFS_filesystem, filepath, LFS_CHECKSUM_DIGEST_ATTR_TYPE, &digest_attr, sizeof(digest_attr)
+    );
+    int8_t result = 0;
+    if (getattr_result == (lfs_ssize_t)sizeof(digest_attr)) {
+        digest_attr.generation++;
+        result = lfs_setattr(
+            &LFS_filesystem, filepath, LFS_CHECKSUM_DIGEST_ATTR_TYPE, &digest_attr, sizeof(digest_attr)
+        );
+    }
+    else if (getattr_result >= 0) {
+        // Older format: remove it, so that it can't be mistaken for a current one.
+        result = lfs_removeattr(&LFS_filesystem, filepath, LFS_CHECKSUM_DIGEST_ATTR_TYPE);
+    }
+    else if (getattr_result != LFS_ERR_NOATTR) {
+        result = getattr_result;
+    }
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
+
+void LFS_checksum_reset_stats(void) {
+    memset(&LFS_checksum_stats, 0, sizeof(LFS_checksum_stats));
+}
+
 /// @brief Computes the SHA256 checksum of a file in LittleFS.
 /// @param filepath Path to the file to read and compute the checksum for.
 /// @param start_offset The offset in the file from which to start reading.
 /// @param max_length The maximum number of bytes to read from the file. 0 means read the entire file.
 /// @param sha256_dest 32-byte array to be filled with checksum.
 /// @return 0 on success. Negative LFS error codes on error.
+/// @note Whole-file checksums (offset 0, and a length of 0 or at least the file size) are served
+///     from the file's digest attribute when it's still valid, and stored in it otherwise.
 int8_t LFS_read_file_checksum_sha256(
     const char filepath[], uint32_t start_offset, uint32_t max_length,
     uint8_t sha256_dest[32]
 ) {
-    const uint16_t chunk_size = 2048; // 2 KiB chunks
+    const uint16_t chunk_size = LFS_CHECKSUM_CHUNK_SIZE_BYTES;
     uint8_t read_buffer[chunk_size];
     
     SHA256_CTX sha256_ctx;
     sha256_init(&sha256_ctx);
 
+    // The digest attribute is read along with the file's metadata, when opening it.
+    LFS_checksum_digest_attr_t digest_attr = {0};
+    struct lfs_attr file_attrs[] = {
+        {.type = LFS_CHECKSUM_DIGEST_ATTR_TYPE, .buffer = &digest_attr, .size = sizeof(digest_attr)},
+    };
+    const struct lfs_file_config file_cfg = {
+        .attrs = file_attrs,
+        .attr_count = (LFS_checksum_digest_cache_enabled != 0) ? 1 : 0,
+    };
+
     lfs_file_t file;
-    const int8_t open_result = lfs_file_open(
-        &LFS_filesystem, &file, filepath, LFS_O_RDONLY
+    const int8_t open_result = lfs_file_opencfg(
+        &LFS_filesystem, &file, filepath, LFS_O_RDONLY, &file_cfg
     );
     if (open_result < 0) {
         return open_result;
     }
 
+    const lfs_soff_t file_size = lfs_file_size(&LFS_filesystem, &file);
+    const uint8_t is_whole_file = (start_offset == 0)
+        && ((max_length == 0) || (file_size < 0) || (max_length >= (uint32_t)file_size));
+    const uint8_t is_cacheable = (LFS_checksum_digest_cache_enabled != 0)
+        && is_whole_file && (file_size >= 0) && ((file.flags & LFS_F_INLINE) == 0);
+    const uint32_t ctz_head_block = file.ctz.head;
+    const uint8_t has_current_attr = (digest_attr.format_version == LFS_CHECKSUM_DIGEST_ATTR_FORMAT_VERSION);
+    const uint32_t generation = has_current_attr ? digest_attr.generation : 0;
+
+    if (
+        is_cacheable
+        && has_current_attr
+        && (digest_attr.digest_generation == generation)
+        && (digest_attr.file_size == (uint32_t)file_size)
+        && (digest_attr.ctz_head_block == ctz_head_block)
+    ) {
+        uint32_t tail_crc;
+        const int32_t tail_result = LFS_checksum_read_tail_crc(&file, (uint32_t)file_size, read_buffer, &tail_crc);
+        if ((tail_result == 0) && (tail_crc == digest_attr.tail_crc)) {
+            lfs_file_close(&LFS_filesystem, &file);
+            memcpy(sha256_dest, digest_attr.sha256, 32);
+            LFS_checksum_stats.digest_cache_hit_count++;
+            return 0;
+        }
+        // Otherwise, fall through and read the whole file.
+    }
+
     // Seek to the start offset
     const lfs_soff_t seek_result = lfs_file_seek(&LFS_filesystem, &file, start_offset, LFS_SEEK_SET);
     if (seek_result < 0) {
@@ -44,6 +171,9 @@ int8_t LFS_read_file_checksum_sha256(
     // Read in chunks and hash.
     int32_t total_calc_time_ms = 0;
     int32_t total_read_time_ms = 0;
+    uint32_t tail_crc = 0xFFFFFFFF;
+    const uint32_t tail_offset = LFS_checksum_get_tail_offset((file_size > 0) ? (uint32_t)file_size : 0);
+    uint32_t chunk_offset = start_offset;
     while (read_bytes_remaining > 0) {
         // Determine how many bytes to read in this chunk.
         const uint32_t bytes_to_read = (read_bytes_remaining < chunk_size) ? read_bytes_remaining : chunk_size;
@@ -67,6 +197,13 @@ int8_t LFS_read_file_checksum_sha256(
         const int32_t sha256_start_time = TIME_uptime_ms();
         sha256_update(&sha256_ctx, read_buffer, bytes_read);
         total_calc_time_ms += TIME_uptime_ms() - sha256_start_time;
+        LFS_checksum_stats.bytes_hashed += bytes_read;
+
+        // Whole-file reads start at 0, so the chunks line up with the tail.
+        if (is_cacheable && (chunk_offset == tail_offset)) {
+            tail_crc = lfs_crc(0xFFFFFFFF, read_buffer, bytes_read);
+        }
+        chunk_offset += bytes_read;
 
         // Decrease the remaining bytes to read.
         read_bytes_remaining -= bytes_read;
@@ -83,6 +220,45 @@ int8_t LFS_read_file_checksum_sha256(
     sha256_final(&sha256_ctx, sha256_dest);
     total_calc_time_ms += TIME_uptime_ms() - sha256_final_start_time;
 
+    if (is_cacheable) {
+        LFS_checksum_stats.digest_cache_miss_count++;
+
+        // Failing to store the digest only means the next check reads the file again.
+        // Skip storing it if a write helper bumped the generation while the file was being read.
+        LFS_lock_for_raw_flash_access();
+        LFS_checksum_digest_attr_t latest_attr = {0};
+        const lfs_ssize_t getattr_result = lfs_getattr(
+            &LFS_filesystem, filepath, LFS_CHECKSUM_DIGEST_ATTR_TYPE, &latest_attr, sizeof(latest_attr)
+        );
+        const uint32_t latest_generation = (
+            (getattr_result == (lfs_ssize_t)sizeof(latest_attr))
+            && (latest_attr.format_version == LFS_CHECKSUM_DIGEST_ATTR_FORMAT_VERSION)
+        ) ? latest_attr.generation : 0;
+        int setattr_result = 0;
+        if (latest_generation == generation) {
+            digest_attr = (LFS_checksum_digest_attr_t){
+                .format_version = LFS_CHECKSUM_DIGEST_ATTR_FORMAT_VERSION,
+                .generation = generation,
+                .digest_generation = generation,
+                .file_size = (uint32_t)file_size,
+                .ctz_head_block = ctz_head_block,
+                .tail_crc = tail_crc,
+            };
+            memcpy(digest_attr.sha256, sha256_dest, 32);
+            setattr_result = lfs_setattr(
+                &LFS_filesystem, filepath, LFS_CHECKSUM_DIGEST_ATTR_TYPE, &digest_attr, sizeof(digest_attr)
+            );
+        }
+        LFS_unlock_for_raw_flash_access();
+        if (setattr_result < 0) {
+            LOG_message(
+                LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE),
+                "LFS_read_file_checksum_sha256: storing digest attribute failed: %d",
+                setattr_result
+            );
+        }
+    }
+
     // Log the time taken for reading and calculating the checksum.
     LOG_message(
         LOG_SYSTEM_LFS, LOG_SEVERITY_DEBUG, LOG_all_sinks_except(LOG_SINK_FILE),
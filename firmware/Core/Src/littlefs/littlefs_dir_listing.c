@@ -0,0 +1,377 @@
+// littlefs_dir_listing.c
+// Directory listing with a resumable cursor, and an in-RAM index of directory entries.
+//
+// LittleFS can only list a directory from its start, so listing a page at an offset reads (and
+// discards) every earlier entry from flash; paging through a directory of N entries costs O(N^2)
+// metadata reads. Instead:
+// - The cursor keeps the directory open between pages. A seek to the position where the last
+//   page stopped continues from there.
+// - A complete pass over a directory from its first entry fills an index of its entries (name,
+//   size, type). Later listings of that directory are served from RAM.
+//
+// An index is only used while nothing has been written to flash since it was built (checked with
+// `LFS_block_device_write_count`), so files written directly with `lfs_file_*` (e.g., log files)
+// can't make it stale. The cursor is an open LittleFS directory, which LittleFS keeps consistent
+// across writes; it's closed when the LittleFS helpers (`littlefs_helper.c`) create or remove
+// something in the directory, and on mount/unmount/format.
+
+#include "littlefs/littlefs_dir_listing.h"
+#include "littlefs/littlefs_helper.h"
+#include "littlefs/littlefs_driver.h"
+#include "littlefs/lfs.h"
+#include "main.h"
+
+#include <string.h>
+
+/// @brief Index entries older than this are rebuilt from flash, even if nothing was written since
+///     they were built. 0 disables the index.
+uint32_t LFS_dir_listing_index_max_age_ms = 60000;
+
+LFS_dir_listing_stats_t LFS_dir_listing_stats;
+
+typedef struct {
+    uint32_t size;
+    uint16_t name_offset; // In `name_pool`.
+    uint8_t type;
+} LFS_dir_listing_index_entry_t;
+
+typedef struct {
+    uint8_t is_valid;
+    char path[LFS_MAX_PATH_LENGTH]; // Normalized (see `LFS_dir_listing_normalize_path`).
+    uint32_t built_at_ms;
+    uint32_t last_used_ms;
+
+    /// @brief `LFS_block_device_write_count` when the pass which built the index started.
+    uint32_t write_count_at_build;
+    uint16_t entry_count;
+    uint16_t name_pool_used;
+    LFS_dir_listing_index_entry_t entries[LFS_DIR_LISTING_INDEX_MAX_ENTRIES];
+    char name_pool[LFS_DIR_LISTING_INDEX_NAME_POOL_BYTES];
+} LFS_dir_listing_index_slot_t;
+
+typedef enum {
+    LFS_DIR_LISTING_SOURCE_NONE,
+    LFS_DIR_LISTING_SOURCE_INDEX,
+    LFS_DIR_LISTING_SOURCE_DIR,
+} LFS_dir_listing_source_enum_t;
+
+static LFS_dir_listing_index_slot_t LFS_dir_listing_index_slots[LFS_DIR_LISTING_INDEX_SLOT_COUNT];
+
+static struct {
+    LFS_dir_listing_source_enum_t source;
+    char path[LFS_MAX_PATH_LENGTH]; // Normalized.
+
+    /// @brief Number of entries returned since the start of the directory (the next entry's position).
+    uint32_t position;
+
+    /// @brief Index slot being read (`LFS_DIR_LISTING_SOURCE_INDEX`).
+    uint8_t index_slot;
+
+    /// @brief Open directory, and the last entry read from it (`LFS_DIR_LISTING_SOURCE_DIR`).
+    lfs_dir_t dir;
+    struct lfs_info info;
+    uint8_t has_info;
+    uint8_t replay_info;
+
+    /// @brief Index slot filled while reading the directory from its first entry, or -1.
+    int8_t build_slot;
+} LFS_dir_listing_cursor = {.source = LFS_DIR_LISTING_SOURCE_NONE, .build_slot = -1};
+
+/// @brief Normalize a directory path, so that "/logs/", "./logs" and "logs" are the same
+///     directory ("logs"). The root directory is "".
+static void LFS_dir_listing_normalize_path(const char path[], char normalized_out[LFS_MAX_PATH_LENGTH]) {
+    while ((path[0] == '/') || ((path[0] == '.') && ((path[1] == '/') || (path[1] == '\0')))) {
+        path++;
+    }
+    strncpy(normalized_out, path, LFS_MAX_PATH_LENGTH - 1);
+    normalized_out[LFS_MAX_PATH_LENGTH - 1] = '\0';
+
+    size_t len = strlen(normalized_out);
+    while ((len > 0) && (normalized_out[len - 1] == '/')) {
+        normalized_out[--len] = '\0';
+    }
+}
+
+/// @brief Check whether `path` is `ancestor_path` or inside it (both normalized).
+static uint8_t LFS_dir_listing_is_within(const char path[], const char ancestor_path[]) {
+    const size_t ancestor_len = strlen(ancestor_path);
+    if (ancestor_len == 0) {
+        return 1;
+    }
+    return (strncmp(path, ancestor_path, ancestor_len) == 0)
+        && ((path[ancestor_len] == '\0') || (path[ancestor_len] == '/'));
+}
+
+/// @brief Close the cursor (and drop a partially-built index).
+static void LFS_dir_listing_close_cursor(void) {
+    if (LFS_dir_listing_cursor.source == LFS_DIR_LISTING_SOURCE_DIR) {
+        if (LFS_is_lfs_mounted) {
+            lfs_dir_close(&LFS_filesystem, &LFS_dir_listing_cursor.dir);
+        }
+    }
+    LFS_dir_listing_cursor.source = LFS_DIR_LISTING_SOURCE_NONE;
+    LFS_dir_listing_cursor.has_info = 0;
+    LFS_dir_listing_cursor.replay_info = 0;
+    LFS_dir_listing_cursor.build_slot = -1;
+}
+
+/// @brief Find the valid index of a directory, dropping it if it's too old.
+/// @return Slot number, or -1 if the directory isn't indexed.
+static int8_t LFS_dir_listing_find_index_slot(const char normalized_path[], uint32_t now_ms) {
+    for (uint8_t i = 0; i < LFS_DIR_LISTING_INDEX_SLOT_COUNT; i++) {
+        LFS_dir_listing_index_slot_t *slot = &LFS_dir_listing_index_slots[i];
+        if (!slot->is_valid || (strcmp(slot->path, normalized_path) != 0)) {
+            continue;
+        }
+        if (
+            ((now_ms - slot->built_at_ms) >= LFS_dir_listing_index_max_age_ms)
+            || (slot->write_count_at_build != LFS_block_device_write_count)
+        ) {
+            slot->is_valid = 0;
+            LFS_dir_listing_stats.index_stale_count++;
+            return -1;
+        }
+        return (int8_t)i;
+    }
+    return -1;
+}
+
+/// @brief Choose the slot to fill with a new index: an unused one, else the least recently used.
+static uint8_t LFS_dir_listing_choose_build_slot(void) {
+    uint8_t chosen_slot = 0;
+    for (uint8_t i = 0; i < LFS_DIR_LISTING_INDEX_SLOT_COUNT; i++) {
+        const LFS_dir_listing_index_slot_t *slot = &LFS_dir_listing_index_slots[i];
+        if (!slot->is_valid) {
+            return i;
+        }
+        if (slot->last_used_ms < LFS_dir_listing_index_slots[chosen_slot].last_used_ms) {
+            chosen_slot = i;
+        }
+    }
+    return chosen_slot;
+}
+
+/// @brief Add the cursor's current entry to the index being built. Stops building if it's full.
+static void LFS_dir_listing_add_to_build_slot(void) {
+    LFS_dir_listing_index_slot_t *slot = &LFS_dir_listing_index_slots[LFS_dir_listing_cursor.build_slot];
+    const struct lfs_info *info = &LFS_dir_listing_cursor.info;
+    const size_t name_size = strlen(info->name) + 1;
+    if (
+        (slot->entry_count >= LFS_DIR_LISTING_INDEX_MAX_ENTRIES)
+        || ((slot->name_pool_used + name_size) > LFS_DIR_LISTING_INDEX_NAME_POOL_BYTES)
+    ) {
+        LFS_dir_listing_cursor.build_slot = -1;
+        return;
+    }
+
+    memcpy(&slot->name_pool[slot->name_pool_used], info->name, name_size);
+    slot->entries[slot->entry_count] = (LFS_dir_listing_index_entry_t){
+        .size = info->size,
+        .name_offset = slot->name_pool_used,
+        .type = info->type,
+    };
+    slot->entry_count++;
+    slot->name_pool_used += name_size;
+}
+
+/// @brief Position the listing cursor at an entry of a directory, for `LFS_dir_listing_read`.
+/// @param directory_path Directory to list.
+/// @param position Number of entries to skip from the start of the directory (including "." and "..").
+/// @return 0 on success, 1 if LFS is unmounted, negative LFS error codes on failure.
+/// @note Served from the index if the directory is indexed, continued without re-reading if
+///     `position` is where the last listing of the directory stopped, else the directory is
+///     re-read from its start.
+int32_t LFS_dir_listing_seek(const char directory_path[], uint32_t position) {
+    if (!LFS_is_lfs_mounted) {
+        return 1;
+    }
+
+    char normalized_path[LFS_MAX_PATH_LENGTH];
+    LFS_dir_listing_normalize_path(directory_path, normalized_path);
+    const uint32_t now_ms = HAL_GetTick();
+
+    const int8_t index_slot = LFS_dir_listing_find_index_slot(normalized_path, now_ms);
+    if (index_slot >= 0) {
+        LFS_dir_listing_close_cursor();
+        LFS_dir_listing_index_slots[index_slot].last_used_ms = now_ms;
+        LFS_dir_listing_cursor.source = LFS_DIR_LISTING_SOURCE_INDEX;
+        LFS_dir_listing_cursor.index_slot = (uint8_t)index_slot;
+        strcpy(LFS_dir_listing_cursor.path, normalized_path);
+        LFS_dir_listing_cursor.position = position;
+        LFS_dir_listing_stats.index_hit_count++;
+        return 0;
+    }
+
+    if (
+        (LFS_dir_listing_cursor.source == LFS_DIR_LISTING_SOURCE_DIR)
+        && (strcmp(LFS_dir_listing_cursor.path, normalized_path) == 0)
+    ) {
+        if (position == LFS_dir_listing_cursor.position) {
+            LFS_dir_listing_stats.resume_count++;
+            return 0;
+        }
+        if (LFS_dir_listing_cursor.has_info && !LFS_dir_listing_cursor.replay_info && ((position + 1) == LFS_dir_listing_cursor.position)) {
+            // The last entry read wasn't used (e.g., it didn't fit in the response).
+            LFS_dir_listing_cursor.replay_info = 1;
+            LFS_dir_listing_cursor.position--;
+            LFS_dir_listing_stats.resume_count++;
+            return 0;
+        }
+    }
+
+    LFS_dir_listing_close_cursor();
+    const int32_t open_result = lfs_dir_open(
+        &LFS_filesystem, &LFS_dir_listing_cursor.dir, (normalized_path[0] == '\0') ? "/" : normalized_path
+    );
+    if (open_result < 0) {
+        return open_result;
+    }
+    LFS_dir_listing_cursor.source = LFS_DIR_LISTING_SOURCE_DIR;
+    strcpy(LFS_dir_listing_cursor.path, normalized_path);
+    LFS_dir_listing_cursor.position = 0;
+    LFS_dir_listing_stats.reopen_count++;
+
+    if ((position == 0) && (LFS_dir_listing_index_max_age_ms > 0)) {
+        const uint8_t build_slot = LFS_dir_listing_choose_build_slot();
+        LFS_dir_listing_index_slot_t *slot = &LFS_dir_listing_index_slots[build_slot];
+        slot->is_valid = 0;
+        strcpy(slot->path, normalized_path);
+        slot->entry_count = 0;
+        slot->name_pool_used = 0;
+        slot->write_count_at_build = LFS_block_device_write_count;
+        LFS_dir_listing_cursor.build_slot = (int8_t)build_slot;
+    }
+
+    while (LFS_dir_listing_cursor.position < position) {
+        const int32_t read_result = lfs_dir_read(&LFS_filesystem, &LFS_dir_listing_cursor.dir, &LFS_dir_listing_cursor.info);
+        if (read_result < 0) {
+            LFS_dir_listing_close_cursor();
+            return read_result;
+        }
+        if (read_result == 0) {
+            // Past the end; reads return 0.
+            break;
+        }
+        LFS_dir_listing_cursor.position++;
+        LFS_dir_listing_stats.flash_entry_read_count++;
+        LFS_dir_listing_stats.skipped_entry_count++;
+    }
+    return 0;
+}
+
+/// @brief Read the entry at the cursor, and advance the cursor.
+/// @return 1 if an entry was read, 0 at the end of the directory, negative LFS error codes on failure.
+int32_t LFS_dir_listing_read(LFS_dir_listing_entry_t *entry_out) {
+    if (LFS_dir_listing_cursor.source == LFS_DIR_LISTING_SOURCE_INDEX) {
+        const LFS_dir_listing_index_slot_t *slot = &LFS_dir_listing_index_slots[LFS_dir_listing_cursor.index_slot];
+        if (!slot->is_valid || (slot->write_count_at_build != LFS_block_device_write_count)) {
+            // Written to since the seek. Continue from flash at the same position.
+            char directory_path[LFS_MAX_PATH_LENGTH];
+            strcpy(directory_path, LFS_dir_listing_cursor.path);
+            const int32_t seek_result = LFS_dir_listing_seek(directory_path, LFS_dir_listing_cursor.position);
+            if (seek_result != 0) {
+                return (seek_result < 0) ? seek_result : LFS_ERR_BADF;
+            }
+            return LFS_dir_listing_read(entry_out);
+        }
+        if (LFS_dir_listing_cursor.position >= slot->entry_count) {
+            return 0;
+        }
+        const LFS_dir_listing_index_entry_t *entry = &slot->entries[LFS_dir_listing_cursor.position];
+        entry_out->name = &slot->name_pool[entry->name_offset];
+        entry_out->size = entry->size;
+        entry_out->type = entry->type;
+        LFS_dir_listing_cursor.position++;
+        return 1;
+    }
+
+    if (LFS_dir_listing_cursor.source != LFS_DIR_LISTING_SOURCE_DIR) {
+        return LFS_ERR_BADF;
+    }
+
+    if (LFS_dir_listing_cursor.replay_info) {
+        LFS_dir_listing_cursor.replay_info = 0;
+    }
+    else {
+        const int32_t read_result = lfs_dir_read(&LFS_filesystem, &LFS_dir_listing_cursor.dir, &LFS_dir_listing_cursor.info);
+        if (read_result < 0) {
+            LFS_dir_listing_close_cursor();
+            return read_result;
+        }
+        LFS_dir_listing_stats.flash_entry_read_count += (read_result > 0) ? 1 : 0;
+        if (read_result == 0) {
+            LFS_dir_listing_cursor.has_info = 0;
+            if (LFS_dir_listing_cursor.build_slot >= 0) {
+                LFS_dir_listing_index_slot_t *slot = &LFS_dir_listing_index_slots[LFS_dir_listing_cursor.build_slot];
+                // If anything was written during the pass, the index is stale already.
+                slot->is_valid = (slot->write_count_at_build == LFS_block_device_write_count);
+                slot->built_at_ms = HAL_GetTick();
+                slot->last_used_ms = slot->built_at_ms;
+                LFS_dir_listing_cursor.build_slot = -1;
+                LFS_dir_listing_stats.index_build_count += slot->is_valid;
+            }
+            return 0;
+        }
+        LFS_dir_listing_cursor.has_info = 1;
+        if (LFS_dir_listing_cursor.build_slot >= 0) {
+            LFS_dir_listing_add_to_build_slot();
+        }
+    }
+
+    entry_out->name = LFS_dir_listing_cursor.info.name;
+    entry_out->size = LFS_dir_listing_cursor.info.size;
+    entry_out->type = LFS_dir_listing_cursor.info.type;
+    LFS_dir_listing_cursor.position++;
+    return 1;
+}
+
+/// @brief Get the cursor's position (the number of entries before the next entry to be read).
+uint32_t LFS_dir_listing_get_position(void) {
+    return LFS_dir_listing_cursor.position;
+}
+
+/// @brief Drop the index and cursor of the directory containing `path`, and of `path` and
+///     everything inside it. Call after creating, writing, or removing `path`.
+void LFS_dir_listing_invalidate_path(const char path[]) {
+    char normalized_path[LFS_MAX_PATH_LENGTH];
+    LFS_dir_listing_normalize_path(path, normalized_path);
+
+    char parent_path[LFS_MAX_PATH_LENGTH];
+    strcpy(parent_path, normalized_path);
+    char *last_slash = strrchr(parent_path, '/');
+    if (last_slash != NULL) {
+        *last_slash = '\0';
+    }
+    else {
+        parent_path[0] = '\0';
+    }
+
+    for (uint8_t i = 0; i < LFS_DIR_LISTING_INDEX_SLOT_COUNT; i++) {
+        LFS_dir_listing_index_slot_t *slot = &LFS_dir_listing_index_slots[i];
+        if ((strcmp(slot->path, parent_path) == 0) || LFS_dir_listing_is_within(slot->path, normalized_path)) {
+            slot->is_valid = 0;
+        }
+    }
+    if (
+        (LFS_dir_listing_cursor.source != LFS_DIR_LISTING_SOURCE_NONE)
+        && (
+            (strcmp(LFS_dir_listing_cursor.path, parent_path) == 0)
+            || LFS_dir_listing_is_within(LFS_dir_listing_cursor.path, normalized_path)
+        )
+    ) {
+        LFS_dir_listing_close_cursor();
+    }
+}
+
+/// @brief Close the cursor and drop all indexes. Call before unmounting, and after mounting or
+///     formatting.
+void LFS_dir_listing_reset(void) {
+    LFS_dir_listing_close_cursor();
+    for (uint8_t i = 0; i < LFS_DIR_LISTING_INDEX_SLOT_COUNT; i++) {
+        LFS_dir_listing_index_slots[i].is_valid = 0;
+    }
+}
+
+void LFS_dir_listing_reset_stats(void) {
+    memset(&LFS_dir_listing_stats, 0, sizeof(LFS_dir_listing_stats));
+}
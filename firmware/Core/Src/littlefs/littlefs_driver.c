@@ -1,36 +1,236 @@
 #include "littlefs/flash_driver.h"
 #include "littlefs/littlefs_driver.h"
+#include "littlefs/littlefs_page_cache.h"
+#include "log/log.h"
 #include "main.h"
 
+#ifdef LFS_THREADSAFE
+#include "rtos_tasks/rtos_task_helpers.h"
+#endif
+
+#include <string.h>
+
 SPI_HandleTypeDef *hspi_lfs_ptr = &hspi1;
 
+// Selects the block-to-chip mapping. Must match the layout the filesystem was formatted with, so
+// it's only changed through `LFS_block_device_set_layout()` (by `LFS_format` and `LFS_mount`).
+LFS_chip_layout_enum_t LFS_chip_layout = LFS_CHIP_LAYOUT_CONCATENATE;
+
+LFS_chip_stats_t LFS_chip_stats[LFS_NUMBER_OF_FLASH_CHIPS];
+
+/// @brief Number of program and erase calls since boot. Any change to the filesystem (including
+///     a file written directly with `lfs_file_*`) increments it, so RAM state derived from the
+///     filesystem is stale once this changes (see `littlefs_dir_listing.c`).
+uint32_t LFS_block_device_write_count = 0;
+
+// One bit per block (1 = bad). Indexed by the LittleFS block number.
+static uint8_t LFS_bad_block_bitmap[LFS_TOTAL_BLOCK_COUNT / 8];
+
+// Byte in the spare area of the first page of each block which holds the factory bad block marker.
+// Any value other than 0xFF means the block is bad. See the datasheet section "Error Management".
+// Blocks which go bad at runtime get the same marker, so that they are found by the next scan.
+#define LFS_FACTORY_BAD_BLOCK_MARKER_COL_ADDRESS FLASH_CHIP_PAGE_SIZE_BYTES
+#define LFS_RUNTIME_BAD_BLOCK_MARKER_VALUE 0x00
+
 // -----------------------------LITTLEFS CONFIG FUNCTIONS-----------------------------
 
+/// @brief In the stripe layout, swap block 1 with the first block of chip 0 after block 0, so that
+///     the superblock pair (blocks 0 and 1) is at the same place in both layouts.
+static inline lfs_block_t LFS_get_stripe_position(lfs_block_t block_num) {
+	if (block_num == 1) {
+		return LFS_NUMBER_OF_FLASH_CHIPS;
+	}
+	if (block_num == LFS_NUMBER_OF_FLASH_CHIPS) {
+		return 1;
+	}
+	return block_num;
+}
+
+static inline uint8_t LFS_get_chip_number(lfs_block_t block_num) {
+	if (LFS_chip_layout == LFS_CHIP_LAYOUT_STRIPE) {
+		return LFS_get_stripe_position(block_num) % LFS_NUMBER_OF_FLASH_CHIPS;
+	}
+	return block_num / LFS_BLOCKS_PER_CHIP;
+}
+
+/// @brief Convert a LittleFS block number to the block number within its chip.
+static inline lfs_block_t LFS_get_block_within_chip(lfs_block_t block_num) {
+	if (LFS_chip_layout == LFS_CHIP_LAYOUT_STRIPE) {
+		return LFS_get_stripe_position(block_num) / LFS_NUMBER_OF_FLASH_CHIPS;
+	}
+	return block_num % LFS_BLOCKS_PER_CHIP;
+}
+
 inline static FLASH_Physical_Address_t _block_plus_offset_to_address(lfs_block_t block, lfs_off_t offset) {
+	const lfs_block_t block_within_chip = LFS_get_block_within_chip(block);
 	FLASH_Physical_Address_t address = {
-		.row_address = ((block * FLASH_CHIP_PAGES_PER_BLOCK) + (offset / FLASH_CHIP_PAGE_SIZE_BYTES)),
-		.col_address = (block* FLASH_CHIP_BLOCK_SIZE_BYTES + offset) % FLASH_CHIP_PAGE_SIZE_BYTES // address to the a specific byte in the page.
+		.row_address = ((block_within_chip * FLASH_CHIP_PAGES_PER_BLOCK) + (offset / FLASH_CHIP_PAGE_SIZE_BYTES)),
+		.col_address = offset % FLASH_CHIP_PAGE_SIZE_BYTES // address to the a specific byte in the page.
 	};
 	return address;
 }
 
-static inline uint8_t LFS_get_chip_number(lfs_block_t block_num) {
-	// TODO: Add a conversion here to partition across multiple chips, if desired.
-	return 0;
+static inline void LFS_mark_block_bad(lfs_block_t block) {
+	if (!LFS_block_device_is_block_bad(block)) {
+		LFS_bad_block_bitmap[block / 8] |= (1 << (block % 8));
+		LFS_chip_stats[LFS_get_chip_number(block)].bad_block_count++;
+	}
+}
+
+/// @brief Check whether a LittleFS block is known to be bad.
+/// @return 1 if bad, 0 if good (or not known to be bad).
+uint8_t LFS_block_device_is_block_bad(lfs_block_t block) {
+	return (LFS_bad_block_bitmap[block / 8] >> (block % 8)) & 1;
+}
+
+/// @brief Program the bad block marker into a block which failed an erase/program, so that it
+///     stays bad after a reboot (the bitmap is only in RAM).
+/// @note Best effort: the program may report a failure too (the block is bad), but the marker
+///     byte is usually still written. The marker is never erased, as known-bad blocks are skipped.
+static void LFS_write_bad_block_marker(lfs_block_t block) {
+	const uint8_t chip_number = LFS_get_chip_number(block);
+	FLASH_Physical_Address_t marker_address = _block_plus_offset_to_address(block, 0);
+	marker_address.col_address = LFS_FACTORY_BAD_BLOCK_MARKER_COL_ADDRESS;
+
+	uint8_t marker = LFS_RUNTIME_BAD_BLOCK_MARKER_VALUE;
+	const FLASH_error_enum_t result = FLASH_program_page(chip_number, marker_address, &marker, 1);
+	LOG_message(
+		LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE),
+		"Marked block %lu (chip %u) bad. FLASH_program_page() -> %d",
+		block, chip_number, result
+	);
+}
+
+/// @brief Convert an erase/program result to a LittleFS error code.
+/// @return 0 on success. LFS_ERR_CORRUPT if the block went bad (LittleFS then relocates the data
+///     to another block), or LFS_ERR_IO for any other (e.g., SPI) error.
+static int LFS_handle_erase_or_program_result(lfs_block_t block, FLASH_error_enum_t result) {
+	if (result == FLASH_ERR_OK) {
+		return 0;
+	}
+	if (result == FLASH_ERR_STATUS_REG_ERROR) {
+		LFS_chip_stats[LFS_get_chip_number(block)].failed_erase_or_program_count++;
+		if (!LFS_block_device_is_block_bad(block)) {
+			LFS_mark_block_bad(block);
+			LFS_write_bad_block_marker(block);
+		}
+		return LFS_ERR_CORRUPT;
+	}
+	return LFS_ERR_IO;
+}
+
+/// @brief Read the bad block marker of every block on the initialized chips into the bitmap.
+/// @note The bitmap is indexed by LittleFS block number, so this must be redone when the layout changes.
+static void LFS_scan_bad_block_markers(void) {
+	memset(LFS_bad_block_bitmap, 0, sizeof(LFS_bad_block_bitmap));
+	for (uint8_t chip_number = 0; chip_number < LFS_NUMBER_OF_FLASH_CHIPS; chip_number++) {
+		LFS_chip_stats[chip_number].bad_block_count = 0;
+	}
+
+	for (lfs_block_t block = 0; block < LFS_TOTAL_BLOCK_COUNT; block++) {
+		const uint8_t chip_number = LFS_get_chip_number(block);
+		if (LFS_chip_stats[chip_number].init_failed) {
+			continue;
+		}
+
+		FLASH_Physical_Address_t marker_address = _block_plus_offset_to_address(block, 0);
+		marker_address.col_address = LFS_FACTORY_BAD_BLOCK_MARKER_COL_ADDRESS;
+
+		uint8_t marker = 0xFF;
+		const FLASH_error_enum_t read_result = FLASH_read_page(chip_number, marker_address, &marker, 1);
+		if ((read_result == FLASH_ERR_OK) && (marker != 0xFF)) {
+			LFS_mark_block_bad(block);
+		}
+	}
+
+	for (uint8_t chip_number = 0; chip_number < LFS_NUMBER_OF_FLASH_CHIPS; chip_number++) {
+		if (LFS_chip_stats[chip_number].bad_block_count > 0) {
+			LOG_message(
+				LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE),
+				"Flash chip %u has %u marked bad blocks.",
+				chip_number, LFS_chip_stats[chip_number].bad_block_count
+			);
+		}
+	}
+}
+
+/// @brief Initialize every flash chip in the filesystem, and read the bad block markers.
+/// @return 0 on success, 1 if any chip failed to initialize (the other chips are still usable).
+/// @note Must be called before mounting or formatting.
+uint8_t LFS_block_device_init(void) {
+	uint8_t any_chip_failed = 0;
+	memset(LFS_chip_stats, 0, sizeof(LFS_chip_stats));
+	LFS_page_cache_invalidate_all();
+
+	for (uint8_t chip_number = 0; chip_number < LFS_NUMBER_OF_FLASH_CHIPS; chip_number++) {
+		const FLASH_error_enum_t init_result = FLASH_init(chip_number);
+		if (init_result != FLASH_ERR_OK) {
+			LFS_chip_stats[chip_number].init_failed = 1;
+			any_chip_failed = 1;
+			LOG_message(
+				LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
+				"FLASH_init(%u) failed: %d", chip_number, init_result
+			);
+		}
+	}
+
+	LFS_scan_bad_block_markers();
+	return any_chip_failed;
+}
+
+/// @brief Switch the block-to-chip layout, and re-scan the bad block markers for it.
+/// @note Only call while the filesystem is unmounted. Does nothing if the layout is unchanged.
+void LFS_block_device_set_layout(LFS_chip_layout_enum_t layout) {
+	if (layout == LFS_chip_layout) {
+		return;
+	}
+	LFS_chip_layout = layout;
+	LFS_page_cache_invalidate_all();
+	LFS_scan_bad_block_markers();
+}
+
+/// @brief Convert a chip layout enum to a string, for logging and telemetry.
+const char* LFS_chip_layout_enum_to_str(LFS_chip_layout_enum_t layout) {
+	switch (layout) {
+		case LFS_CHIP_LAYOUT_CONCATENATE:
+			return "concatenate";
+		case LFS_CHIP_LAYOUT_STRIPE:
+			return "stripe";
+		default:
+			return "unknown";
+	}
 }
 
 /// @brief LittleFS read function, memory is mapped to a physical address here.
 /// @param LittleFS Configurations, Block to write, offset, buffer, buffer size
 /// @return int - any error codes that happened in littlefs
+/// @note LittleFS bypasses its cache for large aligned reads, so `size` may span several pages.
+///     Those are read one page at a time; consecutive pages use the chip's cache read mode.
+///     Reads within one page go through the page cache (`littlefs_page_cache.c`). Multi-page reads
+///     are bulk file data, and go straight to flash, so that they don't evict cached metadata.
 int LFS_block_device_read(
 	const struct lfs_config *c, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size
 ) {
-	return FLASH_read_page(
-		LFS_get_chip_number(block),
-		_block_plus_offset_to_address(block, off),
-		(uint8_t *)buffer,
-		size
-	);
+	const uint8_t is_single_page = ((off % FLASH_CHIP_PAGE_SIZE_BYTES) + size) <= FLASH_CHIP_PAGE_SIZE_BYTES;
+	uint8_t *dest = (uint8_t *)buffer;
+	while (size > 0) {
+		const lfs_size_t page_remaining = FLASH_CHIP_PAGE_SIZE_BYTES - (off % FLASH_CHIP_PAGE_SIZE_BYTES);
+		const lfs_size_t read_size = (size < page_remaining) ? size : page_remaining;
+
+		const uint8_t chip_number = LFS_get_chip_number(block);
+		const FLASH_Physical_Address_t address = _block_plus_offset_to_address(block, off);
+		const FLASH_error_enum_t result = is_single_page
+			? LFS_page_cache_read(chip_number, address, dest, read_size)
+			: FLASH_read_page(chip_number, address, dest, read_size);
+		if (result != FLASH_ERR_OK) {
+			return LFS_ERR_IO;
+		}
+
+		dest += read_size;
+		off += read_size;
+		size -= read_size;
+	}
+	return 0;
 }
 
 /// @brief LittleFS write function, memory is mapped to a physical address here.
@@ -40,22 +240,36 @@ int LFS_block_device_prog(
 	const struct lfs_config *c, lfs_block_t block, lfs_off_t off,
 	const void *buffer, lfs_size_t size
 ) {
-	return FLASH_program_page(
-		LFS_get_chip_number(block),
-		_block_plus_offset_to_address(block, off),
-		(uint8_t *)buffer,
-		size
-	);
+	if (LFS_block_device_is_block_bad(block)) {
+		return LFS_ERR_CORRUPT;
+	}
+
+	const uint8_t chip_number = LFS_get_chip_number(block);
+	const FLASH_Physical_Address_t address = _block_plus_offset_to_address(block, off);
+	LFS_page_cache_invalidate_page(chip_number, address.row_address);
+	LFS_block_device_write_count++;
+
+	const FLASH_error_enum_t result = FLASH_program_page(chip_number, address, (uint8_t *)buffer, size);
+	return LFS_handle_erase_or_program_result(block, result);
 }
 
 /// @brief LittleFS erase function, memory is mapped to a physical address here.
 /// @param LittleFS Configurations, Block to erase
 /// @return int - any error codes that happened in littlefs
+/// @note Known-bad blocks are reported as LFS_ERR_CORRUPT without being erased, so that LittleFS
+///     skips them (and so that the factory bad block marker is never erased).
 int LFS_block_device_erase(const struct lfs_config *c, lfs_block_t block) {
-	return FLASH_erase_block(
-		LFS_get_chip_number(block),
-		_block_plus_offset_to_address(block, 0)
-	);
+	if (LFS_block_device_is_block_bad(block)) {
+		return LFS_ERR_CORRUPT;
+	}
+
+	const uint8_t chip_number = LFS_get_chip_number(block);
+	const FLASH_Physical_Address_t address = _block_plus_offset_to_address(block, 0);
+	LFS_page_cache_invalidate_block(chip_number, address.row_address);
+	LFS_block_device_write_count++;
+
+	const FLASH_error_enum_t result = FLASH_erase_block(chip_number, address);
+	return LFS_handle_erase_or_program_result(block, result);
 }
 
 /// @brief LittleFS sync function
@@ -67,3 +281,46 @@ int LFS_block_device_sync(const struct lfs_config *c) {
 	// the memory, the sync function can simply return 0.
 	return 0;
 }
+
+#ifdef LFS_THREADSAFE
+// Serializes LittleFS calls between tasks. Needed because the flash driver lets other tasks run
+// while a page program or block erase is in progress (see `FLASH_wait_until_ready_with_backoff`),
+// and one of them may start its own LittleFS operation then.
+static TASK_HELP_lazy_mutex_t LFS_lock_mutex = TASK_HELP_LAZY_MUTEX_INIT("LFS_lock_mutex");
+
+int LFS_block_device_lock(const struct lfs_config *c) {
+	const uint8_t lock_result = TASK_HELP_lazy_mutex_lock(&LFS_lock_mutex);
+	if (lock_result == 1) {
+		return LFS_ERR_NOMEM;
+	}
+	if (lock_result != 0) {
+		return LFS_ERR_IO;
+	}
+	return 0;
+}
+
+int LFS_block_device_unlock(const struct lfs_config *c) {
+	if (TASK_HELP_lazy_mutex_unlock(&LFS_lock_mutex) != 0) {
+		return LFS_ERR_IO;
+	}
+	return 0;
+}
+#endif // LFS_THREADSAFE
+
+/// @brief Takes the LittleFS lock around direct flash driver access which bypasses LittleFS
+///     (e.g., the `flash_*` telecommands).
+/// @note The flash driver yields while a program/erase is busy. Without this lock, another task
+///     could start a LittleFS operation on the same chip mid-operation, and LittleFS-derived
+///     state (page cache, agenda index, MPI science file) would be read while the raw access
+///     is half-done. Recursive, so it may be held around LittleFS calls too.
+void LFS_lock_for_raw_flash_access(void) {
+#ifdef LFS_THREADSAFE
+	LFS_block_device_lock(NULL);
+#endif
+}
+
+void LFS_unlock_for_raw_flash_access(void) {
+#ifdef LFS_THREADSAFE
+	LFS_block_device_unlock(NULL);
+#endif
+}
@@ -5,16 +5,31 @@
 #include "littlefs/littlefs_helper.h"
 #include "littlefs/lfs.h"
 #include "littlefs/littlefs_driver.h"
+#include "littlefs/littlefs_checksums.h"
+#include "littlefs/littlefs_dir_listing.h"
+#include "littlefs/littlefs_page_cache.h"
 #include "log/log.h"
 
 /*-----------------------------VARIABLES-----------------------------*/
 // Variables to track LittleFS on Flash Memory Module
 uint8_t LFS_is_lfs_mounted = 0;
 
+/// @brief Number of successful mounts since boot. Lets holders of open files detect that the
+///     filesystem was unmounted (and maybe remounted) under them.
+uint32_t LFS_mount_count = 0;
+
+/// @brief Block-to-chip layout (`LFS_chip_layout_enum_t`) used by the next `LFS_format()`.
+/// @note Mounting uses the layout recorded in the filesystem (see `LFS_CHIP_LAYOUT_ATTR_TYPE`).
+uint32_t LFS_chip_layout_for_format = LFS_CHIP_LAYOUT_CONCATENATE;
+
+// Attribute type on the root directory which records the layout the filesystem was formatted with.
+// Filesystems formatted before it existed don't have it, and are concatenate.
+#define LFS_CHIP_LAYOUT_ATTR_TYPE 0x4C
+
 // Should be equal to `BLOCK_COUNT / 8` to store every block in the lookahead buffer,
 // for optimal performance.
-// Best value: 1024 blocks / 8 = 128
-#define FLASH_LOOKAHEAD_SIZE 128
+// Best value: 4096 blocks (4 chips) / 8 = 512
+#define FLASH_LOOKAHEAD_SIZE (LFS_TOTAL_BLOCK_COUNT / 8)
 
 // LittleFS Buffers for reading and writing
 uint8_t LFS_read_buffer[FLASH_CHIP_PAGE_SIZE_BYTES];
@@ -31,11 +46,15 @@ struct lfs_config LFS_cfg = {
     .prog = LFS_block_device_prog,
     .erase = LFS_block_device_erase,
     .sync = LFS_block_device_sync,
+#ifdef LFS_THREADSAFE
+    .lock = LFS_block_device_lock,
+    .unlock = LFS_block_device_unlock,
+#endif
 
     .read_size = FLASH_CHIP_PAGE_SIZE_BYTES,
     .prog_size = FLASH_CHIP_PAGE_SIZE_BYTES,
     .block_size = FLASH_CHIP_BLOCK_SIZE_BYTES,
-    .block_count = (FLASH_CHIP_SIZE_BYTES / FLASH_CHIP_BLOCK_SIZE_BYTES),
+    .block_count = LFS_TOTAL_BLOCK_COUNT, // All chips. See `LFS_chip_layout`.
     .block_cycles = 500, 
     .cache_size = FLASH_CHIP_PAGE_SIZE_BYTES,
     .lookahead_size = FLASH_LOOKAHEAD_SIZE,
@@ -62,7 +81,7 @@ uint8_t LFS_init() {
         "Entering LFS_init()"
     );
 
-    FLASH_init(0); // TODO: probably need initialize all other chips.
+    LFS_block_device_init();
     LFS_ensure_mounted();
 
     // Create directories which must exist here.
@@ -80,34 +99,164 @@ uint8_t LFS_init() {
 /// @brief Formats Memory Module so it can successfully mount LittleFS
 /// @param None
 /// @return 0 on success, 1 if LFS is already mounted, negative LFS error codes on failure
+/// @note Uses the layout in `LFS_chip_layout_for_format`, and records it in the filesystem.
 int8_t LFS_format() {
     if (LFS_is_lfs_mounted) {
         LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE), 
         "FLASH Memory cannot be formatted while LFS is mounted!");
         return 1;
     }
+    if (LFS_chip_layout_for_format > LFS_CHIP_LAYOUT_STRIPE) {
+        LOG_message(
+            LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
+            "Invalid LFS_chip_layout_for_format: %lu", LFS_chip_layout_for_format
+        );
+        return LFS_ERR_INVAL;
+    }
     
+    LFS_block_device_set_layout((LFS_chip_layout_enum_t)LFS_chip_layout_for_format);
+    LFS_page_cache_invalidate_all();
+    LFS_dir_listing_reset();
     const int8_t format_result = lfs_format(&LFS_filesystem, &LFS_cfg);
     if (format_result < 0) {
         LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_CRITICAL, LOG_all_sinks_except(LOG_SINK_FILE), "Error formatting FLASH memory!");
         return format_result;
     }
+
+    int8_t attr_result = lfs_mount(&LFS_filesystem, &LFS_cfg);
+    if (attr_result == 0) {
+        const uint8_t layout = (uint8_t)LFS_chip_layout;
+        attr_result = lfs_setattr(&LFS_filesystem, "/", LFS_CHIP_LAYOUT_ATTR_TYPE, &layout, sizeof(layout));
+        lfs_unmount(&LFS_filesystem);
+    }
+    if (attr_result < 0) {
+        LOG_message(
+            LOG_SYSTEM_LFS, LOG_SEVERITY_CRITICAL, LOG_all_sinks_except(LOG_SINK_FILE),
+            "Error recording the chip layout after formatting: %d", attr_result
+        );
+        return attr_result;
+    }
     
-    LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE), "LittleFS Memory formatting successful!");
+    LOG_message(
+        LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE),
+        "LittleFS Memory formatting successful (%s layout)!",
+        LFS_chip_layout_enum_to_str(LFS_chip_layout)
+    );
+    return 0;
+}
+
+/// @brief Mounts a filesystem with a smaller block count (e.g., formatted on chip 0 only), then
+///     grows it to span all chips.
+/// @return 0 on success, negative LFS error codes on failure
+/// @note Only valid for the concatenate layout, where the first chip's blocks are in the same place.
+static int8_t LFS_mount_and_grow_to_all_chips() {
+    // A block count of 0 tells LittleFS to use the block count from the superblock.
+    const lfs_size_t configured_block_count = LFS_cfg.block_count;
+    LFS_cfg.block_count = 0;
+    const int8_t mount_result = lfs_mount(&LFS_filesystem, &LFS_cfg);
+    LFS_cfg.block_count = configured_block_count;
+    if (mount_result < 0) {
+        return mount_result;
+    }
+    if (LFS_filesystem.block_count > configured_block_count) {
+        // Shrinking is not supported.
+        lfs_unmount(&LFS_filesystem);
+        return LFS_ERR_INVAL;
+    }
+
+    const int8_t grow_result = lfs_fs_grow(&LFS_filesystem, configured_block_count);
+    if (grow_result < 0) {
+        LOG_message(
+            LOG_SYSTEM_LFS, LOG_SEVERITY_CRITICAL, LOG_all_sinks_except(LOG_SINK_FILE),
+            "Error: lfs_fs_grow() -> %d", grow_result
+        );
+        lfs_unmount(&LFS_filesystem);
+        return grow_result;
+    }
+
+    LOG_message(
+        LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE),
+        "Grew LittleFS filesystem to %lu blocks (%u chips).",
+        configured_block_count, LFS_NUMBER_OF_FLASH_CHIPS
+    );
+    return 0;
+}
+
+/// @brief Mount with the given layout, and read the layout recorded in the filesystem.
+/// @param formatted_layout_out Set to the recorded layout on success.
+/// @return 0 on success (left mounted), negative LFS error codes on failure (left unmounted)
+static int8_t LFS_mount_with_layout(
+    LFS_chip_layout_enum_t layout, LFS_chip_layout_enum_t *formatted_layout_out
+) {
+    LFS_block_device_set_layout(layout);
+
+    int8_t mount_result = lfs_mount(&LFS_filesystem, &LFS_cfg);
+    if ((mount_result == LFS_ERR_INVAL) && (layout == LFS_CHIP_LAYOUT_CONCATENATE)) {
+        // The superblock's block count doesn't match (e.g., a filesystem formatted on chip 0 only).
+        mount_result = LFS_mount_and_grow_to_all_chips();
+    }
+    if (mount_result < 0) {
+        return mount_result;
+    }
+
+    uint8_t formatted_layout = LFS_CHIP_LAYOUT_CONCATENATE;
+    const lfs_ssize_t attr_result = lfs_getattr(
+        &LFS_filesystem, "/", LFS_CHIP_LAYOUT_ATTR_TYPE, &formatted_layout, sizeof(formatted_layout)
+    );
+    if ((attr_result < 0) && (attr_result != LFS_ERR_NOATTR)) {
+        lfs_unmount(&LFS_filesystem);
+        return attr_result;
+    }
+    *formatted_layout_out = (LFS_chip_layout_enum_t)formatted_layout;
     return 0;
 }
 
 /// @brief Mounts LittleFS to the Memory Module
 /// @param None
 /// @return 0 on success, 1 if LFS is already mounted, negative LFS error codes on failure
+/// @note Switches `LFS_chip_layout` to the layout the filesystem was formatted with. Both layouts
+///     keep the superblock pair in the same place, so mounting with the wrong one can appear to
+///     work; the layout recorded there is checked after every mount.
 int8_t LFS_mount() {
     if (LFS_is_lfs_mounted) {
         LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE), "LittleFS already mounted!");
         return 1;
     }
 
-    // Variable to store status of LittleFS mounting
-    const int8_t mount_result = lfs_mount(&LFS_filesystem, &LFS_cfg);
+    // The flash may have been written outside LittleFS (e.g., `flash_write_hex`) since the last mount.
+    LFS_page_cache_invalidate_all();
+    LFS_dir_listing_reset();
+
+    const LFS_chip_layout_enum_t initial_layout = LFS_chip_layout;
+    LFS_chip_layout_enum_t formatted_layout = initial_layout;
+    int8_t mount_result = LFS_mount_with_layout(initial_layout, &formatted_layout);
+    if ((mount_result < 0) || (formatted_layout != initial_layout)) {
+        if (mount_result == 0) {
+            lfs_unmount(&LFS_filesystem);
+        }
+        const LFS_chip_layout_enum_t other_layout = (initial_layout == LFS_CHIP_LAYOUT_STRIPE)
+            ? LFS_CHIP_LAYOUT_CONCATENATE : LFS_CHIP_LAYOUT_STRIPE;
+
+        const int8_t other_mount_result = LFS_mount_with_layout(other_layout, &formatted_layout);
+        if ((other_mount_result == 0) && (formatted_layout == other_layout)) {
+            LOG_message(
+                LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE),
+                "LittleFS was formatted with the %s layout. Switched from %s.",
+                LFS_chip_layout_enum_to_str(other_layout), LFS_chip_layout_enum_to_str(initial_layout)
+            );
+            mount_result = 0;
+        }
+        else {
+            if (other_mount_result == 0) {
+                lfs_unmount(&LFS_filesystem);
+            }
+            LFS_block_device_set_layout(initial_layout);
+            if (mount_result == 0) {
+                // Mounted, but the recorded layout doesn't mount.
+                mount_result = LFS_ERR_CORRUPT;
+            }
+        }
+    }
     if (mount_result < 0) {
         LOG_message(
             LOG_SYSTEM_LFS, LOG_SEVERITY_CRITICAL, LOG_all_sinks_except(LOG_SINK_FILE),
@@ -120,6 +269,7 @@ int8_t LFS_mount() {
     LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE), "LittleFS mounting successful!");
     
     LFS_is_lfs_mounted = 1;
+    LFS_mount_count++;
     return 0;
 }
 
@@ -133,6 +283,9 @@ int8_t LFS_unmount()
         return 1;
     }
 
+    // Close the listing cursor's directory while the filesystem is still mounted.
+    LFS_dir_listing_reset();
+
     // Unmount LittleFS to release any resources used by LittleFS
     const int8_t unmount_result = lfs_unmount(&LFS_filesystem);
     if (unmount_result < 0)
@@ -185,16 +338,15 @@ int8_t LFS_list_directory(const char root_directory[], uint16_t offset, int16_t
         return mount_result;
     }
 
-    // Try to open the directory
-    lfs_dir_t dir;
-    const int8_t open_dir_result = lfs_dir_open(&LFS_filesystem, &dir, root_directory);
-    if (open_dir_result < 0)
+    // Continues the previous listing (or reads the directory's index) when possible.
+    const int32_t seek_result = LFS_dir_listing_seek(root_directory, offset);
+    if (seek_result < 0)
     {
         LOG_message(
             LOG_SYSTEM_LFS, LOG_SEVERITY_CRITICAL, LOG_all_sinks_except(LOG_SINK_FILE),
             "Error opening directory: %s", root_directory
         );
-        return open_dir_result;
+        return seek_result;
     }
 
     if (count == 0) {
@@ -202,14 +354,14 @@ int8_t LFS_list_directory(const char root_directory[], uint16_t offset, int16_t
     }
 
     // Result is positive on success, 0 at the end of directory, or negative on failure.
-    int8_t read_dir_result = 1;
-    struct lfs_info info;
+    int32_t read_dir_result = 1;
+    LFS_dir_listing_entry_t entry;
     LOG_message(
         LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE), "Name (Bytes)"
     );
-    while (read_dir_result > 0)
+    while (count != 0)
     {
-        read_dir_result = lfs_dir_read(&LFS_filesystem, &dir, &info);
+        read_dir_result = LFS_dir_listing_read(&entry);
 
         if (read_dir_result < 0)
         {
@@ -219,39 +371,28 @@ int8_t LFS_list_directory(const char root_directory[], uint16_t offset, int16_t
             );
             break;
         }
-
-        if (offset > 0) {
-            offset--;
-            continue;
+        if (read_dir_result == 0) {
+            break;
         }
 
-        if (count == 0) {
-            break;
-        } else {
+        if (count > 0) {
             count--;
         }
 
-        if (info.type == LFS_TYPE_REG)
+        if (entry.type == LFS_TYPE_REG)
         {
             LOG_message(
                 LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE),
-                "%s (%ld B)", info.name, info.size
+                "%s (%ld B)", entry.name, entry.size
             );
-        } else if (info.type == LFS_TYPE_DIR){
+        } else if (entry.type == LFS_TYPE_DIR){
             LOG_message(
                 LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE),
-                "%s/", info.name
+                "%s/", entry.name
             );
         }
     }
 
-    const int8_t close_dir_result = lfs_dir_close(&LFS_filesystem, &dir);
-    if (close_dir_result < 0)
-    {
-        LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_CRITICAL, LOG_all_sinks_except(LOG_SINK_FILE), "Error closing directory: %s", root_directory);
-        return close_dir_result;
-    }
-
     if (read_dir_result < 0) {
         return read_dir_result;
     } else {
@@ -270,6 +411,7 @@ int8_t LFS_make_directory(const char dir_name[]) {
     }
 
     const int8_t make_dir_result = lfs_mkdir(&LFS_filesystem, dir_name);
+    LFS_dir_listing_invalidate_path(dir_name);
     if (make_dir_result < 0)
     {
         if (make_dir_result == LFS_ERR_EXIST) {
@@ -296,6 +438,7 @@ int8_t LFS_delete_file(const char file_name[]) {
     }
 
     const int8_t remove_result = lfs_remove(&LFS_filesystem, file_name);
+    LFS_dir_listing_invalidate_path(file_name);
     if (remove_result < 0)
     {
         LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE), "Error removing file: %s", file_name);
@@ -378,6 +521,7 @@ int8_t LFS_delete_directory(const char directory[]) {
 
     // Finally, delete the directory itself
     const int8_t remove_result = lfs_remove(&LFS_filesystem, directory);
+    LFS_dir_listing_invalidate_path(directory);
     if (remove_result < 0) {
         LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE), "Error removing directory: %s", directory);
         return remove_result; // Return the error code
@@ -443,6 +587,7 @@ int8_t LFS_write_file(const char file_name[], uint8_t *write_buffer, uint32_t wr
     const int8_t open_result = lfs_file_open(
         &LFS_filesystem, &file, file_name, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC
     );
+    LFS_dir_listing_invalidate_path(file_name);
 
     if (open_result < 0) {
         LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE), "Error opening/creating file: %s", file_name);
@@ -451,6 +596,14 @@ int8_t LFS_write_file(const char file_name[], uint8_t *write_buffer, uint32_t wr
     
     LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE), "Opened/created file: %s", file_name);
 
+    // Invalidate the cached SHA256 digest before changing the file.
+    const int8_t bump_result = LFS_checksum_bump_generation(file_name);
+    if (bump_result < 0) {
+        LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE), "Error invalidating the checksum digest of file: %s (error: %d)", file_name, bump_result);
+        lfs_file_close(&LFS_filesystem, &file);
+        return bump_result;
+    }
+
     // Write data to file
     const lfs_ssize_t write_result = lfs_file_write(&LFS_filesystem, &file, write_buffer, write_buffer_len);
     if (write_result < 0) {
@@ -486,12 +639,21 @@ int8_t LFS_append_file(const char file_name[], uint8_t *write_buffer, uint32_t w
     const int8_t open_result = lfs_file_open(
         &LFS_filesystem, &file, file_name, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND
     );
+    LFS_dir_listing_invalidate_path(file_name);
     if (open_result < 0) {
         LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_CRITICAL, LOG_all_sinks_except(LOG_SINK_FILE), "Error opening file: %s", file_name);
         return open_result;
     }
     // Note: No need to seek to the end of the file, as `LFS_O_APPEND` opens with the cursor at the end.
 
+    // Invalidate the cached SHA256 digest before changing the file.
+    const int8_t bump_result = LFS_checksum_bump_generation(file_name);
+    if (bump_result < 0) {
+        LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE), "Error invalidating the checksum digest of file: %s (error: %d)", file_name, bump_result);
+        lfs_file_close(&LFS_filesystem, &file);
+        return bump_result;
+    }
+
     const lfs_ssize_t write_result = lfs_file_write(&LFS_filesystem, &file, write_buffer, write_buffer_len);
     if (write_result < 0) {
         LOG_message(
@@ -530,6 +692,7 @@ int8_t LFS_write_file_with_offset(const char file_name[], lfs_soff_t offset, uin
     const int8_t open_result = lfs_file_open(
         &LFS_filesystem, &file, file_name, LFS_O_RDWR | LFS_O_CREAT
     );
+    LFS_dir_listing_invalidate_path(file_name);
     if (open_result < 0) {
         LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE), 
                    "Error opening file: %s (error: %d)", file_name, open_result);
@@ -539,6 +702,14 @@ int8_t LFS_write_file_with_offset(const char file_name[], lfs_soff_t offset, uin
     LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE), 
                "Opened file for writing at offset: %s", file_name);
 
+    // Invalidate the cached SHA256 digest before changing the file.
+    const int8_t bump_result = LFS_checksum_bump_generation(file_name);
+    if (bump_result < 0) {
+        LOG_message(LOG_SYSTEM_LFS, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_FILE), "Error invalidating the checksum digest of file: %s (error: %d)", file_name, bump_result);
+        lfs_file_close(&LFS_filesystem, &file);
+        return bump_result;
+    }
+
     // Get the current file size to determine if we need to extend it
 
     const lfs_soff_t current_size = lfs_file_size(&LFS_filesystem, &file);
@@ -734,3 +905,44 @@ lfs_ssize_t LFS_file_size(const char file_name[], uint8_t enable_log_messages) {
     }
     return size; // Nominally, return the number of bytes in the file.
 }
+
+/// @brief File holding the number of the latest boot, for `LFS_get_boot_count`.
+static const char LFS_BOOT_COUNT_FILE_NAME[] = "boot_count.bin";
+
+/// @brief This boot's number, once `LFS_get_boot_count` has saved it. 0 before then.
+static uint32_t LFS_boot_count = 0;
+
+/// @brief Get this boot's number, to tell apart data from different boots (e.g., uptimes).
+/// @return The boot number (1 or more), or 0 if it couldn't be read or saved.
+/// @note Read, incremented, and saved on the first call of each boot, not at startup (so that
+///     booting doesn't write to LittleFS). So it numbers the boots which asked for it: each boot's
+///     number is larger than the last, but it isn't a count of resets. Restarts at 1 after a format.
+uint32_t LFS_get_boot_count(void) {
+    if (LFS_boot_count != 0) {
+        return LFS_boot_count;
+    }
+    if (LFS_ensure_mounted() < 0) {
+        return 0;
+    }
+
+    uint32_t last_boot_count = 0;
+    lfs_file_t file;
+    const int open_result = lfs_file_open(&LFS_filesystem, &file, LFS_BOOT_COUNT_FILE_NAME, LFS_O_RDONLY);
+    if (open_result >= 0) {
+        const lfs_ssize_t read_result = lfs_file_read(&LFS_filesystem, &file, &last_boot_count, sizeof(last_boot_count));
+        lfs_file_close(&LFS_filesystem, &file);
+        if (read_result != sizeof(last_boot_count)) {
+            return 0;
+        }
+    }
+    else if (open_result != LFS_ERR_NOENT) {
+        return 0;
+    }
+
+    const uint32_t boot_count = last_boot_count + 1;
+    if (LFS_write_file(LFS_BOOT_COUNT_FILE_NAME, (uint8_t *)&boot_count, sizeof(boot_count)) != 0) {
+        return 0;
+    }
+    LFS_boot_count = boot_count;
+    return boot_count;
+}
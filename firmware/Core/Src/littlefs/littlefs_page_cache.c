@@ -0,0 +1,271 @@
+// littlefs_page_cache.c
+// LRU cache of whole flash pages, between LittleFS and the flash driver.
+//
+// LittleFS keeps only one page in its read cache, so metadata walks (mount, `lfs_dir_read`,
+// `lfs_stat`) read the same metadata pages from flash again and again. This cache keeps the most
+// recently used pages, and reads ahead when LittleFS reads consecutive pages of a block.
+// Pages are invalidated when they are programmed or erased, so cached data always matches flash
+// (LittleFS's read-back check after a program still reads the chip).
+
+#include "littlefs/littlefs_page_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+/// @brief Number of page buffers in use (0 to `LFS_PAGE_CACHE_MAX_PAGE_COUNT`). 0 disables the cache.
+uint32_t LFS_page_cache_page_count = LFS_PAGE_CACHE_MAX_PAGE_COUNT;
+
+/// @brief On a miss right after the previous page of the same block, also load this many of the
+///     following pages (up to the end of the block). 0 disables read-ahead.
+uint32_t LFS_page_cache_read_ahead_page_count = 4;
+
+LFS_page_cache_stats_t LFS_page_cache_stats;
+
+typedef struct {
+    uint32_t row_address;
+
+    /// @brief Value of `LFS_page_cache_use_counter` when last used. The lowest is evicted first.
+    uint32_t last_used;
+
+    uint8_t chip_number;
+    uint8_t is_valid;
+
+    /// @brief Loaded by read-ahead, and not requested yet.
+    uint8_t is_read_ahead;
+} LFS_page_cache_entry_t;
+
+static LFS_page_cache_entry_t LFS_page_cache_entries[LFS_PAGE_CACHE_MAX_PAGE_COUNT];
+static uint8_t LFS_page_cache_data[LFS_PAGE_CACHE_MAX_PAGE_COUNT][FLASH_CHIP_PAGE_SIZE_BYTES];
+static uint32_t LFS_page_cache_use_counter = 0;
+
+// Last page requested, and how many pages before it were requested in order, to detect sequential reads.
+static uint8_t LFS_page_cache_last_chip_number = 0xFF;
+static uint32_t LFS_page_cache_last_row_address = 0;
+static uint32_t LFS_page_cache_sequential_run_length = 0;
+
+/// @brief Get the number of entries in use, clamped to the entries which exist.
+static inline uint8_t LFS_page_cache_get_active_count(void) {
+    return (LFS_page_cache_page_count < LFS_PAGE_CACHE_MAX_PAGE_COUNT)
+        ? (uint8_t)LFS_page_cache_page_count
+        : LFS_PAGE_CACHE_MAX_PAGE_COUNT;
+}
+
+/// @brief Find a cached page.
+/// @return Entry index, or -1 if not cached.
+static int8_t LFS_page_cache_find(uint8_t chip_number, uint32_t row_address) {
+    const uint8_t active_count = LFS_page_cache_get_active_count();
+    for (uint8_t i = 0; i < active_count; i++) {
+        const LFS_page_cache_entry_t *entry = &LFS_page_cache_entries[i];
+        if (entry->is_valid && (entry->row_address == row_address) && (entry->chip_number == chip_number)) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+/// @brief Pick the entry to load a new page into: an empty one, or else the least recently used.
+static uint8_t LFS_page_cache_find_victim(void) {
+    const uint8_t active_count = LFS_page_cache_get_active_count();
+    uint8_t victim = 0;
+    for (uint8_t i = 0; i < active_count; i++) {
+        const LFS_page_cache_entry_t *entry = &LFS_page_cache_entries[i];
+        if (!entry->is_valid) {
+            return i;
+        }
+        if (entry->last_used < LFS_page_cache_entries[victim].last_used) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+/// @brief Check whether a page reads as erased (all 0xFF).
+static uint8_t LFS_page_cache_is_page_erased(const uint8_t page[]) {
+    for (uint32_t i = 0; i < FLASH_CHIP_PAGE_SIZE_BYTES; i++) {
+        if (page[i] != 0xFF) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/// @brief Read a whole page from flash into a cache entry.
+/// @return Entry index, or -1 if the read failed (`*result_out` has the error).
+static int8_t LFS_page_cache_load(
+    uint8_t chip_number, uint32_t row_address, uint8_t is_read_ahead, FLASH_error_enum_t *result_out
+) {
+    const uint8_t victim = LFS_page_cache_find_victim();
+    LFS_page_cache_entry_t *entry = &LFS_page_cache_entries[victim];
+    entry->is_valid = 0;
+
+    const FLASH_Physical_Address_t address = {.row_address = row_address, .col_address = 0};
+    *result_out = FLASH_read_page(chip_number, address, LFS_page_cache_data[victim], FLASH_CHIP_PAGE_SIZE_BYTES);
+    if (*result_out != FLASH_ERR_OK) {
+        return -1;
+    }
+
+    entry->chip_number = chip_number;
+    entry->row_address = row_address;
+    entry->last_used = ++LFS_page_cache_use_counter;
+    entry->is_read_ahead = is_read_ahead;
+    entry->is_valid = 1;
+    return (int8_t)victim;
+}
+
+/// @brief Read part of one page, through the cache.
+/// @param address Page and offset to read from. `address.col_address + size` must be within the page.
+/// @param dest Destination buffer, of at least `size` bytes.
+/// @return FLASH_ERR_OK on success, or the flash driver's error.
+/// @note When the cache is disabled (`LFS_page_cache_page_count` is 0), reads go straight to flash.
+FLASH_error_enum_t LFS_page_cache_read(
+    uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *dest, uint32_t size
+) {
+    const uint32_t row_address = address.row_address;
+    if (
+        (chip_number == LFS_page_cache_last_chip_number)
+        && (row_address == (LFS_page_cache_last_row_address + 1))
+    ) {
+        LFS_page_cache_sequential_run_length++;
+    }
+    else if ((chip_number != LFS_page_cache_last_chip_number) || (row_address != LFS_page_cache_last_row_address)) {
+        LFS_page_cache_sequential_run_length = 0;
+    }
+    LFS_page_cache_last_chip_number = chip_number;
+    LFS_page_cache_last_row_address = row_address;
+
+    // Only the main area of each page is cached, not the spare area past it.
+    if ((LFS_page_cache_get_active_count() == 0) || ((address.col_address + size) > FLASH_CHIP_PAGE_SIZE_BYTES)) {
+        return FLASH_read_page(chip_number, address, dest, size);
+    }
+
+    int8_t entry_index = LFS_page_cache_find(chip_number, row_address);
+    if (entry_index >= 0) {
+        LFS_page_cache_stats.hit_count++;
+        LFS_page_cache_entry_t *entry = &LFS_page_cache_entries[entry_index];
+        if (entry->is_read_ahead) {
+            LFS_page_cache_stats.read_ahead_hit_count++;
+            entry->is_read_ahead = 0;
+        }
+        entry->last_used = ++LFS_page_cache_use_counter;
+        memcpy(dest, &LFS_page_cache_data[entry_index][address.col_address], size);
+        return FLASH_ERR_OK;
+    }
+
+    LFS_page_cache_stats.miss_count++;
+    FLASH_error_enum_t result;
+    entry_index = LFS_page_cache_load(chip_number, row_address, 0, &result);
+    if (entry_index < 0) {
+        return result;
+    }
+    memcpy(dest, &LFS_page_cache_data[entry_index][address.col_address], size);
+
+    // Read ahead once the third page in a row is requested (metadata fetches often read just two
+    // consecutive pages). Pages of a NAND block are programmed in order, so nothing after an erased
+    // page (e.g., the end of a metadata log) is worth reading.
+    if (
+        (LFS_page_cache_sequential_run_length >= 2)
+        && !LFS_page_cache_is_page_erased(LFS_page_cache_data[entry_index])
+    ) {
+        // Load the following pages of the block while the chip is in cache read mode (see
+        // `FLASH_read_page`). Keep at least one entry for pages which are not part of the run.
+        const uint32_t block_end_row = ((row_address / FLASH_CHIP_PAGES_PER_BLOCK) + 1) * FLASH_CHIP_PAGES_PER_BLOCK;
+        const uint8_t active_count = LFS_page_cache_get_active_count();
+        const uint32_t max_read_ahead_count = (active_count > 2) ? (active_count - 2) : 0;
+        uint32_t read_ahead_count = (LFS_page_cache_read_ahead_page_count < max_read_ahead_count)
+            ? LFS_page_cache_read_ahead_page_count
+            : max_read_ahead_count;
+        for (uint32_t next_row = row_address + 1; (next_row < block_end_row) && (read_ahead_count > 0); next_row++) {
+            if (LFS_page_cache_find(chip_number, next_row) >= 0) {
+                break;
+            }
+            FLASH_error_enum_t read_ahead_result;
+            const int8_t read_ahead_index = LFS_page_cache_load(chip_number, next_row, 1, &read_ahead_result);
+            if (read_ahead_index < 0) {
+                break; // Not an error for this read. The page is read again if it's requested.
+            }
+            LFS_page_cache_stats.read_ahead_page_count++;
+            read_ahead_count--;
+
+            // Keep the first erased page (LittleFS reads it to find the end of a log), but not the
+            // erased pages after it.
+            if (LFS_page_cache_is_page_erased(LFS_page_cache_data[read_ahead_index])) {
+                break;
+            }
+        }
+    }
+    return FLASH_ERR_OK;
+}
+
+/// @brief Drop a page from the cache (e.g., before it is programmed).
+void LFS_page_cache_invalidate_page(uint8_t chip_number, uint32_t row_address) {
+    // All entries, not only the active ones, in case `LFS_page_cache_page_count` grows again later.
+    for (uint8_t i = 0; i < LFS_PAGE_CACHE_MAX_PAGE_COUNT; i++) {
+        LFS_page_cache_entry_t *entry = &LFS_page_cache_entries[i];
+        if (entry->is_valid && (entry->row_address == row_address) && (entry->chip_number == chip_number)) {
+            entry->is_valid = 0;
+            LFS_page_cache_stats.invalidated_page_count++;
+        }
+    }
+}
+
+/// @brief Drop every page of a block from the cache (e.g., before it is erased).
+/// @param first_row_address Row address of any page in the block.
+void LFS_page_cache_invalidate_block(uint8_t chip_number, uint32_t first_row_address) {
+    const uint32_t block_num = first_row_address / FLASH_CHIP_PAGES_PER_BLOCK;
+    for (uint8_t i = 0; i < LFS_PAGE_CACHE_MAX_PAGE_COUNT; i++) {
+        LFS_page_cache_entry_t *entry = &LFS_page_cache_entries[i];
+        if (
+            entry->is_valid && (entry->chip_number == chip_number)
+            && ((entry->row_address / FLASH_CHIP_PAGES_PER_BLOCK) == block_num)
+        ) {
+            entry->is_valid = 0;
+            LFS_page_cache_stats.invalidated_page_count++;
+        }
+    }
+}
+
+/// @brief Drop every page from the cache. Call after writing to flash other than through LittleFS.
+void LFS_page_cache_invalidate_all(void) {
+    for (uint8_t i = 0; i < LFS_PAGE_CACHE_MAX_PAGE_COUNT; i++) {
+        LFS_page_cache_entries[i].is_valid = 0;
+    }
+    LFS_page_cache_last_chip_number = 0xFF;
+    LFS_page_cache_sequential_run_length = 0;
+}
+
+void LFS_page_cache_reset_stats(void) {
+    memset(&LFS_page_cache_stats, 0, sizeof(LFS_page_cache_stats));
+}
+
+/// @brief Format the page cache counters and settings as a JSON object.
+/// @return Number of characters written (excluding the null terminator), or -1 if truncated.
+int16_t LFS_page_cache_stats_to_json(char json_output_buf[], uint16_t json_output_buf_size) {
+    const uint32_t lookup_count = LFS_page_cache_stats.hit_count + LFS_page_cache_stats.miss_count;
+    const int written = snprintf(
+        json_output_buf,
+        json_output_buf_size,
+        "{"
+            "\"page_count\":%" PRIu32 ","
+            "\"read_ahead_page_count\":%" PRIu32 ","
+            "\"hit_count\":%" PRIu32 ","
+            "\"miss_count\":%" PRIu32 ","
+            "\"hit_percent\":%.1f,"
+            "\"read_ahead_loaded_count\":%" PRIu32 ","
+            "\"read_ahead_hit_count\":%" PRIu32 ","
+            "\"invalidated_page_count\":%" PRIu32
+        "}",
+        LFS_page_cache_page_count,
+        LFS_page_cache_read_ahead_page_count,
+        LFS_page_cache_stats.hit_count,
+        LFS_page_cache_stats.miss_count,
+        (lookup_count > 0) ? (LFS_page_cache_stats.hit_count * 100.0 / lookup_count) : 0.0,
+        LFS_page_cache_stats.read_ahead_page_count,
+        LFS_page_cache_stats.read_ahead_hit_count,
+        LFS_page_cache_stats.invalidated_page_count
+    );
+    if ((written < 0) || (written >= json_output_buf_size)) {
+        return -1;
+    }
+    return (int16_t)written;
+}
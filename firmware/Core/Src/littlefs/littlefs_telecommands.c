@@ -1,15 +1,72 @@
 #include "littlefs/littlefs_telecommands.h"
 #include "littlefs/lfs.h"
 #include "littlefs/littlefs_helper.h"
+#include "littlefs/littlefs_driver.h"
+#include "littlefs/littlefs_dir_listing.h"
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 uint32_t LFS_debug_malloc_total_count = 0;
 uint32_t LFS_debug_malloc_failed_count = 0;
 uint32_t LFS_debug_free_total_count = 0;
 
 
+/// @brief Format one directory entry as a JSON key-value pair (full path: size, or full path with a
+///     trailing slash: null for directories).
+/// @return Number of characters written (excluding the null terminator), or -1 if truncated.
+static int32_t LFS_format_listing_entry_json(
+    const char root_directory[], const LFS_dir_listing_entry_t *entry,
+    char *json_output_buf, uint16_t json_output_buf_size
+) {
+    // Construct full path
+    char full_path[LFS_MAX_PATH_LENGTH * 3];
+    if (strcmp(root_directory, "/") == 0) {
+        // root_directory is exactly "/", so avoid double slash
+        snprintf(full_path, sizeof(full_path), "/%s", entry->name);
+    } else {
+        // Copy root_directory to a temporary buffer to trim any trailing slash
+        char trimmed_root[LFS_MAX_PATH_LENGTH];
+        strncpy(trimmed_root, root_directory, sizeof(trimmed_root) - 1);
+        trimmed_root[sizeof(trimmed_root) - 1] = '\0';
+
+        // Trim trailing slash if present
+        size_t len = strlen(trimmed_root);
+        if (len > 0 && trimmed_root[len - 1] == '/') {
+            trimmed_root[len - 1] = '\0';
+        }
+
+        // Combine trimmed root and filename
+        snprintf(
+            full_path, sizeof(full_path), "%s%s/%s",
+            (trimmed_root[0] == '/') ? "" : "/", // Ensure leading slash
+            trimmed_root,
+            entry->name
+        );
+    }
+
+    int written = 0;
+    if (entry->type == LFS_TYPE_REG) {
+        written = snprintf(
+            json_output_buf, json_output_buf_size,
+            "\"%s\":%" PRIu32, full_path, entry->size
+        );
+    } else if (entry->type == LFS_TYPE_DIR) {
+        written = snprintf(
+            json_output_buf, json_output_buf_size,
+            "\"%s/\":null", full_path
+        );
+    } else if (json_output_buf_size > 0) {
+        json_output_buf[0] = '\0';
+    }
+
+    if ((written < 0) || (written >= json_output_buf_size)) {
+        return -1;
+    }
+    return written;
+}
+
 int32_t LFS_list_directory_json_dict(
     const char root_directory[],
     uint16_t offset, int16_t count,
@@ -19,31 +76,25 @@ int32_t LFS_list_directory_json_dict(
         return 1;
     }
 
-    lfs_dir_t dir;
-    if (lfs_dir_open(&LFS_filesystem, &dir, root_directory) < 0) {
-        return -1;
+    // Continues the previous listing (or reads the directory's index) when possible.
+    const int32_t seek_result = LFS_dir_listing_seek(root_directory, offset);
+    if (seek_result != 0) {
+        return seek_result;
     }
 
     if (count == 0) {
         count = -1;
     }
 
-    struct lfs_info info;
-    int8_t read_result = 1;
+    LFS_dir_listing_entry_t entry;
+    int32_t read_result = 1;
     uint16_t buf_used = 0;
 
     // Start JSON object
     buf_used += snprintf(json_output_buf + buf_used, json_output_buf_size - buf_used, "{");
 
     bool first_entry = true;
-    while ((read_result = lfs_dir_read(&LFS_filesystem, &dir, &info)) > 0) {
-        if (offset > 0) {
-            offset--;
-            continue;
-        }
-        if (count == 0) {
-            break;
-        }
+    while ((count != 0) && ((read_result = LFS_dir_listing_read(&entry)) > 0)) {
         if (count > 0) {
             count--;
         }
@@ -54,46 +105,15 @@ int32_t LFS_list_directory_json_dict(
         }
         first_entry = false;
 
-        // Construct full path
-        char full_path[LFS_MAX_PATH_LENGTH * 3];
-        if (strcmp(root_directory, "/") == 0) {
-            // root_directory is exactly "/", so avoid double slash
-            snprintf(full_path, sizeof(full_path), "/%s", info.name);
-        } else {
-            // Copy root_directory to a temporary buffer to trim any trailing slash
-            char trimmed_root[LFS_MAX_PATH_LENGTH];
-            strncpy(trimmed_root, root_directory, sizeof(trimmed_root) - 1);
-            trimmed_root[sizeof(trimmed_root) - 1] = '\0';
-
-            // Trim trailing slash if present
-            size_t len = strlen(trimmed_root);
-            if (len > 0 && trimmed_root[len - 1] == '/') {
-                trimmed_root[len - 1] = '\0';
-            }
-
-            // Combine trimmed root and filename
-            snprintf(
-                full_path, sizeof(full_path), "%s%s/%s",
-                (trimmed_root[0] == '/') ? "" : "/", // Ensure leading slash
-                trimmed_root,
-                info.name
-            );
-        }
-
-        if (info.type == LFS_TYPE_REG) {
-            buf_used += snprintf(
-                json_output_buf + buf_used, json_output_buf_size - buf_used,
-                "\"%s\":%" PRIu32, full_path, info.size
-            );
-        } else if (info.type == LFS_TYPE_DIR) {
-            buf_used += snprintf(
-                json_output_buf + buf_used, json_output_buf_size - buf_used,
-                "\"%s/\":null", full_path
-            );
+        const int32_t entry_len = LFS_format_listing_entry_json(
+            root_directory, &entry, json_output_buf + buf_used, json_output_buf_size - buf_used
+        );
+        if (entry_len < 0) {
+            return -2; // Buffer overflow
         }
+        buf_used += entry_len;
 
         if (buf_used >= json_output_buf_size) {
-            lfs_dir_close(&LFS_filesystem, &dir);
             return -2; // Buffer overflow
         }
     }
@@ -101,11 +121,6 @@ int32_t LFS_list_directory_json_dict(
     // Close JSON object
     buf_used += snprintf(json_output_buf + buf_used, json_output_buf_size - buf_used, "}");
 
-    const int32_t close_result = lfs_dir_close(&LFS_filesystem, &dir);
-    if (close_result < 0) {
-        return close_result;
-    }
-
     if (read_result < 0) {
         return read_result;
     }
@@ -113,6 +128,85 @@ int32_t LFS_list_directory_json_dict(
     return 0;
 }
 
+/// @brief List a page of a directory as a JSON object, resumable with a cursor:
+///     `{"entries":{"/dir/file":size,"/dir/subdir/":null,...},"next":cursor}`.
+/// @param root_directory Directory to list.
+/// @param cursor 0 for the first page, else the "next" value of the previous page.
+/// @param count Maximum number of entries. 0 for as many as fit in the buffer.
+/// @return 0 on success, 1 if LFS is unmounted, -2 if the buffer can't hold one entry, negative
+///     LFS error codes on failure.
+/// @note "next" is null once the end of the directory is reached. Entries include "." and "..".
+/// @note Listing the next page continues from the previous one (or the directory's index), instead
+///     of re-reading every earlier entry from flash.
+int32_t LFS_list_directory_page_json(
+    const char root_directory[],
+    uint32_t cursor, uint16_t count,
+    char *json_output_buf, uint16_t json_output_buf_size
+) {
+    if (!LFS_is_lfs_mounted) {
+        return 1;
+    }
+
+    const int32_t seek_result = LFS_dir_listing_seek(root_directory, cursor);
+    if (seek_result != 0) {
+        return seek_result;
+    }
+
+    // Room for the end of the object: `},"next":4294967295}`.
+    const uint16_t end_reserved_len = 21;
+    if (json_output_buf_size <= end_reserved_len + 12) {
+        return -2;
+    }
+
+    uint16_t buf_used = snprintf(json_output_buf, json_output_buf_size, "{\"entries\":{");
+    uint16_t listed_count = 0;
+    uint8_t is_at_end = 0;
+    while ((count == 0) || (listed_count < count)) {
+        LFS_dir_listing_entry_t entry;
+        const int32_t read_result = LFS_dir_listing_read(&entry);
+        if (read_result < 0) {
+            return read_result;
+        }
+        if (read_result == 0) {
+            is_at_end = 1;
+            break;
+        }
+
+        const uint16_t separator_len = (listed_count > 0) ? 1 : 0;
+        const uint16_t available_len = json_output_buf_size - buf_used - end_reserved_len - separator_len;
+        const int32_t entry_len = LFS_format_listing_entry_json(
+            root_directory, &entry, json_output_buf + buf_used + separator_len, available_len
+        );
+        if (entry_len < 0) {
+            if (listed_count == 0) {
+                return -2;
+            }
+            // Doesn't fit: the next page starts with this entry (without re-reading the directory).
+            const int32_t unread_result = LFS_dir_listing_seek(root_directory, LFS_dir_listing_get_position() - 1);
+            if (unread_result != 0) {
+                return unread_result;
+            }
+            break;
+        }
+        if (separator_len > 0) {
+            json_output_buf[buf_used] = ',';
+        }
+        buf_used += separator_len + entry_len;
+        listed_count++;
+    }
+
+    if (is_at_end) {
+        snprintf(json_output_buf + buf_used, json_output_buf_size - buf_used, "},\"next\":null}");
+    }
+    else {
+        snprintf(
+            json_output_buf + buf_used, json_output_buf_size - buf_used,
+            "},\"next\":%" PRIu32 "}", LFS_dir_listing_get_position()
+        );
+    }
+    return 0;
+}
+
 /// @brief Generate a JSON string containing filesystem stats and debugging info.
 /// @param json_output_buf 
 /// @param json_output_buf_size 
@@ -134,6 +228,19 @@ int8_t LFS_get_filesystem_stats_json(
         return fs_used_size_blocks;
     }
 
+    // Format the per-chip bad block counts as a JSON array body (e.g., "0,2,0,1").
+    char bad_blocks_per_chip_str[LFS_NUMBER_OF_FLASH_CHIPS * 6 + 1];
+    bad_blocks_per_chip_str[0] = '\0';
+    for (uint8_t chip_number = 0; chip_number < LFS_NUMBER_OF_FLASH_CHIPS; chip_number++) {
+        snprintf(
+            &bad_blocks_per_chip_str[strlen(bad_blocks_per_chip_str)],
+            sizeof(bad_blocks_per_chip_str) - strlen(bad_blocks_per_chip_str),
+            "%s%u",
+            (chip_number == 0) ? "" : ",",
+            LFS_chip_stats[chip_number].bad_block_count
+        );
+    }
+
     // Format JSON
     const int written = snprintf(
         json_output_buf,
@@ -151,7 +258,10 @@ int8_t LFS_get_filesystem_stats_json(
             "\"block_count\":%lu,"
             "\"name_max\":%lu,"
             "\"file_max\":%lu,"
-            "\"attr_max\":%lu"
+            "\"attr_max\":%lu,"
+            "\"chip_layout\":\"%s\","
+            "\"chip_count\":%u,"
+            "\"bad_blocks_per_chip\":[%s]"
         "}",
         fs_used_size_blocks * fs_info.block_size, // fs_used_size_bytes
         fs_info.block_count * fs_info.block_size, // fs_total_size_bytes
@@ -165,7 +275,10 @@ int8_t LFS_get_filesystem_stats_json(
         fs_info.block_count,
         fs_info.name_max,
         fs_info.file_max,
-        fs_info.attr_max
+        fs_info.attr_max,
+        LFS_chip_layout_enum_to_str(LFS_chip_layout),
+        LFS_NUMBER_OF_FLASH_CHIPS,
+        bad_blocks_per_chip_str
     );
 
     // Check for truncation or encoding error
@@ -34,6 +34,7 @@ typedef struct {
     uint64_t timestamp_of_last_sync; // Last sync/flush.
     uint64_t timestamp_of_last_close; // Last close/rotate.
     uint8_t is_open;
+    uint8_t is_binary; // Holds binary records (see `log_binary.c`), instead of text lines.
 } LOG_file_context_struct_t;
 
 
@@ -56,7 +57,8 @@ static int8_t LOG_close_current_log_file(void) {
 
 
 /// @brief Opens a new timestamped log file, and sets it as the current log file.
-static int8_t LOG_open_new_log_file_and_set_as_current(void) {
+/// @param is_binary 1 for a binary log file (`.blog`), 0 for a text log file (`.log`).
+static int8_t LOG_open_new_log_file_and_set_as_current(uint8_t is_binary) {
     LFS_ensure_mounted();
 
     // Close the current log file if open.
@@ -72,7 +74,7 @@ static int8_t LOG_open_new_log_file_and_set_as_current(void) {
     char timestamp_str[20];
     TIME_get_current_utc_datetime_str_no_ms(timestamp_str, sizeof(timestamp_str)); 
     char filename[32];
-    snprintf(filename, sizeof(filename), "logs/%s.log", timestamp_str);
+    snprintf(filename, sizeof(filename), "logs/%s.%s", timestamp_str, is_binary ? "blog" : "log");
 
     // Open the new log file.
     // We use the "opencfg" variant to provide a static buffer (no malloc) so that this
@@ -90,14 +92,16 @@ static int8_t LOG_open_new_log_file_and_set_as_current(void) {
     LOG_current_log_file_ctx.timestamp_of_last_sync = TIME_get_current_unix_epoch_time_ms();
     LOG_current_log_file_ctx.timestamp_of_last_close = TIME_get_current_unix_epoch_time_ms();
     LOG_current_log_file_ctx.is_open = 1;
+    LOG_current_log_file_ctx.is_binary = is_binary;
     return 0;
 }
 
 
 
-static int8_t LOG_ensure_current_log_file_is_open() {
-    if (!LOG_current_log_file_ctx.is_open) {
-        return LOG_open_new_log_file_and_set_as_current();
+/// @brief Opens a new log file if none is open, or if the current one holds the other format.
+static int8_t LOG_ensure_current_log_file_is_open(uint8_t is_binary) {
+    if (!LOG_current_log_file_ctx.is_open || (LOG_current_log_file_ctx.is_binary != is_binary)) {
+        return LOG_open_new_log_file_and_set_as_current(is_binary);
     }
     return 0;
 }
@@ -105,9 +109,8 @@ static int8_t LOG_ensure_current_log_file_is_open() {
 
 /// @brief Writes to the current log file.
 /// @return 0 on success, negative LFS error codes on failure.
-static int8_t LOG_write_to_current_log_file(const char *msg, uint16_t msg_length) {
+static int8_t LOG_write_to_current_log_file(const void *msg, uint16_t msg_length) {
     LFS_ensure_mounted();
-    LOG_ensure_current_log_file_is_open();
 
     const lfs_ssize_t write_result = lfs_file_write(
         &LFS_filesystem, &LOG_current_log_file_ctx.file, msg, msg_length
@@ -130,17 +133,29 @@ static int8_t LOG_write_to_current_log_file(const char *msg, uint16_t msg_length
 void LOG_to_file_lazy(const char filename[], const char msg[]) {
     LFS_ensure_mounted();
 
-    LOG_ensure_current_log_file_is_open();
+    LOG_ensure_current_log_file_is_open(0);
 
     LOG_write_to_current_log_file(msg, strlen(msg));
 }
 
 
+/// @brief Write a binary log record (see `log_binary.c`) to an LFS binary log file.
+/// @param record_bytes The encoded record, starting with its length byte.
+/// @note Records are appended back to back; the length byte delimits them.
+void LOG_to_file_lazy_binary(const uint8_t record_bytes[], uint16_t record_len) {
+    LFS_ensure_mounted();
+
+    LOG_ensure_current_log_file_is_open(1);
+
+    LOG_write_to_current_log_file(record_bytes, record_len);
+}
+
+
 
 /// @brief Syncs the current log file.
 int8_t LOG_sync_current_log_file(void) {
     LFS_ensure_mounted();
-    LOG_ensure_current_log_file_is_open();
+    LOG_ensure_current_log_file_is_open(LOG_current_log_file_ctx.is_binary);
 
     LOG_current_log_file_ctx.timestamp_of_last_sync = TIME_get_current_unix_epoch_time_ms();
     return lfs_file_sync(&LFS_filesystem, &LOG_current_log_file_ctx.file);
@@ -200,6 +215,6 @@ void LOG_subtask_handle_sync_and_close_of_current_log_file() {
             "Log file closed in %ld ms", (TIME_uptime_ms() - start_time)
         );
 
-        LOG_open_new_log_file_and_set_as_current();
+        LOG_open_new_log_file_and_set_as_current(LOG_current_log_file_ctx.is_binary);
     }
 }
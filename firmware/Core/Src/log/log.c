@@ -2,7 +2,13 @@
 #include "log/log_sinks.h"
 #include "log/lazy_file_log_sink.h"
 #include "debug_tools/debug_uart.h"
+#include "log/log_args.h"
+#include "log/log_binary.h"
+#include "log/log_queue.h"
 #include "timekeeping/timekeeping.h"
+#include "comms_drivers/comms_tx.h"
+#include "rtos_tasks/rtos_logger_task.h"
+#include "stm32l4xx_hal.h"
 
 #include <complex.h>
 #include <stdint.h>
@@ -23,6 +29,26 @@
 /// @note Could be an enum in a perfect world, but using int for speed of implementation.
 uint32_t LOG_timestamp_prefix_format = 0;
 
+/// @brief Whether `LOG_message` queues messages for the logger task to format and write out.
+/// @details 0: format in the caller's context (as before the logger task existed); the logger
+///   task still writes out. 1: only capture the timestamp and arguments in the caller's context
+///   (default).
+/// @note Configurable with the configuration telecommand.
+uint32_t LOG_deferred_formatting_enabled = 1;
+
+/// @brief Bitfield of the sinks which get binary records (see `log_binary.c`) instead of text lines.
+/// @details Only `LOG_SINK_FILE` (2) and `LOG_SINK_UHF_RADIO` (1) can be binary; the umbilical
+///   UART is always text. Binary log files are named `logs/<datetime>.blog`. Decode the records
+///   with `misc_tools/binary_logs/decode_binary_logs.py`.
+/// @note Configurable with the configuration telecommand. 0 = text to every sink (default).
+uint32_t LOG_binary_format_sink_mask = 0;
+
+/// @brief Set by the logger task once it is draining the queue. Until then, messages are written out directly.
+volatile uint8_t LOG_logger_task_is_running = 0;
+
+// Set while a caller is draining the queue (single consumer).
+static uint8_t LOG_queue_drain_in_progress = 0;
+
 // Internal interfaces and variables
 #define LOG_TIMESTAMP_MAX_LENGTH 30
 #define LOG_SINK_NAME_MAX_LENGTH 10
@@ -50,27 +76,33 @@ typedef struct {
 } LOG_system_t;
 
 typedef struct {
-    // Previously stored these unused fields:
-    // LOG_system_enum_t system;
-    // LOG_severity_enum_t severity;
-    // uint32_t sink_mask;
-    char full_message[LOG_FULL_MESSAGE_MAX_LENGTH];
-} LOG_memory_entry_t;
-
+    /// @brief The record's format string (NULL if the entry was never written).
+    const char *fmt;
 
-// Allocate memory buffers
-static char LOG_timestamp_string[LOG_TIMESTAMP_MAX_LENGTH] = {0};
-static char LOG_formatted_log_message[LOG_FORMATTED_MESSAGE_MAX_LENGTH] = {0};
+    /// @brief Position of the encoded record in `LOG_memory_ring`, counted since boot (not wrapped).
+    uint32_t ring_position;
+} LOG_memory_entry_t;
 
-// Memory sink is a circular buffer up to 256 entries
-// Used for log backup in case of filesystem failure, and as independent
-// buffer storage for preparing log messages, in case of recursive calls to
-// LOG_message
+// Memory sink: the most recent log messages, as binary records (see `log_binary.c`), formatted
+// on demand when read back. Used for log backup in case of filesystem failure.
+// The 128 entries point into an 8 KiB byte ring, which holds ~200 typical records, so the ring
+// rarely runs out before the table does (an entry whose bytes were overwritten reads as empty).
 #define LOG_MEMORY_NUMBER_OF_ENTRIES 128
+#define LOG_MEMORY_RING_SIZE_BYTES 8192
 static LOG_memory_entry_t LOG_memory_table[LOG_MEMORY_NUMBER_OF_ENTRIES] = {0};
+static uint8_t LOG_memory_ring[LOG_MEMORY_RING_SIZE_BYTES] = {0};
+static uint32_t LOG_memory_ring_write_position = 0;
 // Start at last position in table, as first call to LOG_message will roll this to 0
 static uint8_t LOG_memory_index_of_current_log_entry = LOG_MEMORY_NUMBER_OF_ENTRIES - 1;
 
+// Working buffers for the text line and the binary record of the message being written out.
+// Several, used in rotation, in case of recursive calls to LOG_message (e.g., a sink logging
+// its own failure while the outer message is still being sent to the other sinks).
+#define LOG_WORKING_BUFFER_COUNT 4
+static char LOG_line_buffers[LOG_WORKING_BUFFER_COUNT][LOG_FULL_MESSAGE_MAX_LENGTH];
+static uint8_t LOG_binary_record_buffers[LOG_WORKING_BUFFER_COUNT][LOG_BINARY_RECORD_MAX_LENGTH];
+static uint8_t LOG_working_buffer_index = 0;
+
 // Severity masking.
 static const uint8_t LOG_SEVERITY_MASK_ALL = 0xFF;
 static const uint8_t LOG_SEVERITY_MASK_ALL_EXCEPT_DEBUG = (
@@ -129,6 +161,208 @@ static char LOG_context_enum_to_char(LOG_context_enum_t context) {
     }
 }
 
+/// @brief Check whether the caller is an interrupt handler (including the fault handlers).
+static uint8_t LOG_is_in_interrupt_context(void) {
+    return __get_IPSR() != 0;
+}
+
+/// @brief Capture a log message's timestamp, source and arguments into a record.
+/// @param preformat 1 to format the message now (into `packed_args`), 0 to pack the raw arguments.
+/// @details Even with `preformat` 0, the message is formatted now if its arguments do not fit.
+static void LOG_capture_record(
+    LOG_record_t *record,
+    LOG_system_enum_t system, LOG_severity_enum_t severity, uint32_t sink_mask,
+    const char fmt[], va_list ap, uint8_t preformat
+) {
+    record->fmt = fmt;
+    record->unix_epoch_time_at_last_time_resync_ms = TIME_unix_epoch_time_at_last_time_resync_ms;
+    record->ms_since_last_time_resync = TIME_uptime_ms() - TIME_system_uptime_at_last_time_resync_ms;
+    record->sync_source = (uint8_t)TIME_last_synchronization_source;
+    record->context = (uint8_t)LOG_current_log_context;
+    record->system = system;
+    record->severity = severity;
+    record->sink_mask = sink_mask;
+    record->flags = 0;
+
+    if (!preformat) {
+        va_list ap_copy;
+        va_copy(ap_copy, ap);
+        const int16_t packed_args_len = LOG_args_pack(fmt, ap_copy, record->packed_args, sizeof(record->packed_args));
+        va_end(ap_copy);
+        if (packed_args_len >= 0) {
+            record->packed_args_len = (uint16_t)packed_args_len;
+            return;
+        }
+        __atomic_fetch_add(&LOG_queue_stats.preformatted_count, 1, __ATOMIC_RELAXED);
+    }
+
+    vsnprintf((char *)record->packed_args, sizeof(record->packed_args), fmt, ap);
+    record->packed_args_len = sizeof(record->packed_args);
+    record->flags |= LOG_RECORD_FLAG_PREFORMATTED;
+}
+
+/// @brief Get the configuration of a system. Defaults to the "UNKNOWN" system.
+static LOG_system_t *LOG_get_system_config(LOG_system_enum_t system) {
+    for (uint16_t i = 0; i < LOG_NUMBER_OF_SYSTEMS; i++) {
+        if (LOG_systems[i].system == system) {
+            return &LOG_systems[i];
+        }
+    }
+    return &LOG_systems[LOG_NUMBER_OF_SYSTEMS - 1];
+}
+
+/// @brief Render a record as a text log line, including the timestamp (as of the capture) and the newline.
+/// @param line_size Lines are truncated to fit; `LOG_FULL_MESSAGE_MAX_LENGTH` (228) always fits.
+void LOG_format_record_line(const LOG_record_t *record, char line[], uint16_t line_size) {
+    const uint64_t unix_epoch_time_ms = (
+        record->unix_epoch_time_at_last_time_resync_ms + record->ms_since_last_time_resync
+    );
+    switch (LOG_timestamp_prefix_format) {
+        case 1:
+            TIME_format_utc_datetime_str(
+                line, LOG_TIMESTAMP_MAX_LENGTH,
+                unix_epoch_time_ms, (TIME_sync_source_enum_t)record->sync_source
+            );
+            break;
+        case 2:
+            TIME_format_utc_datetime_str_no_ms(line, LOG_TIMESTAMP_MAX_LENGTH, unix_epoch_time_ms);
+            break;
+        case 0:
+        default:
+            TIME_format_resync_offset_timestamp_str(
+                line, LOG_TIMESTAMP_MAX_LENGTH,
+                record->unix_epoch_time_at_last_time_resync_ms, record->ms_since_last_time_resync,
+                (TIME_sync_source_enum_t)record->sync_source
+            );
+            break;
+    }
+
+    uint16_t line_len = (uint16_t)strlen(line);
+    line_len += (uint16_t)snprintf(
+        &line[line_len], line_size - line_len,
+        " [%c:%s:%s]: ",
+        LOG_context_enum_to_char((LOG_context_enum_t)record->context),
+        LOG_get_system_config((LOG_system_enum_t)record->system)->name,
+        LOG_get_severity_name((LOG_severity_enum_t)record->severity)
+    );
+
+    // Leave room for the newline.
+    uint16_t message_size = line_size - line_len - 1;
+    if (message_size > LOG_FORMATTED_MESSAGE_MAX_LENGTH) {
+        message_size = LOG_FORMATTED_MESSAGE_MAX_LENGTH;
+    }
+    if (record->flags & LOG_RECORD_FLAG_PREFORMATTED) {
+        const uint16_t message_len = (uint16_t)strnlen((const char *)record->packed_args, message_size - 1);
+        memcpy(&line[line_len], record->packed_args, message_len);
+        line_len += message_len;
+    }
+    else {
+        line_len += LOG_args_format(
+            record->fmt, record->packed_args, record->packed_args_len, &line[line_len], message_size
+        );
+    }
+    line[line_len++] = '\n';
+    line[line_len] = '\0';
+}
+
+/// @brief Store an encoded record in the in-memory log table.
+static void LOG_store_record_in_memory(const char fmt[], const uint8_t record_bytes[], uint16_t record_len) {
+    // Records are kept contiguous: skip the end of the ring if the record doesn't fit there.
+    uint32_t position = LOG_memory_ring_write_position;
+    const uint32_t offset = position % LOG_MEMORY_RING_SIZE_BYTES;
+    if ((offset + record_len) > LOG_MEMORY_RING_SIZE_BYTES) {
+        position += LOG_MEMORY_RING_SIZE_BYTES - offset;
+    }
+    memcpy(&LOG_memory_ring[position % LOG_MEMORY_RING_SIZE_BYTES], record_bytes, record_len);
+    LOG_memory_ring_write_position = position + record_len;
+
+    // Get pointer to next storage slot in circular memory table
+    LOG_memory_index_of_current_log_entry++;
+    if (LOG_memory_index_of_current_log_entry > LOG_MEMORY_NUMBER_OF_ENTRIES - 1) {
+        LOG_memory_index_of_current_log_entry = 0;
+    }
+    LOG_memory_table[LOG_memory_index_of_current_log_entry].fmt = fmt;
+    LOG_memory_table[LOG_memory_index_of_current_log_entry].ring_position = position;
+}
+
+/// @brief Encode a captured record, store it in the in-memory log table, and send it to its sinks.
+static void LOG_emit_record(const LOG_record_t *record) {
+    // Copy what the sinks need: a sink may log (e.g., a failure), which reuses the static buffers.
+    const LOG_severity_enum_t severity = (LOG_severity_enum_t)record->severity;
+    const uint32_t sink_mask = record->sink_mask;
+    const LOG_system_t *system_config = LOG_get_system_config((LOG_system_enum_t)record->system);
+
+    char *line = LOG_line_buffers[LOG_working_buffer_index];
+    uint8_t *record_bytes = LOG_binary_record_buffers[LOG_working_buffer_index];
+    LOG_working_buffer_index = (LOG_working_buffer_index + 1) % LOG_WORKING_BUFFER_COUNT;
+
+    const int16_t record_len = LOG_binary_encode_record(record, record_bytes, LOG_BINARY_RECORD_MAX_LENGTH);
+    if (record_len > 0) {
+        LOG_store_record_in_memory(record->fmt, record_bytes, (uint16_t)record_len);
+    }
+
+    // If the subsystem is configured to emit the given severity, 
+    // send the message to each enabled sink.
+    uint8_t is_line_formatted = 0;
+    for (uint16_t i = 0; i < LOG_NUMBER_OF_SINKS; i++) {
+        const LOG_sink_t *sink_config = &LOG_sinks[i];
+        if (!(
+            sink_config->enabled
+            && (sink_config->sink & sink_mask)
+            && (severity & sink_config->severity_mask)
+            && (severity & system_config->severity_mask)
+        )) {
+            continue;
+        }
+
+        // Binary sinks get the record; the others get the text line, rendered once. Records
+        // too long for one radio packet (long string arguments) go to the radio as text.
+        const uint8_t is_binary = (
+            (sink_config->sink & LOG_binary_format_sink_mask & (LOG_SINK_FILE | LOG_SINK_UHF_RADIO))
+            && (record_len > 0)
+            && (
+                (sink_config->sink != LOG_SINK_UHF_RADIO)
+                || (record_len <= COMMS_LOG_MESSAGE_PACKET_MAX_DATA_BYTES_PER_PACKET)
+            )
+        );
+        if (!is_binary && !is_line_formatted) {
+            LOG_format_record_line(record, line, LOG_FULL_MESSAGE_MAX_LENGTH);
+            is_line_formatted = 1;
+        }
+
+        switch (sink_config->sink) {
+            case LOG_SINK_FILE:
+                // Send to log file if subsystem logging is enabled.
+                if (system_config->file_logging_enabled) {
+                    if (is_binary) {
+                        LOG_to_file_lazy_binary(record_bytes, (uint16_t)record_len);
+                    }
+                    else {
+                        LOG_to_file_lazy(system_config->log_file_path, line);
+                    }
+                }
+                break;
+            case LOG_SINK_UHF_RADIO:
+                if (is_binary) {
+                    LOG_to_uhf_radio_binary(record_bytes, (uint16_t)record_len);
+                }
+                else {
+                    LOG_to_uhf_radio(line);
+                }
+                break;
+            case LOG_SINK_UMBILICAL_UART:
+                LOG_to_umbilical_uart(line);
+                break;
+            case LOG_SINK_NONE:
+            case LOG_SINK_UNKNOWN:
+            default:
+                // Should not reach this except by memory corruption 
+                LOG_to_umbilical_uart("Error: unknown log sink\n");
+                break;
+        }
+    }
+}
+
 /// @brief Log a message to several destinations (sinks)
 /// @param system the system sending the log message (i.e., satellite subsystem)
 /// @param severity message severity
@@ -138,6 +372,14 @@ static char LOG_context_enum_to_char(LOG_context_enum_t context) {
 /// @return void
 /// @details Normally the message should not end with a newline (\n).
 ///     Exclude one or more sinks using LOG_all_sinks_except(...)
+/// @details Once the logger task runs, the caller only captures the timestamp and the raw
+///     arguments (or, with `LOG_deferred_formatting_enabled` clear, the formatted message) into a
+///     queued record, and wakes the logger task, which formats it and writes to the sinks. When
+///     the queue is full, the caller blocks until the logger task frees a slot (the scheduler is
+///     cooperative, so the logger task can't run until the caller blocks). Before the logger task
+///     starts, and from interrupts (i.e., the fault handlers, which reset right after), the message
+///     is written out directly.
+/// @note `fmt` must stay valid until the message is written out (i.e., be a string literal).
 void LOG_message(LOG_system_enum_t system, LOG_severity_enum_t severity, uint32_t sink_mask, const char fmt[], ...)
 {
     // Ensure quick return if debugging is disabled
@@ -161,88 +403,78 @@ void LOG_message(LOG_system_enum_t system, LOG_severity_enum_t severity, uint32_
         }
     }
 
-    // Get the system time.
-    switch (LOG_timestamp_prefix_format) {
-        case 0:
-            TIME_get_current_timestamp_str(LOG_timestamp_string, LOG_TIMESTAMP_MAX_LENGTH);
-            break;
-        case 1:
-            TIME_get_current_utc_datetime_str(LOG_timestamp_string, LOG_TIMESTAMP_MAX_LENGTH);
-            break;
-        case 2:
-            TIME_get_current_utc_datetime_str_no_ms(LOG_timestamp_string, LOG_TIMESTAMP_MAX_LENGTH);
-            break;
-        default:
-            TIME_get_current_timestamp_str(LOG_timestamp_string, LOG_TIMESTAMP_MAX_LENGTH);
-            break;
+    va_list ap;
+    va_start(ap, fmt);
+
+    const uint8_t is_in_interrupt_context = LOG_is_in_interrupt_context();
+    if (LOG_logger_task_is_running && !is_in_interrupt_context) {
+        // Once the logger task runs, only it writes to the sinks (a sink write can yield in a
+        // flash wait, and the sinks and working buffers are not reentrant).
+        uint32_t ticket;
+        LOG_record_t *record = LOG_queue_claim_slot(&ticket);
+        if (record == NULL) {
+            // Queue full (e.g., a telecommand which logs many lines without a yield): wait for
+            // the logger task to write some out.
+            __atomic_fetch_add(&LOG_queue_stats.full_wait_count, 1, __ATOMIC_RELAXED);
+            for (uint32_t wait_num = 0; (record == NULL) && (wait_num < LOG_QUEUE_FULL_MAX_WAIT_COUNT); wait_num++) {
+                if (TASK_logger_wait_for_queue_space() != 0) {
+                    break;
+                }
+                record = LOG_queue_claim_slot(&ticket);
+            }
+        }
+        if (record == NULL) {
+            // Can't wait (this is the logger task, or the scheduler isn't running), or the logger
+            // task is stuck: drop the message. The logger task reports how many were dropped.
+            __atomic_fetch_add(&LOG_queue_stats.dropped_count, 1, __ATOMIC_RELAXED);
+            va_end(ap);
+            TASK_logger_wake();
+            return;
+        }
+        LOG_capture_record(record, system, severity, sink_mask, fmt, ap, !LOG_deferred_formatting_enabled);
+        LOG_queue_publish_slot(ticket);
+        va_end(ap);
+        TASK_logger_wake();
+        return;
     }
 
-    // Get pointer to next storage slot in circular memory table
-    LOG_memory_index_of_current_log_entry++;
-    if (LOG_memory_index_of_current_log_entry > LOG_MEMORY_NUMBER_OF_ENTRIES - 1) {
-        LOG_memory_index_of_current_log_entry = 0;
+    // Before the logger task starts (only one task runs), and from the fault handlers (which
+    // reset right after): write out directly. Write out anything still queued first, to keep the
+    // order (unless this is an interrupt, which may have interrupted the logger task).
+    if (!is_in_interrupt_context && (LOG_queue_depth() > 0)) {
+        LOG_process_queued_messages(UINT32_MAX);
     }
-    LOG_memory_entry_t *current_log_entry = &LOG_memory_table[LOG_memory_index_of_current_log_entry];
 
-    // Prepare the message according to the requested format
-    va_list ap;
-    va_start(ap, fmt);
-    vsnprintf(LOG_formatted_log_message, LOG_FORMATTED_MESSAGE_MAX_LENGTH, fmt, ap);
+    // Static, as tasks have small stacks.
+    static LOG_record_t direct_record;
+    LOG_capture_record(&direct_record, system, severity, sink_mask, fmt, ap, 1);
     va_end(ap);
+    LOG_emit_record(&direct_record);
+}
 
-    // Prepare the full message including time and severity
-    // Defaults to "UNKNOWN" system
-    const char *severity_text = LOG_get_severity_name(severity);
-    LOG_system_t *system_config = &LOG_systems[LOG_NUMBER_OF_SYSTEMS - 1];
-    for (uint16_t i = 0; i < LOG_NUMBER_OF_SYSTEMS; i++) {
-        if (LOG_systems[i].system == system) {
-            system_config = &LOG_systems[i];
-            break;
-        }
+/// @brief Format and write out the records queued by `LOG_message`, oldest first.
+/// @param max_record_count Stop after this many records (UINT32_MAX to empty the queue).
+/// @return Number of records written out.
+/// @details Called by the logger task, and to flush the queue before a reset. Only one caller
+///     drains at a time; other callers return 0 immediately.
+uint32_t LOG_process_queued_messages(uint32_t max_record_count) {
+    if (__atomic_exchange_n(&LOG_queue_drain_in_progress, 1, __ATOMIC_ACQUIRE) != 0) {
+        return 0;
     }
-    snprintf(current_log_entry->full_message, LOG_FULL_MESSAGE_MAX_LENGTH, 
-            "%s [%c:%s:%s]: %s\n", 
-            LOG_timestamp_string, 
-            LOG_context_enum_to_char(LOG_current_log_context),
-            system_config->name, 
-            severity_text, 
-            LOG_formatted_log_message
-    );
 
-    // If the subsystem is configured to emit the given severity, 
-    // send the message to each enabled sink.
-    for (uint16_t i = 0; i < LOG_NUMBER_OF_SINKS; i++) {
-        const LOG_sink_t *sink_config = &LOG_sinks[i];
-        if (
-            sink_config->enabled
-            && (sink_config->sink & sink_mask)
-            && (severity & sink_config->severity_mask)
-            && (severity & system_config->severity_mask)
-        ) {
-            switch (sink_config->sink) {
-                case LOG_SINK_FILE:
-                    // Send to log file if subsystem logging is enabled.
-                    if (system_config->file_logging_enabled) {
-                        LOG_to_file_lazy(system_config->log_file_path, current_log_entry->full_message);
-                    }
-                    break;
-                case LOG_SINK_UHF_RADIO:
-                    LOG_to_uhf_radio(current_log_entry->full_message);
-                    break;
-                case LOG_SINK_UMBILICAL_UART:
-                    LOG_to_umbilical_uart(current_log_entry->full_message);
-                    break;
-                case LOG_SINK_NONE:
-                case LOG_SINK_UNKNOWN:
-                default:
-                    // Should not reach this except by memory corruption 
-                    LOG_to_umbilical_uart("Error: unknown log sink\n");
-                    break;
-            }
+    uint32_t processed_count = 0;
+    while (processed_count < max_record_count) {
+        const LOG_record_t *record = LOG_queue_peek_front();
+        if (record == NULL) {
+            break;
         }
+        LOG_emit_record(record);
+        LOG_queue_release_front();
+        processed_count++;
     }
-    
-    return;
+
+    __atomic_store_n(&LOG_queue_drain_in_progress, 0, __ATOMIC_RELEASE);
+    return processed_count;
 }
 
 /// @brief Returns all sinks, except the specified exceptions
@@ -491,8 +723,33 @@ uint8_t LOG_get_memory_table_index_of_most_recent_log_entry(void)
 /// @brief Get a pointer to the full text of the in-memory log message at the
 /// specified index
 /// @param index requested in-memory log message
-/// @return pointer to the full text of the log message
+/// @return pointer to the full text of the log message (empty if the entry is unused, or was
+/// overwritten in the byte ring)
+/// @note The text is rendered from the binary record into a static buffer, which the next call
+/// overwrites.
 const char *LOG_get_memory_table_full_message_at_index(uint8_t index)
 {
-    return LOG_memory_table[index].full_message;
+    static char line[LOG_FULL_MESSAGE_MAX_LENGTH];
+    static LOG_record_t decoded_record;
+    line[0] = '\0';
+
+    if (index >= LOG_MEMORY_NUMBER_OF_ENTRIES) {
+        return line;
+    }
+    const LOG_memory_entry_t *entry = &LOG_memory_table[index];
+    if (
+        (entry->fmt == NULL)
+        || ((LOG_memory_ring_write_position - entry->ring_position) > LOG_MEMORY_RING_SIZE_BYTES)
+    ) {
+        return line;
+    }
+
+    const uint32_t offset = entry->ring_position % LOG_MEMORY_RING_SIZE_BYTES;
+    const int16_t decode_result = LOG_binary_decode_record(
+        &LOG_memory_ring[offset], (uint16_t)(LOG_MEMORY_RING_SIZE_BYTES - offset), entry->fmt, &decoded_record
+    );
+    if (decode_result > 0) {
+        LOG_format_record_line(&decoded_record, line, sizeof(line));
+    }
+    return line;
 }
@@ -0,0 +1,387 @@
+// log_args.c
+// Capture the arguments of a printf-style call as raw bytes, and format them later.
+//
+// `LOG_message` callers only walk the format string and copy the argument values (strings are
+// copied, since the caller's buffers may be gone by the time the message is formatted). The
+// logger task runs `vsnprintf`-equivalent formatting from the packed bytes, one conversion at a
+// time, with the same format string. Kept free of RTOS/HAL calls, so that the host build can use it.
+//
+// Packed layout: each value in the order of the format string, at its native size and without
+// padding; `*` widths/precisions are ints; strings are copied with their null terminator.
+
+#include "log/log_args.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// Longest conversion specification which is formatted (e.g., "%-+012.34llx" is 12).
+#define LOG_ARGS_MAX_SPEC_LENGTH 24
+
+/// @brief Find the next conversion specification in a printf format string.
+/// @param fmt The format string.
+/// @param fmt_index Index to start searching from; updated to the index after the specification.
+/// @param conversion_out The specification found.
+/// @return 1 if a specification was found, 0 at the end of the format string.
+uint8_t LOG_args_next_conversion(const char fmt[], uint16_t *fmt_index, LOG_arg_conversion_t *conversion_out) {
+    uint16_t i = *fmt_index;
+    while ((fmt[i] != '\0') && (fmt[i] != '%')) {
+        i++;
+    }
+    if (fmt[i] == '\0') {
+        *fmt_index = i;
+        return 0;
+    }
+
+    memset(conversion_out, 0, sizeof(LOG_arg_conversion_t));
+    conversion_out->start_index = i;
+    i++;
+
+    // Flags.
+    while ((fmt[i] != '\0') && (strchr("-+ #0'", fmt[i]) != NULL)) {
+        i++;
+    }
+
+    // Width.
+    if (fmt[i] == '*') {
+        conversion_out->star_count++;
+        i++;
+    }
+    while ((fmt[i] >= '0') && (fmt[i] <= '9')) {
+        i++;
+    }
+
+    // Precision.
+    if (fmt[i] == '.') {
+        i++;
+        if (fmt[i] == '*') {
+            conversion_out->star_count++;
+            conversion_out->has_star_precision = 1;
+            i++;
+        }
+        else {
+            conversion_out->has_fixed_precision = 1;
+            while ((fmt[i] >= '0') && (fmt[i] <= '9')) {
+                conversion_out->precision = (uint16_t)((conversion_out->precision * 10) + (fmt[i] - '0'));
+                i++;
+            }
+        }
+    }
+
+    // Length modifier.
+    char length_modifier = '\0';
+    uint8_t length_modifier_is_doubled = 0;
+    if ((fmt[i] == 'h') || (fmt[i] == 'l') || (fmt[i] == 'j') || (fmt[i] == 'z') || (fmt[i] == 't') || (fmt[i] == 'L')) {
+        length_modifier = fmt[i];
+        i++;
+        if (((length_modifier == 'h') || (length_modifier == 'l')) && (fmt[i] == length_modifier)) {
+            length_modifier_is_doubled = 1;
+            i++;
+        }
+    }
+
+    // Conversion.
+    const char conversion = fmt[i];
+    if (conversion != '\0') {
+        i++;
+    }
+    switch (conversion) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            conversion_out->is_signed = (conversion == 'd') || (conversion == 'i');
+            if ((length_modifier == 'l') && !length_modifier_is_doubled) {
+                conversion_out->type = LOG_ARG_TYPE_LONG;
+            }
+            else if ((length_modifier == 'l') || (length_modifier == 'j')) {
+                conversion_out->type = LOG_ARG_TYPE_LONG_LONG;
+            }
+            else if ((length_modifier == 'z') || (length_modifier == 't')) {
+                conversion_out->type = LOG_ARG_TYPE_SIZE;
+            }
+            else {
+                // No modifier, 'h' and 'hh' are all promoted to int.
+                conversion_out->type = LOG_ARG_TYPE_INT;
+            }
+            break;
+        case 'c':
+            conversion_out->is_signed = 1;
+            conversion_out->type = LOG_ARG_TYPE_INT;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            conversion_out->type = (length_modifier == 'L') ? LOG_ARG_TYPE_LONG_DOUBLE : LOG_ARG_TYPE_DOUBLE;
+            break;
+        case 'p':
+            conversion_out->type = LOG_ARG_TYPE_POINTER;
+            break;
+        case 's':
+            conversion_out->type = LOG_ARG_TYPE_STRING;
+            break;
+        case '%':
+            conversion_out->type = LOG_ARG_TYPE_NONE;
+            break;
+        default:
+            conversion_out->type = LOG_ARG_TYPE_UNSUPPORTED;
+            break;
+    }
+
+    conversion_out->length = (uint8_t)((i - conversion_out->start_index) < UINT8_MAX ? (i - conversion_out->start_index) : UINT8_MAX);
+    *fmt_index = i;
+    return 1;
+}
+
+/// @brief Get the size of a packed (non-string) value: the native size of its type, or 0.
+uint8_t LOG_args_packed_size(LOG_arg_type_enum_t type) {
+    switch (type) {
+        case LOG_ARG_TYPE_INT: return sizeof(int);
+        case LOG_ARG_TYPE_LONG: return sizeof(long);
+        case LOG_ARG_TYPE_LONG_LONG: return sizeof(long long);
+        case LOG_ARG_TYPE_SIZE: return sizeof(size_t);
+        case LOG_ARG_TYPE_DOUBLE: return sizeof(double);
+        case LOG_ARG_TYPE_LONG_DOUBLE: return sizeof(long double);
+        case LOG_ARG_TYPE_POINTER: return sizeof(void *);
+        default: return 0;
+    }
+}
+
+/// @brief Copy the arguments of a printf-style call into a buffer.
+/// @param fmt The format string. Must outlive the packed buffer (in practice, a string literal).
+/// @param ap The arguments. Consumed.
+/// @param packed_args Destination buffer.
+/// @param packed_args_size Size of the destination buffer.
+/// @return Number of bytes used, or -1 if the arguments do not fit, or the format string has a
+///     conversion which is not supported (`%n`). The caller must then format the message directly.
+int16_t LOG_args_pack(const char fmt[], va_list ap, uint8_t packed_args[], uint16_t packed_args_size) {
+    uint16_t packed_len = 0;
+    uint16_t fmt_index = 0;
+    LOG_arg_conversion_t conversion;
+
+    while (LOG_args_next_conversion(fmt, &fmt_index, &conversion)) {
+        int star_values[2] = {0, 0};
+        for (uint8_t star_num = 0; star_num < conversion.star_count; star_num++) {
+            star_values[star_num] = va_arg(ap, int);
+            if ((packed_len + sizeof(int)) > packed_args_size) {
+                return -1;
+            }
+            memcpy(&packed_args[packed_len], &star_values[star_num], sizeof(int));
+            packed_len += sizeof(int);
+        }
+
+        const uint8_t value_size = LOG_args_packed_size(conversion.type);
+        if ((value_size > 0) && ((packed_len + value_size) > packed_args_size)) {
+            return -1;
+        }
+
+        switch (conversion.type) {
+            case LOG_ARG_TYPE_NONE:
+                break;
+            case LOG_ARG_TYPE_INT: {
+                const int value = va_arg(ap, int);
+                memcpy(&packed_args[packed_len], &value, value_size);
+                break;
+            }
+            case LOG_ARG_TYPE_LONG: {
+                const long value = va_arg(ap, long);
+                memcpy(&packed_args[packed_len], &value, value_size);
+                break;
+            }
+            case LOG_ARG_TYPE_LONG_LONG: {
+                const long long value = va_arg(ap, long long);
+                memcpy(&packed_args[packed_len], &value, value_size);
+                break;
+            }
+            case LOG_ARG_TYPE_SIZE: {
+                const size_t value = va_arg(ap, size_t);
+                memcpy(&packed_args[packed_len], &value, value_size);
+                break;
+            }
+            case LOG_ARG_TYPE_DOUBLE: {
+                const double value = va_arg(ap, double);
+                memcpy(&packed_args[packed_len], &value, value_size);
+                break;
+            }
+            case LOG_ARG_TYPE_LONG_DOUBLE: {
+                const long double value = va_arg(ap, long double);
+                memcpy(&packed_args[packed_len], &value, value_size);
+                break;
+            }
+            case LOG_ARG_TYPE_POINTER: {
+                const void *value = va_arg(ap, void *);
+                memcpy(&packed_args[packed_len], &value, value_size);
+                break;
+            }
+            case LOG_ARG_TYPE_STRING: {
+                const char *value = va_arg(ap, const char *);
+                if (value == NULL) {
+                    value = "(null)";
+                }
+                // A precision limits how much of the string is read (it may not be terminated).
+                size_t max_len = SIZE_MAX;
+                if (conversion.has_fixed_precision) {
+                    max_len = conversion.precision;
+                }
+                else if (conversion.has_star_precision && (star_values[conversion.star_count - 1] >= 0)) {
+                    max_len = (size_t)star_values[conversion.star_count - 1];
+                }
+                size_t str_len = 0;
+                while ((str_len < max_len) && (value[str_len] != '\0')) {
+                    str_len++;
+                }
+                if ((packed_len + str_len + 1) > packed_args_size) {
+                    return -1;
+                }
+                memcpy(&packed_args[packed_len], value, str_len);
+                packed_args[packed_len + str_len] = '\0';
+                packed_len += (uint16_t)(str_len + 1);
+                break;
+            }
+            case LOG_ARG_TYPE_UNSUPPORTED:
+            default:
+                return -1;
+        }
+        packed_len += value_size;
+    }
+    return (int16_t)packed_len;
+}
+
+/// @brief Format a message from a format string and the arguments packed by `LOG_args_pack`.
+/// @param fmt The format string given to `LOG_args_pack`.
+/// @param packed_args The packed arguments.
+/// @param packed_args_len The length returned by `LOG_args_pack`.
+/// @param dest Destination buffer; always null-terminated (if dest_size > 0).
+/// @param dest_size Size of the destination buffer.
+/// @return Length of the formatted message (truncated to fit), excluding the null terminator.
+/// @note The output is the same as `vsnprintf` with the original arguments.
+uint16_t LOG_args_format(
+    const char fmt[], const uint8_t packed_args[], uint16_t packed_args_len,
+    char dest[], uint16_t dest_size
+) {
+    if (dest_size == 0) {
+        return 0;
+    }
+    uint16_t dest_len = 0;
+    uint16_t packed_index = 0;
+    uint16_t fmt_index = 0;
+    uint16_t literal_start_index = 0;
+    LOG_arg_conversion_t conversion;
+    char spec[LOG_ARGS_MAX_SPEC_LENGTH + 1];
+
+    while (1) {
+        const uint8_t found = LOG_args_next_conversion(fmt, &fmt_index, &conversion);
+
+        // Copy the literal text before the conversion (or up to the end).
+        const uint16_t literal_end_index = found ? conversion.start_index : fmt_index;
+        const uint16_t literal_len = literal_end_index - literal_start_index;
+        const uint16_t literal_copy_len = (literal_len < (dest_size - 1 - dest_len)) ? literal_len : (dest_size - 1 - dest_len);
+        memcpy(&dest[dest_len], &fmt[literal_start_index], literal_copy_len);
+        dest_len += literal_copy_len;
+        literal_start_index = fmt_index;
+        if (!found || (dest_len >= (dest_size - 1))) {
+            break;
+        }
+
+        if (conversion.type == LOG_ARG_TYPE_NONE) {
+            dest[dest_len++] = '%';
+            continue;
+        }
+        if ((conversion.type == LOG_ARG_TYPE_UNSUPPORTED) || (conversion.length > LOG_ARGS_MAX_SPEC_LENGTH)) {
+            break;
+        }
+        memcpy(spec, &fmt[conversion.start_index], conversion.length);
+        spec[conversion.length] = '\0';
+
+        int star_values[2] = {0, 0};
+        for (uint8_t star_num = 0; star_num < conversion.star_count; star_num++) {
+            if ((packed_index + sizeof(int)) > packed_args_len) {
+                break;
+            }
+            memcpy(&star_values[star_num], &packed_args[packed_index], sizeof(int));
+            packed_index += sizeof(int);
+        }
+        const uint8_t value_size = LOG_args_packed_size(conversion.type);
+        if ((packed_index + value_size) > packed_args_len) {
+            break;
+        }
+
+        char *out = &dest[dest_len];
+        const size_t out_size = dest_size - dest_len;
+        int written = 0;
+
+        // snprintf with 0, 1 or 2 `*` ints before the value.
+        #define LOG_ARGS_SNPRINTF(value) ( \
+            (conversion.star_count == 0) ? snprintf(out, out_size, spec, value) \
+            : (conversion.star_count == 1) ? snprintf(out, out_size, spec, star_values[0], value) \
+            : snprintf(out, out_size, spec, star_values[0], star_values[1], value) \
+        )
+        switch (conversion.type) {
+            case LOG_ARG_TYPE_INT: {
+                int value;
+                memcpy(&value, &packed_args[packed_index], value_size);
+                written = LOG_ARGS_SNPRINTF(value);
+                break;
+            }
+            case LOG_ARG_TYPE_LONG: {
+                long value;
+                memcpy(&value, &packed_args[packed_index], value_size);
+                written = LOG_ARGS_SNPRINTF(value);
+                break;
+            }
+            case LOG_ARG_TYPE_LONG_LONG: {
+                long long value;
+                memcpy(&value, &packed_args[packed_index], value_size);
+                written = LOG_ARGS_SNPRINTF(value);
+                break;
+            }
+            case LOG_ARG_TYPE_SIZE: {
+                size_t value;
+                memcpy(&value, &packed_args[packed_index], value_size);
+                written = LOG_ARGS_SNPRINTF(value);
+                break;
+            }
+            case LOG_ARG_TYPE_DOUBLE: {
+                double value;
+                memcpy(&value, &packed_args[packed_index], value_size);
+                written = LOG_ARGS_SNPRINTF(value);
+                break;
+            }
+            case LOG_ARG_TYPE_LONG_DOUBLE: {
+                long double value;
+                memcpy(&value, &packed_args[packed_index], value_size);
+                written = LOG_ARGS_SNPRINTF(value);
+                break;
+            }
+            case LOG_ARG_TYPE_POINTER: {
+                void *value;
+                memcpy(&value, &packed_args[packed_index], value_size);
+                written = LOG_ARGS_SNPRINTF(value);
+                break;
+            }
+            case LOG_ARG_TYPE_STRING: {
+                const char *value = (const char *)&packed_args[packed_index];
+                const size_t str_len = strnlen(value, packed_args_len - packed_index);
+                if ((packed_index + str_len) >= packed_args_len) {
+                    written = -1; // Not terminated: corrupt record.
+                    break;
+                }
+                written = LOG_ARGS_SNPRINTF(value);
+                packed_index += (uint16_t)(str_len + 1);
+                break;
+            }
+            default:
+                written = -1;
+                break;
+        }
+        #undef LOG_ARGS_SNPRINTF
+
+        if (written < 0) {
+            break;
+        }
+        packed_index += value_size;
+        if ((size_t)written >= out_size) {
+            dest_len = dest_size - 1;
+            break;
+        }
+        dest_len += (uint16_t)written;
+    }
+
+    dest[dest_len] = '\0';
+    return dest_len;
+}
@@ -0,0 +1,444 @@
+// log_binary.c
+// Compact binary encoding of log records, for the in-memory log table and the sinks which are set
+// to binary (see `LOG_binary_format_sink_mask`). Kept free of RTOS/HAL calls, so that the host
+// build can use it.
+//
+// Instead of the rendered text, a record holds an ID of its format string (a hash, which the
+// ground looks up in the table generated by `firmware_checks/_05_check_log_format_table.py`), the
+// capture timestamp, and the printf arguments as varints. A typical record is 15-30 bytes, vs.
+// 60-150 bytes of text.
+//
+// Record layout (integers are little-endian; varints are LEB128, signed ones zigzag-encoded):
+//   [0]     Length of the rest of the record (1-255).
+//   [1..4]  Format ID: 32-bit FNV-1a hash of the format string.
+//   [5]     Bits 0-3: system (bit number of LOG_system_enum_t). Bits 4-6: severity (bit number of
+//           LOG_severity_enum_t). Bit 7: preformatted (the args are the rendered message).
+//   [6]     Bits 0-2: time sync source. Bits 3-4: log context.
+//   varint  Unix epoch time of the last time resync, in ms.
+//   varint  ms since the last time resync.
+//   args    For each conversion in the format string: each `*` width/precision (signed varint),
+//           then the value: d/i/c signed varint; u/o/x/X/p unsigned varint; floating point as an
+//           8-byte IEEE 754 double; strings as a varint length and the bytes (no terminator).
+//           If preformatted: the rendered message, as a string.
+
+#include "log/log_binary.h"
+#include "log/log_args.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define LOG_BINARY_FNV_OFFSET_BASIS 2166136261u
+#define LOG_BINARY_FNV_PRIME 16777619u
+
+/// @brief Get the ID of a format string, as stored in binary records.
+/// @details 32-bit FNV-1a over the bytes of the string (without the terminator). The ground-side
+///     table generator uses the same hash, and checks that no two format strings collide.
+uint32_t LOG_binary_format_id(const char fmt[]) {
+    uint32_t hash = LOG_BINARY_FNV_OFFSET_BASIS;
+    for (const uint8_t *byte = (const uint8_t *)fmt; *byte != '\0'; byte++) {
+        hash ^= *byte;
+        hash *= LOG_BINARY_FNV_PRIME;
+    }
+    return hash;
+}
+
+/// @brief Get the format ID of an encoded record.
+uint32_t LOG_binary_record_format_id(const uint8_t record_bytes[]) {
+    return (
+        (uint32_t)record_bytes[1]
+        | ((uint32_t)record_bytes[2] << 8)
+        | ((uint32_t)record_bytes[3] << 16)
+        | ((uint32_t)record_bytes[4] << 24)
+    );
+}
+
+/// @brief Append an unsigned LEB128 varint.
+/// @return 0 on success, 1 if it does not fit.
+static uint8_t LOG_binary_put_varint(uint8_t dest[], uint16_t dest_size, uint16_t *len, uint64_t value) {
+    do {
+        if (*len >= dest_size) {
+            return 1;
+        }
+        uint8_t byte = (uint8_t)(value & 0x7F);
+        value >>= 7;
+        if (value != 0) {
+            byte |= 0x80;
+        }
+        dest[(*len)++] = byte;
+    } while (value != 0);
+    return 0;
+}
+
+static uint8_t LOG_binary_put_signed_varint(uint8_t dest[], uint16_t dest_size, uint16_t *len, int64_t value) {
+    const uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    return LOG_binary_put_varint(dest, dest_size, len, zigzag);
+}
+
+static uint8_t LOG_binary_put_bytes(uint8_t dest[], uint16_t dest_size, uint16_t *len, const void *src, uint16_t src_len) {
+    if ((*len + src_len) > dest_size) {
+        return 1;
+    }
+    memcpy(&dest[*len], src, src_len);
+    *len += src_len;
+    return 0;
+}
+
+/// @brief Read an unsigned LEB128 varint.
+/// @return 0 on success, 1 if it runs past the end (or is longer than 10 bytes).
+static uint8_t LOG_binary_get_varint(const uint8_t src[], uint16_t src_len, uint16_t *index, uint64_t *value_out) {
+    uint64_t value = 0;
+    for (uint8_t shift = 0; shift < 70; shift += 7) {
+        if (*index >= src_len) {
+            return 1;
+        }
+        const uint8_t byte = src[(*index)++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value_out = value;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint8_t LOG_binary_get_signed_varint(const uint8_t src[], uint16_t src_len, uint16_t *index, int64_t *value_out) {
+    uint64_t zigzag;
+    if (LOG_binary_get_varint(src, src_len, index, &zigzag) != 0) {
+        return 1;
+    }
+    *value_out = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+    return 0;
+}
+
+/// @brief Append a string, as a varint length and the bytes.
+static uint8_t LOG_binary_put_string(uint8_t dest[], uint16_t dest_size, uint16_t *len, const char str[], uint16_t str_len) {
+    if (LOG_binary_put_varint(dest, dest_size, len, str_len) != 0) {
+        return 1;
+    }
+    return LOG_binary_put_bytes(dest, dest_size, len, str, str_len);
+}
+
+/// @brief Append a record's packed arguments, varint-encoded.
+/// @return 0 on success, 1 if they do not fit (or the packed arguments are corrupt).
+static uint8_t LOG_binary_put_args(const LOG_record_t *record, uint8_t dest[], uint16_t dest_size, uint16_t *len) {
+    uint16_t packed_index = 0;
+    uint16_t fmt_index = 0;
+    LOG_arg_conversion_t conversion;
+
+    while (LOG_args_next_conversion(record->fmt, &fmt_index, &conversion)) {
+        for (uint8_t star_num = 0; star_num < conversion.star_count; star_num++) {
+            int star_value;
+            if ((packed_index + sizeof(int)) > record->packed_args_len) {
+                return 1;
+            }
+            memcpy(&star_value, &record->packed_args[packed_index], sizeof(int));
+            packed_index += sizeof(int);
+            if (LOG_binary_put_signed_varint(dest, dest_size, len, star_value) != 0) {
+                return 1;
+            }
+        }
+
+        const uint8_t value_size = LOG_args_packed_size(conversion.type);
+        if ((packed_index + value_size) > record->packed_args_len) {
+            return 1;
+        }
+        const uint8_t *value_ptr = &record->packed_args[packed_index];
+        uint8_t put_result = 0;
+        switch (conversion.type) {
+            case LOG_ARG_TYPE_NONE:
+                break;
+            case LOG_ARG_TYPE_INT: {
+                int value;
+                memcpy(&value, value_ptr, sizeof(value));
+                put_result = conversion.is_signed
+                    ? LOG_binary_put_signed_varint(dest, dest_size, len, value)
+                    : LOG_binary_put_varint(dest, dest_size, len, (unsigned int)value);
+                break;
+            }
+            case LOG_ARG_TYPE_LONG: {
+                long value;
+                memcpy(&value, value_ptr, sizeof(value));
+                put_result = conversion.is_signed
+                    ? LOG_binary_put_signed_varint(dest, dest_size, len, value)
+                    : LOG_binary_put_varint(dest, dest_size, len, (unsigned long)value);
+                break;
+            }
+            case LOG_ARG_TYPE_LONG_LONG: {
+                long long value;
+                memcpy(&value, value_ptr, sizeof(value));
+                put_result = conversion.is_signed
+                    ? LOG_binary_put_signed_varint(dest, dest_size, len, value)
+                    : LOG_binary_put_varint(dest, dest_size, len, (unsigned long long)value);
+                break;
+            }
+            case LOG_ARG_TYPE_SIZE: {
+                size_t value;
+                memcpy(&value, value_ptr, sizeof(value));
+                put_result = LOG_binary_put_varint(dest, dest_size, len, value);
+                break;
+            }
+            case LOG_ARG_TYPE_POINTER: {
+                void *value;
+                memcpy(&value, value_ptr, sizeof(value));
+                put_result = LOG_binary_put_varint(dest, dest_size, len, (uintptr_t)value);
+                break;
+            }
+            case LOG_ARG_TYPE_DOUBLE: {
+                double value;
+                memcpy(&value, value_ptr, sizeof(value));
+                put_result = LOG_binary_put_bytes(dest, dest_size, len, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_TYPE_LONG_DOUBLE: {
+                long double long_value;
+                memcpy(&long_value, value_ptr, sizeof(long_value));
+                const double value = (double)long_value;
+                put_result = LOG_binary_put_bytes(dest, dest_size, len, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_TYPE_STRING: {
+                const char *value = (const char *)value_ptr;
+                const size_t str_len = strnlen(value, record->packed_args_len - packed_index);
+                if ((packed_index + str_len) >= record->packed_args_len) {
+                    return 1;
+                }
+                put_result = LOG_binary_put_string(dest, dest_size, len, value, (uint16_t)str_len);
+                packed_index += (uint16_t)(str_len + 1);
+                break;
+            }
+            default:
+                return 1;
+        }
+        if (put_result != 0) {
+            return 1;
+        }
+        packed_index += value_size;
+    }
+    return 0;
+}
+
+/// @brief Encode a captured log record.
+/// @param record The record, as captured by `LOG_message`.
+/// @param dest Destination buffer (`LOG_BINARY_RECORD_MAX_LENGTH` is always enough).
+/// @param dest_size Size of the destination buffer.
+/// @return Length of the encoded record (including the length byte), or -1 if it does not fit.
+/// @note If the varint-encoded arguments are too long, the record is encoded preformatted.
+int16_t LOG_binary_encode_record(const LOG_record_t *record, uint8_t dest[], uint16_t dest_size) {
+    if (dest_size > LOG_BINARY_RECORD_MAX_LENGTH) {
+        dest_size = LOG_BINARY_RECORD_MAX_LENGTH;
+    }
+    if (dest_size < LOG_BINARY_RECORD_FIXED_HEADER_LENGTH) {
+        return -1;
+    }
+
+    const uint32_t format_id = LOG_binary_format_id(record->fmt);
+    dest[1] = (uint8_t)format_id;
+    dest[2] = (uint8_t)(format_id >> 8);
+    dest[3] = (uint8_t)(format_id >> 16);
+    dest[4] = (uint8_t)(format_id >> 24);
+    const uint8_t system_num = (record->system != 0) ? (uint8_t)__builtin_ctz(record->system) : 0x0F;
+    const uint8_t severity_num = (record->severity != 0) ? (uint8_t)__builtin_ctz(record->severity) : 0x07;
+    dest[5] = (uint8_t)((system_num & 0x0F) | ((severity_num & 0x07) << 4));
+    dest[6] = (uint8_t)((record->sync_source & 0x07) | ((record->context & 0x03) << 3));
+
+    uint16_t len = LOG_BINARY_RECORD_FIXED_HEADER_LENGTH;
+    if (
+        (LOG_binary_put_varint(dest, dest_size, &len, record->unix_epoch_time_at_last_time_resync_ms) != 0)
+        || (LOG_binary_put_varint(dest, dest_size, &len, record->ms_since_last_time_resync) != 0)
+    ) {
+        return -1;
+    }
+    const uint16_t args_start = len;
+
+    if (!(record->flags & LOG_RECORD_FLAG_PREFORMATTED)) {
+        if (LOG_binary_put_args(record, dest, dest_size, &len) == 0) {
+            dest[0] = (uint8_t)(len - 1);
+            return (int16_t)len;
+        }
+
+        // Too long as varints (rare: e.g., many large numbers): store the rendered message instead.
+        char message[LOG_FORMATTED_MESSAGE_MAX_LENGTH];
+        const uint16_t message_len = LOG_args_format(
+            record->fmt, record->packed_args, record->packed_args_len, message, sizeof(message)
+        );
+        len = args_start;
+        if (LOG_binary_put_string(dest, dest_size, &len, message, message_len) != 0) {
+            return -1;
+        }
+    }
+    else {
+        const char *message = (const char *)record->packed_args;
+        const uint16_t message_len = (uint16_t)strnlen(message, LOG_FORMATTED_MESSAGE_MAX_LENGTH - 1);
+        if (LOG_binary_put_string(dest, dest_size, &len, message, message_len) != 0) {
+            return -1;
+        }
+    }
+    dest[5] |= 0x80;
+    dest[0] = (uint8_t)(len - 1);
+    return (int16_t)len;
+}
+
+/// @brief Read a string (varint length and bytes) into the packed arguments, null-terminated.
+static uint8_t LOG_binary_get_string(
+    const uint8_t src[], uint16_t src_len, uint16_t *index, LOG_record_t *record_out, uint16_t *packed_len
+) {
+    uint64_t str_len;
+    if (LOG_binary_get_varint(src, src_len, index, &str_len) != 0) {
+        return 1;
+    }
+    if (((*index + str_len) > src_len) || ((*packed_len + str_len + 1) > sizeof(record_out->packed_args))) {
+        return 1;
+    }
+    memcpy(&record_out->packed_args[*packed_len], &src[*index], (size_t)str_len);
+    record_out->packed_args[*packed_len + str_len] = '\0';
+    *index += (uint16_t)str_len;
+    *packed_len += (uint16_t)(str_len + 1);
+    return 0;
+}
+
+/// @brief Decode a binary record back into a record which `LOG_args_format` can render.
+/// @param src The encoded record, starting at its length byte.
+/// @param src_len Number of bytes available at `src`.
+/// @param fmt The format string with the record's format ID.
+/// @param record_out The decoded record.
+/// @return Length of the encoded record (including the length byte), or -1 if it is corrupt, or
+///     `fmt` does not have the record's format ID.
+int16_t LOG_binary_decode_record(
+    const uint8_t src[], uint16_t src_len, const char fmt[], LOG_record_t *record_out
+) {
+    if ((src_len < LOG_BINARY_RECORD_FIXED_HEADER_LENGTH) || ((uint16_t)(src[0] + 1) > src_len)) {
+        return -1;
+    }
+    const uint16_t record_len = (uint16_t)(src[0] + 1);
+    if (LOG_binary_record_format_id(src) != LOG_binary_format_id(fmt)) {
+        return -1;
+    }
+
+    memset(record_out, 0, offsetof(LOG_record_t, packed_args));
+    record_out->fmt = fmt;
+    record_out->system = 1u << (src[5] & 0x0F);
+    record_out->severity = 1u << ((src[5] >> 4) & 0x07);
+    record_out->sync_source = src[6] & 0x07;
+    record_out->context = (src[6] >> 3) & 0x03;
+
+    uint16_t index = LOG_BINARY_RECORD_FIXED_HEADER_LENGTH;
+    uint64_t ms_since_resync;
+    if (
+        (LOG_binary_get_varint(src, record_len, &index, &record_out->unix_epoch_time_at_last_time_resync_ms) != 0)
+        || (LOG_binary_get_varint(src, record_len, &index, &ms_since_resync) != 0)
+    ) {
+        return -1;
+    }
+    record_out->ms_since_last_time_resync = (uint32_t)ms_since_resync;
+
+    uint16_t packed_len = 0;
+    if (src[5] & 0x80) {
+        if (LOG_binary_get_string(src, record_len, &index, record_out, &packed_len) != 0) {
+            return -1;
+        }
+        record_out->flags = LOG_RECORD_FLAG_PREFORMATTED;
+        record_out->packed_args_len = packed_len;
+        return (int16_t)record_len;
+    }
+
+    uint16_t fmt_index = 0;
+    LOG_arg_conversion_t conversion;
+    while (LOG_args_next_conversion(fmt, &fmt_index, &conversion)) {
+        for (uint8_t star_num = 0; star_num < conversion.star_count; star_num++) {
+            int64_t star_value;
+            if (
+                (LOG_binary_get_signed_varint(src, record_len, &index, &star_value) != 0)
+                || ((packed_len + sizeof(int)) > sizeof(record_out->packed_args))
+            ) {
+                return -1;
+            }
+            const int value = (int)star_value;
+            memcpy(&record_out->packed_args[packed_len], &value, sizeof(value));
+            packed_len += sizeof(int);
+        }
+
+        const uint8_t value_size = LOG_args_packed_size(conversion.type);
+        if ((packed_len + value_size) > sizeof(record_out->packed_args)) {
+            return -1;
+        }
+        uint8_t *value_ptr = &record_out->packed_args[packed_len];
+        uint64_t unsigned_value = 0;
+        int64_t signed_value = 0;
+        uint8_t get_result = 0;
+        if (
+            (conversion.type == LOG_ARG_TYPE_INT) || (conversion.type == LOG_ARG_TYPE_LONG)
+            || (conversion.type == LOG_ARG_TYPE_LONG_LONG)
+        ) {
+            get_result = conversion.is_signed
+                ? LOG_binary_get_signed_varint(src, record_len, &index, &signed_value)
+                : LOG_binary_get_varint(src, record_len, &index, &unsigned_value);
+            if (conversion.is_signed) {
+                unsigned_value = (uint64_t)signed_value;
+            }
+        }
+        else if ((conversion.type == LOG_ARG_TYPE_SIZE) || (conversion.type == LOG_ARG_TYPE_POINTER)) {
+            get_result = LOG_binary_get_varint(src, record_len, &index, &unsigned_value);
+        }
+        if (get_result != 0) {
+            return -1;
+        }
+
+        switch (conversion.type) {
+            case LOG_ARG_TYPE_NONE:
+                break;
+            case LOG_ARG_TYPE_INT: {
+                const unsigned int value = (unsigned int)unsigned_value;
+                memcpy(value_ptr, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_TYPE_LONG: {
+                const unsigned long value = (unsigned long)unsigned_value;
+                memcpy(value_ptr, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_TYPE_LONG_LONG: {
+                const unsigned long long value = (unsigned long long)unsigned_value;
+                memcpy(value_ptr, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_TYPE_SIZE: {
+                const size_t value = (size_t)unsigned_value;
+                memcpy(value_ptr, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_TYPE_POINTER: {
+                void *value = (void *)(uintptr_t)unsigned_value;
+                memcpy(value_ptr, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_TYPE_DOUBLE:
+            case LOG_ARG_TYPE_LONG_DOUBLE: {
+                double value;
+                if ((index + sizeof(value)) > record_len) {
+                    return -1;
+                }
+                memcpy(&value, &src[index], sizeof(value));
+                index += sizeof(value);
+                if (conversion.type == LOG_ARG_TYPE_DOUBLE) {
+                    memcpy(value_ptr, &value, sizeof(value));
+                }
+                else {
+                    const long double long_value = value;
+                    memcpy(value_ptr, &long_value, sizeof(long_value));
+                }
+                break;
+            }
+            case LOG_ARG_TYPE_STRING:
+                if (LOG_binary_get_string(src, record_len, &index, record_out, &packed_len) != 0) {
+                    return -1;
+                }
+                break;
+            default:
+                return -1;
+        }
+        packed_len += value_size;
+    }
+
+    record_out->packed_args_len = packed_len;
+    return (int16_t)record_len;
+}
@@ -0,0 +1,104 @@
+// log_queue.c
+// Bounded lock-free queue of log records, between `LOG_message` callers (any task) and the logger
+// task (the only consumer). Kept free of RTOS/HAL calls, so that the host build can use it.
+//
+// Each slot has a sequence number (as in D. Vyukov's bounded MPMC queue). A producer claims the
+// slot at `enqueue_position` with a compare-and-swap, fills the record in place, then publishes it
+// by advancing the slot's sequence. The consumer only reads a slot once it is published, so a
+// producer which is interrupted between claim and publish delays the consumer, but never blocks
+// other producers. No critical sections, so no interrupt latency is added.
+
+#include "log/log_queue.h"
+
+#include <stddef.h>
+
+typedef struct {
+    /// @brief The slot's sequence number, minus the slot's index (so that zero-initialized is the
+    ///     empty state: slot i is free for the enqueue at position i).
+    /// @details Free for the enqueue at position p: p. Published by that enqueue: p + 1.
+    ///     Released by the consumer: p + LOG_QUEUE_RECORD_COUNT (free for the next lap).
+    uint32_t sequence_minus_index;
+    LOG_record_t record;
+} LOG_queue_slot_t;
+
+static LOG_queue_slot_t LOG_queue_slots[LOG_QUEUE_RECORD_COUNT];
+static uint32_t LOG_queue_enqueue_position = 0;
+static uint32_t LOG_queue_dequeue_position = 0;
+
+LOG_queue_stats_t LOG_queue_stats = {0};
+
+static inline uint32_t LOG_queue_load_sequence(uint32_t position) {
+    const uint32_t index = position & (LOG_QUEUE_RECORD_COUNT - 1);
+    return __atomic_load_n(&LOG_queue_slots[index].sequence_minus_index, __ATOMIC_ACQUIRE) + index;
+}
+
+static inline void LOG_queue_store_sequence(uint32_t position, uint32_t sequence) {
+    const uint32_t index = position & (LOG_QUEUE_RECORD_COUNT - 1);
+    __atomic_store_n(&LOG_queue_slots[index].sequence_minus_index, sequence - index, __ATOMIC_RELEASE);
+}
+
+/// @brief Claim a slot to fill in. Safe to call from any task or interrupt.
+/// @param ticket_out Passed to `LOG_queue_publish_slot` once the record is filled in.
+/// @return The record to fill in, or NULL if the queue is full.
+LOG_record_t *LOG_queue_claim_slot(uint32_t *ticket_out) {
+    uint32_t position = __atomic_load_n(&LOG_queue_enqueue_position, __ATOMIC_RELAXED);
+    while (1) {
+        const int32_t diff = (int32_t)(LOG_queue_load_sequence(position) - position);
+        if (diff == 0) {
+            // Free. On failure, `position` is reloaded with the position another producer left.
+            if (__atomic_compare_exchange_n(
+                &LOG_queue_enqueue_position, &position, position + 1,
+                1, __ATOMIC_RELAXED, __ATOMIC_RELAXED
+            )) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // Not yet released by the consumer from the previous lap.
+            return NULL;
+        }
+        else {
+            // Claimed by another producer since we loaded the position.
+            position = __atomic_load_n(&LOG_queue_enqueue_position, __ATOMIC_RELAXED);
+        }
+    }
+
+    const uint32_t depth = (position + 1) - __atomic_load_n(&LOG_queue_dequeue_position, __ATOMIC_RELAXED);
+    if (depth > LOG_queue_stats.max_depth) {
+        LOG_queue_stats.max_depth = depth;
+    }
+    __atomic_fetch_add(&LOG_queue_stats.enqueued_count, 1, __ATOMIC_RELAXED);
+
+    *ticket_out = position;
+    return &LOG_queue_slots[position & (LOG_QUEUE_RECORD_COUNT - 1)].record;
+}
+
+/// @brief Hand a filled-in record to the consumer.
+void LOG_queue_publish_slot(uint32_t ticket) {
+    LOG_queue_store_sequence(ticket, ticket + 1);
+}
+
+/// @brief Get the oldest record, without removing it. Consumer only.
+/// @return The record, or NULL if the queue is empty (or the oldest record is not published yet).
+LOG_record_t *LOG_queue_peek_front(void) {
+    const uint32_t position = LOG_queue_dequeue_position;
+    if (LOG_queue_load_sequence(position) != (position + 1)) {
+        return NULL;
+    }
+    return &LOG_queue_slots[position & (LOG_QUEUE_RECORD_COUNT - 1)].record;
+}
+
+/// @brief Remove the record returned by `LOG_queue_peek_front`, freeing its slot. Consumer only.
+void LOG_queue_release_front(void) {
+    const uint32_t position = LOG_queue_dequeue_position;
+    LOG_queue_store_sequence(position, position + LOG_QUEUE_RECORD_COUNT);
+    __atomic_store_n(&LOG_queue_dequeue_position, position + 1, __ATOMIC_RELAXED);
+}
+
+/// @brief Get the number of records claimed but not yet released.
+uint32_t LOG_queue_depth(void) {
+    return (
+        __atomic_load_n(&LOG_queue_enqueue_position, __ATOMIC_RELAXED)
+        - __atomic_load_n(&LOG_queue_dequeue_position, __ATOMIC_RELAXED)
+    );
+}
@@ -80,3 +80,15 @@ void LOG_to_uhf_radio(const char msg[])
     }
     return;
 }
+
+/// @brief Sends a binary log record (see `log_binary.c`) to the UHF radio
+/// @param record_bytes The encoded record, starting with its length byte
+/// @return void
+void LOG_to_uhf_radio_binary(const uint8_t record_bytes[], uint16_t record_len)
+{
+    const uint8_t result = COMMS_downlink_log_record_binary(record_bytes, record_len);
+    if (result != 0) {
+        LOG_to_umbilical_uart("\nError sending binary log record to UHF radio\n");
+    }
+    return;
+}
@@ -32,6 +32,7 @@
 #include "rtos_tasks/rtos_bulk_downlink_task.h"
 #include "rtos_tasks/rtos_bootup_operation_fsm_task.h"
 #include "rtos_tasks/rtos_mpi_tasks.h"
+#include "rtos_tasks/rtos_logger_task.h"
 #include "uart_handler/uart_handler.h"
 #include "adcs_drivers/adcs_types.h"
 #include "adcs_drivers/adcs_commands.h"
@@ -63,6 +64,7 @@ I2C_HandleTypeDef hi2c1;
 I2C_HandleTypeDef hi2c2;
 I2C_HandleTypeDef hi2c3;
 I2C_HandleTypeDef hi2c4;
+DMA_HandleTypeDef hdma_i2c1_tx;
 
 IWDG_HandleTypeDef hiwdg;
 
@@ -72,8 +74,11 @@ UART_HandleTypeDef huart5;
 UART_HandleTypeDef huart1;
 UART_HandleTypeDef huart2;
 UART_HandleTypeDef huart3;
+DMA_HandleTypeDef hdma_lpuart1_rx;
 DMA_HandleTypeDef hdma_uart4_rx;
+DMA_HandleTypeDef hdma_uart5_rx;
 DMA_HandleTypeDef hdma_usart1_rx;
+DMA_HandleTypeDef hdma_usart3_rx;
 
 SPI_HandleTypeDef hspi1;
 DMA_HandleTypeDef hdma_spi1_rx;
@@ -99,6 +104,13 @@ const osThreadAttr_t defaultTask_attributes = {
 // 512 may work okay, but 1024 is a safe bet.
 #define TASK_MINIMUM_STACK_SIZE_BYTES 1024
 
+osThreadId_t TASK_logger_Handle;
+const osThreadAttr_t TASK_logger_Attributes = {
+  .name = "TASK_logger",
+  .stack_size = 2048,
+  .priority = (osPriority_t) osPriorityBelowNormal,
+};
+
 osThreadId_t TASK_service_eps_watchdog_Handle;
 const osThreadAttr_t TASK_service_eps_watchdog_Attributes = {
   .name = "TASK_service_eps_watchdog",
@@ -227,6 +239,11 @@ FREERTOS_task_info_struct_t FREERTOS_task_handles_array [] = {
     .task_attribute = &TASK_background_upkeep_Attributes,
     .lowest_stack_bytes_remaining = UINT32_MAX
   },
+  {
+    .task_handle = &TASK_logger_Handle,
+    .task_attribute = &TASK_logger_Attributes,
+    .lowest_stack_bytes_remaining = UINT32_MAX
+  },
 };
 
 const uint32_t FREERTOS_task_handles_array_size = sizeof(FREERTOS_task_handles_array) / sizeof(FREERTOS_task_info_struct_t);
@@ -385,6 +402,8 @@ int main(void)
 
   TASK_background_upkeep_Handle = osThreadNew(TASK_background_upkeep, NULL, &TASK_background_upkeep_Attributes);
 
+  TASK_logger_Handle = osThreadNew(TASK_logger, NULL, &TASK_logger_Attributes);
+
   /* USER CODE END RTOS_THREADS */
 
   /* USER CODE BEGIN RTOS_EVENTS */
@@ -1138,6 +1157,7 @@ static void MX_DMA_Init(void)
   /* DMA controller clock enable */
   __HAL_RCC_DMAMUX1_CLK_ENABLE();
   __HAL_RCC_DMA1_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
 
   /* DMA interrupt init */
   /* DMA1_Channel1_IRQn interrupt configuration */
@@ -1152,6 +1172,18 @@ static void MX_DMA_Init(void)
   /* DMA1_Channel4_IRQn interrupt configuration */
   HAL_NVIC_SetPriority(DMA1_Channel4_IRQn, 5, 0);
   HAL_NVIC_EnableIRQ(DMA1_Channel4_IRQn);
+  /* DMA1_Channel5_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel5_IRQn, 4, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel5_IRQn);
+  /* DMA1_Channel6_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+  /* DMA1_Channel7_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+  /* DMA2_Channel1_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA2_Channel1_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Channel1_IRQn);
 
 }
 
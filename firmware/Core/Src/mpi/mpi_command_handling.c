@@ -1,8 +1,11 @@
 #include "mpi/mpi_command_handling.h"
 #include "mpi/mpi_types.h"
 #include "mpi/mpi_transceiver.h"
+#include "mpi/mpi_science_ring.h"
+#include "mpi/mpi_frame_index.h"
 #include "eps_drivers/eps_channel_control.h"
 #include "uart_handler/uart_handler.h"
+#include "rtos_tasks/rtos_mpi_tasks.h"
 #include "log/log.h"
 #include "debug_tools/debug_uart.h"
 #include "littlefs/littlefs_helper.h"
@@ -294,6 +297,11 @@ static int8_t MPI_prepare_to_receive_data(const char output_file_path[]) {
         return open_result;
     }
 
+    // A new data file gets a new index; don't append to one left over from a deleted file.
+    if (lfs_file_size(&LFS_filesystem, &MPI_science_data_file_pointer) == 0) {
+        MPI_frame_index_delete(output_file_path);
+    }
+
     // Change the state to state file is open
     MPI_science_data_file_is_open = 1;
     LOG_message(
@@ -360,10 +368,22 @@ uint8_t MPI_enable_active_mode(const char output_file_path[]) {
     MPI_science_data_bytes_lost = 0;
     MPI_recording_start_uptime_ms = TIME_uptime_ms();
 
+    // Index the recording's frames (in `<file>.idx`). The recording works without its index.
+    const lfs_soff_t data_start_file_offset = lfs_file_size(&LFS_filesystem, &MPI_science_data_file_pointer);
+    const int8_t index_start_result = MPI_frame_index_start(
+        output_file_path, (data_start_file_offset > 0) ? (uint32_t)data_start_file_offset : 0,
+        LFS_get_boot_count(), MPI_recording_start_uptime_ms
+    );
+    if (index_start_result != 0) {
+        LOG_message(
+            LOG_SYSTEM_MPI, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
+            "MPI frame index not started (err: %d). Recording without an index.", index_start_result
+        );
+    }
 
-    // Receive MPI response actively with 8192 buffer size.
-    const HAL_StatusTypeDef rx_status = HAL_UART_Receive_DMA(
-        UART_mpi_port_handle, (uint8_t*) UART_mpi_rx_dma_buffer, UART_mpi_rx_dma_buffer_len);
+    // Receive the science data by DMA straight into the science ring's buffers.
+    MPI_science_ring_reset();
+    const HAL_StatusTypeDef rx_status = UART_mpi_start_science_rx_dma();
 
     if (rx_status != HAL_OK) {
         // Note: Saksham's original code didn't call HAL_UART_DMAStop here if HAL_BUSY.
@@ -415,7 +435,12 @@ uint8_t MPI_disable_active_mode(MPI_reason_for_stopping_active_mode_enum_t reaso
         // Steamroll here. Still want to close the file.
     }
 
+    // The writer task may be writing a buffer (and yield in a flash wait). Wait for it, and keep it
+    // out until the file is closed. This task does the final drain.
+    MPI_science_file_lock();
+
     if (MPI_current_uart_rx_mode != MPI_RX_MODE_SENSING_MODE) {
+        MPI_science_file_unlock();
         LOG_message(
             LOG_SYSTEM_MPI, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
             "MPI stop command called when not currently in sensing mode. Can't close file."
@@ -426,11 +451,22 @@ uint8_t MPI_disable_active_mode(MPI_reason_for_stopping_active_mode_enum_t reaso
 
     MPI_current_uart_rx_mode = MPI_RX_MODE_NOT_LISTENING_TO_MPI; // Set UART mode to not listening.
 
+    // Write out the buffers still awaiting their write, and the partly-filled one.
+    uint16_t dma_target_len;
+    MPI_science_ring_get_dma_target(&dma_target_len);
+    const uint16_t dma_remaining_len = __HAL_DMA_GET_COUNTER(UART_mpi_port_handle->hdmarx);
+    if (dma_remaining_len <= dma_target_len) {
+        MPI_science_ring_complete_partial(dma_target_len - dma_remaining_len, TIME_uptime_ms());
+    }
+    MPI_write_pending_science_buffers();
+    MPI_frame_index_finish();
+
     MPI_write_file_footer(reason_for_stopping);
 
     // Close the file. The file in storage is not updated until the file is closed successfully.
     const int8_t close_result = lfs_file_close(&LFS_filesystem, &MPI_science_data_file_pointer);
     MPI_science_data_file_is_open = 0;
+    MPI_science_file_unlock();
     if (close_result < 0) {
         LOG_message(
             LOG_SYSTEM_MPI, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
@@ -1,13 +1,73 @@
 #include "mpi/mpi_data_files.h"
+#include "mpi/mpi_frame_index.h"
 #include "log/log.h"
 #include "littlefs/lfs.h"
 #include "littlefs/littlefs_helper.h"
 #include "littlefs/littlefs_searching.h"
 
+#include <string.h>
+
+
+/// @brief Check a science data file against the totals of its index (`<file>.idx`).
+/// @return 0 if valid, 30 if the frame count doesn't match the data length, 40 if an indexed frame
+///     doesn't start with the sync word, 50 if the file size doesn't match the data length (e.g.,
+///     the file was written to outside of a recording).
+static uint8_t MPI_validate_science_data_file_index(
+    const char* file_path, lfs_ssize_t file_size,
+    const MPI_frame_index_summary_t *index_summary, const uint8_t expected_sync_word[4]
+) {
+    // Besides the science data, each recording has a header and a footer, and a timestamp after
+    // every few buffers (<200 bytes each). Allow 20% for the timestamps, like the counts below.
+    const uint32_t max_file_size = (
+        (uint32_t)(index_summary->data_bytes * 1.2) + (index_summary->recording_count * 600)
+    );
+    if (((uint32_t)file_size < index_summary->data_bytes) || ((uint32_t)file_size > max_file_size)) {
+        LOG_message(
+            LOG_SYSTEM_MPI, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "File size is invalid: %ld bytes, expected %lu to %lu bytes for %lu data bytes in the index.",
+            file_size, index_summary->data_bytes, max_file_size, index_summary->data_bytes
+        );
+        return 50;
+    }
+
+    const int32_t frames_found = index_summary->frames_found;
+    const int32_t expected_frame_count = index_summary->data_bytes / 160;
+    const uint8_t valid_frame_count = (
+        (frames_found >= expected_frame_count * 0.8)
+        && (frames_found <= expected_frame_count * 1.2)
+    );
+    if (!valid_frame_count) {
+        LOG_message(
+            LOG_SYSTEM_MPI, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Index frame count is invalid: found %ld frames, expected %ld frames in %lu data bytes.",
+            frames_found, expected_frame_count, index_summary->data_bytes
+        );
+        return 30;
+    }
+
+    const uint32_t spot_check_offsets[2] = {
+        index_summary->first_entry_file_offset, index_summary->last_entry_file_offset
+    };
+    for (uint8_t i = 0; i < 2; i++) {
+        uint8_t sync_word[4];
+        const lfs_ssize_t read_result = LFS_read_file(file_path, spot_check_offsets[i], sync_word, sizeof(sync_word));
+        if ((read_result != sizeof(sync_word)) || (memcmp(sync_word, expected_sync_word, sizeof(sync_word)) != 0)) {
+            LOG_message(
+                LOG_SYSTEM_MPI, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+                "Indexed frame at offset %lu has no sync word (read result: %ld).",
+                spot_check_offsets[i], read_result
+            );
+            return 40;
+        }
+    }
+    return 0;
+}
+
 
 /// @brief Check if the given file path is a valid MPI science data file with a few heuristics (file size, sync word count).
 /// @param file_path Path of potential science data file to validate.
 /// @return 0 if valid. >0 on invalid.
+/// @note Uses the file's index if it has a complete one, else searches the whole file.
 uint8_t MPI_validate_science_data_file(const char* file_path) {
     // Check the file size: Expecting at least 20_000 bytes.
     lfs_ssize_t file_size = LFS_file_size(file_path, 1);
@@ -30,6 +90,20 @@ uint8_t MPI_validate_science_data_file(const char* file_path) {
 
     // Check the file contents. Expect to see the sync words (0x0C 0xFF 0xFF 0x0C) repeatedly.
     uint8_t expected_sync_word[] = {0x0C, 0xFF, 0xFF, 0x0C};
+
+    // If the file has a complete index, check its totals and spot-check it instead of searching
+    // the whole file.
+    MPI_frame_index_summary_t index_summary;
+    if (
+        (MPI_frame_index_get_summary(file_path, &index_summary) == 0)
+        && index_summary.is_complete
+        && (index_summary.entry_count > 0)
+    ) {
+        return MPI_validate_science_data_file_index(
+            file_path, file_size, &index_summary, expected_sync_word
+        );
+    }
+
     const int32_t sync_count = LFS_search_count_occurrences(
         file_path, expected_sync_word, sizeof(expected_sync_word)
     );
@@ -0,0 +1,520 @@
+// mpi_frame_index.c
+// Index files of MPI science data files. While a recording is written, the writer task passes each
+// buffer of science data through `MPI_frame_index_add_data`, which finds the frames' sync words and
+// records every Nth frame's number, file offset and uptime. The records are batched in RAM and
+// appended to `<science data file>.idx`.
+//
+// A frame range or time range is then found by reading the index (about 1/1000 of the data file's
+// size) instead of searching the whole data file for sync words, and the science data file can be
+// validated from the index's totals and a few spot checks.
+//
+// Once a frame is found, the scan skips to where the next frame's sync word should be, so only
+// about 6 bytes of each 160 B frame are looked at while the data is in sync.
+
+#include "mpi/mpi_frame_index.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+#include "littlefs/littlefs_dir_listing.h"
+#include "log/log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/// @brief Index every Nth frame of MPI science data files. 0 disables the index files.
+/// @note 64 frames is 0.44 s of data at 230400 baud; the index is 1/850 of the data's size.
+/// @note Applied at the start of each recording.
+uint32_t MPI_frame_index_interval_frames = 64;
+
+// Records batched in RAM before being appended to the index file.
+#define MPI_FRAME_INDEX_BATCH_RECORD_COUNT 32
+
+// MPI UART data rate: 230400 baud, 8N1 (USART1, `main.c`). For the time each indexed frame arrived.
+#define MPI_FRAME_INDEX_UART_BYTES_PER_SEC 23040
+
+// Records read from the index file at a time.
+#define MPI_FRAME_INDEX_READ_RECORD_COUNT 32
+
+/// @brief State of the index of the recording in progress.
+typedef struct {
+    uint8_t is_active;
+    char index_path[LFS_MAX_PATH_LENGTH];
+    uint32_t interval_frames;
+
+    /// @brief The last 4 bytes of data (for finding sync words across buffer boundaries).
+    uint32_t window;
+
+    /// @brief Bytes of the current frame left to skip, after its frame counter.
+    uint32_t skip_len;
+
+    /// @brief Frame counter bytes still to be read after a sync word (0 when looking for one).
+    uint8_t counter_bytes_pending;
+    uint16_t counter;
+    uint32_t frame_file_offset;
+
+    /// @brief File offset just after the previous data buffer, for sync words split across buffers.
+    uint32_t prev_data_end_file_offset;
+
+    uint8_t has_frame_number;
+    uint32_t frame_number;
+    uint32_t frames_found;
+    uint32_t data_bytes;
+
+    MPI_frame_index_record_t batch[MPI_FRAME_INDEX_BATCH_RECORD_COUNT];
+    uint16_t batch_count;
+} MPI_frame_index_writer_t;
+
+static MPI_frame_index_writer_t MPI_frame_index_writer;
+
+/// @brief Sequential reader of an index file.
+typedef struct {
+    lfs_file_t file;
+    MPI_frame_index_record_t records[MPI_FRAME_INDEX_READ_RECORD_COUNT];
+    uint16_t record_count;
+    uint16_t next_record_num;
+} MPI_frame_index_reader_t;
+
+static MPI_frame_index_reader_t MPI_frame_index_reader;
+
+
+/// @brief Get the path of a science data file's index file.
+/// @return 0 on success, 1 if the path is too long.
+int8_t MPI_frame_index_get_path(const char data_file_path[], char index_path_out[], uint16_t index_path_out_size) {
+    const int written_len = snprintf(
+        index_path_out, index_path_out_size, "%s" MPI_FRAME_INDEX_FILE_SUFFIX, data_file_path
+    );
+    if ((written_len < 0) || (written_len >= index_path_out_size) || (written_len >= LFS_MAX_PATH_LENGTH)) {
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Remove a science data file's index file (e.g., when the data file is deleted, or
+///     created anew, so that a new recording isn't appended to an old file's index).
+/// @return 0 on success (including if there was no index file), 1 if the path is too long, or a
+///     negative LFS error code.
+int8_t MPI_frame_index_delete(const char data_file_path[]) {
+    char index_path[LFS_MAX_PATH_LENGTH];
+    if (MPI_frame_index_get_path(data_file_path, index_path, sizeof(index_path)) != 0) {
+        return 1;
+    }
+    const int8_t mount_result = LFS_ensure_mounted();
+    if (mount_result < 0) {
+        return mount_result;
+    }
+    const int remove_result = lfs_remove(&LFS_filesystem, index_path);
+    if ((remove_result < 0) && (remove_result != LFS_ERR_NOENT)) {
+        return (int8_t)remove_result;
+    }
+    return 0;
+}
+
+/// @brief Append the batched records to the index file.
+static int8_t MPI_frame_index_flush(void) {
+    MPI_frame_index_writer_t *writer = &MPI_frame_index_writer;
+    if (writer->batch_count == 0) {
+        return 0;
+    }
+    const int8_t append_result = LFS_append_file(
+        writer->index_path, (uint8_t *)writer->batch,
+        writer->batch_count * sizeof(MPI_frame_index_record_t)
+    );
+    writer->batch_count = 0;
+    if (append_result != 0) {
+        LOG_message(
+            LOG_SYSTEM_MPI, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
+            "MPI index: Error appending to %s: %d. Index disabled for this recording.",
+            writer->index_path, append_result
+        );
+        writer->is_active = 0;
+        return append_result;
+    }
+    return 0;
+}
+
+static void MPI_frame_index_add_record(uint32_t frame_number, uint32_t file_offset, uint32_t uptime_ms) {
+    MPI_frame_index_writer_t *writer = &MPI_frame_index_writer;
+    writer->batch[writer->batch_count].frame_number = frame_number;
+    writer->batch[writer->batch_count].file_offset = file_offset;
+    writer->batch[writer->batch_count].uptime_ms = uptime_ms;
+    writer->batch_count++;
+    if (writer->batch_count >= MPI_FRAME_INDEX_BATCH_RECORD_COUNT) {
+        MPI_frame_index_flush();
+    }
+}
+
+/// @brief Start the index of a new recording (appended to the index file, like the data file).
+/// @param data_start_file_offset Offset in the science data file of the recording's first data byte.
+/// @param boot_count This boot's number (`LFS_get_boot_count`), which the entries' uptimes are from.
+/// @param uptime_ms Uptime at the start of the recording.
+/// @return 0 on success (or if the index is disabled), 1 if the index path is too long.
+/// @note Call after writing the science data file's header, before the first science data. If the
+///     science data file was just created, call `MPI_frame_index_delete` first.
+int8_t MPI_frame_index_start(
+    const char data_file_path[], uint32_t data_start_file_offset, uint32_t boot_count, uint32_t uptime_ms
+) {
+    MPI_frame_index_writer_t *writer = &MPI_frame_index_writer;
+    memset(writer, 0, sizeof(*writer));
+    if ((MPI_frame_index_interval_frames == 0) || (MPI_frame_index_interval_frames > UINT16_MAX)) {
+        return 0;
+    }
+    if (MPI_frame_index_get_path(data_file_path, writer->index_path, sizeof(writer->index_path)) != 0) {
+        LOG_message(
+            LOG_SYSTEM_MPI, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
+            "MPI index: Path too long for an index file: %s", data_file_path
+        );
+        return 1;
+    }
+
+    writer->is_active = 1;
+    writer->interval_frames = MPI_frame_index_interval_frames;
+    writer->prev_data_end_file_offset = data_start_file_offset;
+    MPI_frame_index_add_record(MPI_FRAME_INDEX_START_RECORD_MAGIC, data_start_file_offset, boot_count);
+    MPI_frame_index_add_record(
+        MPI_FRAME_INDEX_PARAMS_RECORD_MAGIC,
+        MPI_FRAME_INDEX_FORMAT_VERSION | (writer->interval_frames << 16),
+        uptime_ms
+    );
+    return 0;
+}
+
+/// @brief Handle a frame whose sync word and frame counter were just found.
+/// @param uptime_ms Time the frame's sync word arrived.
+static void MPI_frame_index_on_frame(uint32_t uptime_ms) {
+    MPI_frame_index_writer_t *writer = &MPI_frame_index_writer;
+
+    // Extend the 16-bit frame counter, assuming it only moves forwards.
+    if (!writer->has_frame_number) {
+        writer->frame_number = writer->counter;
+        writer->has_frame_number = 1;
+    }
+    else {
+        writer->frame_number += (uint16_t)(writer->counter - (uint16_t)writer->frame_number);
+    }
+
+    if ((writer->frames_found % writer->interval_frames) == 0) {
+        MPI_frame_index_add_record(writer->frame_number, writer->frame_file_offset, uptime_ms);
+    }
+    writer->frames_found++;
+}
+
+/// @brief Index a buffer of science data, which was just written to the science data file.
+/// @param data_file_offset Offset in the science data file that `data` was written at.
+/// @param uptime_ms Time the buffer finished filling (when its last byte arrived).
+void MPI_frame_index_add_data(const uint8_t data[], uint32_t data_len, uint32_t data_file_offset, uint32_t uptime_ms) {
+    MPI_frame_index_writer_t *writer = &MPI_frame_index_writer;
+    if (!writer->is_active) {
+        return;
+    }
+
+    uint32_t i = (writer->skip_len < data_len) ? writer->skip_len : data_len;
+    writer->skip_len -= i;
+    for (; i < data_len; i++) {
+        if (writer->counter_bytes_pending > 0) {
+            writer->counter = (uint16_t)((writer->counter << 8) | data[i]); // Big-endian.
+            writer->counter_bytes_pending--;
+            if (writer->counter_bytes_pending == 0) {
+                // The sync word arrived this many bytes before the buffer finished filling.
+                const uint32_t bytes_since_sync = data_len - i + 5;
+                MPI_frame_index_on_frame(
+                    uptime_ms - ((bytes_since_sync * 1000) / MPI_FRAME_INDEX_UART_BYTES_PER_SEC)
+                );
+
+                // Skip to where the next frame's sync word should be.
+                const uint32_t skip_len = MPI_FRAME_INDEX_FRAME_SIZE_BYTES - 6;
+                const uint32_t left_in_data = data_len - i - 1;
+                const uint32_t skipped_len = (skip_len < left_in_data) ? skip_len : left_in_data;
+                i += skipped_len;
+                writer->skip_len = skip_len - skipped_len;
+                writer->window = 0;
+            }
+            continue;
+        }
+
+        writer->window = (writer->window << 8) | data[i];
+        if (writer->window == MPI_FRAME_INDEX_SYNC_WORD) {
+            // The sync word started 3 bytes back, maybe in the previous buffer.
+            writer->frame_file_offset = (i >= 3)
+                ? (data_file_offset + i - 3)
+                : (writer->prev_data_end_file_offset - (3 - i));
+            writer->counter_bytes_pending = 2;
+            writer->counter = 0;
+            writer->window = 0;
+        }
+    }
+    writer->prev_data_end_file_offset = data_file_offset + data_len;
+    writer->data_bytes += data_len;
+}
+
+/// @brief End the index of the recording: append the end record, and write out the batch.
+/// @return 0 on success (or if the index is disabled), else the `LFS_append_file` error.
+/// @note Call after the last science data is written.
+int8_t MPI_frame_index_finish(void) {
+    MPI_frame_index_writer_t *writer = &MPI_frame_index_writer;
+    if (!writer->is_active) {
+        return 0;
+    }
+    MPI_frame_index_add_record(MPI_FRAME_INDEX_END_RECORD_MAGIC, writer->frames_found, writer->data_bytes);
+    const int8_t flush_result = MPI_frame_index_flush();
+    writer->is_active = 0;
+    return flush_result;
+}
+
+static int8_t MPI_frame_index_reader_open(const char data_file_path[]) {
+    char index_path[LFS_MAX_PATH_LENGTH];
+    if (MPI_frame_index_get_path(data_file_path, index_path, sizeof(index_path)) != 0) {
+        return 1;
+    }
+    const int8_t mount_result = LFS_ensure_mounted();
+    if (mount_result < 0) {
+        return mount_result;
+    }
+    MPI_frame_index_reader.record_count = 0;
+    MPI_frame_index_reader.next_record_num = 0;
+    return lfs_file_open(&LFS_filesystem, &MPI_frame_index_reader.file, index_path, LFS_O_RDONLY);
+}
+
+/// @brief Read the next record of the index file.
+/// @return 1 if a record was read, 0 at the end of the file, or a negative LFS error code.
+static int8_t MPI_frame_index_reader_next(MPI_frame_index_record_t *record_out) {
+    MPI_frame_index_reader_t *reader = &MPI_frame_index_reader;
+    if (reader->next_record_num >= reader->record_count) {
+        const lfs_ssize_t read_len = lfs_file_read(
+            &LFS_filesystem, &reader->file, reader->records, sizeof(reader->records)
+        );
+        if (read_len < 0) {
+            return (int8_t)read_len;
+        }
+        reader->record_count = (uint16_t)(read_len / sizeof(MPI_frame_index_record_t));
+        reader->next_record_num = 0;
+        if (reader->record_count == 0) {
+            return 0;
+        }
+    }
+    *record_out = reader->records[reader->next_record_num++];
+    return 1;
+}
+
+static void MPI_frame_index_reader_close(void) {
+    lfs_file_close(&LFS_filesystem, &MPI_frame_index_reader.file);
+}
+
+/// @brief Find the byte range of a science data file holding a range of frames, using its index.
+/// @param key Whether `first` and `last` are frame numbers or uptimes (ms).
+/// @param boot_count For uptimes, the boot they are from (`LFS_get_boot_count`); recordings from
+///     other boots are skipped. Ignored for frame numbers.
+/// @param first First frame number or uptime wanted.
+/// @param last Last frame number or uptime wanted (inclusive).
+/// @param start_offset_out File offset of the indexed frame at or before `first`.
+/// @param end_offset_out File offset of the indexed frame after `last` (exclusive), or the end of
+///     the recording.
+/// @return 0 on success, 1 if the path is too long, 2 if no recording in the index holds the range,
+///     3 if `first > last`, 4 if the index has another format version, or a negative LFS error code
+///     (e.g., no index file).
+/// @note The range is found in the first recording in the file which overlaps it. It starts and ends
+///     at indexed frames, so it holds up to `MPI_frame_index_interval_frames` frames more on each
+///     end, plus any timestamps written between the buffers.
+int8_t MPI_frame_index_find_range(
+    const char data_file_path[], MPI_frame_index_key_enum_t key, uint32_t boot_count,
+    uint32_t first, uint32_t last, uint32_t *start_offset_out, uint32_t *end_offset_out
+) {
+    if (first > last) {
+        return 3;
+    }
+    const int8_t open_result = MPI_frame_index_reader_open(data_file_path);
+    if (open_result != 0) {
+        return open_result;
+    }
+
+    uint8_t is_recording_skipped = 0; // The current recording is from another boot.
+    uint8_t has_start_candidate = 0; // In the current recording.
+    uint8_t is_start_found = 0;
+    uint8_t is_end_found = 0;
+    uint32_t start_offset = 0;
+    uint32_t end_offset = 0;
+    MPI_frame_index_record_t record;
+    int8_t read_result;
+    while ((read_result = MPI_frame_index_reader_next(&record)) == 1) {
+        if (record.frame_number == MPI_FRAME_INDEX_START_RECORD_MAGIC) {
+            if (is_start_found) {
+                // The range runs to the end of the recording. The next one starts at its offset
+                // (after the previous recording's footer and the next one's header).
+                end_offset = record.file_offset;
+                is_end_found = 1;
+                break;
+            }
+            is_recording_skipped = (key == MPI_FRAME_INDEX_KEY_UPTIME_MS) && (record.uptime_ms != boot_count);
+            has_start_candidate = 0;
+            continue;
+        }
+        if (record.frame_number == MPI_FRAME_INDEX_PARAMS_RECORD_MAGIC) {
+            if ((record.file_offset & 0xFFFF) != MPI_FRAME_INDEX_FORMAT_VERSION) {
+                read_result = 4;
+                break;
+            }
+            continue;
+        }
+        if ((record.frame_number == MPI_FRAME_INDEX_END_RECORD_MAGIC) || is_recording_skipped) {
+            continue;
+        }
+
+        const uint32_t record_key = (key == MPI_FRAME_INDEX_KEY_FRAME_NUMBER) ? record.frame_number : record.uptime_ms;
+        if (!is_start_found) {
+            if (record_key <= first) {
+                start_offset = record.file_offset;
+                has_start_candidate = 1;
+                continue;
+            }
+            if (!has_start_candidate) {
+                if (record_key > last) {
+                    continue; // This recording starts after the range.
+                }
+                start_offset = record.file_offset; // The range starts before the recording.
+            }
+            is_start_found = 1;
+        }
+        if (record_key > last) {
+            end_offset = record.file_offset;
+            is_end_found = 1;
+            break;
+        }
+    }
+    MPI_frame_index_reader_close();
+    if ((read_result < 0) || (read_result == 4)) {
+        return read_result;
+    }
+
+    // The range starts after the last indexed frame of the last recording (near its end).
+    if ((!is_start_found) && has_start_candidate) {
+        is_start_found = 1;
+    }
+    if (!is_start_found) {
+        return 2;
+    }
+    if (!is_end_found) {
+        const lfs_ssize_t file_size = LFS_file_size(data_file_path, 1);
+        if (file_size < 0) {
+            return (int8_t)file_size;
+        }
+        end_offset = (uint32_t)file_size;
+    }
+
+    *start_offset_out = start_offset;
+    *end_offset_out = end_offset;
+    return 0;
+}
+
+/// @brief Read the totals of a science data file's index.
+/// @return 0 on success, 1 if the path is too long, 2 if the index has no recordings, 4 if the index
+///     has another format version, or a negative LFS error code (e.g., no index file).
+int8_t MPI_frame_index_get_summary(const char data_file_path[], MPI_frame_index_summary_t *summary_out) {
+    memset(summary_out, 0, sizeof(*summary_out));
+    const int8_t open_result = MPI_frame_index_reader_open(data_file_path);
+    if (open_result != 0) {
+        return open_result;
+    }
+
+    uint8_t is_recording_ended = 1;
+    uint8_t is_complete = 1;
+    MPI_frame_index_record_t record;
+    int8_t read_result;
+    while ((read_result = MPI_frame_index_reader_next(&record)) == 1) {
+        if (record.frame_number == MPI_FRAME_INDEX_START_RECORD_MAGIC) {
+            // A previous recording without an end record makes the index incomplete.
+            if (!is_recording_ended) {
+                is_complete = 0;
+            }
+            summary_out->recording_count++;
+            is_recording_ended = 0;
+            continue;
+        }
+        if (record.frame_number == MPI_FRAME_INDEX_PARAMS_RECORD_MAGIC) {
+            if ((record.file_offset & 0xFFFF) != MPI_FRAME_INDEX_FORMAT_VERSION) {
+                read_result = 4;
+                break;
+            }
+            continue;
+        }
+        if (record.frame_number == MPI_FRAME_INDEX_END_RECORD_MAGIC) {
+            summary_out->frames_found += record.file_offset;
+            summary_out->data_bytes += record.uptime_ms;
+            is_recording_ended = 1;
+            continue;
+        }
+        if (summary_out->entry_count == 0) {
+            summary_out->first_entry_file_offset = record.file_offset;
+        }
+        summary_out->last_entry_file_offset = record.file_offset;
+        summary_out->entry_count++;
+    }
+    MPI_frame_index_reader_close();
+    if ((read_result < 0) || (read_result == 4)) {
+        return read_result;
+    }
+    if (summary_out->recording_count == 0) {
+        return 2;
+    }
+    summary_out->is_complete = is_complete && is_recording_ended;
+    return 0;
+}
+
+/// @brief Copy a byte range of a science data file (e.g., from `MPI_frame_index_find_range`) to
+///     a new file.
+/// @return 0 on success, 1 if the range is empty or reversed, or a negative LFS error code.
+int8_t MPI_frame_index_extract_range_to_file(
+    const char data_file_path[], uint32_t start_offset, uint32_t end_offset, const char output_file_path[]
+) {
+    if (end_offset <= start_offset) {
+        return 1;
+    }
+    const int8_t mount_result = LFS_ensure_mounted();
+    if (mount_result < 0) {
+        return mount_result;
+    }
+
+    lfs_file_t input_file;
+    const int8_t open_input_result = lfs_file_open(&LFS_filesystem, &input_file, data_file_path, LFS_O_RDONLY);
+    if (open_input_result < 0) {
+        return open_input_result;
+    }
+    lfs_file_t output_file;
+    const int8_t open_output_result = lfs_file_open(
+        &LFS_filesystem, &output_file, output_file_path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC
+    );
+    LFS_dir_listing_invalidate_path(output_file_path);
+    if (open_output_result < 0) {
+        lfs_file_close(&LFS_filesystem, &input_file);
+        return open_output_result;
+    }
+
+    int8_t result = 0;
+    const lfs_soff_t seek_result = lfs_file_seek(&LFS_filesystem, &input_file, start_offset, LFS_SEEK_SET);
+    if (seek_result < 0) {
+        result = (int8_t)seek_result;
+    }
+    uint32_t offset = start_offset;
+    while ((result == 0) && (offset < end_offset)) {
+        // Use the reader's buffer; the copy doesn't read the index.
+        uint8_t *chunk = (uint8_t *)MPI_frame_index_reader.records;
+        uint32_t chunk_len = end_offset - offset;
+        if (chunk_len > sizeof(MPI_frame_index_reader.records)) {
+            chunk_len = sizeof(MPI_frame_index_reader.records);
+        }
+        const lfs_ssize_t read_len = lfs_file_read(&LFS_filesystem, &input_file, chunk, chunk_len);
+        if (read_len <= 0) {
+            result = (read_len < 0) ? (int8_t)read_len : 0;
+            break; // The end of the file.
+        }
+        const lfs_ssize_t write_len = lfs_file_write(&LFS_filesystem, &output_file, chunk, (lfs_size_t)read_len);
+        if (write_len < 0) {
+            result = (int8_t)write_len;
+        }
+        offset += (uint32_t)read_len;
+    }
+
+    lfs_file_close(&LFS_filesystem, &input_file);
+    const int8_t close_result = lfs_file_close(&LFS_filesystem, &output_file);
+    if ((result == 0) && (close_result < 0)) {
+        result = close_result;
+    }
+    return result;
+}
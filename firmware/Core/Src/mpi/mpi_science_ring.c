@@ -0,0 +1,152 @@
+// mpi_science_ring.c
+// Buffers for MPI science data, received by DMA straight into a ring of flash-page-sized buffers.
+// Each DMA transfer fills one whole buffer. The transfer-complete ISR marks it full, points the
+// next transfer at the next free buffer, and wakes the writer task, which writes the full buffers
+// to the file from where the DMA left them. The CPU never copies the science data.
+//
+// The ISR only writes `MPI_science_ring_filled_count` and the consumer only writes
+// `MPI_science_ring_released_count`, so no lock is needed between them. There is one consumer at a
+// time: the writer task, or `MPI_disable_active_mode` for the final drain, serialized by
+// `MPI_science_file_lock` (`MPI_write_pending_science_buffers`). Both only ever count up, and buffer
+// `n % buffer_count` is the n-th filled. When every buffer is awaiting its write, the DMA is
+// pointed at a small discard buffer instead, one frame at a time, until the writer catches up.
+
+#include "mpi/mpi_science_ring.h"
+
+#include <stddef.h>
+
+/// @brief Number of buffers in the ring (max `MPI_SCIENCE_RING_MAX_BUFFER_COUNT`). More buffers
+///     ride out longer stalls of the writer task (e.g., flash garbage collection).
+/// @note Applied at the start of each recording.
+uint32_t MPI_science_ring_buffer_count = MPI_SCIENCE_RING_MAX_BUFFER_COUNT;
+
+uint8_t MPI_science_ring_storage[MPI_SCIENCE_RING_MAX_BUFFER_COUNT][MPI_SCIENCE_RING_BUFFER_SIZE_BYTES] __attribute__((aligned(4)));
+MPI_science_ring_stats_t MPI_science_ring_stats;
+
+static uint8_t MPI_science_ring_discard_buffer[MPI_SCIENCE_RING_DISCARD_BUFFER_SIZE_BYTES] __attribute__((aligned(4)));
+
+static uint32_t MPI_science_ring_active_buffer_count = MPI_SCIENCE_RING_MAX_BUFFER_COUNT;
+
+// Written by the ISR (and by `MPI_science_ring_complete_partial` while the DMA is stopped).
+static volatile uint32_t MPI_science_ring_filled_count = 0;
+static volatile uint16_t MPI_science_ring_filled_len[MPI_SCIENCE_RING_MAX_BUFFER_COUNT];
+static volatile uint32_t MPI_science_ring_filled_uptime_ms[MPI_SCIENCE_RING_MAX_BUFFER_COUNT];
+
+/// @brief 1 if the DMA is writing into the discard buffer, 0 if into buffer `filled_count % count`.
+static volatile uint8_t MPI_science_ring_dma_target_is_discard = 0;
+
+// Written by the writer task.
+static volatile uint32_t MPI_science_ring_released_count = 0;
+
+
+/// @brief Empty the ring, and apply `MPI_science_ring_buffer_count`.
+/// @note Call before starting the DMA (e.g., at the start of a recording).
+void MPI_science_ring_reset(void) {
+    uint32_t buffer_count = MPI_science_ring_buffer_count;
+    if (buffer_count < MPI_SCIENCE_RING_MIN_BUFFER_COUNT) {
+        buffer_count = MPI_SCIENCE_RING_MIN_BUFFER_COUNT;
+    }
+    if (buffer_count > MPI_SCIENCE_RING_MAX_BUFFER_COUNT) {
+        buffer_count = MPI_SCIENCE_RING_MAX_BUFFER_COUNT;
+    }
+    MPI_science_ring_active_buffer_count = buffer_count;
+
+    MPI_science_ring_filled_count = 0;
+    MPI_science_ring_released_count = 0;
+    MPI_science_ring_dma_target_is_discard = 0;
+    MPI_science_ring_stats = (MPI_science_ring_stats_t){0};
+}
+
+/// @brief Get the buffer that the next DMA transfer must write into.
+/// @param target_len_out Length of the transfer.
+/// @return Start of the buffer (a ring buffer, or the discard buffer if the ring is full).
+uint8_t *MPI_science_ring_get_dma_target(uint16_t *target_len_out) {
+    if (MPI_science_ring_dma_target_is_discard) {
+        *target_len_out = MPI_SCIENCE_RING_DISCARD_BUFFER_SIZE_BYTES;
+        return MPI_science_ring_discard_buffer;
+    }
+    *target_len_out = MPI_SCIENCE_RING_BUFFER_SIZE_BYTES;
+    return MPI_science_ring_storage[MPI_science_ring_filled_count % MPI_science_ring_active_buffer_count];
+}
+
+/// @brief Point the next transfer at the next free buffer, or at the discard buffer if none is free.
+static void MPI_science_ring_select_next_target(void) {
+    const uint32_t pending_count = MPI_science_ring_filled_count - MPI_science_ring_released_count;
+    if (pending_count > MPI_science_ring_stats.max_pending_buffer_count) {
+        MPI_science_ring_stats.max_pending_buffer_count = pending_count;
+    }
+    MPI_science_ring_dma_target_is_discard = (pending_count >= MPI_science_ring_active_buffer_count);
+}
+
+/// @brief Record the completion of the DMA transfer into `MPI_science_ring_get_dma_target()`,
+///     and select the target of the next one (restart the DMA on it after this call).
+/// @param uptime_ms Time the transfer completed.
+/// @return 1 if a buffer was filled (wake the writer task), 0 if the transfer was discarded.
+/// @note ISR only.
+uint8_t MPI_science_ring_on_dma_complete_from_isr(uint32_t uptime_ms) {
+    uint8_t buffer_filled = 0;
+    if (MPI_science_ring_dma_target_is_discard) {
+        MPI_science_ring_stats.discarded_transfer_count++;
+    }
+    else {
+        const uint32_t slot = MPI_science_ring_filled_count % MPI_science_ring_active_buffer_count;
+        MPI_science_ring_filled_len[slot] = MPI_SCIENCE_RING_BUFFER_SIZE_BYTES;
+        MPI_science_ring_filled_uptime_ms[slot] = uptime_ms;
+        MPI_science_ring_filled_count++;
+        MPI_science_ring_stats.buffers_filled++;
+        buffer_filled = 1;
+    }
+
+    MPI_science_ring_select_next_target();
+    return buffer_filled;
+}
+
+/// @brief Mark the partly-filled buffer as full, so that its data is written too.
+/// @param received_len Bytes the DMA wrote into the target before it was stopped.
+/// @note Call after the DMA stops (at the end of a recording, or from the UART error callback,
+///     before restarting it on the next target). Bytes received into the discard buffer are dropped.
+void MPI_science_ring_complete_partial(uint16_t received_len, uint32_t uptime_ms) {
+    if (MPI_science_ring_dma_target_is_discard || (received_len == 0)) {
+        return;
+    }
+    if (received_len > MPI_SCIENCE_RING_BUFFER_SIZE_BYTES) {
+        received_len = MPI_SCIENCE_RING_BUFFER_SIZE_BYTES;
+    }
+
+    const uint32_t slot = MPI_science_ring_filled_count % MPI_science_ring_active_buffer_count;
+    MPI_science_ring_filled_len[slot] = received_len;
+    MPI_science_ring_filled_uptime_ms[slot] = uptime_ms;
+    MPI_science_ring_filled_count++;
+    MPI_science_ring_stats.buffers_filled++;
+    MPI_science_ring_select_next_target();
+}
+
+/// @brief Get the number of full buffers awaiting their write.
+uint32_t MPI_science_ring_pending_count(void) {
+    return MPI_science_ring_filled_count - MPI_science_ring_released_count;
+}
+
+/// @brief Get the oldest full buffer, without removing it from the ring.
+/// @param len_out Number of bytes of data in the buffer.
+/// @param filled_uptime_ms_out Time the buffer finished filling.
+/// @return The buffer's data, or NULL if no buffer is full. Valid until `MPI_science_ring_release`.
+/// @note Consumer only (holding `MPI_science_file_lock`).
+const uint8_t *MPI_science_ring_peek_full(uint16_t *len_out, uint32_t *filled_uptime_ms_out) {
+    if (MPI_science_ring_pending_count() == 0) {
+        return NULL;
+    }
+    const uint32_t slot = MPI_science_ring_released_count % MPI_science_ring_active_buffer_count;
+    *len_out = MPI_science_ring_filled_len[slot];
+    *filled_uptime_ms_out = MPI_science_ring_filled_uptime_ms[slot];
+    return MPI_science_ring_storage[slot];
+}
+
+/// @brief Return the buffer from `MPI_science_ring_peek_full` to the DMA, once it has been written.
+/// @note Consumer only (holding `MPI_science_file_lock`).
+void MPI_science_ring_release(void) {
+    if (MPI_science_ring_pending_count() == 0) {
+        return;
+    }
+    MPI_science_ring_released_count++;
+    MPI_science_ring_stats.buffers_released++;
+}
@@ -18,6 +18,7 @@
 #include "adcs_drivers/adcs_commands.h"
 #include "transforms/number_comparisons.h"
 #include "telecommand_exec/agenda_from_file.h"
+#include "telecommand_exec/telecommand_response_store.h"
 
 #include "cmsis_os.h"
 
@@ -173,9 +174,12 @@ static void subtask_reset_system_after_very_long_uptime(void) {
             TIME_uptime_ms(),
             STM32_system_reset_interval_sec
         );
+        LOG_process_queued_messages(UINT32_MAX); // The logger task won't run again before the reset.
         HAL_Delay(1000); // Give time for the log to be sent.
 
-        // Considered doing an LFS unmount here, but what if LFS is the cause of problems?
+        // Commit batched `@resp_fname` responses, else they're lost on a planned reset.
+        // Considered doing a full LFS unmount here, but what if LFS is the cause of problems?
+        TCMD_resp_store_close_all();
         
         NVIC_SystemReset();
     }
@@ -205,9 +209,12 @@ static void subtask_reset_system_after_no_recent_uplinks(void) {
             time_since_last_uplink_sec,
             STM32_system_reset_no_uplink_interval_sec
         );
+        LOG_process_queued_messages(UINT32_MAX); // The logger task won't run again before the reset.
         HAL_Delay(1000); // Give time for the log to be sent.
 
-        // Considered doing an LFS unmount here, but what if LFS is the cause of problems?
+        // Commit batched `@resp_fname` responses, else they're lost on a planned reset.
+        // Considered doing a full LFS unmount here, but what if LFS is the cause of problems?
+        TCMD_resp_store_close_all();
         
         NVIC_SystemReset();
     }
@@ -276,7 +283,13 @@ static void subtask_send_beacon(void) {
             HAL_Delay(20); // Wait for the RF switch to settle. Should only take <100 nanoseconds.
         }
 
-        COMMS_downlink_beacon_basic_packet();
+        const uint8_t beacon_result = COMMS_downlink_beacon_basic_packet();
+        if (beacon_result != 0) {
+            LOG_message(
+                LOG_SYSTEM_UHF_RADIO, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_UHF_RADIO),
+                "Beacon downlink failed: COMMS_downlink_beacon_basic_packet() -> %d", beacon_result
+            );
+        }
         // TODO: If complex beacon packet is enabled, also send that too.
         COMMS_total_beacon_count_since_boot += 1;
 
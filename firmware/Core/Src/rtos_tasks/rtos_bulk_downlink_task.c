@@ -3,57 +3,128 @@
 
 #include "comms_drivers/bulk_file_downlink.h"
 #include "comms_drivers/comms_tx.h"
+#include "comms_drivers/ax100_tx.h"
+#include "comms_drivers/ax100_tx_pacing.h"
 #include "littlefs/lfs.h"
 #include "littlefs/littlefs_helper.h"
 #include "log/log.h"
 
 #include <string.h>
 
-/// @brief The period to wait between downlink packets.
+/// @brief The period between downlink packets (from the start of one to the start of the next).
 /// @note A 250-byte packet at 9600 baud takes about 208 ms to transmit.
+/// @note The time taken to read and send each packet is subtracted from the wait, so file reads
+///     don't lengthen the period.
 /// @example If you reconfigure the AX100 and increase the baudrate of the radio, decrease this value.
+/// @note Only used when `AX100_tx_pacing_enabled` is 0.
 uint32_t COMMS_bulk_downlink_delay_per_packet_ms = 208;
 
-static uint8_t bulk_file_data[COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET];
+/// @brief Downlink task action, in compressed mode (see `COMMS_bulk_file_downlink_start_compressed`).
+static void do_compressed_bulk_downlink_task_action(void) {
+    const uint8_t *packet_data;
+    uint16_t packet_len;
+    uint8_t is_last_packet;
+    const int32_t compress_result = COMMS_bulk_file_downlink_get_compressed_packet(
+        &packet_data, &packet_len, &is_last_packet
+    );
+    if (compress_result < 0) {
+        // Read error: nothing was consumed, so retry on the next cycle.
+        LOG_message(
+            LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
+            "Compressed bulk downlink: lfs_file_read() -> %ld",
+            compress_result
+        );
+        return;
+    }
+    else if (compress_result > 0) {
+        LOG_message(
+            LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
+            "Compressed bulk downlink: compression failed (%ld). Stopping. File: %s",
+            compress_result,
+            COMMS_bulk_file_downlink_file_path
+        );
+        COMMS_bulk_file_downlink_stop();
+        return;
+    }
+
+    // The last packet is empty when the previous one ended the stream exactly.
+    if (packet_len > 0) {
+        const uint8_t tx_result = COMMS_downlink_bulk_file_downlink_compressed(
+            COMMS_bulk_file_downlink_next_start_offset,
+            (uint8_t *)packet_data,
+            packet_len
+        );
+        if (tx_result != 0) {
+            LOG_message(
+                LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
+                "COMMS_downlink_bulk_file_downlink_compressed(byte_count=%d) -> tx_result=%d",
+                packet_len,
+                tx_result
+            );
+            return; // The same packet is retried on the next cycle.
+        }
+    }
+    COMMS_bulk_file_downlink_compressed_packet_sent();
+
+    if (is_last_packet) {
+        LOG_message(
+            LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE),
+            "Compressed bulk downlink complete. %ld bytes compressed to %ld bytes (%d packets) downlinked. File: %s",
+            COMMS_bulk_file_downlink_bytes_downlinked,
+            COMMS_bulk_file_downlink_next_start_offset,
+            COMMS_bulk_file_downlink_total_seq_num,
+            COMMS_bulk_file_downlink_file_path
+        );
+    }
+}
 
 /// @brief Downlink task action.
 /// @param  
 /// @note Expects that the state has already been checked to be COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING.
+/// @note Packets NACKed by the ground (`COMMS_bulk_file_downlink_nack`) are resent first.
 static void do_bulk_downlink_task_action(void) {
     if (COMMS_bulk_file_downlink_state != COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING) {
         return; // Safety check
     }
     
-    // Read the file data.
-    const uint32_t bytes_remaining = COMMS_bulk_file_downlink_total_bytes - COMMS_bulk_file_downlink_bytes_downlinked;
-    const uint16_t byte_count = 
-        bytes_remaining > COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET
-        ? COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET
-        : bytes_remaining;
-
-    const lfs_ssize_t read_result = lfs_file_read(
-        &LFS_filesystem,
-        &COMMS_bulk_file_downlink_file,
-        bulk_file_data,
-        byte_count
+    // Read the file data straight into the radio's TX buffer.
+    COMMS_bulk_file_downlink_packet_t *packet = COMMS_acquire_bulk_file_downlink_packet();
+    if (packet == NULL) {
+        return; // Logged by `AX100_acquire_tx_buffer`. Retry on the next cycle.
+    }
+    uint16_t seq_num;
+    uint32_t file_offset;
+    uint16_t byte_count;
+    const int32_t read_result = COMMS_bulk_file_downlink_read_next_packet(
+        packet->data, &seq_num, &file_offset, &byte_count
     );
     if (read_result < 0) {
+        AX100_release_tx_buffer((uint8_t *)packet);
         LOG_message(
             LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
-            "lfs_read(byte_count=%d) -> read_result=%ld",
-            byte_count,
+            "Bulk downlink: lfs_file_read() -> %ld",
             read_result
         );
         return;
     }
+    else if (read_result > 0) {
+        AX100_release_tx_buffer((uint8_t *)packet);
+        return; // Nothing to send.
+    }
 
     // Downlink the data.
-    const uint8_t tx_result = COMMS_downlink_bulk_file_downlink(
-        COMMS_bulk_file_downlink_next_seq_num,
-        COMMS_bulk_file_downlink_next_start_offset,
-        bulk_file_data,
-        byte_count
+    uint8_t tx_result = COMMS_start_bulk_file_downlink_packet(
+        packet, COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK, file_offset, byte_count
     );
+
+    // Read the next packets' data from flash while this packet is sent to the radio (and on air).
+    // On failure, the next packet's read retries (and logs the error).
+    COMMS_bulk_file_downlink_prefetch();
+
+    const uint8_t finish_result = AX100_finish_tx_buffer((uint8_t *)packet);
+    if (tx_result == 0) {
+        tx_result = finish_result;
+    }
     if (tx_result != 0) {
         LOG_message(
             LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
@@ -64,20 +135,15 @@ static void do_bulk_downlink_task_action(void) {
         return;
     }
 
-    // Update all the downlink stats.
-    COMMS_bulk_file_downlink_bytes_downlinked += byte_count;
-    COMMS_bulk_file_downlink_next_seq_num++;
-    COMMS_bulk_file_downlink_next_start_offset += byte_count;
-
-    // Check next-state logic if we're done.
-    if (COMMS_bulk_file_downlink_bytes_downlinked == COMMS_bulk_file_downlink_total_bytes) {
-        COMMS_bulk_file_downlink_state = COMMS_BULK_FILE_DOWNLINK_STATE_IDLE;
-
+    // Update all the downlink stats, and check next-state logic if we're done.
+    if (COMMS_bulk_file_downlink_packet_sent(seq_num, byte_count)) {
         LOG_message(
             LOG_SYSTEM_LFS, LOG_SEVERITY_NORMAL, LOG_all_sinks_except(LOG_SINK_FILE),
-            "Bulk downlink complete. %ld bytes (%d packets) downlinked. File: %s",
+            "Bulk downlink complete. %ld bytes (%d packets, %lu resent) downlinked. Transfer ID: %u. File: %s",
             COMMS_bulk_file_downlink_bytes_downlinked,
             COMMS_bulk_file_downlink_total_seq_num,
+            COMMS_bulk_file_downlink_retransmit_count,
+            COMMS_bulk_file_downlink_transfer_id,
             COMMS_bulk_file_downlink_file_path
         );
     }
@@ -94,15 +160,43 @@ void TASK_bulk_downlink(void *argument) {
             continue;
         }
         else if (COMMS_bulk_file_downlink_state == COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING) {
-            do_bulk_downlink_task_action();
+            const uint32_t packet_start_tick = osKernelGetTickCount();
+
+            // Held for the whole packet, so that a start/NACK/pause from the telecommand task
+            // can't swap the file or the encoder while a read is waiting on the flash.
+            COMMS_bulk_file_downlink_lock();
+            // Checked again, as it may have been paused or stopped while waiting for the lock.
+            if (COMMS_bulk_file_downlink_state == COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING) {
+                if (COMMS_bulk_file_downlink_is_compressed) {
+                    do_compressed_bulk_downlink_task_action();
+                }
+                else {
+                    do_bulk_downlink_task_action();
+                }
+            }
+            COMMS_bulk_file_downlink_unlock();
 
             // Delay to avoid flooding the radio with packets.
             // The AX100 seems to have a small queue, but can be overwhelmed easily.
-            if (COMMS_bulk_downlink_delay_per_packet_ms > 0) {
-                osDelay(COMMS_bulk_downlink_delay_per_packet_ms);
+            // Ticks are ms (configTICK_RATE_HZ = 1000).
+            const uint32_t elapsed_ms = osKernelGetTickCount() - packet_start_tick;
+            if (AX100_tx_pacing_enabled) {
+                // Wait until the radio's queue (as modelled from the bitrate and I2C stalls) can
+                // take the next packet.
+                const uint32_t wait_ms = AX100_get_tx_pacing_wait_ms();
+                if (wait_ms > 0) {
+                    osDelay(wait_ms);
+                }
+                else {
+                    osThreadYield();
+                }
+            }
+            else if (COMMS_bulk_downlink_delay_per_packet_ms > elapsed_ms) {
+                osDelay(COMMS_bulk_downlink_delay_per_packet_ms - elapsed_ms);
             }
             else {
-                // Optimization for on the ground (zero delay). Must yield otherwise this task starves others.
+                // Zero delay (optimization for on the ground), or the packet took the whole period.
+                // Must yield otherwise this task starves others.
                 osThreadYield();
             }
         }
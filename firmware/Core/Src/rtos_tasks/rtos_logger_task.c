@@ -0,0 +1,76 @@
+#include "rtos_tasks/rtos_logger_task.h"
+#include "rtos_tasks/rtos_task_helpers.h"
+
+#include "log/log.h"
+#include "log/log_queue.h"
+
+#include "cmsis_os.h"
+
+/// @brief The longest wait before checking the log queue again, when it is empty and the task
+///     was not woken.
+/// @note `LOG_message` wakes the task for each queued message, so this is only a fallback.
+uint32_t LOG_logger_task_idle_poll_period_ms = 1000;
+
+// Thread flag set by `TASK_logger_wake()`.
+#define TASK_LOGGER_WAKE_FLAG 0x01
+
+extern osThreadId_t TASK_logger_Handle;
+
+/// @brief Wake `TASK_logger` to write out the messages queued by `LOG_message`.
+/// @note Call from a task (not an ISR).
+void TASK_logger_wake(void) {
+    if (TASK_logger_Handle != NULL) {
+        osThreadFlagsSet(TASK_logger_Handle, TASK_LOGGER_WAKE_FLAG);
+    }
+}
+
+/// @brief Block the calling task for a tick, so that `TASK_logger` can write out queued messages.
+/// @return 0 after waiting, 1 if the caller can't wait for `TASK_logger` (it is `TASK_logger`,
+///     or the scheduler isn't running).
+/// @note Blocks rather than yields: with the cooperative scheduler, a yield only runs other tasks
+///     of the same priority.
+uint8_t TASK_logger_wait_for_queue_space(void) {
+    if (
+        (TASK_logger_Handle == NULL)
+        || (osKernelGetState() != osKernelRunning)
+        || (osThreadGetId() == TASK_logger_Handle)
+    ) {
+        return 1;
+    }
+    TASK_logger_wake();
+    osDelay(1);
+    return 0;
+}
+
+/// @brief Formats the messages queued by `LOG_message`, and writes them to the log sinks.
+/// @details Until this task starts, `LOG_message` writes out in the caller's context.
+void TASK_logger(void *argument) {
+    TASK_HELP_start_of_task();
+
+    // From here on, `LOG_message` queues messages for this task.
+    LOG_logger_task_is_running = 1;
+
+    uint32_t reported_dropped_count = 0;
+    while (1) {
+        // One record at a time: a sink may block (e.g., a UART transmit), so let the other tasks
+        // run in between.
+        if (LOG_process_queued_messages(1) > 0) {
+            osThreadYield();
+            continue;
+        }
+
+        // Report the messages dropped while the queue was full, once it has room again.
+        const uint32_t dropped_count = LOG_queue_stats.dropped_count;
+        if (dropped_count != reported_dropped_count) {
+            LOG_message(
+                LOG_SYSTEM_LOG, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
+                "Log queue full: dropped %lu messages (%lu since boot)",
+                dropped_count - reported_dropped_count, dropped_count
+            );
+            reported_dropped_count = dropped_count;
+            continue;
+        }
+
+        osThreadFlagsWait(TASK_LOGGER_WAKE_FLAG, osFlagsWaitAny, LOG_logger_task_idle_poll_period_ms);
+    }
+}
@@ -1,10 +1,12 @@
+#include "rtos_tasks/rtos_mpi_tasks.h"
 #include "rtos_tasks/rtos_task_helpers.h"
 #include "mpi/mpi_command_handling.h"
+#include "mpi/mpi_science_ring.h"
+#include "mpi/mpi_frame_index.h"
 #include "littlefs/littlefs_helper.h"
 #include "debug_tools/debug_uart.h"
 #include "cmsis_os.h"
 #include "log/log.h"
-#include "uart_handler/uart_handler.h"
 #include "timekeeping/timekeeping.h"
 #include "transforms/arrays.h"
 
@@ -20,6 +22,44 @@ uint32_t MPI_max_temperature_shutoff_celcius = 60;
 ///        schedule a stop telecommand for MPI data recording.
 uint32_t MPI_max_recording_duration_sec = 900;
 
+/// @brief Thread flag set by `TASK_service_write_mpi_data_wake_from_isr()`.
+#define TASK_SERVICE_WRITE_MPI_DATA_WAKE_FLAG 0x01
+
+/// @brief Number of science ring buffers between timestamps in the file. Keeps the file format of
+///     the former 20480 B ping-pong buffers: 20480 B of data, then a timestamp.
+#define MPI_SCIENCE_BUFFERS_PER_TIMESTAMP 10
+
+/// @brief Value of `MPI_last_avg_temperature_cC` when no new average is available.
+#define MPI_TEMPERATURE_NOT_READ_cC -99999
+
+/// @brief Average temperature of the last buffer followed by a timestamp, for the shutoff check.
+static int32_t MPI_last_avg_temperature_cC = MPI_TEMPERATURE_NOT_READ_cC;
+
+extern osThreadId_t TASK_service_write_mpi_data_Handle;
+
+// Serializes the consumers of the science ring and the science data file: this task, and
+// `MPI_disable_active_mode` (from the telecommand task or the self-check) for the final drain,
+// index and close. Needed because file writes yield in flash waits. Recursive, as this task also
+// calls `MPI_disable_active_mode`.
+static TASK_HELP_lazy_mutex_t MPI_science_file_mutex = TASK_HELP_LAZY_MUTEX_INIT("MPI_science_file_mutex");
+
+/// @brief Take the lock on the science ring's consumer side and the science data file.
+void MPI_science_file_lock(void) {
+    TASK_HELP_lazy_mutex_lock(&MPI_science_file_mutex);
+}
+
+/// @brief Release the lock taken by `MPI_science_file_lock`.
+void MPI_science_file_unlock(void) {
+    TASK_HELP_lazy_mutex_unlock(&MPI_science_file_mutex);
+}
+
+/// @brief Wake `TASK_service_write_mpi_data`, because a science ring buffer is full.
+/// @note ISR only (called from the MPI UART's DMA transfer-complete callback).
+void TASK_service_write_mpi_data_wake_from_isr(void) {
+    if (TASK_service_write_mpi_data_Handle != NULL) {
+        osThreadFlagsSet(TASK_service_write_mpi_data_Handle, TASK_SERVICE_WRITE_MPI_DATA_WAKE_FLAG);
+    }
+}
 
 static int8_t write_mpi_timestamp_to_file(uint32_t buffer_filled_uptime_ms) {
     // Write timestamp data (the time the buffer finished filling) to file.
@@ -65,17 +105,21 @@ static int8_t write_mpi_timestamp_to_file(uint32_t buffer_filled_uptime_ms) {
     return 0; // Success
 }
 
-static void write_mpi_data_to_memory(volatile uint8_t* large_buffer, uint32_t buffer_filled_uptime_ms) {
+static void write_mpi_data_to_memory(
+    const uint8_t* buffer, uint16_t buffer_len, uint32_t buffer_filled_uptime_ms,
+    uint8_t is_timestamp_due
+) {
     // Store the current time for this iteration
     const uint32_t start_time = TIME_uptime_ms();
 
     // Ensure LFS is mounted. Steamroll.
     LFS_ensure_mounted();
 
-    // Write science data to file.
+    // Write science data to file, straight from the buffer the DMA wrote it into.
+    const lfs_soff_t data_file_offset = lfs_file_tell(&LFS_filesystem, &MPI_science_data_file_pointer);
     const lfs_ssize_t write_data_result = lfs_file_write(
         &LFS_filesystem, &MPI_science_data_file_pointer,
-        (uint8_t*)large_buffer, MPI_science_buffer_len
+        buffer, buffer_len
     );
     if (write_data_result < 0) {
         LOG_message(
@@ -84,6 +128,13 @@ static void write_mpi_data_to_memory(volatile uint8_t* large_buffer, uint32_t bu
         );
         return; // Exit early if write failed
     }
+    if (data_file_offset >= 0) {
+        MPI_frame_index_add_data(buffer, buffer_len, (uint32_t)data_file_offset, buffer_filled_uptime_ms);
+    }
+
+    if (!is_timestamp_due) {
+        return;
+    }
 
     const int8_t write_timestamp_result = write_mpi_timestamp_to_file(buffer_filled_uptime_ms);
     if (write_timestamp_result < 0) {
@@ -96,24 +147,26 @@ static void write_mpi_data_to_memory(volatile uint8_t* large_buffer, uint32_t bu
 
     LOG_message(
         LOG_SYSTEM_MPI, LOG_SEVERITY_DEBUG, LOG_SINK_ALL,
-        "MPI Task: Successfully wrote %ld bytes to file in %lums",
+        "MPI Task: Successfully wrote %ld bytes to file in %lums (%lu buffers pending)",
         write_data_result,
-        TIME_uptime_ms() - start_time
+        TIME_uptime_ms() - start_time,
+        MPI_science_ring_pending_count()
     );
 }
 
 /// @brief Scan an MPI data buffer, averaging all temperature reports in it.
 /// @param large_buffer MPI data buffer input.
+/// @param large_buffer_len Number of bytes of data in `large_buffer`.
 /// @return Average temperature in 100ths of a degree Celsius (cC). Returns special value -9999 on error.
-int32_t read_avg_temperature_cC_from_mpi_data_buffer(
-    volatile uint8_t* large_buffer
+static int32_t read_avg_temperature_cC_from_mpi_data_buffer(
+    const uint8_t* large_buffer, uint32_t large_buffer_len
 ) {
     const uint8_t sync_pattern[4] = {0x0c, 0xff, 0xff, 0x0c};
 
     int64_t temp_sum_centi = 0;  // Use int64 to prevent overflow.
     uint32_t temp_count = 0;
 
-    for (uint32_t i = 0; i + 7 < MPI_science_buffer_len; i++) {
+    for (uint32_t i = 0; i + 7 < large_buffer_len; i++) {
         // Check sync pattern.
         if (large_buffer[i + 0] == sync_pattern[0] &&
             large_buffer[i + 1] == sync_pattern[1] &&
@@ -121,7 +174,7 @@ int32_t read_avg_temperature_cC_from_mpi_data_buffer(
             large_buffer[i + 3] == sync_pattern[3]
         ) {
             // Ensure temperature bytes are inside buffer.
-            if (i + 7 < MPI_science_buffer_len) {
+            if (i + 7 < large_buffer_len) {
                 // Assumption: Negative values will be handled gracefully by C, just
                 // by storing the value in a signed int.
                 const int16_t raw_temp =
@@ -147,41 +200,67 @@ int32_t read_avg_temperature_cC_from_mpi_data_buffer(
 }
 
 
+/// @brief Write every full science ring buffer to the science data file, oldest first.
+/// @return Number of buffers written.
+/// @note Called by `TASK_service_write_mpi_data`, and at the end of a recording (after the DMA is
+///     stopped) to write out the rest. Takes `MPI_science_file_lock`, so only one caller drains the
+///     ring at a time. Buffers which arrive after the file is closed are dropped.
+int32_t MPI_write_pending_science_buffers(void) {
+    if (MPI_science_ring_pending_count() == 0) {
+        return 0;
+    }
+    MPI_science_file_lock();
+
+    int32_t buffers_written = 0;
+    uint16_t buffer_len;
+    uint32_t buffer_filled_uptime_ms;
+    const uint8_t *buffer;
+    while ((buffer = MPI_science_ring_peek_full(&buffer_len, &buffer_filled_uptime_ms)) != NULL) {
+        if (!MPI_science_data_file_is_open) {
+            MPI_science_ring_release();
+            continue;
+        }
+
+        // The last buffer of a recording is usually partly filled. Follow it with a timestamp too.
+        const uint8_t is_timestamp_due = (
+            (((MPI_science_ring_stats.buffers_released + 1) % MPI_SCIENCE_BUFFERS_PER_TIMESTAMP) == 0)
+            || (buffer_len < MPI_SCIENCE_RING_BUFFER_SIZE_BYTES)
+        );
+        write_mpi_data_to_memory(buffer, buffer_len, buffer_filled_uptime_ms, is_timestamp_due);
+
+        if (is_timestamp_due) {
+            MPI_last_avg_temperature_cC = read_avg_temperature_cC_from_mpi_data_buffer(
+                buffer, buffer_len
+            );
+        }
+
+        MPI_science_ring_release();
+        buffers_written++;
+    }
+
+    MPI_science_file_unlock();
+    return buffers_written;
+}
+
+
 void TASK_service_write_mpi_data(void *argument) {
     TASK_HELP_start_of_task();
     osDelay(5000);
 
     while(1) {
-        int32_t last_mpi_temperature_cC = -99999;
+        // Woken by the MPI UART's ISR when a buffer is full. The timeout keeps the temperature and
+        // duration checks below running if the data stops.
+        osThreadFlagsWait(TASK_SERVICE_WRITE_MPI_DATA_WAKE_FLAG, osFlagsWaitAny, 250);
 
-        // If the first large buffer contains data to write
-        if (MPI_buffer_one_state == MPI_MEMORY_WRITE_STATUS_AWAITING_WRITE) {
-            write_mpi_data_to_memory(
-                MPI_science_buffer_one,
-                MPI_buffer_one_last_filled_uptime_ms
-            );
-            last_mpi_temperature_cC = read_avg_temperature_cC_from_mpi_data_buffer(
-                MPI_science_buffer_one
-            );
+        MPI_write_pending_science_buffers();
 
-            MPI_buffer_one_state = MPI_MEMORY_WRITE_STATUS_READY_TO_FILL;
-        }
-        else if (MPI_buffer_two_state == MPI_MEMORY_WRITE_STATUS_AWAITING_WRITE) {
-            write_mpi_data_to_memory(
-                MPI_science_buffer_two,
-                MPI_buffer_two_last_filled_uptime_ms
-            );
-            last_mpi_temperature_cC = read_avg_temperature_cC_from_mpi_data_buffer(
-                MPI_science_buffer_two
-            );
-
-            MPI_buffer_two_state = MPI_MEMORY_WRITE_STATUS_READY_TO_FILL;
-        }
+        const int32_t last_mpi_temperature_cC = MPI_last_avg_temperature_cC;
+        MPI_last_avg_temperature_cC = MPI_TEMPERATURE_NOT_READ_cC;
 
         // If we have a valid averaged temperature value available:
         // Note: If read_avg_temp_... fails (e.g., no frame), it returns -9999, which then gets
         // logged stilled. No power/stopping actions are taken with that value, as it's < 0 C.
-        if (last_mpi_temperature_cC != -99999) {
+        if (last_mpi_temperature_cC != MPI_TEMPERATURE_NOT_READ_cC) {
             LOG_message(
                 LOG_SYSTEM_MPI, LOG_SEVERITY_DEBUG, LOG_SINK_ALL,
                 "MPI Task: Last avg temperature: %ld cC", last_mpi_temperature_cC
@@ -220,9 +299,5 @@ void TASK_service_write_mpi_data(void *argument) {
                 MPI_disable_active_mode(MPI_REASON_FOR_STOPPING_MAX_TIME_EXCEEDED);
             }
         }
-
-        // Do a short delay always to allow recording to start right away once enabled
-        // (for the very first packet of a recording session).
-        osDelay(100);
     }
 }
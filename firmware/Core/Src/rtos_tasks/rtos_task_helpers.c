@@ -7,3 +7,41 @@
 void TASK_HELP_start_of_task(void) {
     osDelay(100);
 }
+
+/// @brief Take a `TASK_HELP_lazy_mutex_t`, creating it first if needed.
+/// @return 0 on success (or before the scheduler starts), 1 if the mutex can't be created,
+///     2 if it can't be acquired.
+uint8_t TASK_HELP_lazy_mutex_lock(TASK_HELP_lazy_mutex_t *lazy_mutex) {
+    // Before the scheduler starts, there is only one thread of execution.
+    if (osKernelGetState() != osKernelRunning) {
+        return 0;
+    }
+    if (lazy_mutex->handle == NULL) {
+        // Created on first use. The scheduler is cooperative, so no other task can race this.
+        const osMutexAttr_t attributes = {
+            .name = lazy_mutex->name,
+            .attr_bits = osMutexRecursive | osMutexPrioInherit,
+        };
+        lazy_mutex->handle = osMutexNew(&attributes);
+        if (lazy_mutex->handle == NULL) {
+            return 1;
+        }
+    }
+    if (osMutexAcquire(lazy_mutex->handle, osWaitForever) != osOK) {
+        return 2;
+    }
+    return 0;
+}
+
+/// @brief Release a `TASK_HELP_lazy_mutex_t` taken by `TASK_HELP_lazy_mutex_lock`.
+/// @return 0 on success (or if there is nothing to release), 2 if the release fails.
+uint8_t TASK_HELP_lazy_mutex_unlock(TASK_HELP_lazy_mutex_t *lazy_mutex) {
+    // Skip unlocks which pair with a lock taken before the scheduler started.
+    if ((lazy_mutex->handle == NULL) || (osMutexGetOwner(lazy_mutex->handle) != osThreadGetId())) {
+        return 0;
+    }
+    if (osMutexRelease(lazy_mutex->handle) != osOK) {
+        return 2;
+    }
+    return 0;
+}
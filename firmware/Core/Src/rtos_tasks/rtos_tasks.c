@@ -4,6 +4,7 @@
 #include "rtos_tasks/rtos_tasks.h"
 #include "telecommand_exec/telecommand_parser.h"
 #include "telecommand_exec/telecommand_executor.h"
+#include "telecommand_exec/telecommand_response_store.h"
 #include "debug_tools/debug_uart.h"
 #include "timekeeping/timekeeping.h"
 #include "uart_handler/uart_handler.h"
@@ -66,6 +67,20 @@ void TASK_DEBUG_print_heartbeat(void *argument) {
 
 static char main_response_output_buffer[TCMD_MAX_RESPONSE_BUFFER_LENGTH];
 
+// Thread flag set by `TASK_execute_telecommands_wake()`.
+#define TASK_EXECUTE_TELECOMMANDS_WAKE_FLAG 0x01
+
+extern osThreadId_t TASK_execute_telecommands_Handle;
+
+/// @brief Wake `TASK_execute_telecommands` before the end of its period, so that a telecommand
+///     which was just added to the agenda is executed without waiting for the next period.
+/// @note Call from a task (not an ISR).
+void TASK_execute_telecommands_wake(void) {
+    if (TASK_execute_telecommands_Handle != NULL) {
+        osThreadFlagsSet(TASK_execute_telecommands_Handle, TASK_EXECUTE_TELECOMMANDS_WAKE_FLAG);
+    }
+}
+
 void TASK_execute_telecommands(void *argument) {
     TASK_HELP_start_of_task();
 
@@ -73,22 +88,27 @@ void TASK_execute_telecommands(void *argument) {
     // 250ms is a good period, because it takes 208 ms to uplink a max-sized (250-byte) telecommand
     // at 9600 baud. Therefore, period=250ms makes it so that telecommands will be executed as fast
     // as they are uplinked.
-    // Adding a short path nested loop that continues executing commands while they're available
-    // is unnecessary. It is helpful to have a slight delay between commands to prevent flooding
-    // the system with commands (hence the watchdog minimum interval being 200ms).
-    // Conclusion: All parts of the system can handle 4 commands per second.
+    // The RX tasks wake this task early when they add a telecommand to the agenda, so that
+    // immediate telecommands don't wait out the period. The watchdog is still only petted once
+    // per period, and each wake still executes at most `TCMD_max_consecutive_burst_execution_size`
+    // telecommands, so a flood of commands is limited by the uplink rate.
     const uint32_t task_period_for_watchdog_pet_ms = 250;
 
     // Cannot pet the watchdog too quickly on boot.
     osDelay(task_period_for_watchdog_pet_ms * 2);
 
+    uint32_t last_watchdog_pet_ms = 0;
+
     while (1) {
         // DEBUG_uart_print_str("TASK_execute_telecommands -> top of while(1)\n");
         // Pet the watchdog. Has min and max intervals. This is the nominal place the watchdog is petted.
         // This is a good place to pet, because it basically says "if the satellite stops responding
         // (executing telecommands), reboot it".
-        STM32_pet_watchdog();
-        const uint32_t last_watchdog_pet_ms = TIME_uptime_ms();
+        // If woken early (by a new telecommand), skip the pet until a full period has passed.
+        if ((last_watchdog_pet_ms == 0) || (TIME_uptime_ms() - last_watchdog_pet_ms >= task_period_for_watchdog_pet_ms)) {
+            STM32_pet_watchdog();
+            last_watchdog_pet_ms = TIME_uptime_ms();
+        }
 
         // Execute [potentially] several commands back-to-back if several are available.
         // Normally we want to execute a single command, then yield. However, if several commands
@@ -124,8 +144,12 @@ void TASK_execute_telecommands(void *argument) {
             osDelay(1); // Very brief yield with consecutive telecommands.
         }
 
+        // Commit batched `@resp_fname` responses which have been pending for too long.
+        TCMD_resp_store_flush_if_due();
+
         // Note: Short yield here only; execute all pending telecommands back-to-back.
-        osDelay(task_period_for_watchdog_pet_ms);
+        // Returns early if an RX task calls `TASK_execute_telecommands_wake()`.
+        osThreadFlagsWait(TASK_EXECUTE_TELECOMMANDS_WAKE_FLAG, osFlagsWaitAny, task_period_for_watchdog_pet_ms);
     } /* End Task's Main Loop */
 }
 
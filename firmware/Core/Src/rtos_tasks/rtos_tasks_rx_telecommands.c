@@ -3,6 +3,7 @@
 
 #include "main.h"
 #include "rtos_tasks/rtos_task_helpers.h"
+#include "rtos_tasks/rtos_tasks.h"
 #include "rtos_tasks/rtos_tasks_rx_telecommands.h"
 #include "telecommand_exec/telecommand_parser.h"
 #include "telecommand_exec/telecommand_executor.h"
@@ -21,122 +22,39 @@
 /// @brief The system uptime, as of the last time a telecommand was received by the AX100 (and sent to OBC via KISS)
 uint32_t AX100_uptime_at_last_received_kiss_tcmd_ms = 0;
 
-/// @brief The interval between handling telecommands (parsing and adding to agenda) from the umbilical UART.
-/// @details Any value from 1ms to millions is reasonable. 20ms is a good value for optimized bulk uplink.
-/// Note: Does not include execution.
-uint32_t TCMD_handle_umbilical_tcmds_interval_ms = 400;
-
-/// @brief The interval between handling telecommands (parsing and adding to agenda) uplinked via the UHF radio.
-/// Note: Does not include execution.
-/// Decrease this to 200ms-250ms (or lower) if bulk uplinking large amounts of data (e.g., firmware).
-uint32_t TCMD_handle_ax100_tcmds_interval_ms = 400;
-
-
 typedef enum {
     TCMD_CHECK_STATUS_NO_TCMD = 0,
     TCMD_CHECK_STATUS_TCMD_SCHEDULED = 1,
     TCMD_CHECK_STATUS_TCMD_INVALID_AND_DISCARDED = 2,
 } TCMD_check_result_enum_t;
 
-/// @brief Checks for an available telecommand in the UART buffer, and schedules it for execution.
-/// @return 0 if no telecommand was available; 1 if a telecommand was found and executed.
+/// @brief Parses a telecommand received over the umbilical UART, and schedules it for execution.
+/// @param frame The frame received by the UART ISR.
+/// @param frame_len The number of bytes in `frame->data`.
+/// @return The status of the telecommand.
 /// @note This function is only used in this file.
-/// @note Global extern variables used:
-///     - UART_telecommand_buffer
-///     - UART_telecommand_buffer_write_idx
-///     - UART_telecommand_last_write_time_ms
-static TCMD_check_result_enum_t check_for_and_handle_new_uart_tcmds() {
-    const uint32_t timeout_duration_ms = 100; // CONFIGURATION PARAMETER
-
-    char latest_tcmd[UART_telecommand_buffer_len];
-    uint16_t latest_tcmd_len = 0;
-    
-    // Unnecessary, but good for safety.
-    memset(latest_tcmd, 0, UART_telecommand_buffer_len);
-    latest_tcmd_len = 0; // 0 means no telecommand available (checked later).
-
-    // Debugging: Log the state of the UART buffer.
-    // char msg[256];
-    // snprintf(msg, sizeof(msg), "UART telecommand buffer: write_index=%d, last_time=%lums\n", UART_telecommand_buffer_write_idx, UART_telecommand_last_write_time_ms);
-    // DEBUG_uart_print_str(msg);
+static TCMD_check_result_enum_t handle_uart_tcmd_frame(
+    const UART_telecommand_rx_frame_t *frame, uint16_t frame_len
+) {
+    // One more than the max frame length, for the null terminator.
+    char latest_tcmd[UART_TELECOMMAND_MAX_FRAME_SIZE_BYTES + 1];
 
-    if (UART_telecommand_buffer_write_idx == 0) {
-        // If we haven't received any telecommands, there is nothing to do here.
+    if (frame_len == 0) {
         return TCMD_CHECK_STATUS_NO_TCMD;
     }
 
-    if (
-        // If the end-of-message character was NOT received:
-        GEN_get_index_of_substring_in_array(
-            (char*) UART_telecommand_buffer,
-            UART_telecommand_buffer_write_idx,
-            "!"
-        ) < 0
-    ) {
-        // If timed out on reception:
-        if (TIME_uptime_ms() - UART_telecommand_last_write_time_ms > timeout_duration_ms) {
-            // If the telecommand is not complete, discard it.
-
-            // Null-terminate the string, then log it.
-            UART_telecommand_buffer[UART_telecommand_buffer_write_idx] = '\0';
-            LOG_message(
-                LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-                "Received incomplete telecommand. Discarding incomplete telecommand: '%s'",
-                UART_telecommand_buffer
-            );
-            UART_telecommand_buffer_write_idx = 0;
-            return TCMD_CHECK_STATUS_TCMD_INVALID_AND_DISCARDED;
-        }
-        else {
-            // Keep waiting for a timeout or a complete telecommand.
-            return TCMD_CHECK_STATUS_NO_TCMD;
-        }
-    }
+    memcpy(latest_tcmd, frame->data, frame_len);
+    latest_tcmd[frame_len] = '\0';
 
-    // Set `latest_tcmd_len` to the length of the telecommand.
-    const int16_t idx_of_last_char_in_tcmd = GEN_get_index_of_substring_in_array(
-        (char*) UART_telecommand_buffer,
-        UART_telecommand_buffer_write_idx,
-        "!"
-    );
-    if (idx_of_last_char_in_tcmd < 0) { // -1 indicates "string not found".
-        // If the telecommand is not complete, discard it.
+    // The ISR ends each frame at the end-of-message character. Anything else is incomplete.
+    if (latest_tcmd[frame_len - 1] != '!') {
         LOG_message(
-            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_CRITICAL, LOG_SINK_ALL,
-            "Should not happen: incomplete telecommand. Discarding incomplete telecommand."
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Received incomplete telecommand. Discarding incomplete telecommand: '%s'",
+            latest_tcmd
         );
-        UART_telecommand_buffer_write_idx = 0;
         return TCMD_CHECK_STATUS_TCMD_INVALID_AND_DISCARDED;
     }
-    else {
-        // End-of-message character found. Use the buffer up to that point.
-        latest_tcmd_len = ((uint16_t) idx_of_last_char_in_tcmd) + 1;
-    }
-    
-    // `memcpy()`, but volatile-compatible.
-    for (uint16_t i = 0; i < latest_tcmd_len; i++) {
-        latest_tcmd[i] = (char) UART_telecommand_buffer[i];
-    }
-    // Set the null terminator at the end of the `latest_tcmd` str.
-    latest_tcmd[latest_tcmd_len] = '\0';
-
-    // Shift or clear the buffer.
-    if (latest_tcmd_len == UART_telecommand_buffer_write_idx) {
-        // If the telecommand is the whole buffer, simply clear the buffer.
-        UART_telecommand_buffer_write_idx = 0;
-    }
-    else {
-        // Shift the buffer to the left by `latest_tcmd_len` bytes. Can't use memcpy.
-        for (uint16_t i = latest_tcmd_len; i < UART_telecommand_buffer_write_idx; i++) {
-            UART_telecommand_buffer[i - latest_tcmd_len] = (char) UART_telecommand_buffer[i];
-        }
-        // Update the write index.
-        UART_telecommand_buffer_write_idx -= latest_tcmd_len;
-    }
-
-    if (latest_tcmd_len == 0) {
-        return TCMD_CHECK_STATUS_NO_TCMD;
-    }
 
     // Parse the telecommand
     TCMD_parsed_tcmd_to_execute_t parsed_tcmd;
@@ -150,9 +68,13 @@ static TCMD_check_result_enum_t check_for_and_handle_new_uart_tcmds() {
         );
         return TCMD_CHECK_STATUS_TCMD_INVALID_AND_DISCARDED;
     }
+    parsed_tcmd.rx_source = TCMD_RX_SOURCE_UMBILICAL_UART;
+    parsed_tcmd.uptime_at_rx_ms = frame->uptime_at_rx_ms;
 
     // Add the telecommand to the agenda (regardless of whether it's in the future).
-    TCMD_add_tcmd_to_agenda(&parsed_tcmd);
+    if (TCMD_add_tcmd_to_agenda(&parsed_tcmd) == 0) {
+        TASK_execute_telecommands_wake();
+    }
 
     return TCMD_CHECK_STATUS_TCMD_SCHEDULED;
 }
@@ -161,46 +83,25 @@ static TCMD_check_result_enum_t check_for_and_handle_new_uart_tcmds() {
 void TASK_handle_uart_telecommands(void *argument) {
     TASK_HELP_start_of_task();
 
+    // Static, as it's too large to put on the stack comfortably.
+    static UART_telecommand_rx_frame_t frame;
+
     while (1) {
-        // Place the main delay at the top to avoid a "continue" statement skipping it.
-        osDelay(TCMD_handle_umbilical_tcmds_interval_ms);
-
-        // Continue checking and scheduling telecommands until there are no more to process.
-        while (1) {
-            const TCMD_check_result_enum_t check_result = check_for_and_handle_new_uart_tcmds();
-
-            if (check_result == TCMD_CHECK_STATUS_NO_TCMD) {
-                break;
-            }
-            else if (check_result == TCMD_CHECK_STATUS_TCMD_SCHEDULED) {
-                // Nothing to do. Keep looping.
-                continue;
-            }
-            else if (check_result == TCMD_CHECK_STATUS_TCMD_INVALID_AND_DISCARDED) {
-                // Could either continue OR break here. Will break though, which just means that
-                // rapid invalid telecommands will get parsed rather slowly.
-                break;
-            }
-            else {
-                // This should never happen.
-                LOG_message(
-                    LOG_SYSTEM_OBC, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-                    "Error: check_for_and_handle_new_uart_tcmds() returned an invalid value: %u",
-                    check_result
-                );
-            }
-        }
+        // Blocks until the UART ISR sends a frame. There is nothing to do until then.
+        const uint16_t frame_len = UART_receive_telecommand_frame(&frame, UINT32_MAX);
+        handle_uart_tcmd_frame(&frame, frame_len);
     } /* End Task's Main Loop */
 }
 
 
-/// @brief Checks for an available telecommand in the UART buffer, and schedules it for execution.
-/// @return 0 if no telecommand was available; 1 if a telecommand was found and executed.
+/// @brief Parses a telecommand received from the AX100, and schedules it for execution.
+/// @return The status of the telecommand.
 /// @param csp_packet_array The CSP packet to read, starting with 4 bytes of CSP, and reading until null-termination after the CSP header.
 /// @param csp_packet_array_len The length of the `csp_packet_array`.
+/// @param uptime_at_rx_ms `TIME_uptime_ms()` when the AX100 finished sending the frame to the OBC.
 /// @note This function is only used in this file.
 static TCMD_check_result_enum_t check_for_and_handle_new_ax100_kiss_tcmd(
-    uint8_t csp_packet_array[], uint16_t csp_packet_array_len
+    const uint8_t csp_packet_array[], uint16_t csp_packet_array_len, uint32_t uptime_at_rx_ms
 ) {
     char latest_tcmd[csp_packet_array_len];
     uint16_t latest_tcmd_len = 0;
@@ -288,8 +189,13 @@ static TCMD_check_result_enum_t check_for_and_handle_new_ax100_kiss_tcmd(
         return TCMD_CHECK_STATUS_TCMD_INVALID_AND_DISCARDED;
     }
 
+    parsed_tcmd.rx_source = TCMD_RX_SOURCE_AX100;
+    parsed_tcmd.uptime_at_rx_ms = uptime_at_rx_ms;
+
     // Add the telecommand to the agenda (regardless of whether it's in the future).
-    TCMD_add_tcmd_to_agenda(&parsed_tcmd);
+    if (TCMD_add_tcmd_to_agenda(&parsed_tcmd) == 0) {
+        TASK_execute_telecommands_wake();
+    }
 
     AX100_uptime_at_last_received_kiss_tcmd_ms = TIME_uptime_ms();
 
@@ -300,20 +206,14 @@ static TCMD_check_result_enum_t check_for_and_handle_new_ax100_kiss_tcmd(
 void TASK_handle_ax100_kiss_telecommands(void *argument) {
     TASK_HELP_start_of_task();
 
+    // Static, as it's too large to put on the stack comfortably.
+    static AX100_kiss_frame_struct_t frame;
+
     while (1) {
-        // Place the main delay at the top to avoid a "continue" statement skipping it.
-        osDelay(TCMD_handle_ax100_tcmds_interval_ms);
-
-        // Continue checking and scheduling telecommands until there are no more to process.
-        while (UART_AX100_kiss_frame_queue_tail != UART_AX100_kiss_frame_queue_head) {
-            AX100_kiss_frame_struct_t *f = (AX100_kiss_frame_struct_t*)&UART_AX100_kiss_frame_queue[UART_AX100_kiss_frame_queue_tail];
-            
-            check_for_and_handle_new_ax100_kiss_tcmd(
-                f->data, f->len
-            );
-            // Don't bother checking the result; keep processing all queued frames.
-
-            UART_AX100_kiss_frame_queue_tail = (UART_AX100_kiss_frame_queue_tail + 1) % AX100_MAX_KISS_FRAMES_IN_RX_QUEUE;
-        }
+        // Blocks until the UART ISR sends a complete KISS frame. There is nothing to do until then.
+        const uint16_t frame_len = UART_receive_ax100_kiss_frame(&frame, UINT32_MAX);
+
+        check_for_and_handle_new_ax100_kiss_tcmd(frame.data, frame_len, frame.uptime_at_rx_ms);
+        // Don't bother checking the result; keep processing all queued frames.
     } /* End Task's Main Loop */
 }
@@ -61,9 +61,13 @@ volatile unsigned long ulHighFrequencyTimerTicks = 0;
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_i2c1_tx;
 extern I2C_HandleTypeDef hi2c1;
+extern DMA_HandleTypeDef hdma_lpuart1_rx;
 extern DMA_HandleTypeDef hdma_uart4_rx;
+extern DMA_HandleTypeDef hdma_uart5_rx;
 extern DMA_HandleTypeDef hdma_usart1_rx;
+extern DMA_HandleTypeDef hdma_usart3_rx;
 extern UART_HandleTypeDef hlpuart1;
 extern UART_HandleTypeDef huart5;
 extern UART_HandleTypeDef huart2;
@@ -124,7 +128,7 @@ void HardFault_Handler(void)
     // Could do this part nicer and with less external dependency, but will do this for now.
     // Logging to UHF Radio appears to work well here. Logs to file are hit-and-miss.
     LOG_message(
-      LOG_SYSTEM_OBC, LOG_SEVERITY_CRITICAL, LOG_SINK_ALL, msg
+      LOG_SYSTEM_OBC, LOG_SEVERITY_CRITICAL, LOG_SINK_ALL, "%s", msg
     );
     LOG_emergency_sync_current_log_file();
 
@@ -167,7 +171,7 @@ void MemManage_Handler(void)
     // Could do this part nicer and with less external dependency, but will do this for now.
     // Logging to UHF Radio appears to work well here. Logs to file are hit-and-miss.
     LOG_message(
-      LOG_SYSTEM_OBC, LOG_SEVERITY_CRITICAL, LOG_SINK_ALL, msg
+      LOG_SYSTEM_OBC, LOG_SEVERITY_CRITICAL, LOG_SINK_ALL, "%s", msg
     );
     LOG_emergency_sync_current_log_file();
 
@@ -211,7 +215,7 @@ void BusFault_Handler(void)
     // Could do this part nicer and with less external dependency, but will do this for now.
     // Logging to UHF Radio appears to work well here. Logs to file are hit-and-miss.
     LOG_message(
-      LOG_SYSTEM_OBC, LOG_SEVERITY_CRITICAL, LOG_SINK_ALL, msg
+      LOG_SYSTEM_OBC, LOG_SEVERITY_CRITICAL, LOG_SINK_ALL, "%s", msg
     );
     LOG_emergency_sync_current_log_file();
 
@@ -255,7 +259,7 @@ void UsageFault_Handler(void)
     // Could do this part nicer and with less external dependency, but will do this for now.
     // Logging to UHF Radio appears to work well here. Logs to file are hit-and-miss.
     LOG_message(
-      LOG_SYSTEM_OBC, LOG_SEVERITY_CRITICAL, LOG_SINK_ALL, msg
+      LOG_SYSTEM_OBC, LOG_SEVERITY_CRITICAL, LOG_SINK_ALL, "%s", msg
     );
     LOG_emergency_sync_current_log_file();
 
@@ -347,6 +351,48 @@ void DMA1_Channel4_IRQHandler(void)
   /* USER CODE END DMA1_Channel4_IRQn 1 */
 }
 
+/**
+  * @brief This function handles DMA1 channel5 global interrupt.
+  */
+void DMA1_Channel5_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel5_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel5_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_lpuart1_rx);
+  /* USER CODE BEGIN DMA1_Channel5_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel5_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 channel6 global interrupt.
+  */
+void DMA1_Channel6_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel6_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel6_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_uart5_rx);
+  /* USER CODE BEGIN DMA1_Channel6_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel6_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 channel7 global interrupt.
+  */
+void DMA1_Channel7_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel7_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel7_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart3_rx);
+  /* USER CODE BEGIN DMA1_Channel7_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel7_IRQn 1 */
+}
+
 /**
   * @brief This function handles TIM1 update interrupt and TIM16 global interrupt.
   */
@@ -467,6 +513,20 @@ void TIM6_DAC_IRQHandler(void)
   /* USER CODE END TIM6_DAC_IRQn 1 */
 }
 
+/**
+  * @brief This function handles DMA2 channel1 global interrupt.
+  */
+void DMA2_Channel1_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Channel1_IRQn 0 */
+
+  /* USER CODE END DMA2_Channel1_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_i2c1_tx);
+  /* USER CODE BEGIN DMA2_Channel1_IRQn 1 */
+
+  /* USER CODE END DMA2_Channel1_IRQn 1 */
+}
+
 /**
   * @brief This function handles LPUART1 global interrupt.
   */
@@ -4,6 +4,10 @@
 #include "telecommand_exec/telecommand_executor.h"
 #include "littlefs/littlefs_helper.h"
 #include "log/log.h"
+#include "rtos_tasks/rtos_task_helpers.h"
+
+#include <stdio.h>
+#include <string.h>
 
 /// @brief When `TCMD_active_agenda_filename` is set to this value, agenda loading is disabled.
 char *TCMD_active_agenda_filename_disabled_sentinel = "DISABLED";
@@ -22,59 +26,77 @@ char *TCMD_active_agenda_filename_default_file = "default_tcmd_agenda.txt";
 /// @note Set this to "DISABLED" (case-sensitive) to disable this feature entirely.
 char TCMD_active_agenda_filename[LFS_MAX_PATH_LENGTH] = "default_tcmd_agenda.txt";
 
+/// @brief Boolean. Whether to load agenda files through their index file (1), or by parsing the
+///     whole agenda file on every run (0).
+/// @note The whole file is also parsed if the index can't be built (e.g., filesystem full).
+uint32_t TCMD_agenda_file_use_index = 1;
 
-/// @brief Parses a file of telecommands and enqueues them into the agenda.
-/// @param file_path Path to file with one telecommand per line.
-/// @param min_tsexec_inclusive Filter to only telecommands with `tsexec` greater than or equal to this value.
-/// @param max_tsexec_exclusive Filter to only telecommands with `tsexec` less than this value.
-/// @param max_enqueue_count Maximum number of telecommands to enqueue. Stop after this many successes. Mostly for safety.
-/// @return 0 on success.
-/// @details The file should have one telecommand per line, like so: `CTS1+xxx(...)!\nCTS1+yyy(...)!\n`
-/// @note Obeys all the rules about enqueuing duplicate tssent telecommands. Recommend having unique @tssent values
-///     for each telecommand, and enabling the `TCMD_require_unique_tssent` config option.
-uint8_t TCMD_parse_tcmds_from_file_and_enqueue(
-    const char *file_path,
-    uint64_t min_tsexec_inclusive, uint64_t max_tsexec_exclusive,
-    uint16_t max_enqueue_count
-) {
-    if (strcmp(file_path, TCMD_active_agenda_filename_disabled_sentinel) == 0) {
-        return 0; // Success.
-    }
+TCMD_agenda_file_index_state_t TCMD_agenda_file_index_state;
 
-    // Open the file.
-    lfs_file_t agenda_file;
-    const int8_t open_result = lfs_file_open(
-        &LFS_filesystem, &agenda_file,
-        file_path, LFS_O_RDONLY
-    );
-    if (open_result < 0) {
-        LOG_message(
-            LOG_SYSTEM_TELECOMMAND,
-            (
-                // If it's the default agenda file, make this a debug log because it's quite
-                // expected that this file doesn't exist.
-                (strcmp(file_path, TCMD_active_agenda_filename_default_file) == 0) ?
-                LOG_SEVERITY_DEBUG : LOG_SEVERITY_ERROR
-            ),
-            LOG_SINK_ALL,
-            "LFS error attempting to open agenda file: %d",
-            open_result
-        );
-        return 5;
-    }
+// Serializes the agenda file index (`TCMD_agenda_file_index_state` and the `.idx` files) between
+// the background upkeep task's agenda loads and the telecommand task's rebuilds/invalidations
+// (bulk uplink close, `fs_*` writes). Needed because LittleFS calls yield in flash waits. Recursive.
+static TASK_HELP_lazy_mutex_t TCMD_agenda_file_index_mutex = TASK_HELP_LAZY_MUTEX_INIT("TCMD_agenda_file_index_mutex");
+
+/// @brief Take the lock on the agenda file index.
+static void TCMD_agenda_file_index_lock(void) {
+    TASK_HELP_lazy_mutex_lock(&TCMD_agenda_file_index_mutex);
+}
+
+/// @brief Release the lock taken by `TCMD_agenda_file_index_lock`.
+static void TCMD_agenda_file_index_unlock(void) {
+    TASK_HELP_lazy_mutex_unlock(&TCMD_agenda_file_index_mutex);
+}
+
+#define TCMD_AGENDA_FILE_INDEX_MAGIC 0x58444954 // "TIDX", little-endian.
+
+// Number of index records read or written per LittleFS call.
+#define TCMD_AGENDA_FILE_INDEX_RECORDS_PER_BATCH 8
+
+/// @brief Called by `TCMD_agenda_file_scan` for each telecommand in the agenda file.
+/// @return 0 to continue scanning, 1 to stop.
+typedef uint8_t (*TCMD_agenda_file_scan_callback_t)(
+    const char *tcmd_str, uint32_t tcmd_offset, uint16_t tcmd_len, void *context
+);
+
+typedef struct {
+    uint64_t min_tsexec_inclusive;
+    uint64_t max_tsexec_exclusive;
+    uint16_t max_enqueue_count;
+
+    uint32_t tcmd_count_success_enqueued;
+    uint32_t tcmd_count_success_but_filtered;
+    uint32_t tcmd_count_failed_parsing;
+    uint32_t tcmd_count_failed_enqueue;
+} TCMD_agenda_file_enqueue_context_t;
+
+typedef struct {
+    lfs_file_t *index_file;
+    TCMD_agenda_file_index_record_t batch[TCMD_AGENDA_FILE_INDEX_RECORDS_PER_BATCH];
+    uint8_t batch_count;
+
+    uint32_t record_count;
+    uint64_t last_timestamp_to_execute;
+    uint8_t is_sorted;
+    uint32_t tcmd_count_failed_parsing;
+    int32_t write_error;
+} TCMD_agenda_file_index_build_context_t;
 
+
+/// @brief Reads the agenda file from its current position to the end, calling `callback` for each
+///     `!\n`-terminated telecommand.
+/// @return 0 on success, 6 on read error, 7 if a line is too long, 8 if a telecommand is too long.
+static uint8_t TCMD_agenda_file_scan(
+    lfs_file_t *agenda_file, TCMD_agenda_file_scan_callback_t callback, void *context
+) {
     char file_chunk[TCMD_MAX_FULL_LENGTH];
     char line_buf[TCMD_MAX_FULL_LENGTH * 2];
     size_t line_len = 0;
+    uint32_t line_buf_file_offset = 0; // File offset of `line_buf[0]`.
 
-    uint32_t tcmd_count_success_enqueued = 0;
-    uint32_t tcmd_count_success_but_filtered = 0;
-    uint32_t tcmd_count_failed_parsing = 0;
-
-    // Parse the file.
     while (1) {
         const lfs_ssize_t read_result = lfs_file_read(
-            &LFS_filesystem, &agenda_file,
+            &LFS_filesystem, agenda_file,
             file_chunk, sizeof(file_chunk)
         );
         if (read_result < 0) {
@@ -82,11 +104,10 @@ uint8_t TCMD_parse_tcmds_from_file_and_enqueue(
                 LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
                 "Error reading agenda file: %ld", read_result
             );
-            lfs_file_close(&LFS_filesystem, &agenda_file);
             return 6;
         }
         if (read_result == 0) {
-            break; // End of file
+            return 0; // End of file
         }
 
         // Parse the chunk, looking for a delimiter.
@@ -96,7 +117,6 @@ uint8_t TCMD_parse_tcmds_from_file_and_enqueue(
                 LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
                 "TCMD buffer overflow while parsing agenda file (maybe line too long)."
             );
-            lfs_file_close(&LFS_filesystem, &agenda_file);
             return 7;
         }
 
@@ -123,60 +143,571 @@ uint8_t TCMD_parse_tcmds_from_file_and_enqueue(
                     LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
                     "TCMD too long in agenda file."
                 );
-                lfs_file_close(&LFS_filesystem, &agenda_file);
                 return 8;
             }
 
             memcpy(tcmd_str, &line_buf[start_idx], tcmd_len);
             tcmd_str[tcmd_len] = '\0';
 
-            // Parse telecommand.
-            TCMD_parsed_tcmd_to_execute_t parsed;
-            const uint8_t parse_result = TCMD_parse_full_telecommand(
-                tcmd_str, &parsed
+            const uint8_t stop = callback(
+                tcmd_str, line_buf_file_offset + start_idx, tcmd_len, context
             );
 
-            if (parse_result == 0) {
-                // Apply tsexec filter.
-                if (parsed.timestamp_to_execute >= min_tsexec_inclusive &&
-                    parsed.timestamp_to_execute < max_tsexec_exclusive
-                ) {
-                    // Enqueue the command.
-                    TCMD_add_tcmd_to_agenda(&parsed);
-                    tcmd_count_success_enqueued++;
-                }
-                else {
-                    tcmd_count_success_but_filtered++;
-                }
-            } else {
-                LOG_message(
-                    LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-                    "Agenda File: Failed to parse TCMD: %s (err=%u)", tcmd_str, parse_result
-                );
-                tcmd_count_failed_parsing++;
-            }
-
             // Move start past this command.
             start_idx = i + 2;
             i++; // skip '\n'
+
+            if (stop) {
+                return 0;
+            }
         }
 
         // Shift remaining partial data to front.
         if (start_idx > 0) {
             memmove(line_buf, &line_buf[start_idx], line_len - start_idx);
             line_len -= start_idx;
+            line_buf_file_offset += start_idx;
         }
+    }
+}
 
-        // Check if we've hit the limit.
-        if (tcmd_count_success_enqueued >= max_enqueue_count) {
-            LOG_message(
-                LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
-                "Agenda File: Reached max enqueue count (%lu). Shouldn't normally happen.",
-                tcmd_count_success_enqueued
-            );
+/// @brief Parses one telecommand from the agenda file, and enqueues it if it's in the tsexec window.
+/// @return 1 if the max enqueue count has been reached (stop loading), 0 otherwise.
+static uint8_t TCMD_agenda_file_enqueue_tcmd_str(
+    const char *tcmd_str, TCMD_agenda_file_enqueue_context_t *context
+) {
+    TCMD_parsed_tcmd_to_execute_t parsed;
+    const uint8_t parse_result = TCMD_parse_full_telecommand(tcmd_str, &parsed);
+    if (parse_result != 0) {
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Agenda File: Failed to parse TCMD: %s (err=%u)", tcmd_str, parse_result
+        );
+        context->tcmd_count_failed_parsing++;
+        return 0;
+    }
+
+    // Apply tsexec filter.
+    if (parsed.timestamp_to_execute < context->min_tsexec_inclusive ||
+        parsed.timestamp_to_execute >= context->max_tsexec_exclusive
+    ) {
+        context->tcmd_count_success_but_filtered++;
+        return 0;
+    }
+
+    // Enqueue the command. `TCMD_add_tcmd_to_agenda` logs the reason if it's rejected.
+    if (TCMD_add_tcmd_to_agenda(&parsed) != 0) {
+        context->tcmd_count_failed_enqueue++;
+        return 0;
+    }
+    context->tcmd_count_success_enqueued++;
+
+    // Check if we've hit the limit.
+    if (context->tcmd_count_success_enqueued >= context->max_enqueue_count) {
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
+            "Agenda File: Reached max enqueue count (%lu). Shouldn't normally happen.",
+            context->tcmd_count_success_enqueued
+        );
+        return 1;
+    }
+    return 0;
+}
+
+static uint8_t TCMD_agenda_file_enqueue_scan_callback(
+    const char *tcmd_str, uint32_t tcmd_offset, uint16_t tcmd_len, void *context
+) {
+    return TCMD_agenda_file_enqueue_tcmd_str(tcmd_str, (TCMD_agenda_file_enqueue_context_t *)context);
+}
+
+/// @brief Gets the size of the agenda file and the CRC of its tail, to detect a changed file.
+/// @return 0 on success, 1 on LittleFS error.
+/// @note Moves the file position.
+/// @note Only catches appends and edits near the end. Writers drop the index explicitly (see
+///     `TCMD_agenda_file_invalidate_index`); this is a backstop for other writers.
+static uint8_t TCMD_agenda_file_fingerprint(
+    lfs_file_t *agenda_file, uint32_t *file_size, uint32_t *tail_crc
+) {
+    const lfs_soff_t size = lfs_file_size(&LFS_filesystem, agenda_file);
+    if (size < 0) {
+        return 1;
+    }
+
+    uint8_t tail[TCMD_AGENDA_FILE_FINGERPRINT_TAIL_BYTES];
+    const uint32_t tail_len = (size < (lfs_soff_t)sizeof(tail)) ? (uint32_t)size : sizeof(tail);
+    if (lfs_file_seek(&LFS_filesystem, agenda_file, size - tail_len, LFS_SEEK_SET) < 0) {
+        return 1;
+    }
+    if (lfs_file_read(&LFS_filesystem, agenda_file, tail, tail_len) != (lfs_ssize_t)tail_len) {
+        return 1;
+    }
+
+    *file_size = (uint32_t)size;
+    *tail_crc = lfs_crc(0xFFFFFFFF, tail, tail_len);
+    return 0;
+}
+
+static void TCMD_agenda_file_get_index_path(const char *file_path, char *index_path, size_t index_path_size) {
+    snprintf(index_path, index_path_size, "%s%s", file_path, TCMD_AGENDA_FILE_INDEX_SUFFIX);
+}
+
+/// @brief Writes the batched index records to the index file.
+/// @return 0 on success, 1 on LittleFS error (stored in `context->write_error`).
+static uint8_t TCMD_agenda_file_index_flush_batch(TCMD_agenda_file_index_build_context_t *context) {
+    if (context->batch_count == 0) {
+        return 0;
+    }
+    const lfs_size_t batch_size = context->batch_count * sizeof(TCMD_agenda_file_index_record_t);
+    const lfs_ssize_t write_result = lfs_file_write(
+        &LFS_filesystem, context->index_file, context->batch, batch_size
+    );
+    context->batch_count = 0;
+    if (write_result != (lfs_ssize_t)batch_size) {
+        context->write_error = (write_result < 0) ? write_result : LFS_ERR_NOSPC;
+        return 1;
+    }
+    return 0;
+}
+
+static uint8_t TCMD_agenda_file_index_build_callback(
+    const char *tcmd_str, uint32_t tcmd_offset, uint16_t tcmd_len, void *context_ptr
+) {
+    TCMD_agenda_file_index_build_context_t *context = (TCMD_agenda_file_index_build_context_t *)context_ptr;
+
+    TCMD_parsed_tcmd_to_execute_t parsed;
+    const uint8_t parse_result = TCMD_parse_full_telecommand(tcmd_str, &parsed);
+    if (parse_result != 0) {
+        // Not indexed, so it's only logged once (here), rather than on every load.
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Agenda File: Failed to parse TCMD: %s (err=%u)", tcmd_str, parse_result
+        );
+        context->tcmd_count_failed_parsing++;
+        return 0;
+    }
+
+    if ((context->record_count > 0) && (parsed.timestamp_to_execute < context->last_timestamp_to_execute)) {
+        context->is_sorted = 0;
+    }
+    context->last_timestamp_to_execute = parsed.timestamp_to_execute;
+
+    TCMD_agenda_file_index_record_t *record = &context->batch[context->batch_count++];
+    record->timestamp_to_execute = parsed.timestamp_to_execute;
+    record->offset = tcmd_offset;
+    record->length = tcmd_len;
+    record->reserved = 0;
+    context->record_count++;
+
+    if (context->batch_count == TCMD_AGENDA_FILE_INDEX_RECORDS_PER_BATCH) {
+        return TCMD_agenda_file_index_flush_batch(context);
+    }
+    return 0;
+}
+
+/// @brief `TCMD_agenda_file_build_index`, with `TCMD_agenda_file_index_lock` held.
+static uint8_t TCMD_agenda_file_build_index_with_lock_held(const char *file_path) {
+    TCMD_agenda_file_index_state_t *state = &TCMD_agenda_file_index_state;
+    state->is_loaded = 0;
+    state->is_cursor_valid = 0;
+
+    char index_path[LFS_MAX_PATH_LENGTH + sizeof(TCMD_AGENDA_FILE_INDEX_SUFFIX)];
+    TCMD_agenda_file_get_index_path(file_path, index_path, sizeof(index_path));
+
+    lfs_file_t agenda_file;
+    const int32_t open_result = lfs_file_open(&LFS_filesystem, &agenda_file, file_path, LFS_O_RDONLY);
+    if (open_result < 0) {
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Agenda File: LFS error attempting to open agenda file to index: %ld", open_result
+        );
+        return 5;
+    }
+
+    TCMD_agenda_file_index_header_t header;
+    memset(&header, 0, sizeof(header));
+    if (TCMD_agenda_file_fingerprint(&agenda_file, &header.agenda_file_size, &header.agenda_file_tail_crc) != 0
+        || lfs_file_seek(&LFS_filesystem, &agenda_file, 0, LFS_SEEK_SET) < 0
+    ) {
+        lfs_file_close(&LFS_filesystem, &agenda_file);
+        return 6;
+    }
+
+    lfs_file_t index_file;
+    const int32_t index_open_result = lfs_file_open(
+        &LFS_filesystem, &index_file, index_path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC
+    );
+    if (index_open_result < 0) {
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Agenda File: LFS error attempting to open index file: %ld", index_open_result
+        );
+        lfs_file_close(&LFS_filesystem, &agenda_file);
+        return 9;
+    }
+
+    // The header is written (with the magic number) last, so a partial index is never valid.
+    TCMD_agenda_file_index_build_context_t context = {
+        .index_file = &index_file,
+        .batch_count = 0,
+        .record_count = 0,
+        .last_timestamp_to_execute = 0,
+        .is_sorted = 1,
+        .tcmd_count_failed_parsing = 0,
+        .write_error = 0,
+    };
+    uint8_t result = 0;
+    if (lfs_file_write(&LFS_filesystem, &index_file, &header, sizeof(header)) != sizeof(header)) {
+        result = 9;
+    }
+    if (result == 0) {
+        result = TCMD_agenda_file_scan(&agenda_file, TCMD_agenda_file_index_build_callback, &context);
+    }
+    if ((result == 0) && (TCMD_agenda_file_index_flush_batch(&context) != 0 || context.write_error != 0)) {
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Agenda File: LFS error writing index file: %ld", context.write_error
+        );
+        result = 9;
+    }
+    if (result == 0) {
+        header.magic = TCMD_AGENDA_FILE_INDEX_MAGIC;
+        header.record_count = context.record_count;
+        header.is_sorted = context.is_sorted;
+        if (lfs_file_seek(&LFS_filesystem, &index_file, 0, LFS_SEEK_SET) < 0
+            || lfs_file_write(&LFS_filesystem, &index_file, &header, sizeof(header)) != sizeof(header)
+        ) {
+            result = 9;
+        }
+    }
+
+    lfs_file_close(&LFS_filesystem, &agenda_file);
+    if (lfs_file_close(&LFS_filesystem, &index_file) != 0 && result == 0) {
+        result = 9;
+    }
+    if (result != 0) {
+        lfs_remove(&LFS_filesystem, index_path);
+        return result;
+    }
+
+    snprintf(state->agenda_file_path, sizeof(state->agenda_file_path), "%s", file_path);
+    state->header = header;
+    state->is_loaded = 1;
+    state->index_build_count++;
+
+    LOG_message(
+        LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "Agenda File: Indexed %lu telecommands (%s) from '%s'. Failed to parse %lu.",
+        header.record_count,
+        header.is_sorted ? "in tsexec order" : "not in tsexec order",
+        file_path,
+        context.tcmd_count_failed_parsing
+    );
+    return 0;
+}
+
+/// @brief Builds the index file (`<file_path>.idx`) of an agenda file, with the tsexec and
+///     byte offset of each telecommand.
+/// @param file_path Path to the agenda file.
+/// @return 0 on success, 5 if the agenda file can't be opened, 6/7/8 for agenda file read/format
+///     errors (see `TCMD_parse_tcmds_from_file_and_enqueue`), 9 if the index file can't be written.
+/// @note Called automatically when an agenda file is loaded and its index is missing or stale.
+///     Call after uploading an agenda file to do the full pass then, rather than at load time.
+uint8_t TCMD_agenda_file_build_index(const char *file_path) {
+    TCMD_agenda_file_index_lock();
+    const uint8_t result = TCMD_agenda_file_build_index_with_lock_held(file_path);
+    TCMD_agenda_file_index_unlock();
+    return result;
+}
+
+/// @brief Drops the index of a file which is about to be (or was just) written or deleted, in RAM
+///     and on the filesystem, so that it's rebuilt from the new contents on the next load.
+/// @param file_path Path of the file being written. Any file may later become the agenda file.
+/// @note Call from every path which writes or deletes a file on ground request (bulk uplink, `fs_*`
+///     telecommands). The size/tail-CRC check on load only catches appends and tail edits.
+void TCMD_agenda_file_invalidate_index(const char *file_path) {
+    TCMD_agenda_file_index_lock();
+    TCMD_agenda_file_index_state_t *state = &TCMD_agenda_file_index_state;
+    if (strcmp(state->agenda_file_path, file_path) == 0) {
+        state->is_loaded = 0;
+        state->is_cursor_valid = 0;
+    }
+
+    char index_path[LFS_MAX_PATH_LENGTH + sizeof(TCMD_AGENDA_FILE_INDEX_SUFFIX)];
+    TCMD_agenda_file_get_index_path(file_path, index_path, sizeof(index_path));
+    if (LFS_is_lfs_mounted) {
+        lfs_remove(&LFS_filesystem, index_path); // LFS_ERR_NOENT for files which were never indexed.
+    }
+    TCMD_agenda_file_index_unlock();
+}
+
+/// @brief Makes `TCMD_agenda_file_index_state` hold the index of the agenda file, loading it from
+///     the index file, or (re)building the index file if it's missing or stale.
+/// @return 0 if the index is loaded, >0 if the agenda file must be read without the index.
+static uint8_t TCMD_agenda_file_load_index(const char *file_path, lfs_file_t *agenda_file) {
+    TCMD_agenda_file_index_state_t *state = &TCMD_agenda_file_index_state;
+
+    uint32_t file_size;
+    uint32_t tail_crc;
+    if (TCMD_agenda_file_fingerprint(agenda_file, &file_size, &tail_crc) != 0) {
+        return 1;
+    }
+
+    if (state->is_loaded
+        && (strcmp(state->agenda_file_path, file_path) == 0)
+        && (state->header.agenda_file_size == file_size)
+        && (state->header.agenda_file_tail_crc == tail_crc)
+    ) {
+        return 0;
+    }
+    state->is_loaded = 0;
+    state->is_cursor_valid = 0;
+
+    // Not the most-recent agenda file (or first load since boot); check the index file.
+    char index_path[LFS_MAX_PATH_LENGTH + sizeof(TCMD_AGENDA_FILE_INDEX_SUFFIX)];
+    TCMD_agenda_file_get_index_path(file_path, index_path, sizeof(index_path));
+
+    TCMD_agenda_file_index_header_t header;
+    lfs_file_t index_file;
+    if (lfs_file_open(&LFS_filesystem, &index_file, index_path, LFS_O_RDONLY) >= 0) {
+        const lfs_ssize_t read_result = lfs_file_read(&LFS_filesystem, &index_file, &header, sizeof(header));
+        lfs_file_close(&LFS_filesystem, &index_file);
+
+        if ((read_result == sizeof(header))
+            && (header.magic == TCMD_AGENDA_FILE_INDEX_MAGIC)
+            && (header.agenda_file_size == file_size)
+            && (header.agenda_file_tail_crc == tail_crc)
+        ) {
+            snprintf(state->agenda_file_path, sizeof(state->agenda_file_path), "%s", file_path);
+            state->header = header;
+            state->is_loaded = 1;
+            return 0;
+        }
+    }
+
+    LOG_message(
+        LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "Agenda File: Index of '%s' is missing or stale. Rebuilding.", file_path
+    );
+    return TCMD_agenda_file_build_index_with_lock_held(file_path);
+}
+
+/// @brief Reads consecutive records from an open index file.
+/// @return 0 on success, 1 on LittleFS error.
+static uint8_t TCMD_agenda_file_index_read_records(
+    lfs_file_t *index_file, uint32_t first_record_idx,
+    TCMD_agenda_file_index_record_t records[], uint32_t record_count
+) {
+    const lfs_soff_t offset = (
+        sizeof(TCMD_agenda_file_index_header_t)
+        + (first_record_idx * sizeof(TCMD_agenda_file_index_record_t))
+    );
+    if (lfs_file_seek(&LFS_filesystem, index_file, offset, LFS_SEEK_SET) < 0) {
+        return 1;
+    }
+    const lfs_ssize_t read_size = record_count * sizeof(TCMD_agenda_file_index_record_t);
+    if (lfs_file_read(&LFS_filesystem, index_file, records, read_size) != read_size) {
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Finds the first record with tsexec >= `timestamp_to_execute`, in a sorted index file.
+/// @return 0 on success, 1 on LittleFS error.
+static uint8_t TCMD_agenda_file_index_lower_bound(
+    lfs_file_t *index_file, uint32_t record_count, uint64_t timestamp_to_execute, uint32_t *result_record_idx
+) {
+    uint32_t low = 0;
+    uint32_t high = record_count;
+    while (low < high) {
+        const uint32_t mid = low + ((high - low) / 2);
+        TCMD_agenda_file_index_record_t record;
+        if (TCMD_agenda_file_index_read_records(index_file, mid, &record, 1) != 0) {
+            return 1;
+        }
+        TCMD_agenda_file_index_state.last_records_read_count++;
+
+        if (record.timestamp_to_execute < timestamp_to_execute) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    *result_record_idx = low;
+    return 0;
+}
+
+/// @brief Enqueues the telecommands in the tsexec window, reading only their records and lines.
+/// @return 0 on success, 6 on agenda file read error, 9 on index file error.
+/// @note For a sorted index, continues from the cursor if this window starts where the last one
+///     ended; otherwise, binary searches for the start of the window.
+static uint8_t TCMD_agenda_file_enqueue_with_index(
+    const char *file_path, lfs_file_t *agenda_file, TCMD_agenda_file_enqueue_context_t *context
+) {
+    TCMD_agenda_file_index_state_t *state = &TCMD_agenda_file_index_state;
+    const TCMD_agenda_file_index_header_t *header = &state->header;
+
+    char index_path[LFS_MAX_PATH_LENGTH + sizeof(TCMD_AGENDA_FILE_INDEX_SUFFIX)];
+    TCMD_agenda_file_get_index_path(file_path, index_path, sizeof(index_path));
+
+    lfs_file_t index_file;
+    if (lfs_file_open(&LFS_filesystem, &index_file, index_path, LFS_O_RDONLY) < 0) {
+        state->is_loaded = 0;
+        return 9;
+    }
+
+    uint8_t result = 0;
+    uint32_t record_idx = 0;
+    if (header->is_sorted) {
+        if (state->is_cursor_valid && (state->cursor_min_tsexec == context->min_tsexec_inclusive)) {
+            record_idx = state->cursor_record_idx;
+        }
+        else if (TCMD_agenda_file_index_lower_bound(
+            &index_file, header->record_count, context->min_tsexec_inclusive, &record_idx) != 0
+        ) {
+            result = 9;
+        }
+    }
+
+    uint8_t stop = 0;
+    while ((result == 0) && !stop && (record_idx < header->record_count)) {
+        TCMD_agenda_file_index_record_t batch[TCMD_AGENDA_FILE_INDEX_RECORDS_PER_BATCH];
+        uint32_t batch_count = header->record_count - record_idx;
+        if (batch_count > TCMD_AGENDA_FILE_INDEX_RECORDS_PER_BATCH) {
+            batch_count = TCMD_AGENDA_FILE_INDEX_RECORDS_PER_BATCH;
+        }
+        if (TCMD_agenda_file_index_read_records(&index_file, record_idx, batch, batch_count) != 0) {
+            result = 9;
             break;
         }
+        state->last_records_read_count += batch_count;
+
+        for (uint32_t batch_idx = 0; batch_idx < batch_count; batch_idx++) {
+            const TCMD_agenda_file_index_record_t *record = &batch[batch_idx];
+            if (header->is_sorted && (record->timestamp_to_execute >= context->max_tsexec_exclusive)) {
+                stop = 1;
+                break;
+            }
+            record_idx++;
+
+            // Only reachable for an unsorted index, or when continuing after the max enqueue count.
+            if (record->timestamp_to_execute < context->min_tsexec_inclusive
+                || record->timestamp_to_execute >= context->max_tsexec_exclusive
+            ) {
+                continue;
+            }
+
+            char tcmd_str[TCMD_MAX_FULL_LENGTH];
+            if ((record->length >= sizeof(tcmd_str))
+                || (lfs_file_seek(&LFS_filesystem, agenda_file, record->offset, LFS_SEEK_SET) < 0)
+                || (lfs_file_read(&LFS_filesystem, agenda_file, tcmd_str, record->length) != record->length)
+            ) {
+                LOG_message(
+                    LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+                    "Agenda File: Error reading indexed TCMD at offset %lu.", record->offset
+                );
+                result = 6;
+                break;
+            }
+            tcmd_str[record->length] = '\0';
+
+            if (TCMD_agenda_file_enqueue_tcmd_str(tcmd_str, context)) {
+                stop = 1;
+                break;
+            }
+        }
+    }
+
+    lfs_file_close(&LFS_filesystem, &index_file);
+
+    if (result != 0) {
+        // Rebuild on the next load, in case the index file is damaged.
+        state->is_loaded = 0;
+        state->is_cursor_valid = 0;
+        return result;
+    }
+
+    if (header->is_sorted) {
+        // The next window nominally starts where this one ended.
+        state->cursor_record_idx = record_idx;
+        state->cursor_min_tsexec = context->max_tsexec_exclusive;
+        state->is_cursor_valid = 1;
+    }
+    return 0;
+}
+
+/// @brief Parses a file of telecommands and enqueues them into the agenda.
+/// @param file_path Path to file with one telecommand per line.
+/// @param min_tsexec_inclusive Filter to only telecommands with `tsexec` greater than or equal to this value.
+/// @param max_tsexec_exclusive Filter to only telecommands with `tsexec` less than this value.
+/// @param max_enqueue_count Maximum number of telecommands to enqueue. Stop after this many successes. Mostly for safety.
+/// @return 0 on success, 5 if the file can't be opened, 6 on read error, 7 if a line is too long,
+///     8 if a telecommand is too long, 9 on index file error.
+/// @details The file should have one telecommand per line, like so: `CTS1+xxx(...)!\nCTS1+yyy(...)!\n`
+/// @details The telecommands are found through the agenda file's index file (see
+///     `TCMD_agenda_file_build_index`), so only the telecommands in the window are read and parsed.
+///     When the agenda file is in tsexec order, consecutive windows continue from a cursor.
+///     If the index is disabled (`TCMD_agenda_file_use_index`) or can't be built, the whole file is parsed.
+/// @note Obeys all the rules about enqueuing duplicate tssent telecommands. Recommend having unique @tssent values
+///     for each telecommand, and enabling the `TCMD_require_unique_tssent` config option.
+uint8_t TCMD_parse_tcmds_from_file_and_enqueue(
+    const char *file_path,
+    uint64_t min_tsexec_inclusive, uint64_t max_tsexec_exclusive,
+    uint16_t max_enqueue_count
+) {
+    if (strcmp(file_path, TCMD_active_agenda_filename_disabled_sentinel) == 0) {
+        return 0; // Success.
+    }
+
+    // Open the file.
+    lfs_file_t agenda_file;
+    const int8_t open_result = lfs_file_open(
+        &LFS_filesystem, &agenda_file,
+        file_path, LFS_O_RDONLY
+    );
+    if (open_result < 0) {
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND,
+            (
+                // If it's the default agenda file, make this a debug log because it's quite
+                // expected that this file doesn't exist.
+                (strcmp(file_path, TCMD_active_agenda_filename_default_file) == 0) ?
+                LOG_SEVERITY_DEBUG : LOG_SEVERITY_ERROR
+            ),
+            LOG_SINK_ALL,
+            "LFS error attempting to open agenda file: %d",
+            open_result
+        );
+        return 5;
+    }
+
+    TCMD_agenda_file_enqueue_context_t context = {
+        .min_tsexec_inclusive = min_tsexec_inclusive,
+        .max_tsexec_exclusive = max_tsexec_exclusive,
+        .max_enqueue_count = max_enqueue_count,
+        .tcmd_count_success_enqueued = 0,
+        .tcmd_count_success_but_filtered = 0,
+        .tcmd_count_failed_parsing = 0,
+        .tcmd_count_failed_enqueue = 0,
+    };
+
+    // The index is also (re)built from the telecommand task (bulk uplink close, `fs_*` writes).
+    TCMD_agenda_file_index_lock();
+    TCMD_agenda_file_index_state.last_records_read_count = 0;
+
+    uint8_t result;
+    uint8_t used_index = 0;
+    if (TCMD_agenda_file_use_index && (TCMD_agenda_file_load_index(file_path, &agenda_file) == 0)) {
+        result = TCMD_agenda_file_enqueue_with_index(file_path, &agenda_file, &context);
+        used_index = 1;
+    }
+    else if (lfs_file_seek(&LFS_filesystem, &agenda_file, 0, LFS_SEEK_SET) < 0) {
+        result = 6;
     }
+    else {
+        result = TCMD_agenda_file_scan(&agenda_file, TCMD_agenda_file_enqueue_scan_callback, &context);
+    }
+    TCMD_agenda_file_index_unlock();
 
     const int8_t close_result = lfs_file_close(&LFS_filesystem, &agenda_file);
     if (close_result != 0) {
@@ -187,23 +718,29 @@ uint8_t TCMD_parse_tcmds_from_file_and_enqueue(
         // Streamroll to print logs.
     }
 
-    if (tcmd_count_failed_parsing > 0) {
+    const uint32_t tcmd_count_parsed = (
+        context.tcmd_count_success_enqueued + context.tcmd_count_success_but_filtered
+        + context.tcmd_count_failed_enqueue
+    );
+    if (context.tcmd_count_failed_parsing > 0) {
         LOG_message(
             LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
             "Agenda File: Failed to parse %lu/%lu telecommands from agenda file.",
-            tcmd_count_failed_parsing,
-            tcmd_count_success_enqueued + tcmd_count_success_but_filtered + tcmd_count_failed_parsing
+            context.tcmd_count_failed_parsing,
+            tcmd_count_parsed + context.tcmd_count_failed_parsing
         );
     }
 
     LOG_message(
         LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
-        "Agenda File: Parsed %lu telecommands and enqueued %lu. Failed to parse %lu/%lu telecommands.",
-        tcmd_count_success_enqueued + tcmd_count_success_but_filtered,
-        tcmd_count_success_enqueued,
-        tcmd_count_failed_parsing,
-        tcmd_count_success_enqueued + tcmd_count_success_but_filtered + tcmd_count_failed_parsing
+        "Agenda File: Parsed %lu telecommands and enqueued %lu (%lu rejected by the agenda). Failed to parse %lu/%lu telecommands. %s",
+        tcmd_count_parsed,
+        context.tcmd_count_success_enqueued,
+        context.tcmd_count_failed_enqueue,
+        context.tcmd_count_failed_parsing,
+        tcmd_count_parsed + context.tcmd_count_failed_parsing,
+        used_index ? "Loaded via index." : "Loaded by full scan."
     );
 
-    return 0; // Success.
+    return result;
 }
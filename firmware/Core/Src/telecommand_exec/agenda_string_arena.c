@@ -0,0 +1,146 @@
+#include "telecommand_exec/agenda_string_arena.h"
+#include "telecommand_exec/telecommand_executor.h"
+
+#include <string.h>
+
+// Handle value in a block header which marks the block as freed.
+#define TCMD_ARENA_FREED_HANDLE 0xFFFF
+
+/// @brief Storage for the variable-length strings of the agenda entries.
+/// @details Blocks are appended one after another. Each block is a header (owner handle, then
+///          total block length, each uint16_t), then the args string and the response filename,
+///          each null-terminated. Freed blocks stay in place until the next compaction.
+static uint8_t TCMD_arena[TCMD_ARENA_SIZE_BYTES];
+
+/// @brief Offset into `TCMD_arena` of the block owned by each handle (agenda slot number).
+/// @note Only meaningful where `TCMD_arena_block_is_valid[handle]` is set.
+static uint16_t TCMD_arena_block_offset[TCMD_AGENDA_SIZE];
+static uint8_t TCMD_arena_block_is_valid[TCMD_AGENDA_SIZE];
+
+/// @brief Offset of the end of the last block. New blocks are appended here.
+static uint16_t TCMD_arena_end_offset = 0;
+
+/// @brief Number of bytes in blocks which are not freed (including their headers).
+static uint16_t TCMD_arena_live_bytes = 0;
+
+/// @brief Number of times the arena has been compacted (for telemetry/benchmarks).
+uint32_t TCMD_arena_compaction_count = 0;
+
+
+static inline void TCMD_arena_read_header(uint16_t offset, uint16_t *handle, uint16_t *block_len) {
+    memcpy(handle, &TCMD_arena[offset], sizeof(uint16_t));
+    memcpy(block_len, &TCMD_arena[offset + sizeof(uint16_t)], sizeof(uint16_t));
+}
+
+static inline void TCMD_arena_write_header(uint16_t offset, uint16_t handle, uint16_t block_len) {
+    memcpy(&TCMD_arena[offset], &handle, sizeof(uint16_t));
+    memcpy(&TCMD_arena[offset + sizeof(uint16_t)], &block_len, sizeof(uint16_t));
+}
+
+/// @brief Slides all live blocks down to the start of the arena, removing the freed gaps.
+/// @note O(TCMD_ARENA_SIZE_BYTES). Only runs when an append doesn't fit at the end.
+static void TCMD_arena_compact() {
+    uint16_t read_offset = 0;
+    uint16_t write_offset = 0;
+    while (read_offset < TCMD_arena_end_offset) {
+        uint16_t handle;
+        uint16_t block_len;
+        TCMD_arena_read_header(read_offset, &handle, &block_len);
+
+        if (handle != TCMD_ARENA_FREED_HANDLE) {
+            if (write_offset != read_offset) {
+                memmove(&TCMD_arena[write_offset], &TCMD_arena[read_offset], block_len);
+            }
+            TCMD_arena_block_offset[handle] = write_offset;
+            write_offset += block_len;
+        }
+        read_offset += block_len;
+    }
+    TCMD_arena_end_offset = write_offset;
+    TCMD_arena_compaction_count++;
+}
+
+/// @brief Stores the strings of an agenda entry in the arena, at their actual length.
+/// @param handle The owner of the strings (the agenda slot number). Must not already own a block.
+/// @param args_str The args string (null-terminated, at most `TCMD_ARGS_STR_NO_PARENS_SIZE` incl. null).
+/// @param resp_fname The response filename (null-terminated, at most `TCMD_MAX_RESP_FNAME_LEN` incl. null).
+/// @return 0 on success, 1 if the arena is full (even after compaction), 2 if `handle` is invalid.
+uint8_t TCMD_arena_store(uint16_t handle, const char args_str[], const char resp_fname[]) {
+    if ((handle >= TCMD_AGENDA_SIZE) || TCMD_arena_block_is_valid[handle]) {
+        return 2;
+    }
+
+    const uint16_t args_size = strnlen(args_str, TCMD_ARGS_STR_NO_PARENS_SIZE - 1) + 1;
+    const uint16_t resp_fname_size = strnlen(resp_fname, TCMD_MAX_RESP_FNAME_LEN - 1) + 1;
+    const uint16_t block_len = TCMD_ARENA_BLOCK_HEADER_SIZE_BYTES + args_size + resp_fname_size;
+
+    if (TCMD_arena_end_offset + block_len > TCMD_ARENA_SIZE_BYTES) {
+        if (TCMD_arena_live_bytes + block_len > TCMD_ARENA_SIZE_BYTES) {
+            return 1;
+        }
+        TCMD_arena_compact();
+    }
+
+    const uint16_t offset = TCMD_arena_end_offset;
+    TCMD_arena_write_header(offset, handle, block_len);
+    char *strings = (char *)&TCMD_arena[offset + TCMD_ARENA_BLOCK_HEADER_SIZE_BYTES];
+    memcpy(strings, args_str, args_size - 1);
+    strings[args_size - 1] = '\0';
+    memcpy(&strings[args_size], resp_fname, resp_fname_size - 1);
+    strings[args_size + resp_fname_size - 1] = '\0';
+
+    TCMD_arena_block_offset[handle] = offset;
+    TCMD_arena_block_is_valid[handle] = 1;
+    TCMD_arena_end_offset += block_len;
+    TCMD_arena_live_bytes += block_len;
+    return 0;
+}
+
+/// @brief Gets the args string stored for `handle`.
+/// @return Pointer into the arena, or an empty string if `handle` has no block.
+/// @warning The pointer is only valid until the next `TCMD_arena_store()`, which may compact the arena.
+const char* TCMD_arena_get_args_str(uint16_t handle) {
+    if ((handle >= TCMD_AGENDA_SIZE) || !TCMD_arena_block_is_valid[handle]) {
+        return "";
+    }
+    return (const char *)&TCMD_arena[TCMD_arena_block_offset[handle] + TCMD_ARENA_BLOCK_HEADER_SIZE_BYTES];
+}
+
+/// @brief Gets the response filename stored for `handle`.
+/// @return Pointer into the arena, or an empty string if `handle` has no block.
+/// @warning The pointer is only valid until the next `TCMD_arena_store()`, which may compact the arena.
+const char* TCMD_arena_get_resp_fname(uint16_t handle) {
+    if ((handle >= TCMD_AGENDA_SIZE) || !TCMD_arena_block_is_valid[handle]) {
+        return "";
+    }
+    const char *args_str = TCMD_arena_get_args_str(handle);
+    return args_str + strlen(args_str) + 1;
+}
+
+/// @brief Frees the block owned by `handle`. Does nothing if it has no block.
+void TCMD_arena_free(uint16_t handle) {
+    if ((handle >= TCMD_AGENDA_SIZE) || !TCMD_arena_block_is_valid[handle]) {
+        return;
+    }
+    const uint16_t offset = TCMD_arena_block_offset[handle];
+    uint16_t block_handle;
+    uint16_t block_len;
+    TCMD_arena_read_header(offset, &block_handle, &block_len);
+
+    TCMD_arena_write_header(offset, TCMD_ARENA_FREED_HANDLE, block_len);
+    TCMD_arena_block_is_valid[handle] = 0;
+    TCMD_arena_live_bytes -= block_len;
+
+    // Reclaim the space immediately when possible, to put off compaction.
+    if (TCMD_arena_live_bytes == 0) {
+        TCMD_arena_end_offset = 0;
+    }
+    else if (offset + block_len == TCMD_arena_end_offset) {
+        TCMD_arena_end_offset = offset;
+    }
+}
+
+/// @brief Gets the number of arena bytes in use by stored strings (including block headers).
+uint16_t TCMD_arena_get_live_bytes() {
+    return TCMD_arena_live_bytes;
+}
@@ -8,6 +8,75 @@
 #include <ctype.h>
 
 
+/// @brief Splits an args string into its comma-separated arguments, in a single pass.
+/// @param args_str Input string containing comma-separated arguments. Not modified or copied.
+/// @param args_str_len Length of the input string. Strings longer than 65535 are truncated.
+/// @param args Output; table of the offset and length of each argument.
+/// @note The `TCMD_args_get_*` accessors then read each argument without rescanning the string,
+///     which makes extracting N arguments O(len) instead of O(N * len).
+void TCMD_tokenize_args(const char *args_str, uint32_t args_str_len, TCMD_args_t *args) {
+    if (args_str_len > UINT16_MAX) {
+        args_str_len = UINT16_MAX;
+    }
+    args->args_str = args_str;
+    args->args_str_len = (uint16_t)args_str_len;
+    args->arg_count = 0;
+
+    if (args_str_len == 0) {
+        return;
+    }
+
+    uint16_t arg_start = 0;
+    for (uint32_t i = 0; i <= args_str_len; i++) {
+        if ((i < args_str_len) && (args_str[i] != ',')) {
+            continue;
+        }
+
+        if (args->arg_count < TCMD_ARGS_MAX_TOKENIZED_COUNT) {
+            args->arg_start[args->arg_count] = arg_start;
+            args->arg_len[args->arg_count] = i - arg_start;
+        }
+        args->arg_count++;
+        arg_start = i + 1;
+    }
+}
+
+/// @brief Finds the offset and length of the nth argument in a tokenized args string.
+/// @return 0 if found, 1 if the args string is empty, 2 if there are not enough arguments.
+/// @note Arguments past `TCMD_ARGS_MAX_TOKENIZED_COUNT` are found by scanning from the last
+///     stored argument.
+static uint8_t TCMD_args_find_arg(
+    const TCMD_args_t *args, uint8_t arg_index, uint16_t *arg_start, uint16_t *arg_len
+) {
+    if (args->arg_count == 0) {
+        return 1;
+    }
+    if (arg_index >= args->arg_count) {
+        return 2;
+    }
+    if (arg_index < TCMD_ARGS_MAX_TOKENIZED_COUNT) {
+        *arg_start = args->arg_start[arg_index];
+        *arg_len = args->arg_len[arg_index];
+        return 0;
+    }
+
+    const uint8_t last_stored_idx = TCMD_ARGS_MAX_TOKENIZED_COUNT - 1;
+    uint16_t start = args->arg_start[last_stored_idx] + args->arg_len[last_stored_idx] + 1;
+    for (uint8_t skip = last_stored_idx + 1; skip < arg_index; skip++) {
+        while (args->args_str[start] != ',') {
+            start++;
+        }
+        start++;
+    }
+    uint16_t end = start;
+    while ((end < args->args_str_len) && (args->args_str[end] != ',')) {
+        end++;
+    }
+    *arg_start = start;
+    *arg_len = end - start;
+    return 0;
+}
+
 /// @brief Extracts a uint64, starting from the beginning of `str`, to a maximum length of `str_len`.
 /// @param str Input string, starting with an integer
 /// @param str_len Length of the input string. The first `str_len` characters are considered.
@@ -53,30 +122,28 @@ uint8_t TCMD_ascii_to_uint64(const char *str, uint32_t str_len, uint64_t *result
 /// @param result Pointer to the result
 /// @return 0 if successful, 1 if the string is empty, 2 if the string does not contain enough arguments
 ///        3 if the argument is not an integer, 4 for other error
+/// @note Tokenizes `str` on every call. To extract several arguments, use `TCMD_tokenize_args`
+///     once, then `TCMD_args_get_uint64`.
 uint8_t TCMD_extract_uint64_arg(const char *str, uint32_t str_len, uint8_t arg_index, uint64_t *result) {
-    if (str_len == 0) {
-        return 1;
-    }
-
-    uint32_t arg_count = 0;
-    uint32_t i = 0;
-    uint32_t start_index = 0;
-    for (; i < str_len; i++) {
-        if (str[i] == ',') {
-            if (arg_count == arg_index) {
-                break;
-            }
-
-            arg_count++;
-            start_index = i + 1;
-        }
-    }
+    TCMD_args_t args;
+    TCMD_tokenize_args(str, str_len, &args);
+    return TCMD_args_get_uint64(&args, arg_index, result);
+}
 
-    if (arg_count < arg_index) {
-        return 2;
+/// @brief Gets the nth argument of a tokenized args string, assuming it's a uint64.
+/// @param args Tokenized args, from `TCMD_tokenize_args`.
+/// @param arg_index Index of the argument to extract (0-based)
+/// @param result Pointer to the result
+/// @return 0 if successful, 1 if the string is empty, 2 if the string does not contain enough arguments
+///        3 if the argument is not an integer, 4 for other error
+uint8_t TCMD_args_get_uint64(const TCMD_args_t *args, uint8_t arg_index, uint64_t *result) {
+    uint16_t arg_start, arg_len;
+    const uint8_t find_result = TCMD_args_find_arg(args, arg_index, &arg_start, &arg_len);
+    if (find_result != 0) {
+        return find_result;
     }
 
-    uint8_t parse_result = TCMD_ascii_to_uint64(&str[start_index], i - start_index, result);
+    const uint8_t parse_result = TCMD_ascii_to_uint64(&args->args_str[arg_start], arg_len, result);
     if (parse_result == 3) {
         // The argument is not an integer
         return 3;
@@ -132,29 +199,25 @@ uint8_t TCMD_ascii_to_int64(const char *str, uint32_t str_len, int64_t *result)
 /// @return 0 if successful, 1 if the string is empty, 2 if the string does not contain enough arguments
 ///        3 if the argument is not an integer, 4 for other error
 uint8_t TCMD_extract_int64_arg(const char *str, uint32_t str_len, uint8_t arg_index, int64_t *result) {
-    if (str_len == 0) {
-        return 1;
-    }
-
-    uint32_t arg_count = 0;
-    uint32_t i = 0;
-    uint32_t start_index = 0;
-    for (; i < str_len; i++) {
-        if (str[i] == ',') {
-            if (arg_count == arg_index) {
-                break;
-            }
-
-            arg_count++;
-            start_index = i + 1;
-        }
-    }
+    TCMD_args_t args;
+    TCMD_tokenize_args(str, str_len, &args);
+    return TCMD_args_get_int64(&args, arg_index, result);
+}
 
-    if (arg_count < arg_index) {
-        return 2;
+/// @brief Gets the nth argument of a tokenized args string, assuming it's an int64.
+/// @param args Tokenized args, from `TCMD_tokenize_args`.
+/// @param arg_index Index of the argument to extract (0-based)
+/// @param result Pointer to the result
+/// @return 0 if successful, 1 if the string is empty, 2 if the string does not contain enough arguments
+///        3 if the argument is not an integer, 4 for other error
+uint8_t TCMD_args_get_int64(const TCMD_args_t *args, uint8_t arg_index, int64_t *result) {
+    uint16_t arg_start, arg_len;
+    const uint8_t find_result = TCMD_args_find_arg(args, arg_index, &arg_start, &arg_len);
+    if (find_result != 0) {
+        return find_result;
     }
 
-    uint8_t parse_result = TCMD_ascii_to_int64(&str[start_index], i - start_index, result);
+    const uint8_t parse_result = TCMD_ascii_to_int64(&args->args_str[arg_start], arg_len, result);
     if (parse_result == 2) {
         // The argument is not an integer
         return 3;
@@ -174,34 +237,36 @@ uint8_t TCMD_extract_int64_arg(const char *str, uint32_t str_len, uint8_t arg_in
 /// @return 0 if successful, 1 if the string is empty, 2 if the string does not contain enough arguments
 ///         3 for other error
 uint8_t TCMD_extract_string_arg(const char *str, uint8_t arg_index, char *result, uint16_t result_max_len) {
-    const uint16_t str_len = strlen(str);
-    if (str_len == 0) {
-        return 1;
-    }
-
-    uint32_t arg_count = 0;
-    uint32_t i = 0;
-    uint32_t start_index = 0;
-    for (; i < str_len; i++) {
-        if (str[i] == ',') {
-            if (arg_count == arg_index) {
-                break;
-            }
+    TCMD_args_t args;
+    TCMD_tokenize_args(str, strlen(str), &args);
+    return TCMD_args_get_string(&args, arg_index, result, result_max_len);
+}
 
-            arg_count++;
-            start_index = i + 1;
-        }
+/// @brief Gets the nth argument of a tokenized args string, as a string with surrounding
+///     whitespace trimmed.
+/// @param args Tokenized args, from `TCMD_tokenize_args`.
+/// @param arg_index Index of the argument to extract (0-based).
+/// @param result Pointer to the result, to be filled with the extracted string (null-terminated).
+/// @param result_max_len Maximum length of the result, including the null-terminator.
+/// @return 0 if successful, 1 if the string is empty, 2 if the string does not contain enough arguments
+///         3 for other error
+uint8_t TCMD_args_get_string(
+    const TCMD_args_t *args, uint8_t arg_index, char *result, uint16_t result_max_len
+) {
+    uint16_t arg_start, arg_len;
+    const uint8_t find_result = TCMD_args_find_arg(args, arg_index, &arg_start, &arg_len);
+    if (find_result != 0) {
+        return find_result;
     }
 
-    if (arg_count < arg_index) {
-        return 2;
-    }
-    
-    uint32_t end_index = i;
-    if (end_index - start_index >= result_max_len) {
+    if (arg_len >= result_max_len) {
         return 3;
     }
 
+    const char *str = args->args_str;
+    uint32_t start_index = arg_start;
+    uint32_t end_index = arg_start + arg_len;
+
     // Trim leading whitespace
     while (start_index < end_index && (str[start_index] == ' ' || str[start_index] == '\t')) {
         start_index++;
@@ -214,11 +279,6 @@ uint8_t TCMD_extract_string_arg(const char *str, uint8_t arg_index, char *result
 
     const uint32_t token_len = end_index - start_index;
 
-    if (token_len >= result_max_len) {
-        // The argument is too long for the result buffer.
-        return 3;
-    }
-
     strncpy(result, &str[start_index], token_len);
     result[token_len] = '\0';
 
@@ -238,49 +298,43 @@ uint8_t TCMD_extract_string_arg(const char *str, uint8_t arg_index, char *result
 uint8_t TCMD_extract_hex_array_arg(const char *args_str, uint8_t arg_index, uint8_t result_array[],
     uint16_t result_array_size, uint16_t *result_length )
 {
-    const size_t args_str_len = strlen(args_str);
-    if (args_str_len == 0) {
-        // String is empty
-        return 10;
-    }
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+    return TCMD_args_get_hex_array(&args, arg_index, result_array, result_array_size, result_length);
+}
 
-    // Find the start index of the argument.
-    uint32_t arg_count = 0;
-    uint32_t start_index = 0;
-    for (uint32_t i = 0; i < args_str_len; i++) {
-        if (args_str[i] == ',') {
-            if (arg_count == arg_index) {
-                break;
-            }
-            arg_count++;
-            start_index = i + 1;
-        }
-    }
-    
-    if (arg_count < arg_index) {
-        // Not enough arguments
-        return 11;
+/// @brief Gets the nth argument of a tokenized args string, assuming it's a hex string.
+/// @param args Tokenized args, from `TCMD_tokenize_args`.
+/// @param arg_index Index of the argument to extract (0-based)
+/// @param result Pointer to the result; a byte array containing the values of the hex string
+/// @param result_array_size Size of the result array
+/// @param result_length Pointer to variable that will contain the length of the result after converting
+/// @return 0 if successful, 10 if the string is empty, 11 if there are not enough arguments,
+///     12 if there are fewer than 2 characters left, 2 for an invalid character,
+///     3 if the result array is too small, 4 for half a byte.
+/// @note Delimiters between bytes are ignored, but delimiters within a byte are not allowed.
+uint8_t TCMD_args_get_hex_array(
+    const TCMD_args_t *args, uint8_t arg_index,
+    uint8_t result_array[], uint16_t result_array_size, uint16_t *result_length
+) {
+    uint16_t arg_start, arg_len;
+    const uint8_t find_result = TCMD_args_find_arg(args, arg_index, &arg_start, &arg_len);
+    if (find_result != 0) {
+        return find_result + 9; // 10 for empty, 11 for not enough arguments.
     }
 
-    if (strlen(&args_str[start_index]) < 2) {
+    if (args->args_str_len - arg_start < 2) {
         // Empty argument, or not enough characters to form a byte
-        return 12; 
+        return 12;
     }
 
-    // Find the end index of the argument.
-    // `end_index` will point to the character after the last character of the argument.
-    uint32_t end_index = start_index;
-    while (args_str[end_index] != ',' && args_str[end_index] != '\0') {
-        end_index++;
-    }
-    
     // Parse the hex string into a byte array.
     uint16_t byte_index = 0;
     uint8_t current_byte = 0;
     uint8_t nibble_count = 0;
 
-    for (size_t i = start_index; i < end_index; i++) {
-        char current_char = args_str[i];
+    for (uint32_t i = arg_start; i < (uint32_t)arg_start + arg_len; i++) {
+        char current_char = args->args_str[i];
 
         if (current_char == ' ' || current_char == '_') {
             if (nibble_count % 2 != 0) {
@@ -291,12 +345,12 @@ uint8_t TCMD_extract_hex_array_arg(const char *args_str, uint8_t arg_index, uint
             continue;
         }
 
-        if (!isxdigit(current_char)) {
+        if (!isxdigit((unsigned char)current_char)) {
             // Invalid character found
             return 2;
         }
 
-        current_char = tolower(current_char);
+        current_char = tolower((unsigned char)current_char);
 
         // Incantation to convert a hex character to a nibble.
         uint8_t nibble = (uint8_t)((current_char >= '0' && current_char <= '9') ? (current_char - '0') : (current_char - 'a' + 10));
@@ -352,32 +406,28 @@ uint8_t TCMD_extract_base64_array_arg(
     const char *args_str, uint8_t arg_index,
     uint8_t result_array[], uint16_t result_array_size, uint16_t *result_length
 ) {
-    const size_t args_str_len = strlen(args_str);
-    if (args_str_len == 0) {
-        return 10; // Empty string
-    }
-
-    // Find the start index of the argument.
-    uint32_t arg_count = 0;
-    uint32_t start_index = 0;
-    for (uint32_t i = 0; i < args_str_len; i++) {
-        if (args_str[i] == ',') {
-            if (arg_count == arg_index) {
-                break;
-            }
-            arg_count++;
-            start_index = i + 1;
-        }
-    }
-
-    if (arg_count < arg_index) {
-        return 11; // Not enough arguments.
-    }
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+    return TCMD_args_get_base64_array(&args, arg_index, result_array, result_array_size, result_length);
+}
 
-    // Find end of argument.
-    uint32_t end_index = start_index;
-    while (args_str[end_index] != ',' && args_str[end_index] != '\0') {
-        end_index++;
+/// @brief Gets the nth argument of a tokenized args string, assuming it's a Base64 string.
+/// @param args Tokenized args, from `TCMD_tokenize_args`.
+/// @param arg_index Index of the argument to extract (0-based)
+/// @param result Pointer to the result; a byte array containing the decoded Base64 bytes
+/// @param result_array_size Size of the result array
+/// @param result_length Pointer to variable that will contain the length of the result after converting
+/// @return 0 if successful, 10 if the string is empty, 11 if there are not enough arguments,
+///     2 for an invalid character, 3 if the result array is too small, 4 for an incomplete quartet.
+/// @note Whitespace is ignored between Base64 characters, but invalid placement is not allowed.
+uint8_t TCMD_args_get_base64_array(
+    const TCMD_args_t *args, uint8_t arg_index,
+    uint8_t result_array[], uint16_t result_array_size, uint16_t *result_length
+) {
+    uint16_t arg_start, arg_len;
+    const uint8_t find_result = TCMD_args_find_arg(args, arg_index, &arg_start, &arg_len);
+    if (find_result != 0) {
+        return find_result + 9; // 10 for empty, 11 for not enough arguments.
     }
 
     uint16_t byte_index = 0;
@@ -385,8 +435,8 @@ uint8_t TCMD_extract_base64_array_arg(
     uint8_t quartet_count = 0;
     uint8_t padding_count = 0;
 
-    for (size_t i = start_index; i < end_index; i++) {
-        char c = args_str[i];
+    for (uint32_t i = arg_start; i < (uint32_t)arg_start + arg_len; i++) {
+        char c = args->args_str[i];
 
         if (c == ' ') {
             // Allow separators only between complete quartets.
@@ -490,29 +540,25 @@ uint8_t TCMD_ascii_to_double(const char *str, uint32_t str_len, double *result)
 /// @return 0 if successful, 1 if the string is empty, 2 if the string does not contain enough arguments
 ///        3 if the argument is not a double, 4 for other error
 uint8_t TCMD_extract_double_arg(const char *str, uint32_t str_len, uint8_t arg_index, double *result) {
-    if (str_len == 0) {
-        return 1;
-    }
-
-    uint32_t arg_count = 0;
-    uint32_t i = 0;
-    uint32_t start_index = 0;
-    for (; i < str_len; i++) {
-        if (str[i] == ',') {
-            if (arg_count == arg_index) {
-                break;
-            }
-
-            arg_count++;
-            start_index = i + 1;
-        }
-    }
+    TCMD_args_t args;
+    TCMD_tokenize_args(str, str_len, &args);
+    return TCMD_args_get_double(&args, arg_index, result);
+}
 
-    if (arg_count < arg_index) {
-        return 2;
+/// @brief Gets the nth argument of a tokenized args string, assuming it's a double.
+/// @param args Tokenized args, from `TCMD_tokenize_args`.
+/// @param arg_index Index of the argument to extract (0-based)
+/// @param result Pointer to the result
+/// @return 0 if successful, 1 if the string is empty, 2 if the string does not contain enough arguments
+///        3 if the argument is not a double, 4 for other error
+uint8_t TCMD_args_get_double(const TCMD_args_t *args, uint8_t arg_index, double *result) {
+    uint16_t arg_start, arg_len;
+    const uint8_t find_result = TCMD_args_find_arg(args, arg_index, &arg_start, &arg_len);
+    if (find_result != 0) {
+        return find_result;
     }
 
-    uint8_t parse_result = TCMD_ascii_to_double(&str[start_index], i - start_index, result);
+    const uint8_t parse_result = TCMD_ascii_to_double(&args->args_str[arg_start], arg_len, result);
     if (parse_result == 2) {
         // The argument is not a double
         return 3;
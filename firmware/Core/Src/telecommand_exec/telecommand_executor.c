@@ -2,6 +2,8 @@
 #include "telecommand_exec/telecommand_definitions.h"
 #include "telecommand_exec/telecommand_executor.h"
 #include "telecommand_exec/telecommand_types.h"
+#include "telecommand_exec/agenda_string_arena.h"
+#include "telecommand_exec/telecommand_response_store.h"
 #include "debug_tools/debug_uart.h"
 #include "timekeeping/timekeeping.h"
 #include "log/log.h"
@@ -19,6 +21,10 @@
 uint32_t TCMD_total_tcmd_queued_count = 0;
 uint64_t TCMD_latest_received_tcmd_timestamp_sent = 0;
 
+/// @brief Latency from reception (in the UART ISR) to the start of execution, of immediate
+///     (`@tsexec` unset) uplinked telecommands. Indexed by `TCMD_rx_source_enum_t`.
+TCMD_rx_latency_stats_t TCMD_rx_latency_stats[TCMD_RX_SOURCE_COUNT];
+
 
 ///@brief  The head of the circular buffer of timestamps of telecommands that have been sent.
 /// @note This is an index into `TCMD_timestamp_sent_store`.
@@ -28,77 +34,268 @@ uint16_t  TCMD_timestamp_sent_used_slots = 0;
 /// @brief The circular buffer of timestamps of telecommands that have been sent.
 uint64_t TCMD_timestamp_sent_store[TCMD_TIMESTAMP_RECORD_SIZE] = {0};
 
+// Number of buckets in `TCMD_timestamp_sent_hash_set`. Power of 2, and at least twice
+// `TCMD_TIMESTAMP_RECORD_SIZE`, so that probe sequences stay short.
+#define TCMD_TIMESTAMP_SENT_HASH_BITS 11
+#define TCMD_TIMESTAMP_SENT_HASH_SIZE (1 << TCMD_TIMESTAMP_SENT_HASH_BITS)
+
+/// @brief Open-addressing (linear probing) hash set over the used entries of `TCMD_timestamp_sent_store`.
+/// @details Each bucket holds an index into `TCMD_timestamp_sent_store`, plus 1 (0 means empty).
+///          Entries are removed as the ring overwrites them, so it always covers the same history as the ring.
+static uint16_t TCMD_timestamp_sent_hash_set[TCMD_TIMESTAMP_SENT_HASH_SIZE] = {0};
+
+/// @brief Fibonacci hash of a tssent value to a bucket in `TCMD_timestamp_sent_hash_set`.
+static inline uint16_t TCMD_timestamp_sent_hash(uint64_t timestamp_sent) {
+    return (uint16_t)((timestamp_sent * 0x9E3779B97F4A7C15ULL) >> (64 - TCMD_TIMESTAMP_SENT_HASH_BITS));
+}
+
+/// @brief Adds the entry at `store_idx` in `TCMD_timestamp_sent_store` to the hash set.
+static void TCMD_timestamp_sent_hash_set_insert(uint16_t store_idx) {
+    uint16_t bucket = TCMD_timestamp_sent_hash(TCMD_timestamp_sent_store[store_idx]);
+    while (TCMD_timestamp_sent_hash_set[bucket] != 0) {
+        bucket = (bucket + 1) & (TCMD_TIMESTAMP_SENT_HASH_SIZE - 1);
+    }
+    TCMD_timestamp_sent_hash_set[bucket] = store_idx + 1;
+}
+
+/// @brief Removes the entry at `store_idx` in `TCMD_timestamp_sent_store` from the hash set.
+/// @note Must be called before the entry in `TCMD_timestamp_sent_store` is overwritten.
+/// @note Uses backward-shift deletion (no tombstones), so lookups never slow down over time.
+static void TCMD_timestamp_sent_hash_set_remove(uint16_t store_idx) {
+    const uint16_t mask = TCMD_TIMESTAMP_SENT_HASH_SIZE - 1;
+    uint16_t hole = TCMD_timestamp_sent_hash(TCMD_timestamp_sent_store[store_idx]);
+    // Bounded by the table size, in case the entry is somehow missing.
+    for (uint16_t i = 0; TCMD_timestamp_sent_hash_set[hole] != store_idx + 1; i++) {
+        if ((TCMD_timestamp_sent_hash_set[hole] == 0) || (i >= TCMD_TIMESTAMP_SENT_HASH_SIZE)) {
+            return;
+        }
+        hole = (hole + 1) & mask;
+    }
+
+    // Shift back any later entry in the probe run which may not stay after the hole.
+    uint16_t bucket = hole;
+    while (1) {
+        bucket = (bucket + 1) & mask;
+        if (TCMD_timestamp_sent_hash_set[bucket] == 0) {
+            break;
+        }
+        const uint16_t home = TCMD_timestamp_sent_hash(
+            TCMD_timestamp_sent_store[TCMD_timestamp_sent_hash_set[bucket] - 1]
+        );
+        // The entry can stay if its home bucket is cyclically within (hole, bucket].
+        const uint8_t can_stay = (hole <= bucket)
+            ? ((hole < home) && (home <= bucket))
+            : ((hole < home) || (home <= bucket));
+        if (can_stay) {
+            continue;
+        }
+        TCMD_timestamp_sent_hash_set[hole] = TCMD_timestamp_sent_hash_set[bucket];
+        hole = bucket;
+    }
+    TCMD_timestamp_sent_hash_set[hole] = 0;
+}
+
+/// @brief Checks whether a tssent value is in the history of recently-received telecommands.
+/// @param timestamp_sent The tssent value to look for.
+/// @return 1 if it was received within the last `TCMD_TIMESTAMP_RECORD_SIZE` telecommands, 0 otherwise.
+/// @note O(1). tssent=0 is never recorded, so it always returns 0 for tssent=0.
+uint8_t TCMD_timestamp_sent_is_recorded(uint64_t timestamp_sent) {
+    uint16_t bucket = TCMD_timestamp_sent_hash(timestamp_sent);
+    while (TCMD_timestamp_sent_hash_set[bucket] != 0) {
+        if (TCMD_timestamp_sent_store[TCMD_timestamp_sent_hash_set[bucket] - 1] == timestamp_sent) {
+            return 1;
+        }
+        bucket = (bucket + 1) & (TCMD_TIMESTAMP_SENT_HASH_SIZE - 1);
+    }
+    return 0;
+}
+
+
 /// @brief  The agenda (schedule queue) of telecommands to execute.
-TCMD_parsed_tcmd_to_execute_t TCMD_agenda[TCMD_AGENDA_SIZE];
-// TODO: Consider an optimization to store the args_str_no_parens in a separate buffer (or on the heap), to save a ton of memory.
+/// @note Entries stay in the same slot from enqueue until they are executed or deleted. The order
+///       of execution is kept separately, in `TCMD_agenda_heap`.
+/// @note The args and response filename of each slot are in the agenda string arena (handle = slot number).
+TCMD_agenda_entry_t TCMD_agenda[TCMD_AGENDA_SIZE];
 
 /// @brief  A flag indicating whether a given index in `TCMD_agenda` is valid
 ///         (i.e., filled with a not-yet-executed command).
 /// @note The values in here are tri-state via TCMD_agenda_entry_state_enum_t.
+/// @note Read-only outside this file. Use `TCMD_agenda_delete_slot()` to remove an entry.
 uint8_t TCMD_agenda_is_valid[TCMD_AGENDA_SIZE] = {0};
 
-/// @brief Index into `TCMD_agenda` and `TCMD_agenda_is_valid` of the last used slot.
-/// @details The next telecommand to entered into the agenda will fill this slot, or will
-///          go into the first free slot after this one.
-uint16_t TCMD_agenda_last_used_slot = 0;
-
-
-/// @brief  Gets the index of the first free ("invalid") slot in the agenda.
-/// @return The index into `TCMD_agenda` and `TCMD_agenda_is_valid` of the first free slot.
-///         If the agenda is full, returns 0, suggesting that the caller should overwrite starting at the beginning.
-static uint16_t TCMD_agenda_get_free_slot_idx() {
-    // `i` is just a counter to ensure we don't get stuck in an infinite loop.
-    uint16_t slot_num = TCMD_agenda_last_used_slot;
-    for (uint16_t i = 0; i < TCMD_AGENDA_SIZE; i++) {
-        // Skip filled slots. Skip both PENDING and EXECUTING slots!
-        if (TCMD_agenda_is_valid[slot_num] == TCMD_AGENDA_ENTRY_INVALID) {
-            return slot_num;
+/// @brief Binary min-heap of the slot numbers of all VALID_AND_PENDING entries, ordered by
+///        `timestamp_to_execute`, then by insertion order (`TCMD_agenda_insert_seq_num`).
+/// @details `TCMD_agenda_heap[0]` is the next telecommand to execute. The number of pending
+///          entries is `TCMD_agenda_heap_size`.
+static uint16_t TCMD_agenda_heap[TCMD_AGENDA_SIZE];
+static uint16_t TCMD_agenda_heap_size = 0;
+
+/// @brief Index into `TCMD_agenda_heap` of each pending slot (indexed by slot number), so that
+///        any entry can be removed from the heap without searching for it.
+static uint16_t TCMD_agenda_heap_pos[TCMD_AGENDA_SIZE];
+
+/// @brief Insertion sequence number of each slot. Breaks tsexec ties in the order the
+///        telecommands were added to the agenda (received).
+static uint32_t TCMD_agenda_insert_seq_num[TCMD_AGENDA_SIZE];
+static uint32_t TCMD_agenda_next_insert_seq_num = 0;
+
+/// @brief Stack of slots which have been used and freed again.
+static uint16_t TCMD_agenda_free_slots[TCMD_AGENDA_SIZE];
+static uint16_t TCMD_agenda_free_slots_count = 0;
+
+/// @brief Number of slots which have ever been handed out. Slots at and above this index have
+///        never been used, and are free without being on `TCMD_agenda_free_slots`.
+static uint16_t TCMD_agenda_never_used_slot_start = 0;
+
+
+/// @brief Whether the entry in `slot_a` should execute before the entry in `slot_b`.
+static inline bool TCMD_agenda_slot_is_before(uint16_t slot_a, uint16_t slot_b) {
+    if (TCMD_agenda[slot_a].timestamp_to_execute != TCMD_agenda[slot_b].timestamp_to_execute) {
+        return TCMD_agenda[slot_a].timestamp_to_execute < TCMD_agenda[slot_b].timestamp_to_execute;
+    }
+    // Subtract, so that ordering still holds when the sequence number wraps around.
+    return (int32_t)(TCMD_agenda_insert_seq_num[slot_a] - TCMD_agenda_insert_seq_num[slot_b]) < 0;
+}
+
+static inline void TCMD_agenda_heap_set(uint16_t heap_idx, uint16_t slot_num) {
+    TCMD_agenda_heap[heap_idx] = slot_num;
+    TCMD_agenda_heap_pos[slot_num] = heap_idx;
+}
+
+static void TCMD_agenda_heap_sift_up(uint16_t heap_idx) {
+    const uint16_t slot_num = TCMD_agenda_heap[heap_idx];
+    while (heap_idx > 0) {
+        const uint16_t parent_idx = (heap_idx - 1) / 2;
+        if (!TCMD_agenda_slot_is_before(slot_num, TCMD_agenda_heap[parent_idx])) {
+            break;
         }
-        slot_num = (slot_num + 1) % TCMD_AGENDA_SIZE; // Increment and wrap around.
+        TCMD_agenda_heap_set(heap_idx, TCMD_agenda_heap[parent_idx]);
+        heap_idx = parent_idx;
     }
+    TCMD_agenda_heap_set(heap_idx, slot_num);
+}
 
-    LOG_message(
-        LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
-        "TCMD_agenda_get_free_slot_idx: No free slots in the agenda. Overwriting from the start."
-    );
+static void TCMD_agenda_heap_sift_down(uint16_t heap_idx) {
+    const uint16_t slot_num = TCMD_agenda_heap[heap_idx];
+    while (1) {
+        const uint16_t left_idx = (2 * heap_idx) + 1;
+        if (left_idx >= TCMD_agenda_heap_size) {
+            break;
+        }
+        uint16_t child_idx = left_idx;
+        if (
+            (left_idx + 1 < TCMD_agenda_heap_size)
+            && TCMD_agenda_slot_is_before(TCMD_agenda_heap[left_idx + 1], TCMD_agenda_heap[left_idx])
+        ) {
+            child_idx = left_idx + 1;
+        }
+        if (!TCMD_agenda_slot_is_before(TCMD_agenda_heap[child_idx], slot_num)) {
+            break;
+        }
+        TCMD_agenda_heap_set(heap_idx, TCMD_agenda_heap[child_idx]);
+        heap_idx = child_idx;
+    }
+    TCMD_agenda_heap_set(heap_idx, slot_num);
+}
+
+/// @brief Removes a pending slot from the heap. O(log n).
+/// @note Does not change `TCMD_agenda_is_valid`, nor free the slot.
+static void TCMD_agenda_heap_remove(uint16_t slot_num) {
+    const uint16_t heap_idx = TCMD_agenda_heap_pos[slot_num];
+    TCMD_agenda_heap_size--;
+    if (heap_idx == TCMD_agenda_heap_size) {
+        return; // Was the last element.
+    }
+
+    // Move the last element into the hole, then restore the heap property in whichever direction.
+    TCMD_agenda_heap_set(heap_idx, TCMD_agenda_heap[TCMD_agenda_heap_size]);
+    if ((heap_idx > 0) && TCMD_agenda_slot_is_before(
+        TCMD_agenda_heap[heap_idx], TCMD_agenda_heap[(heap_idx - 1) / 2]
+    )) {
+        TCMD_agenda_heap_sift_up(heap_idx);
+    }
+    else {
+        TCMD_agenda_heap_sift_down(heap_idx);
+    }
+}
 
-    // If it's full, try returning 0. However, if telecommand 0 is executing, then don't overwrite it.
-    // Instead, move to 1, under the assumption that only a single telecommand can be executing at a time.
-    if (TCMD_agenda_is_valid[0] != TCMD_AGENDA_ENTRY_EXECUTING) {
-        return 0; // Slot 0 because slot 0 is not executing - nominal error handling case.
+/// @brief Gets a free ("invalid") slot in the agenda. O(1).
+/// @return The index into `TCMD_agenda` and `TCMD_agenda_is_valid` of a free slot,
+///         or -1 if the agenda is full.
+/// @note Slots which are EXECUTING are not free until their telecommand finishes.
+static int16_t TCMD_agenda_get_free_slot_idx() {
+    if (TCMD_agenda_free_slots_count > 0) {
+        TCMD_agenda_free_slots_count--;
+        return TCMD_agenda_free_slots[TCMD_agenda_free_slots_count];
+    }
+    if (TCMD_agenda_never_used_slot_start < TCMD_AGENDA_SIZE) {
+        return TCMD_agenda_never_used_slot_start++;
     }
-    return 1; // Slot 1 because slot 0 is executing. Extreme edge case.
+    return -1;
+}
+
+/// @brief Marks a slot as invalid, and returns it (and its strings) to the free lists.
+static void TCMD_agenda_free_slot(uint16_t slot_num) {
+    TCMD_agenda_is_valid[slot_num] = TCMD_AGENDA_ENTRY_INVALID;
+    TCMD_arena_free(slot_num);
+    TCMD_agenda_free_slots[TCMD_agenda_free_slots_count] = slot_num;
+    TCMD_agenda_free_slots_count++;
 }
 
 /// @brief Adds a telecommand to the agenda (schedule/queue) of telecommands to execute.
 /// @param parsed_tcmd The parsed telecommand to add to the agenda.
-/// @return 0 on success, 1 if the agenda is full.
+/// @return 0 on success, 1 if the agenda is full, 2 if the agenda's string arena is full,
+///         20 if the tssent is a repeat.
 /// @note Performs a deep copy of the `parsed_tcmd` arg into the agenda.
+/// @note When the agenda is full, the telecommand is rejected (nothing already in the agenda is
+///       overwritten), and its tssent is not recorded, so it can be re-sent later.
+/// @note The string arena can fill before the slots do: only `TCMD_ARENA_MIN_ENTRY_COUNT` entries
+///       with max-length args and resp_fname are guaranteed to fit (see `agenda_string_arena.h`).
 uint8_t TCMD_add_tcmd_to_agenda(const TCMD_parsed_tcmd_to_execute_t *parsed_tcmd) {
-    // Find the first empty slot in the agenda.
-    const uint16_t slot_num = TCMD_agenda_get_free_slot_idx();
-    
     // If this is a duplicate telecommand, and we're enforcing that, skip it.
     if (TCMD_require_unique_tssent) {
-        // Check to see if timestamp is in the circular buffer.
-        // Loop upperbound: Search to the end, because it's circular. It's initialized with zeros,
-        // so tssent=0 will cause a rejection/error here (which is good/as planned).
-        for (uint32_t i = 0; i < TCMD_timestamp_sent_used_slots; i++) {
-            if (parsed_tcmd->timestamp_sent == TCMD_timestamp_sent_store[i]) {
-                // Skip this telecommand.
-                LOG_message(
-                    LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-                    "Telecommand skipped due to repeated tssent."
-                );
-                return 20;
-            }
+        // Check to see if timestamp is in the circular buffer (via its hash set).
+        if (TCMD_timestamp_sent_is_recorded(parsed_tcmd->timestamp_sent)) {
+            // Skip this telecommand.
+            LOG_message(
+                LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+                "Telecommand skipped due to repeated tssent."
+            );
+            return 20;
         }
     }
 
+    // Find a free slot in the agenda.
+    const int16_t slot_num = TCMD_agenda_get_free_slot_idx();
+    if (slot_num < 0) {
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Telecommand skipped: Agenda is full (%u entries).",
+            TCMD_AGENDA_SIZE
+        );
+        return 1;
+    }
+
+    // Store the variable-length strings.
+    if (TCMD_arena_store(slot_num, parsed_tcmd->args_str_no_parens, parsed_tcmd->resp_fname) != 0) {
+        TCMD_agenda_free_slot(slot_num);
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Telecommand skipped: Agenda string arena is full (%u bytes in use).",
+            TCMD_arena_get_live_bytes()
+        );
+        return 2;
+    }
+
     // Add the tssent timestamp to the circular buffer.
     // This mechanism prevents command replays (executing the same command twice inadvertently).
     if (parsed_tcmd->timestamp_sent > 0) {
+        // Once the buffer is full, the head is the oldest entry, which is evicted.
+        if (TCMD_timestamp_sent_used_slots == TCMD_TIMESTAMP_RECORD_SIZE) {
+            TCMD_timestamp_sent_hash_set_remove(TCMD_timestamp_sent_head);
+        }
         TCMD_timestamp_sent_store[TCMD_timestamp_sent_head] = parsed_tcmd->timestamp_sent;
+        TCMD_timestamp_sent_hash_set_insert(TCMD_timestamp_sent_head);
         TCMD_timestamp_sent_head = (TCMD_timestamp_sent_head + 1) % TCMD_TIMESTAMP_RECORD_SIZE;
 
         // Increase the used slots count up until it hits TCMD_TIMESTAMP_RECORD_SIZE, then
@@ -112,76 +309,69 @@ uint8_t TCMD_add_tcmd_to_agenda(const TCMD_parsed_tcmd_to_execute_t *parsed_tcmd
     TCMD_agenda[slot_num].tcmd_idx = parsed_tcmd->tcmd_idx;
     TCMD_agenda[slot_num].timestamp_sent = parsed_tcmd->timestamp_sent;
     TCMD_agenda[slot_num].timestamp_to_execute = parsed_tcmd->timestamp_to_execute;
+    TCMD_agenda[slot_num].rx_source = parsed_tcmd->rx_source;
+    TCMD_agenda[slot_num].uptime_at_rx_ms = parsed_tcmd->uptime_at_rx_ms;
 
-    for (uint16_t j = 0; j < TCMD_ARGS_STR_NO_PARENS_SIZE; j++) {
-        TCMD_agenda[slot_num].args_str_no_parens[j] = parsed_tcmd->args_str_no_parens[j];
-    }
-
-    // Copy the log filename into the agenda.
-    for (uint16_t j = 0; j < TCMD_MAX_RESP_FNAME_LEN; j++) {
-        TCMD_agenda[slot_num].resp_fname[j] = parsed_tcmd->resp_fname[j];
-    }
     // Mark the slot as valid.
     TCMD_agenda_is_valid[slot_num] = TCMD_AGENDA_ENTRY_VALID_AND_PENDING;
 
+    // Insert into the execution order.
+    TCMD_agenda_insert_seq_num[slot_num] = TCMD_agenda_next_insert_seq_num++;
+    TCMD_agenda_heap_set(TCMD_agenda_heap_size, slot_num);
+    TCMD_agenda_heap_size++;
+    TCMD_agenda_heap_sift_up(TCMD_agenda_heap_size - 1);
+
     // Incrementing counters used for stats 
     TCMD_total_tcmd_queued_count++; 
     TCMD_latest_received_tcmd_timestamp_sent = parsed_tcmd->timestamp_sent;
-    TCMD_agenda_last_used_slot = slot_num;
 
     return 0;
 }
 
+/// @brief Deletes a pending telecommand from the agenda, so that it is never executed.
+/// @param slot_num The index into `TCMD_agenda` of the entry to delete.
+/// @return 0 on success, 1 if the slot is not a pending (VALID_AND_PENDING) entry.
+uint8_t TCMD_agenda_delete_slot(uint16_t slot_num) {
+    if (
+        (slot_num >= TCMD_AGENDA_SIZE)
+        || (TCMD_agenda_is_valid[slot_num] != TCMD_AGENDA_ENTRY_VALID_AND_PENDING)
+    ) {
+        return 1;
+    }
+    TCMD_agenda_heap_remove(slot_num);
+    TCMD_agenda_free_slot(slot_num);
+    return 0;
+}
+
 
 /// @brief Gets the number of used slots in the agenda (how many valid and pending telecommands).
 /// @return The number of currently-filled slots in the agenda.
 /// @note This function is mostly intended for "system stats" telecommands and logging.
 uint16_t TCMD_get_agenda_used_slots_count() {
-    // TODO: Consider an easy O(1) optimization by keeping track of the number of used slots.
-    uint16_t count = 0;
-    for (uint16_t slot_num = 0; slot_num < TCMD_AGENDA_SIZE; slot_num++) {
-        if (TCMD_agenda_is_valid[slot_num] == TCMD_AGENDA_ENTRY_VALID_AND_PENDING) {
-            count++;
-        }
-    }
-    return count;
+    return TCMD_agenda_heap_size;
 }
 
 /// @brief Finds the index into `TCMD_agenda` (`slot_num`) of the next telecommand to execute.
 /// @return The index into `TCMD_agenda` of the next telecommand to execute, or -1 if none are available/ready.
 /// @note This function will return the `slot_num` which has the lowest `timestamp_to_execute` value.
-///       If multiple slots have the same `timestamp_to_execute`, the lowest `slot_num` will be returned.
-///       Thus, based on the insertion order, during tsexec ties, telecommands will be executed in the order
-///       they were added to the agenda (received).
-///       Edge case: When wrapping around the circular buffer (at 750 telecommands), it is not perfectly guaranteed
-///       that tsexec ties will run in the order they were inserted.
+///       During tsexec ties, telecommands will be executed in the order they were added to the
+///       agenda (received).
 int16_t TCMD_get_next_tcmd_agenda_slot_to_execute() {
-    const uint64_t current_timestamp_ms = TIME_get_current_unix_epoch_time_ms();
+    if (TCMD_agenda_heap_size == 0) {
+        return -1;
+    }
 
-    int16_t earliest_slot_num = -1;
-    uint64_t earliest_timestamp = UINT64_MAX;
-    for (uint16_t slot_num = 0; slot_num < TCMD_AGENDA_SIZE; slot_num++) {
-        // Skip empty/invalid slots.
-        if (TCMD_agenda_is_valid[slot_num] == TCMD_AGENDA_ENTRY_INVALID) {
-            continue;
-        }
+    const uint16_t earliest_slot_num = TCMD_agenda_heap[0];
+    const uint64_t earliest_timestamp = TCMD_agenda[earliest_slot_num].timestamp_to_execute;
 
-        // Optimization: Return the first 0-timestamp slot found, if any.
-        if (TCMD_agenda[slot_num].timestamp_to_execute == 0) {
-            return slot_num;
-        }
-        
-        // Find the next earliest tsexec timestamp.
-        if (
-            (TCMD_agenda[slot_num].timestamp_to_execute < earliest_timestamp)
-            && (TCMD_agenda[slot_num].timestamp_to_execute <= current_timestamp_ms)
-        ) {
-            earliest_slot_num = slot_num;
-            earliest_timestamp = TCMD_agenda[slot_num].timestamp_to_execute;
-        }
+    // tsexec=0 means "execute immediately", and is always the smallest key, so skip getting the time.
+    if (
+        (earliest_timestamp == 0)
+        || (earliest_timestamp <= TIME_get_current_unix_epoch_time_ms())
+    ) {
+        return earliest_slot_num;
     }
-
-    return earliest_slot_num;
+    return -1;
 }
 
 
@@ -189,7 +379,8 @@ int16_t TCMD_get_next_tcmd_agenda_slot_to_execute() {
 /// @param resp_fname The name of the file to log to.
 /// @param response_output_buf The message to log.
 /// @return 0 on success, LFS error code on failure.
-/// @note This function is used to log telecommand responses to a file.
+/// @note This function is used to log telecommand responses to a file. The file is kept open and
+///     synced in batches (see `telecommand_response_store.c`).
 static int8_t TCMD_store_resp_to_file(
     const char *resp_fname, const char *response_output_buf,
     uint64_t timestamp_sent,
@@ -206,30 +397,6 @@ static int8_t TCMD_store_resp_to_file(
         return -1; // Invalid argument error
     }
 
-    const int8_t mount_ret = LFS_ensure_mounted();
-    if (mount_ret < 0) {
-        LOG_message(
-            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-            "Error: TCMD_store_resp_to_file: Failed to mount LFS. Error code: %d",
-            mount_ret
-        );
-        return mount_ret;
-    }
-
-    lfs_file_t file;
-    const int8_t open_result = lfs_file_open(
-        &LFS_filesystem, &file, resp_fname,
-        LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND
-    );
-    if (open_result < 0) {
-        LOG_message(
-            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-            "Error: TCMD_store_resp_to_file: Failed to open file. LFS error code: %d",
-            open_result
-        );
-        return open_result;
-    }
-
     // Write the header to the file.
     char timestamp_sent_str[30];
     GEN_uint64_to_str(timestamp_sent, timestamp_sent_str);
@@ -255,61 +422,9 @@ static int8_t TCMD_store_resp_to_file(
         args_str_no_parens
     );
 
-    const lfs_ssize_t header_write_result = lfs_file_write(
-        &LFS_filesystem, &file, header_msg, strlen(header_msg)
-    );
-    if (header_write_result < 0) {
-        LOG_message(
-            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-            "Error: TCMD_store_resp_to_file: Failed to write to file. LFS error code: %ld",
-            header_write_result
-        );
-        lfs_file_close(&LFS_filesystem, &file);
-        return header_write_result;
-    }
-
-    // Write the response to the file.
-    const lfs_ssize_t response_write_result = lfs_file_write(
-        &LFS_filesystem, &file, response_output_buf, strlen(response_output_buf)
-    );
-    if (response_write_result < 0) {
-        LOG_message(
-            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-            "Error: TCMD_store_resp_to_file: Failed to write response to file. LFS error code: %ld",
-            response_write_result
-        );
-        lfs_file_close(&LFS_filesystem, &file);
-        return response_write_result;
-    }
-
-
-    // Write a delimiter to the file, in case multiple telecommands are logged to the same file.
-    const char *delimiter = "\n[END_RESPONSE]\n";
-    const lfs_ssize_t delim_write_result = lfs_file_write(
-        &LFS_filesystem, &file, delimiter, strlen(delimiter)
-    );
-    if (delim_write_result < 0) {
-        LOG_message(
-            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-            "Error: TCMD_store_resp_to_file: Failed to write end delim to file. LFS error code: %ld",
-            delim_write_result
-        );
-        lfs_file_close(&LFS_filesystem, &file);
-        return delim_write_result;
-    }
-
-    // Close the file.
-    const int8_t close_result = lfs_file_close(&LFS_filesystem, &file);
-    if (close_result < 0) {
-        LOG_message(
-            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-            "Error: TCMD_store_resp_to_file: Failed to close file. LFS error code: %d",
-            close_result
-        );
-        return close_result;
-    }
-    
-    return 0;
+    // Writes the header, the response, and a delimiter (in case multiple telecommands are logged
+    // to the same file). Internally logs errors.
+    return TCMD_resp_store_write_entry(resp_fname, header_msg, response_output_buf);
 }
 
 /// @brief Executes a telecommand immediately, based on the minimum info required to execute a telecommand.
@@ -365,13 +480,20 @@ static uint8_t TCMD_execute_parsed_telecommand_now(
         tcmd_result
     );
 
-    COMMS_downlink_tcmd_response(
+    const uint8_t downlink_response_result = COMMS_downlink_tcmd_response(
         timestamp_sent,
         tcmd_result,
         tcmd_exec_duration_ms,
         response_output_buf,
         strnlen(response_output_buf, response_output_buf_size) + 1 // +1 for null terminator
     );
+    if (downlink_response_result != 0) {
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_WARNING, LOG_all_sinks_except(LOG_SINK_UHF_RADIO),
+            "Telecommand response downlink failed: COMMS_downlink_tcmd_response() -> %u",
+            downlink_response_result
+        );
+    }
 
     DEBUG_uart_print_str("==========================\n");
     DEBUG_uart_print_str(response_output_buf);
@@ -392,6 +514,25 @@ static uint8_t TCMD_execute_parsed_telecommand_now(
     return tcmd_result;
 }
 
+/// @brief Adds a reception-to-execution latency sample to `TCMD_rx_latency_stats`.
+/// @param rx_source Where the telecommand was received from.
+/// @param latency_ms Time from the end of reception (in the UART ISR) to the start of execution.
+void TCMD_record_rx_latency(TCMD_rx_source_enum_t rx_source, uint32_t latency_ms) {
+    if (rx_source >= TCMD_RX_SOURCE_COUNT) {
+        return;
+    }
+    TCMD_rx_latency_stats_t *stats = &TCMD_rx_latency_stats[rx_source];
+    if ((stats->sample_count == 0) || (latency_ms < stats->min_latency_ms)) {
+        stats->min_latency_ms = latency_ms;
+    }
+    if (latency_ms > stats->max_latency_ms) {
+        stats->max_latency_ms = latency_ms;
+    }
+    stats->last_latency_ms = latency_ms;
+    stats->total_latency_ms += latency_ms;
+    stats->sample_count++;
+}
+
 /// @brief Executes a telecommand from the agenda immediately.
 /// @param tcmd_agenda_slot_num The index into `TCMD_agenda` for the telecommand to execute.
 /// @param response_output_buf A buffer to store the response from the telecommand.
@@ -401,30 +542,46 @@ uint8_t TCMD_execute_telecommand_in_agenda(
     const uint16_t tcmd_agenda_slot_num,
     char *response_output_buf, uint16_t response_output_buf_size
 ) {
-    if (TCMD_agenda_is_valid[tcmd_agenda_slot_num] == TCMD_AGENDA_ENTRY_INVALID) {
+    // Only pending slots can be executed. An EXECUTING slot is already running (and will be freed
+    // when it finishes), so running it again would free it twice.
+    if (TCMD_agenda_is_valid[tcmd_agenda_slot_num] != TCMD_AGENDA_ENTRY_VALID_AND_PENDING) {
         LOG_message(
             LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
-            "Error: TCMD_execute_telecommand_in_agenda: slot %u is invalidated",
+            "Error: TCMD_execute_telecommand_in_agenda: slot %u is not pending",
             tcmd_agenda_slot_num
         );
         return 253;
     }
 
     // Mark the slot as executing. Slot is still in use, but no longer counted in the "count pending" operations.
+    TCMD_agenda_heap_remove(tcmd_agenda_slot_num);
     TCMD_agenda_is_valid[tcmd_agenda_slot_num] = TCMD_AGENDA_ENTRY_EXECUTING;
 
+    // Copy the entry out of the agenda. The telecommand may enqueue more telecommands, which can
+    // compact the string arena and move this slot's strings while the telecommand is using them.
+    TCMD_parsed_tcmd_to_execute_t parsed_tcmd;
+    parsed_tcmd.tcmd_idx = TCMD_agenda[tcmd_agenda_slot_num].tcmd_idx;
+    parsed_tcmd.timestamp_sent = TCMD_agenda[tcmd_agenda_slot_num].timestamp_sent;
+    parsed_tcmd.timestamp_to_execute = TCMD_agenda[tcmd_agenda_slot_num].timestamp_to_execute;
+    parsed_tcmd.rx_source = TCMD_agenda[tcmd_agenda_slot_num].rx_source;
+    parsed_tcmd.uptime_at_rx_ms = TCMD_agenda[tcmd_agenda_slot_num].uptime_at_rx_ms;
+    strncpy(parsed_tcmd.args_str_no_parens, TCMD_arena_get_args_str(tcmd_agenda_slot_num), TCMD_ARGS_STR_NO_PARENS_SIZE);
+    parsed_tcmd.args_str_no_parens[TCMD_ARGS_STR_NO_PARENS_SIZE - 1] = '\0';
+    strncpy(parsed_tcmd.resp_fname, TCMD_arena_get_resp_fname(tcmd_agenda_slot_num), TCMD_MAX_RESP_FNAME_LEN);
+    parsed_tcmd.resp_fname[TCMD_MAX_RESP_FNAME_LEN - 1] = '\0';
+
     char tssent_str[32];
     GEN_uint64_to_str(TCMD_agenda[tcmd_agenda_slot_num].timestamp_sent, tssent_str);
     char tsexec_str[32];
     GEN_uint64_to_str(TCMD_agenda[tcmd_agenda_slot_num].timestamp_to_execute, tsexec_str);
-    uint8_t resp_fname_len = strlen(TCMD_agenda[tcmd_agenda_slot_num].resp_fname);
+    uint8_t resp_fname_len = strlen(parsed_tcmd.resp_fname);
     LOG_message(
         LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_DEBUG, LOG_SINK_ALL,
         "Executing telecommand from agenda slot %d, sent at tssent=%s, scheduled for tsexec=%s, logging to file: '%s'.",
         tcmd_agenda_slot_num,
         tssent_str,
         tsexec_str,
-        (resp_fname_len > 0) ? TCMD_agenda[tcmd_agenda_slot_num].resp_fname : "None"
+        (resp_fname_len > 0) ? parsed_tcmd.resp_fname : "None"
     );
 
     if (TCMD_agenda[tcmd_agenda_slot_num].timestamp_to_execute > 0) {
@@ -432,19 +589,24 @@ uint8_t TCMD_execute_telecommand_in_agenda(
     }
     else {
         LOG_current_log_context = LOG_CONTEXT_IMMEDIATE_TELECOMMAND;
+
+        // Scheduled telecommands wait on purpose, so only immediate ones count towards latency.
+        if (parsed_tcmd.rx_source != TCMD_RX_SOURCE_NONE) {
+            TCMD_record_rx_latency(parsed_tcmd.rx_source, TIME_uptime_ms() - parsed_tcmd.uptime_at_rx_ms);
+        }
     }
 
     // Execute the telecommand.
     const uint8_t exec_result = TCMD_execute_parsed_telecommand_now(
-        &TCMD_agenda[tcmd_agenda_slot_num],
+        &parsed_tcmd,
         response_output_buf,
         response_output_buf_size
     );
 
-    // Mark the slot as invalid because it's executed.
+    // Mark the slot as invalid because it's executed, and free it.
     // Must do it AFTER finishing the telecommand, in case the telecommand
     // enqueues more telecommands during execution.
-    TCMD_agenda_is_valid[tcmd_agenda_slot_num] = TCMD_AGENDA_ENTRY_INVALID;
+    TCMD_agenda_free_slot(tcmd_agenda_slot_num);
 
     // Reset the log context back to the default.
     LOG_current_log_context = LOG_CONTEXT_AUTONOMOUS;
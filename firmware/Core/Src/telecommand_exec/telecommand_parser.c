@@ -52,10 +52,57 @@ uint8_t TCMD_check_starts_with_device_id(const char *tcmd_str, uint32_t tcmd_str
     return 1;
 }
 
+/// @brief Compares a telecommand name (not null-terminated) to a null-terminated telecommand name, like `strcmp`.
+static int TCMD_compare_telecommand_name(const char *name, uint16_t name_len, const char *tcmd_name) {
+    const int cmp = strncmp(name, tcmd_name, name_len);
+    if (cmp != 0) {
+        return cmp;
+    }
+    // `name` is a prefix of `tcmd_name`. They're equal only if `tcmd_name` ends here.
+    return (tcmd_name[name_len] == '\0') ? 0 : -1;
+}
+
+/// @brief Finds the index into TCMD_telecommand_definitions of a telecommand name. Case-sensitive.
+/// @param name The telecommand name. Need not be null-terminated.
+/// @param name_len The length of `name`.
+/// @return The index into TCMD_telecommand_definitions, or -1 if not found.
+/// @note O(log n), by binary search over the generated `TCMD_telecommand_name_sorted_idx`.
+///     Falls back to a linear search if that index is obviously stale (wrong length). It is kept in
+///     sync by `firmware_checks/_04_check_tcmd_name_index.py`.
+int16_t TCMD_get_telecommand_idx_by_name(const char *name, uint16_t name_len) {
+    if (TCMD_telecommand_name_sorted_idx_count != TCMD_NUM_TELECOMMANDS) {
+        for (uint16_t tcmd_idx = 0; tcmd_idx < TCMD_NUM_TELECOMMANDS; tcmd_idx++) {
+            if (TCMD_compare_telecommand_name(name, name_len, TCMD_telecommand_definitions[tcmd_idx].tcmd_name) == 0) {
+                return tcmd_idx;
+            }
+        }
+        return -1;
+    }
+
+    int16_t low = 0;
+    int16_t high = TCMD_telecommand_name_sorted_idx_count - 1;
+    while (low <= high) {
+        const int16_t mid = low + ((high - low) / 2);
+        const uint8_t tcmd_idx = TCMD_telecommand_name_sorted_idx[mid];
+        const int cmp = TCMD_compare_telecommand_name(
+            name, name_len, TCMD_telecommand_definitions[tcmd_idx].tcmd_name
+        );
+        if (cmp == 0) {
+            return tcmd_idx;
+        }
+        if (cmp < 0) {
+            high = mid - 1;
+        }
+        else {
+            low = mid + 1;
+        }
+    }
+    return -1;
+}
+
 /// @brief Finds an index into TCMD_telecommand_definitions for the given telecommand string.
-/// @details This function searches for the longest matching telecommand string in TCMD_telecommand_definitions, where all
-///          alpha-numeric characters at the start of the to-be-parsed telecommand match the telecommand string in
-///          TCMD_telecommand_definitions. This function is case-sensitive.
+/// @details The telecommand name is all the telecommand-name characters (alphanumeric and '_') after the
+///          prefix. It must exactly match a name in TCMD_telecommand_definitions. This function is case-sensitive.
 /// @param tcmd_str The telecommand string to search within, starting with prefix, optionally including args.
 /// @return The index into TCMD_telecommand_definitions for the given telecommand string. <0 if error.
 ///       Returns -1 if telecommand not found.
@@ -79,27 +126,11 @@ int32_t TCMD_parse_telecommand_get_index(const char *tcmd_str, uint32_t tcmd_str
             break;
         }
     }
-
-    // Iterate through the table of telecommands, and see if any match the given telecommand string
-    for (uint16_t check_cmd_idx = 0; check_cmd_idx < TCMD_NUM_TELECOMMANDS; check_cmd_idx++) {
-        if (tcmd_name_len != strlen(TCMD_telecommand_definitions[check_cmd_idx].tcmd_name)) {
-            continue;
-        }
-
-        for (uint16_t str_idx = 0; str_idx < tcmd_name_len; str_idx++) {
-            char rxd_char = tcmd_str[str_idx + TCMD_PREFIX_STR_LEN];
-            char real_tcmd_name_char = TCMD_telecommand_definitions[check_cmd_idx].tcmd_name[str_idx];
-            if (rxd_char != real_tcmd_name_char) {
-                break;
-            }
-
-            // if we've checked against the whole telecommand name
-            if (str_idx == (strlen(TCMD_telecommand_definitions[check_cmd_idx].tcmd_name) - 1)) {
-                return check_cmd_idx;
-            }
-        }
+    if (tcmd_name_len == 0) {
+        return (-1);
     }
-    return (-1);
+
+    return TCMD_get_telecommand_idx_by_name(&tcmd_str[TCMD_PREFIX_STR_LEN], tcmd_name_len);
 }
 
 /// @brief Searches for a `str` like `\@tag_name=xxxx`, and sets `uint64_t xxxx` into `out_value`.
@@ -471,6 +502,8 @@ uint8_t TCMD_parse_full_telecommand(
     parsed_tcmd_output->timestamp_sent = timestamp_sent;
     parsed_tcmd_output->timestamp_to_execute = timestamp_to_execute;
     memcpy(parsed_tcmd_output->resp_fname, tcmd_suffix_resp_fname, TCMD_MAX_RESP_FNAME_LEN);
+    parsed_tcmd_output->rx_source = TCMD_RX_SOURCE_NONE;
+    parsed_tcmd_output->uptime_at_rx_ms = 0;
 
     return 0;
 }
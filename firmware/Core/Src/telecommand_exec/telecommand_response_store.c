@@ -0,0 +1,313 @@
+// telecommand_response_store.c
+// Stores telecommand responses to their `@resp_fname` files.
+//
+// Opening, appending to, and closing the file for every response commits the file's metadata each
+// time, so an agenda of short telecommands sharing one `resp_fname` costs a metadata commit (and
+// usually a partly-filled data page) per telecommand. Instead, the most recently used response
+// files are kept open: entries are appended into the file's LittleFS cache (in RAM), and the file
+// is synced once `TCMD_resp_store_flush_bytes` are pending, once the oldest pending entry is
+// `TCMD_resp_store_flush_age_ms` old, when it's evicted by another response file, or on
+// shutdown/unmount (`TCMD_resp_store_close_all`).
+//
+// Until a file is synced, its pending entries aren't visible to other readers of the file, and
+// are lost on an unexpected reset.
+
+#include "telecommand_exec/telecommand_response_store.h"
+#include "telecommand_exec/telecommand_types.h"
+#include "littlefs/littlefs_helper.h"
+#include "littlefs/lfs.h"
+#include "timekeeping/timekeeping.h"
+#include "log/log.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/// @brief When 0, each response file is opened, appended to, and closed for every response.
+uint32_t TCMD_resp_store_batching_enabled = 1;
+
+/// @brief Sync a response file once this many bytes are pending. One flash page by default.
+uint32_t TCMD_resp_store_flush_bytes = FLASH_CHIP_PAGE_SIZE_BYTES;
+
+/// @brief Sync a response file once its oldest pending entry is this old. 0 syncs after every
+///     entry (the file is still kept open).
+uint32_t TCMD_resp_store_flush_age_ms = 10000;
+
+TCMD_resp_store_stats_t TCMD_resp_store_stats;
+
+static const char TCMD_resp_store_entry_delimiter[] = "\n[END_RESPONSE]\n";
+
+typedef struct {
+    uint8_t is_open;
+    char resp_fname[TCMD_MAX_RESP_FNAME_LEN];
+    lfs_file_t file;
+
+    /// @brief `LFS_mount_count` when opened. The handle is invalid after a remount.
+    uint32_t mount_count;
+
+    uint32_t last_used_ms;
+    uint32_t oldest_pending_ms;
+    uint32_t pending_bytes;
+} TCMD_resp_store_handle_t;
+
+// Statically allocate the LittleFS cache buffers (no malloc), like the log file's.
+static uint8_t TCMD_resp_store_cache_buffers[TCMD_RESP_STORE_HANDLE_COUNT][FLASH_CHIP_PAGE_SIZE_BYTES];
+static struct lfs_file_config TCMD_resp_store_file_configs[TCMD_RESP_STORE_HANDLE_COUNT];
+static TCMD_resp_store_handle_t TCMD_resp_store_handles[TCMD_RESP_STORE_HANDLE_COUNT];
+
+/// @brief Check that an open handle still belongs to the mounted filesystem, else forget it.
+/// @return 1 if the handle is open and usable.
+static uint8_t TCMD_resp_store_check_handle(TCMD_resp_store_handle_t *handle) {
+    if (!handle->is_open) {
+        return 0;
+    }
+    if (!LFS_is_lfs_mounted || (handle->mount_count != LFS_mount_count)) {
+        // The filesystem was unmounted without closing the file; `file` is no longer valid.
+        handle->is_open = 0;
+        TCMD_resp_store_stats.dropped_handle_count++;
+        return 0;
+    }
+    return 1;
+}
+
+static int8_t TCMD_resp_store_sync_handle(TCMD_resp_store_handle_t *handle) {
+    if (!TCMD_resp_store_check_handle(handle) || (handle->pending_bytes == 0)) {
+        return 0;
+    }
+    handle->pending_bytes = 0;
+    const int8_t sync_result = lfs_file_sync(&LFS_filesystem, &handle->file);
+    if (sync_result < 0) {
+        TCMD_resp_store_stats.error_count++;
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Error: TCMD_resp_store: Failed to sync %s. LFS error code: %d",
+            handle->resp_fname, sync_result
+        );
+        return sync_result;
+    }
+    TCMD_resp_store_stats.sync_count++;
+    return 0;
+}
+
+static int8_t TCMD_resp_store_close_handle(TCMD_resp_store_handle_t *handle) {
+    if (!TCMD_resp_store_check_handle(handle)) {
+        return 0;
+    }
+    handle->is_open = 0;
+    handle->pending_bytes = 0;
+    TCMD_resp_store_stats.close_count++;
+    const int8_t close_result = lfs_file_close(&LFS_filesystem, &handle->file);
+    if (close_result < 0) {
+        TCMD_resp_store_stats.error_count++;
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Error: TCMD_resp_store: Failed to close %s. LFS error code: %d",
+            handle->resp_fname, close_result
+        );
+        return close_result;
+    }
+    return 0;
+}
+
+/// @brief Get the open handle of a response file, opening it (and evicting the least recently
+///     used handle) if needed.
+/// @return The handle, or NULL on failure (logged).
+static TCMD_resp_store_handle_t *TCMD_resp_store_get_handle(const char resp_fname[], uint32_t now_ms) {
+    TCMD_resp_store_handle_t *chosen_handle = NULL;
+    for (uint8_t i = 0; i < TCMD_RESP_STORE_HANDLE_COUNT; i++) {
+        TCMD_resp_store_handle_t *handle = &TCMD_resp_store_handles[i];
+        if (!TCMD_resp_store_check_handle(handle)) {
+            if (chosen_handle == NULL || chosen_handle->is_open) {
+                chosen_handle = handle;
+            }
+            continue;
+        }
+        if (strcmp(handle->resp_fname, resp_fname) == 0) {
+            handle->last_used_ms = now_ms;
+            return handle;
+        }
+        if ((chosen_handle == NULL) || (chosen_handle->is_open && (handle->last_used_ms < chosen_handle->last_used_ms))) {
+            chosen_handle = handle;
+        }
+    }
+
+    // Evict (if needed), then open into the chosen handle.
+    TCMD_resp_store_close_handle(chosen_handle);
+
+    const uint8_t handle_num = (uint8_t)(chosen_handle - TCMD_resp_store_handles);
+    TCMD_resp_store_file_configs[handle_num].buffer = TCMD_resp_store_cache_buffers[handle_num];
+    const int8_t open_result = lfs_file_opencfg(
+        &LFS_filesystem, &chosen_handle->file, resp_fname,
+        LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND,
+        &TCMD_resp_store_file_configs[handle_num]
+    );
+    if (open_result < 0) {
+        TCMD_resp_store_stats.error_count++;
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Error: TCMD_resp_store: Failed to open file. LFS error code: %d",
+            open_result
+        );
+        return NULL;
+    }
+
+    chosen_handle->is_open = 1;
+    strncpy(chosen_handle->resp_fname, resp_fname, sizeof(chosen_handle->resp_fname) - 1);
+    chosen_handle->resp_fname[sizeof(chosen_handle->resp_fname) - 1] = '\0';
+    chosen_handle->mount_count = LFS_mount_count;
+    chosen_handle->last_used_ms = now_ms;
+    chosen_handle->pending_bytes = 0;
+    TCMD_resp_store_stats.open_count++;
+    return chosen_handle;
+}
+
+/// @brief Append a telecommand response entry (header, response, then the `[END_RESPONSE]`
+///     delimiter) to a response file.
+/// @param resp_fname File to append to (created if needed).
+/// @param header JSON header line of the entry.
+/// @param response Telecommand response.
+/// @return 0 on success, LFS error code on failure (logged).
+int8_t TCMD_resp_store_write_entry(const char resp_fname[], const char header[], const char response[]) {
+    const int8_t mount_ret = LFS_ensure_mounted();
+    if (mount_ret < 0) {
+        TCMD_resp_store_stats.error_count++;
+        LOG_message(
+            LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+            "Error: TCMD_resp_store: Failed to mount LFS. Error code: %d",
+            mount_ret
+        );
+        return mount_ret;
+    }
+
+    const uint32_t now_ms = TIME_uptime_ms();
+    TCMD_resp_store_handle_t *handle = TCMD_resp_store_get_handle(resp_fname, now_ms);
+    if (handle == NULL) {
+        return LFS_ERR_IO;
+    }
+
+    const char *parts[] = {header, response, TCMD_resp_store_entry_delimiter};
+    uint32_t entry_bytes = 0;
+    for (uint8_t i = 0; i < (sizeof(parts) / sizeof(parts[0])); i++) {
+        const lfs_ssize_t write_result = lfs_file_write(
+            &LFS_filesystem, &handle->file, parts[i], strlen(parts[i])
+        );
+        if (write_result < 0) {
+            TCMD_resp_store_stats.error_count++;
+            LOG_message(
+                LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
+                "Error: TCMD_resp_store: Failed to write to %s. LFS error code: %ld",
+                resp_fname, write_result
+            );
+            TCMD_resp_store_close_handle(handle);
+            return write_result;
+        }
+        entry_bytes += (uint32_t)write_result;
+    }
+
+    if (handle->pending_bytes == 0) {
+        handle->oldest_pending_ms = now_ms;
+    }
+    handle->pending_bytes += entry_bytes;
+    TCMD_resp_store_stats.entry_count++;
+    TCMD_resp_store_stats.bytes_written += entry_bytes;
+
+    if (!TCMD_resp_store_batching_enabled) {
+        return TCMD_resp_store_close_handle(handle);
+    }
+    if ((handle->pending_bytes >= TCMD_resp_store_flush_bytes) || (TCMD_resp_store_flush_age_ms == 0)) {
+        return TCMD_resp_store_sync_handle(handle);
+    }
+    return 0;
+}
+
+/// @brief Sync the response files whose oldest pending entry is `TCMD_resp_store_flush_age_ms` old.
+/// @note Call periodically (from the telecommand executor task).
+void TCMD_resp_store_flush_if_due(void) {
+    const uint32_t now_ms = TIME_uptime_ms();
+    for (uint8_t i = 0; i < TCMD_RESP_STORE_HANDLE_COUNT; i++) {
+        TCMD_resp_store_handle_t *handle = &TCMD_resp_store_handles[i];
+        if (
+            TCMD_resp_store_check_handle(handle)
+            && (handle->pending_bytes > 0)
+            && ((now_ms - handle->oldest_pending_ms) >= TCMD_resp_store_flush_age_ms)
+        ) {
+            TCMD_resp_store_sync_handle(handle);
+        }
+    }
+}
+
+/// @brief Sync all open response files (they stay open).
+/// @return 0 on success, else the last LFS error code.
+int8_t TCMD_resp_store_flush_all(void) {
+    int8_t result = 0;
+    for (uint8_t i = 0; i < TCMD_RESP_STORE_HANDLE_COUNT; i++) {
+        const int8_t sync_result = TCMD_resp_store_sync_handle(&TCMD_resp_store_handles[i]);
+        if (sync_result != 0) {
+            result = sync_result;
+        }
+    }
+    return result;
+}
+
+/// @brief Close all open response files (committing pending entries). Call before unmounting
+///     the filesystem or rebooting.
+/// @return 0 on success, else the last LFS error code.
+int8_t TCMD_resp_store_close_all(void) {
+    int8_t result = 0;
+    for (uint8_t i = 0; i < TCMD_RESP_STORE_HANDLE_COUNT; i++) {
+        const int8_t close_result = TCMD_resp_store_close_handle(&TCMD_resp_store_handles[i]);
+        if (close_result != 0) {
+            result = close_result;
+        }
+    }
+    return result;
+}
+
+void TCMD_resp_store_reset_stats(void) {
+    memset(&TCMD_resp_store_stats, 0, sizeof(TCMD_resp_store_stats));
+}
+
+/// @brief Format the response store statistics, and the open files, as a JSON object.
+/// @return Number of characters written (excluding the null terminator), or -1 if truncated.
+int16_t TCMD_resp_store_stats_to_json(char json_output_buf[], uint16_t json_output_buf_size) {
+    int written = snprintf(
+        json_output_buf,
+        json_output_buf_size,
+        "{"
+            "\"entry_count\":%" PRIu32 ","
+            "\"bytes_written\":%" PRIu32 ","
+            "\"open_count\":%" PRIu32 ","
+            "\"close_count\":%" PRIu32 ","
+            "\"sync_count\":%" PRIu32 ","
+            "\"dropped_handle_count\":%" PRIu32 ","
+            "\"error_count\":%" PRIu32 ","
+            "\"open_files\":[",
+        TCMD_resp_store_stats.entry_count,
+        TCMD_resp_store_stats.bytes_written,
+        TCMD_resp_store_stats.open_count,
+        TCMD_resp_store_stats.close_count,
+        TCMD_resp_store_stats.sync_count,
+        TCMD_resp_store_stats.dropped_handle_count,
+        TCMD_resp_store_stats.error_count
+    );
+    uint8_t is_first = 1;
+    for (uint8_t i = 0; (i < TCMD_RESP_STORE_HANDLE_COUNT) && (written >= 0) && (written < json_output_buf_size); i++) {
+        TCMD_resp_store_handle_t *handle = &TCMD_resp_store_handles[i];
+        if (!TCMD_resp_store_check_handle(handle)) {
+            continue;
+        }
+        written += snprintf(
+            &json_output_buf[written], json_output_buf_size - written,
+            "%s{\"name\":\"%s\",\"pending_bytes\":%" PRIu32 "}",
+            is_first ? "" : ",", handle->resp_fname, handle->pending_bytes
+        );
+        is_first = 0;
+    }
+    if ((written >= 0) && (written < json_output_buf_size)) {
+        written += snprintf(&json_output_buf[written], json_output_buf_size - written, "]}");
+    }
+    if ((written < 0) || (written >= json_output_buf_size)) {
+        return -1;
+    }
+    return (int16_t)written;
+}
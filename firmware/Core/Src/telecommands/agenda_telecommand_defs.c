@@ -4,6 +4,7 @@
 #include "telecommand_exec/telecommand_args_helpers.h"
 #include "telecommand_exec/telecommand_executor.h"
 #include "telecommand_exec/agenda_from_file.h"
+#include "telecommand_exec/telecommand_response_store.h"
 #include "debug_tools/debug_uart.h"
 #include "log/log.h"
 #include "transforms/arrays.h"
@@ -137,17 +138,11 @@ uint8_t TCMDEXEC_agenda_delete_all(
 ) {
     uint16_t num_deleted = 0;
     for (uint16_t slot_num = 0; slot_num < TCMD_AGENDA_SIZE; slot_num++) {
-        if (TCMD_agenda_is_valid[slot_num] == TCMD_AGENDA_ENTRY_VALID_AND_PENDING) {
-            TCMD_agenda_is_valid[slot_num] = TCMD_AGENDA_ENTRY_INVALID;
+        if (TCMD_agenda_delete_slot(slot_num) == 0) {
             num_deleted++;
         }
     }
 
-    // Not essential, but good to do. Reset the write index to 0.
-    // Benefit: Ensures that the next TCMD_AGENDA_SIZE telecommands will get executed perfectly
-    // in the order they were received, if there are tsexec ties.
-    TCMD_agenda_last_used_slot = 0;
-
     snprintf(
         response_output_buf, response_output_buf_len,
         "Deleted all %d entries from the agenda.",
@@ -168,10 +163,13 @@ uint8_t TCMDEXEC_agenda_delete_by_tssent(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t tssent = 0;
 
     // Parse the arg string passed into a uint64_t for the timestamp sent
-    const uint8_t parse_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &tssent);
+    const uint8_t parse_result = TCMD_args_get_uint64(&args, 0, &tssent);
 
     // Checking if the argument was valid.
     if (parse_result > 0) {
@@ -191,7 +189,7 @@ uint8_t TCMDEXEC_agenda_delete_by_tssent(
         ) {
             // Set agenda entry as invalid.
             tcmd_name = TCMD_telecommand_definitions[TCMD_agenda[slot_num].tcmd_idx].tcmd_name;
-            TCMD_agenda_is_valid[slot_num] = TCMD_AGENDA_ENTRY_INVALID;
+            TCMD_agenda_delete_slot(slot_num);
             deleted_count++;
         }
     }
@@ -264,8 +262,8 @@ uint8_t TCMDEXEC_agenda_delete_by_name(
             (TCMD_agenda_is_valid[slot_num] == TCMD_AGENDA_ENTRY_VALID_AND_PENDING) // It's valid.
             && (TCMD_agenda[slot_num].tcmd_idx == tcmd_idx) // It's the one we're searching for.
         ) {
-            // Set agenda as invalid ("delete" it).
-            TCMD_agenda_is_valid[slot_num] = TCMD_AGENDA_ENTRY_INVALID;
+            // Remove it from the agenda ("delete" it).
+            TCMD_agenda_delete_slot(slot_num);
             deleted_count++;
         }
     }
@@ -292,13 +290,16 @@ uint8_t TCMDEXEC_agenda_enqueue_from_file(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     const uint16_t pending_cmd_count_before = TCMD_get_agenda_used_slots_count();
 
     char arg_file_name[LFS_MAX_PATH_LENGTH];
 
     // Parse filename argument.
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(
-        args_str, 0, arg_file_name, sizeof(arg_file_name)
+    const uint8_t parse_file_name_result = TCMD_args_get_string(
+        &args, 0, arg_file_name, sizeof(arg_file_name)
     );
     if (parse_file_name_result != 0) {
         snprintf(
@@ -310,12 +311,12 @@ uint8_t TCMDEXEC_agenda_enqueue_from_file(
 
     // Parse filter timestamp arguments.
     uint64_t min_tsexec_inclusive;
-    const uint8_t parse_filter_arg_min_err = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 1, &min_tsexec_inclusive
+    const uint8_t parse_filter_arg_min_err = TCMD_args_get_uint64(
+        &args, 1, &min_tsexec_inclusive
     );
     uint64_t max_tsexec_exclusive;
-    const uint8_t parse_filter_arg_max_err = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 2, &max_tsexec_exclusive
+    const uint8_t parse_filter_arg_max_err = TCMD_args_get_uint64(
+        &args, 2, &max_tsexec_exclusive
     );
     if (parse_filter_arg_min_err != 0 || parse_filter_arg_max_err != 0) {
         snprintf(
@@ -366,3 +367,82 @@ uint8_t TCMDEXEC_agenda_enqueue_from_file(
 
     return 0; // Success.
 }
+
+
+/// @brief Telecommand: Get the latency from reception to start of execution of immediate
+///     telecommands, for each receiver, as JSON.
+/// @param args_str No arguments.
+/// @param response_output_buf The buffer to write the response to
+/// @param response_output_buf_len The maximum length of the response_output_buf (its size)
+/// @return 0 on success, 1 if the response was truncated.
+/// @note Latency is measured from the end of reception in the UART ISR, to the start of execution.
+///     Only immediate telecommands (no `@tsexec`) are counted. Times are in ms, since boot.
+uint8_t TCMDEXEC_agenda_get_rx_latency_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    const char *source_names[TCMD_RX_SOURCE_COUNT] = {
+        [TCMD_RX_SOURCE_NONE] = NULL,
+        [TCMD_RX_SOURCE_UMBILICAL_UART] = "umbilical",
+        [TCMD_RX_SOURCE_AX100] = "ax100",
+    };
+
+    uint16_t buf_pos = snprintf(response_output_buf, response_output_buf_len, "{");
+    for (uint8_t source = 0; source < TCMD_RX_SOURCE_COUNT; source++) {
+        if (source_names[source] == NULL) {
+            continue;
+        }
+        const TCMD_rx_latency_stats_t *stats = &TCMD_rx_latency_stats[source];
+        const uint32_t avg_latency_ms = (stats->sample_count > 0)
+            ? (uint32_t)(stats->total_latency_ms / stats->sample_count)
+            : 0;
+        buf_pos += snprintf(
+            response_output_buf + buf_pos, response_output_buf_len - buf_pos,
+            "%s\"%s\":{\"count\":%lu,\"last_ms\":%lu,\"min_ms\":%lu,\"max_ms\":%lu,\"avg_ms\":%lu}",
+            (buf_pos > 1) ? "," : "",
+            source_names[source],
+            stats->sample_count,
+            stats->last_latency_ms,
+            stats->min_latency_ms,
+            stats->max_latency_ms,
+            avg_latency_ms
+        );
+        if (buf_pos >= response_output_buf_len) {
+            return 1;
+        }
+    }
+    buf_pos += snprintf(response_output_buf + buf_pos, response_output_buf_len - buf_pos, "}");
+    if (buf_pos >= response_output_buf_len) {
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/// @brief Telecommand: Commit all batched `@resp_fname` responses to their files, and get the
+///     response store statistics as JSON.
+/// @param args_str No arguments.
+/// @param response_output_buf The buffer to write the response to
+/// @param response_output_buf_len The maximum length of the response_output_buf (its size)
+/// @return 0 on success, 1 if syncing a file failed, 2 if the response was truncated.
+/// @note Responses are otherwise committed every `TCMD_resp_store_flush_bytes` bytes or
+///     `TCMD_resp_store_flush_age_ms`. Use before reading a response file which is still in use.
+uint8_t TCMDEXEC_agenda_flush_response_files(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    const int8_t flush_result = TCMD_resp_store_flush_all();
+    if (flush_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error: TCMD_resp_store_flush_all() -> %d", flush_result
+        );
+        return 1;
+    }
+
+    if (TCMD_resp_store_stats_to_json(response_output_buf, response_output_buf_len) < 0) {
+        return 2;
+    }
+    return 0;
+}
@@ -18,8 +18,11 @@
 uint8_t TCMDEXEC_ant_reset(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) 
 {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus/mcu");
         return 1;
     }
@@ -54,8 +57,11 @@ uint8_t TCMDEXEC_ant_reset(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_ant_arm_antenna_system(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -91,8 +97,11 @@ uint8_t TCMDEXEC_ant_arm_antenna_system(const char *args_str,
 /// @return 0 on success, 0 > otherwise
 uint8_t TCMDEXEC_ant_disarm_antenna_system(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -130,8 +139,11 @@ uint8_t TCMDEXEC_ant_disarm_antenna_system(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_ant_deploy_antenna(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -151,7 +163,7 @@ uint8_t TCMDEXEC_ant_deploy_antenna(const char *args_str,
     }
 
     uint64_t antenna;
-    const uint8_t parse_antenna_result = TCMD_extract_uint64_arg(args_str, strlen(args_str),  1, &antenna);
+    const uint8_t parse_antenna_result = TCMD_args_get_uint64(&args, 1, &antenna);
     if (parse_antenna_result != 0) {
         // error parsing
         snprintf(
@@ -170,7 +182,7 @@ uint8_t TCMDEXEC_ant_deploy_antenna(const char *args_str,
     }
 
     uint64_t arg_activation_time;
-    const uint8_t parse_activation_time_result = TCMD_extract_uint64_arg(args_str, strlen(args_str),  2, &arg_activation_time);
+    const uint8_t parse_activation_time_result = TCMD_args_get_uint64(&args, 2, &arg_activation_time);
     if (parse_activation_time_result != 0) {
         // error parsing
         snprintf(
@@ -206,8 +218,11 @@ uint8_t TCMDEXEC_ant_deploy_antenna(const char *args_str,
 uint8_t TCMDEXEC_ant_start_automated_antenna_deployment(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) 
 {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -228,7 +243,7 @@ uint8_t TCMDEXEC_ant_start_automated_antenna_deployment(const char *args_str,
     }
 
     uint64_t activation_time;
-    const uint8_t parse_activation_time_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &activation_time);
+    const uint8_t parse_activation_time_result = TCMD_args_get_uint64(&args, 1, &activation_time);
     if (parse_activation_time_result != 0) {
         snprintf( response_output_buf, response_output_buf_len, "Error parsing argument: %d", parse_activation_time_result);
         return 3;
@@ -255,8 +270,11 @@ uint8_t TCMDEXEC_ant_start_automated_antenna_deployment(const char *args_str,
 /// @return 0 on successful communication, >0 on communications error 
 uint8_t TCMDEXEC_ant_deploy_antenna_with_override(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -277,7 +295,7 @@ uint8_t TCMDEXEC_ant_deploy_antenna_with_override(const char *args_str,
     }
 
     uint64_t antenna;
-    const uint8_t parse_antenna_result = TCMD_extract_uint64_arg(args_str, strlen(args_str),  1, &antenna);
+    const uint8_t parse_antenna_result = TCMD_args_get_uint64(&args, 1, &antenna);
     if (parse_antenna_result != 0) {
         // error parsing
         snprintf(
@@ -296,7 +314,7 @@ uint8_t TCMDEXEC_ant_deploy_antenna_with_override(const char *args_str,
     }
 
     uint64_t arg_activation_time;
-    const uint8_t parse_activation_time_result = TCMD_extract_uint64_arg(args_str, strlen(args_str),  2, &arg_activation_time);
+    const uint8_t parse_activation_time_result = TCMD_args_get_uint64(&args, 2, &arg_activation_time);
     if (parse_activation_time_result != 0) {
         // error parsing
         snprintf(
@@ -330,8 +348,11 @@ uint8_t TCMDEXEC_ant_deploy_antenna_with_override(const char *args_str,
 /// @return 0 on successful communication, > 0 on communications error
 uint8_t TCMDEXEC_ant_cancel_deployment_system_activation(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -368,8 +389,11 @@ uint8_t TCMDEXEC_ant_cancel_deployment_system_activation(const char *args_str,
 /// @return 0 on successful communication, > 0 on communications error
 uint8_t TCMDEXEC_ant_report_deployment_status(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -450,8 +474,11 @@ uint8_t TCMDEXEC_ant_report_deployment_status(const char *args_str,
 /// @return 0 on successful communication, > 0 on communications error
 uint8_t TCMDEXEC_ant_report_antenna_deployment_activation_count(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -472,7 +499,7 @@ uint8_t TCMDEXEC_ant_report_antenna_deployment_activation_count(const char *args
     }
 
     uint64_t antenna;
-    const uint8_t parse_antenna_result = TCMD_extract_uint64_arg(args_str, strlen(args_str),  1, &antenna);
+    const uint8_t parse_antenna_result = TCMD_args_get_uint64(&args, 1, &antenna);
     if (parse_antenna_result != 0) {
         // error parsing
         snprintf(
@@ -514,8 +541,11 @@ uint8_t TCMDEXEC_ant_report_antenna_deployment_activation_count(const char *args
 /// @return 0 on successful communication, > 0 on communications error
 uint8_t TCMDEXEC_ant_report_antenna_deployment_activation_time(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -536,7 +566,7 @@ uint8_t TCMDEXEC_ant_report_antenna_deployment_activation_time(const char *args_
     }
 
     uint64_t antenna;
-    const uint8_t parse_antenna_result = TCMD_extract_uint64_arg(args_str, strlen(args_str),  1, &antenna);
+    const uint8_t parse_antenna_result = TCMD_args_get_uint64(&args, 1, &antenna);
     if (parse_antenna_result != 0) {
         // error parsing
         snprintf(
@@ -576,8 +606,11 @@ uint8_t TCMDEXEC_ant_report_antenna_deployment_activation_time(const char *args_
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_ant_measure_temp(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char i2c_bus_str [2];
-    if(TCMD_extract_string_arg(args_str, 0, i2c_bus_str, 2) != 0 ) {
+    if(TCMD_args_get_string(&args, 0, i2c_bus_str, 2) != 0 ) {
         LOG_message(LOG_SYSTEM_TELECOMMAND,LOG_SEVERITY_ERROR,LOG_SINK_ALL, "Failed reading i2c bus");
         return 1;
     }
@@ -31,8 +31,11 @@ uint8_t TCMDEXEC_boom_deploy_timed(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t channel_u64;
-    const uint8_t arg0_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &channel_u64);
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &channel_u64);
     if (arg0_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -43,7 +46,7 @@ uint8_t TCMDEXEC_boom_deploy_timed(
     }
 
     uint64_t duration_ms_u64;
-    const uint8_t arg1_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &duration_ms_u64);
+    const uint8_t arg1_result = TCMD_args_get_uint64(&args, 1, &duration_ms_u64);
 
     if (arg1_result != 0) {
         snprintf(
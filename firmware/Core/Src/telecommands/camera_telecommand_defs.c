@@ -105,10 +105,13 @@ uint8_t TCMDEXEC_camera_change_baud_rate(
 uint8_t TCMDEXEC_camera_capture(const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len)
 {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Extract arg 0 - filename
     // Note: extract_string function null-terminates the string
     char filename[32] = {0};
-    const uint8_t parse_result_filename = TCMD_extract_string_arg(args_str, 0, filename, sizeof(filename));
+    const uint8_t parse_result_filename = TCMD_args_get_string(&args, 0, filename, sizeof(filename));
     if (parse_result_filename > 0) {
         snprintf(response_output_buf, response_output_buf_len, "Could not parse filename (arg 0) for: %s: Error:  %u", args_str, parse_result_filename);
         return 1;
@@ -116,7 +119,7 @@ uint8_t TCMDEXEC_camera_capture(const char *args_str,
 
     // Extract arg 1 - single char for lighting mode (d,m,n,s)
     char lighting[2];
-    const uint8_t parse_result_lighting_mode = TCMD_extract_string_arg(args_str, 1, lighting, sizeof(lighting));
+    const uint8_t parse_result_lighting_mode = TCMD_args_get_string(&args, 1, lighting, sizeof(lighting));
     if (parse_result_lighting_mode > 0) {
         snprintf(response_output_buf, response_output_buf_len, "Could not parse lighting mode (arg 1) for: %s. Error: %u", args_str, parse_result_lighting_mode);
         return 2;
@@ -1,9 +1,11 @@
+#include "main.h"
 #include "telecommands/comms_telecommand_defs.h"
 #include "comms_drivers/rf_antenna_switch.h"
 #include "telecommand_exec/telecommand_args_helpers.h"
 #include "littlefs/littlefs_helper.h"
 #include "comms_drivers/bulk_file_downlink.h"
 #include "comms_drivers/bulk_file_uplink.h"
+#include "comms_drivers/ax100_tx_pacing.h"
 #include "log/log.h"
 
 #include <string.h>
@@ -105,26 +107,28 @@ uint8_t TCMDEXEC_comms_bulk_file_downlink_start(
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
     const uint8_t args_str_len = strlen(args_str);
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, args_str_len, &args);
 
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(
-        args_str, 0,
+    const uint8_t parse_file_name_result = TCMD_args_get_string(
+        &args, 0,
         arg_file_name, sizeof(arg_file_name)
     );
     if (parse_file_name_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
-            "Error parsing file name arg: TCMD_extract_string_arg() -> %d", parse_file_name_result
+            "Error parsing file name arg: TCMD_args_get_string() -> %d", parse_file_name_result
         );
         return 1;
     }
 
     uint64_t start_offset = 0;
-    const uint8_t parse_offset_result = TCMD_extract_uint64_arg(args_str, args_str_len, 1, &start_offset);
+    const uint8_t parse_offset_result = TCMD_args_get_uint64(&args, 1, &start_offset);
     if (parse_offset_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
-            "Error parsing start offset arg: TCMD_extract_uint64_arg(arg=1) -> %d",
+            "Error parsing start offset arg: TCMD_args_get_uint64(arg=1) -> %d",
             parse_offset_result
         );
         return 2;
@@ -138,11 +142,11 @@ uint8_t TCMDEXEC_comms_bulk_file_downlink_start(
     }
 
     uint64_t max_bytes = 0;
-    const uint8_t parse_max_bytes_result = TCMD_extract_uint64_arg(args_str, args_str_len, 2, &max_bytes);
+    const uint8_t parse_max_bytes_result = TCMD_args_get_uint64(&args, 2, &max_bytes);
     if (parse_max_bytes_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
-            "Error parsing max bytes arg: TCMD_extract_uint64_arg(arg=2) -> %d",
+            "Error parsing max bytes arg: TCMD_args_get_uint64(arg=2) -> %d",
             parse_max_bytes_result
         );
         return 4;
@@ -175,7 +179,93 @@ uint8_t TCMDEXEC_comms_bulk_file_downlink_start(
 
     snprintf(
         response_output_buf, response_output_buf_len,
-        "Bulk file downlink started successfully!"
+        "Bulk file downlink started successfully! Transfer ID: %u. %u packets.",
+        COMMS_bulk_file_downlink_transfer_id,
+        COMMS_bulk_file_downlink_total_seq_num
+    );
+    return 0;
+}
+
+/// @brief Telecommand: Initiate a bulk file downlink over the UHF radio, compressing the data on the fly with heatshrink.
+/// @param args_str
+/// - Arg 0: File path to downlink as string
+/// - Arg 1: Start offset in file (uint32)
+/// - Arg 2: The maximum number of file bytes to compress and downlink. Same limits as `comms_bulk_file_downlink_start` (1 MB max, 0 = 1 MB).
+/// - Arg 3: window_sz2 (min 4, recommended 8, max 15, like CLI -w arg)
+/// - Arg 4: lookahead_sz2 (min 3, recommended 4, less than window_sz2, like CLI -l arg)
+/// @return 0 on success. Non-zero on failure.
+/// @note Packets are type 0x11, with offsets in the compressed stream. The stream starts with a
+///       14-byte header holding the window sizes and the file range, so no file is written to flash.
+/// @note Text logs, JSON telemetry and GNSS ASCII data compress about 2-4x, so they downlink 2-4x
+///       faster. Already-compressed data grows by up to 1/8; use `comms_bulk_file_downlink_start` for it.
+uint8_t TCMDEXEC_comms_bulk_file_downlink_start_compressed(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
+    char arg_file_name[LFS_MAX_PATH_LENGTH];
+    const uint8_t parse_file_name_result = TCMD_args_get_string(
+        &args, 0,
+        arg_file_name, sizeof(arg_file_name)
+    );
+    if (parse_file_name_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing file name arg: TCMD_args_get_string() -> %d", parse_file_name_result
+        );
+        return 1;
+    }
+
+    uint64_t start_offset = 0;
+    uint64_t max_bytes = 0;
+    uint64_t window_sz2 = 0;
+    uint64_t lookahead_sz2 = 0;
+    const uint8_t parse_offset_result = TCMD_args_get_uint64(&args, 1, &start_offset);
+    const uint8_t parse_max_bytes_result = TCMD_args_get_uint64(&args, 2, &max_bytes);
+    const uint8_t parse_window_sz2_result = TCMD_args_get_uint64(&args, 3, &window_sz2);
+    const uint8_t parse_lookahead_sz2_result = TCMD_args_get_uint64(&args, 4, &lookahead_sz2);
+    if (parse_offset_result || parse_max_bytes_result || parse_window_sz2_result || parse_lookahead_sz2_result) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing args: arg1_err=%d, arg2_err=%d, arg3_err=%d, arg4_err=%d",
+            parse_offset_result, parse_max_bytes_result, parse_window_sz2_result, parse_lookahead_sz2_result
+        );
+        return 2;
+    }
+    if ((start_offset > UINT32_MAX) || (max_bytes > UINT32_MAX) || (window_sz2 > 255) || (lookahead_sz2 > 255)) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error: an argument is too large."
+        );
+        return 3;
+    }
+
+    const int32_t result = COMMS_bulk_file_downlink_start_compressed(
+        arg_file_name, start_offset, max_bytes, (uint8_t)window_sz2, (uint8_t)lookahead_sz2
+    );
+    if (result < 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Downlink start failed (LFS error). COMMS_bulk_file_downlink_start_compressed() -> %ld",
+            result
+        );
+        return 10;
+    }
+    else if (result > 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Downlink start failed (non-LFS logical error). COMMS_bulk_file_downlink_start_compressed() -> %ld",
+            result
+        );
+        return 11;
+    }
+
+    snprintf(
+        response_output_buf, response_output_buf_len,
+        "Compressed bulk file downlink started successfully! %lu bytes to compress.",
+        COMMS_bulk_file_downlink_total_bytes
     );
     return 0;
 }
@@ -225,6 +315,95 @@ uint8_t TCMDEXEC_comms_bulk_file_downlink_resume(
     return 0;
 }
 
+/// @brief Telecommand: Request that lost packets of an uncompressed bulk file downlink be sent again.
+/// @param args_str
+/// - Arg 0: Transfer ID (uint16), from the `comms_bulk_file_downlink_start` response.
+/// - Arg 1: Sequence number of the first packet in the bitmap (first packet of the file is 1). The sequence number of a packet is (file_offset - start_offset) / 195 + 1.
+/// - Arg 2: Base64 bitmap of the packets to resend. Bit N (byte N/8, LSB first) requests packet (Arg 1 + N). Max 150 bytes (1200 packets).
+/// @note Only the NACKed packets are resent (from their offsets in the file), before the downlink
+///       continues in sequence. After a completed transfer, the file is reopened to resend them.
+/// @note `misc_tools/extract_radio_packets_from_uart_logs.py` prints these telecommands for the missing packets.
+uint8_t TCMDEXEC_comms_bulk_file_downlink_nack(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
+    uint64_t transfer_id = 0;
+    uint64_t first_seq_num = 0;
+    const uint8_t parse_transfer_id_result = TCMD_args_get_uint64(&args, 0, &transfer_id);
+    const uint8_t parse_first_seq_num_result = TCMD_args_get_uint64(&args, 1, &first_seq_num);
+    if (parse_transfer_id_result || parse_first_seq_num_result) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing args: arg0_err=%d, arg1_err=%d",
+            parse_transfer_id_result, parse_first_seq_num_result
+        );
+        return 1;
+    }
+    if ((transfer_id > UINT16_MAX) || (first_seq_num > UINT16_MAX)) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error: transfer ID or first sequence number is too large."
+        );
+        return 2;
+    }
+
+    uint8_t bitmap[150];
+    uint16_t bitmap_len = 0;
+    const uint8_t parse_bitmap_result = TCMD_args_get_base64_array(
+        &args, 2, bitmap, sizeof(bitmap), &bitmap_len
+    );
+    if (parse_bitmap_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing bitmap arg: TCMD_args_get_base64_array() -> %d",
+            parse_bitmap_result
+        );
+        return 3;
+    }
+
+    uint16_t nacked_count = 0;
+    const int32_t result = COMMS_bulk_file_downlink_nack(
+        (uint16_t)transfer_id, (uint16_t)first_seq_num, bitmap, bitmap_len, &nacked_count
+    );
+    if (result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Bulk downlink NACK failed. COMMS_bulk_file_downlink_nack() -> %ld (current transfer ID: %u)",
+            result,
+            COMMS_bulk_file_downlink_transfer_id
+        );
+        return 10;
+    }
+
+    snprintf(
+        response_output_buf, response_output_buf_len,
+        "Queued %u packets to resend (%u pending).",
+        nacked_count,
+        COMMS_bulk_file_downlink_nack_pending_count
+    );
+    return 0;
+}
+
+/// @brief Telecommand: Get the AX100 downlink pacing statistics (achieved packet rate, stalls, and
+///     the learned model of the radio's drain rate), as JSON.
+/// @param args_str No arguments.
+/// @return 0 on success, >0 on error.
+uint8_t TCMDEXEC_comms_get_tx_pacing_stats_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    AX100_tx_pacing_stats_t stats;
+    AX100_tx_pacing_get_stats(HAL_GetTick(), &stats);
+    if (AX100_tx_pacing_stats_to_json(&stats, response_output_buf, response_output_buf_len) < 0) {
+        snprintf(response_output_buf, response_output_buf_len, "Response buffer too small.");
+        return 1;
+    }
+    return 0;
+}
+
 // MARK: Bulk Uplink
 
 /// @brief Telecommand: Open a file for bulk uplink
@@ -236,29 +415,32 @@ uint8_t TCMDEXEC_comms_bulk_uplink_open_file(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_path[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_path_result = TCMD_extract_string_arg(
-        args_str, 0,
+    const uint8_t parse_path_result = TCMD_args_get_string(
+        &args, 0,
         arg_file_path, sizeof(arg_file_path)
     );
     if (parse_path_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
-            "Error parsing file path arg: TCMD_extract_string_arg() -> %d",
+            "Error parsing file path arg: TCMD_args_get_string() -> %d",
             parse_path_result
         );
         return 1;
     }
 
     char arg_mode_str[16];
-    const uint8_t parse_mode_result = TCMD_extract_string_arg(
-        args_str, 1,
+    const uint8_t parse_mode_result = TCMD_args_get_string(
+        &args, 1,
         arg_mode_str, sizeof(arg_mode_str)
     );
     if (parse_mode_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
-            "Error parsing mode arg: TCMD_extract_string_arg() -> %d",
+            "Error parsing mode arg: TCMD_args_get_string() -> %d",
             parse_mode_result
         );
         return 2;
@@ -348,11 +530,14 @@ uint8_t TCMDEXEC_comms_bulk_uplink_write_bytes_hex(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint8_t binary_data[200] = {0};
     uint16_t binary_data_length = 0;
 
-    const uint8_t parse_hex_result = TCMD_extract_hex_array_arg(
-        args_str,
+    const uint8_t parse_hex_result = TCMD_args_get_hex_array(
+        &args,
         0,
         binary_data,
         sizeof(binary_data),
@@ -362,7 +547,7 @@ uint8_t TCMDEXEC_comms_bulk_uplink_write_bytes_hex(
     if (parse_hex_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
-            "Error parsing hex bytes arg: TCMD_extract_hex_array_arg() -> %d",
+            "Error parsing hex bytes arg: TCMD_args_get_hex_array() -> %d",
             parse_hex_result
         );
         return 1;
@@ -409,11 +594,14 @@ uint8_t TCMDEXEC_comms_bulk_uplink_write_bytes_base64(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint8_t binary_data[200] = {0};
     uint16_t binary_data_length = 0;
 
-    const uint8_t parse_base64_result = TCMD_extract_base64_array_arg(
-        args_str,
+    const uint8_t parse_base64_result = TCMD_args_get_base64_array(
+        &args,
         0,
         binary_data,
         sizeof(binary_data),
@@ -423,7 +611,7 @@ uint8_t TCMDEXEC_comms_bulk_uplink_write_bytes_base64(
     if (parse_base64_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
-            "Error parsing base64 bytes arg: TCMD_extract_base64_array_arg() -> %d",
+            "Error parsing base64 bytes arg: TCMD_args_get_base64_array() -> %d",
             parse_base64_result
         );
         return 1;
@@ -504,10 +692,12 @@ uint8_t TCMDEXEC_comms_bulk_uplink_seek(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t new_position = 0;
-    const uint8_t parse_result = TCMD_extract_uint64_arg(
-        args_str,
-        strlen(args_str),
+    const uint8_t parse_result = TCMD_args_get_uint64(
+        &args,
         0,
         &new_position
     );
@@ -515,7 +705,7 @@ uint8_t TCMDEXEC_comms_bulk_uplink_seek(
     if (parse_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
-            "Error parsing seek position arg: TCMD_extract_uint64_arg() -> %d",
+            "Error parsing seek position arg: TCMD_args_get_uint64() -> %d",
             parse_result
         );
         return 1;
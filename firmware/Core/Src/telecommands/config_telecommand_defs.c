@@ -19,9 +19,12 @@ uint8_t TCMDEXEC_config_set_int_var(const char *args_str,
                                          char *response_output_buf, uint16_t response_output_buf_len)
 {
     const int args_str_len = strlen(args_str);
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, args_str_len, &args);
+
     char config_var_name[CONFIG_MAX_VARIABLE_NAME_LENGTH];
     memset(config_var_name, 0, CONFIG_MAX_VARIABLE_NAME_LENGTH);
-    const uint8_t parse_result = TCMD_extract_string_arg(args_str, 0, config_var_name, CONFIG_MAX_VARIABLE_NAME_LENGTH);
+    const uint8_t parse_result = TCMD_args_get_string(&args, 0, config_var_name, CONFIG_MAX_VARIABLE_NAME_LENGTH);
     if (parse_result > 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Could not parse arg 0 for: %s", args_str);
@@ -29,7 +32,7 @@ uint8_t TCMDEXEC_config_set_int_var(const char *args_str,
     }
 
     uint64_t config_var_new_value;
-    const uint8_t parse_result2 = TCMD_extract_uint64_arg(args_str, args_str_len, 1, &config_var_new_value);
+    const uint8_t parse_result2 = TCMD_args_get_uint64(&args, 1, &config_var_new_value);
     if (parse_result2 > 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Could not parse arg 1 for: %s", args_str);
@@ -56,10 +59,12 @@ uint8_t TCMDEXEC_config_set_str_var(const char *args_str,
                                          char *response_output_buf, uint16_t response_output_buf_len)
 
 {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
 
     char config_var_name[CONFIG_MAX_VARIABLE_NAME_LENGTH];
     memset(config_var_name, 0, CONFIG_MAX_VARIABLE_NAME_LENGTH);
-    const uint8_t parse_result = TCMD_extract_string_arg(args_str, 0, config_var_name, CONFIG_MAX_VARIABLE_NAME_LENGTH);
+    const uint8_t parse_result = TCMD_args_get_string(&args, 0, config_var_name, CONFIG_MAX_VARIABLE_NAME_LENGTH);
     if (parse_result > 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Could not parse arg 0 for: %s", args_str);
@@ -68,7 +73,7 @@ uint8_t TCMDEXEC_config_set_str_var(const char *args_str,
 
     char config_var_new_value[CONFIG_MAX_VARIABLE_NAME_LENGTH];
     memset(config_var_new_value, 0, CONFIG_MAX_VARIABLE_NAME_LENGTH);
-    const uint8_t parse_result2 = TCMD_extract_string_arg(args_str, 1, config_var_new_value, CONFIG_MAX_VARIABLE_NAME_LENGTH);
+    const uint8_t parse_result2 = TCMD_args_get_string(&args, 1, config_var_new_value, CONFIG_MAX_VARIABLE_NAME_LENGTH);
     if (parse_result2 > 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Could not parse arg 1 for: %s", args_str);
@@ -139,7 +144,7 @@ uint8_t TCMDEXEC_config_get_all_vars_jsonl(
         );
         LOG_message(
             LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
-            json_str
+            "%s", json_str
         );
     }
     
@@ -152,7 +157,7 @@ uint8_t TCMDEXEC_config_get_all_vars_jsonl(
         );
         LOG_message(
             LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
-            json_str
+            "%s", json_str
         );
     }
 
@@ -146,9 +146,12 @@ uint8_t TCMDEXEC_eps_set_channel_enabled(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Extract Arg 0: The channel name/number.
     char channel_str[30];
-    const uint8_t arg_0_result = TCMD_extract_string_arg(args_str, 0, channel_str, sizeof(channel_str));
+    const uint8_t arg_0_result = TCMD_args_get_string(&args, 0, channel_str, sizeof(channel_str));
     if (arg_0_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -158,7 +161,7 @@ uint8_t TCMDEXEC_eps_set_channel_enabled(
 
     // Extract Arg 1: 1 to enable (power on), 0 to disable (power off)
     uint64_t enabled_val_u64 = 42;
-    const uint8_t arg_1_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &enabled_val_u64);
+    const uint8_t arg_1_result = TCMD_args_get_uint64(&args, 1, &enabled_val_u64);
     if (arg_1_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -419,9 +422,12 @@ uint8_t TCMDEXEC_eps_get_pdu_data_for_channel_json(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Extract Arg 0: The channel name/number.
     char channel_str[30];
-    const uint8_t arg_0_result = TCMD_extract_string_arg(args_str, 0, channel_str, sizeof(channel_str));
+    const uint8_t arg_0_result = TCMD_args_get_string(&args, 0, channel_str, sizeof(channel_str));
     if (arg_0_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -722,9 +728,12 @@ uint8_t TCMDEXEC_eps_power_management_set_current_threshold(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Extract Arg 0: The channel name/number.
     char channel_str[30];
-    const uint8_t arg_0_result = TCMD_extract_string_arg(args_str, 0, channel_str, sizeof(channel_str));
+    const uint8_t arg_0_result = TCMD_args_get_string(&args, 0, channel_str, sizeof(channel_str));
     if (arg_0_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -734,7 +743,7 @@ uint8_t TCMDEXEC_eps_power_management_set_current_threshold(
 
     // Extract Arg 1: Threshold current (in mA) to set.
     uint64_t current_threshold = 0;
-    const uint8_t arg_1_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &current_threshold);
+    const uint8_t arg_1_result = TCMD_args_get_uint64(&args, 1, &current_threshold);
     if (arg_1_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -7,6 +7,8 @@
 #include "debug_tools/debug_uart.h"
 #include "log/log.h"
 #include "littlefs/littlefs_helper.h" // For unmounting.
+#include "littlefs/littlefs_page_cache.h"
+#include "littlefs/littlefs_driver.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -15,10 +17,7 @@
 uint8_t read_buf[FLASH_CHIP_PAGE_SIZE_BYTES];
 uint8_t bytes_to_write[FLASH_CHIP_PAGE_SIZE_BYTES];
 
-/// @brief Telecommand: Read bytes as hex from a flash address
-/// @param args_str No args.
-/// @return 0 always
-uint8_t TCMDEXEC_flash_activate_each_cs(const char *args_str,
+static uint8_t flash_activate_each_cs_with_lfs_locked(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
 
     for (uint8_t chip_number = 0; chip_number < FLASH_NUMBER_OF_FLASH_DEVICES; chip_number++) {
@@ -33,11 +32,21 @@ uint8_t TCMDEXEC_flash_activate_each_cs(const char *args_str,
     return 0;
 }
 
-
 /// @brief Telecommand: Read bytes as hex from a flash address
 /// @param args_str No args.
 /// @return 0 always
-uint8_t TCMDEXEC_flash_each_is_reachable(const char *args_str,
+uint8_t TCMDEXEC_flash_activate_each_cs(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_activate_each_cs_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
+
+
+static uint8_t flash_each_is_reachable_with_lfs_locked(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
     uint8_t fail_count = 0;
 
@@ -82,25 +91,35 @@ uint8_t TCMDEXEC_flash_each_is_reachable(const char *args_str,
     }
 }
 
+/// @brief Telecommand: Read bytes as hex from a flash address
+/// @param args_str No args.
+/// @return 0 always
+uint8_t TCMDEXEC_flash_each_is_reachable(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_each_is_reachable_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
 
-/// @brief Telecommand: Read bytes as hex from a page number
-/// @param args_str
-/// - Arg 0: Chip Number (CS number) as uint
-/// - Arg 1: Page number as uint
-/// - Arg 2: Number of bytes to read as uint
-/// @return 0 on success, >0 on error
-uint8_t TCMDEXEC_flash_read_hex(
+
+static uint8_t flash_read_hex_with_lfs_locked(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // FIXME: This can't print a whole page of data because TCMD_MAX_RESPONSE_BUFFER_LENGTH=2048.
     // One solution: Best to include an offset-into-page argument as well. Was removed in Marko's flash refactor.
 
     uint64_t chip_num_u64, page_num_u64, num_bytes_u64;
 
-    uint8_t arg0_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &chip_num_u64);
-    uint8_t arg1_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &page_num_u64);
-    uint8_t arg2_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 2, &num_bytes_u64);
+    uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &chip_num_u64);
+    uint8_t arg1_result = TCMD_args_get_uint64(&args, 1, &page_num_u64);
+    uint8_t arg2_result = TCMD_args_get_uint64(&args, 2, &num_bytes_u64);
     
     if (arg0_result != 0 || arg1_result != 0 || arg2_result != 0) {
         snprintf(
@@ -178,22 +197,35 @@ uint8_t TCMDEXEC_flash_read_hex(
     return 0;
 }
 
-
-/// @brief Telecommand: Write a hex string of bytes to a page number
+/// @brief Telecommand: Read bytes as hex from a page number
 /// @param args_str
 /// - Arg 0: Chip Number (CS number) as uint
 /// - Arg 1: Page number as uint
-/// - Arg 2: Hex string of bytes to write (any case, allows space/underscore separators)
+/// - Arg 2: Number of bytes to read as uint
 /// @return 0 on success, >0 on error
-uint8_t TCMDEXEC_flash_write_hex(const char *args_str,
+uint8_t TCMDEXEC_flash_read_hex(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_read_hex_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
+
+
+static uint8_t flash_write_hex_with_lfs_locked(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint16_t num_bytes;
     uint64_t chip_num_u64, page_num_u64;
 
-    const uint8_t arg0_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &chip_num_u64);
-    const uint8_t arg1_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &page_num_u64);
-    const uint8_t arg2_result = TCMD_extract_hex_array_arg(
-        args_str, 2, bytes_to_write, FLASH_CHIP_PAGE_SIZE_BYTES, &num_bytes
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &chip_num_u64);
+    const uint8_t arg1_result = TCMD_args_get_uint64(&args, 1, &page_num_u64);
+    const uint8_t arg2_result = TCMD_args_get_hex_array(
+        &args, 2, bytes_to_write, FLASH_CHIP_PAGE_SIZE_BYTES, &num_bytes
     );
     
     if (arg0_result != 0 || arg1_result != 0 || arg2_result != 0) {
@@ -227,6 +259,7 @@ uint8_t TCMDEXEC_flash_write_hex(const char *args_str,
         .row_address = page_num,
         .col_address = 0,
     };
+    LFS_page_cache_invalidate_page(chip_num, address.row_address);
     const FLASH_error_enum_t write_result = FLASH_program_page(chip_num, address, bytes_to_write, num_bytes);
 
     if (write_result != 0) {
@@ -244,18 +277,32 @@ uint8_t TCMDEXEC_flash_write_hex(const char *args_str,
     return 0;
 }
 
-
-/// @brief Telecommand: Erase a block of flash memory containing the given page number.
+/// @brief Telecommand: Write a hex string of bytes to a page number
 /// @param args_str
 /// - Arg 0: Chip Number (CS number) as uint
 /// - Arg 1: Page number as uint
+/// - Arg 2: Hex string of bytes to write (any case, allows space/underscore separators)
 /// @return 0 on success, >0 on error
-uint8_t TCMDEXEC_flash_erase(const char *args_str,
+uint8_t TCMDEXEC_flash_write_hex(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_write_hex_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
+
+
+static uint8_t flash_erase_with_lfs_locked(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t chip_num_u64, page_num_u64;
 
-    const uint8_t arg0_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &chip_num_u64);
-    const uint8_t arg1_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &page_num_u64);
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &chip_num_u64);
+    const uint8_t arg1_result = TCMD_args_get_uint64(&args, 1, &page_num_u64);
     
     if (arg0_result != 0 || arg1_result != 0) {
         snprintf(
@@ -287,6 +334,7 @@ uint8_t TCMDEXEC_flash_erase(const char *args_str,
         .row_address = page_num,
         .col_address = 0,
     };
+    LFS_page_cache_invalidate_block(chip_num, address.row_address);
     const FLASH_error_enum_t erase_result = FLASH_erase_block(chip_num, address);
 
     if (erase_result != 0) {
@@ -306,19 +354,31 @@ uint8_t TCMDEXEC_flash_erase(const char *args_str,
     return 0;
 }
 
-/// @brief Telecommand: Benchmarks the erase/write/read operations on the flash memory module.
+/// @brief Telecommand: Erase a block of flash memory containing the given page number.
 /// @param args_str
 /// - Arg 0: Chip Number (CS number) as uint
-/// - Arg 1: Test Data Address as uint
-/// - Arg 2: Test Data Length as uint
+/// - Arg 1: Page number as uint
 /// @return 0 on success, >0 on error
-uint8_t TCMDEXEC_flash_benchmark_erase_write_read(const char *args_str,
+uint8_t TCMDEXEC_flash_erase(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_erase_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
+
+static uint8_t flash_benchmark_erase_write_read_with_lfs_locked(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t chip_num, test_data_address, test_data_length;
 
-    uint8_t arg0_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &chip_num);
-    uint8_t arg1_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &test_data_address);
-    uint8_t arg2_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 2, &test_data_length);
+    uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &chip_num);
+    uint8_t arg1_result = TCMD_args_get_uint64(&args, 1, &test_data_address);
+    uint8_t arg2_result = TCMD_args_get_uint64(&args, 2, &test_data_length);
     
     if (arg0_result != 0 || arg1_result != 0 || arg2_result != 0) {
         snprintf(
@@ -328,6 +388,7 @@ uint8_t TCMDEXEC_flash_benchmark_erase_write_read(const char *args_str,
         return 1;
     }
 
+    LFS_page_cache_invalidate_all(); // The benchmark erases and programs a block.
     uint8_t result = FLASH_benchmark_erase_write_read((uint8_t)chip_num, (uint32_t)test_data_address, (uint32_t)test_data_length, response_output_buf, response_output_buf_len);
     response_output_buf[response_output_buf_len - 1] = '\0'; // ensure null-terminated
     if (result != 0) {
@@ -341,15 +402,88 @@ uint8_t TCMDEXEC_flash_benchmark_erase_write_read(const char *args_str,
     return result;
 }
 
-/// @brief Telecommand: Reset the flash memory module.
-/// @param args_str 
+/// @brief Telecommand: Benchmarks the erase/write/read operations on the flash memory module.
+/// @param args_str
 /// - Arg 0: Chip Number (CS number) as uint
+/// - Arg 1: Test Data Address as uint
+/// - Arg 2: Test Data Length as uint
 /// @return 0 on success, >0 on error
-uint8_t TCMDEXEC_flash_reset(const char *args_str,
+uint8_t TCMDEXEC_flash_benchmark_erase_write_read(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_benchmark_erase_write_read_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
+
+static uint8_t flash_benchmark_sequential_read_with_lfs_locked(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
+    uint64_t chip_num, start_page_num, page_count;
+
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &chip_num);
+    const uint8_t arg1_result = TCMD_args_get_uint64(&args, 1, &start_page_num);
+    const uint8_t arg2_result = TCMD_args_get_uint64(&args, 2, &page_count);
+
+    if (arg0_result != 0 || arg1_result != 0 || arg2_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing arguments. Return codes: arg0=%d, arg1=%d, arg2=%d",
+            arg0_result, arg1_result, arg2_result);
+        return 1;
+    }
+    if (chip_num >= FLASH_NUMBER_OF_FLASH_DEVICES || start_page_num > UINT32_MAX || page_count > UINT32_MAX) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Argument out of range.");
+        return 1;
+    }
+
+    const uint8_t result = FLASH_benchmark_sequential_read(
+        (uint8_t)chip_num, (uint32_t)start_page_num, (uint32_t)page_count,
+        response_output_buf, response_output_buf_len
+    );
+    response_output_buf[response_output_buf_len - 1] = '\0'; // ensure null-terminated
+    if (result != 0) {
+        snprintf(
+            &response_output_buf[strlen(response_output_buf)],
+            response_output_buf_len - strlen(response_output_buf) - 1,
+            "Error benchmarking flash: Returned %d", result);
+        return 2;
+    }
+
+    return 0;
+}
+
+/// @brief Telecommand: Benchmarks reading consecutive pages, with and without cache read mode.
+/// @param args_str
+/// - Arg 0: Chip Number (CS number) as uint
+/// - Arg 1: Start Page Number (row address) as uint
+/// - Arg 2: Page Count as uint (e.g., 64 for one block)
+/// @return 0 on success, >0 on error
+/// @note Reports the throughput in MB/s of each pass. Does not modify the flash contents.
+uint8_t TCMDEXEC_flash_benchmark_sequential_read(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_benchmark_sequential_read_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
+
+static uint8_t flash_reset_with_lfs_locked(const char *args_str,
+                        char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t chip_num_u64;
 
-    const uint8_t arg0_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &chip_num_u64);
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &chip_num_u64);
 
     if (arg0_result != 0) {
         snprintf(
@@ -385,15 +519,28 @@ uint8_t TCMDEXEC_flash_reset(const char *args_str,
     return 0;
 }
 
-/// @brief Telecommand: Read and print Status Register value as hex from the flash memory module.
-/// @param args_str
+/// @brief Telecommand: Reset the flash memory module.
+/// @param args_str 
 /// - Arg 0: Chip Number (CS number) as uint
 /// @return 0 on success, >0 on error
-uint8_t TCMDEXEC_flash_read_status_register(const char *args_str, 
+uint8_t TCMDEXEC_flash_reset(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_reset_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
+
+static uint8_t flash_read_status_register_with_lfs_locked(const char *args_str, 
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t chip_num_u64;
 
-    const uint8_t arg0_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &chip_num_u64);
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &chip_num_u64);
 
     if (arg0_result != 0) {
         snprintf(
@@ -430,17 +577,85 @@ uint8_t TCMDEXEC_flash_read_status_register(const char *args_str,
     return 0;
 }
 
+/// @brief Telecommand: Read and print Status Register value as hex from the flash memory module.
+/// @param args_str
+/// - Arg 0: Chip Number (CS number) as uint
+/// @return 0 on success, >0 on error
+uint8_t TCMDEXEC_flash_read_status_register(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_read_status_register_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
 
-/// @brief Force the LittleFS filesystem to be corrupted by modifying the underlying storage on a flash memory module.
+
+/// @brief Telecommand: Get the measured page program and block erase busy times of a flash chip,
+///     as JSON. Busy times are from the start of the wait to the status poll which found the chip
+///     ready. `histogram_log2_us[k]` counts busy times in [2^k, 2^(k+1)) us. Also gives the SPI DMA
+///     transfers (on any chip) which failed after their starter stopped waiting for them.
 /// @param args_str
 /// - Arg 0: Chip Number (CS number) as uint
-/// @return 0 on success (forced corruption). >0 on error.
-uint8_t TCMDEXEC_flash_force_corrupt_filesystem(
+/// @return 0 on success, >0 on error
+uint8_t TCMDEXEC_flash_get_busy_time_stats_json(const char *args_str,
+                        char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
+    uint64_t chip_num_u64;
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &chip_num_u64);
+    if (arg0_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing chip number argument: %d", arg0_result);
+        return 1;
+    }
+
+    if (chip_num_u64 >= FLASH_NUMBER_OF_FLASH_DEVICES) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Chip number is out of range. Must be 0 to %d.",
+            FLASH_NUMBER_OF_FLASH_DEVICES - 1);
+        return 2;
+    }
+
+    const uint8_t chip_num = (uint8_t)chip_num_u64;
+    char program_json[320];
+    char erase_json[320];
+    if (
+        (FLASH_busy_time_stats_to_json(
+            &FLASH_program_busy_time_stats[chip_num], program_json, sizeof(program_json)) < 0)
+        || (FLASH_busy_time_stats_to_json(
+            &FLASH_erase_busy_time_stats[chip_num], erase_json, sizeof(erase_json)) < 0)
+    ) {
+        snprintf(response_output_buf, response_output_buf_len, "Error formatting busy time stats.");
+        return 3;
+    }
+
+    const int written = snprintf(
+        response_output_buf, response_output_buf_len,
+        "{\"chip\":%u,\"program\":%s,\"erase\":%s,\"spi_abandoned_transfer_errors\":%lu,\"spi_last_abandoned_transfer_error\":%d}",
+        chip_num, program_json, erase_json,
+        FLASH_SPI_abandoned_transfer_error_count, FLASH_SPI_last_abandoned_transfer_error);
+    if ((written < 0) || (written >= response_output_buf_len)) {
+        snprintf(response_output_buf, response_output_buf_len, "Response buffer too small.");
+        return 4;
+    }
+    return 0;
+}
+
+
+static uint8_t flash_force_corrupt_filesystem_with_lfs_locked(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t chip_num_u64;
-    const uint8_t arg0_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &chip_num_u64);
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &chip_num_u64);
     if (arg0_result != 0) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -498,3 +713,17 @@ uint8_t TCMDEXEC_flash_force_corrupt_filesystem(
     );
     return 0;
 }
+
+/// @brief Force the LittleFS filesystem to be corrupted by modifying the underlying storage on a flash memory module.
+/// @param args_str
+/// - Arg 0: Chip Number (CS number) as uint
+/// @return 0 on success (forced corruption). >0 on error.
+uint8_t TCMDEXEC_flash_force_corrupt_filesystem(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    LFS_lock_for_raw_flash_access();
+    const uint8_t result = flash_force_corrupt_filesystem_with_lfs_locked(args_str, response_output_buf, response_output_buf_len);
+    LFS_unlock_for_raw_flash_access();
+    return result;
+}
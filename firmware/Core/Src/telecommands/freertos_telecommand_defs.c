@@ -84,9 +84,12 @@ uint8_t TCMDEXEC_freertos_demo_stack_usage(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t num_bytes;
-    uint8_t parse_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 0, &num_bytes
+    uint8_t parse_result = TCMD_args_get_uint64(
+        &args, 0, &num_bytes
     );
     if (parse_result > 0) {
         snprintf(response_output_buf, response_output_buf_len, "Error parsing num_bytes: Err=%d", parse_result);
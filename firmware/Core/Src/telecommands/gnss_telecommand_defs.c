@@ -122,9 +122,12 @@ uint8_t TCMDEXEC_gnss_send_cmd_ascii_get_response_hex(
 uint8_t TCMDEXEC_gnss_enable_firehose_storage_mode(
     const char *args_str, char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Get the file name from the telecommand argument.
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(args_str, 0, arg_file_name, sizeof(arg_file_name));
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
     if (parse_file_name_result != 0) {
         snprintf(
             response_output_buf,
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "main.h"
+#include "comms_drivers/ax100_tx.h"
 
 const uint32_t I2C_scan_number_of_trials = 3;
 const uint32_t I2C_scan_timeout_ms = 5;
@@ -45,6 +46,10 @@ uint8_t TCMDEXEC_scan_i2c_bus_verbose(
     uint8_t count_busy = 0;
     uint8_t count_misc = 0;
 
+    if (hi2c == &hi2c1) {
+        AX100_wait_for_tx_idle(); // I2C1 is shared with the AX100.
+    }
+
     // Go through all possible i2c addresses
     for (uint16_t i = 0; i < 128; i++) {
         const HAL_StatusTypeDef i2c_device_status = HAL_I2C_IsDeviceReady(hi2c, (i<<1), I2C_scan_number_of_trials, I2C_scan_timeout_ms);
@@ -120,6 +125,10 @@ uint8_t TCMDEXEC_scan_i2c_bus(
     uint8_t state_counts[5] = {0}; // [OK, ERROR, BUSY, TIMEOUT, MISC]
     HAL_StatusTypeDef address_states[128];
 
+    if (hi2c == &hi2c1) {
+        AX100_wait_for_tx_idle(); // I2C1 is shared with the AX100.
+    }
+
     // Scan the bus
     for (uint16_t i = 0; i < 128; i++) {
         address_states[i] = HAL_I2C_IsDeviceReady(hi2c, (i<<1), I2C_scan_number_of_trials, I2C_scan_timeout_ms);
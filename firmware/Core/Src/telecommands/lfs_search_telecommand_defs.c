@@ -16,11 +16,14 @@ uint8_t TCMDEXEC_fs_count_str_occurrences(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_path[LFS_MAX_PATH_LENGTH];
     char arg_needle[256];
 
-    const uint8_t parse_file_result = TCMD_extract_string_arg(
-        args_str, 0, arg_file_path, sizeof(arg_file_path)
+    const uint8_t parse_file_result = TCMD_args_get_string(
+        &args, 0, arg_file_path, sizeof(arg_file_path)
     );
     if (parse_file_result != 0) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -28,8 +31,8 @@ uint8_t TCMDEXEC_fs_count_str_occurrences(
         return 1;
     }
 
-    const uint8_t parse_needle_result = TCMD_extract_string_arg(
-        args_str, 1, arg_needle, sizeof(arg_needle)
+    const uint8_t parse_needle_result = TCMD_args_get_string(
+        &args, 1, arg_needle, sizeof(arg_needle)
     );
     if (parse_needle_result != 0) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -63,12 +66,15 @@ uint8_t TCMDEXEC_fs_find_nth_str_occurrence(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_path[LFS_MAX_PATH_LENGTH];
     char arg_needle[256];
     uint64_t n;
 
-    const uint8_t parse_file_result = TCMD_extract_string_arg(
-        args_str, 0, arg_file_path, sizeof(arg_file_path)
+    const uint8_t parse_file_result = TCMD_args_get_string(
+        &args, 0, arg_file_path, sizeof(arg_file_path)
     );
     if (parse_file_result != 0) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -76,8 +82,8 @@ uint8_t TCMDEXEC_fs_find_nth_str_occurrence(
         return 1;
     }
 
-    const uint8_t parse_needle_result = TCMD_extract_string_arg(
-        args_str, 1, arg_needle, sizeof(arg_needle)
+    const uint8_t parse_needle_result = TCMD_args_get_string(
+        &args, 1, arg_needle, sizeof(arg_needle)
     );
     if (parse_needle_result != 0) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -85,8 +91,8 @@ uint8_t TCMDEXEC_fs_find_nth_str_occurrence(
         return 2;
     }
 
-    const uint8_t parse_n_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 2, &n
+    const uint8_t parse_n_result = TCMD_args_get_uint64(
+        &args, 2, &n
     );
     if (parse_n_result != 0 || n == 0 || n > UINT16_MAX) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -126,12 +132,15 @@ uint8_t TCMDEXEC_fs_count_hex_occurrences(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_path[LFS_MAX_PATH_LENGTH];
     uint8_t needle[256];
     uint16_t needle_len = 0;
 
-    const uint8_t parse_file_result = TCMD_extract_string_arg(
-        args_str, 0, arg_file_path, sizeof(arg_file_path)
+    const uint8_t parse_file_result = TCMD_args_get_string(
+        &args, 0, arg_file_path, sizeof(arg_file_path)
     );
     if (parse_file_result != 0) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -139,8 +148,8 @@ uint8_t TCMDEXEC_fs_count_hex_occurrences(
         return 1;
     }
 
-    const uint8_t parse_hex_result = TCMD_extract_hex_array_arg(
-        args_str, 1, needle, sizeof(needle), &needle_len
+    const uint8_t parse_hex_result = TCMD_args_get_hex_array(
+        &args, 1, needle, sizeof(needle), &needle_len
     );
     if (parse_hex_result != 0 || needle_len == 0) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -174,13 +183,16 @@ uint8_t TCMDEXEC_fs_find_nth_hex_occurrence(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_path[LFS_MAX_PATH_LENGTH];
     uint8_t needle[256];
     uint16_t needle_len = 0;
     uint64_t n;
 
-    const uint8_t parse_file_result = TCMD_extract_string_arg(
-        args_str, 0, arg_file_path, sizeof(arg_file_path)
+    const uint8_t parse_file_result = TCMD_args_get_string(
+        &args, 0, arg_file_path, sizeof(arg_file_path)
     );
     if (parse_file_result != 0) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -188,8 +200,8 @@ uint8_t TCMDEXEC_fs_find_nth_hex_occurrence(
         return 1;
     }
 
-    const uint8_t parse_hex_result = TCMD_extract_hex_array_arg(
-        args_str, 1, needle, sizeof(needle), &needle_len
+    const uint8_t parse_hex_result = TCMD_args_get_hex_array(
+        &args, 1, needle, sizeof(needle), &needle_len
     );
     if (parse_hex_result != 0 || needle_len == 0) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -197,8 +209,8 @@ uint8_t TCMDEXEC_fs_find_nth_hex_occurrence(
         return 2;
     }
 
-    const uint8_t parse_n_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 2, &n
+    const uint8_t parse_n_result = TCMD_args_get_uint64(
+        &args, 2, &n
     );
     if (parse_n_result != 0 || n == 0 || n > UINT16_MAX) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -8,10 +8,14 @@
 #include "littlefs/littlefs_telecommands.h"
 #include "littlefs/littlefs_benchmark.h"
 #include "littlefs/littlefs_checksums.h"
+#include "littlefs/littlefs_page_cache.h"
 #include "log/log.h"
 #include "telecommands/lfs_telecommand_defs.h"
 #include "telecommand_exec/telecommand_definitions.h"
 #include "telecommand_exec/telecommand_args_helpers.h"
+#include "telecommand_exec/telecommand_response_store.h"
+#include "telecommand_exec/agenda_from_file.h"
+#include "mpi/mpi_frame_index.h"
 #include "transforms/arrays.h"
 #include "compression/heatshrink_helpers.h"
 #include "compression/heatshrink_lib/heatshrink_common.h"
@@ -25,6 +29,8 @@ uint8_t TCMDEXEC_fs_format_storage(
     const char *args_str,
         char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    // Release the open `@resp_fname` response files before their filesystem is erased.
+    TCMD_resp_store_close_all();
     const int8_t unmount_result = LFS_ensure_unmounted();
     if (unmount_result != 0) {
         LOG_message(
@@ -59,6 +65,8 @@ uint8_t TCMDEXEC_fs_mount(const char *args_str,
 
 uint8_t TCMDEXEC_fs_unmount(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    // Commit batched `@resp_fname` responses while the files can still be closed.
+    TCMD_resp_store_close_all();
     const int8_t result = LFS_unmount();
     if (result != 0) {
         snprintf(response_output_buf, response_output_buf_len, "Error: LFS_unmount() -> %d", result);
@@ -80,9 +88,12 @@ uint8_t TCMDEXEC_fs_list_directory(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_root_directory_path[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_directory_path_result = TCMD_extract_string_arg(
-        args_str, 0, arg_root_directory_path, sizeof(arg_root_directory_path)
+    const uint8_t parse_directory_path_result = TCMD_args_get_string(
+        &args, 0, arg_root_directory_path, sizeof(arg_root_directory_path)
     );
     if (parse_directory_path_result != 0) {
         // error parsing
@@ -94,8 +105,8 @@ uint8_t TCMDEXEC_fs_list_directory(
     }
 
     uint64_t arg_listing_offset = 0;
-    const uint8_t parse_listing_offset_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 1, &arg_listing_offset
+    const uint8_t parse_listing_offset_result = TCMD_args_get_uint64(
+        &args, 1, &arg_listing_offset
     );
     if (parse_listing_offset_result != 0) {
         // error parsing
@@ -107,8 +118,8 @@ uint8_t TCMDEXEC_fs_list_directory(
     }
 
     uint64_t arg_listing_count = 0;
-    const uint8_t parse_listing_count_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 2, &arg_listing_count
+    const uint8_t parse_listing_count_result = TCMD_args_get_uint64(
+        &args, 2, &arg_listing_count
     );
     if (parse_listing_count_result != 0) {
         // error parsing
@@ -143,9 +154,12 @@ uint8_t TCMDEXEC_fs_list_directory_json(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_root_directory_path[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_directory_path_result = TCMD_extract_string_arg(
-        args_str, 0, arg_root_directory_path, sizeof(arg_root_directory_path)
+    const uint8_t parse_directory_path_result = TCMD_args_get_string(
+        &args, 0, arg_root_directory_path, sizeof(arg_root_directory_path)
     );
     if (parse_directory_path_result != 0) {
         // error parsing
@@ -157,8 +171,8 @@ uint8_t TCMDEXEC_fs_list_directory_json(
     }
 
     uint64_t arg_listing_offset = 0;
-    const uint8_t parse_listing_offset_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 1, &arg_listing_offset
+    const uint8_t parse_listing_offset_result = TCMD_args_get_uint64(
+        &args, 1, &arg_listing_offset
     );
     if (parse_listing_offset_result != 0) {
         // error parsing
@@ -170,8 +184,8 @@ uint8_t TCMDEXEC_fs_list_directory_json(
     }
 
     uint64_t arg_listing_count = 0;
-    const uint8_t parse_listing_count_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 2, &arg_listing_count
+    const uint8_t parse_listing_count_result = TCMD_args_get_uint64(
+        &args, 2, &arg_listing_count
     );
     if (parse_listing_count_result != 0) {
         // error parsing
@@ -197,15 +211,82 @@ uint8_t TCMDEXEC_fs_list_directory_json(
     return 0;
 }
 
+/// @brief Telecommand: List a page of the files and directories within a given directory, as JSON.
+///     Page through a directory by passing each response's "next" value as the next cursor.
+/// @param args_str
+/// - Arg 0: Root Directory path as string
+/// - Arg 1: Cursor: 0 for the first page, else the "next" value from the previous page
+/// - Arg 2: (Count) Maximum number of entries in the page; 0 for as many as fit in the response
+/// @note Response: `{"entries":{"/dir/file":size,"/dir/subdir/":null,...},"next":cursor}`, where
+///     "next" is null once the end of the directory is reached.
+/// @note Each page continues from the previous one (or from the in-RAM index of the directory),
+///     instead of re-reading all earlier entries from flash like `fs_list_directory_json`'s offset.
+uint8_t TCMDEXEC_fs_list_directory_page_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
+    char arg_root_directory_path[LFS_MAX_PATH_LENGTH];
+    const uint8_t parse_directory_path_result = TCMD_args_get_string(
+        &args, 0, arg_root_directory_path, sizeof(arg_root_directory_path)
+    );
+    if (parse_directory_path_result != 0) {
+        snprintf(
+            response_output_buf,
+            response_output_buf_len,
+            "Error parsing directory path arg: Error %d", parse_directory_path_result);
+        return 1;
+    }
+
+    uint64_t arg_cursor = 0;
+    const uint8_t parse_cursor_result = TCMD_args_get_uint64(&args, 1, &arg_cursor);
+    if ((parse_cursor_result != 0) || (arg_cursor > UINT32_MAX)) {
+        snprintf(
+            response_output_buf,
+            response_output_buf_len,
+            "Error parsing cursor arg: Error %d", parse_cursor_result);
+        return 2;
+    }
+
+    uint64_t arg_listing_count = 0;
+    const uint8_t parse_listing_count_result = TCMD_args_get_uint64(&args, 2, &arg_listing_count);
+    if ((parse_listing_count_result != 0) || (arg_listing_count > UINT16_MAX)) {
+        snprintf(
+            response_output_buf,
+            response_output_buf_len,
+            "Error parsing count arg: Error %d", parse_listing_count_result);
+        return 3;
+    }
+
+    const int32_t list_directory_result = LFS_list_directory_page_json(
+        arg_root_directory_path, (uint32_t)arg_cursor, (uint16_t)arg_listing_count,
+        response_output_buf, response_output_buf_len
+    );
+    if (list_directory_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "LittleFS List Directory Error: %ld", list_directory_result
+        );
+        return 4;
+    }
+
+    return 0;
+}
+
 /// @brief Telecommand: Create a directory
 /// @param args_str
 /// - Arg 0: Directory Name as string (e.g., "/dir1", "/dir1/subdir1")
 uint8_t TCMDEXEC_fs_make_directory(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_root_directory_path[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_directory_path_result = TCMD_extract_string_arg(
-        args_str, 0, arg_root_directory_path, sizeof(arg_root_directory_path)
+    const uint8_t parse_directory_path_result = TCMD_args_get_string(
+        &args, 0, arg_root_directory_path, sizeof(arg_root_directory_path)
     );
     if (parse_directory_path_result != 0) {
         // Error parsing
@@ -238,9 +319,11 @@ uint8_t TCMDEXEC_fs_make_directory(const char *args_str,
 /// - Arg 1: String to write to file (up to 512 bytes)
 uint8_t TCMDEXEC_fs_write_file_str(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
 
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(args_str, 0, arg_file_name, sizeof(arg_file_name));
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
     if (parse_file_name_result != 0) {
         // error parsing
         snprintf(
@@ -251,7 +334,7 @@ uint8_t TCMDEXEC_fs_write_file_str(const char *args_str,
     }
 
     char arg_file_content[512] = {0};
-    const uint8_t parse_file_content_result = TCMD_extract_string_arg(args_str, 1, arg_file_content, sizeof(arg_file_content));
+    const uint8_t parse_file_content_result = TCMD_args_get_string(&args, 1, arg_file_content, sizeof(arg_file_content));
     if (parse_file_content_result != 0) {
         // error parsing
         snprintf(
@@ -262,6 +345,7 @@ uint8_t TCMDEXEC_fs_write_file_str(const char *args_str,
     }
 
     const int8_t result = LFS_write_file(arg_file_name, (uint8_t*) arg_file_content, strlen(arg_file_content));
+    TCMD_agenda_file_invalidate_index(arg_file_name);
     if (result != 0) {
         snprintf(response_output_buf, response_output_buf_len, "Error: LFS_write_file() -> %d", result);
         return 1;
@@ -279,8 +363,11 @@ uint8_t TCMDEXEC_fs_write_file_str(const char *args_str,
 /// @note The maximum number of bytes that can be written is 105 bytes
 uint8_t TCMDEXEC_fs_write_file_hex(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(args_str, 0, arg_file_name, sizeof(arg_file_name));
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
     if (parse_file_name_result != 0) {
         // error parsing
         snprintf(
@@ -292,7 +379,7 @@ uint8_t TCMDEXEC_fs_write_file_hex(const char *args_str,
 
     // Extract the offset parameter
     uint64_t file_offset = 0;
-    const uint8_t parse_offset_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &file_offset);
+    const uint8_t parse_offset_result = TCMD_args_get_uint64(&args, 1, &file_offset);
     if (parse_offset_result != 0) {
         // error parsing
         snprintf(
@@ -307,8 +394,8 @@ uint8_t TCMDEXEC_fs_write_file_hex(const char *args_str,
     uint16_t binary_data_length = 0;
     
     // Extract and convert hex string to binary data
-    const uint8_t parse_hex_result = TCMD_extract_hex_array_arg(
-        args_str, 2, binary_data, sizeof(binary_data), &binary_data_length
+    const uint8_t parse_hex_result = TCMD_args_get_hex_array(
+        &args, 2, binary_data, sizeof(binary_data), &binary_data_length
     );
     
     if (parse_hex_result != 0) {
@@ -322,6 +409,7 @@ uint8_t TCMDEXEC_fs_write_file_hex(const char *args_str,
 
     // Use our new helper function to write the data at the specified offset
     const int8_t result = LFS_write_file_with_offset(arg_file_name, (lfs_soff_t)file_offset, binary_data, binary_data_length);
+    TCMD_agenda_file_invalidate_index(arg_file_name);
     if (result != 0) {
         snprintf(response_output_buf, response_output_buf_len, "LittleFS Writing Error: %d", result);
         return 4;
@@ -339,8 +427,11 @@ uint8_t TCMDEXEC_fs_write_file_hex(const char *args_str,
 /// @note Do not add quotations around the argument, write as is.
 uint8_t TCMDEXEC_fs_delete_file(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(args_str, 0, arg_file_name, sizeof(arg_file_name));
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
     if (parse_file_name_result != 0) {
         // error parsing
         snprintf(
@@ -351,6 +442,8 @@ uint8_t TCMDEXEC_fs_delete_file(const char *args_str,
     }
 
     int8_t result = LFS_delete_file(arg_file_name);
+    TCMD_agenda_file_invalidate_index(arg_file_name);
+    MPI_frame_index_delete(arg_file_name);
     if (result != 0) {
         snprintf(response_output_buf, response_output_buf_len, "Error: LFS_delete_file() -> %d", result);
         return 1;
@@ -368,8 +461,11 @@ uint8_t TCMDEXEC_fs_delete_dir(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_dir_name_result = TCMD_extract_string_arg(args_str, 0, arg_file_name, sizeof(arg_file_name));
+    const uint8_t parse_dir_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
     if (parse_dir_name_result != 0) {
         // error parsing
         snprintf(
@@ -399,8 +495,11 @@ uint8_t TCMDEXEC_fs_delete_dir(
 static uint8_t parse_arg_str_for_file_offset_length(
     const char args_str[], char *dest_filename, uint16_t dest_filename_size, uint32_t *dest_offset, uint32_t *dest_length
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Extract the file name
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(args_str, 0, dest_filename, dest_filename_size);
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, dest_filename, dest_filename_size);
     if (parse_file_name_result != 0) {
         // error parsing
         return parse_file_name_result;
@@ -408,7 +507,7 @@ static uint8_t parse_arg_str_for_file_offset_length(
 
     // Extract the offset parameter
     uint64_t offset_u64;
-    const uint8_t parse_offset_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &offset_u64);
+    const uint8_t parse_offset_result = TCMD_args_get_uint64(&args, 1, &offset_u64);
     if (parse_offset_result != 0) {
         // error parsing
         return parse_offset_result;
@@ -421,7 +520,7 @@ static uint8_t parse_arg_str_for_file_offset_length(
 
     // Extract the length parameter
     uint64_t length_u64;
-    const uint8_t parse_length_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 2, &length_u64);
+    const uint8_t parse_length_result = TCMD_args_get_uint64(&args, 2, &length_u64);
     if (parse_length_result != 0) {
         // error parsing
         return parse_length_result;
@@ -644,12 +743,15 @@ uint8_t TCMDEXEC_fs_demo_write_random_data(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(args_str, 0, arg_file_name, sizeof(arg_file_name));
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
 
     uint64_t arg_file_size, arg_randomness_amount;
-    const uint8_t arg_file_size_err = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &arg_file_size);
-    const uint8_t arg_randomness_amount_err = TCMD_extract_uint64_arg(args_str, strlen(args_str), 2, &arg_randomness_amount);
+    const uint8_t arg_file_size_err = TCMD_args_get_uint64(&args, 1, &arg_file_size);
+    const uint8_t arg_randomness_amount_err = TCMD_args_get_uint64(&args, 2, &arg_randomness_amount);
 
     if (
         parse_file_name_result != 0 || arg_file_size_err != 0 || arg_randomness_amount_err != 0
@@ -743,6 +845,7 @@ uint8_t TCMDEXEC_fs_demo_write_random_data(
     }
 
     const int8_t close_err = lfs_file_close(&LFS_filesystem, &file);
+    TCMD_agenda_file_invalidate_index(arg_file_name);
     if (close_err != 0) {
         snprintf(response_output_buf, response_output_buf_len, "LittleFS close error: %d", close_err);
         return 5;
@@ -765,11 +868,13 @@ uint8_t TCMDEXEC_fs_demo_write_random_data(
 /// @note The maximum write chunk size is 127 bytes, apparently; need to investigate why so small.
 uint8_t TCMDEXEC_fs_benchmark_write_read(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
-    
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t arg_write_chunk_size, arg_write_chunk_count;
 
-    const uint8_t parse_write_chunk_size_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &arg_write_chunk_size);
-    const uint8_t parse_write_chunk_count_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &arg_write_chunk_count);
+    const uint8_t parse_write_chunk_size_result = TCMD_args_get_uint64(&args, 0, &arg_write_chunk_size);
+    const uint8_t parse_write_chunk_count_result = TCMD_args_get_uint64(&args, 1, &arg_write_chunk_count);
     if (parse_write_chunk_size_result != 0 || parse_write_chunk_count_result != 0) {
         // error parsing
         snprintf(
@@ -814,6 +919,40 @@ uint8_t TCMDEXEC_fs_get_filesystem_stats_json(
     return 0; // Success.
 }
 
+/// @brief Get the block device page cache counters and settings as JSON.
+/// @param args_str
+/// - Arg 0: 1 to reset the counters after reading them, 0 to keep them.
+/// @return 0 on success, >0 on error.
+/// @note Settings are the `LFS_page_cache_page_count` and `LFS_page_cache_read_ahead_page_count`
+///     config vars.
+uint8_t TCMDEXEC_fs_get_page_cache_stats_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
+    uint64_t reset_after_read;
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &reset_after_read);
+    if (arg0_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing reset argument: %d", arg0_result
+        );
+        return 1;
+    }
+
+    if (LFS_page_cache_stats_to_json(response_output_buf, response_output_buf_len) < 0) {
+        snprintf(response_output_buf, response_output_buf_len, "Response buffer too small.");
+        return 2;
+    }
+
+    if (reset_after_read) {
+        LFS_page_cache_reset_stats();
+    }
+    return 0;
+}
+
 /// @brief Compress a file using heatshrink.
 /// @param args_str 
 /// - Arg 0: Input file path
@@ -830,13 +969,16 @@ uint8_t TCMDEXEC_fs_compress_file_with_heatshrink(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_in[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_in_result = TCMD_extract_string_arg(
-        args_str, 0, arg_file_in, sizeof(arg_file_in)
+    const uint8_t parse_file_name_in_result = TCMD_args_get_string(
+        &args, 0, arg_file_in, sizeof(arg_file_in)
     );
     char arg_file_out[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_out_result = TCMD_extract_string_arg(
-        args_str, 1, arg_file_out, sizeof(arg_file_out)
+    const uint8_t parse_file_name_out_result = TCMD_args_get_string(
+        &args, 1, arg_file_out, sizeof(arg_file_out)
     );
     if (parse_file_name_in_result || parse_file_name_out_result) {
         snprintf(
@@ -851,11 +993,11 @@ uint8_t TCMDEXEC_fs_compress_file_with_heatshrink(
 
     uint64_t arg_window_sz2;
     uint64_t arg_lookahead_sz2;
-    const uint8_t parse_window_sz2_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 2, &arg_window_sz2
+    const uint8_t parse_window_sz2_result = TCMD_args_get_uint64(
+        &args, 2, &arg_window_sz2
     );
-    const uint8_t parse_lookahead_sz2_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 3, &arg_lookahead_sz2
+    const uint8_t parse_lookahead_sz2_result = TCMD_args_get_uint64(
+        &args, 3, &arg_lookahead_sz2
     );
     const uint8_t is_out_of_range = (
         arg_window_sz2 < HEATSHRINK_MIN_WINDOW_BITS
@@ -22,8 +22,11 @@ uint8_t TCMDEXEC_log_set_sink_enabled_state(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t sink;
-    const uint8_t sink_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &sink);
+    const uint8_t sink_result = TCMD_args_get_uint64(&args, 0, &sink);
     if (sink_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -33,7 +36,7 @@ uint8_t TCMDEXEC_log_set_sink_enabled_state(
     }
 
     uint64_t state;
-    const uint8_t state_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &state);
+    const uint8_t state_result = TCMD_args_get_uint64(&args, 1, &state);
     if (state_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -71,8 +74,11 @@ uint8_t TCMDEXEC_log_set_system_file_logging_enabled_state(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t system;
-    const uint8_t system_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &system);
+    const uint8_t system_result = TCMD_args_get_uint64(&args, 0, &system);
     if (system_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -82,7 +88,7 @@ uint8_t TCMDEXEC_log_set_system_file_logging_enabled_state(
     }
 
     uint64_t state;
-    const uint8_t state_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &state);
+    const uint8_t state_result = TCMD_args_get_uint64(&args, 1, &state);
     if (state_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -139,8 +145,11 @@ uint8_t TCMDEXEC_log_set_sink_debugging_messages_state(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t sink = 0;
-    const uint8_t sink_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &sink);
+    const uint8_t sink_result = TCMD_args_get_uint64(&args, 0, &sink);
     if (sink_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -150,7 +159,7 @@ uint8_t TCMDEXEC_log_set_sink_debugging_messages_state(
     }
     
     uint64_t state = 0;
-    const uint8_t state_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &state);
+    const uint8_t state_result = TCMD_args_get_uint64(&args, 1, &state);
     if (state_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -188,8 +197,11 @@ uint8_t TCMDEXEC_log_set_system_debugging_messages_state(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t system = 0;
-    uint8_t system_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &system);
+    uint8_t system_result = TCMD_args_get_uint64(&args, 0, &system);
     if (system_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -199,7 +211,7 @@ uint8_t TCMDEXEC_log_set_system_debugging_messages_state(
     }
     
     uint64_t state = 0;
-    uint8_t state_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &state);
+    uint8_t state_result = TCMD_args_get_uint64(&args, 1, &state);
     if (state_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -246,8 +258,11 @@ uint8_t TCMDEXEC_log_set_system_severity_mask(
         const char *args_str, 
         char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t system = 0;
-    uint8_t system_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &system);
+    uint8_t system_result = TCMD_args_get_uint64(&args, 0, &system);
     if (system_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -257,7 +272,7 @@ uint8_t TCMDEXEC_log_set_system_severity_mask(
     }
     
     uint64_t severity_mask = 0;
-    uint8_t severity_mask_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &severity_mask);
+    uint8_t severity_mask_result = TCMD_args_get_uint64(&args, 1, &severity_mask);
     if (severity_mask_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -281,8 +296,11 @@ uint8_t TCMDEXEC_log_report_n_latest_messages_from_memory(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t requested_number_of_entries = 0;
-    uint8_t result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &requested_number_of_entries);
+    uint8_t result = TCMD_args_get_uint64(&args, 0, &requested_number_of_entries);
     if (result) {
         snprintf(
             response_output_buf, response_output_buf_len,
@@ -342,10 +360,13 @@ uint8_t TCMDEXEC_log_report_messages_from_memory(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t arg_offset = 0;
-    const uint8_t arg0_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &arg_offset);
+    const uint8_t arg0_result = TCMD_args_get_uint64(&args, 0, &arg_offset);
     uint64_t arg_count = 0;
-    const uint8_t arg1_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &arg_count);
+    const uint8_t arg1_result = TCMD_args_get_uint64(&args, 1, &arg_count);
     if (arg0_result || arg1_result) {
         snprintf(
             response_output_buf, response_output_buf_len,
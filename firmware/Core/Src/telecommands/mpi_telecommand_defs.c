@@ -3,6 +3,8 @@
 #include "mpi/mpi_command_handling.h"
 #include "transforms/arrays.h"
 #include "mpi/mpi_transceiver.h"
+#include "mpi/mpi_frame_index.h"
+#include "comms_drivers/bulk_file_downlink.h"
 #include "littlefs/littlefs_helper.h"
 #include "log/log.h"
 #include "uart_handler/uart_handler.h"
@@ -28,11 +30,14 @@ uint8_t TCMDEXEC_mpi_send_command_get_response_hex(
 ) {    
     // Parse hex-encoded string to bytes
     const size_t args_str_len = strlen(args_str);       // Length of input string
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, args_str_len, &args);
+
     const uint16_t args_bytes_size = args_str_len/2;    // Expected size of input byte array
     uint16_t args_bytes_len;                            // Variable to store the length of the converted byte array
     uint8_t args_bytes[args_bytes_size];                // Byte array to store the values of converted hex string
-    const uint8_t bytes_parse_result = TCMD_extract_hex_array_arg(
-        args_str, 0, args_bytes, args_bytes_size, &args_bytes_len);
+    const uint8_t bytes_parse_result = TCMD_args_get_hex_array(
+        &args, 0, args_bytes, args_bytes_size, &args_bytes_len);
 
     // Check for invalid arguments
     if(bytes_parse_result != 0){
@@ -93,9 +98,12 @@ uint8_t TCMDEXEC_mpi_send_command_get_response_hex(
 /// @param response_output_buf_len The maximum length of the response_output_buf (its size)
 /// @return 0: Success, >0: Failure
 uint8_t TCMDEXEC_mpi_enable_active_mode(const char *args_str, char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Get the file name from the telecommand argument
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(args_str, 0, arg_file_name, sizeof(arg_file_name));
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
     if (parse_file_name_result != 0) {
         snprintf(
             response_output_buf,
@@ -203,3 +211,198 @@ uint8_t TCMDEXEC_mpi_set_transceiver_mode(
     }
     return 0;
 }
+
+/// @brief Parse the `<key> <first> <last> <boot>` args of the MPI range telecommands, and find the
+///     range in the science data file's index.
+/// @param first_arg_index Index of the key arg.
+/// @return 0: Success, >0: Failure (with the response written).
+static uint8_t MPI_tcmd_find_range_from_args(
+    const TCMD_args_t *args, uint8_t first_arg_index, const char data_file_path[],
+    uint32_t *start_offset_out, uint32_t *end_offset_out,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    char arg_key[16];
+    const uint8_t parse_key_result = TCMD_args_get_string(args, first_arg_index, arg_key, sizeof(arg_key));
+    MPI_frame_index_key_enum_t key;
+    if ((parse_key_result == 0) && (strcasecmp(arg_key, "frame") == 0)) {
+        key = MPI_FRAME_INDEX_KEY_FRAME_NUMBER;
+    }
+    else if ((parse_key_result == 0) && (strcasecmp(arg_key, "uptime") == 0)) {
+        key = MPI_FRAME_INDEX_KEY_UPTIME_MS;
+    }
+    else {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing key arg: expected \"frame\" or \"uptime\"."
+        );
+        return 10;
+    }
+
+    uint64_t first = 0;
+    uint64_t last = 0;
+    const uint8_t parse_first_result = TCMD_args_get_uint64(args, first_arg_index + 1, &first);
+    const uint8_t parse_last_result = TCMD_args_get_uint64(args, first_arg_index + 2, &last);
+    if ((parse_first_result != 0) || (parse_last_result != 0) || (first > UINT32_MAX) || (last > UINT32_MAX)) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing first/last args: TCMD_args_get_uint64() -> %d, %d",
+            parse_first_result, parse_last_result
+        );
+        return 11;
+    }
+
+    uint64_t boot_count = 0;
+    const uint8_t parse_boot_count_result = TCMD_args_get_uint64(args, first_arg_index + 3, &boot_count);
+    if ((parse_boot_count_result != 0) || (boot_count > UINT32_MAX)) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing boot arg: TCMD_args_get_uint64() -> %d",
+            parse_boot_count_result
+        );
+        return 13;
+    }
+    if (boot_count == 0) {
+        boot_count = LFS_get_boot_count();
+    }
+
+    const int8_t find_result = MPI_frame_index_find_range(
+        data_file_path, key, (uint32_t)boot_count, (uint32_t)first, (uint32_t)last,
+        start_offset_out, end_offset_out
+    );
+    if (find_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Range not found in the file's index. MPI_frame_index_find_range() -> %d",
+            find_result
+        );
+        return 12;
+    }
+    return 0;
+}
+
+/// @brief Downlink the part of an MPI science data file holding a range of frames or uptimes,
+///     found using the file's index (`<file>.idx`).
+/// @param args_str
+/// - Arg 0: Science data file path
+/// - Arg 1: Key of the range: "frame" (MPI frame number) or "uptime" (OBC uptime, ms)
+/// - Arg 2: First frame number or uptime
+/// - Arg 3: Last frame number or uptime (inclusive)
+/// - Arg 4: Boot the uptimes are from (`LFS_get_boot_count`, in the index's start records), or 0 for
+///     this boot. Ignored for frame numbers.
+/// @param response_output_buf The buffer to write the response to
+/// @param response_output_buf_len The maximum length of the response_output_buf (its size)
+/// @return 0: Success, >0: Failure
+/// @note The range is widened to the indexed frames around it (every `MPI_frame_index_interval_frames`).
+uint8_t TCMDEXEC_mpi_downlink_range(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
+    char arg_file_name[LFS_MAX_PATH_LENGTH];
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
+    if (parse_file_name_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing file name arg: TCMD_args_get_string() -> %d", parse_file_name_result
+        );
+        return 1;
+    }
+
+    uint32_t start_offset;
+    uint32_t end_offset;
+    const uint8_t find_result = MPI_tcmd_find_range_from_args(
+        &args, 1, arg_file_name, &start_offset, &end_offset,
+        response_output_buf, response_output_buf_len
+    );
+    if (find_result != 0) {
+        return find_result;
+    }
+
+    const int32_t downlink_result = COMMS_bulk_file_downlink_start(
+        arg_file_name, start_offset, end_offset - start_offset
+    );
+    if (downlink_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Downlink start failed. COMMS_bulk_file_downlink_start() -> %ld",
+            downlink_result
+        );
+        return 20;
+    }
+
+    snprintf(
+        response_output_buf, response_output_buf_len,
+        "{\"start_offset\":%lu,\"end_offset\":%lu,\"transfer_id\":%u,\"packet_count\":%u}",
+        start_offset, end_offset,
+        COMMS_bulk_file_downlink_transfer_id,
+        COMMS_bulk_file_downlink_total_seq_num
+    );
+    return 0;
+}
+
+/// @brief Copy the part of an MPI science data file holding a range of frames or uptimes to a new
+///     file, found using the file's index (`<file>.idx`).
+/// @param args_str
+/// - Arg 0: Science data file path
+/// - Arg 1: Output file path (overwritten)
+/// - Arg 2: Key of the range: "frame" (MPI frame number) or "uptime" (OBC uptime, ms)
+/// - Arg 3: First frame number or uptime
+/// - Arg 4: Last frame number or uptime (inclusive)
+/// - Arg 5: Boot the uptimes are from (`LFS_get_boot_count`, in the index's start records), or 0 for
+///     this boot. Ignored for frame numbers.
+/// @param response_output_buf The buffer to write the response to
+/// @param response_output_buf_len The maximum length of the response_output_buf (its size)
+/// @return 0: Success, >0: Failure
+uint8_t TCMDEXEC_mpi_extract_range_to_file(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
+    char arg_file_name[LFS_MAX_PATH_LENGTH];
+    char arg_output_file_name[LFS_MAX_PATH_LENGTH];
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
+    const uint8_t parse_output_file_name_result = TCMD_args_get_string(
+        &args, 1, arg_output_file_name, sizeof(arg_output_file_name)
+    );
+    if ((parse_file_name_result != 0) || (parse_output_file_name_result != 0)) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error parsing file name args: TCMD_args_get_string() -> %d, %d",
+            parse_file_name_result, parse_output_file_name_result
+        );
+        return 1;
+    }
+
+    uint32_t start_offset;
+    uint32_t end_offset;
+    const uint8_t find_result = MPI_tcmd_find_range_from_args(
+        &args, 2, arg_file_name, &start_offset, &end_offset,
+        response_output_buf, response_output_buf_len
+    );
+    if (find_result != 0) {
+        return find_result;
+    }
+
+    const int8_t extract_result = MPI_frame_index_extract_range_to_file(
+        arg_file_name, start_offset, end_offset, arg_output_file_name
+    );
+    if (extract_result != 0) {
+        snprintf(
+            response_output_buf, response_output_buf_len,
+            "Error extracting range. MPI_frame_index_extract_range_to_file() -> %d",
+            extract_result
+        );
+        return 20;
+    }
+
+    snprintf(
+        response_output_buf, response_output_buf_len,
+        "{\"start_offset\":%lu,\"end_offset\":%lu,\"bytes\":%lu}",
+        start_offset, end_offset, end_offset - start_offset
+    );
+    return 0;
+}
@@ -21,9 +21,12 @@
 //// @return 0 on success, > 0 on error
 uint8_t TCMDEXEC_stm32_internal_flash_write(const char *args_str, char *response_output_buf, uint16_t response_output_buf_len)
 {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint8_t address_buf[4] = {0};
     uint16_t address_len = 0;
-    const uint8_t parse_address_res = TCMD_extract_hex_array_arg(args_str, 0, address_buf, sizeof(address_buf), &address_len);
+    const uint8_t parse_address_res = TCMD_args_get_hex_array(&args, 0, address_buf, sizeof(address_buf), &address_len);
     if (parse_address_res != 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Error Parsing Arg 0: %u", parse_address_res);
@@ -32,7 +35,7 @@ uint8_t TCMDEXEC_stm32_internal_flash_write(const char *args_str, char *response
 
     uint8_t write_hex_buffer[PAGESIZE] = {0};
     uint16_t write_hex_buffer_len = 0;
-    const uint8_t parse_hex_buffer_res = TCMD_extract_hex_array_arg(args_str, 1, write_hex_buffer, sizeof(write_hex_buffer), &write_hex_buffer_len);
+    const uint8_t parse_hex_buffer_res = TCMD_args_get_hex_array(&args, 1, write_hex_buffer, sizeof(write_hex_buffer), &write_hex_buffer_len);
     if (parse_hex_buffer_res != 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Error Parsing Arg 1: %u", parse_hex_buffer_res);
@@ -61,9 +64,12 @@ uint8_t TCMDEXEC_stm32_internal_flash_write(const char *args_str, char *response
 //// @return 0 on success, > 0 on error
 uint8_t TCMDEXEC_stm32_internal_flash_read(const char *args_str, char *response_output_buf, uint16_t response_output_buf_len)
 {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint8_t address_buf[4] = {0};
     uint16_t address_len = 0;
-    const uint8_t parse_address_res = TCMD_extract_hex_array_arg(args_str, 0, address_buf, sizeof(address_buf), &address_len);
+    const uint8_t parse_address_res = TCMD_args_get_hex_array(&args, 0, address_buf, sizeof(address_buf), &address_len);
 
     if (parse_address_res != 0)
     {
@@ -72,7 +78,7 @@ uint8_t TCMDEXEC_stm32_internal_flash_read(const char *args_str, char *response_
     }
 
     uint64_t number_of_bytes_to_read = 0;
-    const uint8_t parse_res = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &number_of_bytes_to_read);
+    const uint8_t parse_res = TCMD_args_get_uint64(&args, 1, &number_of_bytes_to_read);
     if (parse_res != 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Error Parsing Arg 1: %u", parse_res);
@@ -107,8 +113,11 @@ uint8_t TCMDEXEC_stm32_internal_flash_read(const char *args_str, char *response_
 //// @return 0 on success, > 0 on error
 uint8_t TCMDEXEC_stm32_internal_flash_page_erase(const char *args_str, char *response_output_buf, uint16_t response_output_buf_len)
 {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t flash_bank_to_erase = 0;
-    const uint8_t flash_bank_to_erase_parse_res = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &flash_bank_to_erase);
+    const uint8_t flash_bank_to_erase_parse_res = TCMD_args_get_uint64(&args, 0, &flash_bank_to_erase);
     if (flash_bank_to_erase_parse_res != 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Error Parsing arg 0: %u", flash_bank_to_erase_parse_res);
@@ -121,7 +130,7 @@ uint8_t TCMDEXEC_stm32_internal_flash_page_erase(const char *args_str, char *res
     }
     uint64_t start_page_erase = 0;
 
-    const uint8_t start_page_erase_parse_res = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &start_page_erase);
+    const uint8_t start_page_erase_parse_res = TCMD_args_get_uint64(&args, 1, &start_page_erase);
     if (start_page_erase_parse_res != 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Error Parsing arg 1: %u", start_page_erase_parse_res);
@@ -129,7 +138,7 @@ uint8_t TCMDEXEC_stm32_internal_flash_page_erase(const char *args_str, char *res
     }
 
     uint64_t number_of_pages_to_erase = 0;
-    const uint8_t number_of_pages_to_erase_parse_res = TCMD_extract_uint64_arg(args_str, strlen(args_str), 2, &number_of_pages_to_erase);
+    const uint8_t number_of_pages_to_erase_parse_res = TCMD_args_get_uint64(&args, 2, &number_of_pages_to_erase);
     if (number_of_pages_to_erase_parse_res != 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Error Parsing arg 2: %u", number_of_pages_to_erase_parse_res);
@@ -152,8 +161,11 @@ uint8_t TCMDEXEC_stm32_internal_flash_page_erase(const char *args_str, char *res
 /// @return 0 on success, > 0 on error
 uint8_t TCMDEXEC_stm32_internal_flash_bank_erase(const char *args_str, char *response_output_buf, uint16_t response_output_buf_len)
 {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t flash_bank_to_erase = 0;
-    const uint8_t flash_bank_to_erase_parse_res = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &flash_bank_to_erase);
+    const uint8_t flash_bank_to_erase_parse_res = TCMD_args_get_uint64(&args, 0, &flash_bank_to_erase);
     if (flash_bank_to_erase_parse_res != 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Error Parsing arg 0: %u", flash_bank_to_erase_parse_res);
@@ -217,8 +229,11 @@ uint8_t TCMDEXEC_stm32_internal_flash_get_option_bytes(const char *args_str, cha
 /// @return 0 on success, > 0 otherwise
 uint8_t TCMDEXEC_stm32_internal_flash_set_active_flash_bank(const char *args_str, char *response_output_buf, uint16_t response_output_buf_len)
 {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t desired_active_flash_bank = 0;
-    const uint8_t arg_res = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &desired_active_flash_bank);
+    const uint8_t arg_res = TCMD_args_get_uint64(&args, 0, &desired_active_flash_bank);
     if (arg_res != 0)
     {
         snprintf(response_output_buf, response_output_buf_len, "Error Parsing Arg 0: %u", arg_res);
@@ -260,8 +275,11 @@ uint8_t TCMDEXEC_stm32_internal_flash_calculate_sha256(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t address_u64 = 0;
-    const uint8_t parse_address_res = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &address_u64);
+    const uint8_t parse_address_res = TCMD_args_get_uint64(&args, 0, &address_u64);
     if (parse_address_res != 0) {
         snprintf(response_output_buf, response_output_buf_len,
                  "Error Parsing Arg 0: %u", parse_address_res);
@@ -269,7 +287,7 @@ uint8_t TCMDEXEC_stm32_internal_flash_calculate_sha256(
     }
 
     uint64_t length_u64 = 0;
-    const uint8_t parse_length_res = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &length_u64);
+    const uint8_t parse_length_res = TCMD_args_get_uint64(&args, 1, &length_u64);
     if (parse_length_res != 0) {
         snprintf(response_output_buf, response_output_buf_len,
                  "Error Parsing Arg 1: %u", parse_length_res);
@@ -333,9 +351,11 @@ uint8_t TCMDEXEC_stm32_internal_flash_calculate_sha256(
 uint8_t TCMDEXEC_stm32_internal_flash_write_file_to_internal_flash(const char *args_str, char *response_output_buf, uint16_t response_output_buf_len)
 {
     const uint32_t args_str_len = strlen(args_str);
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, args_str_len, &args);
 
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_file_name_result = TCMD_extract_string_arg(args_str, 0, arg_file_name, sizeof(arg_file_name));
+    const uint8_t parse_file_name_result = TCMD_args_get_string(&args, 0, arg_file_name, sizeof(arg_file_name));
     if (parse_file_name_result != 0) {
         snprintf(
             response_output_buf,
@@ -346,7 +366,7 @@ uint8_t TCMDEXEC_stm32_internal_flash_write_file_to_internal_flash(const char *a
 
     // Get length of data to read
     uint64_t read_length = 0;
-    const uint8_t parse_length_result = TCMD_extract_uint64_arg(args_str, args_str_len, 1, &read_length);
+    const uint8_t parse_length_result = TCMD_args_get_uint64(&args, 1, &read_length);
     if (parse_length_result != 0) {
         snprintf(
             response_output_buf,
@@ -367,7 +387,7 @@ uint8_t TCMDEXEC_stm32_internal_flash_write_file_to_internal_flash(const char *a
     }
     // Get offset to read from in file
     uint64_t read_offset = 0;
-    const uint8_t parse_offset_result = TCMD_extract_uint64_arg(args_str, args_str_len, 2, &read_offset);
+    const uint8_t parse_offset_result = TCMD_args_get_uint64(&args, 2, &read_offset);
     if (parse_offset_result != 0) {
         snprintf(
             response_output_buf,
@@ -378,7 +398,7 @@ uint8_t TCMDEXEC_stm32_internal_flash_write_file_to_internal_flash(const char *a
 
     // Get address to write to
     uint64_t write_address = 0;
-    const uint8_t parse_address_result = TCMD_extract_uint64_arg(args_str, args_str_len, 3, &write_address);
+    const uint8_t parse_address_result = TCMD_args_get_uint64(&args, 3, &write_address);
     
     if (parse_address_result != 0) {
         snprintf(
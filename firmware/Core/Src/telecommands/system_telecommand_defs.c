@@ -14,6 +14,7 @@
 #include "system/system_temperature.h"
 #include "mpi/mpi_command_handling.h"
 #include "mpi/mpi_types.h"
+#include "mpi/mpi_science_ring.h"
 #include "uart_handler/uart_handler.h"
 #include "rtos_tasks/rtos_bootup_operation_fsm_task.h"
 #include "gnss_receiver/gnss_internal_drivers.h"
@@ -22,6 +23,7 @@
 #include "telecommands/system_telecommand_defs.h"
 #include "telecommand_exec/telecommand_definitions.h"
 #include "telecommand_exec/telecommand_executor.h"
+#include "telecommand_exec/telecommand_response_store.h"
 #include "telecommand_exec/telecommand_args_helpers.h"
 
 #include <stdio.h>
@@ -231,6 +233,9 @@ uint8_t TCMDEXEC_reboot(
         "Rebooting by telecommand request."
     );
 
+    // Write out the queued log messages; the logger task won't run again before the reset.
+    LOG_process_queued_messages(UINT32_MAX);
+
     // If logging to file is enabled, flush the current log file.
     // Not an emergency, but the "emergency" one is good for a pending reboot.
     LOG_emergency_sync_current_log_file();
@@ -238,6 +243,8 @@ uint8_t TCMDEXEC_reboot(
     // Delay to flush log sinks if enabled.
     HAL_Delay(500);
 
+    // Commit batched `@resp_fname` responses.
+    TCMD_resp_store_close_all();
     LFS_ensure_unmounted();
 
     // Delay to flush UART buffer.
@@ -370,13 +377,16 @@ uint8_t TCMDEXEC_exec_blob_from_fs(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     char arg_file_name[LFS_MAX_PATH_LENGTH];
-    const uint8_t parse_dir_name_result = TCMD_extract_string_arg(
-        args_str, 0, arg_file_name, sizeof(arg_file_name)
+    const uint8_t parse_dir_name_result = TCMD_args_get_string(
+        &args, 0, arg_file_name, sizeof(arg_file_name)
     );
     uint64_t arg_where_to_load;
-    const uint8_t parse_int_arg_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 1, &arg_where_to_load
+    const uint8_t parse_int_arg_result = TCMD_args_get_uint64(
+        &args, 1, &arg_where_to_load
     );
     if ((parse_dir_name_result != 0) || (parse_int_arg_result != 0) || (arg_where_to_load > 2)) {
         snprintf(
@@ -418,12 +428,14 @@ uint8_t TCMDEXEC_exec_blob_from_fs(
         }
     }
     else if (arg_where_to_load == 1) {
-        blob_buffer = (uint8_t*)MPI_science_buffer_one;
-        blob_buffer_size = MPI_science_buffer_len;
+        // First half of the MPI science ring's buffers.
+        blob_buffer = MPI_science_ring_storage[0];
+        blob_buffer_size = sizeof(MPI_science_ring_storage) / 2;
     }
     else if (arg_where_to_load == 2) {
-        blob_buffer = (uint8_t*)MPI_science_buffer_two;
-        blob_buffer_size = MPI_science_buffer_len;
+        // Second half of the MPI science ring's buffers.
+        blob_buffer = MPI_science_ring_storage[MPI_SCIENCE_RING_MAX_BUFFER_COUNT / 2];
+        blob_buffer_size = sizeof(MPI_science_ring_storage) / 2;
     }
     else {
         snprintf(
@@ -17,6 +17,7 @@
 #include "adcs_drivers/adcs_command_ids.h"
 #include "adcs_drivers/adcs_struct_packers.h"
 #include "adcs_drivers/adcs_types_to_json.h"
+#include "comms_drivers/ax100_tx.h"
 
 /// @brief Telecommand: execute a generic command on the ADCS
 /// @param args_str 
@@ -26,10 +27,12 @@
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_generic_command(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
-    
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse command ID argument: first into uint64_t, then convert to correct form for input
     uint64_t command_id;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &command_id);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 0, &command_id);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -49,7 +52,7 @@ uint8_t TCMDEXEC_adcs_generic_command(const char *args_str,
     // parse hex array arguments
     uint8_t hex_data_array[504]; 
     uint16_t data_length;
-    extract_status = TCMD_extract_hex_array_arg(args_str, 1, &hex_data_array[0], 504, &data_length);
+    extract_status = TCMD_args_get_hex_array(&args, 1, &hex_data_array[0], 504, &data_length);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -73,10 +76,12 @@ uint8_t TCMDEXEC_adcs_generic_command(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_generic_bootloader_command(const char *args_str, 
                         char *response_output_buf, uint16_t response_output_buf_len) {
-    
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse command ID argument: first into uint64_t, then convert to correct form for input
     uint64_t command_id;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &command_id);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 0, &command_id);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -96,7 +101,7 @@ uint8_t TCMDEXEC_adcs_generic_bootloader_command(const char *args_str,
     // parse hex array arguments
     uint8_t hex_data_array[504]; 
     uint16_t data_length;
-    extract_status = TCMD_extract_hex_array_arg(args_str, 1, &hex_data_array[0], 504, &data_length);
+    extract_status = TCMD_args_get_hex_array(&args, 1, &hex_data_array[0], 504, &data_length);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -107,6 +112,7 @@ uint8_t TCMDEXEC_adcs_generic_bootloader_command(const char *args_str,
     if (status == ADCS_ERROR_FLAG_WRONG_LENGTH && data_length == 1) {
         // for zero-parameter commands, do this instead
         uint8_t data_send[1] = {command_id}; 
+        AX100_wait_for_tx_idle(); // I2C1 is shared with the AX100.
         status = HAL_I2C_Master_Transmit(ADCS_i2c_HANDLE, ADCS_i2c_ADDRESS << 1, data_send, 1, ADCS_HAL_TIMEOUT);
             // The bootloader doesn't support checksum, and this is a zero-parameter command, so HAL_I2C_Mem_Write can't be used (zero length message).
     }
@@ -121,10 +127,12 @@ uint8_t TCMDEXEC_adcs_generic_bootloader_command(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_generic_telemetry_request(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
 
     // parse telemetry request ID argument: first into uint64_t
     uint64_t telemetry_request_id;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &telemetry_request_id);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 0, &telemetry_request_id);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed in position 0 (err %d)", extract_status);
@@ -143,7 +151,7 @@ uint8_t TCMDEXEC_adcs_generic_telemetry_request(const char *args_str,
 
     // parse data length argument: first into uint64_t
     uint64_t data_length;
-    extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &data_length);
+    extract_status = TCMD_args_get_uint64(&args, 1, &data_length);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed in position 1 (err %d)", extract_status);
@@ -232,12 +240,15 @@ uint8_t TCMDEXEC_adcs_ack(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_wheel_speed(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse arguments: first into int64_t, then convert to correct form for input
     const uint8_t num_args = 3;
     int64_t arguments[num_args]; 
     int16_t args_16[num_args];
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_int64_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_int64(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -348,8 +359,11 @@ uint8_t TCMDEXEC_adcs_communication_status(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_deploy_magnetometer(const char *args_str,
                                           char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t timeout;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &timeout);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 0, &timeout);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -365,8 +379,11 @@ uint8_t TCMDEXEC_adcs_deploy_magnetometer(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_run_mode(const char *args_str,
                                    char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t run_mode;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &run_mode);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 0, &run_mode);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -410,11 +427,14 @@ uint8_t TCMDEXEC_adcs_clear_errors(const char *args_str,
 ///    ADCS_CONTROL_MODE_TARGET_TRACKING_YAW_ONLY_WHEEL = 15
 uint8_t TCMDEXEC_adcs_attitude_control_mode(const char *args_str,
                                             char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse arguments into uint64_t
     const uint8_t num_args = 2;
     uint64_t arguments[num_args]; 
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_uint64(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -441,8 +461,11 @@ uint8_t TCMDEXEC_adcs_attitude_control_mode(const char *args_str,
 ///    ADCS_ESTIMATION_MODE_USER_CODED_ESTIMATION_MODE = 7
 uint8_t TCMDEXEC_adcs_attitude_estimation_mode(const char *args_str,
                                                char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t estimation_mode;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &estimation_mode);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 0, &estimation_mode);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -468,8 +491,11 @@ uint8_t TCMDEXEC_adcs_run_once(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_magnetometer_mode(const char *args_str,
                                             char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t mode;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &mode);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 0, &mode);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -487,11 +513,14 @@ uint8_t TCMDEXEC_adcs_set_magnetometer_mode(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_magnetorquer_output(const char *args_str,
                                               char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
      // parse arguments into doubles
     const uint8_t num_args = 3;
     double arguments[num_args]; 
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_double_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_double(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -609,13 +638,15 @@ uint8_t TCMDEXEC_adcs_get_power_control(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_power_control(const char *args_str,
                                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
 
     // parse arguments: first into uint64_t, then convert to correct form for input
     const uint8_t num_args = 10;
     uint64_t arguments[num_args]; 
     uint8_t args_8[num_args];
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_uint64(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -634,9 +665,11 @@ uint8_t TCMDEXEC_adcs_set_power_control(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_enter_low_power_mode(const char *args_str,
                                         char *response_output_buf, uint16_t response_output_buf_len) {
-    
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t mode;
-    const uint8_t status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &mode);
+    const uint8_t status = TCMD_args_get_uint64(&args, 0, &mode);
     if (status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", status);
@@ -755,12 +788,14 @@ uint8_t TCMDEXEC_adcs_track_sun(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_magnetometer_config(const char *args_str,
                                               char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
 
     // parse arguments into doubles
     const uint8_t num_args = 15;
     double arguments[num_args]; 
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_double_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_double(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -791,10 +826,13 @@ uint8_t TCMDEXEC_adcs_bootloader_clear_errors(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_unix_time_save_mode(const char *args_str,
                                               char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t bools[3];
     uint64_t uint_arg;
     for (uint8_t i = 0; i < 3; i++) {
-        uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i, &bools[i]);
+        uint8_t extract_status = TCMD_args_get_uint64(&args, i, &bools[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -802,7 +840,7 @@ uint8_t TCMDEXEC_adcs_set_unix_time_save_mode(const char *args_str,
         }
     }
     
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 3, &uint_arg);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 3, &uint_arg);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed in position 3 (err %d)", extract_status);
@@ -853,11 +891,14 @@ uint8_t TCMDEXEC_adcs_get_unix_time_save_mode(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_sgp4_orbit_params(const char *args_str,
                                             char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse arguments into doubles
     const uint8_t num_args = 8;
     double arguments[num_args]; 
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_double_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_double(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -1104,11 +1145,14 @@ uint8_t TCMDEXEC_adcs_get_commanded_attitude_angles(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_commanded_attitude_angles(const char *args_str,
                                                     char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse arguments into doubles
     const uint8_t num_args = 3;
     double arguments[num_args]; 
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_double_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_double(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -1142,6 +1186,9 @@ uint8_t TCMDEXEC_adcs_set_commanded_attitude_angles(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_estimation_params(const char *args_str,
                                             char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // the first seven are floats (0-6)
     // the next six are bools (0-5)
     // after that there are two enums (6-7)
@@ -1154,7 +1201,7 @@ uint8_t TCMDEXEC_adcs_set_estimation_params(const char *args_str,
     double double_type_arguments[num_args]; 
     float float_args[num_args];
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_double_arg(args_str, strlen(args_str), i, &double_type_arguments[i]);
+        uint8_t extract_status = TCMD_args_get_double(&args, i, &double_type_arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -1170,7 +1217,7 @@ uint8_t TCMDEXEC_adcs_set_estimation_params(const char *args_str,
     uint8_t uint8_arg;
 
     for (uint8_t i = 0; i < new_num_args; i++) {
-        uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i + 7, &uint_type_arguments[i]);
+        uint8_t extract_status = TCMD_args_get_uint64(&args, i + 7, &uint_type_arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i + 7, extract_status);
@@ -1244,6 +1291,9 @@ uint8_t TCMDEXEC_adcs_get_estimation_params(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_augmented_sgp4_params(const char *args_str,
                                        char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // seven doubles, then enum, then two doubles, uint8, two doubles, uint8, two doubles, uint16
     //  0-6             7           8-9             10      11-12       13      14-15       16
     uint8_t total_doubles = 14;
@@ -1259,7 +1309,7 @@ uint8_t TCMDEXEC_adcs_set_augmented_sgp4_params(const char *args_str,
 
     for (uint8_t i = 0; i < num_args; i++) {
         if (i < 7 || (i == 8 || i == 9) || (i == 11 || i == 12) || (i == 14 || i == 15)) {
-            uint8_t extract_status = TCMD_extract_double_arg(args_str, strlen(args_str), i, &doubles_params[double_counter]);
+            uint8_t extract_status = TCMD_args_get_double(&args, i, &doubles_params[double_counter]);
             if (extract_status != 0) {
                 snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -1268,7 +1318,7 @@ uint8_t TCMDEXEC_adcs_set_augmented_sgp4_params(const char *args_str,
             double_counter++;
         }
         else if (i == 7 || i == 10 || i == 13 || i == 16) {
-            uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i, &uint_params[uint_counter]);
+            uint8_t extract_status = TCMD_args_get_uint64(&args, i, &uint_params[uint_counter]);
             if (extract_status != 0) {
                 snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -1327,11 +1377,14 @@ uint8_t TCMDEXEC_adcs_get_augmented_sgp4_params(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_tracking_controller_target_reference(const char *args_str,
                                                                 char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse arguments into doubles
     const uint8_t num_args = 3;
     double arguments[num_args]; 
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_double_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_double(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -1383,12 +1436,14 @@ uint8_t TCMDEXEC_adcs_get_tracking_controller_target_reference(const char *args_
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_rate_gyro_config(const char *args_str,
                                            char *response_output_buf, uint16_t response_output_buf_len) {
-    
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse axis select arguments into uint64s
     uint8_t num_axis_args = 3;
     uint64_t axis_arguments[num_axis_args]; 
     for (uint8_t i = 0; i < num_axis_args; i++) {
-        uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i, &axis_arguments[i]);
+        uint8_t extract_status = TCMD_args_get_uint64(&args, i, &axis_arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -1400,7 +1455,7 @@ uint8_t TCMDEXEC_adcs_set_rate_gyro_config(const char *args_str,
     uint8_t num_offset_args = 3;
     double offset_arguments[num_offset_args]; 
     for (uint8_t i = 0; i < num_offset_args; i++) {
-        uint8_t extract_status = TCMD_extract_double_arg(args_str, strlen(args_str), i + 3, &offset_arguments[i]);
+        uint8_t extract_status = TCMD_args_get_double(&args, i + 3, &offset_arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i + 3, extract_status);
@@ -1409,7 +1464,7 @@ uint8_t TCMDEXEC_adcs_set_rate_gyro_config(const char *args_str,
     }
 
     uint64_t rate_sensor_mult;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 6, &rate_sensor_mult);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 6, &rate_sensor_mult);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed in position 6 (err %d)", extract_status);
@@ -1860,11 +1915,14 @@ uint8_t TCMDEXEC_adcs_measurements(const char *args_str,
 /// @note Despite its name, this telecommand does not download any files nor write to LittleFS.
 uint8_t TCMDEXEC_adcs_download_index_file(const char *args_str,
                                    char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t index_offset;
-    const uint8_t arg0_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &index_offset);
+    const uint8_t arg0_status = TCMD_args_get_uint64(&args, 0, &index_offset);
 
     uint64_t num_to_read;
-    const uint8_t arg1_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &num_to_read);
+    const uint8_t arg1_status = TCMD_args_get_uint64(&args, 1, &num_to_read);
 
     if (arg0_status != 0 || arg1_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -1898,9 +1956,12 @@ uint8_t TCMDEXEC_adcs_download_sd_file_by_index(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse file index argument
     uint64_t file_index;
-    TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &file_index);
+    TCMD_args_get_uint64(&args, 0, &file_index);
 
     const int16_t status = ADCS_save_sd_file_to_lfs_by_index(false, file_index, false, 0);
 
@@ -1922,9 +1983,12 @@ uint8_t TCMDEXEC_adcs_download_sd_file_by_checksum(
     const char *args_str, 
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint8_t checksum[2];
     uint16_t checksum_length;
-    TCMD_extract_hex_array_arg(args_str, 0, &checksum[0], 2, &checksum_length);
+    TCMD_args_get_hex_array(&args, 0, &checksum[0], 2, &checksum_length);
 
     if (checksum_length != 2) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -2001,12 +2065,15 @@ uint8_t TCMDEXEC_adcs_get_current_state_1(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_save_image_to_sd(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse arguments: first into int64_t, then convert to correct form for input
     const uint8_t num_args = 2;
     uint64_t arguments[num_args]; 
     uint8_t args_8[num_args];
     for (uint8_t i = 0; i < num_args; i++) {
-        uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_uint64(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -2066,9 +2133,11 @@ uint8_t TCMDEXEC_adcs_get_current_unix_time(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_set_sd_log_config(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
-    
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t which_log;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &which_log);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 0, &which_log);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -2078,7 +2147,7 @@ uint8_t TCMDEXEC_adcs_set_sd_log_config(const char *args_str,
     // parse hex array arguments
     uint8_t hex_data_array[ADCS_SD_LOG_BITFIELD_LENGTH_BYTES]; 
     uint16_t data_length;
-    extract_status = TCMD_extract_hex_array_arg(args_str, 1, &hex_data_array[0], data_length, &data_length);
+    extract_status = TCMD_args_get_hex_array(&args, 1, &hex_data_array[0], data_length, &data_length);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -2088,7 +2157,7 @@ uint8_t TCMDEXEC_adcs_set_sd_log_config(const char *args_str,
     const uint8_t *data_pointer[1] = {hex_data_array};
 
     uint64_t log_period;
-    extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 2, &log_period);
+    extract_status = TCMD_args_get_uint64(&args, 2, &log_period);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed in position 2 (err %d)", extract_status);
@@ -2096,7 +2165,7 @@ uint8_t TCMDEXEC_adcs_set_sd_log_config(const char *args_str,
     }
 
     uint64_t which_sd;
-    extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 3, &which_sd);
+    extract_status = TCMD_args_get_uint64(&args, 3, &which_sd);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed in position 3 (err %d)", extract_status);
@@ -2114,9 +2183,11 @@ uint8_t TCMDEXEC_adcs_set_sd_log_config(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_get_sd_log_config(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
-    
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t which_log;
-    uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &which_log);
+    uint8_t extract_status = TCMD_args_get_uint64(&args, 0, &which_log);
     if (extract_status != 0) {
         snprintf(response_output_buf, response_output_buf_len,
             "Telecommand argument extraction failed (err %d)", extract_status);
@@ -2154,9 +2225,12 @@ uint8_t TCMDEXEC_adcs_set_commissioning_modes(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t arguments[2];
     for (uint8_t i = 0; i < 2; i++) {
-        const uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i, &(arguments[i]));
+        const uint8_t extract_status = TCMD_args_get_uint64(&args, i, &(arguments[i]));
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed (err %d)", extract_status);
@@ -2731,10 +2805,13 @@ uint8_t TCMDEXEC_adcs_set_commissioning_modes(
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_request_commissioning_telemetry(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse arguments: first into int64_t, then convert to correct form for input
     uint64_t arguments[3];
     for (uint8_t i = 0; i < 3; i++) {
-        uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_uint64(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -2939,10 +3016,12 @@ uint8_t TCMDEXEC_adcs_format_sd(const char *args_str,
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_erase_sd_file_by_index(const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len) {
-    
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse file index argument
     uint64_t file_index;
-    TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &file_index);
+    TCMD_args_get_uint64(&args, 0, &file_index);
 
     const int16_t status = ADCS_erase_sd_file_by_index(file_index);
 
@@ -2957,10 +3036,13 @@ uint8_t TCMDEXEC_adcs_erase_sd_file_by_checksum(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse checksum
     uint8_t checksum[2];
     uint16_t checksum_length;
-    TCMD_extract_hex_array_arg(args_str, 0, &checksum[0], 2, &checksum_length);
+    TCMD_args_get_hex_array(&args, 0, &checksum[0], 2, &checksum_length);
 
     if (checksum_length != 2) {
         snprintf(response_output_buf, response_output_buf_len,
@@ -3018,11 +3100,13 @@ uint8_t TCMDEXEC_adcs_exit_bootloader(
 /// @return 0 on success, >0 on error
 uint8_t TCMDEXEC_adcs_convert_to_jpg_by_index(const char *args_str, 
                         char *response_output_buf, uint16_t response_output_buf_len) {
-    
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse file index argument
     uint64_t arguments[3];
     for (uint8_t i = 0; i < 3; i++) {
-        uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_uint64(&args, i, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i, extract_status);
@@ -3070,10 +3154,13 @@ uint8_t TCMDEXEC_adcs_convert_to_jpg_by_checksum(
     const char *args_str, 
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // parse checksum argument
     uint8_t checksum[2];
     uint16_t checksum_length;
-    TCMD_extract_hex_array_arg(args_str, 0, &checksum[0], 2, &checksum_length);
+    TCMD_args_get_hex_array(&args, 0, &checksum[0], 2, &checksum_length);
     if (checksum_length != 2) {
         return 5;
     }
@@ -3082,7 +3169,7 @@ uint8_t TCMDEXEC_adcs_convert_to_jpg_by_checksum(
     uint64_t arguments[2];
     // parse integer arguments
     for (uint8_t i = 0; i < 2; i++) {
-        uint8_t extract_status = TCMD_extract_uint64_arg(args_str, strlen(args_str), i + 1, &arguments[i]);
+        uint8_t extract_status = TCMD_args_get_uint64(&args, i + 1, &arguments[i]);
         if (extract_status != 0) {
             snprintf(response_output_buf, response_output_buf_len,
                 "Telecommand argument extraction failed in position %d (err %d)", i + 1, extract_status);
@@ -44,6 +44,8 @@
 #include <inttypes.h>
 #include <time.h>
 
+// After adding, removing, renaming, or reordering telecommands, regenerate the name lookup index
+// (`telecommand_name_index.c`) with: `python firmware_checks/_04_check_tcmd_name_index.py --fix`
 // extern
 const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
     {
@@ -236,6 +238,12 @@ const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
         .number_of_args = 1,
         .readiness_level = TCMD_READINESS_LEVEL_FLIGHT_TESTING, // Can cause crash via Watchdog reset.
     },
+    {
+        .tcmd_name = "crypto_benchmark_sha256_json",
+        .tcmd_func = TCMDEXEC_crypto_benchmark_sha256_json,
+        .number_of_args = 1,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
 
     // ****************** END SECTION: testing_telecommand_defs ******************
 
@@ -315,6 +323,12 @@ const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
         .number_of_args = 3,
         .readiness_level = TCMD_READINESS_LEVEL_FLIGHT_TESTING,
     },
+    {
+        .tcmd_name = "flash_benchmark_sequential_read",
+        .tcmd_func = TCMDEXEC_flash_benchmark_sequential_read,
+        .number_of_args = 3,
+        .readiness_level = TCMD_READINESS_LEVEL_FLIGHT_TESTING,
+    },
     {
         .tcmd_name = "flash_reset",
         .tcmd_func = TCMDEXEC_flash_reset,
@@ -327,6 +341,12 @@ const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
         .number_of_args = 1,
         .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
     },
+    {
+        .tcmd_name = "flash_get_busy_time_stats_json",
+        .tcmd_func = TCMDEXEC_flash_get_busy_time_stats_json,
+        .number_of_args = 1,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
     {
         .tcmd_name = "flash_force_corrupt_filesystem",
         .tcmd_func = TCMDEXEC_flash_force_corrupt_filesystem,
@@ -366,6 +386,12 @@ const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
         .number_of_args = 3,
         .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
     },
+    {
+        .tcmd_name = "fs_list_directory_page_json",
+        .tcmd_func = TCMDEXEC_fs_list_directory_page_json,
+        .number_of_args = 3,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
     {
         .tcmd_name = "fs_make_directory",
         .tcmd_func = TCMDEXEC_fs_make_directory,
@@ -438,6 +464,12 @@ const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
         .number_of_args = 0,
         .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
     },
+    {
+        .tcmd_name = "fs_get_page_cache_stats_json",
+        .tcmd_func = TCMDEXEC_fs_get_page_cache_stats_json,
+        .number_of_args = 1,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
     {
         .tcmd_name = "fs_compress_file_with_heatshrink",
         .tcmd_func = TCMDEXEC_fs_compress_file_with_heatshrink,
@@ -1239,6 +1271,19 @@ const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
         .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION
     },
 
+    {
+        .tcmd_name = "agenda_get_rx_latency_json",
+        .tcmd_func = TCMDEXEC_agenda_get_rx_latency_json,
+        .number_of_args = 0,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
+    {
+        .tcmd_name = "agenda_flush_response_files",
+        .tcmd_func = TCMDEXEC_agenda_flush_response_files,
+        .number_of_args = 0,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
+
     // ****************** END SECTION: agenda_telecommand_defs ******************
 
     // ****************** START: MPI_telecommand_definitions ******************
@@ -1272,6 +1317,18 @@ const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
         .number_of_args = 0,
         .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
     },
+    {
+        .tcmd_name = "mpi_downlink_range",
+        .tcmd_func = TCMDEXEC_mpi_downlink_range,
+        .number_of_args = 5,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
+    {
+        .tcmd_name = "mpi_extract_range_to_file",
+        .tcmd_func = TCMDEXEC_mpi_extract_range_to_file,
+        .number_of_args = 6,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
     // ****************** END: MPI_telecommand_definitions ********************
     // ****************** START SECTION: stm32_internal_flash_telecommand_defs ******************
 
@@ -1453,6 +1510,12 @@ const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
         .number_of_args = 3,
         .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
     },
+    {
+        .tcmd_name = "comms_bulk_file_downlink_start_compressed",
+        .tcmd_func = TCMDEXEC_comms_bulk_file_downlink_start_compressed,
+        .number_of_args = 5,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
     {
         .tcmd_name = "comms_bulk_file_downlink_pause",
         .tcmd_func = TCMDEXEC_comms_bulk_file_downlink_pause,
@@ -1465,6 +1528,18 @@ const TCMD_TelecommandDefinition_t TCMD_telecommand_definitions[] = {
         .number_of_args = 0,
         .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
     },
+    {
+        .tcmd_name = "comms_bulk_file_downlink_nack",
+        .tcmd_func = TCMDEXEC_comms_bulk_file_downlink_nack,
+        .number_of_args = 3,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
+    {
+        .tcmd_name = "comms_get_tx_pacing_stats_json",
+        .tcmd_func = TCMDEXEC_comms_get_tx_pacing_stats_json,
+        .number_of_args = 0,
+        .readiness_level = TCMD_READINESS_LEVEL_FOR_OPERATION,
+    },
     {
         .tcmd_name = "comms_bulk_uplink_open_file",
         .tcmd_func = TCMDEXEC_comms_bulk_uplink_open_file,
@@ -0,0 +1,266 @@
+// GENERATED FILE - DO NOT EDIT.
+// Regenerate with: `python firmware_checks/_04_check_tcmd_name_index.py --fix`
+
+#include "telecommand_exec/telecommand_definitions.h"
+
+// extern
+const int16_t TCMD_telecommand_name_sorted_idx_count = 254;
+
+/// @brief Indices into `TCMD_telecommand_definitions`, sorted by `tcmd_name` (like `strcmp`).
+// extern
+const uint8_t TCMD_telecommand_name_sorted_idx[] = {
+    73, // adcs_ack
+    137, // adcs_acp_execution_state
+    82, // adcs_attitude_control_mode
+    83, // adcs_attitude_estimation_mode
+    95, // adcs_bootloader_clear_errors
+    81, // adcs_clear_errors
+    121, // adcs_commanded_wheel_speed
+    78, // adcs_communication_status
+    152, // adcs_convert_to_jpg_by_checksum
+    151, // adcs_convert_to_jpg_by_index
+    130, // adcs_cubecontrol_current
+    79, // adcs_deploy_magnetometer
+    146, // adcs_download_index_file
+    133, // adcs_download_sd_file_by_checksum
+    132, // adcs_download_sd_file_by_index
+    92, // adcs_enter_low_power_mode
+    149, // adcs_erase_sd_file_by_checksum
+    148, // adcs_erase_sd_file_by_index
+    88, // adcs_estimate_angular_rates
+    105, // adcs_estimate_fine_angular_rates
+    117, // adcs_estimated_attitude_angles
+    124, // adcs_estimated_gyro_bias
+    125, // adcs_estimation_innovation_vector
+    150, // adcs_exit_bootloader
+    119, // adcs_fine_sun_vector
+    145, // adcs_format_sd
+    135, // adcs_generic_bootloader_command
+    134, // adcs_generic_command
+    136, // adcs_generic_telemetry_request
+    112, // adcs_get_augmented_sgp4_params
+    107, // adcs_get_commanded_attitude_angles
+    154, // adcs_get_cubesense_currents
+    138, // adcs_get_current_state_1
+    142, // adcs_get_current_unix_time
+    110, // adcs_get_estimation_params
+    89, // adcs_get_llh_position
+    106, // adcs_get_magnetometer_config
+    103, // adcs_get_magnetorquer_command
+    155, // adcs_get_misc_currents
+    90, // adcs_get_power_control
+    116, // adcs_get_rate_gyro_config
+    104, // adcs_get_raw_magnetometer_values
+    144, // adcs_get_sd_log_config
+    99, // adcs_get_sgp4_orbit_params
+    114, // adcs_get_tracking_controller_target_reference
+    97, // adcs_get_unix_time_save_mode
+    153, // adcs_get_wheel_currents
+    102, // adcs_get_wheel_speed
+    76, // adcs_identification
+    122, // adcs_igrf_magnetic_field_vector
+    118, // adcs_magnetic_field_vector
+    131, // adcs_measurements
+    120, // adcs_nadir_vector
+    77, // adcs_program_status
+    123, // adcs_quaternion_error_vector
+    101, // adcs_rate_sensor_rates
+    126, // adcs_raw_cam1_sensor
+    127, // adcs_raw_cam2_sensor
+    128, // adcs_raw_coarse_sun_sensor_1_to_6
+    129, // adcs_raw_coarse_sun_sensor_7_to_10
+    140, // adcs_request_commissioning_telemetry
+    75, // adcs_reset
+    84, // adcs_run_once
+    87, // adcs_save_config
+    139, // adcs_save_image_to_sd
+    100, // adcs_save_orbit_params
+    111, // adcs_set_augmented_sgp4_params
+    108, // adcs_set_commanded_attitude_angles
+    147, // adcs_set_commissioning_modes
+    109, // adcs_set_estimation_params
+    94, // adcs_set_magnetometer_config
+    85, // adcs_set_magnetometer_mode
+    86, // adcs_set_magnetorquer_output
+    91, // adcs_set_power_control
+    115, // adcs_set_rate_gyro_config
+    80, // adcs_set_run_mode
+    143, // adcs_set_sd_log_config
+    98, // adcs_set_sgp4_orbit_params
+    113, // adcs_set_tracking_controller_target_reference
+    96, // adcs_set_unix_time_save_mode
+    74, // adcs_set_wheel_speed
+    141, // adcs_synchronize_unix_time
+    93, // adcs_track_sun
+    192, // agenda_delete_all
+    194, // agenda_delete_by_name
+    193, // agenda_delete_by_tssent
+    195, // agenda_enqueue_from_file
+    190, // agenda_fetch_json_grouped
+    191, // agenda_fetch_logged_jsonl
+    197, // agenda_flush_response_files
+    196, // agenda_get_rx_latency_json
+    215, // ant_arm_antenna_system
+    220, // ant_cancel_deployment_system_activation
+    217, // ant_deploy_antenna
+    219, // ant_deploy_antenna_with_override
+    216, // ant_disarm_antenna_system
+    221, // ant_measure_temp
+    223, // ant_report_antenna_deployment_activation_count
+    224, // ant_report_antenna_deployment_activation_time
+    222, // ant_report_deployment_status
+    214, // ant_reset
+    218, // ant_start_automated_antenna_deployment
+    12, // available_telecommands
+    252, // boom_deploy_timed
+    253, // boom_self_check
+    240, // bulkup16
+    242, // bulkup64
+    251, // camera_capture
+    250, // camera_change_baud_rate
+    248, // camera_setup
+    249, // camera_test
+    235, // comms_bulk_file_downlink_nack
+    233, // comms_bulk_file_downlink_pause
+    234, // comms_bulk_file_downlink_resume
+    231, // comms_bulk_file_downlink_start
+    232, // comms_bulk_file_downlink_start_compressed
+    238, // comms_bulk_uplink_close_file
+    237, // comms_bulk_uplink_open_file
+    243, // comms_bulk_uplink_seek
+    241, // comms_bulk_uplink_write_bytes_base64
+    239, // comms_bulk_uplink_write_bytes_hex
+    230, // comms_get_rf_switch_info
+    236, // comms_get_tx_pacing_stats_json
+    229, // comms_set_rf_switch_control_mode
+    37, // config_get_all_int_vars_json
+    36, // config_get_all_vars_jsonl
+    34, // config_get_int_var_json
+    35, // config_get_str_var_json
+    32, // config_set_int_var
+    33, // config_set_str_var
+    2, // core_system_stats
+    7, // correct_system_time
+    31, // crypto_benchmark_sha256_json
+    29, // demo_blocking_delay
+    30, // demo_os_delay
+    26, // echo_back_args
+    27, // echo_back_uint32_args
+    170, // eps_cancel_operation
+    188, // eps_get_current_battery_percent
+    187, // eps_get_enabled_channels_json
+    175, // eps_get_pbu_abf_placed_state_json
+    181, // eps_get_pbu_housekeeping_data_eng_json
+    182, // eps_get_pbu_housekeeping_data_run_avg_json
+    183, // eps_get_pcu_housekeeping_data_eng_json
+    184, // eps_get_pcu_housekeeping_data_run_avg_json
+    178, // eps_get_pdu_active_channels_data_json
+    179, // eps_get_pdu_active_channels_data_run_avg_json
+    176, // eps_get_pdu_data_for_channel_json
+    177, // eps_get_pdu_housekeeping_data_eng_json
+    180, // eps_get_pdu_housekeeping_data_run_avg_json
+    174, // eps_get_pdu_overcurrent_fault_state_json
+    185, // eps_get_piu_housekeeping_data_eng_json
+    186, // eps_get_piu_housekeeping_data_run_avg_json
+    173, // eps_get_system_status_json
+    169, // eps_no_operation
+    189, // eps_power_management_set_current_threshold
+    172, // eps_set_channel_enabled
+    171, // eps_switch_to_mode
+    168, // eps_system_reset
+    167, // eps_watchdog
+    14, // exec_blob_from_fs
+    38, // flash_activate_each_cs
+    43, // flash_benchmark_erase_write_read
+    44, // flash_benchmark_sequential_read
+    39, // flash_each_is_reachable
+    42, // flash_erase
+    48, // flash_force_corrupt_filesystem
+    47, // flash_get_busy_time_stats_json
+    40, // flash_read_hex
+    46, // flash_read_status_register
+    45, // flash_reset
+    41, // flash_write_hex
+    166, // freertos_demo_stack_usage
+    165, // freetos_list_tasks_jsonl
+    65, // fs_benchmark_write_read
+    68, // fs_compress_file_with_heatshrink
+    71, // fs_count_hex_occurrences
+    69, // fs_count_str_occurrences
+    59, // fs_delete_dir
+    58, // fs_delete_file
+    64, // fs_demo_write_random_data
+    63, // fs_demo_write_then_read
+    72, // fs_find_nth_hex_occurrence
+    70, // fs_find_nth_str_occurrence
+    49, // fs_format_storage
+    66, // fs_get_filesystem_stats_json
+    67, // fs_get_page_cache_stats_json
+    52, // fs_list_directory
+    53, // fs_list_directory_json
+    54, // fs_list_directory_page_json
+    55, // fs_make_directory
+    50, // fs_mount
+    60, // fs_read_file_hex
+    62, // fs_read_file_sha256_hash_json
+    61, // fs_read_text_file
+    51, // fs_unmount
+    57, // fs_write_file_hex
+    56, // fs_write_file_str
+    3, // get_all_system_thermal_info
+    4, // get_system_time
+    247, // gnss_disable_firehose_storage_mode
+    246, // gnss_enable_firehose_storage_mode
+    244, // gnss_send_cmd_ascii
+    245, // gnss_send_cmd_ascii_get_response_hex
+    0, // hello_world
+    158, // log_report_all_sink_enabled_states
+    159, // log_report_all_system_file_logging_states
+    163, // log_report_messages_from_memory
+    164, // log_report_n_latest_messages_from_memory
+    160, // log_set_sink_debugging_messages_state
+    156, // log_set_sink_enabled_state
+    162, // log_set_system_debugging_messages_state
+    157, // log_set_system_file_logging_enabled_state
+    161, // log_set_system_severity_mask
+    199, // mpi_demo_tx_to_mpi
+    202, // mpi_disable_active_mode
+    203, // mpi_downlink_range
+    201, // mpi_enable_active_mode
+    204, // mpi_extract_range_to_file
+    198, // mpi_send_command_get_response_hex
+    200, // mpi_set_transceiver_mode
+    227, // obc_adc_read_vbat_voltage
+    1, // obc_firmware_version
+    19, // obc_get_rbf_state
+    226, // obc_read_temperature
+    225, // obc_read_temperature_complex
+    228, // obc_set_stm32_sysclk_to_hse
+    13, // reboot
+    28, // run_all_unit_tests
+    15, // scan_i2c_bus
+    16, // scan_i2c_bus_verbose
+    8, // set_eps_time_based_on_obc_time
+    9, // set_obc_time_based_on_eps_time
+    11, // set_obc_time_based_on_gnss_pps
+    10, // set_obc_time_based_on_gnss_time
+    6, // set_system_time
+    5, // set_system_time_approx
+    208, // stm32_internal_flash_bank_erase
+    213, // stm32_internal_flash_calculate_sha256
+    210, // stm32_internal_flash_get_active_flash_bank
+    209, // stm32_internal_flash_get_option_bytes
+    207, // stm32_internal_flash_page_erase
+    205, // stm32_internal_flash_read
+    211, // stm32_internal_flash_set_active_flash_bank
+    206, // stm32_internal_flash_write
+    212, // stm32_internal_flash_write_file_to_internal_flash
+    18, // system_self_check_as_json
+    17, // system_self_check_failures_as_json
+    24, // uart_get_errors_json
+    23, // uart_get_last_rx_times_json
+    20, // uart_send_hex
+    22, // uart_send_hex_get_response_hex
+    21, // uart_send_str
+    25, // uart_set_baud_rate
+};
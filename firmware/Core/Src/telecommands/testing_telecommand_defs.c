@@ -6,6 +6,9 @@
 #include "debug_tools/debug_uart.h"
 
 #include "unit_tests/unit_test_executor.h"
+#include "crypto/sha256.h"
+
+#include "stm32l4xx_hal.h"
 
 #include <stdio.h>
 #include <inttypes.h>
@@ -31,12 +34,15 @@ uint8_t TCMDEXEC_echo_back_args(
 /// @return 0 if all ints are parsed successfully, otherwise the error code of the first failed parse.
 uint8_t TCMDEXEC_echo_back_uint32_args(const char *args_str,
                         char *response_output_buf, uint16_t response_output_buf_len) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     response_output_buf[0] = '\0'; // clear the response buffer
 
     for (uint8_t arg_num = 0; arg_num < 3; arg_num++) {
         uint64_t arg_uint64;
-        uint8_t parse_result = TCMD_extract_uint64_arg(
-            args_str, strlen(args_str), arg_num, &arg_uint64);
+        uint8_t parse_result = TCMD_args_get_uint64(
+            &args, arg_num, &arg_uint64);
         if (parse_result > 0) {
             // error parsing
             snprintf(
@@ -72,9 +78,12 @@ uint8_t TCMDEXEC_demo_blocking_delay(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t delay_ms;
-    const uint8_t parse_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 0, &delay_ms
+    const uint8_t parse_result = TCMD_args_get_uint64(
+        &args, 0, &delay_ms
     );
     if (parse_result > 0) {
         snprintf(response_output_buf, response_output_buf_len, "Error parsing delay_ms: Err=%d", parse_result);
@@ -104,9 +113,12 @@ uint8_t TCMDEXEC_demo_os_delay(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t delay_ms;
-    const uint8_t parse_result = TCMD_extract_uint64_arg(
-        args_str, strlen(args_str), 0, &delay_ms
+    const uint8_t parse_result = TCMD_args_get_uint64(
+        &args, 0, &delay_ms
     );
     if (parse_result > 0) {
         snprintf(response_output_buf, response_output_buf_len, "Error parsing delay_ms: Err=%d", parse_result);
@@ -125,3 +137,56 @@ uint8_t TCMDEXEC_demo_os_delay(
     snprintf(response_output_buf, response_output_buf_len, "Delayed for %" PRIu32 " ms", delay_ms_u32);
     return 0;
 }
+
+
+/// @brief Measure the speed of the SHA256 implementation, in CPU cycles per byte (DWT cycle counter).
+/// @param args_str
+/// - Arg 0: Number of KiB to hash (1 to 256). The same 1 KiB buffer is hashed repeatedly.
+/// @return 0 on success, 1 on error
+/// @note Interrupts and other tasks aren't excluded, so run it a few times and take the lowest.
+uint8_t TCMDEXEC_crypto_benchmark_sha256_json(
+    const char *args_str,
+    char *response_output_buf, uint16_t response_output_buf_len
+) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
+    uint64_t kib_count;
+    const uint8_t parse_result = TCMD_args_get_uint64(&args, 0, &kib_count);
+    if ((parse_result > 0) || (kib_count == 0) || (kib_count > 256)) {
+        snprintf(response_output_buf, response_output_buf_len, "Error parsing KiB count (1 to 256): Err=%d", parse_result);
+        return 1;
+    }
+
+    static uint8_t message[1024];
+    for (uint16_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t)((i * 167) + 13);
+    }
+
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    SHA256_CTX ctx;
+    uint8_t hash[32];
+    const uint32_t start_cycle_count = DWT->CYCCNT;
+    sha256_init(&ctx);
+    for (uint32_t i = 0; i < (uint32_t)kib_count; i++) {
+        sha256_update(&ctx, message, sizeof(message));
+    }
+    sha256_final(&ctx, hash);
+    const uint32_t cycle_count = DWT->CYCCNT - start_cycle_count;
+
+    const uint32_t byte_count = (uint32_t)kib_count * sizeof(message);
+    const uint32_t cycles_per_byte_x100 = (uint32_t)(((uint64_t)cycle_count * 100) / byte_count);
+    snprintf(
+        response_output_buf, response_output_buf_len,
+        "{\"bytes\":%" PRIu32 ",\"cycles\":%" PRIu32 ",\"cycles_per_byte\":%" PRIu32 ".%02" PRIu32
+        ",\"duration_us\":%" PRIu32 ",\"sysclk_hz\":%" PRIu32 "}",
+        byte_count, cycle_count, cycles_per_byte_x100 / 100, cycles_per_byte_x100 % 100,
+        (uint32_t)(((uint64_t)cycle_count * 1000000) / SystemCoreClock), SystemCoreClock
+    );
+    return 0;
+}
@@ -27,9 +27,12 @@ uint8_t TCMDEXEC_set_system_time(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t ms = 0;
 
-    const uint8_t result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &ms);
+    const uint8_t result = TCMD_args_get_uint64(&args, 0, &ms);
     if (result != 0) {
         snprintf(response_output_buf, response_output_buf_len, "Invalid system time argument");
         return 1;
@@ -68,9 +71,12 @@ uint8_t TCMDEXEC_set_system_time_approx(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     uint64_t ms = 0;
 
-    const uint8_t result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 0, &ms);
+    const uint8_t result = TCMD_args_get_uint64(&args, 0, &ms);
     if (result != 0) {
         snprintf(response_output_buf, response_output_buf_len, "Invalid system time argument");
         return 1;
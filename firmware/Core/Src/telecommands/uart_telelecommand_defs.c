@@ -2,6 +2,7 @@
 #include "telecommand_exec/telecommand_args_helpers.h"
 
 #include "uart_handler/uart_handler.h"
+#include "uart_handler/uart_dma_ring.h"
 #include "mpi/mpi_command_handling.h"
 #include "log/log.h"
 #include "debug_tools/debug_uart.h"
@@ -40,13 +41,16 @@ uint8_t TCMDEXEC_uart_send_hex_get_response_hex(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Parse UART port argument
     char arg_uart_port_name[10] = "";
-    const uint8_t uart_port_name_parse_result = TCMD_extract_string_arg(args_str, 0, arg_uart_port_name, 10);
+    const uint8_t uart_port_name_parse_result = TCMD_args_get_string(&args, 0, arg_uart_port_name, 10);
 
     // Parse hex-encoded config command (string to bytes)
     uint16_t tx_buffer_len = 0; // Variable to store the length of the converted byte array
-    const uint8_t bytes_to_send_parse_result = TCMD_extract_hex_array_arg(args_str, 1, tx_buffer, tx_buffer_max_size, &tx_buffer_len);
+    const uint8_t bytes_to_send_parse_result = TCMD_args_get_hex_array(&args, 1, tx_buffer, tx_buffer_max_size, &tx_buffer_len);
 
     // Check for argument parsing errors
     if(uart_port_name_parse_result != 0 || bytes_to_send_parse_result !=0) {
@@ -65,9 +69,10 @@ uint8_t TCMDEXEC_uart_send_hex_get_response_hex(
 
     // Assign pointers to UART reception variables to unify the interface (Interrupt case only in this function)
     UART_HandleTypeDef *UART_handle_ptr;                        
-    volatile uint16_t *UART_rx_buffer_write_idx_ptr;            
-    volatile uint8_t *UART_rx_buffer;
-    const uint16_t *UART_rx_buffer_size_ptr;
+    volatile uint16_t *UART_rx_buffer_write_idx_ptr = NULL;
+    volatile uint8_t *UART_rx_buffer = NULL;
+    const uint16_t *UART_rx_buffer_size_ptr = NULL;
+    UART_dma_ring_t *UART_rx_ring_ptr = NULL; // Used instead of the 3 above, for circular-DMA reception.
     volatile uint32_t *UART_last_write_time_ms_ptr;
 
     LOG_system_enum_t LOG_source = LOG_SYSTEM_TELECOMMAND;
@@ -181,18 +186,16 @@ uint8_t TCMDEXEC_uart_send_hex_get_response_hex(
         return 0;
     }
 
-    // UART 2 (disabled), 3 & 5 use interrupt based reception. Set UART handle and buffers accordingly.
+    // UART 2 (disabled), 3 & 5 use interrupt/DMA based reception. Set UART handle and buffers accordingly.
     else {
         // UART 3 Selected (GNSS)
         if(strcasecmp(arg_uart_port_name, "GNSS") == 0) {
             UART_handle_ptr = UART_gnss_port_handle;
-            UART_rx_buffer_write_idx_ptr = &UART_gnss_buffer_write_idx;
-            UART_rx_buffer = UART_gnss_buffer;
-            UART_rx_buffer_size_ptr = &UART_gnss_buffer_len;
+            UART_rx_ring_ptr = &UART_gnss_rx_ring;
             UART_last_write_time_ms_ptr = &UART_gnss_last_write_time_ms;
             LOG_source = LOG_SYSTEM_GNSS;
 
-            // Enable GNSS UART interrupt. We are now listening.
+            // Enable GNSS UART reception. We are now listening.
             GNSS_set_uart_interrupt_state(1);
         }
 
@@ -217,13 +220,21 @@ uint8_t TCMDEXEC_uart_send_hex_get_response_hex(
             return 2;   // Error code: Invalid UART port requested
         }
 
-        // Reset UART buffer write index
-        *UART_rx_buffer_write_idx_ptr = 0;
+        if (UART_rx_ring_ptr != NULL) {
+            // Only look at the response to this transmission.
+            UART_dma_ring_discard_all(UART_rx_ring_ptr);
+        }
+        else {
+            // Reset UART buffer write index
+            *UART_rx_buffer_write_idx_ptr = 0;
 
-        // Clear the response buffer (Note: Can't use memset because UART_rx_buffer is Volatile)
-        for (uint16_t i = 0; i < *UART_rx_buffer_size_ptr; i++) {
-            UART_rx_buffer[i] = 0;
+            // Clear the response buffer (Note: Can't use memset because UART_rx_buffer is Volatile)
+            for (uint16_t i = 0; i < *UART_rx_buffer_size_ptr; i++) {
+                UART_rx_buffer[i] = 0;
+            }
         }
+        const uint16_t rx_len_max = (UART_rx_ring_ptr != NULL) ? rx_buffer_max_size : *UART_rx_buffer_size_ptr;
+        uint16_t rx_len = 0;
 
         // Transmit config command to requested peripheral
         const HAL_StatusTypeDef transmit_status = HAL_UART_Transmit(
@@ -255,13 +266,22 @@ uint8_t TCMDEXEC_uart_send_hex_get_response_hex(
 
         // Receive from peripheral until a timeout event
         while (1) {
+            if (UART_rx_ring_ptr != NULL) {
+                // Copy out of the DMA ring as it arrives (straight into the response buffer).
+                rx_len += UART_dma_ring_read(UART_rx_ring_ptr, &rx_buffer[rx_len], rx_len_max - rx_len);
+            }
+            else {
+                rx_len = *UART_rx_buffer_write_idx_ptr;
+            }
+
             // Check if we have received up to max UART rx buffer size.
-            if (*UART_rx_buffer_write_idx_ptr >= *UART_rx_buffer_size_ptr) {
+            if (rx_len >= rx_len_max) {
+                rx_buffer_len = rx_len;
                 break;
             }
 
             // Check if we have timed out (Before receiving the first byte)
-            if (*UART_rx_buffer_write_idx_ptr == 0) {
+            if (rx_len == 0) {
                 if((TIME_uptime_ms() - UART_rx_start_time_ms) > UART_RX_TIMEOUT_DURATION_MS) {
                     LOG_message(
                         LOG_source, LOG_SEVERITY_ERROR, LOG_SINK_ALL,
@@ -286,7 +306,7 @@ uint8_t TCMDEXEC_uart_send_hex_get_response_hex(
                     (current_time > last_write_time) // Important seemingly-obvious safety check.
                     && ((current_time - last_write_time) > UART_RX_TIMEOUT_DURATION_MS)
                 ) {
-                    rx_buffer_len = *UART_rx_buffer_write_idx_ptr; // Set the length of the response buffer
+                    rx_buffer_len = rx_len; // Set the length of the response buffer
                     break;
                 }
             }
@@ -294,13 +314,16 @@ uint8_t TCMDEXEC_uart_send_hex_get_response_hex(
 
         // Log the response received from peripheral
         // Copy the buffer to the last received byte index & clear the UART buffer
-        for (uint16_t i = 0; i < rx_buffer_len; i++) {
-            rx_buffer[i] = UART_rx_buffer[i];
-            UART_rx_buffer[i] = 0;
-        }
+        // (The ring case already copied into `rx_buffer`.)
+        if (UART_rx_ring_ptr == NULL) {
+            for (uint16_t i = 0; i < rx_buffer_len; i++) {
+                rx_buffer[i] = UART_rx_buffer[i];
+                UART_rx_buffer[i] = 0;
+            }
 
-        // Reset UART buffer write index                
-        *UART_rx_buffer_write_idx_ptr = 0;
+            // Reset UART buffer write index                
+            *UART_rx_buffer_write_idx_ptr = 0;
+        }
 
         // Reset listening flags if used by peripheral (interrupt reception mode case is only handled here)
         if (UART_handle_ptr == UART_eps_port_handle) {
@@ -375,14 +398,17 @@ uint8_t TCMDEXEC_uart_send_hex(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Parse UART port argument
     char arg_uart_port_name[10] = "";
-    const uint8_t uart_port_name_parse_result = TCMD_extract_string_arg(args_str, 0, arg_uart_port_name, 10);
+    const uint8_t uart_port_name_parse_result = TCMD_args_get_string(&args, 0, arg_uart_port_name, 10);
 
     // Parse hex-encoded config command (string to bytes)
     uint16_t tx_buffer_len = 0; // Variable to store the length of the converted byte array
-    const uint8_t bytes_to_send_parse_result = TCMD_extract_hex_array_arg(
-        args_str, 1, tx_buffer, tx_buffer_max_size, &tx_buffer_len
+    const uint8_t bytes_to_send_parse_result = TCMD_args_get_hex_array(
+        &args, 1, tx_buffer, tx_buffer_max_size, &tx_buffer_len
     );
 
     // Check for argument parsing errors
@@ -443,13 +469,16 @@ uint8_t TCMDEXEC_uart_send_str(
     const char *args_str,
     char *response_output_buf, uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Parse UART port argument
     char arg_uart_port_name[10] = "";
-    const uint8_t uart_port_name_parse_result = TCMD_extract_string_arg(args_str, 0, arg_uart_port_name, 10);
+    const uint8_t uart_port_name_parse_result = TCMD_args_get_string(&args, 0, arg_uart_port_name, 10);
 
     // Parse string-encoded config command (string to bytes)
-    const uint8_t bytes_to_send_parse_result = TCMD_extract_string_arg(
-        args_str, 1, (char *)tx_buffer, tx_buffer_max_size
+    const uint8_t bytes_to_send_parse_result = TCMD_args_get_string(
+        &args, 1, (char *)tx_buffer, tx_buffer_max_size
     );
 
     // Check for argument parsing errors
@@ -547,13 +576,16 @@ uint8_t TCMDEXEC_uart_set_baud_rate(
     char *response_output_buf,
     uint16_t response_output_buf_len
 ) {
+    TCMD_args_t args;
+    TCMD_tokenize_args(args_str, strlen(args_str), &args);
+
     // Parse UART port argument
     char arg_uart_port_name[50];
-    const uint8_t uart_port_name_parse_result = TCMD_extract_string_arg(args_str, 0, arg_uart_port_name, 10);
+    const uint8_t uart_port_name_parse_result = TCMD_args_get_string(&args, 0, arg_uart_port_name, 10);
 
     // Parse baud rate argument
     uint64_t new_baud_rate_u64 = 0;
-    const uint8_t baud_rate_parse_result = TCMD_extract_uint64_arg(args_str, strlen(args_str), 1, &new_baud_rate_u64);
+    const uint8_t baud_rate_parse_result = TCMD_args_get_uint64(&args, 1, &new_baud_rate_u64);
 
     // Check max bound to convert to uint32_t.
     if (new_baud_rate_u64 > 921600) {
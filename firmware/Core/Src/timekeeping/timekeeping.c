@@ -126,6 +126,35 @@ void TIME_format_timestamp_str(
     return;
 }
 
+/// @brief Same as `TIME_format_timestamp_str`, for a time kept as the time of a resync plus the ms
+/// since it (e.g., captured by `LOG_message`, and formatted later by the logger task).
+/// @param unix_epoch_time_at_resync_ms - The `TIME_unix_epoch_time_at_last_time_resync_ms` at capture.
+/// @param ms_since_resync - The uptime since that resync, at capture.
+/// @note Gives the same string as `TIME_format_timestamp_str` at capture, even if the time has
+/// been resynced since.
+void TIME_format_resync_offset_timestamp_str(
+    char dest_str[], size_t dest_str_size,
+    uint64_t unix_epoch_time_at_resync_ms, uint32_t ms_since_resync, TIME_sync_source_enum_t sync_source
+) {
+    if (dest_str_size < TIME_EPOCH_DECIMAL_STRING_LEN) {
+        return;
+    }
+    char resync_time_str[TIME_EPOCH_DECIMAL_STRING_LEN + 1];
+    const char *resync_time_str_ptr = TIME_unix_epoch_time_at_last_time_resync_ms_str;
+    if (unix_epoch_time_at_resync_ms != TIME_unix_epoch_time_at_last_time_resync_ms) {
+        GEN_uint64_to_padded_str(unix_epoch_time_at_resync_ms, TIME_EPOCH_DECIMAL_STRING_LEN, resync_time_str);
+        resync_time_str_ptr = resync_time_str;
+    }
+    snprintf(
+        dest_str,
+        dest_str_size,
+        "%s+%010lu_%c",
+        resync_time_str_ptr,
+        ms_since_resync,
+        TIME_sync_source_enum_to_letter_char(sync_source)
+    );
+}
+
 /// @brief Returns a computer-friendly timestamp string. 
 /// @param dest_str - Pointer to buffer that stores the log string 
 /// @param dest_str_size - Maximum length of dest_str buffer
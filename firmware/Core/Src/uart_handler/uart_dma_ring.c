@@ -0,0 +1,120 @@
+// uart_dma_ring.c
+// Consumer side of a UART received with `HAL_UARTEx_ReceiveToIdle_DMA` into a circular buffer.
+// The DMA writes every byte without CPU involvement. The CPU is only interrupted at the
+// half-transfer and transfer-complete points, and when the RX line goes idle after a burst, and
+// each of those events just advances `total_bytes_written`. Readers copy out whatever is new.
+//
+// Because an event occurs at least every half buffer, the distance the DMA moved between two
+// events is always less than the buffer length, so it can be found from the two positions alone.
+
+#include "uart_handler/uart_dma_ring.h"
+
+/// @brief Initialize a ring over a DMA buffer. The DMA must not be running yet.
+/// @param buffer The buffer passed to `HAL_UARTEx_ReceiveToIdle_DMA`.
+/// @param buffer_len Length of `buffer`. Must be a power of two.
+/// @return 0 on success, 1 if `buffer_len` is not a power of two.
+uint8_t UART_dma_ring_init(UART_dma_ring_t *ring, volatile uint8_t *buffer, uint16_t buffer_len) {
+    if ((buffer_len == 0) || ((buffer_len & (buffer_len - 1)) != 0)) {
+        return 1;
+    }
+    ring->buffer = buffer;
+    ring->buffer_len = buffer_len;
+    ring->dma_write_pos = 0;
+    ring->total_bytes_written = 0;
+    ring->restart_total_bytes_written = 0;
+    ring->rx_event_count = 0;
+    ring->total_bytes_read = 0;
+    ring->overrun_bytes_lost = 0;
+    return 0;
+}
+
+/// @brief Call just before (re)starting the DMA, which always starts at the start of the buffer.
+/// @note Any unread bytes are discarded. The totals are advanced to the next multiple of the
+///     buffer length, so that `total & (buffer_len - 1)` stays equal to the DMA position.
+/// @note ISR (e.g., re-arming after a UART error), or task context while the DMA is stopped.
+void UART_dma_ring_restart(UART_dma_ring_t *ring) {
+    const uint32_t mask = ring->buffer_len - 1;
+    const uint32_t restart_total = (ring->total_bytes_written + mask) & ~mask;
+
+    ring->dma_write_pos = 0;
+    ring->restart_total_bytes_written = restart_total;
+    ring->total_bytes_written = restart_total;
+}
+
+/// @brief Record an RX event from `HAL_UARTEx_RxEventCallback`.
+/// @param dma_write_pos The callback's `Size` argument: the index in the buffer that the DMA has
+///     written up to (equal to the buffer length on transfer-complete).
+/// @return Number of new bytes since the previous event.
+/// @note ISR only.
+uint16_t UART_dma_ring_on_rx_event(UART_dma_ring_t *ring, uint16_t dma_write_pos) {
+    const uint16_t mask = ring->buffer_len - 1;
+    const uint16_t new_pos = dma_write_pos & mask;
+    const uint16_t new_bytes = (new_pos - ring->dma_write_pos) & mask;
+
+    ring->dma_write_pos = new_pos;
+    ring->total_bytes_written += new_bytes;
+    ring->rx_event_count++;
+    return new_bytes;
+}
+
+/// @brief Get the first unread byte's total, skipping anything discarded by a DMA restart.
+static uint32_t UART_dma_ring_first_unread_total(const UART_dma_ring_t *ring, uint32_t total_bytes_written) {
+    const uint32_t restart_total = ring->restart_total_bytes_written;
+
+    // Signed differences, because the totals wrap. The second check guards against a restart
+    // which happened after `total_bytes_written` was read.
+    if (
+        ((int32_t)(restart_total - ring->total_bytes_read) > 0)
+        && ((int32_t)(total_bytes_written - restart_total) >= 0)
+    ) {
+        return restart_total;
+    }
+    return ring->total_bytes_read;
+}
+
+/// @brief Get the number of bytes which can be read now.
+/// @note Capped at the buffer length. Any older bytes have been overwritten by the DMA.
+uint16_t UART_dma_ring_available(const UART_dma_ring_t *ring) {
+    const uint32_t total_bytes_written = ring->total_bytes_written;
+    const uint32_t unread = total_bytes_written - UART_dma_ring_first_unread_total(ring, total_bytes_written);
+    if (unread > ring->buffer_len) {
+        return ring->buffer_len;
+    }
+    return unread;
+}
+
+/// @brief Copy the oldest unread bytes out of the ring, and mark them as read.
+/// @param dest Output buffer.
+/// @param dest_max_len Max number of bytes to copy.
+/// @return Number of bytes copied into `dest`.
+/// @note If the DMA lapped the reader, the overwritten bytes are skipped and added to
+///     `overrun_bytes_lost`.
+/// @note The DMA keeps writing during the copy. The reader must keep up (i.e., read at least
+///     once per half buffer at the line rate), or the newest bytes may overwrite the ones being copied.
+uint16_t UART_dma_ring_read(UART_dma_ring_t *ring, uint8_t dest[], uint16_t dest_max_len) {
+    const uint32_t total_bytes_written = ring->total_bytes_written; // Snapshot; the ISR may advance it.
+    ring->total_bytes_read = UART_dma_ring_first_unread_total(ring, total_bytes_written);
+
+    uint32_t unread = total_bytes_written - ring->total_bytes_read;
+    if (unread > ring->buffer_len) {
+        ring->overrun_bytes_lost += unread - ring->buffer_len;
+        ring->total_bytes_read = total_bytes_written - ring->buffer_len;
+        unread = ring->buffer_len;
+    }
+
+    const uint16_t copy_len = (unread < dest_max_len) ? unread : dest_max_len;
+    const uint16_t mask = ring->buffer_len - 1;
+    uint16_t read_pos = ring->total_bytes_read & mask;
+    for (uint16_t i = 0; i < copy_len; i++) { // Volatile-safe memcpy.
+        dest[i] = ring->buffer[read_pos];
+        read_pos = (read_pos + 1) & mask;
+    }
+
+    ring->total_bytes_read += copy_len;
+    return copy_len;
+}
+
+/// @brief Mark everything received so far as read (e.g., before sending a command, to only see its response).
+void UART_dma_ring_discard_all(UART_dma_ring_t *ring) {
+    ring->total_bytes_read = ring->total_bytes_written;
+}
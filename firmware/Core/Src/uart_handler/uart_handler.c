@@ -1,15 +1,21 @@
 #include "uart_handler/uart_handler.h"
+#include "uart_handler/uart_dma_ring.h"
 #include "debug_tools/debug_uart.h"
 #include "mpi/mpi_command_handling.h"
+#include "mpi/mpi_science_ring.h"
 #include "gnss_receiver/gnss_firehose_storage.h"
 #include "uart_handler/uart_error_tracking.h"
 #include "camera/camera_capture.h"
 #include "log/log.h"
 #include "timekeeping/timekeeping.h"
+#include "rtos_tasks/rtos_mpi_tasks.h"
 
 #include "mpi/mpi_transceiver.h"
 #include "main.h"
 
+#include "FreeRTOS.h"
+#include "message_buffer.h"
+
 #include <string.h>
 
 // Name the UART interfaces
@@ -21,11 +27,29 @@ UART_HandleTypeDef *UART_camera_port_handle = &huart4;
 UART_HandleTypeDef *UART_eps_port_handle = &huart5;
 
 // UART telecommand buffer
-const uint16_t UART_telecommand_buffer_len = 256;           // extern
-volatile uint8_t UART_telecommand_buffer[256];              // extern
-volatile uint16_t UART_telecommand_buffer_write_idx = 0;    // extern
 volatile uint32_t UART_telecommand_last_write_time_ms = 0;  // extern
-volatile uint8_t UART_telecommand_buffer_last_rx_byte = 0;  // not an extern
+
+// Circular DMA reception (see `uart_dma_ring.c`). Lengths must be powers of two.
+static volatile uint8_t UART_telecommand_dma_buffer[256];
+static UART_dma_ring_t UART_telecommand_rx_ring;
+
+/// @brief The telecommand currently being received. Sent to `UART_telecommand_rx_message_buffer`
+///     when the end-of-telecommand character ('!') is received.
+static volatile UART_telecommand_rx_frame_t UART_telecommand_rx_frame_in_progress;
+static volatile uint16_t UART_telecommand_rx_frame_in_progress_len = 0;
+
+/// @brief If no byte is received for this long, the telecommand in progress is sent on as incomplete.
+static const uint32_t UART_telecommand_incomplete_timeout_ms = 100;
+
+/// @brief Max number of max-length telecommands which can be waiting for `TASK_handle_uart_telecommands`.
+#define UART_TELECOMMAND_RX_FRAMES_IN_QUEUE 4
+
+// Each message in a message buffer is stored with a `size_t` length prefix.
+#define UART_TELECOMMAND_RX_MESSAGE_BUFFER_SIZE \
+    (UART_TELECOMMAND_RX_FRAMES_IN_QUEUE * (sizeof(size_t) + sizeof(UART_telecommand_rx_frame_t)))
+static uint8_t UART_telecommand_rx_message_buffer_storage[UART_TELECOMMAND_RX_MESSAGE_BUFFER_SIZE + 1];
+static StaticMessageBuffer_t UART_telecommand_rx_message_buffer_struct;
+static MessageBufferHandle_t UART_telecommand_rx_message_buffer = NULL;
 
 // UART AX100 buffer
 volatile uint16_t UART_ax100_buffer_write_idx = 0;          // extern
@@ -49,7 +73,8 @@ volatile uint8_t UART_eps_buffer[310];              // extern
 volatile uint16_t UART_eps_buffer_write_idx = 0;    // extern
 volatile uint32_t UART_eps_last_write_time_ms = 0;  // extern
 volatile uint8_t UART_eps_is_expecting_data = 0;    // extern  // Set to 1 when a command is sent, and we're awaiting a response.
-volatile uint8_t UART_eps_buffer_last_rx_byte = 0;  // not an extern
+static volatile uint8_t UART_eps_dma_buffer[512];   // Copied into `UART_eps_buffer` by the RX event ISR.
+static UART_dma_ring_t UART_eps_rx_ring;
 
 // UART MPI command mode buffer
 const uint16_t UART_mpi_buffer_len = 256;                   // extern
@@ -58,33 +83,13 @@ volatile uint8_t UART_mpi_last_rx_byte = 0;                 // extern
 volatile uint32_t UART_mpi_last_write_time_ms = 0;          // extern
 volatile uint16_t UART_mpi_buffer_write_idx = 0;            // extern
 
-// UART GNSS buffer
-const uint16_t UART_gnss_buffer_len = 2048; // extern
-volatile uint8_t UART_gnss_buffer[2048]; // extern
-volatile uint16_t UART_gnss_buffer_write_idx = 0; // extern
+// UART GNSS buffer. Read through `UART_gnss_rx_ring`.
+static volatile uint8_t UART_gnss_dma_buffer[2048];
+UART_dma_ring_t UART_gnss_rx_ring; // extern
 volatile uint32_t UART_gnss_last_write_time_ms = 0; // extern
-volatile uint8_t UART_gnss_buffer_last_rx_byte = 0; // extern
 volatile uint8_t UART_gnss_uart_interrupt_enabled = 0; // extern
 
-// Section: MPI science data buffers.
-const uint8_t UART_mpi_rx_dma_buffer_len = 160;
-volatile uint8_t UART_mpi_rx_dma_buffer[160];
-
-/// @brief Length of the `MPI_science_buffer_one` and `MPI_science_buffer_two` arrays.
-const uint16_t MPI_science_buffer_len = 20480;
-volatile uint8_t MPI_science_buffer_one[20480];
-volatile uint8_t MPI_science_buffer_two[20480];
-
-/// @brief Current state of the `MPI_active_data_median_buffer` (pending write vs. written).
-volatile MPI_buffer_state_enum_t MPI_buffer_one_state = MPI_MEMORY_WRITE_STATUS_READY_TO_FILL;
-volatile MPI_buffer_state_enum_t MPI_buffer_two_state = MPI_MEMORY_WRITE_STATUS_READY_TO_FILL;
-
-volatile uint32_t MPI_buffer_one_last_filled_uptime_ms = 0; // Last time the buffer was filled
-volatile uint32_t MPI_buffer_two_last_filled_uptime_ms = 0; // Last time the buffer was filled
-
-/// @brief Index into a virtual array that is `MPI_science_buffer_one` and
-///        `MPI_science_buffer_two` concatenated.
-volatile uint16_t UART_MPI_science_buffer_index = 0;
+// MPI science data is received by DMA straight into the buffers of `mpi_science_ring.c`.
 
 
 #define KISS_FEND  0xC0
@@ -93,9 +98,11 @@ volatile uint16_t UART_MPI_science_buffer_index = 0;
 #define KISS_TFESC 0xDD
 
 
-volatile AX100_kiss_frame_struct_t UART_AX100_kiss_frame_queue[AX100_MAX_KISS_FRAMES_IN_RX_QUEUE];
-volatile uint8_t UART_AX100_kiss_frame_queue_head = 0;
-volatile uint8_t UART_AX100_kiss_frame_queue_tail = 0;
+#define AX100_KISS_RX_MESSAGE_BUFFER_SIZE \
+    (AX100_MAX_KISS_FRAMES_IN_RX_QUEUE * (sizeof(size_t) + sizeof(AX100_kiss_frame_struct_t)))
+static uint8_t AX100_kiss_rx_message_buffer_storage[AX100_KISS_RX_MESSAGE_BUFFER_SIZE + 1];
+static StaticMessageBuffer_t AX100_kiss_rx_message_buffer_struct;
+static MessageBufferHandle_t AX100_kiss_rx_message_buffer = NULL;
 
 
 /// Indicates whether we are currently inside a KISS frame.
@@ -108,112 +115,157 @@ static volatile uint8_t kiss_escaped = 0;
 
 /// Temporary buffer to hold the decoded contents of the current KISS frame.
 /// Reset when a frame is completed or an error occurs (e.g. overflow or bad escape).
-static volatile uint8_t kiss_decode_buf[AX100_MAX_KISS_FRAME_SIZE_BYTES];
+static volatile AX100_kiss_frame_struct_t kiss_decode_frame;
 
-/// Current write index into kiss_decode_buf, tracking how many decoded bytes
+/// Current write index into kiss_decode_frame.data, tracking how many decoded bytes
 /// have been accumulated in the current frame.
 static volatile uint16_t kiss_decode_len = 0;
 
-static inline uint8_t kiss_queue_is_full(void) {
-    return ((UART_AX100_kiss_frame_queue_head + 1) % AX100_MAX_KISS_FRAMES_IN_RX_QUEUE) == UART_AX100_kiss_frame_queue_tail;
+/// @brief Send a received frame (`uptime_at_rx_ms` followed by `data_len` bytes of data) to the
+///     message buffer, which wakes the task blocked on it.
+/// @return 0 on success, 1 if there was not enough space in the message buffer (frame dropped).
+/// @note ISR only.
+/// @note The woken task is not switched to from the ISR. The scheduler is cooperative
+///     (`configUSE_PREEMPTION` is 0), so it runs when the interrupted task next yields.
+static uint8_t UART_send_frame_to_message_buffer_from_isr(
+    MessageBufferHandle_t message_buffer, volatile void *frame, uint16_t data_len
+) {
+    const size_t message_len = sizeof(uint32_t) + data_len;
+    const size_t sent_len = xMessageBufferSendFromISR(
+        message_buffer, (const void *)frame, message_len, NULL
+    );
+    return (sent_len == message_len) ? 0 : 1;
 }
 
-static inline void kiss_enqueue_frame(const volatile uint8_t *data, uint16_t len) {
-    if (kiss_queue_is_full()) {
-        // Tracking error
-        UART_error_ax100_error_info.handler_buffer_full_error_count++;
-        // DEBUG_uart_print_str("HAL_UART_RxCpltCallback() -> KISS frame queue is full\n");
+/// @brief Send the telecommand in progress (complete or not) to `TASK_handle_uart_telecommands`.
+/// @note ISR only.
+static void UART_telecommand_send_frame_in_progress(void) {
+    if (UART_telecommand_rx_frame_in_progress_len == 0) {
         return;
     }
+    UART_telecommand_rx_frame_in_progress.uptime_at_rx_ms = UART_telecommand_last_write_time_ms;
+    if (UART_send_frame_to_message_buffer_from_isr(
+        UART_telecommand_rx_message_buffer,
+        &UART_telecommand_rx_frame_in_progress,
+        UART_telecommand_rx_frame_in_progress_len
+    ) != 0) {
+        // Tracking error
+        UART_error_telecommand_error_info.handler_buffer_full_error_count++;
+    }
+    UART_telecommand_rx_frame_in_progress_len = 0;
+}
 
-    AX100_kiss_frame_struct_t *dst = (AX100_kiss_frame_struct_t*)&UART_AX100_kiss_frame_queue[UART_AX100_kiss_frame_queue_head];
-    dst->len = len > AX100_MAX_KISS_FRAME_SIZE_BYTES ? AX100_MAX_KISS_FRAME_SIZE_BYTES : len;
-    
-    // Volatile-safe memcpy(dst->data, data, dst->len);
-    for (uint16_t i = 0; i < dst->len; i++) {
-        dst->data[i] = data[i];
+/// @brief Add a received byte to the telecommand in progress, and send the frame on when it ends.
+/// @note ISR only.
+static void UART_telecommand_add_rx_byte(uint8_t rx_byte) {
+    UART_telecommand_rx_frame_in_progress.data[UART_telecommand_rx_frame_in_progress_len++] = rx_byte;
+
+    if (rx_byte == '!') {
+        // End of telecommand.
+        UART_telecommand_send_frame_in_progress();
+    }
+    else if (UART_telecommand_rx_frame_in_progress_len >= UART_TELECOMMAND_MAX_FRAME_SIZE_BYTES) {
+        // Too long to be a telecommand. Pass it on as incomplete.
+        UART_error_telecommand_error_info.handler_buffer_full_error_count++;
+        UART_telecommand_send_frame_in_progress();
     }
-    UART_AX100_kiss_frame_queue_head = (UART_AX100_kiss_frame_queue_head + 1) % AX100_MAX_KISS_FRAMES_IN_RX_QUEUE;
 }
 
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
-    // This ISR function gets called every time a byte is received on the UART.
+/// @brief Start (or restart, e.g., after an error) circular-DMA reception into a ring.
+/// @note Received data is signalled through `HAL_UARTEx_RxEventCallback`, on half-transfer,
+///     transfer-complete, and when the RX line goes idle after a burst.
+static HAL_StatusTypeDef UART_start_dma_ring_reception(UART_HandleTypeDef *huart, UART_dma_ring_t *ring) {
+    UART_dma_ring_restart(ring);
+    return HAL_UARTEx_ReceiveToIdle_DMA(huart, (uint8_t*) ring->buffer, ring->buffer_len);
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+    // This ISR function gets called for the circular-DMA ports (telecommand, EPS, GNSS) when the
+    // DMA reaches the middle or end of the buffer, and when the RX line goes idle.
+    // `Size` is the position in the DMA buffer which has been written up to.
 
     if (huart->Instance == UART_telecommand_port_handle->Instance) {
         // THIS IS THE DEBUG/TELECOMMAND UART
-        // DEBUG_uart_print_str("HAL_UART_RxCpltCallback() -> Telecommand\n");
-        
-        // Add the byte to the buffer.
-        if (UART_telecommand_buffer_write_idx >= UART_telecommand_buffer_len) {
-            // Tracking error
-            UART_error_telecommand_error_info.handler_buffer_full_error_count++;
-            DEBUG_uart_print_str("HAL_UART_RxCpltCallback() -> UART telecommand buffer is full\n");
-            
-            // shift all bytes left by 1
-            for (uint16_t i = 1; i < UART_telecommand_buffer_len; i++) {
-                UART_telecommand_buffer[i - 1] = UART_telecommand_buffer[i];
+        const uint32_t now_ms = TIME_uptime_ms();
+        if (UART_dma_ring_on_rx_event(&UART_telecommand_rx_ring, Size) == 0) {
+            return;
+        }
+
+        // If the telecommand in progress stalled, pass it on as incomplete (the task logs and discards it).
+        if (now_ms - UART_telecommand_last_write_time_ms > UART_telecommand_incomplete_timeout_ms) {
+            UART_telecommand_send_frame_in_progress();
+        }
+        UART_telecommand_last_write_time_ms = now_ms;
+
+        uint8_t rx_chunk[32];
+        uint16_t rx_chunk_len;
+        while ((rx_chunk_len = UART_dma_ring_read(&UART_telecommand_rx_ring, rx_chunk, sizeof(rx_chunk))) > 0) {
+            for (uint16_t i = 0; i < rx_chunk_len; i++) {
+                UART_telecommand_add_rx_byte(rx_chunk[i]);
             }
+        }
+    }
+
+    else if (huart->Instance == UART_eps_port_handle->Instance) {
+        if (UART_dma_ring_on_rx_event(&UART_eps_rx_ring, Size) == 0) {
+            return;
+        }
+
+        if (! UART_eps_is_expecting_data) {
+            // Not expecting data, ignore this noise.
+            UART_dma_ring_discard_all(&UART_eps_rx_ring);
+            return;
+        }
 
-            // reset to a valid index
-            UART_telecommand_buffer_write_idx = UART_telecommand_buffer_len - 1;
+        // Append to the linear response buffer that the EPS driver reads.
+        const uint16_t space_left = UART_eps_buffer_len - UART_eps_buffer_write_idx;
+        UART_eps_buffer_write_idx += UART_dma_ring_read(
+            &UART_eps_rx_ring, (uint8_t*) &UART_eps_buffer[UART_eps_buffer_write_idx], space_left // Discard volatile.
+        );
+        if (UART_dma_ring_available(&UART_eps_rx_ring) > 0) {
+            // Tracking error. Exit, with everything the way it is (stop appending).
+            UART_error_eps_error_info.handler_buffer_full_error_count++;
+            UART_dma_ring_discard_all(&UART_eps_rx_ring);
         }
+        UART_eps_last_write_time_ms = TIME_uptime_ms();
+    }
 
-        // Add the received byte to the buffer
-        UART_telecommand_buffer[UART_telecommand_buffer_write_idx++] = UART_telecommand_buffer_last_rx_byte;
-        UART_telecommand_last_write_time_ms = TIME_uptime_ms();
+    else if (huart->Instance == UART_gnss_port_handle->Instance) {
+        // The data stays in the ring until the GNSS driver or firehose storage reads it.
+        if (UART_dma_ring_on_rx_event(&UART_gnss_rx_ring, Size) > 0) {
+            UART_gnss_last_write_time_ms = TIME_uptime_ms();
+        }
+    }
 
-        // Restart reception for next byte
-        HAL_UART_Receive_IT(UART_telecommand_port_handle, (uint8_t*) &UART_telecommand_buffer_last_rx_byte, 1);
+    else {
+        // Should never be reached.
+        DEBUG_uart_print_str("HAL_UARTEx_RxEventCallback() -> unknown UART instance\n");
     }
-    else if (huart->Instance == UART_mpi_port_handle->Instance) {        
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+    // This ISR function gets called every time a byte is received on the UART.
+    // Note: The telecommand, EPS and GNSS ports use `HAL_UARTEx_RxEventCallback` instead.
+
+    if (huart->Instance == UART_mpi_port_handle->Instance) {        
         // DEBUG_uart_print_str("HAL_UART_RxCpltCallback() -> MPI Data\n");
 
         if (MPI_current_uart_rx_mode == MPI_RX_MODE_COMMAND_MODE) {
             // Command mode is blocking. Nothing to do here.
         }
         else if (MPI_current_uart_rx_mode == MPI_RX_MODE_SENSING_MODE) {
-            // Pointer to copy the data to
-            volatile uint8_t *write_ptr = NULL; // Pointer to volatile buffer.
-
-            // Decide which buffer to fill
-            if (
-                (UART_MPI_science_buffer_index < 20480)
-                && (MPI_buffer_one_state == MPI_MEMORY_WRITE_STATUS_READY_TO_FILL)
-            ) {
-                write_ptr = &MPI_science_buffer_one[UART_MPI_science_buffer_index];
-            } 
-            else if (
-                (UART_MPI_science_buffer_index < 40960)
-                && (MPI_buffer_two_state == MPI_MEMORY_WRITE_STATUS_READY_TO_FILL)
-            ) {
-                write_ptr = &MPI_science_buffer_two[UART_MPI_science_buffer_index - MPI_science_buffer_len];
+            // The DMA transfer just filled a ring buffer (or the discard buffer, if every buffer is
+            // awaiting its write). Restart it on the next one right away: the USART's RX FIFO holds
+            // the bytes which arrive in the meantime.
+            const uint8_t buffer_filled = MPI_science_ring_on_dma_complete_from_isr(TIME_uptime_ms());
+            UART_mpi_start_science_rx_dma();
+
+            if (buffer_filled) {
+                TASK_service_write_mpi_data_wake_from_isr();
             }
             else {
                 UART_error_mpi_error_info.handler_buffer_full_error_count++;
-                MPI_science_data_bytes_lost += UART_mpi_rx_dma_buffer_len;
-
-                // DEBUG_uart_print_str("MPI Full ISR - Data too fast!\n");
-            }
-
-            // Once decided, copy the data to large buffer
-            if (write_ptr != NULL) {
-                // Volatile-safe: memcpy(write_ptr, UART_mpi_rx_dma_buffer, UART_mpi_rx_dma_buffer_len);
-                for (uint16_t i = 0; i < UART_mpi_rx_dma_buffer_len; i++) {
-                    write_ptr[i] = UART_mpi_rx_dma_buffer[i];
-                }
-                UART_MPI_science_buffer_index += UART_mpi_rx_dma_buffer_len;
-
-                // When a buffer is filled, mark it as such.
-                // Reset the write index when needed. Identify the time it was fully filled.
-                if (UART_MPI_science_buffer_index == MPI_science_buffer_len) {
-                    MPI_buffer_one_state = MPI_MEMORY_WRITE_STATUS_AWAITING_WRITE;
-                    MPI_buffer_one_last_filled_uptime_ms = TIME_uptime_ms();
-                }
-                else if (UART_MPI_science_buffer_index == (2 * MPI_science_buffer_len)) {
-                    MPI_buffer_two_state = MPI_MEMORY_WRITE_STATUS_AWAITING_WRITE;
-                    MPI_buffer_two_last_filled_uptime_ms = TIME_uptime_ms();
-                    UART_MPI_science_buffer_index = 0;
-                }
+                MPI_science_data_bytes_lost += MPI_SCIENCE_RING_DISCARD_BUFFER_SIZE_BYTES;
             }
         }
         else {
@@ -229,7 +281,13 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
         if (rx == KISS_FEND) {
             if (kiss_in_frame && kiss_decode_len > 0) {
                 // Queue completed frame
-                kiss_enqueue_frame(kiss_decode_buf, kiss_decode_len);
+                kiss_decode_frame.uptime_at_rx_ms = TIME_uptime_ms();
+                if (UART_send_frame_to_message_buffer_from_isr(
+                    AX100_kiss_rx_message_buffer, &kiss_decode_frame, kiss_decode_len
+                ) != 0) {
+                    // Tracking error
+                    UART_error_ax100_error_info.handler_buffer_full_error_count++;
+                }
             }
     
             // Start new frame
@@ -252,7 +310,7 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
                 kiss_escaped = 1;
             } else {
                 if (kiss_decode_len < AX100_MAX_KISS_FRAME_SIZE_BYTES) {
-                    kiss_decode_buf[kiss_decode_len++] = rx;
+                    kiss_decode_frame.data[kiss_decode_len++] = rx;
                 } else {
                     // Frame too long - discard
                     kiss_in_frame = 0;
@@ -267,63 +325,6 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
         HAL_UART_Receive_IT(UART_ax100_port_handle, (uint8_t*) &UART_ax100_buffer_last_rx_byte, 1);
     }
 
-    
-    else if (huart->Instance == UART_eps_port_handle->Instance) {
-        // DEBUG_uart_print_str("HAL_UART_RxCpltCallback() -> EPS Data\n");
-
-        if (! UART_eps_is_expecting_data) {
-            // Not expecting data, ignore this noise.
-            // Intentionally re-enable the interrupt though, because the EPS is quite important,
-            // and is deemed reliable over UART. Not too worried about spurious interrupts.
-            HAL_UART_Receive_IT(UART_eps_port_handle, (uint8_t*) &UART_eps_buffer_last_rx_byte, 1);
-            return;
-        }
-
-        if (UART_eps_buffer_write_idx >= UART_eps_buffer_len) {
-            // Tracking error
-            UART_error_eps_error_info.handler_buffer_full_error_count++;
-            // DEBUG_uart_print_str("HAL_UART_RxCpltCallback() -> UART EPS buffer is full\n");
-
-            HAL_UART_Receive_IT(UART_eps_port_handle, (uint8_t*) &UART_eps_buffer_last_rx_byte, 1);
-            // Exit, with everything the way it is (stop appending)
-            return;
-        }
-
-        // Add the byte to the buffer
-        UART_eps_buffer[UART_eps_buffer_write_idx++] = UART_eps_buffer_last_rx_byte;
-        UART_eps_last_write_time_ms = TIME_uptime_ms();
-
-        // Restart reception for next byte
-        HAL_UART_Receive_IT(UART_eps_port_handle, (uint8_t*) &UART_eps_buffer_last_rx_byte, 1);
-    }
-
-    else if (huart->Instance == UART_gnss_port_handle->Instance) {
-        // Note: If the GNSS is not enabled, the interrupt is not re-enabled via HAL_UART_Receive_IT().
-        // This is a safety feature against the GNSS spamming null bytes, which can lock up the system.
-        if (UART_gnss_uart_interrupt_enabled == 1) {
-            // Add the byte to the buffer
-            if (UART_gnss_buffer_write_idx >= UART_gnss_buffer_len) {
-                // Tracking error
-                UART_error_gnss_error_info.handler_buffer_full_error_count++;
-                GNSS_firehose_bytes_lost++;
-                DEBUG_uart_print_str("HAL_UART_RxCpltCallback() -> UART gnss buffer is full\n");
-                
-                // Shift all bytes left by 1
-                for (uint16_t i = 1; i < UART_gnss_buffer_len; i++) {
-                    UART_gnss_buffer[i - 1] = UART_gnss_buffer[i];
-                }
-
-                // Reset to a valid index
-                UART_gnss_buffer_write_idx = UART_gnss_buffer_len - 1;
-            }
-
-            UART_gnss_buffer[UART_gnss_buffer_write_idx++] = UART_gnss_buffer_last_rx_byte;
-            UART_gnss_last_write_time_ms = TIME_uptime_ms();
-
-            HAL_UART_Receive_IT(UART_gnss_port_handle, (uint8_t*) &UART_gnss_buffer_last_rx_byte, 1);
-        }
-        
-    }
 
     else if (huart->Instance == UART_camera_port_handle->Instance) {
         if (CAMERA_uart_half_2_state == CAMERA_UART_WRITE_STATE_HALF_FILLED_WAITING_FS_WRITE) {
@@ -376,7 +377,7 @@ void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart) {
         // DEBUG_uart_print_str("Half callback being called!");
 
         if (MPI_current_uart_rx_mode == MPI_RX_MODE_SENSING_MODE) {
-            // Current not being used - data already in buffer.
+            // Not used. The science data is handled a whole buffer at a time.
         }
         else {
             DEBUG_uart_print_str("MPI Half ISR - Received MPI Data, rx_mode != SENSING though!\n");
@@ -385,24 +386,24 @@ void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart) {
 }
 
 
-/// @brief Sets the UART interrupt state (enabled/disabled)
-/// @param new_enabled 1: enable interrupt; 0: disable interrupt
+/// @brief Sets the UART reception state (enabled/disabled)
+/// @param new_enabled 1: start circular-DMA reception; 0: stop it
 /// @note This function must be called very carefully. This type of GNSS is known to, in the wrong
-///       mode, spam null bytes, which can lock up the entire system. Thus, the interrupt is disabled
+///       mode, spam null bytes, which can lock up the entire system. Thus, reception is disabled
 ///       by default, and must be enabled explicitly by the GNSS telecommands.
 /// @note Function is idempotent. Calling it when already in the desired state is a no-op.
+/// @note Enabling discards anything left unread in `UART_gnss_rx_ring`.
 void GNSS_set_uart_interrupt_state(uint8_t new_enabled) {
     if (new_enabled) {
         if (!UART_gnss_uart_interrupt_enabled) {
             UART_gnss_uart_interrupt_enabled = 1;
-            HAL_UART_Receive_IT(UART_gnss_port_handle, (uint8_t*) &UART_gnss_buffer_last_rx_byte, 1);
+            UART_start_dma_ring_reception(UART_gnss_port_handle, &UART_gnss_rx_ring);
         }
     }
     else {
         UART_gnss_uart_interrupt_enabled = 0;
-        // The interrupt is re-registered inside the ISR by calling `HAL_UART_Receive_IT` again.
-        // No need to disable the HAL interrupt here - the ISR will trigger one last time, do a no-op
-        // (guarded by if-statement), then not re-enable the interrupt.
+        // Stops the DMA and the IDLE interrupt. Unlike byte-by-byte reception, nothing re-arms it.
+        HAL_UART_AbortReceive(UART_gnss_port_handle);
     }
 }
 
@@ -426,20 +427,52 @@ uint8_t CAMERA_set_expecting_data(uint8_t new_enabled) {
     return 0;
 }
 
+/// @brief Start a DMA transfer of MPI science data into the science ring's current target.
+/// @note The DMA is in normal (not circular) mode: each transfer is restarted on the next buffer by
+///     `HAL_UART_RxCpltCallback`.
+HAL_StatusTypeDef UART_mpi_start_science_rx_dma(void) {
+    uint16_t target_len;
+    uint8_t *target = MPI_science_ring_get_dma_target(&target_len);
+    return HAL_UART_Receive_DMA(UART_mpi_port_handle, target, target_len);
+}
+
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
     // Docs for error codes: https://community.st.com/t5/stm32-mcus-products/identifying-and-solving-uart-error/td-p/135754
     const uint32_t error_code = huart->ErrorCode;
     const uint32_t up_time_ms = TIME_uptime_ms();
-    // if the error code is no error or it has been less than 100 ms since start up, ignore
-    if ((error_code == HAL_UART_ERROR_NONE) || up_time_ms < 100) {
+    if (error_code == HAL_UART_ERROR_NONE) {
         return;
     }
 
-    UART_track_error_from_isr(huart->Instance, error_code);
+    // If it has been less than 100 ms since start up, don't track it. Still re-arm the reception
+    // below, because the HAL stops the circular-DMA ports' reception on any error.
+    if (up_time_ms >= 100) {
+        UART_track_error_from_isr(huart->Instance, error_code);
+    }
 
     // Reception Error callback for MPI UART port
     if (huart->Instance == UART_mpi_port_handle->Instance) {
-        HAL_UART_Receive_DMA(UART_mpi_port_handle, (uint8_t*)&UART_mpi_last_rx_byte, 1);
+        if (MPI_current_uart_rx_mode == MPI_RX_MODE_SENSING_MODE) {
+            // Keep what the stopped transfer received: complete the buffer with its partial
+            // contents, and restart on the next one. Bytes received into the discard buffer are lost.
+            uint16_t target_len;
+            MPI_science_ring_get_dma_target(&target_len);
+            const uint16_t remaining_len = __HAL_DMA_GET_COUNTER(huart->hdmarx);
+            const uint16_t received_len = (remaining_len <= target_len) ? (target_len - remaining_len) : 0;
+            const uint32_t buffers_filled_before = MPI_science_ring_stats.buffers_filled;
+            MPI_science_ring_complete_partial(received_len, up_time_ms);
+            UART_mpi_start_science_rx_dma();
+
+            if (MPI_science_ring_stats.buffers_filled != buffers_filled_before) {
+                TASK_service_write_mpi_data_wake_from_isr();
+            }
+            else {
+                MPI_science_data_bytes_lost += received_len;
+            }
+        }
+        else {
+            HAL_UART_Receive_DMA(UART_mpi_port_handle, (uint8_t*)&UART_mpi_last_rx_byte, 1);
+        }
     }
 
     // Reception Error callback for AX100 UART port
@@ -448,12 +481,18 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
     }
 
     // Reception Error callback for GNSS UART port
+    // Note: The HAL stops DMA reception on any RX error, so it must be restarted.
     if (huart->Instance == UART_gnss_port_handle->Instance) {
         if (UART_gnss_uart_interrupt_enabled == 1) {
-            HAL_UART_Receive_IT(UART_gnss_port_handle, (uint8_t*)&UART_gnss_buffer_last_rx_byte, 1);
+            UART_start_dma_ring_reception(UART_gnss_port_handle, &UART_gnss_rx_ring);
         }
     }
 
+    // Reception Error callback for telecommand UART port
+    if (huart->Instance == UART_telecommand_port_handle->Instance) {
+        UART_start_dma_ring_reception(UART_telecommand_port_handle, &UART_telecommand_rx_ring);
+    }
+
     // Reception Error callback for CAMERA UART port
     if (huart->Instance == UART_camera_port_handle->Instance) {
         // Do not re-enable the interrupt here. Afraid of negative feedback loop.
@@ -462,22 +501,70 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
     // Reception Error callback for EPS UART port
     if (huart->Instance == UART_eps_port_handle->Instance) {
         // We trust the EPS. Always re-enable the interrupt.
-        HAL_UART_Receive_IT(UART_eps_port_handle, (uint8_t*)&UART_eps_buffer_last_rx_byte, 1);
+        UART_start_dma_ring_reception(UART_eps_port_handle, &UART_eps_rx_ring);
     }
 }
 
 /// @brief Enable the UART interrupts for always-enabled systems.
 /// @note Should be called very early in system init. Called in `main.c`.
 void UART_init_uart_handlers(void) {
+    // Create the message buffers before any RX interrupt can use them.
+    UART_telecommand_rx_message_buffer = xMessageBufferCreateStatic(
+        UART_TELECOMMAND_RX_MESSAGE_BUFFER_SIZE,
+        UART_telecommand_rx_message_buffer_storage,
+        &UART_telecommand_rx_message_buffer_struct
+    );
+    AX100_kiss_rx_message_buffer = xMessageBufferCreateStatic(
+        AX100_KISS_RX_MESSAGE_BUFFER_SIZE,
+        AX100_kiss_rx_message_buffer_storage,
+        &AX100_kiss_rx_message_buffer_struct
+    );
+
+    UART_dma_ring_init(&UART_telecommand_rx_ring, UART_telecommand_dma_buffer, sizeof(UART_telecommand_dma_buffer));
+    UART_dma_ring_init(&UART_eps_rx_ring, UART_eps_dma_buffer, sizeof(UART_eps_dma_buffer));
+    UART_dma_ring_init(&UART_gnss_rx_ring, UART_gnss_dma_buffer, sizeof(UART_gnss_dma_buffer));
+
     // Fear: What if transients cause spam/noise on the telecommand UART? OBC has a pull-up
     // resistor on this floating line, so it is fine to be enabled for "fly-as-you-test" purposes.
-    HAL_UART_Receive_IT(UART_telecommand_port_handle, (uint8_t*) &UART_telecommand_buffer_last_rx_byte, 1);
+    UART_start_dma_ring_reception(UART_telecommand_port_handle, &UART_telecommand_rx_ring);
 
     // Enable the always-on UARTs.
-    HAL_UART_Receive_IT(UART_eps_port_handle, (uint8_t*) &UART_eps_buffer_last_rx_byte, 1);
+    UART_start_dma_ring_reception(UART_eps_port_handle, &UART_eps_rx_ring);
     HAL_UART_Receive_IT(UART_ax100_port_handle, (uint8_t*) &UART_ax100_buffer_last_rx_byte, 1);
 
     // GNSS is not initialized as always-listening. It is enabled by the GNSS telecommands.
     // Reason: The GNSS has a mode where it spams null bytes, which can lock up the entire system.
-    // Thus, its interrupt is disabled by default.
+    // Thus, its reception is disabled by default.
+}
+
+/// @brief Block until a telecommand frame is received on the umbilical UART, or until the timeout.
+/// @param frame_out Output; the received frame.
+/// @param timeout_ms Max time to wait. Use `UINT32_MAX` to wait forever.
+/// @return Number of bytes in `frame_out->data`, or 0 on timeout.
+/// @note A frame ending in '!' is a complete telecommand. Any other frame is an incomplete
+///     telecommand (reception stalled for 100 ms, or it was too long).
+uint16_t UART_receive_telecommand_frame(UART_telecommand_rx_frame_t *frame_out, uint32_t timeout_ms) {
+    const size_t message_len = xMessageBufferReceive(
+        UART_telecommand_rx_message_buffer, frame_out, sizeof(UART_telecommand_rx_frame_t),
+        (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms)
+    );
+    if (message_len < sizeof(uint32_t)) {
+        return 0;
+    }
+    return message_len - sizeof(uint32_t);
+}
+
+/// @brief Block until a KISS frame is received from the AX100, or until the timeout.
+/// @param frame_out Output; the received frame, with the KISS framing and escaping removed.
+/// @param timeout_ms Max time to wait. Use `UINT32_MAX` to wait forever.
+/// @return Number of bytes in `frame_out->data`, or 0 on timeout.
+uint16_t UART_receive_ax100_kiss_frame(AX100_kiss_frame_struct_t *frame_out, uint32_t timeout_ms) {
+    const size_t message_len = xMessageBufferReceive(
+        AX100_kiss_rx_message_buffer, frame_out, sizeof(AX100_kiss_frame_struct_t),
+        (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms)
+    );
+    if (message_len < sizeof(uint32_t)) {
+        return 0;
+    }
+    return message_len - sizeof(uint32_t);
 }
@@ -1,6 +1,9 @@
 #include "telecommand_exec/telecommand_args_helpers.h"
 #include "unit_tests/unit_test_helpers.h"
 
+#include <stdio.h>
+#include <string.h>
+
 uint8_t TEST_EXEC__TCMD_ascii_to_uint64() {
     uint64_t result;
 
@@ -206,4 +209,90 @@ uint8_t TEST_EXEC__TCMD_extract_int64_arg() {
     TEST_ASSERT_TRUE(TCMD_extract_int64_arg("", 0, 0, &output_val));
 
     return 0;
-}
\ No newline at end of file
+}
+
+uint8_t TEST_EXEC__TCMD_tokenize_args() {
+    TCMD_args_t args;
+
+    // Nominal: offsets and lengths of each argument, including empty ones.
+    const char str[] = "12,abc,,-4";
+    TCMD_tokenize_args(str, strlen(str), &args);
+    TEST_ASSERT(args.arg_count == 4);
+    TEST_ASSERT(args.arg_start[0] == 0 && args.arg_len[0] == 2);
+    TEST_ASSERT(args.arg_start[1] == 3 && args.arg_len[1] == 3);
+    TEST_ASSERT(args.arg_start[2] == 7 && args.arg_len[2] == 0);
+    TEST_ASSERT(args.arg_start[3] == 8 && args.arg_len[3] == 2);
+
+    // Empty string: no arguments.
+    TCMD_tokenize_args("", 0, &args);
+    TEST_ASSERT(args.arg_count == 0);
+
+    // Trailing comma: the last argument is empty.
+    TCMD_tokenize_args("5,", 2, &args);
+    TEST_ASSERT(args.arg_count == 2);
+    TEST_ASSERT(args.arg_len[1] == 0);
+
+    // More arguments than are stored in the table: later ones are still found.
+    char long_str[128] = {0};
+    for (uint8_t i = 0; i < 40; i++) {
+        snprintf(&long_str[strlen(long_str)], sizeof(long_str) - strlen(long_str), "%s%u", i ? "," : "", i);
+    }
+    TCMD_tokenize_args(long_str, strlen(long_str), &args);
+    TEST_ASSERT(args.arg_count == 40);
+    uint64_t result;
+    TEST_ASSERT(TCMD_args_get_uint64(&args, 31, &result) == 0);
+    TEST_ASSERT(result == 31);
+    TEST_ASSERT(TCMD_args_get_uint64(&args, 32, &result) == 0);
+    TEST_ASSERT(result == 32);
+    TEST_ASSERT(TCMD_args_get_uint64(&args, 39, &result) == 0);
+    TEST_ASSERT(result == 39);
+    TEST_ASSERT(TCMD_args_get_uint64(&args, 40, &result) == 2);
+
+    return 0;
+}
+
+uint8_t TEST_EXEC__TCMD_args_get_accessors() {
+    TCMD_args_t args;
+    const char str[] = " file.txt ,42,-7,3.5,0A0B, aGk=";
+    TCMD_tokenize_args(str, strlen(str), &args);
+    TEST_ASSERT(args.arg_count == 6);
+
+    char string_result[16];
+    TEST_ASSERT(TCMD_args_get_string(&args, 0, string_result, sizeof(string_result)) == 0);
+    TEST_ASSERT(strcmp(string_result, "file.txt") == 0);
+    // Error: too long for the result buffer (checked before trimming).
+    TEST_ASSERT(TCMD_args_get_string(&args, 0, string_result, 10) == 3);
+
+    uint64_t u64_result;
+    TEST_ASSERT(TCMD_args_get_uint64(&args, 1, &u64_result) == 0);
+    TEST_ASSERT(u64_result == 42);
+    TEST_ASSERT(TCMD_args_get_uint64(&args, 2, &u64_result) == 3);
+
+    int64_t i64_result;
+    TEST_ASSERT(TCMD_args_get_int64(&args, 2, &i64_result) == 0);
+    TEST_ASSERT(i64_result == -7);
+
+    double double_result;
+    TEST_ASSERT(TCMD_args_get_double(&args, 3, &double_result) == 0);
+    TEST_ASSERT(double_result == 3.5);
+
+    uint8_t bytes_result[4];
+    uint16_t bytes_len;
+    TEST_ASSERT(TCMD_args_get_hex_array(&args, 4, bytes_result, sizeof(bytes_result), &bytes_len) == 0);
+    TEST_ASSERT(bytes_len == 2 && bytes_result[0] == 0x0A && bytes_result[1] == 0x0B);
+
+    TEST_ASSERT(TCMD_args_get_base64_array(&args, 5, bytes_result, sizeof(bytes_result), &bytes_len) == 0);
+    TEST_ASSERT(bytes_len == 2 && bytes_result[0] == 'h' && bytes_result[1] == 'i');
+
+    // Error: not enough arguments, with each accessor's error code.
+    TEST_ASSERT(TCMD_args_get_uint64(&args, 6, &u64_result) == 2);
+    TEST_ASSERT(TCMD_args_get_string(&args, 6, string_result, sizeof(string_result)) == 2);
+    TEST_ASSERT(TCMD_args_get_hex_array(&args, 6, bytes_result, sizeof(bytes_result), &bytes_len) == 11);
+
+    // Error: empty args string.
+    TCMD_tokenize_args("", 0, &args);
+    TEST_ASSERT(TCMD_args_get_uint64(&args, 0, &u64_result) == 1);
+    TEST_ASSERT(TCMD_args_get_base64_array(&args, 0, bytes_result, sizeof(bytes_result), &bytes_len) == 10);
+
+    return 0;
+}
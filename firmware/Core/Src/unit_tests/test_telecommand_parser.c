@@ -44,6 +44,40 @@ uint8_t TEST_EXEC__TCMD_check_starts_with_device_id() {
     return 0;
 }
 
+uint8_t TEST_EXEC__TCMD_get_telecommand_idx_by_name() {
+    // The generated name index must be a sorted permutation of the table (checked in CI by
+    // `firmware_checks/_04_check_tcmd_name_index.py`).
+    TEST_ASSERT(TCMD_telecommand_name_sorted_idx_count == TCMD_NUM_TELECOMMANDS);
+    for (int16_t i = 1; i < TCMD_telecommand_name_sorted_idx_count; i++) {
+        TEST_ASSERT(strcmp(
+            TCMD_telecommand_definitions[TCMD_telecommand_name_sorted_idx[i - 1]].tcmd_name,
+            TCMD_telecommand_definitions[TCMD_telecommand_name_sorted_idx[i]].tcmd_name
+        ) < 0);
+    }
+
+    // Every name is found at its own index.
+    for (int16_t tcmd_idx = 0; tcmd_idx < TCMD_NUM_TELECOMMANDS; tcmd_idx++) {
+        const char *tcmd_name = TCMD_telecommand_definitions[tcmd_idx].tcmd_name;
+        TEST_ASSERT(TCMD_get_telecommand_idx_by_name(tcmd_name, strlen(tcmd_name)) == tcmd_idx);
+    }
+
+    // Not null-terminated.
+    TEST_ASSERT(TCMD_get_telecommand_idx_by_name("hello_world(", 11) >= 0);
+
+    // Prefixes, extensions, and case mismatches are not found.
+    TEST_ASSERT(TCMD_get_telecommand_idx_by_name("hello_worl", 10) == -1);
+    TEST_ASSERT(TCMD_get_telecommand_idx_by_name("hello_worldx", 12) == -1);
+    TEST_ASSERT(TCMD_get_telecommand_idx_by_name("HELLO_WORLD", 11) == -1);
+    TEST_ASSERT(TCMD_get_telecommand_idx_by_name("", 0) == -1);
+
+    // Via the full parser entry point.
+    TEST_ASSERT(TCMD_parse_telecommand_get_index("CTS1+hello_world()!", 19) == TCMD_get_telecommand_idx_by_name("hello_world", 11));
+    TEST_ASSERT(TCMD_parse_telecommand_get_index("CTS1+not_a_real_tcmd()!", 23) == -1);
+    TEST_ASSERT(TCMD_parse_telecommand_get_index("CTS1+()!", 8) == -1);
+
+    return 0;
+}
+
 uint8_t TEST_EXEC__TCMD_get_suffix_tag_uint64() {
     uint8_t result_err = 0;
     uint64_t result_val = 0;
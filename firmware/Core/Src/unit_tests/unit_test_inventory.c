@@ -54,6 +54,11 @@ const TEST_Definition_t TEST_definitions[] = {
         .test_file = "telecommands/telecommand_parser",
         .test_func_name = "TCMD_check_starts_with_device_id"
     },
+    {
+        .test_func = TEST_EXEC__TCMD_get_telecommand_idx_by_name,
+        .test_file = "telecommands/telecommand_parser",
+        .test_func_name = "TCMD_get_telecommand_idx_by_name"
+    },
     {
         .test_func = TEST_EXEC__TCMD_process_suffix_tag_sha256,
         .test_file = "telecommands/telecommand_parser",
@@ -531,6 +536,16 @@ const TEST_Definition_t TEST_definitions[] = {
         .test_file = "telecommands/telecommand_args_helpers",
         .test_func_name = "TCMD_extract_int64_arg"
     },
+    {
+        .test_func = TEST_EXEC__TCMD_tokenize_args,
+        .test_file = "telecommands/telecommand_args_helpers",
+        .test_func_name = "TCMD_tokenize_args"
+    },
+    {
+        .test_func = TEST_EXEC__TCMD_args_get_accessors,
+        .test_file = "telecommands/telecommand_args_helpers",
+        .test_func_name = "TCMD_args_get_accessors"
+    },
     {
         .test_func = TEST_EXEC__OBC_TEMP_SENSOR_configure_precision_values,
         .test_file = "temperature_sensor/obc_temperature_sensor_driver",
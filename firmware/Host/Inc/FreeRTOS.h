@@ -0,0 +1,18 @@
+// FreeRTOS.h (host simulation build)
+// Only the heap API is used by the portable modules (littlefs, heatshrink), so it is mapped onto
+// the C library heap.
+
+#ifndef INCLUDE_GUARD__HOST_FREERTOS_H__
+#define INCLUDE_GUARD__HOST_FREERTOS_H__
+
+#include <stdlib.h>
+
+static inline void *pvPortMalloc(size_t xWantedSize) {
+    return malloc(xWantedSize);
+}
+
+static inline void vPortFree(void *pv) {
+    free(pv);
+}
+
+#endif // INCLUDE_GUARD__HOST_FREERTOS_H__
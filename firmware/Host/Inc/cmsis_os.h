@@ -0,0 +1,29 @@
+// cmsis_os.h (host simulation build)
+// Minimal stand-in for the CMSIS-RTOS v2 API subset used by the portable firmware modules.
+
+#ifndef INCLUDE_GUARD__HOST_CMSIS_OS_H__
+#define INCLUDE_GUARD__HOST_CMSIS_OS_H__
+
+#include <stdint.h>
+
+typedef void *osThreadId_t;
+typedef void *osMutexId_t;
+
+typedef struct {
+    const char *name;
+    uint32_t stack_size;
+    int32_t priority;
+} osThreadAttr_t;
+
+typedef enum {
+    osOK = 0,
+    osError = -1,
+} osStatus_t;
+
+// Implemented in `Host/Src/host_hal_stubs.c`, on the calling thread. There is no scheduler on the
+// host build, so `osThreadYield()` is a `sched_yield()`, and ticks are milliseconds.
+osStatus_t osDelay(uint32_t ticks);
+osStatus_t osThreadYield(void);
+uint32_t osKernelGetTickCount(void);
+
+#endif // INCLUDE_GUARD__HOST_CMSIS_OS_H__
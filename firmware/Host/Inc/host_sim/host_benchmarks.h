@@ -0,0 +1,51 @@
+#ifndef INCLUDE_GUARD__HOST_BENCHMARKS_H__
+#define INCLUDE_GUARD__HOST_BENCHMARKS_H__
+
+#include <stdint.h>
+
+/// @brief A benchmark (or self-test) which can be run from the host simulation command line.
+/// @note Each function returns 0 on success, and >0 on failure (e.g., a failed correctness check).
+typedef struct {
+    const char *bench_name;
+    uint8_t (*bench_func)(void);
+    const char *description;
+} HOST_benchmark_t;
+
+void HOST_BENCH_print_nand_stats(const char label[]);
+uint8_t HOST_BENCH_reformat_filesystem(void);
+
+uint8_t HOST_BENCH_nand_emulator_self_test(void);
+uint8_t HOST_BENCH_lfs_write_read(void);
+uint8_t HOST_BENCH_lfs_chip_layouts(void);
+uint8_t HOST_BENCH_lfs_grow_from_single_chip(void);
+uint8_t HOST_BENCH_lfs_bad_blocks(void);
+uint8_t HOST_BENCH_lfs_page_cache(void);
+uint8_t HOST_BENCH_flash_cache_read(void);
+uint8_t HOST_BENCH_flash_busy_wait(void);
+
+uint8_t HOST_BENCH_agenda_tick(void);
+uint8_t HOST_BENCH_agenda_order(void);
+uint8_t HOST_BENCH_tssent_dedup(void);
+uint8_t HOST_BENCH_agenda_arena(void);
+uint8_t HOST_BENCH_agenda_file_loader(void);
+
+uint8_t HOST_BENCH_tcmd_name_lookup(void);
+uint8_t HOST_BENCH_tcmd_args_tokenizer(void);
+
+uint8_t HOST_BENCH_uart_dma_ring_firehose(void);
+
+uint8_t HOST_BENCH_log_queue(void);
+uint8_t HOST_BENCH_log_binary(void);
+
+uint8_t HOST_BENCH_bulk_downlink_compressed(void);
+uint8_t HOST_BENCH_bulk_downlink_selective_repeat(void);
+uint8_t HOST_BENCH_bulk_downlink_prefetch(void);
+uint8_t HOST_BENCH_ax100_tx_pacing(void);
+uint8_t HOST_BENCH_ax100_tx_dma(void);
+uint8_t HOST_BENCH_lfs_dir_listing(void);
+uint8_t HOST_BENCH_tcmd_resp_store(void);
+uint8_t HOST_BENCH_sha256(void);
+uint8_t HOST_BENCH_mpi_science_ring(void);
+uint8_t HOST_BENCH_mpi_frame_index(void);
+
+#endif // INCLUDE_GUARD__HOST_BENCHMARKS_H__
@@ -0,0 +1,25 @@
+#ifndef INCLUDE_GUARD__HOST_HAL_STUBS_H__
+#define INCLUDE_GUARD__HOST_HAL_STUBS_H__
+
+#include <stdint.h>
+
+/// @brief Counters for the transfers made through a class of peripheral.
+typedef struct {
+    uint32_t transfer_count;
+    uint64_t byte_count;
+} HOST_peripheral_counters_t;
+
+extern HOST_peripheral_counters_t HOST_i2c_counters;
+extern HOST_peripheral_counters_t HOST_uart_counters;
+extern uint32_t HOST_i2c_transfer_us_per_byte;
+extern uint32_t HOST_i2c_dma_error_transfer_count;
+extern uint32_t HOST_i2c_abort_duration_us;
+extern volatile uint32_t HOST_i2c_abort_count;
+
+extern uint8_t HOST_umbilical_uart_to_stdout_enabled;
+
+uint8_t HOST_hal_init(void);
+
+uint64_t HOST_get_monotonic_time_us(void);
+
+#endif // INCLUDE_GUARD__HOST_HAL_STUBS_H__
@@ -0,0 +1,56 @@
+#ifndef INCLUDE_GUARD__HOST_NAND_EMULATOR_H__
+#define INCLUDE_GUARD__HOST_NAND_EMULATOR_H__
+
+#include <stdint.h>
+
+#include "littlefs/flash_driver.h"
+
+// Number of blocks in each emulated chip (1024 blocks of 64 pages of 2048 bytes = 128 MiB).
+#define HOST_NAND_BLOCKS_PER_CHIP (FLASH_CHIP_SIZE_BYTES / FLASH_CHIP_BLOCK_SIZE_BYTES)
+
+// Size of the spare area after each page. Only the bad block marker (its first byte) is stored;
+// the rest reads back as 0xFF.
+#define HOST_NAND_SPARE_AREA_SIZE_BYTES 128
+
+/// @brief Timing model for the emulated chips, in microseconds (MT29F1G01 datasheet typicals).
+/// @note The SPI transfer time is modelled separately from the byte count and SPI clock.
+typedef struct {
+    uint32_t page_read_to_cache_us; // tRD
+    uint32_t cache_read_busy_us; // tRCBSY: moving a loaded page to the cache, in cache read mode
+    uint32_t page_program_us; // tPROG
+    uint32_t block_erase_us; // tBERS
+    uint32_t spi_clock_hz; // SPI1 SCK (16 MHz HSI / prescaler 2, on the flight hardware)
+} HOST_NAND_timing_model_t;
+
+/// @brief Per-chip operation counters, for benchmarks.
+typedef struct {
+    uint32_t page_read_count;
+
+    /// @brief Number of page reads served in cache read mode (page load overlapped with SPI).
+    uint32_t cache_read_page_count;
+
+    uint32_t page_program_count;
+    uint32_t block_erase_count;
+    uint64_t bytes_read;
+    uint64_t bytes_programmed;
+
+    /// @brief Number of programs which tried to flip a bit from 0 to 1 (i.e., program without erase).
+    uint32_t program_without_erase_count;
+
+    /// @brief Total time the chip (plus its SPI transfers) would have been busy on the flight hardware.
+    uint64_t modelled_busy_us;
+} HOST_NAND_chip_stats_t;
+
+extern HOST_NAND_timing_model_t HOST_NAND_timing_model;
+
+uint8_t HOST_NAND_init(const char image_file_path[]);
+void HOST_NAND_deinit(void);
+
+void HOST_NAND_reset_stats(void);
+const HOST_NAND_chip_stats_t *HOST_NAND_get_chip_stats(uint8_t chip_number);
+void HOST_NAND_get_total_stats(HOST_NAND_chip_stats_t *total_stats_out);
+
+uint8_t HOST_NAND_set_block_bad(uint8_t chip_number, uint32_t block_num, uint8_t is_bad);
+uint8_t HOST_NAND_set_block_worn(uint8_t chip_number, uint32_t block_num, uint8_t is_worn);
+
+#endif // INCLUDE_GUARD__HOST_NAND_EMULATOR_H__
@@ -0,0 +1,101 @@
+// stm32l4xx_hal.h (host simulation build)
+// Minimal stand-in for the STM32 HAL, so that the portable firmware modules (and the real `main.h`)
+// compile on a Linux host. Only the types/functions used by the modules in `Makefile.host.mk` are
+// declared here. The implementations are in `Host/Src/host_hal_stubs.c`.
+
+#ifndef INCLUDE_GUARD__HOST_STM32L4XX_HAL_H__
+#define INCLUDE_GUARD__HOST_STM32L4XX_HAL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    HAL_OK = 0x00,
+    HAL_ERROR = 0x01,
+    HAL_BUSY = 0x02,
+    HAL_TIMEOUT = 0x03,
+} HAL_StatusTypeDef;
+
+typedef enum {
+    HAL_I2C_STATE_RESET = 0x00,
+    HAL_I2C_STATE_READY = 0x20,
+    HAL_I2C_STATE_BUSY_TX = 0x21,
+    HAL_I2C_STATE_ABORT = 0x60,
+} HAL_I2C_StateTypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+/// @brief Host stand-in for all peripheral handles. Only the peripheral's name is tracked.
+typedef struct {
+    const char *host_peripheral_name;
+} HOST_peripheral_handle_t;
+
+typedef HOST_peripheral_handle_t ADC_HandleTypeDef;
+typedef HOST_peripheral_handle_t I2C_HandleTypeDef;
+typedef HOST_peripheral_handle_t UART_HandleTypeDef;
+typedef HOST_peripheral_handle_t SPI_HandleTypeDef;
+typedef HOST_peripheral_handle_t TIM_HandleTypeDef;
+typedef HOST_peripheral_handle_t DMA_HandleTypeDef;
+
+typedef struct {
+    uint32_t host_port_index;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef HOST_gpio_ports[8];
+#define GPIOA (&HOST_gpio_ports[0])
+#define GPIOB (&HOST_gpio_ports[1])
+#define GPIOC (&HOST_gpio_ports[2])
+#define GPIOD (&HOST_gpio_ports[3])
+#define GPIOE (&HOST_gpio_ports[4])
+#define GPIOF (&HOST_gpio_ports[5])
+#define GPIOG (&HOST_gpio_ports[6])
+#define GPIOH (&HOST_gpio_ports[7])
+
+#define GPIO_PIN_0  ((uint16_t)0x0001)
+#define GPIO_PIN_1  ((uint16_t)0x0002)
+#define GPIO_PIN_2  ((uint16_t)0x0004)
+#define GPIO_PIN_3  ((uint16_t)0x0008)
+#define GPIO_PIN_4  ((uint16_t)0x0010)
+#define GPIO_PIN_5  ((uint16_t)0x0020)
+#define GPIO_PIN_6  ((uint16_t)0x0040)
+#define GPIO_PIN_7  ((uint16_t)0x0080)
+#define GPIO_PIN_8  ((uint16_t)0x0100)
+#define GPIO_PIN_9  ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+// CMSIS core: the active exception number (0 in thread mode). There are no interrupts on the host.
+static inline uint32_t __get_IPSR(void) {
+    return 0;
+}
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay_ms);
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+HAL_StatusTypeDef HAL_UART_Transmit(
+    UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout
+);
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(
+    I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout
+);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(
+    I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size
+);
+HAL_StatusTypeDef HAL_I2C_Master_Abort_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress);
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_AbortCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+#endif // INCLUDE_GUARD__HOST_STM32L4XX_HAL_H__
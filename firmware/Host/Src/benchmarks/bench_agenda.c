@@ -0,0 +1,669 @@
+// bench_agenda.c
+// Host benchmarks and self-tests for the telecommand agenda (`telecommand_executor.c`).
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "host_sim/host_nand_emulator.h"
+#include "config/configuration.h"
+#include "littlefs/littlefs_helper.h"
+#include "telecommand_exec/agenda_from_file.h"
+#include "telecommand_exec/agenda_string_arena.h"
+#include "telecommand_exec/telecommand_executor.h"
+#include "telecommands/lfs_telecommand_defs.h"
+#include "timekeeping/timekeeping.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_BENCH_AGENDA_TICK_ITERATIONS 100000
+
+// From `telecommand_executor.c` (not in its header, as nothing else should touch them).
+extern uint64_t TCMD_timestamp_sent_store[TCMD_TIMESTAMP_RECORD_SIZE];
+extern uint16_t TCMD_timestamp_sent_used_slots;
+
+// Unique tssent values for every telecommand enqueued by these benchmarks, so that none are
+// rejected as replays.
+static uint64_t HOST_BENCH_agenda_next_tssent = 1000000000000ULL;
+
+static uint32_t HOST_BENCH_agenda_lcg_state = 12345;
+
+static uint32_t HOST_BENCH_agenda_rand(void) {
+    HOST_BENCH_agenda_lcg_state = (HOST_BENCH_agenda_lcg_state * 1103515245) + 12345;
+    return HOST_BENCH_agenda_lcg_state >> 8;
+}
+
+static void HOST_BENCH_agenda_delete_all(void) {
+    for (uint16_t slot_num = 0; slot_num < TCMD_AGENDA_SIZE; slot_num++) {
+        TCMD_agenda_delete_slot(slot_num);
+    }
+}
+
+static uint8_t HOST_BENCH_agenda_enqueue(uint64_t timestamp_to_execute) {
+    TCMD_parsed_tcmd_to_execute_t parsed_tcmd;
+    memset(&parsed_tcmd, 0, sizeof(parsed_tcmd));
+    parsed_tcmd.tcmd_idx = 0;
+    parsed_tcmd.timestamp_sent = HOST_BENCH_agenda_next_tssent++;
+    parsed_tcmd.timestamp_to_execute = timestamp_to_execute;
+    return TCMD_add_tcmd_to_agenda(&parsed_tcmd);
+}
+
+/// @brief The executor tick and beacon cost before the agenda heap: a full scan of the slots for
+///     the next-due entry, plus a full scan to count the pending entries.
+static int32_t HOST_BENCH_agenda_linear_scan_tick(uint64_t current_timestamp_ms) {
+    int32_t earliest_slot_num = -1;
+    uint64_t earliest_timestamp = UINT64_MAX;
+    uint16_t count = 0;
+    for (uint16_t slot_num = 0; slot_num < TCMD_AGENDA_SIZE; slot_num++) {
+        if (TCMD_agenda_is_valid[slot_num] == TCMD_AGENDA_ENTRY_INVALID) {
+            continue;
+        }
+        count++;
+        if (
+            (TCMD_agenda[slot_num].timestamp_to_execute < earliest_timestamp)
+            && (TCMD_agenda[slot_num].timestamp_to_execute <= current_timestamp_ms)
+        ) {
+            earliest_slot_num = slot_num;
+            earliest_timestamp = TCMD_agenda[slot_num].timestamp_to_execute;
+        }
+    }
+    return earliest_slot_num + count;
+}
+
+/// @brief Time one executor tick (next-due lookup) plus one beacon (pending count) with
+///     0, half, and all of the agenda slots filled with not-yet-due telecommands.
+uint8_t HOST_BENCH_agenda_tick(void) {
+    const uint16_t queued_counts[] = {0, TCMD_AGENDA_SIZE / 2, TCMD_AGENDA_SIZE};
+    const uint64_t future_timestamp_ms = TIME_get_current_unix_epoch_time_ms() + (24 * 3600 * 1000);
+
+    for (uint8_t i = 0; i < sizeof(queued_counts) / sizeof(queued_counts[0]); i++) {
+        const uint16_t queued_count = queued_counts[i];
+        HOST_BENCH_agenda_delete_all();
+
+        const uint64_t enqueue_start_us = HOST_get_monotonic_time_us();
+        for (uint16_t j = 0; j < queued_count; j++) {
+            if (HOST_BENCH_agenda_enqueue(future_timestamp_ms + (HOST_BENCH_agenda_rand() % 100000)) != 0) {
+                printf("  FAIL: enqueue %u of %u\n", j, queued_count);
+                return 1;
+            }
+        }
+        const uint64_t enqueue_us = HOST_get_monotonic_time_us() - enqueue_start_us;
+
+        if (TCMD_get_agenda_used_slots_count() != queued_count) {
+            printf("  FAIL: pending count %u, expected %u\n", TCMD_get_agenda_used_slots_count(), queued_count);
+            return 1;
+        }
+
+        volatile int32_t sink = 0;
+        const uint64_t tick_start_us = HOST_get_monotonic_time_us();
+        for (uint32_t iter = 0; iter < HOST_BENCH_AGENDA_TICK_ITERATIONS; iter++) {
+            sink += TCMD_get_next_tcmd_agenda_slot_to_execute();
+            sink += TCMD_get_agenda_used_slots_count();
+        }
+        const uint64_t tick_us = HOST_get_monotonic_time_us() - tick_start_us;
+
+        const uint64_t now_ms = TIME_get_current_unix_epoch_time_ms();
+        const uint64_t scan_start_us = HOST_get_monotonic_time_us();
+        for (uint32_t iter = 0; iter < HOST_BENCH_AGENDA_TICK_ITERATIONS; iter++) {
+            sink += HOST_BENCH_agenda_linear_scan_tick(now_ms);
+        }
+        const uint64_t scan_us = HOST_get_monotonic_time_us() - scan_start_us;
+        (void)sink;
+
+        printf(
+            "  queued=%3u: tick=%7.1f ns (linear scan: %7.1f ns), enqueue=%6.1f ns/tcmd\n",
+            queued_count,
+            (double)tick_us * 1000.0 / HOST_BENCH_AGENDA_TICK_ITERATIONS,
+            (double)scan_us * 1000.0 / HOST_BENCH_AGENDA_TICK_ITERATIONS,
+            (queued_count > 0) ? ((double)enqueue_us * 1000.0 / queued_count) : 0.0
+        );
+    }
+
+    // The agenda is full now. The next telecommand must be rejected, without overwriting any entry.
+    if (HOST_BENCH_agenda_enqueue(0) != 1) {
+        printf("  FAIL: enqueue into a full agenda was not rejected\n");
+        return 1;
+    }
+    if (TCMD_get_agenda_used_slots_count() != TCMD_AGENDA_SIZE) {
+        printf("  FAIL: full agenda changed size to %u\n", TCMD_get_agenda_used_slots_count());
+        return 1;
+    }
+    for (uint16_t slot_num = 0; slot_num < TCMD_AGENDA_SIZE; slot_num++) {
+        if (TCMD_agenda[slot_num].timestamp_to_execute == 0) {
+            printf("  FAIL: slot %u was overwritten in a full agenda\n", slot_num);
+            return 1;
+        }
+    }
+
+    HOST_BENCH_agenda_delete_all();
+    return 0;
+}
+
+/// @brief Check that due telecommands come out of the agenda by tsexec, then in the order they
+///     were received (for tsexec ties), including after deletions from the middle.
+uint8_t HOST_BENCH_agenda_order(void) {
+    HOST_BENCH_agenda_delete_all();
+
+    // All due (tsexec between 0 and now), with many ties.
+    const uint64_t now_ms = TIME_get_current_unix_epoch_time_ms();
+    for (uint16_t i = 0; i < TCMD_AGENDA_SIZE; i++) {
+        if (HOST_BENCH_agenda_enqueue((now_ms * (HOST_BENCH_agenda_rand() % 50)) / 50) != 0) {
+            printf("  FAIL: enqueue %u\n", i);
+            return 1;
+        }
+    }
+
+    // Delete every third slot, to exercise removal from the middle of the heap.
+    uint16_t expected_count = TCMD_AGENDA_SIZE;
+    for (uint16_t slot_num = 0; slot_num < TCMD_AGENDA_SIZE; slot_num += 3) {
+        if (TCMD_agenda_delete_slot(slot_num) != 0) {
+            printf("  FAIL: delete slot %u\n", slot_num);
+            return 1;
+        }
+        expected_count--;
+    }
+    if (TCMD_agenda_delete_slot(0) == 0) {
+        printf("  FAIL: deleted an already-deleted slot\n");
+        return 1;
+    }
+    if (TCMD_get_agenda_used_slots_count() != expected_count) {
+        printf("  FAIL: pending count %u, expected %u\n", TCMD_get_agenda_used_slots_count(), expected_count);
+        return 1;
+    }
+
+    // Drain. tssent increases with insertion order, so it breaks ties.
+    uint64_t prev_tsexec = 0;
+    uint64_t prev_tssent = 0;
+    uint16_t drained_count = 0;
+    while (1) {
+        const int16_t slot_num = TCMD_get_next_tcmd_agenda_slot_to_execute();
+        if (slot_num < 0) {
+            break;
+        }
+        const uint64_t tsexec = TCMD_agenda[slot_num].timestamp_to_execute;
+        const uint64_t tssent = TCMD_agenda[slot_num].timestamp_sent;
+        if ((tsexec < prev_tsexec) || ((tsexec == prev_tsexec) && (tssent < prev_tssent))) {
+            printf("  FAIL: out of order at entry %u (slot %d)\n", drained_count, slot_num);
+            return 1;
+        }
+        prev_tsexec = tsexec;
+        prev_tssent = tssent;
+        TCMD_agenda_delete_slot(slot_num);
+        drained_count++;
+    }
+    if ((drained_count != expected_count) || (TCMD_get_agenda_used_slots_count() != 0)) {
+        printf("  FAIL: drained %u of %u\n", drained_count, expected_count);
+        return 1;
+    }
+
+    // Future telecommands are not due yet.
+    HOST_BENCH_agenda_enqueue(now_ms + 3600000);
+    const int16_t not_due_slot_num = TCMD_get_next_tcmd_agenda_slot_to_execute();
+    HOST_BENCH_agenda_delete_all();
+    if (not_due_slot_num != -1) {
+        printf("  FAIL: future telecommand reported as due\n");
+        return 1;
+    }
+
+    printf("  %u telecommands drained in order\n", drained_count);
+    return 0;
+}
+
+/// @brief The tssent duplicate check before the hash set: a scan of the whole tssent ring.
+static uint8_t HOST_BENCH_tssent_linear_scan_is_recorded(uint64_t timestamp_sent) {
+    for (uint32_t i = 0; i < TCMD_timestamp_sent_used_slots; i++) {
+        if (timestamp_sent == TCMD_timestamp_sent_store[i]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#define HOST_BENCH_TSSENT_DEDUP_FILE_NAME "bench_agenda_replay.txt"
+
+/// @brief Replay a full agenda file twice (like the periodic agenda-file reload), with duplicate
+///     tssent rejection enabled, and compare the hash set against the old linear scan.
+uint8_t HOST_BENCH_tssent_dedup(void) {
+    const char file_name[] = HOST_BENCH_TSSENT_DEDUP_FILE_NAME;
+    const uint16_t tcmd_count = TCMD_TIMESTAMP_RECORD_SIZE;
+    const uint64_t first_tssent = HOST_BENCH_agenda_next_tssent;
+    const uint64_t future_timestamp_ms = TIME_get_current_unix_epoch_time_ms() + (24 * 3600 * 1000);
+
+    HOST_BENCH_agenda_delete_all();
+    LFS_delete_file(file_name);
+    for (uint16_t i = 0; i < tcmd_count; i++) {
+        char line[96];
+        const int line_len = snprintf(
+            line, sizeof(line), "CTS1+fs_list_directory(/,0,20)@tssent=%llu@tsexec=%llu!\n",
+            (unsigned long long)(first_tssent + i), (unsigned long long)future_timestamp_ms
+        );
+        if (LFS_append_file(file_name, (uint8_t *)line, line_len) != 0) {
+            printf("  FAIL: write agenda file\n");
+            return 1;
+        }
+    }
+    HOST_BENCH_agenda_next_tssent += tcmd_count;
+
+    const uint32_t prev_require_unique_tssent = TCMD_require_unique_tssent;
+    TCMD_require_unique_tssent = 1;
+    uint8_t result = 0;
+
+    uint64_t load_us[2];
+    uint16_t pending_after_load[2];
+    for (uint8_t load_num = 0; load_num < 2; load_num++) {
+        const uint64_t start_us = HOST_get_monotonic_time_us();
+        TCMD_parse_tcmds_from_file_and_enqueue(file_name, 0, UINT64_MAX, UINT16_MAX);
+        load_us[load_num] = HOST_get_monotonic_time_us() - start_us;
+        pending_after_load[load_num] = TCMD_get_agenda_used_slots_count();
+    }
+    if ((pending_after_load[0] != tcmd_count) || (pending_after_load[1] != tcmd_count)) {
+        printf(
+            "  FAIL: pending after first load=%u, after replay=%u, expected %u\n",
+            pending_after_load[0], pending_after_load[1], tcmd_count
+        );
+        result = 1;
+    }
+
+    // Isolate the duplicate check itself, with the ring full.
+    volatile uint32_t found_count_hash = 0;
+    volatile uint32_t found_count_linear = 0;
+    const uint64_t hash_start_us = HOST_get_monotonic_time_us();
+    for (uint16_t i = 0; i < tcmd_count; i++) {
+        found_count_hash += TCMD_timestamp_sent_is_recorded(first_tssent + i);
+    }
+    const uint64_t hash_us = HOST_get_monotonic_time_us() - hash_start_us;
+    const uint64_t linear_start_us = HOST_get_monotonic_time_us();
+    for (uint16_t i = 0; i < tcmd_count; i++) {
+        found_count_linear += HOST_BENCH_tssent_linear_scan_is_recorded(first_tssent + i);
+    }
+    const uint64_t linear_us = HOST_get_monotonic_time_us() - linear_start_us;
+    if ((found_count_hash != tcmd_count) || (found_count_linear != tcmd_count)) {
+        printf("  FAIL: found %u (hash), %u (linear) of %u\n", found_count_hash, found_count_linear, tcmd_count);
+        result = 1;
+    }
+
+    printf(
+        "  %u tcmds: first load %.1f ms, replay (all duplicates) %.1f ms\n",
+        tcmd_count, (double)load_us[0] / 1000.0, (double)load_us[1] / 1000.0
+    );
+    printf(
+        "  duplicate check per tcmd: hash set %.1f ns, linear scan %.1f ns\n",
+        (double)hash_us * 1000.0 / tcmd_count, (double)linear_us * 1000.0 / tcmd_count
+    );
+
+    // A full ring's worth of new telecommands evicts every tssent from the file.
+    HOST_BENCH_agenda_delete_all();
+    for (uint16_t i = 0; i < TCMD_TIMESTAMP_RECORD_SIZE; i++) {
+        HOST_BENCH_agenda_enqueue(future_timestamp_ms);
+    }
+    HOST_BENCH_agenda_delete_all();
+    for (uint16_t i = 0; i < tcmd_count; i++) {
+        if (TCMD_timestamp_sent_is_recorded(first_tssent + i)) {
+            printf("  FAIL: tssent %u of the file not evicted\n", i);
+            result = 1;
+            break;
+        }
+    }
+    if (!TCMD_timestamp_sent_is_recorded(HOST_BENCH_agenda_next_tssent - 1)) {
+        printf("  FAIL: latest tssent not recorded\n");
+        result = 1;
+    }
+
+    TCMD_require_unique_tssent = prev_require_unique_tssent;
+    LFS_delete_file(file_name);
+    LFS_delete_file(HOST_BENCH_TSSENT_DEDUP_FILE_NAME TCMD_AGENDA_FILE_INDEX_SUFFIX);
+    return result;
+}
+
+/// @brief Fill the string arena past its end with a mix of arg lengths, deleting entries in
+///     between to force compaction, and check that every entry's strings survive. Then execute
+///     one entry from the agenda.
+/// @brief Fill the agenda with max-length entries: exactly `TCMD_ARENA_MIN_ENTRY_COUNT` must fit,
+///     the next one must be rejected as "arena full" (without recording its tssent), and short
+///     entries must still fit in what's left.
+static uint8_t HOST_BENCH_agenda_arena_check_max_length_limit(uint64_t timestamp_to_execute) {
+    HOST_BENCH_agenda_delete_all();
+
+    TCMD_parsed_tcmd_to_execute_t parsed_tcmd;
+    memset(&parsed_tcmd, 0, sizeof(parsed_tcmd));
+    memset(parsed_tcmd.args_str_no_parens, 'a', TCMD_ARGS_STR_NO_PARENS_SIZE - 1);
+    memset(parsed_tcmd.resp_fname, 'r', TCMD_MAX_RESP_FNAME_LEN - 1);
+    parsed_tcmd.timestamp_to_execute = timestamp_to_execute;
+
+    uint16_t max_length_count = 0;
+    uint8_t add_result = 0;
+    while (add_result == 0) {
+        parsed_tcmd.timestamp_sent = HOST_BENCH_agenda_next_tssent++;
+        add_result = TCMD_add_tcmd_to_agenda(&parsed_tcmd);
+        if (add_result == 0) {
+            max_length_count++;
+        }
+    }
+    printf(
+        "  max-length entries: %u fit (documented minimum %u, %u slots)\n",
+        max_length_count, TCMD_ARENA_MIN_ENTRY_COUNT, TCMD_AGENDA_SIZE
+    );
+    if ((add_result != 2) || (max_length_count != TCMD_ARENA_MIN_ENTRY_COUNT)) {
+        printf("  FAIL: expected %u max-length entries then result 2, got result %u\n",
+            TCMD_ARENA_MIN_ENTRY_COUNT, add_result);
+        return 1;
+    }
+    if (TCMD_timestamp_sent_is_recorded(parsed_tcmd.timestamp_sent)) {
+        printf("  FAIL: tssent of the rejected entry was recorded\n");
+        return 1;
+    }
+
+    // The space left after the max-length entries still takes short ones.
+    if (HOST_BENCH_agenda_enqueue(timestamp_to_execute) != 0) {
+        printf("  FAIL: short entry rejected after the max-length ones\n");
+        return 1;
+    }
+    HOST_BENCH_agenda_delete_all();
+    return 0;
+}
+
+uint8_t HOST_BENCH_agenda_arena(void) {
+    HOST_BENCH_agenda_delete_all();
+    const uint64_t future_timestamp_ms = TIME_get_current_unix_epoch_time_ms() + (24 * 3600 * 1000);
+
+    // The expected args of each slot, regenerated from (slot_num, tssent) when checking.
+    char args_str[TCMD_ARGS_STR_NO_PARENS_SIZE];
+    char resp_fname[TCMD_MAX_RESP_FNAME_LEN];
+    uint32_t inserted_count = 0;
+    uint32_t rejected_count = 0;
+    const uint32_t compactions_before = TCMD_arena_compaction_count;
+
+    for (uint32_t round = 0; round < 20000; round++) {
+        // Delete a random pending entry half the time, once it's at least half full.
+        if ((TCMD_get_agenda_used_slots_count() > TCMD_AGENDA_SIZE / 2) && (HOST_BENCH_agenda_rand() % 2)) {
+            TCMD_agenda_delete_slot(HOST_BENCH_agenda_rand() % TCMD_AGENDA_SIZE);
+            continue;
+        }
+
+        TCMD_parsed_tcmd_to_execute_t parsed_tcmd;
+        memset(&parsed_tcmd, 0, sizeof(parsed_tcmd));
+        parsed_tcmd.timestamp_sent = HOST_BENCH_agenda_next_tssent++;
+        parsed_tcmd.timestamp_to_execute = future_timestamp_ms;
+        // Mostly short args (like most telecommands), and sometimes max-length ones.
+        const uint16_t args_len = (HOST_BENCH_agenda_rand() % 10 == 0)
+            ? (TCMD_ARGS_STR_NO_PARENS_SIZE - 1)
+            : (HOST_BENCH_agenda_rand() % 40);
+        for (uint16_t i = 0; i < args_len; i++) {
+            parsed_tcmd.args_str_no_parens[i] = 'a' + ((parsed_tcmd.timestamp_sent + i) % 26);
+        }
+        snprintf(parsed_tcmd.resp_fname, sizeof(parsed_tcmd.resp_fname), "resp_%llu.txt",
+            (unsigned long long)parsed_tcmd.timestamp_sent);
+
+        const uint8_t add_result = TCMD_add_tcmd_to_agenda(&parsed_tcmd);
+        if (add_result == 0) {
+            inserted_count++;
+        }
+        else if ((add_result == 1) || (add_result == 2)) {
+            rejected_count++;
+        }
+        else {
+            printf("  FAIL: add returned %u\n", add_result);
+            return 1;
+        }
+    }
+
+    for (uint16_t slot_num = 0; slot_num < TCMD_AGENDA_SIZE; slot_num++) {
+        if (TCMD_agenda_is_valid[slot_num] != TCMD_AGENDA_ENTRY_VALID_AND_PENDING) {
+            continue;
+        }
+        const uint64_t tssent = TCMD_agenda[slot_num].timestamp_sent;
+        snprintf(resp_fname, sizeof(resp_fname), "resp_%llu.txt", (unsigned long long)tssent);
+        const char *stored_args_str = TCMD_arena_get_args_str(slot_num);
+        const size_t args_len = strlen(stored_args_str);
+        for (size_t i = 0; i < args_len; i++) {
+            args_str[i] = 'a' + ((tssent + i) % 26);
+        }
+        args_str[args_len] = '\0';
+        if (
+            (strcmp(stored_args_str, args_str) != 0)
+            || (strcmp(TCMD_arena_get_resp_fname(slot_num), resp_fname) != 0)
+        ) {
+            printf("  FAIL: slot %u strings corrupted\n", slot_num);
+            return 1;
+        }
+    }
+
+    printf(
+        "  inserted=%u rejected_when_full=%u compactions=%u live=%u/%u bytes, pending=%u\n",
+        inserted_count, rejected_count, TCMD_arena_compaction_count - compactions_before,
+        TCMD_arena_get_live_bytes(), TCMD_ARENA_SIZE_BYTES, TCMD_get_agenda_used_slots_count()
+    );
+    printf(
+        "  agenda memory: %zu bytes (was %zu with inline strings)\n",
+        sizeof(TCMD_agenda) + TCMD_ARENA_SIZE_BYTES,
+        sizeof(TCMD_parsed_tcmd_to_execute_t) * TCMD_AGENDA_SIZE
+    );
+    if (TCMD_arena_compaction_count == compactions_before) {
+        printf("  FAIL: arena never compacted\n");
+        return 1;
+    }
+
+    // Execute an entry from the agenda, which copies its strings out of the arena first.
+    // (Its telecommand may be unavailable in the host build; only the executor itself is checked.)
+    HOST_BENCH_agenda_delete_all();
+    HOST_BENCH_agenda_enqueue(0);
+    const int16_t slot_num = TCMD_get_next_tcmd_agenda_slot_to_execute();
+    char response_output_buf[256] = {0};
+    if (
+        (slot_num < 0)
+        || (TCMD_execute_telecommand_in_agenda(slot_num, response_output_buf, sizeof(response_output_buf)) >= 253)
+        || (strlen(response_output_buf) == 0)
+    ) {
+        printf("  FAIL: execute from agenda\n");
+        return 1;
+    }
+    if ((TCMD_get_agenda_used_slots_count() != 0) || (TCMD_arena_get_live_bytes() != 0)) {
+        printf("  FAIL: executed entry not freed\n");
+        return 1;
+    }
+
+    return HOST_BENCH_agenda_arena_check_max_length_limit(future_timestamp_ms);
+}
+
+#define HOST_BENCH_AGENDA_FILE_TCMD_COUNT (3 * 24 * 60) // One per minute, for 3 days.
+#define HOST_BENCH_AGENDA_FILE_TCMD_SPACING_MS (60 * 1000)
+#define HOST_BENCH_AGENDA_FILE_WINDOW_COUNT 200
+
+// Arbitrary, but after the host epoch time, so that the windows are all in the future.
+static const uint64_t HOST_BENCH_agenda_file_start_ms = 1800000000000ULL;
+
+/// @brief Write an agenda file with one telecommand per `HOST_BENCH_AGENDA_FILE_TCMD_SPACING_MS`.
+/// @param tsexec_order_swaps If nonzero, swap the tsexec of every Nth pair of lines (unsorted file).
+static uint8_t HOST_BENCH_write_agenda_file(const char file_name[], uint16_t tcmd_count, uint16_t tsexec_order_swaps) {
+    LFS_delete_file(file_name);
+    char chunk[4096];
+    uint32_t chunk_len = 0;
+    for (uint16_t i = 0; i < tcmd_count; i++) {
+        uint16_t tsexec_idx = i;
+        if ((tsexec_order_swaps != 0) && ((i / 2) % tsexec_order_swaps == 0)) {
+            tsexec_idx = (i % 2 == 0) ? (i + 1) : (i - 1);
+        }
+        chunk_len += snprintf(
+            &chunk[chunk_len], sizeof(chunk) - chunk_len,
+            "CTS1+fs_list_directory(/logs/pass_%05u,0,20)@tssent=%llu@tsexec=%llu!\n",
+            i, (unsigned long long)(HOST_BENCH_agenda_next_tssent++),
+            (unsigned long long)(HOST_BENCH_agenda_file_start_ms + (uint64_t)tsexec_idx * HOST_BENCH_AGENDA_FILE_TCMD_SPACING_MS)
+        );
+        if ((chunk_len > sizeof(chunk) - 128) || (i == tcmd_count - 1)) {
+            if (LFS_append_file(file_name, (uint8_t *)chunk, chunk_len) != 0) {
+                printf("  FAIL: write agenda file\n");
+                return 1;
+            }
+            chunk_len = 0;
+        }
+    }
+    return 0;
+}
+
+/// @brief Run consecutive enqueue windows like `subtask_enqueue_tcmds_from_agenda_file` does,
+///     starting a day into the agenda file.
+/// @param enqueued_per_window Output; number of telecommands enqueued in each window.
+static void HOST_BENCH_run_agenda_file_windows(
+    const char file_name[], uint16_t enqueued_per_window[],
+    uint64_t *total_us, uint64_t *total_bytes_read
+) {
+    const uint64_t interval_ms = 45000;
+    const uint64_t grace_period_ms = 15000;
+    uint64_t now_ms = HOST_BENCH_agenda_file_start_ms + (24 * 3600 * 1000);
+    uint64_t last_max_ms = now_ms;
+
+    HOST_NAND_reset_stats();
+    *total_us = 0;
+    for (uint16_t window = 0; window < HOST_BENCH_AGENDA_FILE_WINDOW_COUNT; window++) {
+        const uint64_t max_ms = now_ms + interval_ms + grace_period_ms;
+        const uint16_t pending_before = TCMD_get_agenda_used_slots_count();
+
+        const uint64_t start_us = HOST_get_monotonic_time_us();
+        TCMD_parse_tcmds_from_file_and_enqueue(file_name, last_max_ms, max_ms, 100);
+        *total_us += HOST_get_monotonic_time_us() - start_us;
+
+        enqueued_per_window[window] = TCMD_get_agenda_used_slots_count() - pending_before;
+        HOST_BENCH_agenda_delete_all();
+        last_max_ms = max_ms;
+        now_ms += interval_ms;
+    }
+
+    HOST_NAND_chip_stats_t stats;
+    HOST_NAND_get_total_stats(&stats);
+    *total_bytes_read = stats.bytes_read;
+}
+
+/// @brief Load a 3-day agenda file in 45 s windows (like the background upkeep task), with and
+///     without the agenda file index, and check that both enqueue the same telecommands. Then
+///     check that appending to the file rebuilds the index, and that an unsorted file still loads.
+uint8_t HOST_BENCH_agenda_file_loader(void) {
+    const char file_name[] = "bench_agenda_multiday.txt";
+    const char index_file_name[] = "bench_agenda_multiday.txt" TCMD_AGENDA_FILE_INDEX_SUFFIX;
+    static uint16_t enqueued_full_scan[HOST_BENCH_AGENDA_FILE_WINDOW_COUNT];
+    static uint16_t enqueued_indexed[HOST_BENCH_AGENDA_FILE_WINDOW_COUNT];
+    const uint32_t prev_use_index = TCMD_agenda_file_use_index;
+    uint8_t result = 0;
+
+    HOST_BENCH_agenda_delete_all();
+    if (HOST_BENCH_write_agenda_file(file_name, HOST_BENCH_AGENDA_FILE_TCMD_COUNT, 0) != 0) {
+        return 1;
+    }
+    const lfs_ssize_t file_size = LFS_file_size(file_name, 0);
+
+    uint64_t full_scan_us, full_scan_bytes_read;
+    TCMD_agenda_file_use_index = 0;
+    HOST_BENCH_run_agenda_file_windows(file_name, enqueued_full_scan, &full_scan_us, &full_scan_bytes_read);
+
+    TCMD_agenda_file_use_index = 1;
+    const uint64_t build_start_us = HOST_get_monotonic_time_us();
+    if (TCMD_agenda_file_build_index(file_name) != 0) {
+        printf("  FAIL: build index\n");
+        TCMD_agenda_file_use_index = prev_use_index;
+        return 1;
+    }
+    const uint64_t build_us = HOST_get_monotonic_time_us() - build_start_us;
+    const uint32_t build_count_before_windows = TCMD_agenda_file_index_state.index_build_count;
+
+    uint64_t indexed_us, indexed_bytes_read;
+    HOST_BENCH_run_agenda_file_windows(file_name, enqueued_indexed, &indexed_us, &indexed_bytes_read);
+
+    uint32_t total_enqueued = 0;
+    for (uint16_t window = 0; window < HOST_BENCH_AGENDA_FILE_WINDOW_COUNT; window++) {
+        total_enqueued += enqueued_indexed[window];
+        if (enqueued_indexed[window] != enqueued_full_scan[window]) {
+            printf(
+                "  FAIL: window %u enqueued %u (indexed) vs %u (full scan)\n",
+                window, enqueued_indexed[window], enqueued_full_scan[window]
+            );
+            result = 1;
+            break;
+        }
+    }
+    // 200 windows of 45 s, one telecommand per minute.
+    if ((total_enqueued < 145) || (total_enqueued > 155)) {
+        printf("  FAIL: enqueued %lu telecommands over the windows\n", (unsigned long)total_enqueued);
+        result = 1;
+    }
+    if (TCMD_agenda_file_index_state.index_build_count != build_count_before_windows) {
+        printf("  FAIL: index rebuilt during the windows\n");
+        result = 1;
+    }
+
+    printf(
+        "  %u tcmds (%ld bytes, index %ld bytes), index build %.1f ms\n",
+        HOST_BENCH_AGENDA_FILE_TCMD_COUNT, (long)file_size, (long)LFS_file_size(index_file_name, 0),
+        (double)build_us / 1000.0
+    );
+    printf(
+        "  %u windows, %lu enqueued: full scan %.2f ms/window, %lu KiB flash read/window\n",
+        HOST_BENCH_AGENDA_FILE_WINDOW_COUNT, (unsigned long)total_enqueued,
+        (double)full_scan_us / 1000.0 / HOST_BENCH_AGENDA_FILE_WINDOW_COUNT,
+        (unsigned long)(full_scan_bytes_read / 1024 / HOST_BENCH_AGENDA_FILE_WINDOW_COUNT)
+    );
+    printf(
+        "  %*s indexed   %.2f ms/window, %lu KiB flash read/window\n",
+        (int)strlen("200 windows, 150 enqueued:") - 1, "",
+        (double)indexed_us / 1000.0 / HOST_BENCH_AGENDA_FILE_WINDOW_COUNT,
+        (unsigned long)(indexed_bytes_read / 1024 / HOST_BENCH_AGENDA_FILE_WINDOW_COUNT)
+    );
+
+    // Appending to the agenda file must make the index stale, and the new telecommand loadable.
+    const uint64_t appended_tsexec_ms = HOST_BENCH_agenda_file_start_ms + (10ULL * 24 * 3600 * 1000);
+    char line[128];
+    const int line_len = snprintf(
+        line, sizeof(line), "CTS1+fs_list_directory(/,0,20)@tssent=%llu@tsexec=%llu!\n",
+        (unsigned long long)(HOST_BENCH_agenda_next_tssent++), (unsigned long long)appended_tsexec_ms
+    );
+    LFS_append_file(file_name, (uint8_t *)line, line_len);
+    TCMD_parse_tcmds_from_file_and_enqueue(file_name, appended_tsexec_ms, appended_tsexec_ms + 1, 100);
+    if ((TCMD_agenda_file_index_state.index_build_count != build_count_before_windows + 1)
+        || (TCMD_get_agenda_used_slots_count() != 1)
+    ) {
+        printf("  FAIL: appended telecommand not indexed/enqueued\n");
+        result = 1;
+    }
+    HOST_BENCH_agenda_delete_all();
+
+    // A same-size edit at the head of the file (not caught by the size/tail-CRC check) through
+    // `fs_write_file_hex` must drop the index too: "pass_00000" -> "pass_99999".
+    char response[256];
+    char write_args[128];
+    snprintf(write_args, sizeof(write_args), "%s,%u,3939393939", file_name, (unsigned)strlen("CTS1+fs_list_directory(/logs/pass_"));
+    if (TCMDEXEC_fs_write_file_hex(write_args, response, sizeof(response)) != 0) {
+        printf("  FAIL: fs_write_file_hex: %s\n", response);
+        result = 1;
+    }
+    TCMD_parse_tcmds_from_file_and_enqueue(file_name, appended_tsexec_ms, appended_tsexec_ms + 1, 100);
+    if (TCMD_agenda_file_index_state.index_build_count != build_count_before_windows + 2) {
+        printf("  FAIL: index not rebuilt after an edit at the head of the agenda file\n");
+        result = 1;
+    }
+    HOST_BENCH_agenda_delete_all();
+
+    // An unsorted file is loaded through its index too, with the same result as a full scan.
+    if (HOST_BENCH_write_agenda_file(file_name, 600, 3) != 0) {
+        result = 1;
+    }
+    const uint64_t unsorted_min_ms = HOST_BENCH_agenda_file_start_ms + (100ULL * HOST_BENCH_AGENDA_FILE_TCMD_SPACING_MS);
+    const uint64_t unsorted_max_ms = unsorted_min_ms + (50ULL * HOST_BENCH_AGENDA_FILE_TCMD_SPACING_MS);
+    uint16_t unsorted_enqueued[2];
+    for (uint8_t use_index = 0; use_index < 2; use_index++) {
+        TCMD_agenda_file_use_index = use_index;
+        TCMD_parse_tcmds_from_file_and_enqueue(file_name, unsorted_min_ms, unsorted_max_ms, 100);
+        unsorted_enqueued[use_index] = TCMD_get_agenda_used_slots_count();
+        HOST_BENCH_agenda_delete_all();
+    }
+    if ((unsorted_enqueued[0] != 50) || (unsorted_enqueued[1] != 50)
+        || TCMD_agenda_file_index_state.header.is_sorted
+    ) {
+        printf(
+            "  FAIL: unsorted file enqueued %u (full scan), %u (indexed), expected 50\n",
+            unsorted_enqueued[0], unsorted_enqueued[1]
+        );
+        result = 1;
+    }
+
+    TCMD_agenda_file_use_index = prev_use_index;
+    LFS_delete_file(file_name);
+    LFS_delete_file(index_file_name);
+    return result;
+}
@@ -0,0 +1,196 @@
+// bench_ax100_tx_dma.c
+// Host benchmark of sending packets to the AX100 with the blocking I2C transmit vs. DMA
+// (`AX100_tx_dma_enabled`). Packets are built in place in the TX buffers, then the sender does
+// some other work (like the bulk downlink's flash read-ahead) before waiting for the result.
+// The I2C transfer time is modelled by the HAL stubs at 100 kHz (90 us per byte).
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "main.h"
+#include "comms_drivers/ax100_tx.h"
+#include "comms_drivers/ax100_tx_pacing.h"
+#include "comms_drivers/comms_tx.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_BENCH_TX_DMA_PACKET_COUNT 40
+#define HOST_BENCH_TX_DMA_I2C_US_PER_BYTE 90
+#define HOST_BENCH_TX_DMA_OTHER_WORK_US 10000
+
+typedef struct {
+    double start_ms; // Mean time in `AX100_start_tx_buffer` (the sender is blocked).
+    double finish_ms; // Mean time in `AX100_finish_tx_buffer`.
+    double packet_ms; // Mean time per packet, including the other work.
+    uint64_t i2c_bytes;
+} HOST_BENCH_tx_dma_result_t;
+
+/// @brief Stand-in for work done while the packet is sent (busy, like reading flash).
+static void HOST_BENCH_tx_dma_other_work(void) {
+    const uint64_t start_us = HOST_get_monotonic_time_us();
+    while ((HOST_get_monotonic_time_us() - start_us) < HOST_BENCH_TX_DMA_OTHER_WORK_US) {
+    }
+}
+
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_tx_dma_run(uint8_t dma_enabled, HOST_BENCH_tx_dma_result_t *result_out) {
+    *result_out = (HOST_BENCH_tx_dma_result_t){0};
+    AX100_tx_dma_enabled = dma_enabled;
+    HOST_i2c_counters = (HOST_peripheral_counters_t){0};
+
+    double total_start_us = 0;
+    double total_finish_us = 0;
+    const uint64_t run_start_us = HOST_get_monotonic_time_us();
+    for (uint32_t i = 0; i < HOST_BENCH_TX_DMA_PACKET_COUNT; i++) {
+        COMMS_bulk_file_downlink_packet_t *packet = COMMS_acquire_bulk_file_downlink_packet();
+        if (packet == NULL) {
+            printf("  FAIL: COMMS_acquire_bulk_file_downlink_packet() -> NULL\n");
+            return 1;
+        }
+        memset(packet->data, (int)i, COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET);
+
+        const uint64_t start_us = HOST_get_monotonic_time_us();
+        const uint8_t start_result = COMMS_start_bulk_file_downlink_packet(
+            packet, COMMS_PACKET_TYPE_BULK_FILE_DOWNLINK,
+            i * COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET,
+            COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET
+        );
+        const uint64_t started_us = HOST_get_monotonic_time_us();
+
+        HOST_BENCH_tx_dma_other_work();
+
+        const uint64_t finish_start_us = HOST_get_monotonic_time_us();
+        const uint8_t finish_result = AX100_finish_tx_buffer((uint8_t *)packet);
+        total_finish_us += (double)(HOST_get_monotonic_time_us() - finish_start_us);
+        total_start_us += (double)(started_us - start_us);
+
+        if ((start_result != 0) || (finish_result != 0)) {
+            printf("  FAIL: packet %lu: start -> %u, finish -> %u\n", (unsigned long)i, start_result, finish_result);
+            return 1;
+        }
+    }
+    const double run_us = (double)(HOST_get_monotonic_time_us() - run_start_us);
+
+    result_out->start_ms = total_start_us / 1000.0 / HOST_BENCH_TX_DMA_PACKET_COUNT;
+    result_out->finish_ms = total_finish_us / 1000.0 / HOST_BENCH_TX_DMA_PACKET_COUNT;
+    result_out->packet_ms = run_us / 1000.0 / HOST_BENCH_TX_DMA_PACKET_COUNT;
+    result_out->i2c_bytes = HOST_i2c_counters.byte_count;
+
+    const uint64_t expected_bytes = (uint64_t)HOST_BENCH_TX_DMA_PACKET_COUNT * (AX100_DOWNLINK_MAX_BYTES + AX100_CSP_HEADER_LENGTH_BYTES);
+    if (result_out->i2c_bytes != expected_bytes) {
+        printf(
+            "  FAIL: %llu bytes sent over I2C, expected %llu\n",
+            (unsigned long long)result_out->i2c_bytes, (unsigned long long)expected_bytes
+        );
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Check that failures of packets sent without waiting reach the callers, and that a timed-out
+///     transfer's abort completes before I2C1 is reported idle.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_tx_dma_check_errors(void) {
+    AX100_tx_dma_enabled = 1;
+
+    // A log message packet is NACKed after `COMMS_downlink_log_message` returns.
+    const uint32_t error_count_before = AX100_tx_send_error_count;
+    HOST_i2c_dma_error_transfer_count = 1;
+    const uint8_t log_result = COMMS_downlink_log_message("NACKed log message");
+    const uint8_t flush_result = AX100_flush_tx_buffers();
+    if ((log_result != 0) || (flush_result != HAL_ERROR) || (AX100_tx_send_error_count != (error_count_before + 1))) {
+        printf(
+            "  FAIL: NACKed log message: send -> %u, flush -> %u, error count +%lu\n",
+            log_result, flush_result, (unsigned long)(AX100_tx_send_error_count - error_count_before)
+        );
+        return 1;
+    }
+
+    // The last packet of a telecommand response is NACKed.
+    char response[300];
+    memset(response, 'r', sizeof(response));
+    HOST_i2c_dma_error_transfer_count = 0;
+    const uint8_t ok_response_result = COMMS_downlink_tcmd_response(0, 0, 0, response, sizeof(response));
+    HOST_i2c_dma_error_transfer_count = 2;
+    const uint8_t nacked_response_result = COMMS_downlink_tcmd_response(0, 0, 0, response, sizeof(response));
+    HOST_i2c_dma_error_transfer_count = 0;
+    AX100_flush_tx_buffers();
+    if ((ok_response_result != 0) || (nacked_response_result == 0)) {
+        printf(
+            "  FAIL: telecommand response: -> %u, NACKed -> %u\n", ok_response_result, nacked_response_result
+        );
+        return 1;
+    }
+
+    // A transfer takes longer than the timeout, and is aborted.
+    const uint32_t original_us_per_byte = HOST_i2c_transfer_us_per_byte;
+    const uint32_t abort_count_before = HOST_i2c_abort_count;
+    HOST_i2c_transfer_us_per_byte = 1000;
+    HOST_i2c_abort_duration_us = 20000;
+    char long_log_message[COMMS_LOG_MESSAGE_PACKET_MAX_DATA_BYTES_PER_PACKET + 1];
+    memset(long_log_message, 'l', sizeof(long_log_message) - 1);
+    long_log_message[sizeof(long_log_message) - 1] = '\0';
+    const uint8_t send_result = COMMS_downlink_log_message(long_log_message);
+    AX100_wait_for_tx_idle();
+    const uint32_t abort_count_at_idle = HOST_i2c_abort_count;
+    const uint8_t timeout_result = AX100_flush_tx_buffers();
+    HOST_i2c_transfer_us_per_byte = original_us_per_byte;
+    HOST_i2c_abort_duration_us = 1000;
+    if ((send_result != 0) || (abort_count_at_idle != (abort_count_before + 1)) || (timeout_result != HAL_TIMEOUT)) {
+        printf(
+            "  FAIL: timed-out transfer: send -> %u, aborts completed at idle: %lu, flush -> %u\n",
+            send_result, (unsigned long)(abort_count_at_idle - abort_count_before), timeout_result
+        );
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t HOST_BENCH_ax100_tx_dma(void) {
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    const uint32_t original_dma_enabled = AX100_tx_dma_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+    HOST_i2c_transfer_us_per_byte = HOST_BENCH_TX_DMA_I2C_US_PER_BYTE;
+
+    HOST_BENCH_tx_dma_result_t blocking_result;
+    HOST_BENCH_tx_dma_result_t dma_result;
+    uint8_t result = HOST_BENCH_tx_dma_run(0, &blocking_result);
+    if (result == 0) {
+        result = HOST_BENCH_tx_dma_run(1, &dma_result);
+    }
+    if (result == 0) {
+        result = HOST_BENCH_tx_dma_check_errors();
+    }
+
+    HOST_i2c_transfer_us_per_byte = 0;
+    AX100_tx_pacing_reset();
+    AX100_tx_dma_enabled = original_dma_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    if (result != 0) {
+        return 1;
+    }
+
+    printf(
+        "  %u packets of %u bytes (%.1f ms over I2C each), %.0f ms of other work per packet\n",
+        HOST_BENCH_TX_DMA_PACKET_COUNT, AX100_DOWNLINK_MAX_BYTES + AX100_CSP_HEADER_LENGTH_BYTES,
+        (AX100_DOWNLINK_MAX_BYTES + AX100_CSP_HEADER_LENGTH_BYTES) * HOST_BENCH_TX_DMA_I2C_US_PER_BYTE / 1000.0,
+        HOST_BENCH_TX_DMA_OTHER_WORK_US / 1000.0
+    );
+    printf("  %-22s %10s %10s %10s\n", "", "start ms", "finish ms", "packet ms");
+    printf(
+        "  %-22s %10.3f %10.3f %10.2f\n",
+        "blocking transmit", blocking_result.start_ms, blocking_result.finish_ms, blocking_result.packet_ms
+    );
+    printf(
+        "  %-22s %10.3f %10.3f %10.2f\n",
+        "DMA", dma_result.start_ms, dma_result.finish_ms, dma_result.packet_ms
+    );
+    printf("  (start ms: sender blocked starting the send; finish ms: waiting for the result, other tasks run)\n");
+    printf("  Failures of packets sent without waiting reach the senders; aborts complete before I2C1 is idle\n");
+
+    if (dma_result.packet_ms >= blocking_result.packet_ms) {
+        printf("  FAIL: DMA didn't overlap the I2C transfer with the other work\n");
+        return 1;
+    }
+    return 0;
+}
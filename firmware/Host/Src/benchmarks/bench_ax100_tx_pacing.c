@@ -0,0 +1,190 @@
+// bench_ax100_tx_pacing.c
+// Host benchmark of the AX100 downlink pacing (`ax100_tx_pacing.c`) against the fixed
+// `COMMS_bulk_downlink_delay_per_packet_ms` delay, on a simulated clock. The simulated AX100 has a
+// queue of a few packets, sends them at its real bitrate, and NACKs I2C transfers while the queue
+// is full. The pacing model is configured for 9600 bps; the radio is run slower, at, and faster
+// than that, as if it had been reconfigured without updating `AX100_tx_bitrate_bps`.
+
+#include "host_sim/host_benchmarks.h"
+#include "comms_drivers/ax100_tx.h"
+#include "comms_drivers/ax100_tx_pacing.h"
+
+#include <stdio.h>
+
+#define HOST_BENCH_PACING_SIM_DURATION_MS (10.0 * 60.0 * 1000.0)
+
+// A full packet to the AX100 (CSP header included), and its I2C transfer at 100 kHz
+// (9 bits per byte). A NACKed transfer ends after the address byte.
+#define HOST_BENCH_PACING_PACKET_BYTES (AX100_DOWNLINK_MAX_BYTES + AX100_CSP_HEADER_LENGTH_BYTES)
+#define HOST_BENCH_PACING_I2C_MS ((double)HOST_BENCH_PACING_PACKET_BYTES * 9.0 / 100.0)
+#define HOST_BENCH_PACING_I2C_NACK_MS 0.1
+
+// Reading the next packet from the file, and scheduling.
+#define HOST_BENCH_PACING_READ_MS 0.2
+
+// The simulated AX100: packets it holds (including the one on air), and its on-air overhead.
+#define HOST_BENCH_PACING_RADIO_QUEUE_PACKETS 3
+#define HOST_BENCH_PACING_RADIO_OVERHEAD_BYTES 46
+
+#define HOST_BENCH_PACING_FIXED_DELAY_MS 208.0
+
+typedef struct {
+    double packets_per_sec;
+    double radio_utilization; // Fraction of the time the radio was on air.
+    uint32_t nack_count;
+    uint32_t wait_count;
+    uint32_t rate_scale_permille;
+    uint32_t probe_count;
+    uint32_t failed_probe_count;
+    double reported_packets_per_sec; // From `AX100_tx_pacing_get_stats`.
+} HOST_BENCH_pacing_result_t;
+
+/// @brief Run the bulk downlink task's send loop against the simulated AX100.
+static void HOST_BENCH_pacing_run(
+    uint32_t radio_bitrate_bps, uint8_t pacing_enabled, HOST_BENCH_pacing_result_t *result_out
+) {
+    *result_out = (HOST_BENCH_pacing_result_t){0};
+    AX100_tx_pacing_reset();
+
+    const double airtime_ms = (
+        (double)(HOST_BENCH_PACING_PACKET_BYTES + HOST_BENCH_PACING_RADIO_OVERHEAD_BYTES) * 8.0 * 1000.0
+        / (double)radio_bitrate_bps
+    );
+
+    // End times of the packets in the radio's queue (oldest first).
+    double queue_done_ms[HOST_BENCH_PACING_RADIO_QUEUE_PACKETS];
+    uint8_t queue_count = 0;
+
+    // Start at 1 s, so that the ms clock doesn't start at 0.
+    double now_ms = 1000.0;
+    const double end_ms = now_ms + HOST_BENCH_PACING_SIM_DURATION_MS;
+    uint32_t accepted_count = 0;
+    double on_air_ms = 0;
+    while (now_ms < end_ms) {
+        const double packet_start_ms = now_ms;
+        now_ms += HOST_BENCH_PACING_READ_MS;
+
+        // Drain the packets which have been sent.
+        while ((queue_count > 0) && (queue_done_ms[0] <= now_ms)) {
+            for (uint8_t i = 1; i < queue_count; i++) {
+                queue_done_ms[i - 1] = queue_done_ms[i];
+            }
+            queue_count--;
+        }
+
+        // Send the packet over I2C.
+        const double i2c_start_ms = now_ms;
+        const uint8_t is_accepted = (queue_count < HOST_BENCH_PACING_RADIO_QUEUE_PACKETS);
+        if (is_accepted) {
+            now_ms += HOST_BENCH_PACING_I2C_MS;
+            const double on_air_start_ms = (queue_count > 0) ? queue_done_ms[queue_count - 1] : now_ms;
+            queue_done_ms[queue_count++] = on_air_start_ms + airtime_ms;
+            if (on_air_start_ms + airtime_ms <= end_ms) {
+                accepted_count++;
+                on_air_ms += airtime_ms;
+            }
+        }
+        else {
+            now_ms += HOST_BENCH_PACING_I2C_NACK_MS;
+            result_out->nack_count++;
+        }
+        AX100_tx_pacing_record_send(
+            HOST_BENCH_PACING_PACKET_BYTES, (uint32_t)i2c_start_ms, (uint32_t)now_ms, !is_accepted
+        );
+
+        // Wait, as `TASK_bulk_downlink` does.
+        if (pacing_enabled) {
+            now_ms += (double)AX100_tx_pacing_get_wait_ms((uint32_t)now_ms);
+        }
+        else if ((now_ms - packet_start_ms) < HOST_BENCH_PACING_FIXED_DELAY_MS) {
+            now_ms = packet_start_ms + HOST_BENCH_PACING_FIXED_DELAY_MS;
+        }
+    }
+
+    AX100_tx_pacing_stats_t stats;
+    AX100_tx_pacing_get_stats((uint32_t)now_ms, &stats);
+    result_out->packets_per_sec = (double)accepted_count * 1000.0 / HOST_BENCH_PACING_SIM_DURATION_MS;
+    result_out->radio_utilization = on_air_ms / HOST_BENCH_PACING_SIM_DURATION_MS;
+    result_out->wait_count = stats.wait_count;
+    result_out->rate_scale_permille = stats.rate_scale_permille;
+    result_out->probe_count = stats.probe_count;
+    result_out->failed_probe_count = stats.failed_probe_count;
+    result_out->reported_packets_per_sec = (double)stats.achieved_packets_per_sec_x100 / 100.0;
+}
+
+static void HOST_BENCH_pacing_print_row(const char label[], const HOST_BENCH_pacing_result_t *result) {
+    printf(
+        "  %-22s %9.2f %9.2f %6.1f%% %7lu %7lu %7lu %7lu %7lu\n",
+        label,
+        result->packets_per_sec,
+        result->reported_packets_per_sec,
+        result->radio_utilization * 100.0,
+        (unsigned long)result->nack_count,
+        (unsigned long)result->wait_count,
+        (unsigned long)result->rate_scale_permille,
+        (unsigned long)result->probe_count,
+        (unsigned long)result->failed_probe_count
+    );
+}
+
+uint8_t HOST_BENCH_ax100_tx_pacing(void) {
+    const uint32_t original_bitrate_bps = AX100_tx_bitrate_bps;
+    AX100_tx_bitrate_bps = 9600;
+
+    const uint32_t radio_bitrates_bps[] = {4800, 9600, 19200};
+    const uint8_t radio_bitrate_count = sizeof(radio_bitrates_bps) / sizeof(radio_bitrates_bps[0]);
+    HOST_BENCH_pacing_result_t fixed_results[3];
+    HOST_BENCH_pacing_result_t paced_results[3];
+    for (uint8_t i = 0; i < radio_bitrate_count; i++) {
+        HOST_BENCH_pacing_run(radio_bitrates_bps[i], 0, &fixed_results[i]);
+        HOST_BENCH_pacing_run(radio_bitrates_bps[i], 1, &paced_results[i]);
+    }
+    AX100_tx_pacing_reset();
+    AX100_tx_bitrate_bps = original_bitrate_bps;
+
+    printf(
+        "  %u-byte packets, %.0f s simulated; AX100 queue of %u packets; model configured for 9600 bps\n",
+        HOST_BENCH_PACING_PACKET_BYTES, HOST_BENCH_PACING_SIM_DURATION_MS / 1000.0,
+        HOST_BENCH_PACING_RADIO_QUEUE_PACKETS
+    );
+    printf(
+        "  %-22s %9s %9s %7s %7s %7s %7s %7s %7s\n",
+        "", "pkt/s", "reported", "on air", "NACKs", "waits", "scale", "probes", "failed"
+    );
+    uint8_t result = 0;
+    for (uint8_t i = 0; i < radio_bitrate_count; i++) {
+        char label[32];
+        snprintf(label, sizeof(label), "%lu bps, fixed %.0f ms", (unsigned long)radio_bitrates_bps[i], HOST_BENCH_PACING_FIXED_DELAY_MS);
+        HOST_BENCH_pacing_print_row(label, &fixed_results[i]);
+        snprintf(label, sizeof(label), "%lu bps, paced", (unsigned long)radio_bitrates_bps[i]);
+        HOST_BENCH_pacing_print_row(label, &paced_results[i]);
+
+        if (paced_results[i].packets_per_sec < (fixed_results[i].packets_per_sec * 0.98)) {
+            printf("  FAIL: pacing is slower than the fixed delay at %lu bps\n", (unsigned long)radio_bitrates_bps[i]);
+            result = 1;
+        }
+    }
+    printf("  (reported: AX100_tx_pacing_get_stats() over the last window; scale: learned airtime / modelled, permille;\n");
+    printf("  probes: steps towards a faster rate; failed: probes undone by a stall)\n");
+
+    // Slower radio: the fixed delay overruns the queue; the model learns to back off.
+    if (paced_results[0].nack_count >= fixed_results[0].nack_count) {
+        printf("  FAIL: pacing didn't reduce NACKs from a slower radio\n");
+        result = 1;
+    }
+    // Radio as configured: the model is right, and probing for a faster rate mustn't cost more
+    // NACKs or throughput than the fixed delay (which is tuned for this bitrate).
+    if (
+        (paced_results[1].nack_count > fixed_results[1].nack_count)
+        || (paced_results[1].packets_per_sec < fixed_results[1].packets_per_sec)
+    ) {
+        printf("  FAIL: pacing is worse than the fixed delay at the configured bitrate\n");
+        result = 1;
+    }
+    // Faster radio: the fixed delay leaves the radio idle; the model learns to send faster.
+    if (paced_results[2].packets_per_sec < (fixed_results[2].packets_per_sec * 1.5)) {
+        printf("  FAIL: pacing didn't use a faster radio\n");
+        result = 1;
+    }
+    return result;
+}
@@ -0,0 +1,437 @@
+// bench_bulk_downlink_compressed.c
+// Host benchmark of the compressed bulk downlink (`COMMS_bulk_file_downlink_start_compressed`):
+// packets and airtime for typical files, raw vs. compressed, the encoder's CPU time per packet,
+// and the flash written (none, vs. compressing to a file first). Each downlinked stream is
+// decompressed and checked against the file, including after restarting a downlink mid-stream.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "host_sim/host_nand_emulator.h"
+#include "comms_drivers/bulk_file_downlink.h"
+#include "comms_drivers/comms_tx.h"
+#include "compression/heatshrink_helpers.h"
+#include "compression/heatshrink_lib/heatshrink_decoder.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES (32 * 1024)
+#define HOST_BENCH_BULK_COMPRESSED_STREAM_MAX_BYTES (HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES * 2)
+#define HOST_BENCH_BULK_COMPRESSED_WINDOW_SZ2 8
+#define HOST_BENCH_BULK_COMPRESSED_LOOKAHEAD_SZ2 4
+
+// `TASK_bulk_downlink` sends one packet per `COMMS_bulk_downlink_delay_per_packet_ms` (default).
+#define HOST_BENCH_BULK_COMPRESSED_MS_PER_PACKET 208
+
+typedef enum {
+    HOST_BENCH_BULK_COMPRESSED_FILE_LOG_TEXT = 0,
+    HOST_BENCH_BULK_COMPRESSED_FILE_JSON_TELEMETRY,
+    HOST_BENCH_BULK_COMPRESSED_FILE_GNSS_NMEA,
+    HOST_BENCH_BULK_COMPRESSED_FILE_RANDOM_BINARY,
+    HOST_BENCH_BULK_COMPRESSED_FILE_COUNT,
+} HOST_BENCH_bulk_compressed_file_enum_t;
+
+static const char *HOST_BENCH_bulk_compressed_file_paths[HOST_BENCH_BULK_COMPRESSED_FILE_COUNT] = {
+    "bulk_log.txt",
+    "bulk_telemetry.json",
+    "bulk_gnss.txt",
+    "bulk_random.bin",
+};
+
+static uint8_t HOST_BENCH_bulk_compressed_file_data[HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES];
+static uint8_t HOST_BENCH_bulk_compressed_stream[HOST_BENCH_BULK_COMPRESSED_STREAM_MAX_BYTES];
+static uint8_t HOST_BENCH_bulk_compressed_decompressed[HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES];
+
+/// @brief Fill `HOST_BENCH_bulk_compressed_file_data` with one kind of file's contents.
+static void HOST_BENCH_bulk_compressed_generate_file(HOST_BENCH_bulk_compressed_file_enum_t file_kind) {
+    char *text = (char *)HOST_BENCH_bulk_compressed_file_data;
+    const size_t size = sizeof(HOST_BENCH_bulk_compressed_file_data);
+    size_t len = 0;
+    uint32_t lcg = 12345;
+
+    for (uint32_t line_num = 0; len < size; line_num++) {
+        lcg = (lcg * 1103515245u) + 12345u;
+        const uint32_t noise = (lcg >> 16) & 0x7FFF;
+        int line_len = 0;
+        switch (file_kind) {
+            case HOST_BENCH_BULK_COMPRESSED_FILE_LOG_TEXT:
+                line_len = snprintf(
+                    &text[len], size - len,
+                    "1760702400000+%010lu_N [T:LFS:INFO]: MPI: wrote %lu bytes to 'mpi/science.bin'\n",
+                    (unsigned long)(line_num * 997), (unsigned long)(noise % 2048)
+                );
+                break;
+            case HOST_BENCH_BULK_COMPRESSED_FILE_JSON_TELEMETRY:
+                line_len = snprintf(
+                    &text[len], size - len,
+                    "{\"uptime_ms\":%lu,\"vbat_mV\":%lu,\"ibat_mA\":%ld,\"temp_cC\":%lu,\"mode\":\"nominal\"}\n",
+                    (unsigned long)(line_num * 10000), (unsigned long)(7400 + (noise % 200)),
+                    (long)(noise % 300) - 150, (unsigned long)(2000 + (noise % 500))
+                );
+                break;
+            case HOST_BENCH_BULK_COMPRESSED_FILE_GNSS_NMEA:
+                line_len = snprintf(
+                    &text[len], size - len,
+                    "$GPGGA,%06lu.00,4413.%05lu,N,07629.%05lu,W,1,08,0.9,%lu.%lu,M,-34.0,M,,*%02lX\r\n",
+                    (unsigned long)(120000 + line_num), (unsigned long)(noise % 100000),
+                    (unsigned long)((noise * 7) % 100000), (unsigned long)(500000 + (noise % 100)),
+                    (unsigned long)(noise % 10), (unsigned long)(noise & 0xFF)
+                );
+                break;
+            default:
+                for (uint8_t i = 0; (i < 64) && (len < size); i++) {
+                    lcg = (lcg * 1103515245u) + 12345u;
+                    HOST_BENCH_bulk_compressed_file_data[len++] = (uint8_t)(lcg >> 16);
+                }
+                continue;
+        }
+        if ((line_len <= 0) || ((size_t)line_len >= (size - len))) {
+            // Pad the end, where a whole line doesn't fit.
+            memset(&text[len], ' ', size - len);
+            len = size;
+            break;
+        }
+        len += (size_t)line_len;
+    }
+}
+
+/// @brief Write `HOST_BENCH_bulk_compressed_file_data` to a file.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_bulk_compressed_write_file(const char path[]) {
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+        return 1;
+    }
+    const lfs_ssize_t written = lfs_file_write(
+        &LFS_filesystem, &file, HOST_BENCH_bulk_compressed_file_data, sizeof(HOST_BENCH_bulk_compressed_file_data)
+    );
+    lfs_file_close(&LFS_filesystem, &file);
+    return (written == (lfs_ssize_t)sizeof(HOST_BENCH_bulk_compressed_file_data)) ? 0 : 1;
+}
+
+/// @brief Send packets of the running compressed downlink (as `TASK_bulk_downlink` does), placing
+///     each at its stream offset in `HOST_BENCH_bulk_compressed_stream`.
+/// @param max_packets Stop after this many packets (even if the downlink isn't finished).
+/// @param packet_count_out Number of packets sent (not counting an empty last packet).
+/// @param compress_us_out Time spent getting (i.e., compressing) the packets.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_bulk_compressed_send_packets(
+    uint32_t max_packets, uint32_t *packet_count_out, uint64_t *compress_us_out
+) {
+    *packet_count_out = 0;
+    *compress_us_out = 0;
+    for (uint32_t packet_num = 0; packet_num < max_packets; packet_num++) {
+        if (COMMS_bulk_file_downlink_state != COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING) {
+            return 0;
+        }
+
+        const uint8_t *packet_data;
+        uint16_t packet_len;
+        uint8_t is_last_packet;
+        const uint64_t start_us = HOST_get_monotonic_time_us();
+        const int32_t result = COMMS_bulk_file_downlink_get_compressed_packet(
+            &packet_data, &packet_len, &is_last_packet
+        );
+        *compress_us_out += HOST_get_monotonic_time_us() - start_us;
+        if (result != 0) {
+            printf("  FAIL: COMMS_bulk_file_downlink_get_compressed_packet() -> %ld\n", (long)result);
+            return 1;
+        }
+
+        const uint32_t stream_offset = COMMS_bulk_file_downlink_next_start_offset;
+        if ((stream_offset + packet_len) > sizeof(HOST_BENCH_bulk_compressed_stream)) {
+            printf("  FAIL: compressed stream is larger than %u bytes\n", HOST_BENCH_BULK_COMPRESSED_STREAM_MAX_BYTES);
+            return 1;
+        }
+        if ((packet_len != COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET) && !is_last_packet) {
+            printf("  FAIL: short packet (%u bytes) before the end of the stream\n", packet_len);
+            return 1;
+        }
+        memcpy(&HOST_BENCH_bulk_compressed_stream[stream_offset], packet_data, packet_len);
+        if (packet_len > 0) {
+            (*packet_count_out)++;
+        }
+        COMMS_bulk_file_downlink_compressed_packet_sent();
+    }
+    return 0;
+}
+
+/// @brief Decompress the stream in `HOST_BENCH_bulk_compressed_stream` and compare it with
+///     `HOST_BENCH_bulk_compressed_file_data`.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_bulk_compressed_check_stream(uint32_t stream_len) {
+    COMMS_bulk_file_downlink_compressed_header_t header;
+    if (stream_len < sizeof(header)) {
+        printf("  FAIL: stream is shorter than its header\n");
+        return 1;
+    }
+    memcpy(&header, HOST_BENCH_bulk_compressed_stream, sizeof(header));
+    if (
+        (header.magic[0] != 'H') || (header.magic[1] != 'S')
+        || (header.version != COMMS_BULK_FILE_DOWNLINK_COMPRESSED_HEADER_VERSION)
+        || (header.window_sz2 != HOST_BENCH_BULK_COMPRESSED_WINDOW_SZ2)
+        || (header.lookahead_sz2 != HOST_BENCH_BULK_COMPRESSED_LOOKAHEAD_SZ2)
+        || (header.source_start_offset != 0)
+        || (header.source_byte_count != HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES)
+    ) {
+        printf("  FAIL: stream header doesn't match the downlink's parameters\n");
+        return 1;
+    }
+
+    heatshrink_decoder *decoder = heatshrink_decoder_alloc(256, header.window_sz2, header.lookahead_sz2);
+    if (decoder == NULL) {
+        printf("  FAIL: heatshrink_decoder_alloc()\n");
+        return 1;
+    }
+
+    uint32_t in_pos = sizeof(header);
+    size_t out_len = 0;
+    uint8_t result = 0;
+    while (1) {
+        if (in_pos < stream_len) {
+            size_t sunk_count = 0;
+            if (heatshrink_decoder_sink(decoder, &HOST_BENCH_bulk_compressed_stream[in_pos], stream_len - in_pos, &sunk_count) < 0) {
+                result = 1;
+                break;
+            }
+            in_pos += (uint32_t)sunk_count;
+        }
+        else if (heatshrink_decoder_finish(decoder) == HSDR_FINISH_DONE) {
+            break;
+        }
+
+        HSD_poll_res poll_result;
+        do {
+            uint8_t chunk[64];
+            size_t polled_count = 0;
+            poll_result = heatshrink_decoder_poll(decoder, chunk, sizeof(chunk), &polled_count);
+            if ((out_len + polled_count) > sizeof(HOST_BENCH_bulk_compressed_decompressed)) {
+                poll_result = HSDR_POLL_ERROR_UNKNOWN; // More output than the file has.
+                break;
+            }
+            memcpy(&HOST_BENCH_bulk_compressed_decompressed[out_len], chunk, polled_count);
+            out_len += polled_count;
+        } while (poll_result == HSDR_POLL_MORE);
+        if (poll_result < 0) {
+            result = 1;
+            break;
+        }
+    }
+    heatshrink_decoder_free(decoder);
+
+    if (
+        (result != 0)
+        || (out_len != sizeof(HOST_BENCH_bulk_compressed_file_data))
+        || (memcmp(HOST_BENCH_bulk_compressed_decompressed, HOST_BENCH_bulk_compressed_file_data, out_len) != 0)
+    ) {
+        printf("  FAIL: decompressed stream doesn't match the file (%zu bytes decompressed)\n", out_len);
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Downlink one file compressed, check the stream, and print its row of the table.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_bulk_compressed_run_file(HOST_BENCH_bulk_compressed_file_enum_t file_kind) {
+    const char *path = HOST_BENCH_bulk_compressed_file_paths[file_kind];
+    HOST_BENCH_bulk_compressed_generate_file(file_kind);
+    if (HOST_BENCH_bulk_compressed_write_file(path) != 0) {
+        printf("  FAIL: write %s\n", path);
+        return 1;
+    }
+
+    HOST_NAND_reset_stats();
+    const int32_t start_result = COMMS_bulk_file_downlink_start_compressed(
+        (char *)path, 0, 0, HOST_BENCH_BULK_COMPRESSED_WINDOW_SZ2, HOST_BENCH_BULK_COMPRESSED_LOOKAHEAD_SZ2
+    );
+    if (start_result != 0) {
+        printf("  FAIL: COMMS_bulk_file_downlink_start_compressed(%s) -> %ld\n", path, (long)start_result);
+        return 1;
+    }
+    uint32_t packet_count;
+    uint64_t compress_us;
+    if (HOST_BENCH_bulk_compressed_send_packets(UINT32_MAX, &packet_count, &compress_us) != 0) {
+        return 1;
+    }
+    HOST_NAND_chip_stats_t streaming_stats;
+    HOST_NAND_get_total_stats(&streaming_stats);
+
+    const uint32_t stream_len = COMMS_bulk_file_downlink_next_start_offset;
+    if (
+        (COMMS_bulk_file_downlink_state != COMMS_BULK_FILE_DOWNLINK_STATE_IDLE)
+        || COMMS_bulk_file_downlink_is_compressed
+        || (COMMS_bulk_file_downlink_total_seq_num != packet_count)
+        || (COMMS_bulk_file_downlink_bytes_downlinked != HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES)
+    ) {
+        printf("  FAIL: downlink of %s didn't finish cleanly\n", path);
+        return 1;
+    }
+    if (HOST_BENCH_bulk_compressed_check_stream(stream_len) != 0) {
+        return 1;
+    }
+
+    // Compressing to a file first (`fs_compress_file_with_heatshrink`), then downlinking that.
+    HOST_NAND_reset_stats();
+    if (LFS_compress_lfs_file_with_heatshrink(
+        &LFS_filesystem, path, "bulk_compressed.hs",
+        HOST_BENCH_BULK_COMPRESSED_WINDOW_SZ2, HOST_BENCH_BULK_COMPRESSED_LOOKAHEAD_SZ2
+    ) != 0) {
+        printf("  FAIL: LFS_compress_lfs_file_with_heatshrink(%s)\n", path);
+        return 1;
+    }
+    HOST_NAND_chip_stats_t to_file_stats;
+    HOST_NAND_get_total_stats(&to_file_stats);
+    lfs_remove(&LFS_filesystem, "bulk_compressed.hs");
+
+    const uint32_t raw_packet_count = (
+        (HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES + COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET - 1)
+        / COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET
+    );
+    const double raw_seconds = (double)raw_packet_count * HOST_BENCH_BULK_COMPRESSED_MS_PER_PACKET / 1000.0;
+    const double compressed_seconds = (double)packet_count * HOST_BENCH_BULK_COMPRESSED_MS_PER_PACKET / 1000.0;
+    printf(
+        "  %-20s %6.2f %6lu %6lu %9.0f %9.0f %9.1f %8llu %9llu\n",
+        path,
+        (double)HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES / (double)stream_len,
+        (unsigned long)raw_packet_count, (unsigned long)packet_count,
+        (double)HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES / raw_seconds,
+        (double)HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES / compressed_seconds,
+        (double)compress_us / (double)packet_count,
+        (unsigned long long)streaming_stats.bytes_programmed,
+        (unsigned long long)to_file_stats.bytes_programmed
+    );
+
+    if (streaming_stats.bytes_programmed != 0) {
+        printf("  FAIL: the compressed downlink wrote to flash\n");
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Start a compressed downlink, restart it mid-stream (new file), and check the new stream.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_bulk_compressed_restart(void) {
+    const char *first_path = HOST_BENCH_bulk_compressed_file_paths[HOST_BENCH_BULK_COMPRESSED_FILE_LOG_TEXT];
+    const char *second_path = HOST_BENCH_bulk_compressed_file_paths[HOST_BENCH_BULK_COMPRESSED_FILE_GNSS_NMEA];
+    uint32_t packet_count;
+    uint64_t compress_us;
+
+    if (COMMS_bulk_file_downlink_start_compressed(
+        (char *)first_path, 0, 0, HOST_BENCH_BULK_COMPRESSED_WINDOW_SZ2, HOST_BENCH_BULK_COMPRESSED_LOOKAHEAD_SZ2
+    ) != 0) {
+        printf("  FAIL: first COMMS_bulk_file_downlink_start_compressed()\n");
+        return 1;
+    }
+    if (HOST_BENCH_bulk_compressed_send_packets(5, &packet_count, &compress_us) != 0) {
+        return 1;
+    }
+
+    // Leave a packet filled but not sent, as when the radio refuses it.
+    const uint8_t *packet_data;
+    uint16_t packet_len;
+    uint8_t is_last_packet;
+    if (COMMS_bulk_file_downlink_get_compressed_packet(&packet_data, &packet_len, &is_last_packet) != 0) {
+        printf("  FAIL: COMMS_bulk_file_downlink_get_compressed_packet() before restart\n");
+        return 1;
+    }
+
+    HOST_BENCH_bulk_compressed_generate_file(HOST_BENCH_BULK_COMPRESSED_FILE_GNSS_NMEA);
+    memset(HOST_BENCH_bulk_compressed_stream, 0, sizeof(HOST_BENCH_bulk_compressed_stream));
+    if (COMMS_bulk_file_downlink_start_compressed(
+        (char *)second_path, 0, 0, HOST_BENCH_BULK_COMPRESSED_WINDOW_SZ2, HOST_BENCH_BULK_COMPRESSED_LOOKAHEAD_SZ2
+    ) != 0) {
+        printf("  FAIL: second COMMS_bulk_file_downlink_start_compressed()\n");
+        return 1;
+    }
+    if (HOST_BENCH_bulk_compressed_send_packets(UINT32_MAX, &packet_count, &compress_us) != 0) {
+        return 1;
+    }
+    if (COMMS_bulk_file_downlink_state != COMMS_BULK_FILE_DOWNLINK_STATE_IDLE) {
+        printf("  FAIL: restarted downlink didn't finish\n");
+        return 1;
+    }
+    if (HOST_BENCH_bulk_compressed_check_stream(COMMS_bulk_file_downlink_next_start_offset) != 0) {
+        return 1;
+    }
+    printf("  Restart mid-stream (with a packet pending): new stream decompresses to the new file\n");
+    return 0;
+}
+
+/// @brief Whether `COMMS_bulk_file_downlink_file` is in LittleFS's list of open files.
+static uint8_t HOST_BENCH_bulk_compressed_downlink_file_is_in_lfs(void) {
+    for (const struct lfs_mlist *entry = LFS_filesystem.mlist; entry != NULL; entry = entry->next) {
+        if (entry == (const struct lfs_mlist *)&COMMS_bulk_file_downlink_file) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/// @brief Check that a start which fails after opening the file (bad offset) closes it, including
+///     when it replaces a running downlink.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_bulk_compressed_check_failed_start_closes_file(void) {
+    char *path = (char *)HOST_BENCH_bulk_compressed_file_paths[HOST_BENCH_BULK_COMPRESSED_FILE_LOG_TEXT];
+    if (COMMS_bulk_file_downlink_start_compressed(
+        path, 0, 0, HOST_BENCH_BULK_COMPRESSED_WINDOW_SZ2, HOST_BENCH_BULK_COMPRESSED_LOOKAHEAD_SZ2
+    ) != 0) {
+        printf("  FAIL: COMMS_bulk_file_downlink_start_compressed() before the failed start\n");
+        return 1;
+    }
+    const int32_t start_result = COMMS_bulk_file_downlink_start_compressed(
+        path, HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES, 0,
+        HOST_BENCH_BULK_COMPRESSED_WINDOW_SZ2, HOST_BENCH_BULK_COMPRESSED_LOOKAHEAD_SZ2
+    );
+    if (start_result != 3) {
+        printf("  FAIL: start at the end of the file -> %ld (expected 3)\n", (long)start_result);
+        return 1;
+    }
+    if (
+        COMMS_bulk_file_downlink_file_is_open
+        || HOST_BENCH_bulk_compressed_downlink_file_is_in_lfs()
+        || (COMMS_bulk_file_downlink_state != COMMS_BULK_FILE_DOWNLINK_STATE_IDLE)
+    ) {
+        printf("  FAIL: a failed start left the downlink file open\n");
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t HOST_BENCH_bulk_downlink_compressed(void) {
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+
+    uint8_t result = 0;
+    if (HOST_BENCH_reformat_filesystem() != 0) {
+        printf("  FAIL: reformat filesystem\n");
+        result = 1;
+    }
+
+    if (result == 0) {
+        printf(
+            "  %u-byte files, window_sz2=%u, lookahead_sz2=%u; one %u-byte packet per %u ms\n",
+            HOST_BENCH_BULK_COMPRESSED_FILE_SIZE_BYTES, HOST_BENCH_BULK_COMPRESSED_WINDOW_SZ2,
+            HOST_BENCH_BULK_COMPRESSED_LOOKAHEAD_SZ2, COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET,
+            HOST_BENCH_BULK_COMPRESSED_MS_PER_PACKET
+        );
+        printf(
+            "  %-20s %6s %6s %6s %9s %9s %9s %8s %9s\n",
+            "file", "ratio", "raw", "comp", "raw B/s", "comp B/s", "us/packet", "NAND wr", "to-file wr"
+        );
+    }
+    for (uint8_t file_num = 0; (file_num < HOST_BENCH_BULK_COMPRESSED_FILE_COUNT) && (result == 0); file_num++) {
+        result = HOST_BENCH_bulk_compressed_run_file((HOST_BENCH_bulk_compressed_file_enum_t)file_num);
+    }
+    if (result == 0) {
+        result = HOST_BENCH_bulk_compressed_restart();
+    }
+    if (result == 0) {
+        result = HOST_BENCH_bulk_compressed_check_failed_start_closes_file();
+    }
+
+    COMMS_bulk_file_downlink_end_compression();
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    return result;
+}
@@ -0,0 +1,196 @@
+// bench_bulk_downlink_prefetch.c
+// Host benchmark of the bulk downlink file reads, with read-ahead off and on
+// (`COMMS_bulk_file_downlink_prefetch_enabled`): flash transactions, and the flash time on the
+// packet path (before the packet can be sent) vs. overlapped with the packet on air. The packet
+// period is modelled for the old pacing (read, send, then the full delay) and for elapsed-time
+// pacing (delay minus the time taken). Flash times are the NAND emulator's modelled busy time.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "host_sim/host_nand_emulator.h"
+#include "comms_drivers/bulk_file_downlink.h"
+#include "comms_drivers/comms_tx.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_BENCH_PREFETCH_FILE_PATH "bulk_prefetch.bin"
+#define HOST_BENCH_PREFETCH_FILE_SIZE_BYTES (256 * 1024)
+
+// `COMMS_bulk_downlink_delay_per_packet_ms` (default), and the I2C transfer of a packet to the
+// AX100 (~205 bytes at 400 kHz).
+#define HOST_BENCH_PREFETCH_DELAY_PER_PACKET_MS 208.0
+#define HOST_BENCH_PREFETCH_TX_MS 5.0
+
+static uint8_t HOST_BENCH_prefetch_file_data[HOST_BENCH_PREFETCH_FILE_SIZE_BYTES];
+
+typedef struct {
+    uint32_t packet_count;
+    uint32_t page_read_count;
+    double on_path_flash_ms; // Total, reading packets (before sending).
+    double max_on_path_flash_ms; // Worst packet.
+    double overlapped_flash_ms; // Total, reading ahead (while the packet is on air).
+} HOST_BENCH_prefetch_result_t;
+
+/// @brief Get the NAND emulator's modelled busy time, in ms.
+static double HOST_BENCH_prefetch_busy_ms(void) {
+    HOST_NAND_chip_stats_t stats;
+    HOST_NAND_get_total_stats(&stats);
+    return (double)stats.modelled_busy_us / 1000.0;
+}
+
+/// @brief Downlink the whole file (as `TASK_bulk_downlink` does), checking every packet's data.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_prefetch_run(uint8_t prefetch_enabled, HOST_BENCH_prefetch_result_t *result_out) {
+    *result_out = (HOST_BENCH_prefetch_result_t){0};
+    COMMS_bulk_file_downlink_prefetch_enabled = prefetch_enabled;
+
+    // Remount, so that no file data is cached from the previous run.
+    LFS_ensure_unmounted();
+    if (LFS_mount() != 0) {
+        printf("  FAIL: LFS_mount()\n");
+        return 1;
+    }
+    if (COMMS_bulk_file_downlink_start(HOST_BENCH_PREFETCH_FILE_PATH, 0, 0) != 0) {
+        printf("  FAIL: COMMS_bulk_file_downlink_start()\n");
+        return 1;
+    }
+
+    HOST_NAND_reset_stats();
+    uint8_t data[COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET];
+    while (COMMS_bulk_file_downlink_state == COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING) {
+        const double read_start_ms = HOST_BENCH_prefetch_busy_ms();
+        uint16_t seq_num;
+        uint32_t file_offset;
+        uint16_t data_len;
+        const int32_t read_result = COMMS_bulk_file_downlink_read_next_packet(data, &seq_num, &file_offset, &data_len);
+        if (read_result != 0) {
+            printf("  FAIL: COMMS_bulk_file_downlink_read_next_packet() -> %ld\n", (long)read_result);
+            return 1;
+        }
+        const double read_ms = HOST_BENCH_prefetch_busy_ms() - read_start_ms;
+        result_out->on_path_flash_ms += read_ms;
+        if (read_ms > result_out->max_on_path_flash_ms) {
+            result_out->max_on_path_flash_ms = read_ms;
+        }
+
+        if (
+            ((file_offset + data_len) > sizeof(HOST_BENCH_prefetch_file_data))
+            || (memcmp(data, &HOST_BENCH_prefetch_file_data[file_offset], data_len) != 0)
+        ) {
+            printf("  FAIL: packet %u data doesn't match the file\n", seq_num);
+            return 1;
+        }
+        result_out->packet_count++;
+        COMMS_bulk_file_downlink_packet_sent(seq_num, data_len);
+
+        const double prefetch_start_ms = HOST_BENCH_prefetch_busy_ms();
+        if (COMMS_bulk_file_downlink_prefetch() != 0) {
+            printf("  FAIL: COMMS_bulk_file_downlink_prefetch()\n");
+            return 1;
+        }
+        result_out->overlapped_flash_ms += HOST_BENCH_prefetch_busy_ms() - prefetch_start_ms;
+    }
+
+    HOST_NAND_chip_stats_t stats;
+    HOST_NAND_get_total_stats(&stats);
+    result_out->page_read_count = stats.page_read_count;
+
+    if (COMMS_bulk_file_downlink_bytes_downlinked != HOST_BENCH_PREFETCH_FILE_SIZE_BYTES) {
+        printf("  FAIL: downlinked %lu bytes\n", (unsigned long)COMMS_bulk_file_downlink_bytes_downlinked);
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Print one row: the packet period and throughput, for one pacing.
+static void HOST_BENCH_prefetch_print_row(
+    const char label[], const HOST_BENCH_prefetch_result_t *result, uint8_t elapsed_time_pacing
+) {
+    const double packet_count = (double)result->packet_count;
+    const double work_ms = HOST_BENCH_PREFETCH_TX_MS + ((result->on_path_flash_ms + result->overlapped_flash_ms) / packet_count);
+    double period_ms = work_ms + HOST_BENCH_PREFETCH_DELAY_PER_PACKET_MS;
+    if (elapsed_time_pacing) {
+        period_ms = (work_ms > HOST_BENCH_PREFETCH_DELAY_PER_PACKET_MS) ? work_ms : HOST_BENCH_PREFETCH_DELAY_PER_PACKET_MS;
+    }
+    printf(
+        "  %-34s %9.2f %9.3f %9.3f %9.3f %9.1f %7.0f\n",
+        label,
+        (double)result->page_read_count * 1024.0 / HOST_BENCH_PREFETCH_FILE_SIZE_BYTES,
+        result->on_path_flash_ms / packet_count,
+        result->max_on_path_flash_ms,
+        result->overlapped_flash_ms / packet_count,
+        period_ms,
+        (double)HOST_BENCH_PREFETCH_FILE_SIZE_BYTES / (packet_count * period_ms / 1000.0)
+    );
+}
+
+uint8_t HOST_BENCH_bulk_downlink_prefetch(void) {
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    const uint32_t original_prefetch_enabled = COMMS_bulk_file_downlink_prefetch_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+
+    uint32_t lcg = 99;
+    for (uint32_t i = 0; i < sizeof(HOST_BENCH_prefetch_file_data); i++) {
+        lcg = (lcg * 1103515245u) + 12345u;
+        HOST_BENCH_prefetch_file_data[i] = (uint8_t)(lcg >> 16);
+    }
+
+    uint8_t result = 0;
+    lfs_file_t file;
+    if (
+        (HOST_BENCH_reformat_filesystem() != 0)
+        || (lfs_file_open(&LFS_filesystem, &file, HOST_BENCH_PREFETCH_FILE_PATH, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0)
+    ) {
+        printf("  FAIL: create file\n");
+        result = 1;
+    }
+    else {
+        const lfs_ssize_t written = lfs_file_write(
+            &LFS_filesystem, &file, HOST_BENCH_prefetch_file_data, sizeof(HOST_BENCH_prefetch_file_data)
+        );
+        lfs_file_close(&LFS_filesystem, &file);
+        if (written != (lfs_ssize_t)sizeof(HOST_BENCH_prefetch_file_data)) {
+            printf("  FAIL: write file\n");
+            result = 1;
+        }
+    }
+
+    HOST_BENCH_prefetch_result_t off_result;
+    HOST_BENCH_prefetch_result_t on_result;
+    if (result == 0) {
+        result = HOST_BENCH_prefetch_run(0, &off_result);
+    }
+    if (result == 0) {
+        result = HOST_BENCH_prefetch_run(1, &on_result);
+    }
+    COMMS_bulk_file_downlink_prefetch_enabled = original_prefetch_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    if (result != 0) {
+        return 1;
+    }
+
+    printf(
+        "  %u-byte file, %lu packets; %.0f ms delay per packet, %.0f ms I2C send\n",
+        HOST_BENCH_PREFETCH_FILE_SIZE_BYTES, (unsigned long)on_result.packet_count,
+        HOST_BENCH_PREFETCH_DELAY_PER_PACKET_MS, HOST_BENCH_PREFETCH_TX_MS
+    );
+    printf(
+        "  %-34s %9s %9s %9s %9s %9s %7s\n",
+        "", "pages/KiB", "path ms", "max ms", "ahead ms", "period ms", "B/s"
+    );
+    HOST_BENCH_prefetch_print_row("per-packet read, full delay", &off_result, 0);
+    HOST_BENCH_prefetch_print_row("per-packet read, elapsed pacing", &off_result, 1);
+    HOST_BENCH_prefetch_print_row("read-ahead, elapsed pacing", &on_result, 1);
+    printf(
+        "  (path ms: flash time before each packet can be sent; ahead ms: while the previous one is on air)\n"
+    );
+
+    if (on_result.on_path_flash_ms >= off_result.on_path_flash_ms) {
+        printf("  FAIL: read-ahead didn't take the flash reads off the packet path\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,289 @@
+// bench_bulk_downlink_selective_repeat.c
+// Host benchmark of the selective-repeat bulk downlink (`COMMS_bulk_file_downlink_nack`) over a
+// simulated lossy link: the ground NACKs the missing packets after each pass, until it has the
+// whole file. Compared with downlinking the whole file again until every packet has arrived.
+// Goodput counts the packet airtime, plus a turnaround per NACK round (uplink and response).
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "comms_drivers/bulk_file_downlink.h"
+#include "comms_drivers/comms_tx.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_BENCH_SELECTIVE_REPEAT_FILE_PATH "bulk_selective_repeat.bin"
+#define HOST_BENCH_SELECTIVE_REPEAT_FILE_SIZE_BYTES (64 * 1024)
+#define HOST_BENCH_SELECTIVE_REPEAT_PACKET_COUNT ( \
+    (HOST_BENCH_SELECTIVE_REPEAT_FILE_SIZE_BYTES + COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET - 1) \
+    / COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET \
+)
+
+// `TASK_bulk_downlink` sends one packet per `COMMS_bulk_downlink_delay_per_packet_ms` (default).
+#define HOST_BENCH_SELECTIVE_REPEAT_MS_PER_PACKET 208
+
+// Time from the end of a pass to the start of the next one: uplink the telecommands, and get the response.
+#define HOST_BENCH_SELECTIVE_REPEAT_TURNAROUND_MS 5000
+
+// Bitmap bytes per `comms_bulk_file_downlink_nack` telecommand (as the ground tool makes them).
+#define HOST_BENCH_SELECTIVE_REPEAT_NACK_BITMAP_MAX_BYTES 150
+
+#define HOST_BENCH_SELECTIVE_REPEAT_MAX_ROUNDS 100
+
+static const uint8_t HOST_BENCH_selective_repeat_loss_percents[] = {0, 1, 3, 10, 20};
+
+static uint8_t HOST_BENCH_selective_repeat_file_data[HOST_BENCH_SELECTIVE_REPEAT_FILE_SIZE_BYTES];
+static uint8_t HOST_BENCH_selective_repeat_ground_data[HOST_BENCH_SELECTIVE_REPEAT_FILE_SIZE_BYTES];
+static uint8_t HOST_BENCH_selective_repeat_ground_received[HOST_BENCH_SELECTIVE_REPEAT_PACKET_COUNT + 1];
+
+static uint32_t HOST_BENCH_selective_repeat_lcg;
+
+typedef struct {
+    uint32_t packets_sent;
+    uint32_t round_count; // Passes (the first pass, plus one per NACK round or re-downlink).
+    double seconds;
+} HOST_BENCH_selective_repeat_result_t;
+
+/// @brief Whether the simulated link loses the next packet.
+static uint8_t HOST_BENCH_selective_repeat_is_lost(uint8_t loss_percent) {
+    HOST_BENCH_selective_repeat_lcg = (HOST_BENCH_selective_repeat_lcg * 1103515245u) + 12345u;
+    return (((HOST_BENCH_selective_repeat_lcg >> 16) % 1000) < ((uint32_t)loss_percent * 10));
+}
+
+/// @brief Send packets (as `TASK_bulk_downlink` does) until the downlink goes idle, receiving
+///     the ones which aren't lost into the ground buffer.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_selective_repeat_run_pass(uint8_t loss_percent, uint32_t *packets_sent) {
+    uint8_t data[COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET];
+    while (COMMS_bulk_file_downlink_state == COMMS_BULK_FILE_DOWNLINK_STATE_DOWNLINKING) {
+        uint16_t seq_num;
+        uint32_t file_offset;
+        uint16_t data_len;
+        const int32_t read_result = COMMS_bulk_file_downlink_read_next_packet(data, &seq_num, &file_offset, &data_len);
+        if (read_result != 0) {
+            printf("  FAIL: COMMS_bulk_file_downlink_read_next_packet() -> %ld\n", (long)read_result);
+            return 1;
+        }
+        (*packets_sent)++;
+
+        if (!HOST_BENCH_selective_repeat_is_lost(loss_percent)) {
+            if ((file_offset + data_len) > sizeof(HOST_BENCH_selective_repeat_ground_data)) {
+                printf("  FAIL: packet %u is past the end of the file\n", seq_num);
+                return 1;
+            }
+            memcpy(&HOST_BENCH_selective_repeat_ground_data[file_offset], data, data_len);
+            HOST_BENCH_selective_repeat_ground_received[seq_num] = 1;
+        }
+        COMMS_bulk_file_downlink_packet_sent(seq_num, data_len);
+    }
+    return 0;
+}
+
+/// @brief NACK every packet the ground is missing, in telecommand-sized bitmaps.
+/// @return Number of packets NACKed, or -1 on failure.
+static int32_t HOST_BENCH_selective_repeat_send_nacks(void) {
+    int32_t total_nacked = 0;
+    uint16_t seq_num = 1;
+    while (seq_num <= HOST_BENCH_SELECTIVE_REPEAT_PACKET_COUNT) {
+        if (HOST_BENCH_selective_repeat_ground_received[seq_num]) {
+            seq_num++;
+            continue;
+        }
+
+        uint8_t bitmap[HOST_BENCH_SELECTIVE_REPEAT_NACK_BITMAP_MAX_BYTES] = {0};
+        const uint16_t first_seq_num = seq_num;
+        uint16_t bitmap_len = 0;
+        for (; (seq_num <= HOST_BENCH_SELECTIVE_REPEAT_PACKET_COUNT) && ((uint32_t)(seq_num - first_seq_num) < (sizeof(bitmap) * 8)); seq_num++) {
+            if (!HOST_BENCH_selective_repeat_ground_received[seq_num]) {
+                const uint16_t bit_idx = seq_num - first_seq_num;
+                bitmap[bit_idx / 8] |= (1 << (bit_idx % 8));
+                bitmap_len = (bit_idx / 8) + 1;
+            }
+        }
+
+        uint16_t nacked_count = 0;
+        const int32_t result = COMMS_bulk_file_downlink_nack(
+            COMMS_bulk_file_downlink_transfer_id, first_seq_num, bitmap, bitmap_len, &nacked_count
+        );
+        if (result != 0) {
+            printf("  FAIL: COMMS_bulk_file_downlink_nack() -> %ld\n", (long)result);
+            return -1;
+        }
+        total_nacked += nacked_count;
+    }
+    return total_nacked;
+}
+
+/// @brief Check that the ground has every packet, with the file's data.
+/// @return 1 if the ground has the whole file, else 0.
+static uint8_t HOST_BENCH_selective_repeat_ground_is_complete(void) {
+    for (uint16_t seq_num = 1; seq_num <= HOST_BENCH_SELECTIVE_REPEAT_PACKET_COUNT; seq_num++) {
+        if (!HOST_BENCH_selective_repeat_ground_received[seq_num]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/// @brief Reset the ground's received data, and the link's random sequence.
+static void HOST_BENCH_selective_repeat_reset_ground(void) {
+    memset(HOST_BENCH_selective_repeat_ground_data, 0, sizeof(HOST_BENCH_selective_repeat_ground_data));
+    memset(HOST_BENCH_selective_repeat_ground_received, 0, sizeof(HOST_BENCH_selective_repeat_ground_received));
+    HOST_BENCH_selective_repeat_lcg = 2024;
+}
+
+/// @brief Downlink the file over the lossy link. With `use_nacks`, NACK the missing packets after
+///     each pass; otherwise, downlink the whole file again (merging what arrives).
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_selective_repeat_run(
+    uint8_t loss_percent, uint8_t use_nacks, HOST_BENCH_selective_repeat_result_t *result_out
+) {
+    HOST_BENCH_selective_repeat_reset_ground();
+    *result_out = (HOST_BENCH_selective_repeat_result_t){0};
+
+    for (uint32_t round = 0; round < HOST_BENCH_SELECTIVE_REPEAT_MAX_ROUNDS; round++) {
+        if ((round == 0) || !use_nacks) {
+            if (COMMS_bulk_file_downlink_start(HOST_BENCH_SELECTIVE_REPEAT_FILE_PATH, 0, 0) != 0) {
+                printf("  FAIL: COMMS_bulk_file_downlink_start()\n");
+                return 1;
+            }
+        }
+        else if (HOST_BENCH_selective_repeat_send_nacks() <= 0) {
+            printf("  FAIL: nothing NACKed, with packets missing\n");
+            return 1;
+        }
+
+        result_out->round_count++;
+        if (HOST_BENCH_selective_repeat_run_pass(loss_percent, &result_out->packets_sent) != 0) {
+            return 1;
+        }
+        if (HOST_BENCH_selective_repeat_ground_is_complete()) {
+            break;
+        }
+    }
+
+    if (
+        !HOST_BENCH_selective_repeat_ground_is_complete()
+        || (memcmp(HOST_BENCH_selective_repeat_ground_data, HOST_BENCH_selective_repeat_file_data, sizeof(HOST_BENCH_selective_repeat_file_data)) != 0)
+    ) {
+        printf("  FAIL: ground doesn't have the whole file after %lu rounds\n", (unsigned long)result_out->round_count);
+        return 1;
+    }
+    if ((COMMS_bulk_file_downlink_state != COMMS_BULK_FILE_DOWNLINK_STATE_IDLE) || (COMMS_bulk_file_downlink_nack_pending_count != 0)) {
+        printf("  FAIL: downlink didn't return to idle\n");
+        return 1;
+    }
+
+    result_out->seconds = (
+        ((double)result_out->packets_sent * HOST_BENCH_SELECTIVE_REPEAT_MS_PER_PACKET)
+        + ((double)(result_out->round_count - 1) * HOST_BENCH_SELECTIVE_REPEAT_TURNAROUND_MS)
+    ) / 1000.0;
+    return 0;
+}
+
+/// @brief Check that NACKs for another transfer, or for a compressed transfer, are rejected.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_selective_repeat_check_rejects(void) {
+    const uint8_t bitmap[1] = {0x01};
+    uint16_t nacked_count;
+    if (COMMS_bulk_file_downlink_start(HOST_BENCH_SELECTIVE_REPEAT_FILE_PATH, 0, 0) != 0) {
+        return 1;
+    }
+    const uint16_t transfer_id = COMMS_bulk_file_downlink_transfer_id;
+    if (COMMS_bulk_file_downlink_nack(transfer_id - 1, 1, bitmap, sizeof(bitmap), &nacked_count) != 1) {
+        printf("  FAIL: NACK for an old transfer ID was accepted\n");
+        return 1;
+    }
+    if ((COMMS_bulk_file_downlink_nack(transfer_id, 1, bitmap, sizeof(bitmap), &nacked_count) != 0) || (nacked_count != 0)) {
+        printf("  FAIL: NACK for a packet which wasn't sent yet was queued\n");
+        return 1;
+    }
+    if (COMMS_bulk_file_downlink_start_compressed(HOST_BENCH_SELECTIVE_REPEAT_FILE_PATH, 0, 0, 8, 4) != 0) {
+        return 1;
+    }
+    const uint8_t compressed_result = COMMS_bulk_file_downlink_nack(
+        COMMS_bulk_file_downlink_transfer_id, 1, bitmap, sizeof(bitmap), &nacked_count
+    );
+    COMMS_bulk_file_downlink_start(HOST_BENCH_SELECTIVE_REPEAT_FILE_PATH, 0, 0); // Frees the encoder.
+    COMMS_bulk_file_downlink_pause();
+    if (compressed_result != 2) {
+        printf("  FAIL: NACK for a compressed transfer was accepted\n");
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t HOST_BENCH_bulk_downlink_selective_repeat(void) {
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+
+    uint32_t lcg = 7;
+    for (uint32_t i = 0; i < sizeof(HOST_BENCH_selective_repeat_file_data); i++) {
+        lcg = (lcg * 1103515245u) + 12345u;
+        HOST_BENCH_selective_repeat_file_data[i] = (uint8_t)(lcg >> 16);
+    }
+
+    uint8_t result = 0;
+    lfs_file_t file;
+    if (
+        (HOST_BENCH_reformat_filesystem() != 0)
+        || (lfs_file_open(&LFS_filesystem, &file, HOST_BENCH_SELECTIVE_REPEAT_FILE_PATH, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0)
+    ) {
+        printf("  FAIL: create file\n");
+        result = 1;
+    }
+    else {
+        const lfs_ssize_t written = lfs_file_write(
+            &LFS_filesystem, &file, HOST_BENCH_selective_repeat_file_data, sizeof(HOST_BENCH_selective_repeat_file_data)
+        );
+        lfs_file_close(&LFS_filesystem, &file);
+        if (written != (lfs_ssize_t)sizeof(HOST_BENCH_selective_repeat_file_data)) {
+            printf("  FAIL: write file\n");
+            result = 1;
+        }
+    }
+
+    if (result == 0) {
+        result = HOST_BENCH_selective_repeat_check_rejects();
+    }
+
+    if (result == 0) {
+        printf(
+            "  %u-byte file (%u packets), %u ms per packet, %u ms turnaround per round\n",
+            HOST_BENCH_SELECTIVE_REPEAT_FILE_SIZE_BYTES, HOST_BENCH_SELECTIVE_REPEAT_PACKET_COUNT,
+            HOST_BENCH_SELECTIVE_REPEAT_MS_PER_PACKET, HOST_BENCH_SELECTIVE_REPEAT_TURNAROUND_MS
+        );
+        printf(
+            "  %-6s | %-30s | %-30s\n", "", "selective repeat (NACK)", "downlink whole file again"
+        );
+        printf(
+            "  %-6s | %7s %6s %7s %7s | %7s %6s %7s %7s\n",
+            "loss", "packets", "rounds", "time s", "B/s", "packets", "passes", "time s", "B/s"
+        );
+    }
+    for (uint8_t i = 0; (i < sizeof(HOST_BENCH_selective_repeat_loss_percents)) && (result == 0); i++) {
+        const uint8_t loss_percent = HOST_BENCH_selective_repeat_loss_percents[i];
+        HOST_BENCH_selective_repeat_result_t nack_result;
+        HOST_BENCH_selective_repeat_result_t full_result;
+        result = HOST_BENCH_selective_repeat_run(loss_percent, 1, &nack_result);
+        if (result == 0) {
+            result = HOST_BENCH_selective_repeat_run(loss_percent, 0, &full_result);
+        }
+        if (result != 0) {
+            break;
+        }
+        printf(
+            "  %5u%% | %7lu %6lu %7.1f %7.0f | %7lu %6lu %7.1f %7.0f\n",
+            loss_percent,
+            (unsigned long)nack_result.packets_sent, (unsigned long)nack_result.round_count, nack_result.seconds,
+            HOST_BENCH_SELECTIVE_REPEAT_FILE_SIZE_BYTES / nack_result.seconds,
+            (unsigned long)full_result.packets_sent, (unsigned long)full_result.round_count, full_result.seconds,
+            HOST_BENCH_SELECTIVE_REPEAT_FILE_SIZE_BYTES / full_result.seconds
+        );
+    }
+
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    return result;
+}
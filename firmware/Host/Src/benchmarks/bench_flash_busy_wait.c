@@ -0,0 +1,201 @@
+// bench_flash_busy_wait.c
+// Host benchmark of waiting for page programs and block erases: back-to-back status register
+// polls (the old `FLASH_wait_until_ready`) vs. the backoff schedule of
+// `FLASH_busy_wait_next_poll_delay_us`, which leaves the CPU to other tasks between polls.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/flash_busy_wait.h"
+#include "littlefs/flash_driver.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// A Get Features (status register) command: 3 bytes at 8 MHz, plus CS and HAL overhead.
+#define HOST_BENCH_BUSY_WAIT_STATUS_POLL_US 8
+#define HOST_BENCH_BUSY_WAIT_OPERATION_COUNT 10000
+
+// 1 MiB, written through LittleFS to fill the driver's histograms.
+#define HOST_BENCH_BUSY_WAIT_FILE_CHUNK_COUNT 512
+
+typedef struct {
+    const char *label;
+    const FLASH_busy_wait_timing_t *timing;
+    uint32_t min_busy_us;
+    uint32_t max_busy_us;
+} HOST_BENCH_busy_wait_case_t;
+
+typedef struct {
+    uint64_t status_poll_count;
+    uint64_t cpu_used_us;
+    uint64_t busy_us;
+    uint64_t detection_latency_us;
+    uint32_t max_detection_latency_us;
+} HOST_BENCH_busy_wait_result_t;
+
+/// @brief Busy times spread over [min, max]: tPROG/tBERS vary with the block and its wear.
+static uint32_t HOST_BENCH_busy_wait_next_busy_us(uint32_t *lcg_state, uint32_t min_us, uint32_t max_us) {
+    *lcg_state = (*lcg_state * 1103515245u) + 12345u;
+    return min_us + ((*lcg_state >> 8) % (max_us - min_us + 1));
+}
+
+/// @brief Run the same busy times through both ways of waiting.
+/// @return 0 on success, 1 if the backoff noticed a ready chip later than its schedule allows.
+static uint8_t HOST_BENCH_busy_wait_run_case(
+    const HOST_BENCH_busy_wait_case_t *test_case,
+    HOST_BENCH_busy_wait_result_t *tight_out, HOST_BENCH_busy_wait_result_t *backoff_out
+) {
+    memset(tight_out, 0, sizeof(HOST_BENCH_busy_wait_result_t));
+    memset(backoff_out, 0, sizeof(HOST_BENCH_busy_wait_result_t));
+    uint32_t lcg_state = 42;
+
+    for (uint32_t op_num = 0; op_num < HOST_BENCH_BUSY_WAIT_OPERATION_COUNT; op_num++) {
+        const uint32_t busy_us = HOST_BENCH_busy_wait_next_busy_us(
+            &lcg_state, test_case->min_busy_us, test_case->max_busy_us
+        );
+
+        // Back-to-back polls: the CPU is occupied for the whole busy time.
+        const uint32_t tight_poll_count = (busy_us / HOST_BENCH_BUSY_WAIT_STATUS_POLL_US) + 1;
+        tight_out->status_poll_count += tight_poll_count;
+        tight_out->cpu_used_us += (uint64_t)tight_poll_count * HOST_BENCH_BUSY_WAIT_STATUS_POLL_US;
+        tight_out->busy_us += busy_us;
+
+        // Backoff: the CPU is only occupied by the polls themselves.
+        uint32_t elapsed_us = 0;
+        uint32_t backoff_poll_count = 0;
+        while (elapsed_us < busy_us) {
+            elapsed_us += FLASH_busy_wait_next_poll_delay_us(test_case->timing, elapsed_us);
+            backoff_poll_count++;
+        }
+        const uint32_t latency_us = elapsed_us - busy_us;
+        backoff_out->status_poll_count += backoff_poll_count;
+        backoff_out->cpu_used_us += (uint64_t)backoff_poll_count * HOST_BENCH_BUSY_WAIT_STATUS_POLL_US;
+        backoff_out->busy_us += busy_us;
+        backoff_out->detection_latency_us += latency_us;
+        if (latency_us > backoff_out->max_detection_latency_us) {
+            backoff_out->max_detection_latency_us = latency_us;
+        }
+
+        // Past the typical time, each delay is at most typical/2.
+        if ((busy_us > test_case->timing->typical_us) && (latency_us > (test_case->timing->typical_us / 2))) {
+            printf("  FAIL: %s of %u us noticed %u us late\n", test_case->label, busy_us, latency_us);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void HOST_BENCH_busy_wait_print_row(const char label[], const HOST_BENCH_busy_wait_result_t *result) {
+    const double op_count = HOST_BENCH_BUSY_WAIT_OPERATION_COUNT;
+    const double cpu_free_percent = 100.0 * (1.0 - ((double)result->cpu_used_us / (double)result->busy_us));
+    printf(
+        "  %-24s %10.1f %10.1f %9.1f%% %10.1f %10u\n",
+        label,
+        (double)result->status_poll_count / op_count,
+        (double)result->cpu_used_us / op_count,
+        (cpu_free_percent > 0) ? cpu_free_percent : 0.0,
+        (double)result->detection_latency_us / op_count,
+        result->max_detection_latency_us
+    );
+}
+
+/// @brief Write a file through LittleFS, and print the busy time stats the driver collected.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_busy_wait_lfs_write(void) {
+    static uint8_t file_chunk[FLASH_CHIP_PAGE_SIZE_BYTES];
+    memset(FLASH_program_busy_time_stats, 0, sizeof(FLASH_program_busy_time_stats));
+    memset(FLASH_erase_busy_time_stats, 0, sizeof(FLASH_erase_busy_time_stats));
+    HOST_NAND_reset_stats();
+
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, "bench_busy_wait.bin", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+        printf("  FAIL: open for write\n");
+        return 1;
+    }
+    uint8_t result = 0;
+    for (uint32_t chunk_num = 0; chunk_num < HOST_BENCH_BUSY_WAIT_FILE_CHUNK_COUNT; chunk_num++) {
+        memset(file_chunk, (uint8_t)chunk_num, sizeof(file_chunk));
+        if (lfs_file_write(&LFS_filesystem, &file, file_chunk, sizeof(file_chunk)) != (lfs_ssize_t)sizeof(file_chunk)) {
+            result = 1;
+            break;
+        }
+    }
+    lfs_file_close(&LFS_filesystem, &file);
+    lfs_remove(&LFS_filesystem, "bench_busy_wait.bin");
+    if (result != 0) {
+        printf("  FAIL: LittleFS file write\n");
+        return 1;
+    }
+
+    HOST_NAND_chip_stats_t nand_total;
+    HOST_NAND_get_total_stats(&nand_total);
+    uint32_t program_count = 0;
+    uint32_t erase_count = 0;
+    char json[320];
+    printf("  Driver busy time stats after writing a 1 MiB file (flash_get_busy_time_stats_json):\n");
+    for (uint8_t chip = 0; chip < FLASH_NUMBER_OF_FLASH_DEVICES; chip++) {
+        program_count += FLASH_program_busy_time_stats[chip].count;
+        erase_count += FLASH_erase_busy_time_stats[chip].count;
+        if ((FLASH_program_busy_time_stats[chip].count == 0) && (FLASH_erase_busy_time_stats[chip].count == 0)) {
+            continue;
+        }
+        if (FLASH_busy_time_stats_to_json(&FLASH_program_busy_time_stats[chip], json, sizeof(json)) < 0) {
+            printf("  FAIL: program stats JSON truncated\n");
+            return 1;
+        }
+        printf("    chip %u program: %s\n", chip, json);
+        if (FLASH_busy_time_stats_to_json(&FLASH_erase_busy_time_stats[chip], json, sizeof(json)) < 0) {
+            printf("  FAIL: erase stats JSON truncated\n");
+            return 1;
+        }
+        printf("    chip %u erase:   %s\n", chip, json);
+    }
+
+    if ((program_count != nand_total.page_program_count) || (erase_count != nand_total.block_erase_count)) {
+        printf(
+            "  FAIL: stats count %u programs and %u erases; the NAND saw %u and %u\n",
+            program_count, erase_count, nand_total.page_program_count, nand_total.block_erase_count
+        );
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t HOST_BENCH_flash_busy_wait(void) {
+    const HOST_BENCH_busy_wait_case_t cases[] = {
+        {.label = "page program", .timing = &FLASH_PAGE_PROGRAM_TIMING, .min_busy_us = 150, .max_busy_us = 600},
+        {.label = "block erase", .timing = &FLASH_BLOCK_ERASE_TIMING, .min_busy_us = 1500, .max_busy_us = 10000},
+    };
+
+    printf(
+        "  %u operations per case; busy times uniform in the ranges below; %u us per status poll\n",
+        HOST_BENCH_BUSY_WAIT_OPERATION_COUNT, HOST_BENCH_BUSY_WAIT_STATUS_POLL_US
+    );
+    printf(
+        "  %-24s %10s %10s %10s %10s %10s\n",
+        "", "polls/op", "CPU us/op", "CPU free", "late us", "max late"
+    );
+    for (uint8_t case_num = 0; case_num < (sizeof(cases) / sizeof(cases[0])); case_num++) {
+        HOST_BENCH_busy_wait_result_t tight;
+        HOST_BENCH_busy_wait_result_t backoff;
+        if (HOST_BENCH_busy_wait_run_case(&cases[case_num], &tight, &backoff) != 0) {
+            return 1;
+        }
+        printf(
+            "  %s (%u-%u us, typical %u us):\n",
+            cases[case_num].label, cases[case_num].min_busy_us, cases[case_num].max_busy_us,
+            cases[case_num].timing->typical_us
+        );
+        HOST_BENCH_busy_wait_print_row("  back-to-back polls", &tight);
+        HOST_BENCH_busy_wait_print_row("  backoff", &backoff);
+
+        if (backoff.cpu_used_us >= tight.cpu_used_us) {
+            printf("  FAIL: backoff used as much CPU time as back-to-back polling\n");
+            return 1;
+        }
+    }
+
+    return HOST_BENCH_busy_wait_lfs_write();
+}
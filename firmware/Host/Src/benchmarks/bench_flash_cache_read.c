@@ -0,0 +1,220 @@
+// bench_flash_cache_read.c
+// Host benchmark of sequential NAND reads: one page read (load to cache, wait, read out) at a time
+// vs. the chip's cache read mode, where the next page loads while the current one is read out.
+// Throughputs are from the NAND emulator's timing model of the flight hardware.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/flash_driver.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// 1 MiB: the last 8 blocks of the last chip, which LittleFS is unlikely to touch.
+#define HOST_BENCH_FLASH_PAGE_COUNT 512
+#define HOST_BENCH_FLASH_CHIP (FLASH_NUMBER_OF_FLASH_DEVICES - 1)
+#define HOST_BENCH_FLASH_START_ROW \
+    ((HOST_NAND_BLOCKS_PER_CHIP * FLASH_CHIP_PAGES_PER_BLOCK) - HOST_BENCH_FLASH_PAGE_COUNT)
+
+// Processing of each page (e.g., a SHA-256 checksum) is assumed to cost about 50 cycles per byte
+// at SYSCLK (HSI, 16 MHz).
+#define HOST_BENCH_FLASH_CPU_HZ 16000000.0
+#define HOST_BENCH_FLASH_CYCLES_PER_BYTE_PROCESSED 50
+
+static uint8_t HOST_BENCH_flash_pattern_byte(uint32_t page_num, uint32_t byte_num) {
+    return (uint8_t)((page_num * 7) + byte_num + 42);
+}
+
+/// @brief Erase the benchmark blocks, and program every page with a pattern unique to the page.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_flash_write_pattern(void) {
+    static uint8_t page[FLASH_CHIP_PAGE_SIZE_BYTES];
+    for (uint32_t page_num = 0; page_num < HOST_BENCH_FLASH_PAGE_COUNT; page_num++) {
+        const FLASH_Physical_Address_t address = {
+            .row_address = HOST_BENCH_FLASH_START_ROW + page_num,
+            .col_address = 0,
+        };
+        if ((page_num % FLASH_CHIP_PAGES_PER_BLOCK) == 0) {
+            if (FLASH_erase_block(HOST_BENCH_FLASH_CHIP, address) != FLASH_ERR_OK) {
+                return 1;
+            }
+        }
+        for (uint32_t i = 0; i < FLASH_CHIP_PAGE_SIZE_BYTES; i++) {
+            page[i] = HOST_BENCH_flash_pattern_byte(page_num, i);
+        }
+        if (FLASH_program_page(HOST_BENCH_FLASH_CHIP, address, page, sizeof(page)) != FLASH_ERR_OK) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+typedef struct {
+    double read_only_us;
+    double read_then_process_us;
+    double overlapped_us;
+    uint32_t cache_read_page_count;
+} HOST_BENCH_flash_pass_result_t;
+
+/// @brief Read every benchmark page with `FLASH_start_read_page`/`FLASH_wait_for_read_page`, and
+///     check its contents.
+/// @return 0 on success, 1 on a read failure or a data mismatch.
+static uint8_t HOST_BENCH_flash_read_pass(uint8_t cache_read_enabled, HOST_BENCH_flash_pass_result_t *result_out) {
+    static uint8_t page[FLASH_CHIP_PAGE_SIZE_BYTES];
+    const double process_us = (
+        (double)FLASH_CHIP_PAGE_SIZE_BYTES * HOST_BENCH_FLASH_CYCLES_PER_BYTE_PROCESSED * 1e6
+        / HOST_BENCH_FLASH_CPU_HZ
+    );
+    const HOST_NAND_chip_stats_t *stats = HOST_NAND_get_chip_stats(HOST_BENCH_FLASH_CHIP);
+
+    FLASH_cache_read_enabled = cache_read_enabled;
+    FLASH_reset(HOST_BENCH_FLASH_CHIP); // Start with the chip out of cache read mode.
+    HOST_NAND_reset_stats();
+    memset(result_out, 0, sizeof(HOST_BENCH_flash_pass_result_t));
+
+    for (uint32_t page_num = 0; page_num < HOST_BENCH_FLASH_PAGE_COUNT; page_num++) {
+        const FLASH_Physical_Address_t address = {
+            .row_address = HOST_BENCH_FLASH_START_ROW + page_num,
+            .col_address = 0,
+        };
+        const uint64_t busy_before_us = stats->modelled_busy_us;
+        if (FLASH_start_read_page(HOST_BENCH_FLASH_CHIP, address, page, sizeof(page)) != FLASH_ERR_OK) {
+            return 1;
+        }
+        if (FLASH_wait_for_read_page() != FLASH_ERR_OK) {
+            return 1;
+        }
+        const double read_us = (double)(stats->modelled_busy_us - busy_before_us);
+
+        // Overlapped: this page's read runs while the previous page is processed.
+        result_out->read_only_us += read_us;
+        result_out->read_then_process_us += read_us + process_us;
+        result_out->overlapped_us += (page_num == 0) ? read_us : ((read_us > process_us) ? read_us : process_us);
+
+        for (uint32_t i = 0; i < FLASH_CHIP_PAGE_SIZE_BYTES; i++) {
+            if (page[i] != HOST_BENCH_flash_pattern_byte(page_num, i)) {
+                printf("  FAIL: data mismatch in page %u at byte %u\n", page_num, i);
+                return 1;
+            }
+        }
+    }
+    result_out->overlapped_us += process_us; // The last page is processed after its read.
+    result_out->cache_read_page_count = stats->cache_read_page_count;
+    return 0;
+}
+
+/// @brief Read a file through LittleFS in small chunks (as the search telecommands do), and get
+///     the modelled NAND busy time.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_flash_lfs_read_pass(uint8_t cache_read_enabled, uint64_t *busy_us_out) {
+    FLASH_cache_read_enabled = cache_read_enabled;
+    HOST_NAND_reset_stats();
+
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, "bench_cache_read.bin", LFS_O_RDONLY) < 0) {
+        return 1;
+    }
+    uint8_t chunk[64];
+    uint32_t total_bytes = 0;
+    lfs_ssize_t bytes_read;
+    while ((bytes_read = lfs_file_read(&LFS_filesystem, &file, chunk, sizeof(chunk))) > 0) {
+        total_bytes += bytes_read;
+    }
+    lfs_file_close(&LFS_filesystem, &file);
+    if ((bytes_read < 0) || (total_bytes != (HOST_BENCH_FLASH_PAGE_COUNT * FLASH_CHIP_PAGE_SIZE_BYTES))) {
+        return 1;
+    }
+
+    HOST_NAND_chip_stats_t total;
+    HOST_NAND_get_total_stats(&total);
+    *busy_us_out = total.modelled_busy_us;
+    return 0;
+}
+
+uint8_t HOST_BENCH_flash_cache_read(void) {
+    const uint32_t original_cache_read_enabled = FLASH_cache_read_enabled;
+    const double total_mib = (double)(HOST_BENCH_FLASH_PAGE_COUNT * FLASH_CHIP_PAGE_SIZE_BYTES) / (1024.0 * 1024.0);
+    uint8_t result = 0;
+
+    if (HOST_BENCH_flash_write_pattern() != 0) {
+        printf("  FAIL: write pattern\n");
+        return 1;
+    }
+
+    // Raw driver reads of 1 MiB of consecutive pages.
+    HOST_BENCH_flash_pass_result_t passes[2];
+    for (uint8_t cache_read_enabled = 0; cache_read_enabled < 2; cache_read_enabled++) {
+        if (HOST_BENCH_flash_read_pass(cache_read_enabled, &passes[cache_read_enabled]) != 0) {
+            printf("  FAIL: read pass (cache read %s)\n", cache_read_enabled ? "on" : "off");
+            FLASH_cache_read_enabled = original_cache_read_enabled;
+            return 1;
+        }
+    }
+    printf(
+        "  %u consecutive pages (%.2f MiB); processing assumed %u cycles/byte at %.0f MHz\n",
+        HOST_BENCH_FLASH_PAGE_COUNT, total_mib,
+        HOST_BENCH_FLASH_CYCLES_PER_BYTE_PROCESSED, HOST_BENCH_FLASH_CPU_HZ / 1e6
+    );
+    printf("  %-34s %12s %12s\n", "", "page read", "cache read");
+    printf(
+        "  %-34s %12u %12u\n", "pages served by cache read",
+        passes[0].cache_read_page_count, passes[1].cache_read_page_count
+    );
+    printf(
+        "  %-34s %10.3f/s %10.3f/s\n", "read only (MiB)",
+        total_mib / (passes[0].read_only_us / 1e6), total_mib / (passes[1].read_only_us / 1e6)
+    );
+    printf(
+        "  %-34s %10.3f/s %10.3f/s\n", "read, then process (MiB)",
+        total_mib / (passes[0].read_then_process_us / 1e6), total_mib / (passes[1].read_then_process_us / 1e6)
+    );
+    printf(
+        "  %-34s %12s %10.3f/s\n", "process during next read (MiB)",
+        "-", total_mib / (passes[1].overlapped_us / 1e6)
+    );
+
+    // Small reads of a 1 MiB file through LittleFS, which reads whole pages into its cache.
+    static uint8_t file_chunk[FLASH_CHIP_PAGE_SIZE_BYTES];
+    if (HOST_BENCH_reformat_filesystem() != 0) {
+        printf("  FAIL: format/mount\n");
+        FLASH_cache_read_enabled = original_cache_read_enabled;
+        return 1;
+    }
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, "bench_cache_read.bin", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+        printf("  FAIL: open for write\n");
+        FLASH_cache_read_enabled = original_cache_read_enabled;
+        return 1;
+    }
+    for (uint32_t chunk_num = 0; chunk_num < HOST_BENCH_FLASH_PAGE_COUNT; chunk_num++) {
+        memset(file_chunk, (uint8_t)chunk_num, sizeof(file_chunk));
+        if (lfs_file_write(&LFS_filesystem, &file, file_chunk, sizeof(file_chunk)) != (lfs_ssize_t)sizeof(file_chunk)) {
+            result = 1;
+            break;
+        }
+    }
+    lfs_file_close(&LFS_filesystem, &file);
+
+    uint64_t lfs_busy_us[2] = {0, 0};
+    for (uint8_t cache_read_enabled = 0; (cache_read_enabled < 2) && (result == 0); cache_read_enabled++) {
+        result = HOST_BENCH_flash_lfs_read_pass(cache_read_enabled, &lfs_busy_us[cache_read_enabled]);
+    }
+    lfs_remove(&LFS_filesystem, "bench_cache_read.bin");
+    FLASH_cache_read_enabled = original_cache_read_enabled;
+    if (result != 0) {
+        printf("  FAIL: LittleFS file read\n");
+        return 1;
+    }
+    printf(
+        "  %-34s %10.3f/s %10.3f/s\n", "LittleFS 64 B reads of file (MiB)",
+        total_mib / ((double)lfs_busy_us[0] / 1e6), total_mib / ((double)lfs_busy_us[1] / 1e6)
+    );
+
+    if (passes[1].cache_read_page_count == 0) {
+        printf("  FAIL: cache read mode was never used\n");
+        return 1;
+    }
+    return 0;
+}
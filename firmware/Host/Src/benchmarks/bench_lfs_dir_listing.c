@@ -0,0 +1,241 @@
+// bench_lfs_dir_listing.c
+// Host benchmark of paging through a large directory (`littlefs_dir_listing.c`): re-reading the
+// directory up to each page's offset (as before the cursor), continuing with the cursor, and
+// served from the in-RAM index. Every mode must return the same entries. Times are the NAND
+// emulator's modelled busy time, with the page cache off (it hides re-reads of a small directory).
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_dir_listing.h"
+#include "littlefs/littlefs_helper.h"
+#include "littlefs/littlefs_page_cache.h"
+#include "littlefs/littlefs_telecommands.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_BENCH_DIR_LISTING_DIR_PATH "/listing_dir"
+#define HOST_BENCH_DIR_LISTING_FILE_COUNT 200
+#define HOST_BENCH_DIR_LISTING_PAGE_ENTRY_COUNT 8
+
+// Concatenated entries of every page, for comparing the modes.
+static char HOST_BENCH_dir_listing_entries[HOST_BENCH_DIR_LISTING_FILE_COUNT * 48];
+
+typedef struct {
+    uint32_t page_count;
+    uint32_t flash_entry_read_count;
+    uint32_t page_read_count;
+    double busy_ms;
+} HOST_BENCH_dir_listing_result_t;
+
+typedef enum {
+    HOST_BENCH_DIR_LISTING_MODE_REREAD,
+    HOST_BENCH_DIR_LISTING_MODE_CURSOR,
+    HOST_BENCH_DIR_LISTING_MODE_INDEX,
+} HOST_BENCH_dir_listing_mode_enum_t;
+
+/// @brief Append the entries of a page (between the braces of `"entries":{...}` or `{...}`).
+/// @return Number of entries in the page.
+static uint32_t HOST_BENCH_dir_listing_append_entries(const char json[]) {
+    const char *start = strchr(json, '{');
+    if (strncmp(json, "{\"entries\":{", 12) == 0) {
+        start = &json[11];
+    }
+    const char *end = strchr(start, '}');
+    if ((start == NULL) || (end == NULL) || (end == (start + 1))) {
+        return 0;
+    }
+    const size_t used = strlen(HOST_BENCH_dir_listing_entries);
+    snprintf(
+        &HOST_BENCH_dir_listing_entries[used], sizeof(HOST_BENCH_dir_listing_entries) - used,
+        "%s%.*s", (used > 0) ? "," : "", (int)(end - start - 1), start + 1
+    );
+
+    uint32_t entry_count = 1;
+    for (const char *c = start + 1; c < end; c++) {
+        entry_count += (*c == ',') ? 1 : 0;
+    }
+    return entry_count;
+}
+
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_dir_listing_run(
+    HOST_BENCH_dir_listing_mode_enum_t mode, HOST_BENCH_dir_listing_result_t *result_out
+) {
+    *result_out = (HOST_BENCH_dir_listing_result_t){0};
+    HOST_BENCH_dir_listing_entries[0] = '\0';
+    if (mode != HOST_BENCH_DIR_LISTING_MODE_INDEX) {
+        LFS_dir_listing_reset();
+    }
+    LFS_dir_listing_reset_stats();
+    HOST_NAND_reset_stats();
+
+    char response[1024];
+    uint32_t cursor = 0;
+    while (1) {
+        int32_t list_result;
+        uint32_t page_entry_count;
+        if (mode == HOST_BENCH_DIR_LISTING_MODE_REREAD) {
+            // Forget the cursor and index, so the directory is read from its start to the offset.
+            LFS_dir_listing_reset();
+            list_result = LFS_list_directory_json_dict(
+                HOST_BENCH_DIR_LISTING_DIR_PATH, (uint16_t)cursor, HOST_BENCH_DIR_LISTING_PAGE_ENTRY_COUNT,
+                response, sizeof(response)
+            );
+            page_entry_count = HOST_BENCH_dir_listing_append_entries(response);
+            cursor += page_entry_count;
+        }
+        else {
+            list_result = LFS_list_directory_page_json(
+                HOST_BENCH_DIR_LISTING_DIR_PATH, cursor, HOST_BENCH_DIR_LISTING_PAGE_ENTRY_COUNT,
+                response, sizeof(response)
+            );
+            page_entry_count = HOST_BENCH_dir_listing_append_entries(response);
+            const char *next = strstr(response, "\"next\":");
+            if ((list_result == 0) && (next != NULL) && (strcmp(next, "\"next\":null}") == 0)) {
+                cursor = UINT32_MAX;
+            }
+            else if (next != NULL) {
+                cursor = (uint32_t)strtoul(next + 7, NULL, 10);
+            }
+        }
+        if (list_result != 0) {
+            printf("  FAIL: listing page %lu -> %ld\n", (unsigned long)result_out->page_count, (long)list_result);
+            return 1;
+        }
+        result_out->page_count++;
+        if ((page_entry_count == 0) || (cursor == UINT32_MAX)) {
+            break;
+        }
+    }
+
+    HOST_NAND_chip_stats_t stats;
+    HOST_NAND_get_total_stats(&stats);
+    result_out->page_read_count = stats.page_read_count;
+    result_out->busy_ms = (double)stats.modelled_busy_us / 1000.0;
+    result_out->flash_entry_read_count = LFS_dir_listing_stats.flash_entry_read_count;
+    return 0;
+}
+
+static void HOST_BENCH_dir_listing_print_row(const char label[], const HOST_BENCH_dir_listing_result_t *result) {
+    printf(
+        "  %-26s %7lu %12lu %11lu %10.2f\n",
+        label,
+        (unsigned long)result->page_count,
+        (unsigned long)result->flash_entry_read_count,
+        (unsigned long)result->page_read_count,
+        result->busy_ms
+    );
+}
+
+uint8_t HOST_BENCH_lfs_dir_listing(void) {
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    const uint32_t original_page_cache_page_count = LFS_page_cache_page_count;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+    LFS_page_cache_page_count = 0;
+
+    uint8_t result = 0;
+    if ((HOST_BENCH_reformat_filesystem() != 0) || (LFS_make_directory(HOST_BENCH_DIR_LISTING_DIR_PATH) != 0)) {
+        printf("  FAIL: create directory\n");
+        result = 1;
+    }
+    for (uint32_t i = 0; (result == 0) && (i < HOST_BENCH_DIR_LISTING_FILE_COUNT); i++) {
+        char path[64];
+        char contents[32];
+        snprintf(path, sizeof(path), HOST_BENCH_DIR_LISTING_DIR_PATH "/file_%03lu.bin", (unsigned long)i);
+        const int contents_len = snprintf(contents, sizeof(contents), "file %lu", (unsigned long)i);
+        if (LFS_write_file(path, (uint8_t *)contents, (uint32_t)contents_len) != 0) {
+            printf("  FAIL: create %s\n", path);
+            result = 1;
+        }
+    }
+
+    static char reread_entries[sizeof(HOST_BENCH_dir_listing_entries)];
+    HOST_BENCH_dir_listing_result_t reread_result;
+    HOST_BENCH_dir_listing_result_t cursor_result;
+    HOST_BENCH_dir_listing_result_t index_result;
+    if (result == 0) {
+        result = HOST_BENCH_dir_listing_run(HOST_BENCH_DIR_LISTING_MODE_REREAD, &reread_result);
+        strcpy(reread_entries, HOST_BENCH_dir_listing_entries);
+    }
+    if (result == 0) {
+        result = HOST_BENCH_dir_listing_run(HOST_BENCH_DIR_LISTING_MODE_CURSOR, &cursor_result);
+        if ((result == 0) && (strcmp(reread_entries, HOST_BENCH_dir_listing_entries) != 0)) {
+            printf("  FAIL: cursor listing doesn't match\n");
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        result = HOST_BENCH_dir_listing_run(HOST_BENCH_DIR_LISTING_MODE_INDEX, &index_result);
+        if ((result == 0) && (strcmp(reread_entries, HOST_BENCH_dir_listing_entries) != 0)) {
+            printf("  FAIL: index listing doesn't match\n");
+            result = 1;
+        }
+    }
+
+    // Creating a file through the helpers must drop the index.
+    if (result == 0) {
+        LFS_write_file(HOST_BENCH_DIR_LISTING_DIR_PATH "/zz_new.bin", (uint8_t *)"new", 3);
+        HOST_BENCH_dir_listing_result_t after_create_result;
+        result = HOST_BENCH_dir_listing_run(HOST_BENCH_DIR_LISTING_MODE_INDEX, &after_create_result);
+        if ((result == 0) && (strstr(HOST_BENCH_dir_listing_entries, "zz_new.bin") == NULL)) {
+            printf("  FAIL: new file missing from the listing after creating it\n");
+            result = 1;
+        }
+    }
+
+    // Appending to a file directly with `lfs_file_*` (like the log sinks do) must drop the index too.
+    if (result == 0) {
+        HOST_BENCH_dir_listing_result_t rebuild_result;
+        result = HOST_BENCH_dir_listing_run(HOST_BENCH_DIR_LISTING_MODE_INDEX, &rebuild_result);
+    }
+    if (result == 0) {
+        lfs_file_t file;
+        if (
+            (lfs_file_open(&LFS_filesystem, &file, HOST_BENCH_DIR_LISTING_DIR_PATH "/file_000.bin", LFS_O_WRONLY | LFS_O_APPEND) < 0)
+            || (lfs_file_write(&LFS_filesystem, &file, "0123456789", 10) != 10)
+            || (lfs_file_close(&LFS_filesystem, &file) < 0)
+        ) {
+            printf("  FAIL: append to file_000.bin\n");
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        HOST_BENCH_dir_listing_result_t after_append_result;
+        result = HOST_BENCH_dir_listing_run(HOST_BENCH_DIR_LISTING_MODE_INDEX, &after_append_result);
+        if ((result == 0) && (strstr(HOST_BENCH_dir_listing_entries, "/file_000.bin\":16") == NULL)) {
+            printf("  FAIL: listing shows the old size after a direct append\n");
+            result = 1;
+        }
+    }
+
+    LFS_dir_listing_reset();
+    LFS_page_cache_page_count = original_page_cache_page_count;
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    if (result != 0) {
+        return 1;
+    }
+
+    printf(
+        "  %u files in one directory, %u entries per page\n",
+        HOST_BENCH_DIR_LISTING_FILE_COUNT, HOST_BENCH_DIR_LISTING_PAGE_ENTRY_COUNT
+    );
+    printf("  %-26s %7s %12s %11s %10s\n", "", "pages", "dir entries", "page reads", "flash ms");
+    HOST_BENCH_dir_listing_print_row("re-read to offset", &reread_result);
+    HOST_BENCH_dir_listing_print_row("cursor", &cursor_result);
+    HOST_BENCH_dir_listing_print_row("index (second listing)", &index_result);
+    printf("  (dir entries: lfs_dir_read calls; page reads: NAND page reads)\n");
+
+    if (cursor_result.flash_entry_read_count > (HOST_BENCH_DIR_LISTING_FILE_COUNT + 2)) {
+        printf("  FAIL: the cursor re-read entries\n");
+        return 1;
+    }
+    if (index_result.flash_entry_read_count != 0) {
+        printf("  FAIL: the indexed listing read entries from flash\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,287 @@
+// bench_lfs_page_cache.c
+// Host benchmark of the block device page cache (`littlefs_page_cache.c`): mount, directory
+// listing, stat of every file, and small sequential reads of a file, with the cache off and on.
+// Times are the NAND emulator's modelled busy time, plus a 2 KiB copy for each cached page read.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/flash_driver.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+#include "littlefs/littlefs_page_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_BENCH_PAGE_CACHE_DIR_COUNT 4
+#define HOST_BENCH_PAGE_CACHE_FILES_PER_DIR 40
+#define HOST_BENCH_PAGE_CACHE_BIG_FILE_SIZE_BYTES (256 * 1024)
+
+// Copying a 2 KiB page (from the flash driver or the cache) at ~1 cycle per byte, at 16 MHz.
+#define HOST_BENCH_PAGE_CACHE_COPY_US 128
+
+typedef enum {
+    HOST_BENCH_PAGE_CACHE_STEP_MOUNT = 0,
+    HOST_BENCH_PAGE_CACHE_STEP_DIR_READ,
+    HOST_BENCH_PAGE_CACHE_STEP_STAT,
+    HOST_BENCH_PAGE_CACHE_STEP_FILE_READ,
+    HOST_BENCH_PAGE_CACHE_STEP_COUNT,
+} HOST_BENCH_page_cache_step_enum_t;
+
+static const char *HOST_BENCH_page_cache_step_names[HOST_BENCH_PAGE_CACHE_STEP_COUNT] = {
+    "mount",
+    "lfs_dir_read of all dirs",
+    "lfs_stat of every file",
+    "64 B reads of 256 KiB file",
+};
+
+typedef struct {
+    uint32_t page_read_count;
+    uint32_t cache_hit_count;
+    double time_us;
+} HOST_BENCH_page_cache_step_result_t;
+
+/// @brief Create the directories and files which the steps read.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_page_cache_create_files(void) {
+    char path[64];
+    char contents[96];
+    for (uint8_t dir_num = 0; dir_num < HOST_BENCH_PAGE_CACHE_DIR_COUNT; dir_num++) {
+        snprintf(path, sizeof(path), "cache_dir_%u", dir_num);
+        if (lfs_mkdir(&LFS_filesystem, path) < 0) {
+            return 1;
+        }
+        for (uint8_t file_num = 0; file_num < HOST_BENCH_PAGE_CACHE_FILES_PER_DIR; file_num++) {
+            snprintf(path, sizeof(path), "cache_dir_%u/file_%02u.txt", dir_num, file_num);
+            const int contents_len = snprintf(contents, sizeof(contents), "dir %u, file %u", dir_num, file_num);
+            lfs_file_t file;
+            if (lfs_file_open(&LFS_filesystem, &file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+                return 1;
+            }
+            const lfs_ssize_t written = lfs_file_write(&LFS_filesystem, &file, contents, (lfs_size_t)contents_len);
+            lfs_file_close(&LFS_filesystem, &file);
+            if (written != contents_len) {
+                return 1;
+            }
+        }
+    }
+
+    static uint8_t chunk[FLASH_CHIP_PAGE_SIZE_BYTES];
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, "cache_big.bin", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+        return 1;
+    }
+    uint8_t result = 0;
+    for (uint32_t offset = 0; offset < HOST_BENCH_PAGE_CACHE_BIG_FILE_SIZE_BYTES; offset += sizeof(chunk)) {
+        memset(chunk, (uint8_t)(offset / sizeof(chunk)), sizeof(chunk));
+        if (lfs_file_write(&LFS_filesystem, &file, chunk, sizeof(chunk)) != (lfs_ssize_t)sizeof(chunk)) {
+            result = 1;
+            break;
+        }
+    }
+    lfs_file_close(&LFS_filesystem, &file);
+    return result;
+}
+
+/// @brief Run one step.
+/// @param checksum_out Sum over everything read, to check that the cache returns the same data.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_page_cache_run_step(HOST_BENCH_page_cache_step_enum_t step, uint32_t *checksum_out) {
+    char path[64];
+    switch (step) {
+        case HOST_BENCH_PAGE_CACHE_STEP_MOUNT:
+            LFS_ensure_unmounted();
+            return (LFS_mount() == 0) ? 0 : 1;
+
+        case HOST_BENCH_PAGE_CACHE_STEP_DIR_READ:
+            for (uint8_t dir_num = 0; dir_num < HOST_BENCH_PAGE_CACHE_DIR_COUNT; dir_num++) {
+                snprintf(path, sizeof(path), "cache_dir_%u", dir_num);
+                lfs_dir_t dir;
+                if (lfs_dir_open(&LFS_filesystem, &dir, path) < 0) {
+                    return 1;
+                }
+                struct lfs_info info;
+                while (lfs_dir_read(&LFS_filesystem, &dir, &info) > 0) {
+                    *checksum_out += info.size + (uint8_t)info.name[0];
+                }
+                lfs_dir_close(&LFS_filesystem, &dir);
+            }
+            return 0;
+
+        case HOST_BENCH_PAGE_CACHE_STEP_STAT:
+            for (uint8_t dir_num = 0; dir_num < HOST_BENCH_PAGE_CACHE_DIR_COUNT; dir_num++) {
+                for (uint8_t file_num = 0; file_num < HOST_BENCH_PAGE_CACHE_FILES_PER_DIR; file_num++) {
+                    snprintf(path, sizeof(path), "cache_dir_%u/file_%02u.txt", dir_num, file_num);
+                    struct lfs_info info;
+                    if (lfs_stat(&LFS_filesystem, path, &info) < 0) {
+                        return 1;
+                    }
+                    *checksum_out += info.size;
+                }
+            }
+            return 0;
+
+        case HOST_BENCH_PAGE_CACHE_STEP_FILE_READ: {
+            lfs_file_t file;
+            if (lfs_file_open(&LFS_filesystem, &file, "cache_big.bin", LFS_O_RDONLY) < 0) {
+                return 1;
+            }
+            uint8_t chunk[64];
+            lfs_ssize_t bytes_read;
+            while ((bytes_read = lfs_file_read(&LFS_filesystem, &file, chunk, sizeof(chunk))) > 0) {
+                *checksum_out += chunk[0] + chunk[bytes_read - 1];
+            }
+            lfs_file_close(&LFS_filesystem, &file);
+            return (bytes_read == 0) ? 0 : 1;
+        }
+
+        default:
+            return 1;
+    }
+}
+
+/// @brief Run every step with the given cache size, starting from a freshly mounted filesystem.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_page_cache_run_pass(
+    uint32_t page_count, HOST_BENCH_page_cache_step_result_t results_out[], uint32_t checksums_out[]
+) {
+    LFS_page_cache_page_count = page_count;
+    for (uint8_t step = 0; step < HOST_BENCH_PAGE_CACHE_STEP_COUNT; step++) {
+        HOST_NAND_reset_stats();
+        LFS_page_cache_reset_stats();
+        checksums_out[step] = 0;
+        if (HOST_BENCH_page_cache_run_step((HOST_BENCH_page_cache_step_enum_t)step, &checksums_out[step]) != 0) {
+            printf("  FAIL: %s (page cache size %u)\n", HOST_BENCH_page_cache_step_names[step], page_count);
+            return 1;
+        }
+
+        HOST_NAND_chip_stats_t total;
+        HOST_NAND_get_total_stats(&total);
+        results_out[step].page_read_count = total.page_read_count;
+        results_out[step].cache_hit_count = LFS_page_cache_stats.hit_count;
+        results_out[step].time_us = (
+            (double)total.modelled_busy_us
+            + ((double)(total.page_read_count + LFS_page_cache_stats.hit_count) * HOST_BENCH_PAGE_CACHE_COPY_US)
+        );
+    }
+    return 0;
+}
+
+/// @brief Check that read-ahead stops at the first erased page of a block: program the first
+///     pages of a spare block, read them in order, and count the pages read ahead.
+static uint8_t HOST_BENCH_page_cache_check_read_ahead_stops_at_erased(void) {
+    // Use the last block of the last chip, like the NAND emulator self-test.
+    const uint8_t chip = FLASH_NUMBER_OF_FLASH_DEVICES - 1;
+    const uint32_t first_row = (HOST_NAND_BLOCKS_PER_CHIP - 1) * FLASH_CHIP_PAGES_PER_BLOCK;
+    const uint32_t programmed_page_count = 3;
+    static uint8_t page[FLASH_CHIP_PAGE_SIZE_BYTES];
+    uint8_t result = 0;
+
+    if (FLASH_erase_block(chip, (FLASH_Physical_Address_t){.row_address = first_row, .col_address = 0}) != FLASH_ERR_OK) {
+        printf("  FAIL: erase block for the read-ahead check\n");
+        return 1;
+    }
+    memset(page, 0xA5, sizeof(page));
+    for (uint32_t i = 0; i < programmed_page_count; i++) {
+        const FLASH_Physical_Address_t address = {.row_address = first_row + i, .col_address = 0};
+        if (FLASH_program_page(chip, address, page, sizeof(page)) != FLASH_ERR_OK) {
+            printf("  FAIL: program page for the read-ahead check\n");
+            return 1;
+        }
+    }
+
+    LFS_page_cache_page_count = LFS_PAGE_CACHE_MAX_PAGE_COUNT;
+    LFS_page_cache_invalidate_all();
+    LFS_page_cache_reset_stats();
+    for (uint32_t i = 0; i < programmed_page_count; i++) {
+        const FLASH_Physical_Address_t address = {.row_address = first_row + i, .col_address = 0};
+        if (LFS_page_cache_read(chip, address, page, 16) != FLASH_ERR_OK) {
+            printf("  FAIL: read page for the read-ahead check\n");
+            result = 1;
+        }
+    }
+
+    // Reading the last programmed page starts read-ahead, which should load only the erased page after it.
+    const uint32_t expected_read_ahead_count = (LFS_page_cache_read_ahead_page_count > 0) ? 1 : 0;
+    printf(
+        "  read-ahead after %u programmed pages: %u pages loaded (expected %u)\n",
+        programmed_page_count, LFS_page_cache_stats.read_ahead_page_count, expected_read_ahead_count
+    );
+    if (LFS_page_cache_stats.read_ahead_page_count != expected_read_ahead_count) {
+        printf("  FAIL: read-ahead continued past the first erased page\n");
+        result = 1;
+    }
+
+    LFS_page_cache_invalidate_all();
+    FLASH_erase_block(chip, (FLASH_Physical_Address_t){.row_address = first_row, .col_address = 0});
+    return result;
+}
+
+uint8_t HOST_BENCH_lfs_page_cache(void) {
+    const uint32_t original_page_count = LFS_page_cache_page_count;
+    uint8_t result = 0;
+
+    if ((HOST_BENCH_reformat_filesystem() != 0) || (HOST_BENCH_page_cache_create_files() != 0)) {
+        printf("  FAIL: create files\n");
+        return 1;
+    }
+
+    HOST_BENCH_page_cache_step_result_t results[2][HOST_BENCH_PAGE_CACHE_STEP_COUNT];
+    uint32_t checksums[2][HOST_BENCH_PAGE_CACHE_STEP_COUNT];
+    const uint32_t page_counts[2] = {0, LFS_PAGE_CACHE_MAX_PAGE_COUNT};
+    for (uint8_t pass = 0; (pass < 2) && (result == 0); pass++) {
+        result = HOST_BENCH_page_cache_run_pass(page_counts[pass], results[pass], checksums[pass]);
+    }
+    LFS_page_cache_page_count = original_page_count;
+    if (result != 0) {
+        return 1;
+    }
+
+    printf(
+        "  %u dirs of %u files; page cache of %u pages, read-ahead %u pages\n",
+        HOST_BENCH_PAGE_CACHE_DIR_COUNT, HOST_BENCH_PAGE_CACHE_FILES_PER_DIR,
+        LFS_PAGE_CACHE_MAX_PAGE_COUNT, LFS_page_cache_read_ahead_page_count
+    );
+    printf(
+        "  %-28s %10s %10s | %10s %10s %10s %8s\n",
+        "", "reads", "ms", "reads", "hits", "ms", "speedup"
+    );
+    for (uint8_t step = 0; step < HOST_BENCH_PAGE_CACHE_STEP_COUNT; step++) {
+        const HOST_BENCH_page_cache_step_result_t *off = &results[0][step];
+        const HOST_BENCH_page_cache_step_result_t *on = &results[1][step];
+        printf(
+            "  %-28s %10u %10.1f | %10u %10u %10.1f %7.2fx\n",
+            HOST_BENCH_page_cache_step_names[step],
+            off->page_read_count, off->time_us / 1000.0,
+            on->page_read_count, on->cache_hit_count, on->time_us / 1000.0,
+            off->time_us / on->time_us
+        );
+        if (checksums[0][step] != checksums[1][step]) {
+            printf("  FAIL: %s read different data with the cache on\n", HOST_BENCH_page_cache_step_names[step]);
+            result = 1;
+        }
+        if (on->page_read_count > off->page_read_count) {
+            printf("  FAIL: %s read more pages with the cache on\n", HOST_BENCH_page_cache_step_names[step]);
+            result = 1;
+        }
+    }
+
+    const uint32_t stats_page_count = LFS_page_cache_page_count;
+    if (HOST_BENCH_page_cache_check_read_ahead_stops_at_erased() != 0) {
+        result = 1;
+    }
+    LFS_page_cache_page_count = stats_page_count;
+
+    // Clean up, so that later benchmarks start from a small filesystem.
+    char path[64];
+    for (uint8_t dir_num = 0; dir_num < HOST_BENCH_PAGE_CACHE_DIR_COUNT; dir_num++) {
+        for (uint8_t file_num = 0; file_num < HOST_BENCH_PAGE_CACHE_FILES_PER_DIR; file_num++) {
+            snprintf(path, sizeof(path), "cache_dir_%u/file_%02u.txt", dir_num, file_num);
+            lfs_remove(&LFS_filesystem, path);
+        }
+        snprintf(path, sizeof(path), "cache_dir_%u", dir_num);
+        lfs_remove(&LFS_filesystem, path);
+    }
+    lfs_remove(&LFS_filesystem, "cache_big.bin");
+    return result;
+}
@@ -0,0 +1,461 @@
+// bench_littlefs.c
+// Host benchmarks and self-tests for the NAND emulator and LittleFS.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/flash_driver.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+#include "littlefs/littlefs_driver.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/// @brief Print the NAND emulator's total counters, plus the time the flight hardware would take.
+void HOST_BENCH_print_nand_stats(const char label[]) {
+    HOST_NAND_chip_stats_t total;
+    HOST_NAND_get_total_stats(&total);
+    printf(
+        "  [%s] NAND: reads=%u programs=%u erases=%u read_bytes=%llu programmed_bytes=%llu "
+        "program_without_erase=%u modelled_busy=%.1f ms\n",
+        label,
+        total.page_read_count, total.page_program_count, total.block_erase_count,
+        (unsigned long long)total.bytes_read, (unsigned long long)total.bytes_programmed,
+        total.program_without_erase_count,
+        (double)total.modelled_busy_us / 1000.0
+    );
+}
+
+/// @brief Unmount, format, and remount the filesystem, so that each benchmark starts from empty.
+/// @return 0 on success, 1 on failure.
+uint8_t HOST_BENCH_reformat_filesystem(void) {
+    LFS_ensure_unmounted();
+    if (LFS_format() != 0) {
+        return 1;
+    }
+    if (LFS_mount() != 0) {
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Check that the emulator behaves like NAND: erased reads 0xFF, programming only clears
+///     bits, erase restores 0xFF, and bad blocks fail.
+uint8_t HOST_BENCH_nand_emulator_self_test(void) {
+    // Use the last block of the last chip, which LittleFS is unlikely to touch.
+    const uint8_t chip = FLASH_NUMBER_OF_FLASH_DEVICES - 1;
+    const uint32_t block = HOST_NAND_BLOCKS_PER_CHIP - 1;
+    const FLASH_Physical_Address_t addr = {
+        .row_address = block * FLASH_CHIP_PAGES_PER_BLOCK,
+        .col_address = 0,
+    };
+    uint8_t buf[FLASH_CHIP_PAGE_SIZE_BYTES];
+    uint8_t data[FLASH_CHIP_PAGE_SIZE_BYTES];
+
+    if (FLASH_erase_block(chip, addr) != FLASH_ERR_OK) {
+        printf("  FAIL: erase\n");
+        return 1;
+    }
+    FLASH_read_page(chip, addr, buf, sizeof(buf));
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+        if (buf[i] != 0xFF) {
+            printf("  FAIL: erased page byte %u is 0x%02X\n", i, buf[i]);
+            return 1;
+        }
+    }
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7);
+    }
+    FLASH_program_page(chip, addr, data, sizeof(data));
+    FLASH_read_page(chip, addr, buf, sizeof(buf));
+    if (memcmp(buf, data, sizeof(data)) != 0) {
+        printf("  FAIL: read-back after program\n");
+        return 1;
+    }
+
+    // Programming again without an erase can only clear bits.
+    const uint32_t pwe_before = HOST_NAND_get_chip_stats(chip)->program_without_erase_count;
+    memset(data, 0xF0, sizeof(data));
+    FLASH_program_page(chip, addr, data, sizeof(data));
+    FLASH_read_page(chip, addr, buf, sizeof(buf));
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+        if (buf[i] != ((uint8_t)(i * 7) & 0xF0)) {
+            printf("  FAIL: program without erase did not AND at byte %u\n", i);
+            return 1;
+        }
+    }
+    if (HOST_NAND_get_chip_stats(chip)->program_without_erase_count == pwe_before) {
+        printf("  FAIL: program without erase not counted\n");
+        return 1;
+    }
+
+    FLASH_erase_block(chip, addr);
+    FLASH_read_page(chip, addr, buf, sizeof(buf));
+    if (buf[0] != 0xFF || buf[sizeof(buf) - 1] != 0xFF) {
+        printf("  FAIL: erase did not restore 0xFF\n");
+        return 1;
+    }
+
+    HOST_NAND_set_block_bad(chip, block, 1);
+    const FLASH_error_enum_t bad_erase_result = FLASH_erase_block(chip, addr);
+    HOST_NAND_set_block_bad(chip, block, 0);
+    if (bad_erase_result == FLASH_ERR_OK) {
+        printf("  FAIL: erase of bad block succeeded\n");
+        return 1;
+    }
+
+    printf("  PASS\n");
+    return 0;
+}
+
+/// @brief Write then read back a 1 MiB file through LittleFS, in page-sized chunks.
+uint8_t HOST_BENCH_lfs_write_read(void) {
+    const uint32_t chunk_size = FLASH_CHIP_PAGE_SIZE_BYTES;
+    const uint32_t chunk_count = 512;
+    static uint8_t chunk[FLASH_CHIP_PAGE_SIZE_BYTES];
+
+    if (HOST_BENCH_reformat_filesystem() != 0) {
+        printf("  FAIL: format/mount\n");
+        return 1;
+    }
+
+    HOST_NAND_reset_stats();
+    uint64_t start_us = HOST_get_monotonic_time_us();
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, "bench_write_read.bin", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+        printf("  FAIL: open for write\n");
+        return 1;
+    }
+    for (uint32_t chunk_num = 0; chunk_num < chunk_count; chunk_num++) {
+        memset(chunk, (uint8_t)chunk_num, chunk_size);
+        if (lfs_file_write(&LFS_filesystem, &file, chunk, chunk_size) != (lfs_ssize_t)chunk_size) {
+            printf("  FAIL: write chunk %u\n", chunk_num);
+            lfs_file_close(&LFS_filesystem, &file);
+            return 1;
+        }
+    }
+    lfs_file_close(&LFS_filesystem, &file);
+    const uint64_t write_wall_us = HOST_get_monotonic_time_us() - start_us;
+
+    HOST_NAND_chip_stats_t write_stats;
+    HOST_NAND_get_total_stats(&write_stats);
+    HOST_BENCH_print_nand_stats("write");
+
+    HOST_NAND_reset_stats();
+    start_us = HOST_get_monotonic_time_us();
+    if (lfs_file_open(&LFS_filesystem, &file, "bench_write_read.bin", LFS_O_RDONLY) < 0) {
+        printf("  FAIL: open for read\n");
+        return 1;
+    }
+    for (uint32_t chunk_num = 0; chunk_num < chunk_count; chunk_num++) {
+        if (lfs_file_read(&LFS_filesystem, &file, chunk, chunk_size) != (lfs_ssize_t)chunk_size) {
+            printf("  FAIL: read chunk %u\n", chunk_num);
+            lfs_file_close(&LFS_filesystem, &file);
+            return 1;
+        }
+        if (chunk[0] != (uint8_t)chunk_num || chunk[chunk_size - 1] != (uint8_t)chunk_num) {
+            printf("  FAIL: data mismatch in chunk %u\n", chunk_num);
+            lfs_file_close(&LFS_filesystem, &file);
+            return 1;
+        }
+    }
+    lfs_file_close(&LFS_filesystem, &file);
+    const uint64_t read_wall_us = HOST_get_monotonic_time_us() - start_us;
+
+    HOST_NAND_chip_stats_t read_stats;
+    HOST_NAND_get_total_stats(&read_stats);
+    HOST_BENCH_print_nand_stats("read");
+
+    const double total_mib = (double)(chunk_size * chunk_count) / (1024.0 * 1024.0);
+    printf(
+        "  write: %.2f MiB in %.1f ms host, modelled flight throughput %.3f MiB/s\n",
+        total_mib, (double)write_wall_us / 1000.0,
+        total_mib / ((double)write_stats.modelled_busy_us / 1e6)
+    );
+    printf(
+        "  read:  %.2f MiB in %.1f ms host, modelled flight throughput %.3f MiB/s\n",
+        total_mib, (double)read_wall_us / 1000.0,
+        total_mib / ((double)read_stats.modelled_busy_us / 1e6)
+    );
+    return 0;
+}
+
+/// @brief Write a file of `chunk_count` page-sized chunks (each filled with its chunk number).
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_write_pattern_file(const char file_name[], uint32_t chunk_count) {
+    static uint8_t chunk[FLASH_CHIP_PAGE_SIZE_BYTES];
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, file_name, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+        printf("  FAIL: open %s for write\n", file_name);
+        return 1;
+    }
+    for (uint32_t chunk_num = 0; chunk_num < chunk_count; chunk_num++) {
+        memset(chunk, (uint8_t)chunk_num, sizeof(chunk));
+        if (lfs_file_write(&LFS_filesystem, &file, chunk, sizeof(chunk)) != (lfs_ssize_t)sizeof(chunk)) {
+            printf("  FAIL: write %s chunk %u\n", file_name, chunk_num);
+            lfs_file_close(&LFS_filesystem, &file);
+            return 1;
+        }
+    }
+    if (lfs_file_close(&LFS_filesystem, &file) < 0) {
+        printf("  FAIL: close %s\n", file_name);
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Read back and check a file written by `HOST_BENCH_write_pattern_file`.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_verify_pattern_file(const char file_name[], uint32_t chunk_count) {
+    static uint8_t chunk[FLASH_CHIP_PAGE_SIZE_BYTES];
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, file_name, LFS_O_RDONLY) < 0) {
+        printf("  FAIL: open %s for read\n", file_name);
+        return 1;
+    }
+    for (uint32_t chunk_num = 0; chunk_num < chunk_count; chunk_num++) {
+        if (lfs_file_read(&LFS_filesystem, &file, chunk, sizeof(chunk)) != (lfs_ssize_t)sizeof(chunk)) {
+            printf("  FAIL: read %s chunk %u\n", file_name, chunk_num);
+            lfs_file_close(&LFS_filesystem, &file);
+            return 1;
+        }
+        for (uint32_t i = 0; i < sizeof(chunk); i++) {
+            if (chunk[i] != (uint8_t)chunk_num) {
+                printf("  FAIL: %s data mismatch in chunk %u\n", file_name, chunk_num);
+                lfs_file_close(&LFS_filesystem, &file);
+                return 1;
+            }
+        }
+    }
+    lfs_file_close(&LFS_filesystem, &file);
+    return 0;
+}
+
+/// @brief Re-scan the chips, then format with the given block-to-chip layout.
+static uint8_t HOST_BENCH_reformat_with_layout(LFS_chip_layout_enum_t layout) {
+    LFS_ensure_unmounted();
+    LFS_chip_layout_for_format = layout;
+    LFS_block_device_init();
+    return HOST_BENCH_reformat_filesystem();
+}
+
+/// @brief Unmount, then re-scan the chips and mount as at boot, starting from `initial_layout`.
+static uint8_t HOST_BENCH_remount_as_after_reboot(LFS_chip_layout_enum_t initial_layout) {
+    LFS_ensure_unmounted();
+    LFS_block_device_set_layout(initial_layout);
+    LFS_block_device_init();
+    return (LFS_mount() == 0) ? 0 : 1;
+}
+
+/// @brief Compare the concatenate and stripe layouts: where the programs/erases land, and the
+///     modelled flight time if each chip's operations could overlap with the other chips'.
+uint8_t HOST_BENCH_lfs_chip_layouts(void) {
+    const uint32_t chunk_count = 8192; // 16 MiB
+    const LFS_chip_layout_enum_t layouts[] = {LFS_CHIP_LAYOUT_CONCATENATE, LFS_CHIP_LAYOUT_STRIPE};
+    uint8_t result = 0;
+
+    for (uint8_t layout_idx = 0; layout_idx < sizeof(layouts) / sizeof(layouts[0]); layout_idx++) {
+        if (HOST_BENCH_reformat_with_layout(layouts[layout_idx]) != 0) {
+            printf("  FAIL: format/mount\n");
+            result = 1;
+            break;
+        }
+        HOST_NAND_reset_stats();
+        if (HOST_BENCH_write_pattern_file("bench_layout.bin", chunk_count) != 0) {
+            result = 1;
+            break;
+        }
+
+        uint64_t serial_busy_us = 0;
+        uint64_t max_chip_busy_us = 0;
+        printf("  layout=%s:\n", LFS_chip_layout_enum_to_str(LFS_chip_layout));
+        for (uint8_t chip = 0; chip < LFS_NUMBER_OF_FLASH_CHIPS; chip++) {
+            const HOST_NAND_chip_stats_t *stats = HOST_NAND_get_chip_stats(chip);
+            printf(
+                "    chip %u: programs=%u erases=%u busy=%.1f ms\n",
+                chip, stats->page_program_count, stats->block_erase_count,
+                (double)stats->modelled_busy_us / 1000.0
+            );
+            serial_busy_us += stats->modelled_busy_us;
+            if (stats->modelled_busy_us > max_chip_busy_us) {
+                max_chip_busy_us = stats->modelled_busy_us;
+            }
+        }
+        printf(
+            "    16 MiB write: modelled %.1f ms serial, %.1f ms with chips overlapping\n",
+            (double)serial_busy_us / 1000.0, (double)max_chip_busy_us / 1000.0
+        );
+
+        if (HOST_BENCH_verify_pattern_file("bench_layout.bin", chunk_count) != 0) {
+            result = 1;
+            break;
+        }
+
+        // After a reboot, the boot-time layout may not be the formatted one. Mounting must follow
+        // the layout recorded in the filesystem.
+        const LFS_chip_layout_enum_t other_layout = (layouts[layout_idx] == LFS_CHIP_LAYOUT_STRIPE)
+            ? LFS_CHIP_LAYOUT_CONCATENATE : LFS_CHIP_LAYOUT_STRIPE;
+        if (
+            (HOST_BENCH_remount_as_after_reboot(other_layout) != 0)
+            || (LFS_chip_layout != layouts[layout_idx])
+        ) {
+            printf(
+                "  FAIL: remount starting from %s gave layout %s\n",
+                LFS_chip_layout_enum_to_str(other_layout), LFS_chip_layout_enum_to_str(LFS_chip_layout)
+            );
+            result = 1;
+            break;
+        }
+        if (HOST_BENCH_verify_pattern_file("bench_layout.bin", chunk_count) != 0) {
+            result = 1;
+            break;
+        }
+        printf("    remount starting from %s: layout detected\n", LFS_chip_layout_enum_to_str(other_layout));
+    }
+
+    HOST_BENCH_reformat_with_layout(LFS_CHIP_LAYOUT_CONCATENATE);
+    return result;
+}
+
+/// @brief Format a single-chip filesystem (the original layout), then check that mounting it grows
+///     it to all chips, keeps its files, and can then store more than one chip's worth of data.
+uint8_t HOST_BENCH_lfs_grow_from_single_chip(void) {
+    const uint32_t small_file_chunk_count = 64;
+    // A bit more than one chip's capacity, so the data must go past chip 0.
+    const uint32_t large_file_chunk_count = (LFS_BLOCKS_PER_CHIP + 64) * FLASH_CHIP_PAGES_PER_BLOCK;
+
+    LFS_ensure_unmounted();
+    LFS_chip_layout_for_format = LFS_CHIP_LAYOUT_CONCATENATE;
+    LFS_block_device_init();
+
+    const lfs_size_t configured_block_count = LFS_cfg.block_count;
+    LFS_cfg.block_count = LFS_BLOCKS_PER_CHIP;
+    const uint8_t single_chip_format_result = HOST_BENCH_reformat_filesystem();
+    if (single_chip_format_result == 0) {
+        HOST_BENCH_write_pattern_file("before_grow.bin", small_file_chunk_count);
+    }
+    LFS_ensure_unmounted();
+    LFS_cfg.block_count = configured_block_count;
+    if (single_chip_format_result != 0) {
+        printf("  FAIL: single-chip format\n");
+        return 1;
+    }
+
+    if (LFS_mount() != 0) {
+        printf("  FAIL: mount (grow) of single-chip filesystem\n");
+        return 1;
+    }
+    struct lfs_fsinfo fs_info;
+    lfs_fs_stat(&LFS_filesystem, &fs_info);
+    printf("  block_count after mount: %u (expected %u)\n", fs_info.block_count, LFS_TOTAL_BLOCK_COUNT);
+    if (fs_info.block_count != LFS_TOTAL_BLOCK_COUNT) {
+        printf("  FAIL: filesystem not grown\n");
+        return 1;
+    }
+    if (HOST_BENCH_verify_pattern_file("before_grow.bin", small_file_chunk_count) != 0) {
+        return 1;
+    }
+
+    HOST_NAND_reset_stats();
+    if (HOST_BENCH_write_pattern_file("after_grow.bin", large_file_chunk_count) != 0) {
+        return 1;
+    }
+    printf("  wrote %u MiB; chip 1 programs: %u\n",
+        (large_file_chunk_count * FLASH_CHIP_PAGE_SIZE_BYTES) >> 20,
+        HOST_NAND_get_chip_stats(1)->page_program_count
+    );
+    if (HOST_NAND_get_chip_stats(1)->page_program_count == 0) {
+        printf("  FAIL: no data written past chip 0\n");
+        return 1;
+    }
+    if (HOST_BENCH_verify_pattern_file("after_grow.bin", large_file_chunk_count) != 0) {
+        return 1;
+    }
+
+    printf("  PASS\n");
+    HOST_BENCH_reformat_with_layout(LFS_CHIP_LAYOUT_CONCATENATE);
+    return 0;
+}
+
+/// @brief Check that factory-marked bad blocks are skipped, that blocks which fail erase or
+///     program at runtime are relocated by LittleFS without losing data, and that those are still
+///     known to be bad after a reboot.
+uint8_t HOST_BENCH_lfs_bad_blocks(void) {
+    const uint32_t chunk_count = 4096; // 8 MiB
+    uint8_t result = 0;
+
+    // Factory-marked bad blocks, found by the scan in `LFS_block_device_init()`.
+    // Not in blocks 0/1 of the filesystem, which LittleFS requires for the superblock.
+    HOST_NAND_set_block_bad(1, 5, 1);
+    HOST_NAND_set_block_bad(2, 3, 1);
+    if (HOST_BENCH_reformat_with_layout(LFS_CHIP_LAYOUT_STRIPE) != 0) {
+        printf("  FAIL: format/mount\n");
+        result = 1;
+        goto cleanup;
+    }
+    printf(
+        "  after scan: bad blocks per chip = [%u, %u, %u, %u]\n",
+        LFS_chip_stats[0].bad_block_count, LFS_chip_stats[1].bad_block_count,
+        LFS_chip_stats[2].bad_block_count, LFS_chip_stats[3].bad_block_count
+    );
+    if ((LFS_chip_stats[1].bad_block_count != 1) || (LFS_chip_stats[2].bad_block_count != 1)) {
+        printf("  FAIL: factory bad blocks not found by scan\n");
+        result = 1;
+        goto cleanup;
+    }
+
+    // Blocks which go bad after the scan (every second block on chip 3), without a factory marker.
+    for (uint32_t block = 1; block < HOST_NAND_BLOCKS_PER_CHIP; block += 2) {
+        HOST_NAND_set_block_worn(3, block, 1);
+    }
+    if (HOST_BENCH_write_pattern_file("bench_bad_blocks.bin", chunk_count) != 0) {
+        result = 1;
+        goto cleanup;
+    }
+    if (HOST_BENCH_verify_pattern_file("bench_bad_blocks.bin", chunk_count) != 0) {
+        result = 1;
+        goto cleanup;
+    }
+    printf(
+        "  after write: bad blocks on chip 3 = %u, failed erase/program = %u\n",
+        LFS_chip_stats[3].bad_block_count, LFS_chip_stats[3].failed_erase_or_program_count
+    );
+    if (LFS_chip_stats[3].failed_erase_or_program_count == 0) {
+        printf("  FAIL: runtime bad blocks never hit\n");
+        result = 1;
+        goto cleanup;
+    }
+
+    // The runtime bad blocks must be marked in flash, so that the scan at boot finds them.
+    const uint16_t runtime_bad_block_count = LFS_chip_stats[3].bad_block_count;
+    if (HOST_BENCH_remount_as_after_reboot(LFS_CHIP_LAYOUT_CONCATENATE) != 0) {
+        printf("  FAIL: remount\n");
+        result = 1;
+        goto cleanup;
+    }
+    printf("  after reboot: bad blocks on chip 3 = %u\n", LFS_chip_stats[3].bad_block_count);
+    if (LFS_chip_stats[3].bad_block_count != runtime_bad_block_count) {
+        printf("  FAIL: runtime bad blocks not persisted (expected %u)\n", runtime_bad_block_count);
+        result = 1;
+        goto cleanup;
+    }
+    if (HOST_BENCH_verify_pattern_file("bench_bad_blocks.bin", chunk_count) != 0) {
+        result = 1;
+        goto cleanup;
+    }
+    printf("  PASS\n");
+
+cleanup:
+    HOST_NAND_set_block_bad(1, 5, 0);
+    HOST_NAND_set_block_bad(2, 3, 0);
+    for (uint32_t block = 1; block < HOST_NAND_BLOCKS_PER_CHIP; block += 2) {
+        HOST_NAND_set_block_worn(3, block, 0);
+        // Erasing clears the programmed bad block marker.
+        const FLASH_Physical_Address_t block_address = {.row_address = block * FLASH_CHIP_PAGES_PER_BLOCK};
+        FLASH_erase_block(3, block_address);
+    }
+    HOST_BENCH_reformat_with_layout(LFS_CHIP_LAYOUT_CONCATENATE);
+    return result;
+}
@@ -0,0 +1,250 @@
+// bench_log_binary.c
+// Host benchmark of binary log records (see `log_binary.c`) vs. text log lines, for the same
+// messages: bytes per message, CPU time to encode vs. to render, and UHF downlink airtime.
+// Also checks that every decoded record renders to the same text line as the original, and that
+// the in-memory log table (which stores binary records) reads back its newest entries.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "comms_drivers/ax100_tx.h"
+#include "comms_drivers/comms_tx.h"
+#include "log/log.h"
+#include "log/log_binary.h"
+#include "log/log_queue.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_BENCH_LOG_BINARY_ROUNDS 100
+#define HOST_BENCH_LOG_BINARY_MESSAGES_PER_ROUND 8
+#define HOST_BENCH_LOG_BINARY_RECORD_COUNT (HOST_BENCH_LOG_BINARY_ROUNDS * HOST_BENCH_LOG_BINARY_MESSAGES_PER_ROUND)
+
+// Repeat the timed loops, so that the times are well above the clock resolution.
+#define HOST_BENCH_LOG_BINARY_TIMING_REPEATS 20
+
+// UHF downlink at 9600 bps (8 bits per byte), counting the CSP header and the packet type byte.
+#define HOST_BENCH_LOG_BINARY_UHF_BITS_PER_SECOND 9600.0
+
+#define HOST_BENCH_LOG_BINARY_LINE_SIZE 256
+
+static LOG_record_t HOST_BENCH_log_binary_records[HOST_BENCH_LOG_BINARY_RECORD_COUNT];
+
+/// @brief Log one round of messages, like those on the MPI, LFS, EPS and telecommand paths.
+static void HOST_BENCH_log_binary_log_round(uint32_t round) {
+    const char *file_name = "mpi/2026-10-17T120000_science.bin";
+
+    LOG_message(
+        LOG_SYSTEM_MPI, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "MPI: wrote %lu bytes to '%s' (total %lu bytes)", 2048UL, file_name, (unsigned long)(round * 2048UL)
+    );
+    LOG_message(
+        LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
+        "lfs_file_write(%s) -> %ld", file_name, -28L
+    );
+    LOG_message(
+        LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "Executed telecommand '%s' (tssent=%llu) in %u ms: err=%d", "fs_list_directory",
+        1760702400000ULL + round, round % 97, 0
+    );
+    LOG_message(
+        LOG_SYSTEM_EPS, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
+        "EPS: battery at %5.2f V, %d%% charged, mode %c", 7.4 + (round % 10) * 0.01, 83, 'N'
+    );
+    LOG_message(
+        LOG_SYSTEM_FLASH, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "chip %u, addr 0x%08X, %-6s|%.*s|", round % 8, round * 2048U, "prog", 4, "statusword"
+    );
+    LOG_message(
+        LOG_SYSTEM_OBC, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "Heartbeat %lu", (unsigned long)round
+    );
+    LOG_message(
+        LOG_SYSTEM_ADCS, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "ADCS: wheel speeds %d, %d, %d rpm; est. rate %ld mdeg/s", -1200 + (int)round, 15, 3400, -73L
+    );
+    LOG_message(
+        LOG_SYSTEM_LOG, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "No arguments at all, 100%% static text."
+    );
+}
+
+/// @brief Capture every round into `HOST_BENCH_log_binary_records`, via the logger task's queue.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_log_binary_capture_records(void) {
+    uint32_t record_num = 0;
+    for (uint32_t round = 0; round < HOST_BENCH_LOG_BINARY_ROUNDS; round++) {
+        HOST_BENCH_log_binary_log_round(round);
+        const LOG_record_t *record;
+        while ((record = LOG_queue_peek_front()) != NULL) {
+            if (record_num < HOST_BENCH_LOG_BINARY_RECORD_COUNT) {
+                HOST_BENCH_log_binary_records[record_num] = *record;
+            }
+            record_num++;
+            LOG_queue_release_front();
+        }
+    }
+    if (record_num != HOST_BENCH_LOG_BINARY_RECORD_COUNT) {
+        printf("  FAIL: captured %u records, expected %u\n", record_num, HOST_BENCH_LOG_BINARY_RECORD_COUNT);
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Airtime of one log message packet, in ms.
+static double HOST_BENCH_log_binary_packet_airtime_ms(uint16_t data_len) {
+    if (data_len > COMMS_LOG_MESSAGE_PACKET_MAX_DATA_BYTES_PER_PACKET) {
+        data_len = COMMS_LOG_MESSAGE_PACKET_MAX_DATA_BYTES_PER_PACKET;
+    }
+    const uint16_t packet_len = AX100_CSP_HEADER_LENGTH_BYTES + 1 + data_len;
+    return (double)packet_len * 8.0 * 1000.0 / HOST_BENCH_LOG_BINARY_UHF_BITS_PER_SECOND;
+}
+
+/// @brief Check that the newest entries of the in-memory log table read back.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_log_binary_check_memory_table(void) {
+    for (uint32_t round = 0; round < 32; round++) {
+        HOST_BENCH_log_binary_log_round(round);
+        LOG_process_queued_messages(UINT32_MAX);
+    }
+
+    // All 128 entries must still have their bytes in the ring.
+    const uint8_t max_entries = LOG_memory_table_max_entries();
+    const uint8_t newest_index = LOG_get_memory_table_index_of_most_recent_log_entry();
+    for (uint8_t age = 0; age < max_entries; age++) {
+        const uint8_t index = (uint8_t)((newest_index + max_entries - age) % max_entries);
+        const char *line = LOG_get_memory_table_full_message_at_index(index);
+        if ((strstr(line, "]: ") == NULL) || (line[strlen(line) - 1] != '\n')) {
+            printf("  FAIL: in-memory log entry %u (age %u) did not read back: '%s'\n", index, age, line);
+            return 1;
+        }
+    }
+    const char *newest_line = LOG_get_memory_table_full_message_at_index(newest_index);
+    if (strcmp(strstr(newest_line, "]: "), "]: No arguments at all, 100% static text.\n") != 0) {
+        printf("  FAIL: newest in-memory log entry is wrong: %s", newest_line);
+        return 1;
+    }
+    printf("  In-memory log table: all %u entries read back from the binary ring\n", max_entries);
+    return 0;
+}
+
+uint8_t HOST_BENCH_log_binary(void) {
+    const uint32_t original_deferred = LOG_deferred_formatting_enabled;
+    const uint8_t original_running = LOG_logger_task_is_running;
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+    LOG_process_queued_messages(UINT32_MAX);
+    LOG_deferred_formatting_enabled = 1;
+    LOG_logger_task_is_running = 1;
+
+    uint8_t result = HOST_BENCH_log_binary_capture_records();
+
+    static char line[HOST_BENCH_LOG_BINARY_LINE_SIZE];
+    static char decoded_line[HOST_BENCH_LOG_BINARY_LINE_SIZE];
+    static uint8_t record_bytes[LOG_BINARY_RECORD_MAX_LENGTH];
+    static LOG_record_t decoded_record;
+
+    uint64_t text_byte_count = 0;
+    uint64_t binary_byte_count = 0;
+    double text_airtime_ms = 0;
+    double binary_airtime_ms = 0;
+    uint32_t text_fallback_count = 0;
+    uint32_t preformatted_count = 0;
+    for (uint32_t record_num = 0; (record_num < HOST_BENCH_LOG_BINARY_RECORD_COUNT) && (result == 0); record_num++) {
+        const LOG_record_t *record = &HOST_BENCH_log_binary_records[record_num];
+        LOG_format_record_line(record, line, sizeof(line));
+        const int16_t record_len = LOG_binary_encode_record(record, record_bytes, sizeof(record_bytes));
+        if (record_len <= 0) {
+            printf("  FAIL: could not encode: %s", line);
+            result = 1;
+            break;
+        }
+
+        // Round trip: the ground decodes the record with the format string from the table.
+        const int16_t decode_result = LOG_binary_decode_record(record_bytes, (uint16_t)record_len, record->fmt, &decoded_record);
+        if (decode_result != record_len) {
+            printf("  FAIL: decoding returned %d for a %d-byte record: %s", decode_result, record_len, line);
+            result = 1;
+            break;
+        }
+        LOG_format_record_line(&decoded_record, decoded_line, sizeof(decoded_line));
+        if (strcmp(line, decoded_line) != 0) {
+            printf("  FAIL: round trip differs:\n    text:    %s    decoded: %s", line, decoded_line);
+            result = 1;
+            break;
+        }
+
+        const uint16_t line_len = (uint16_t)strlen(line);
+        text_byte_count += line_len;
+        binary_byte_count += (uint64_t)record_len;
+        text_airtime_ms += HOST_BENCH_log_binary_packet_airtime_ms(line_len);
+        if (record_len <= COMMS_LOG_MESSAGE_PACKET_MAX_DATA_BYTES_PER_PACKET) {
+            binary_airtime_ms += HOST_BENCH_log_binary_packet_airtime_ms((uint16_t)record_len);
+        }
+        else {
+            binary_airtime_ms += HOST_BENCH_log_binary_packet_airtime_ms(line_len);
+            text_fallback_count++;
+        }
+        if (record_bytes[5] & 0x80) {
+            preformatted_count++;
+        }
+    }
+
+    // Timing: render every record as text vs. encode every record.
+    uint64_t text_us = 0;
+    uint64_t binary_us = 0;
+    if (result == 0) {
+        const uint64_t text_start_us = HOST_get_monotonic_time_us();
+        for (uint32_t repeat = 0; repeat < HOST_BENCH_LOG_BINARY_TIMING_REPEATS; repeat++) {
+            for (uint32_t record_num = 0; record_num < HOST_BENCH_LOG_BINARY_RECORD_COUNT; record_num++) {
+                LOG_format_record_line(&HOST_BENCH_log_binary_records[record_num], line, sizeof(line));
+            }
+        }
+        text_us = HOST_get_monotonic_time_us() - text_start_us;
+
+        const uint64_t binary_start_us = HOST_get_monotonic_time_us();
+        for (uint32_t repeat = 0; repeat < HOST_BENCH_LOG_BINARY_TIMING_REPEATS; repeat++) {
+            for (uint32_t record_num = 0; record_num < HOST_BENCH_LOG_BINARY_RECORD_COUNT; record_num++) {
+                LOG_binary_encode_record(&HOST_BENCH_log_binary_records[record_num], record_bytes, sizeof(record_bytes));
+            }
+        }
+        binary_us = HOST_get_monotonic_time_us() - binary_start_us;
+    }
+
+    if (result == 0) {
+        result = HOST_BENCH_log_binary_check_memory_table();
+    }
+
+    LOG_deferred_formatting_enabled = original_deferred;
+    LOG_logger_task_is_running = original_running;
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    if (result != 0) {
+        return 1;
+    }
+
+    const double message_count = HOST_BENCH_LOG_BINARY_RECORD_COUNT;
+    const double timed_count = message_count * HOST_BENCH_LOG_BINARY_TIMING_REPEATS;
+    printf(
+        "  %u messages (%u kinds); UHF airtime at %.0f bps, one packet per message\n",
+        HOST_BENCH_LOG_BINARY_RECORD_COUNT, HOST_BENCH_LOG_BINARY_MESSAGES_PER_ROUND,
+        HOST_BENCH_LOG_BINARY_UHF_BITS_PER_SECOND
+    );
+    printf("  %-10s %14s %14s %16s\n", "", "bytes/message", "CPU us/message", "airtime ms/msg");
+    printf(
+        "  %-10s %14.1f %14.3f %16.1f\n", "text",
+        (double)text_byte_count / message_count, (double)text_us / timed_count, text_airtime_ms / message_count
+    );
+    printf(
+        "  %-10s %14.1f %14.3f %16.1f\n", "binary",
+        (double)binary_byte_count / message_count, (double)binary_us / timed_count, binary_airtime_ms / message_count
+    );
+    printf(
+        "  Binary is %.1f%% of the text size; %u records preformatted, %u sent to the radio as text\n",
+        100.0 * (double)binary_byte_count / (double)text_byte_count, preformatted_count, text_fallback_count
+    );
+
+    if (binary_byte_count >= text_byte_count) {
+        printf("  FAIL: binary records are not smaller than the text lines\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+// bench_log_queue.c
+// Host benchmark of the caller-side latency of `LOG_message`: formatting and writing to the sinks
+// in the caller's context (`LOG_deferred_formatting_enabled` = 0), vs. capturing a record for the
+// logger task (= 1). Also checks that both give the same log lines, that the timestamps are taken
+// at the call, and that a burst which overflows the queue waits for the logger task, and is
+// written out in full and in order.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "log/log.h"
+#include "log/log_queue.h"
+#include "timekeeping/timekeeping.h"
+
+#include "cmsis_os.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_BENCH_LOG_QUEUE_ROUNDS 200
+
+// Messages per round: less than the queue, as the logger task drains between bursts.
+#define HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND 8
+
+// The umbilical UART (LPUART1) runs at 115200 baud, 10 bits per byte, and `HAL_UART_Transmit`
+// busy-waits until the last byte is sent.
+#define HOST_BENCH_LOG_QUEUE_UART_US_PER_BYTE (10.0 * 1000000.0 / 115200.0)
+
+#define HOST_BENCH_LOG_QUEUE_BURST_COUNT (LOG_QUEUE_RECORD_COUNT + 8)
+
+typedef struct {
+    double caller_us;
+    double logger_us;
+    uint64_t uart_byte_count;
+} HOST_BENCH_log_queue_result_t;
+
+static char HOST_BENCH_log_queue_lines[2][HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND][256];
+
+/// @brief Log one round of messages, like those on the MPI, LFS and telecommand hot paths.
+static void HOST_BENCH_log_queue_log_round(uint32_t round) {
+    static char long_str[300];
+    if (long_str[0] == '\0') {
+        memset(long_str, 'x', sizeof(long_str) - 1);
+    }
+    const char *file_name = "mpi/2026-10-17T120000_science.bin";
+
+    LOG_message(
+        LOG_SYSTEM_MPI, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "MPI: wrote %lu bytes to '%s' (total %lu bytes)", 2048UL, file_name, (unsigned long)(round * 2048UL)
+    );
+    LOG_message(
+        LOG_SYSTEM_LFS, LOG_SEVERITY_ERROR, LOG_all_sinks_except(LOG_SINK_FILE),
+        "lfs_file_write(%s) -> %ld", file_name, -28L
+    );
+    LOG_message(
+        LOG_SYSTEM_TELECOMMAND, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "Executed telecommand '%s' (tssent=%llu) in %u ms: err=%d", "fs_list_directory",
+        1760702400000ULL + round, round % 97, 0
+    );
+    LOG_message(
+        LOG_SYSTEM_EPS, LOG_SEVERITY_WARNING, LOG_SINK_ALL,
+        "EPS: battery at %5.2f V, %d%% charged, mode %c", 7.4 + (round % 10) * 0.01, 83, 'N'
+    );
+    LOG_message(
+        LOG_SYSTEM_FLASH, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "chip %u, addr 0x%08X, %-6s|%.*s|", round % 8, round * 2048U, "prog", 4, "statusword"
+    );
+    LOG_message(
+        LOG_SYSTEM_OBC, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "Heartbeat %lu", (unsigned long)round
+    );
+    LOG_message(
+        LOG_SYSTEM_GNSS, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "GNSS: %zu bytes: %s", strlen(long_str), long_str
+    );
+    LOG_message(
+        LOG_SYSTEM_LOG, LOG_SEVERITY_NORMAL, LOG_SINK_ALL,
+        "No arguments at all, 100%% static text."
+    );
+}
+
+/// @brief Copy the last `count` lines of the in-memory log table, oldest first.
+static void HOST_BENCH_log_queue_get_last_lines(char lines[][256], uint8_t count) {
+    const uint8_t max_entries = LOG_memory_table_max_entries();
+    const uint8_t newest_index = LOG_get_memory_table_index_of_most_recent_log_entry();
+    for (uint8_t line_num = 0; line_num < count; line_num++) {
+        const uint8_t index = (uint8_t)((newest_index + max_entries - (count - 1 - line_num)) % max_entries);
+        snprintf(lines[line_num], 256, "%s", LOG_get_memory_table_full_message_at_index(index));
+    }
+}
+
+/// @brief Get the "ms since resync" field of a format-0 timestamp ("1719169299720+0000042000_N").
+static uint32_t HOST_BENCH_log_queue_line_ms_since_resync(const char line[]) {
+    const char *plus = strchr(line, '+');
+    return (plus != NULL) ? (uint32_t)strtoul(plus + 1, NULL, 10) : UINT32_MAX;
+}
+
+/// @brief Run every round with deferred formatting off (0) or on (1).
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_log_queue_run_mode(uint8_t deferred, HOST_BENCH_log_queue_result_t *result_out) {
+    memset(result_out, 0, sizeof(HOST_BENCH_log_queue_result_t));
+    LOG_deferred_formatting_enabled = deferred;
+    LOG_logger_task_is_running = deferred;
+
+    for (uint32_t round = 0; round < HOST_BENCH_LOG_QUEUE_ROUNDS; round++) {
+        const uint64_t uart_bytes_before = HOST_uart_counters.byte_count;
+
+        const uint64_t caller_start_us = HOST_get_monotonic_time_us();
+        HOST_BENCH_log_queue_log_round(round);
+        const uint64_t caller_end_us = HOST_get_monotonic_time_us();
+        const uint32_t uptime_after_calls_ms = TIME_uptime_ms();
+        result_out->caller_us += (double)(caller_end_us - caller_start_us);
+
+        if (deferred) {
+            if (LOG_queue_depth() != HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND) {
+                printf("  FAIL: %u records queued, expected %u\n", LOG_queue_depth(), HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND);
+                return 1;
+            }
+            // Let the clock move on, as it would before the logger task runs.
+            if (round == 0) {
+                osDelay(5);
+            }
+            const uint64_t logger_start_us = HOST_get_monotonic_time_us();
+            const uint32_t processed_count = LOG_process_queued_messages(UINT32_MAX);
+            result_out->logger_us += (double)(HOST_get_monotonic_time_us() - logger_start_us);
+            if (processed_count != HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND) {
+                printf("  FAIL: logger wrote out %u records\n", processed_count);
+                return 1;
+            }
+        }
+        result_out->uart_byte_count += HOST_uart_counters.byte_count - uart_bytes_before;
+
+        // Keep the first round's lines, to compare the modes.
+        if (round == 0) {
+            HOST_BENCH_log_queue_get_last_lines(HOST_BENCH_log_queue_lines[deferred], HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND);
+            for (uint8_t line_num = 0; line_num < HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND; line_num++) {
+                if (HOST_BENCH_log_queue_line_ms_since_resync(HOST_BENCH_log_queue_lines[deferred][line_num]) > uptime_after_calls_ms) {
+                    printf("  FAIL: timestamp taken after the call: %s", HOST_BENCH_log_queue_lines[deferred][line_num]);
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/// @brief Log more messages than the queue holds, without draining in between.
+/// @return 0 if every message was written out in order, with none dropped; 1 otherwise.
+/// @note On the host, waiting for the logger task writes out one queued message instead.
+static uint8_t HOST_BENCH_log_queue_check_burst(void) {
+    LOG_deferred_formatting_enabled = 1;
+    LOG_logger_task_is_running = 1;
+    const uint32_t dropped_count_before = LOG_queue_stats.dropped_count;
+    const uint32_t full_wait_count_before = LOG_queue_stats.full_wait_count;
+
+    for (uint32_t msg_num = 0; msg_num < HOST_BENCH_LOG_QUEUE_BURST_COUNT; msg_num++) {
+        LOG_message(LOG_SYSTEM_LOG, LOG_SEVERITY_NORMAL, LOG_SINK_ALL, "burst message %03lu", (unsigned long)msg_num);
+    }
+    LOG_process_queued_messages(UINT32_MAX);
+
+    static char lines[HOST_BENCH_LOG_QUEUE_BURST_COUNT][256];
+    HOST_BENCH_log_queue_get_last_lines(lines, HOST_BENCH_LOG_QUEUE_BURST_COUNT);
+    for (uint32_t msg_num = 0; msg_num < HOST_BENCH_LOG_QUEUE_BURST_COUNT; msg_num++) {
+        char expected[32];
+        snprintf(expected, sizeof(expected), "burst message %03lu\n", (unsigned long)msg_num);
+        const char *message = strstr(lines[msg_num], "]: ");
+        if ((message == NULL) || (strcmp(message + 3, expected) != 0)) {
+            printf("  FAIL: burst line %u missing or out of order: %s", msg_num, lines[msg_num]);
+            return 1;
+        }
+    }
+
+    const uint32_t dropped_count = LOG_queue_stats.dropped_count - dropped_count_before;
+    const uint32_t full_wait_count = LOG_queue_stats.full_wait_count - full_wait_count_before;
+    printf(
+        "  Burst of %u messages without a yield: all written out in order, %lu waited for the logger, %lu dropped\n",
+        HOST_BENCH_LOG_QUEUE_BURST_COUNT, full_wait_count, dropped_count
+    );
+    if ((dropped_count != 0) || (full_wait_count != (HOST_BENCH_LOG_QUEUE_BURST_COUNT - LOG_QUEUE_RECORD_COUNT))) {
+        printf("  FAIL: expected %u waits and none dropped\n", HOST_BENCH_LOG_QUEUE_BURST_COUNT - LOG_QUEUE_RECORD_COUNT);
+        return 1;
+    }
+    return 0;
+}
+
+static void HOST_BENCH_log_queue_print_row(const char label[], const HOST_BENCH_log_queue_result_t *result, uint8_t deferred) {
+    const double message_count = HOST_BENCH_LOG_QUEUE_ROUNDS * HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND;
+    const double uart_us = (double)result->uart_byte_count * HOST_BENCH_LOG_QUEUE_UART_US_PER_BYTE / message_count;
+    const double caller_cpu_us = result->caller_us / message_count;
+    printf(
+        "  %-20s %12.3f %12.1f %14.1f %12.3f\n",
+        label,
+        caller_cpu_us,
+        deferred ? 0.0 : uart_us,
+        caller_cpu_us + (deferred ? 0.0 : uart_us),
+        result->logger_us / message_count
+    );
+}
+
+uint8_t HOST_BENCH_log_queue(void) {
+    const uint32_t original_deferred = LOG_deferred_formatting_enabled;
+    const uint8_t original_running = LOG_logger_task_is_running;
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+    LOG_process_queued_messages(UINT32_MAX);
+
+    HOST_BENCH_log_queue_result_t results[2];
+    uint8_t result = 0;
+    for (uint8_t deferred = 0; (deferred < 2) && (result == 0); deferred++) {
+        result = HOST_BENCH_log_queue_run_mode(deferred, &results[deferred]);
+    }
+    if (result == 0) {
+        result = HOST_BENCH_log_queue_check_burst();
+    }
+
+    LOG_deferred_formatting_enabled = original_deferred;
+    LOG_logger_task_is_running = original_running;
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    if (result != 0) {
+        return 1;
+    }
+
+    printf(
+        "  %u messages (%u per burst); UART blocking modelled at 115200 baud; us per message\n",
+        HOST_BENCH_LOG_QUEUE_ROUNDS * HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND, HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND
+    );
+    printf("  %-20s %12s %12s %14s %12s\n", "", "caller CPU", "caller UART", "caller total", "logger CPU");
+    HOST_BENCH_log_queue_print_row("direct (before)", &results[0], 0);
+    HOST_BENCH_log_queue_print_row("queued (after)", &results[1], 1);
+    printf("  Record size %u B; queue of %u records\n", (uint32_t)sizeof(LOG_record_t), LOG_QUEUE_RECORD_COUNT);
+
+    // The log lines must match, apart from the timestamp.
+    for (uint8_t line_num = 0; line_num < HOST_BENCH_LOG_QUEUE_MESSAGES_PER_ROUND; line_num++) {
+        const char *direct_line = strchr(HOST_BENCH_log_queue_lines[0][line_num], ' ');
+        const char *queued_line = strchr(HOST_BENCH_log_queue_lines[1][line_num], ' ');
+        if ((direct_line == NULL) || (queued_line == NULL) || (strcmp(direct_line, queued_line) != 0)) {
+            printf(
+                "  FAIL: line %u differs:\n    direct: %s    queued: %s",
+                line_num, HOST_BENCH_log_queue_lines[0][line_num], HOST_BENCH_log_queue_lines[1][line_num]
+            );
+            result = 1;
+        }
+    }
+    if (results[1].caller_us >= results[0].caller_us) {
+        printf("  FAIL: queueing took as much caller CPU time as formatting directly\n");
+        result = 1;
+    }
+    return result;
+}
@@ -0,0 +1,444 @@
+// bench_mpi_frame_index.c
+// Host benchmark of finding frames in an MPI science data file: a file is recorded as the writer
+// task does it (header, 2048 B buffers with a timestamp every 10, footer) with the frame index
+// (`mpi_frame_index.c`) built as it's written. Then a frame range is found by searching the data
+// file for the frames' sync words (as before), vs. reading the index; and the file is validated by
+// counting every sync word in it (as before), vs. checking the index's totals. Read costs are the
+// NAND emulator's page reads and modelled busy time.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+#include "mpi/mpi_frame_index.h"
+#include "mpi/mpi_data_files.h"
+#include "telecommands/lfs_telecommand_defs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// 230400 baud, 8N1, in 160 B MPI frames, received into 2048 B buffers.
+#define HOST_BENCH_MPI_INDEX_BYTES_PER_SEC 23040
+#define HOST_BENCH_MPI_INDEX_FRAME_BYTES 160
+#define HOST_BENCH_MPI_INDEX_BUFFER_BYTES 2048
+#define HOST_BENCH_MPI_INDEX_BUFFERS_PER_TIMESTAMP 10
+#define HOST_BENCH_MPI_INDEX_DURATION_SEC 120
+
+// The frame counter starts near its wrap, to exercise its extension to 32 bits.
+#define HOST_BENCH_MPI_INDEX_FIRST_FRAME_NUM 60000
+
+static const char HOST_BENCH_mpi_index_file_path[] = "/mpi_index_bench.bin";
+static const char HOST_BENCH_mpi_index_extract_path[] = "/mpi_index_bench_range.bin";
+
+static uint8_t HOST_BENCH_mpi_index_buffer[HOST_BENCH_MPI_INDEX_BUFFER_BYTES];
+
+typedef struct {
+    uint32_t page_read_count;
+    double busy_ms;
+} HOST_BENCH_mpi_index_cost_t;
+
+static void HOST_BENCH_mpi_index_cost_since(
+    const HOST_NAND_chip_stats_t *stats_before, HOST_BENCH_mpi_index_cost_t *cost_out
+) {
+    HOST_NAND_chip_stats_t stats_after;
+    HOST_NAND_get_total_stats(&stats_after);
+    cost_out->page_read_count = stats_after.page_read_count - stats_before->page_read_count;
+    cost_out->busy_ms = (double)(stats_after.modelled_busy_us - stats_before->modelled_busy_us) / 1000.0;
+}
+
+/// @brief Get byte `offset` of the MPI data stream: frames of sync word, frame counter,
+///     temperature, and pixels (which never contain the sync word).
+static uint8_t HOST_BENCH_mpi_index_stream_byte(uint32_t offset) {
+    const uint32_t frame_num = HOST_BENCH_MPI_INDEX_FIRST_FRAME_NUM + (offset / HOST_BENCH_MPI_INDEX_FRAME_BYTES);
+    const uint32_t i = offset % HOST_BENCH_MPI_INDEX_FRAME_BYTES;
+    switch (i) {
+        case 0: return 0x0c;
+        case 1: return 0xff;
+        case 2: return 0xff;
+        case 3: return 0x0c;
+        case 4: return (uint8_t)(frame_num >> 8);
+        case 5: return (uint8_t)frame_num;
+        case 6: return 0x0a;
+        case 7: return 0x00;
+        default: return (uint8_t)(((frame_num * 31) + (i * 7)) & 0x7f);
+    }
+}
+
+/// @brief Record the science data file, as the writer task does, with its index.
+/// @param boot_count Boot the recording's uptimes are from. Every recording's uptimes start at 1 s.
+/// @param is_append Append a recording to the file (else replace the file).
+static uint8_t HOST_BENCH_mpi_index_record_file(uint32_t boot_count, uint8_t is_append, uint32_t *data_bytes_out) {
+    if (!is_append) {
+        LFS_delete_file(HOST_BENCH_mpi_index_file_path);
+    }
+
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, HOST_BENCH_mpi_index_file_path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND) < 0) {
+        return 1;
+    }
+    if (lfs_file_size(&LFS_filesystem, &file) == 0) {
+        MPI_frame_index_delete(HOST_BENCH_mpi_index_file_path);
+    }
+    const char header[] = "{\"mpi_start\":1,\"uptime_ms\":1000}\n";
+    lfs_file_write(&LFS_filesystem, &file, header, strlen(header));
+    if (MPI_frame_index_start(HOST_BENCH_mpi_index_file_path, lfs_file_size(&LFS_filesystem, &file), boot_count, 1000) != 0) {
+        lfs_file_close(&LFS_filesystem, &file);
+        return 2;
+    }
+
+    const uint32_t data_bytes = HOST_BENCH_MPI_INDEX_BYTES_PER_SEC * HOST_BENCH_MPI_INDEX_DURATION_SEC;
+    uint32_t buffer_num = 0;
+    for (uint32_t stream_offset = 0; stream_offset < data_bytes; stream_offset += HOST_BENCH_MPI_INDEX_BUFFER_BYTES) {
+        uint32_t buffer_len = data_bytes - stream_offset;
+        if (buffer_len > HOST_BENCH_MPI_INDEX_BUFFER_BYTES) {
+            buffer_len = HOST_BENCH_MPI_INDEX_BUFFER_BYTES;
+        }
+        for (uint32_t i = 0; i < buffer_len; i++) {
+            HOST_BENCH_mpi_index_buffer[i] = HOST_BENCH_mpi_index_stream_byte(stream_offset + i);
+        }
+        const uint32_t filled_uptime_ms = 1000 + (uint32_t)(
+            ((uint64_t)(stream_offset + buffer_len) * 1000) / HOST_BENCH_MPI_INDEX_BYTES_PER_SEC
+        );
+
+        const lfs_soff_t data_file_offset = lfs_file_tell(&LFS_filesystem, &file);
+        if (lfs_file_write(&LFS_filesystem, &file, HOST_BENCH_mpi_index_buffer, buffer_len) != (lfs_ssize_t)buffer_len) {
+            lfs_file_close(&LFS_filesystem, &file);
+            return 3;
+        }
+        MPI_frame_index_add_data(HOST_BENCH_mpi_index_buffer, buffer_len, (uint32_t)data_file_offset, filled_uptime_ms);
+
+        buffer_num++;
+        if (((buffer_num % HOST_BENCH_MPI_INDEX_BUFFERS_PER_TIMESTAMP) == 0) || (buffer_len < HOST_BENCH_MPI_INDEX_BUFFER_BYTES)) {
+            char timestamp[64];
+            const int timestamp_len = snprintf(timestamp, sizeof(timestamp), "{\"uptime_ms\":%lu}\n", filled_uptime_ms);
+            lfs_file_write(&LFS_filesystem, &file, timestamp, timestamp_len);
+        }
+    }
+    if (MPI_frame_index_finish() != 0) {
+        lfs_file_close(&LFS_filesystem, &file);
+        return 4;
+    }
+    const char footer[] = "{\"mpi_stop\":1,\"reason\":\"telecommand\"}\n";
+    lfs_file_write(&LFS_filesystem, &file, footer, strlen(footer));
+    if (lfs_file_close(&LFS_filesystem, &file) < 0) {
+        return 5;
+    }
+    *data_bytes_out = data_bytes;
+    return 0;
+}
+
+/// @brief Find frames by searching the data file for sync words and reading their frame counters.
+/// @param stop_after_last Stop at the first frame after `last` (else read to `file_end_offset`).
+/// @return Number of frames found in `[first, last]`.
+static uint32_t HOST_BENCH_mpi_index_scan_frames(
+    const char file_path[], uint32_t file_start_offset, uint32_t file_end_offset,
+    uint32_t first, uint32_t last, uint8_t stop_after_last
+) {
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, file_path, LFS_O_RDONLY) < 0) {
+        return 0;
+    }
+    lfs_file_seek(&LFS_filesystem, &file, file_start_offset, LFS_SEEK_SET);
+
+    uint32_t found_count = 0;
+    uint32_t window = 0;
+    uint8_t counter_bytes_pending = 0;
+    uint16_t counter = 0;
+    uint8_t has_frame_num = 0;
+    uint32_t frame_num = 0;
+    uint32_t offset = file_start_offset;
+    uint8_t is_done = 0;
+    while ((!is_done) && (offset < file_end_offset)) {
+        uint32_t chunk_len = file_end_offset - offset;
+        if (chunk_len > sizeof(HOST_BENCH_mpi_index_buffer)) {
+            chunk_len = sizeof(HOST_BENCH_mpi_index_buffer);
+        }
+        const lfs_ssize_t read_len = lfs_file_read(&LFS_filesystem, &file, HOST_BENCH_mpi_index_buffer, chunk_len);
+        if (read_len <= 0) {
+            break;
+        }
+        for (lfs_ssize_t i = 0; i < read_len; i++) {
+            if (counter_bytes_pending > 0) {
+                counter = (uint16_t)((counter << 8) | HOST_BENCH_mpi_index_buffer[i]);
+                if (--counter_bytes_pending > 0) {
+                    continue;
+                }
+                // Extend the counter like the index does; the first one is taken as the nearest to `first`.
+                frame_num = has_frame_num
+                    ? (frame_num + (uint16_t)(counter - (uint16_t)frame_num))
+                    : (first + (int16_t)(counter - (uint16_t)first));
+                has_frame_num = 1;
+                if ((frame_num >= first) && (frame_num <= last)) {
+                    found_count++;
+                }
+                if (stop_after_last && (frame_num > last)) {
+                    is_done = 1;
+                    break;
+                }
+                continue;
+            }
+            window = (window << 8) | HOST_BENCH_mpi_index_buffer[i];
+            if (window == MPI_FRAME_INDEX_SYNC_WORD) {
+                counter_bytes_pending = 2;
+                counter = 0;
+                window = 0;
+            }
+        }
+        offset += (uint32_t)read_len;
+    }
+    lfs_file_close(&LFS_filesystem, &file);
+    return found_count;
+}
+
+uint8_t HOST_BENCH_mpi_frame_index(void) {
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    const uint32_t original_interval_frames = MPI_frame_index_interval_frames;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+    MPI_frame_index_interval_frames = 64;
+
+    uint8_t result = 0;
+    uint32_t data_bytes = 0;
+    if (HOST_BENCH_reformat_filesystem() != 0) {
+        printf("  FAIL: reformat\n");
+        result = 1;
+    }
+    if (result == 0) {
+        const uint8_t record_result = HOST_BENCH_mpi_index_record_file(1, 0, &data_bytes);
+        if (record_result != 0) {
+            printf("  FAIL: recording the science data file: %u\n", record_result);
+            result = 1;
+        }
+    }
+
+    const uint32_t frame_count = data_bytes / HOST_BENCH_MPI_INDEX_FRAME_BYTES;
+    char index_path[LFS_MAX_PATH_LENGTH];
+    MPI_frame_index_get_path(HOST_BENCH_mpi_index_file_path, index_path, sizeof(index_path));
+    const lfs_ssize_t file_size = LFS_file_size(HOST_BENCH_mpi_index_file_path, 0);
+    const lfs_ssize_t index_size = LFS_file_size(index_path, 0);
+
+    MPI_frame_index_summary_t summary = {0};
+    if ((result == 0) && (
+        (MPI_frame_index_get_summary(HOST_BENCH_mpi_index_file_path, &summary) != 0)
+        || (!summary.is_complete) || (summary.recording_count != 1)
+        || (summary.frames_found != frame_count) || (summary.data_bytes != data_bytes)
+    )) {
+        printf(
+            "  FAIL: index summary: %lu recordings, %lu frames (expected %lu), %lu data bytes, complete=%u\n",
+            summary.recording_count, summary.frames_found, frame_count, summary.data_bytes, summary.is_complete
+        );
+        result = 1;
+    }
+
+    // A range of 100 frames, three quarters of the way through the recording (across the counter's wrap).
+    const uint32_t first = HOST_BENCH_MPI_INDEX_FIRST_FRAME_NUM + ((frame_count * 3) / 4);
+    const uint32_t last = first + 99;
+    HOST_BENCH_mpi_index_cost_t scan_find_cost = {0};
+    HOST_BENCH_mpi_index_cost_t index_find_cost = {0};
+    HOST_BENCH_mpi_index_cost_t index_uptime_find_cost = {0};
+    HOST_BENCH_mpi_index_cost_t scan_validate_cost = {0};
+    HOST_BENCH_mpi_index_cost_t index_validate_cost = {0};
+    uint32_t start_offset = 0;
+    uint32_t end_offset = 0;
+    uint32_t extracted_frame_count = 0;
+    uint32_t extracted_size = 0;
+    uint32_t uptime_range_len = 0;
+
+    // The same range, by uptime: frame `first` finished arriving within the buffer filled at this time.
+    const uint32_t first_stream_offset = (first - HOST_BENCH_MPI_INDEX_FIRST_FRAME_NUM) * HOST_BENCH_MPI_INDEX_FRAME_BYTES;
+    const uint32_t first_uptime_ms = 1000 + (first_stream_offset * 1000ULL) / HOST_BENCH_MPI_INDEX_BYTES_PER_SEC;
+    const uint32_t last_uptime_ms = first_uptime_ms + ((100 * HOST_BENCH_MPI_INDEX_FRAME_BYTES * 1000) / HOST_BENCH_MPI_INDEX_BYTES_PER_SEC);
+    if (result == 0) {
+        HOST_NAND_chip_stats_t stats_before;
+        HOST_NAND_get_total_stats(&stats_before);
+        const uint32_t scan_found = HOST_BENCH_mpi_index_scan_frames(
+            HOST_BENCH_mpi_index_file_path, 0, (uint32_t)file_size, first, last, 1
+        );
+        HOST_BENCH_mpi_index_cost_since(&stats_before, &scan_find_cost);
+
+        HOST_NAND_get_total_stats(&stats_before);
+        const int8_t find_result = MPI_frame_index_find_range(
+            HOST_BENCH_mpi_index_file_path, MPI_FRAME_INDEX_KEY_FRAME_NUMBER, 0, first, last, &start_offset, &end_offset
+        );
+        HOST_BENCH_mpi_index_cost_since(&stats_before, &index_find_cost);
+
+        // The range holds every wanted frame, and at most one index interval more on each end.
+        const uint32_t index_found = HOST_BENCH_mpi_index_scan_frames(
+            HOST_BENCH_mpi_index_file_path, start_offset, end_offset, first, last, 0
+        );
+        const uint32_t range_frame_count = HOST_BENCH_mpi_index_scan_frames(
+            HOST_BENCH_mpi_index_file_path, start_offset, end_offset, 0, UINT32_MAX, 0
+        );
+        if ((scan_found != 100) || (find_result != 0) || (index_found != 100) || (range_frame_count > (100 + (2 * 64)))) {
+            printf(
+                "  FAIL: frame range: scan found %lu, find_range -> %d, range holds %lu of 100 (%lu frames)\n",
+                scan_found, find_result, index_found, range_frame_count
+            );
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        HOST_NAND_chip_stats_t stats_before;
+        HOST_NAND_get_total_stats(&stats_before);
+        uint32_t uptime_start_offset = 0;
+        uint32_t uptime_end_offset = 0;
+        const int8_t find_result = MPI_frame_index_find_range(
+            HOST_BENCH_mpi_index_file_path, MPI_FRAME_INDEX_KEY_UPTIME_MS, 1, first_uptime_ms, last_uptime_ms,
+            &uptime_start_offset, &uptime_end_offset
+        );
+        HOST_BENCH_mpi_index_cost_since(&stats_before, &index_uptime_find_cost);
+        const uint32_t index_found = HOST_BENCH_mpi_index_scan_frames(
+            HOST_BENCH_mpi_index_file_path, uptime_start_offset, uptime_end_offset, first, last, 0
+        );
+        uptime_range_len = uptime_end_offset - uptime_start_offset;
+        if ((find_result != 0) || (index_found != 100)) {
+            printf("  FAIL: uptime range: find_range -> %d, range holds %lu of 100 frames\n", find_result, index_found);
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        const int8_t extract_result = MPI_frame_index_extract_range_to_file(
+            HOST_BENCH_mpi_index_file_path, start_offset, end_offset, HOST_BENCH_mpi_index_extract_path
+        );
+        extracted_size = (uint32_t)LFS_file_size(HOST_BENCH_mpi_index_extract_path, 0);
+        extracted_frame_count = HOST_BENCH_mpi_index_scan_frames(
+            HOST_BENCH_mpi_index_extract_path, 0, extracted_size, first, last, 0
+        );
+        if ((extract_result != 0) || (extracted_size != (end_offset - start_offset)) || (extracted_frame_count != 100)) {
+            printf(
+                "  FAIL: extract: -> %d, %lu B (expected %lu), %lu of 100 frames\n",
+                extract_result, extracted_size, end_offset - start_offset, extracted_frame_count
+            );
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        HOST_NAND_chip_stats_t stats_before;
+        HOST_NAND_get_total_stats(&stats_before);
+        const uint8_t index_validate_result = MPI_validate_science_data_file(HOST_BENCH_mpi_index_file_path);
+        HOST_BENCH_mpi_index_cost_since(&stats_before, &index_validate_cost);
+
+        // Without the index, validation falls back to counting every sync word.
+        char moved_index_path[LFS_MAX_PATH_LENGTH];
+        snprintf(moved_index_path, sizeof(moved_index_path), "%s.moved", index_path);
+        lfs_rename(&LFS_filesystem, index_path, moved_index_path);
+        HOST_NAND_get_total_stats(&stats_before);
+        const uint8_t scan_validate_result = MPI_validate_science_data_file(HOST_BENCH_mpi_index_file_path);
+        HOST_BENCH_mpi_index_cost_since(&stats_before, &scan_validate_cost);
+        lfs_rename(&LFS_filesystem, moved_index_path, index_path);
+        if ((index_validate_result != 0) || (scan_validate_result != 0)) {
+            printf("  FAIL: validation: with index -> %u, without -> %u\n", index_validate_result, scan_validate_result);
+            result = 1;
+        }
+    }
+
+    if (result == 0) {
+        // Data written to the file outside of a recording doesn't match the index's totals.
+        memset(HOST_BENCH_mpi_index_buffer, 0, sizeof(HOST_BENCH_mpi_index_buffer));
+        for (uint32_t junk_len = 0; junk_len < (data_bytes / 4); junk_len += sizeof(HOST_BENCH_mpi_index_buffer)) {
+            LFS_append_file(HOST_BENCH_mpi_index_file_path, HOST_BENCH_mpi_index_buffer, sizeof(HOST_BENCH_mpi_index_buffer));
+        }
+        const uint8_t junk_validate_result = MPI_validate_science_data_file(HOST_BENCH_mpi_index_file_path);
+        if (junk_validate_result != 50) {
+            printf("  FAIL: validation with junk appended -> %u (expected 50)\n", junk_validate_result);
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        // A new data file at the path of a deleted one (with its index left behind) gets a new index.
+        LFS_delete_file(HOST_BENCH_mpi_index_file_path);
+        uint32_t new_data_bytes = 0;
+        const uint8_t record_result = HOST_BENCH_mpi_index_record_file(1, 0, &new_data_bytes);
+        MPI_frame_index_summary_t new_summary = {0};
+        const int8_t summary_result = MPI_frame_index_get_summary(HOST_BENCH_mpi_index_file_path, &new_summary);
+        if ((record_result != 0) || (summary_result != 0) || (new_summary.recording_count != 1)) {
+            printf(
+                "  FAIL: new file over a stale index: record -> %u, summary -> %d, %lu recordings (expected 1)\n",
+                record_result, summary_result, new_summary.recording_count
+            );
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        // A second boot's recording with the same uptimes: each boot's uptimes find their own recording.
+        const lfs_ssize_t boot_1_file_size = LFS_file_size(HOST_BENCH_mpi_index_file_path, 0);
+        uint32_t boot_2_data_bytes = 0;
+        const uint8_t record_result = HOST_BENCH_mpi_index_record_file(2, 1, &boot_2_data_bytes);
+        uint32_t boot_1_start = 0;
+        uint32_t boot_1_end = 0;
+        uint32_t boot_2_start = 0;
+        uint32_t boot_2_end = 0;
+        uint32_t boot_3_start = 0;
+        uint32_t boot_3_end = 0;
+        const int8_t boot_1_result = MPI_frame_index_find_range(
+            HOST_BENCH_mpi_index_file_path, MPI_FRAME_INDEX_KEY_UPTIME_MS, 1, first_uptime_ms, last_uptime_ms,
+            &boot_1_start, &boot_1_end
+        );
+        const int8_t boot_2_result = MPI_frame_index_find_range(
+            HOST_BENCH_mpi_index_file_path, MPI_FRAME_INDEX_KEY_UPTIME_MS, 2, first_uptime_ms, last_uptime_ms,
+            &boot_2_start, &boot_2_end
+        );
+        const int8_t boot_3_result = MPI_frame_index_find_range(
+            HOST_BENCH_mpi_index_file_path, MPI_FRAME_INDEX_KEY_UPTIME_MS, 3, first_uptime_ms, last_uptime_ms,
+            &boot_3_start, &boot_3_end
+        );
+        if (
+            (record_result != 0) || (boot_1_result != 0) || (boot_2_result != 0) || (boot_3_result != 2)
+            || (boot_1_end > (uint32_t)boot_1_file_size) || (boot_2_start < (uint32_t)boot_1_file_size)
+            || (HOST_BENCH_mpi_index_scan_frames(HOST_BENCH_mpi_index_file_path, boot_2_start, boot_2_end, first, last, 0) != 100)
+        ) {
+            printf(
+                "  FAIL: uptimes of two boots: record -> %u, find_range -> %d (boot 1, %lu-%lu), %d (boot 2, %lu-%lu), "
+                "%d (boot 3), boot 2 starts at %ld\n",
+                record_result, boot_1_result, boot_1_start, boot_1_end, boot_2_result, boot_2_start, boot_2_end,
+                boot_3_result, boot_1_file_size
+            );
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        // Deleting the data file by telecommand deletes its index.
+        char response[256];
+        TCMDEXEC_fs_delete_file(HOST_BENCH_mpi_index_file_path, response, sizeof(response));
+        if (LFS_file_size(index_path, 0) != LFS_ERR_NOENT) {
+            printf("  FAIL: fs_delete_file left the index behind: %s\n", response);
+            result = 1;
+        }
+    }
+
+    LFS_delete_file(HOST_BENCH_mpi_index_file_path);
+    LFS_delete_file(index_path);
+    LFS_delete_file(HOST_BENCH_mpi_index_extract_path);
+    MPI_frame_index_interval_frames = original_interval_frames;
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    if (result != 0) {
+        return 1;
+    }
+
+    printf(
+        "  %u s recording: %ld B data file (%lu frames), %ld B index (every 64th frame, %lu entries)\n",
+        HOST_BENCH_MPI_INDEX_DURATION_SEC, file_size, frame_count, index_size, summary.entry_count
+    );
+    printf("  Frames %lu-%lu (100 frames, 3/4 through the file):\n", first, last);
+    printf("    %-36s %8s %9s\n", "", "pg reads", "busy ms");
+    printf("    %-36s %8lu %9.1f\n", "search the data file for sync words", scan_find_cost.page_read_count, scan_find_cost.busy_ms);
+    printf("    %-36s %8lu %9.1f\n", "find_range in the index (by frame)", index_find_cost.page_read_count, index_find_cost.busy_ms);
+    printf("    %-36s %8lu %9.1f\n", "find_range in the index (by uptime)", index_uptime_find_cost.page_read_count, index_uptime_find_cost.busy_ms);
+    printf(
+        "    range: %lu B by frame (%lu B by uptime), extracted to a file holding all 100 frames\n",
+        end_offset - start_offset, uptime_range_len
+    );
+    printf("  Validate the file:\n");
+    printf("    %-36s %8lu %9.1f\n", "count every sync word", scan_validate_cost.page_read_count, scan_validate_cost.busy_ms);
+    printf("    %-36s %8lu %9.1f\n", "index totals + 2 spot checks", index_validate_cost.page_read_count, index_validate_cost.busy_ms);
+
+    if ((index_find_cost.page_read_count * 10) > scan_find_cost.page_read_count) {
+        printf("  FAIL: the index didn't cut the pages read for a frame range by 10x\n");
+        return 1;
+    }
+    if ((index_validate_cost.page_read_count * 10) > scan_validate_cost.page_read_count) {
+        printf("  FAIL: the index didn't cut the pages read for validation by 10x\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,491 @@
+// bench_mpi_science_ring.c
+// Host benchmark of MPI science data reception at 230400 baud, on a simulated clock: 160 B DMA
+// transfers copied byte-wise by the ISR into two 20480 B ping-pong buffers, written by a task which
+// polls every 100 ms (as before), vs. DMA straight into the ring of 2048 B buffers
+// (`mpi_science_ring.c`), written by a task woken on each full buffer. The writer task is
+// cooperative, so it waits for the other tasks' work: downlink packets, GNSS firehose storage, and
+// an occasional long telecommand. The data is really written to a file; write times are the NAND
+// emulator's modelled busy time.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/lfs.h"
+#include "littlefs/lfs_util.h"
+#include "littlefs/littlefs_helper.h"
+#include "mpi/mpi_science_ring.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// 230400 baud, 8N1, in 160 B MPI frames.
+#define HOST_BENCH_MPI_BYTES_PER_SEC 23040
+#define HOST_BENCH_MPI_FRAME_BYTES 160
+#define HOST_BENCH_MPI_FRAME_MS (1000.0 * HOST_BENCH_MPI_FRAME_BYTES / HOST_BENCH_MPI_BYTES_PER_SEC)
+#define HOST_BENCH_MPI_DURATION_SEC 60
+
+// Former ping-pong buffers, and the writer task's poll period.
+#define HOST_BENCH_MPI_PING_PONG_BUFFER_LEN 20480
+#define HOST_BENCH_MPI_POLL_PERIOD_MS 100.0
+
+// ISR cost estimate, at the flight SYSCLK (HSI, 16 MHz): as in `bench_uart_dma_ring.c`, plus
+// restarting the DMA in normal mode (`HAL_UART_Receive_DMA`).
+#define HOST_BENCH_MPI_CPU_HZ 16000000.0
+#define HOST_BENCH_MPI_CYCLES_PER_IRQ 300
+#define HOST_BENCH_MPI_CYCLES_PER_DMA_RESTART 400
+#define HOST_BENCH_MPI_CYCLES_PER_BYTE_MOVED 4
+
+typedef struct {
+    const char *name;
+
+    /// @brief Period and duration of a long-running telecommand (e.g., hashing a large file), which
+    ///     holds the CPU. 0 for none.
+    double long_tcmd_period_ms;
+    double long_tcmd_duration_ms;
+} HOST_BENCH_mpi_scenario_t;
+
+typedef struct {
+    uint32_t irq_count;
+    uint32_t bytes_moved_by_cpu;
+    uint32_t bytes_stored;
+    uint32_t bytes_lost;
+
+    /// @brief Bytes received but dropped at the stop, instead of being written.
+    uint32_t bytes_dropped_at_stop;
+
+    uint32_t crc_of_bytes_kept;
+    uint32_t buffers_written;
+    double sum_write_latency_ms;
+    double max_write_latency_ms;
+    double flash_busy_ms;
+} HOST_BENCH_mpi_result_t;
+
+typedef enum {
+    HOST_BENCH_MPI_WRITER_IDLE,
+    HOST_BENCH_MPI_WRITER_WRITING,
+} HOST_BENCH_mpi_writer_state_enum_t;
+
+/// @brief The writer task's state: waiting until `event_ms` (poll, wake, or end of the CPU being
+///     held by another task), or writing a buffer until `event_ms`.
+typedef struct {
+    HOST_BENCH_mpi_writer_state_enum_t state;
+    double event_ms;
+    double written_buffer_filled_ms;
+} HOST_BENCH_mpi_writer_t;
+
+static const char HOST_BENCH_mpi_file_path[] = "/mpi_science_bench.bin";
+
+static uint8_t HOST_BENCH_mpi_ping_pong_buffers[2][HOST_BENCH_MPI_PING_PONG_BUFFER_LEN];
+
+/// @brief Get the next MPI frame: sync word, frame counter, temperature, and pseudo-random pixels.
+static void HOST_BENCH_mpi_make_frame(uint32_t frame_num, uint8_t frame_out[]) {
+    frame_out[0] = 0x0c;
+    frame_out[1] = 0xff;
+    frame_out[2] = 0xff;
+    frame_out[3] = 0x0c;
+    frame_out[4] = (uint8_t)(frame_num >> 8);
+    frame_out[5] = (uint8_t)frame_num;
+    frame_out[6] = 0x0a; // 20 C (raw / 128).
+    frame_out[7] = 0x00;
+    uint32_t x = (frame_num * 2654435761U) | 1;
+    for (uint16_t i = 8; i < HOST_BENCH_MPI_FRAME_BYTES; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        frame_out[i] = (uint8_t)x;
+    }
+}
+
+/// @brief Get the time from which the writer task can run, if it is ready at `ready_ms`.
+/// @note Other tasks' work, which the cooperative scheduler lets finish first: a downlink packet
+///     every 208 ms (9600 bps), GNSS firehose storage every 1.1 s, and the scenario's telecommand.
+static double HOST_BENCH_mpi_cpu_free_ms(const HOST_BENCH_mpi_scenario_t *scenario, double ready_ms) {
+    const double periods_ms[3] = {208.0, 1100.0, scenario->long_tcmd_period_ms};
+    const double durations_ms[3] = {5.0, 20.0, scenario->long_tcmd_duration_ms};
+
+    double free_ms = ready_ms;
+    for (uint8_t pass = 0; pass < 3; pass++) {
+        for (uint8_t i = 0; i < 3; i++) {
+            if (periods_ms[i] <= 0) {
+                continue;
+            }
+            const double start_ms = (double)(uint64_t)(free_ms / periods_ms[i]) * periods_ms[i];
+            if ((free_ms >= start_ms) && (free_ms < (start_ms + durations_ms[i]))) {
+                free_ms = start_ms + durations_ms[i];
+            }
+        }
+    }
+    return free_ms;
+}
+
+/// @brief Append a buffer to the science data file.
+/// @return Modelled flash busy time of the write, or a negative value on error.
+static double HOST_BENCH_mpi_write_buffer(lfs_file_t *file, const uint8_t buffer[], uint32_t buffer_len) {
+    HOST_NAND_chip_stats_t stats_before;
+    HOST_NAND_get_total_stats(&stats_before);
+    if (lfs_file_write(&LFS_filesystem, file, buffer, buffer_len) != (lfs_ssize_t)buffer_len) {
+        return -1;
+    }
+    HOST_NAND_chip_stats_t stats_after;
+    HOST_NAND_get_total_stats(&stats_after);
+    return (double)(stats_after.modelled_busy_us - stats_before.modelled_busy_us) / 1000.0;
+}
+
+static void HOST_BENCH_mpi_record_write(HOST_BENCH_mpi_result_t *result, double filled_ms, double written_ms) {
+    const double latency_ms = written_ms - filled_ms;
+    result->buffers_written++;
+    result->sum_write_latency_ms += latency_ms;
+    if (latency_ms > result->max_write_latency_ms) {
+        result->max_write_latency_ms = latency_ms;
+    }
+}
+
+/// @brief Receive and store a recording, as before the ring: 160 B DMA transfers copied into the
+///     ping-pong buffers by the ISR, and a writer task polling every 100 ms.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_mpi_run_ping_pong(
+    const HOST_BENCH_mpi_scenario_t *scenario, lfs_file_t *file, HOST_BENCH_mpi_result_t *result
+) {
+    uint8_t is_awaiting_write[2] = {0, 0};
+    double filled_ms[2] = {0, 0};
+    uint32_t buffer_index = 0; // Into the two buffers, concatenated.
+    HOST_BENCH_mpi_writer_t writer = {.state = HOST_BENCH_MPI_WRITER_IDLE, .event_ms = 0};
+    uint8_t written_buffer = 0;
+
+    const uint32_t frame_count = (HOST_BENCH_MPI_BYTES_PER_SEC * HOST_BENCH_MPI_DURATION_SEC) / HOST_BENCH_MPI_FRAME_BYTES;
+    uint32_t frame_num = 0;
+    while (frame_num < frame_count) {
+        const double frame_done_ms = (frame_num + 1) * HOST_BENCH_MPI_FRAME_MS;
+
+        if (writer.event_ms <= frame_done_ms) {
+            if (writer.state == HOST_BENCH_MPI_WRITER_WRITING) {
+                is_awaiting_write[written_buffer] = 0;
+                HOST_BENCH_mpi_record_write(result, writer.written_buffer_filled_ms, writer.event_ms);
+                writer.state = HOST_BENCH_MPI_WRITER_IDLE;
+                writer.event_ms += HOST_BENCH_MPI_POLL_PERIOD_MS;
+                continue;
+            }
+            const double start_ms = HOST_BENCH_mpi_cpu_free_ms(scenario, writer.event_ms);
+            if (start_ms > writer.event_ms) {
+                writer.event_ms = start_ms;
+                continue;
+            }
+            // Like `TASK_service_write_mpi_data`: one buffer per poll, buffer one first.
+            const int8_t buffer_num = is_awaiting_write[0] ? 0 : (is_awaiting_write[1] ? 1 : -1);
+            if (buffer_num < 0) {
+                writer.event_ms += HOST_BENCH_MPI_POLL_PERIOD_MS;
+                continue;
+            }
+            const double write_ms = HOST_BENCH_mpi_write_buffer(
+                file, HOST_BENCH_mpi_ping_pong_buffers[buffer_num], HOST_BENCH_MPI_PING_PONG_BUFFER_LEN
+            );
+            if (write_ms < 0) {
+                printf("  FAIL: write to %s\n", HOST_BENCH_mpi_file_path);
+                return 1;
+            }
+            result->flash_busy_ms += write_ms;
+            written_buffer = (uint8_t)buffer_num;
+            writer.state = HOST_BENCH_MPI_WRITER_WRITING;
+            writer.written_buffer_filled_ms = filled_ms[buffer_num];
+            writer.event_ms += write_ms;
+            continue;
+        }
+
+        // The DMA received a frame into the 160 B buffer; the transfer-complete ISR copies it out.
+        uint8_t frame[HOST_BENCH_MPI_FRAME_BYTES];
+        HOST_BENCH_mpi_make_frame(frame_num, frame);
+        result->irq_count++;
+        const uint8_t buffer_num = (buffer_index < HOST_BENCH_MPI_PING_PONG_BUFFER_LEN) ? 0 : 1;
+        if (is_awaiting_write[buffer_num]) {
+            result->bytes_lost += HOST_BENCH_MPI_FRAME_BYTES;
+        }
+        else {
+            const uint32_t offset = buffer_index - (buffer_num * HOST_BENCH_MPI_PING_PONG_BUFFER_LEN);
+            memcpy(&HOST_BENCH_mpi_ping_pong_buffers[buffer_num][offset], frame, HOST_BENCH_MPI_FRAME_BYTES);
+            result->bytes_moved_by_cpu += HOST_BENCH_MPI_FRAME_BYTES;
+            result->crc_of_bytes_kept = lfs_crc(result->crc_of_bytes_kept, frame, HOST_BENCH_MPI_FRAME_BYTES);
+            buffer_index += HOST_BENCH_MPI_FRAME_BYTES;
+            if ((buffer_index % HOST_BENCH_MPI_PING_PONG_BUFFER_LEN) == 0) {
+                is_awaiting_write[buffer_num] = 1;
+                filled_ms[buffer_num] = frame_done_ms;
+                buffer_index %= (2 * HOST_BENCH_MPI_PING_PONG_BUFFER_LEN);
+            }
+        }
+        frame_num++;
+    }
+
+    // As before the ring, the buffers still awaiting their write at the stop are not stored.
+    if (writer.state == HOST_BENCH_MPI_WRITER_WRITING) {
+        is_awaiting_write[written_buffer] = 0;
+        HOST_BENCH_mpi_record_write(result, writer.written_buffer_filled_ms, writer.event_ms);
+    }
+    const uint32_t unwritten_len = (buffer_index % HOST_BENCH_MPI_PING_PONG_BUFFER_LEN)
+        + ((is_awaiting_write[0] + is_awaiting_write[1]) * HOST_BENCH_MPI_PING_PONG_BUFFER_LEN);
+    result->bytes_dropped_at_stop = unwritten_len;
+    return 0;
+}
+
+/// @brief Write the oldest full ring buffer, as `MPI_write_pending_science_buffers` does.
+/// @return Modelled flash busy time of the write, 0 if no buffer is full, or negative on error.
+static double HOST_BENCH_mpi_ring_write_oldest(lfs_file_t *file, HOST_BENCH_mpi_writer_t *writer, HOST_BENCH_mpi_result_t *result) {
+    uint16_t buffer_len;
+    uint32_t filled_uptime_ms;
+    const uint8_t *buffer = MPI_science_ring_peek_full(&buffer_len, &filled_uptime_ms);
+    if (buffer == NULL) {
+        return 0;
+    }
+    const double write_ms = HOST_BENCH_mpi_write_buffer(file, buffer, buffer_len);
+    if (write_ms < 0) {
+        printf("  FAIL: write to %s\n", HOST_BENCH_mpi_file_path);
+        return -1;
+    }
+    result->flash_busy_ms += write_ms;
+    writer->state = HOST_BENCH_MPI_WRITER_WRITING;
+    writer->written_buffer_filled_ms = filled_uptime_ms;
+    writer->event_ms += write_ms;
+    return write_ms;
+}
+
+/// @brief Receive and store a recording with the science ring: DMA straight into the ring's
+///     buffers, and a writer task woken on each full buffer.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_mpi_run_ring(
+    const HOST_BENCH_mpi_scenario_t *scenario, lfs_file_t *file, HOST_BENCH_mpi_result_t *result
+) {
+    // The writer is waiting for a wake (its 250 ms timeout doesn't matter here).
+    const double waiting_ms = 1e30;
+
+    MPI_science_ring_reset();
+    uint16_t target_len;
+    uint8_t *target = MPI_science_ring_get_dma_target(&target_len);
+    uint16_t target_received_len = 0;
+    HOST_BENCH_mpi_writer_t writer = {.state = HOST_BENCH_MPI_WRITER_IDLE, .event_ms = waiting_ms};
+
+    const uint32_t frame_count = (HOST_BENCH_MPI_BYTES_PER_SEC * HOST_BENCH_MPI_DURATION_SEC) / HOST_BENCH_MPI_FRAME_BYTES;
+    uint32_t frame_num = 0;
+    while (frame_num < frame_count) {
+        const double frame_done_ms = (frame_num + 1) * HOST_BENCH_MPI_FRAME_MS;
+
+        if (writer.event_ms <= frame_done_ms) {
+            if (writer.state == HOST_BENCH_MPI_WRITER_WRITING) {
+                MPI_science_ring_release();
+                HOST_BENCH_mpi_record_write(result, writer.written_buffer_filled_ms, writer.event_ms);
+                writer.state = HOST_BENCH_MPI_WRITER_IDLE;
+                continue;
+            }
+            const double start_ms = HOST_BENCH_mpi_cpu_free_ms(scenario, writer.event_ms);
+            if (start_ms > writer.event_ms) {
+                writer.event_ms = start_ms;
+                continue;
+            }
+            const double write_ms = HOST_BENCH_mpi_ring_write_oldest(file, &writer, result);
+            if (write_ms < 0) {
+                return 1;
+            }
+            if (write_ms == 0) {
+                writer.event_ms = waiting_ms;
+            }
+            continue;
+        }
+
+        // The DMA writes the frame into its target(s), with no CPU involvement. Frames don't divide
+        // the 2048 B buffers, so a frame can end in the next target.
+        uint8_t frame[HOST_BENCH_MPI_FRAME_BYTES];
+        HOST_BENCH_mpi_make_frame(frame_num, frame);
+        uint16_t frame_pos = 0;
+        while (frame_pos < HOST_BENCH_MPI_FRAME_BYTES) {
+            uint16_t chunk_len = HOST_BENCH_MPI_FRAME_BYTES - frame_pos;
+            if (chunk_len > (target_len - target_received_len)) {
+                chunk_len = target_len - target_received_len;
+            }
+            memcpy(&target[target_received_len], &frame[frame_pos], chunk_len);
+            target_received_len += chunk_len;
+            frame_pos += chunk_len;
+            if (target_received_len < target_len) {
+                continue;
+            }
+
+            // Transfer-complete ISR, as in `HAL_UART_RxCpltCallback`.
+            result->irq_count++;
+            if (MPI_science_ring_on_dma_complete_from_isr((uint32_t)frame_done_ms)) {
+                result->crc_of_bytes_kept = lfs_crc(result->crc_of_bytes_kept, target, target_len);
+                if ((writer.state == HOST_BENCH_MPI_WRITER_IDLE) && (writer.event_ms > frame_done_ms)) {
+                    writer.event_ms = frame_done_ms;
+                }
+            }
+            else {
+                result->bytes_lost += target_len;
+            }
+            target = MPI_science_ring_get_dma_target(&target_len);
+            target_received_len = 0;
+        }
+        frame_num++;
+    }
+
+    // Stop, as in `MPI_disable_active_mode`: the DMA is stopped, and the rest is written out.
+    const double stop_ms = frame_count * HOST_BENCH_MPI_FRAME_MS;
+    if (writer.state == HOST_BENCH_MPI_WRITER_WRITING) {
+        MPI_science_ring_release();
+        HOST_BENCH_mpi_record_write(result, writer.written_buffer_filled_ms, writer.event_ms);
+        writer.state = HOST_BENCH_MPI_WRITER_IDLE;
+    }
+    if (target_len == MPI_SCIENCE_RING_BUFFER_SIZE_BYTES) {
+        result->crc_of_bytes_kept = lfs_crc(result->crc_of_bytes_kept, target, target_received_len);
+    }
+    else {
+        result->bytes_lost += target_received_len;
+    }
+    MPI_science_ring_complete_partial(target_received_len, (uint32_t)stop_ms);
+
+    writer.event_ms = (writer.event_ms > stop_ms) ? writer.event_ms : stop_ms;
+    while (1) {
+        const double write_ms = HOST_BENCH_mpi_ring_write_oldest(file, &writer, result);
+        if (write_ms < 0) {
+            return 1;
+        }
+        if (write_ms == 0) {
+            break;
+        }
+        MPI_science_ring_release();
+        HOST_BENCH_mpi_record_write(result, writer.written_buffer_filled_ms, writer.event_ms);
+        writer.state = HOST_BENCH_MPI_WRITER_IDLE;
+    }
+    return 0;
+}
+
+/// @brief Run a recording into a new file, and check that the file holds the bytes kept.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_mpi_run(
+    const HOST_BENCH_mpi_scenario_t *scenario, uint8_t is_ring, HOST_BENCH_mpi_result_t *result_out
+) {
+    *result_out = (HOST_BENCH_mpi_result_t){0};
+    lfs_remove(&LFS_filesystem, HOST_BENCH_mpi_file_path);
+
+    lfs_file_t file;
+    if (lfs_file_open(&LFS_filesystem, &file, HOST_BENCH_mpi_file_path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+        printf("  FAIL: open %s\n", HOST_BENCH_mpi_file_path);
+        return 1;
+    }
+    const uint8_t run_result = is_ring
+        ? HOST_BENCH_mpi_run_ring(scenario, &file, result_out)
+        : HOST_BENCH_mpi_run_ping_pong(scenario, &file, result_out);
+    if ((lfs_file_close(&LFS_filesystem, &file) < 0) || (run_result != 0)) {
+        printf("  FAIL: recording to %s\n", HOST_BENCH_mpi_file_path);
+        return 1;
+    }
+
+    if (lfs_file_open(&LFS_filesystem, &file, HOST_BENCH_mpi_file_path, LFS_O_RDONLY) < 0) {
+        printf("  FAIL: reopen %s\n", HOST_BENCH_mpi_file_path);
+        return 1;
+    }
+    uint32_t crc = 0;
+    uint8_t chunk[2048];
+    lfs_ssize_t chunk_len;
+    while ((chunk_len = lfs_file_read(&LFS_filesystem, &file, chunk, sizeof(chunk))) > 0) {
+        crc = lfs_crc(crc, chunk, (size_t)chunk_len);
+        result_out->bytes_stored += (uint32_t)chunk_len;
+    }
+    lfs_file_close(&LFS_filesystem, &file);
+    lfs_remove(&LFS_filesystem, HOST_BENCH_mpi_file_path);
+
+    // Lost bytes at the end of the ping-pong run were received but never written.
+    if (is_ring && (crc != result_out->crc_of_bytes_kept)) {
+        printf("  FAIL: stored data doesn't match the data received into the ring\n");
+        return 1;
+    }
+    const uint32_t total_bytes = (HOST_BENCH_MPI_BYTES_PER_SEC * HOST_BENCH_MPI_DURATION_SEC / HOST_BENCH_MPI_FRAME_BYTES) * HOST_BENCH_MPI_FRAME_BYTES;
+    if ((result_out->bytes_stored + result_out->bytes_lost + result_out->bytes_dropped_at_stop) != total_bytes) {
+        printf(
+            "  FAIL: %lu B stored + %lu B lost + %lu B dropped != %lu B received\n",
+            (unsigned long)result_out->bytes_stored, (unsigned long)result_out->bytes_lost,
+            (unsigned long)result_out->bytes_dropped_at_stop, (unsigned long)total_bytes
+        );
+        return 1;
+    }
+    return 0;
+}
+
+static void HOST_BENCH_mpi_print_row(const char label[], uint8_t is_ring, const HOST_BENCH_mpi_result_t *result) {
+    const double cycles_per_irq = HOST_BENCH_MPI_CYCLES_PER_IRQ + (is_ring ? HOST_BENCH_MPI_CYCLES_PER_DMA_RESTART : 0);
+    const double isr_cycles = ((double)result->irq_count * cycles_per_irq)
+        + ((double)result->bytes_moved_by_cpu * HOST_BENCH_MPI_CYCLES_PER_BYTE_MOVED);
+    printf(
+        "    %-32s %7lu %8lu %6lu %7.1f %9lu %7.3f%% %7.1f %7.1f\n",
+        label,
+        (unsigned long)result->bytes_lost,
+        (unsigned long)result->bytes_dropped_at_stop,
+        (unsigned long)result->irq_count,
+        (double)result->irq_count / HOST_BENCH_MPI_DURATION_SEC,
+        (unsigned long)result->bytes_moved_by_cpu,
+        100.0 * isr_cycles / (HOST_BENCH_MPI_CPU_HZ * HOST_BENCH_MPI_DURATION_SEC),
+        (result->buffers_written > 0) ? (result->sum_write_latency_ms / result->buffers_written) : 0.0,
+        result->max_write_latency_ms
+    );
+}
+
+uint8_t HOST_BENCH_mpi_science_ring(void) {
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    const uint32_t original_buffer_count = MPI_science_ring_buffer_count;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+
+    const HOST_BENCH_mpi_scenario_t scenarios[] = {
+        {.name = "downlink + GNSS firehose", .long_tcmd_period_ms = 0, .long_tcmd_duration_ms = 0},
+        {.name = "+ 1.5 s telecommand every 15 s", .long_tcmd_period_ms = 15000, .long_tcmd_duration_ms = 1500},
+    };
+    const uint8_t scenario_count = sizeof(scenarios) / sizeof(scenarios[0]);
+
+    // Per scenario: ping-pong, ring of 20, and ring of the minimum (3).
+    HOST_BENCH_mpi_result_t results[2][3];
+    uint8_t result = 0;
+    if (HOST_BENCH_reformat_filesystem() != 0) {
+        printf("  FAIL: reformat\n");
+        result = 1;
+    }
+    for (uint8_t i = 0; (result == 0) && (i < scenario_count); i++) {
+        result = HOST_BENCH_mpi_run(&scenarios[i], 0, &results[i][0]);
+        if (result == 0) {
+            MPI_science_ring_buffer_count = MPI_SCIENCE_RING_MAX_BUFFER_COUNT;
+            result = HOST_BENCH_mpi_run(&scenarios[i], 1, &results[i][1]);
+        }
+        if (result == 0) {
+            MPI_science_ring_buffer_count = MPI_SCIENCE_RING_MIN_BUFFER_COUNT;
+            result = HOST_BENCH_mpi_run(&scenarios[i], 1, &results[i][2]);
+        }
+    }
+
+    MPI_science_ring_buffer_count = original_buffer_count;
+    MPI_science_ring_reset();
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    if (result != 0) {
+        return 1;
+    }
+
+    printf(
+        "  %u s at 230400 baud (%lu B), 160 B frames\n",
+        HOST_BENCH_MPI_DURATION_SEC, (unsigned long)(HOST_BENCH_MPI_BYTES_PER_SEC * HOST_BENCH_MPI_DURATION_SEC)
+    );
+    printf(
+        "    %-32s %7s %8s %6s %7s %9s %8s %7s %7s\n",
+        "", "B lost", "B@stop", "IRQs", "IRQs/s", "B copied", "ISR CPU", "lat ms", "max ms"
+    );
+    for (uint8_t i = 0; i < scenario_count; i++) {
+        printf("  %s:\n", scenarios[i].name);
+        HOST_BENCH_mpi_print_row("ping-pong 2x20 KiB, 100 ms poll", 0, &results[i][0]);
+        HOST_BENCH_mpi_print_row("ring 20x2 KiB, woken", 1, &results[i][1]);
+        HOST_BENCH_mpi_print_row("ring 3x2 KiB, woken", 1, &results[i][2]);
+    }
+    printf("  (B lost: while recording; B@stop: received but not written at the stop; ISR CPU: est. at 16 MHz;\n");
+    printf("   lat: from a buffer filling to it being written)\n");
+
+    for (uint8_t i = 0; i < scenario_count; i++) {
+        if ((results[i][1].bytes_lost != 0) || (results[i][1].bytes_moved_by_cpu != 0)) {
+            printf("  FAIL: the ring of 20 lost or copied data (%s)\n", scenarios[i].name);
+            return 1;
+        }
+    }
+    if ((results[0][1].sum_write_latency_ms / results[0][1].buffers_written) >= (results[0][0].sum_write_latency_ms / results[0][0].buffers_written)) {
+        printf("  FAIL: the ring didn't reduce the write latency\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+// bench_tcmd_resp_store.c
+// Host benchmark of storing telecommand responses to `@resp_fname` files
+// (`telecommand_response_store.c`): opening, appending, and closing the file for every response
+// vs. keeping the files open and syncing in batches. Counts the flash pages programmed per 100
+// stored responses, for one response file and for two interleaved ones. Times are the NAND
+// emulator's modelled busy time.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/lfs.h"
+#include "littlefs/littlefs_helper.h"
+#include "telecommand_exec/telecommand_response_store.h"
+#include "telecommands/lfs_telecommand_defs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_BENCH_RESP_STORE_RESPONSE_COUNT 100
+
+typedef struct {
+    uint32_t page_program_count;
+    uint32_t block_erase_count;
+    double busy_ms;
+} HOST_BENCH_resp_store_result_t;
+
+static const char *HOST_BENCH_resp_store_fnames[] = {"resp_a.txt", "resp_b.txt"};
+
+/// @brief Count the entries in a response file, and check its size.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_resp_store_check_file(const char fname[], uint32_t expected_entry_count) {
+    static char file_data[64 * 1024];
+    const lfs_ssize_t size = LFS_read_file(fname, 0, (uint8_t *)file_data, sizeof(file_data) - 1);
+    if (size < 0) {
+        printf("  FAIL: read %s -> %ld\n", fname, (long)size);
+        return 1;
+    }
+    file_data[size] = '\0';
+
+    uint32_t entry_count = 0;
+    for (const char *c = file_data; (c = strstr(c, "\n[END_RESPONSE]\n")) != NULL; c++) {
+        entry_count++;
+    }
+    if (entry_count != expected_entry_count) {
+        printf("  FAIL: %s has %lu entries, expected %lu\n", fname, (unsigned long)entry_count, (unsigned long)expected_entry_count);
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Store the responses (as the executor does), then close the files.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_resp_store_run(
+    uint8_t batching_enabled, uint8_t file_count, HOST_BENCH_resp_store_result_t *result_out
+) {
+    *result_out = (HOST_BENCH_resp_store_result_t){0};
+    TCMD_resp_store_batching_enabled = batching_enabled;
+    for (uint8_t i = 0; i < file_count; i++) {
+        lfs_remove(&LFS_filesystem, HOST_BENCH_resp_store_fnames[i]);
+    }
+    TCMD_resp_store_reset_stats();
+    HOST_NAND_reset_stats();
+
+    for (uint32_t i = 0; i < HOST_BENCH_RESP_STORE_RESPONSE_COUNT; i++) {
+        // A header like `TCMD_store_resp_to_file`'s, and a short response.
+        char header[160];
+        snprintf(
+            header, sizeof(header),
+            "{\"ts_sent\":%lu,\"ts_done\":%lu,\"tcmd\":\"eps_get_pdu_housekeeping_data_eng_json\","
+            "\"duration_ms\":12,\"return\":0,\"args\":\"\"}\n",
+            1760000000000UL + (i * 60000UL), 1760000000012UL + (i * 60000UL)
+        );
+        char response[96];
+        snprintf(response, sizeof(response), "{\"vbat_mv\":%lu,\"ibat_ma\":%lu,\"temp_c\":21}", 7400UL + i, 300UL + i);
+
+        const int8_t write_result = TCMD_resp_store_write_entry(
+            HOST_BENCH_resp_store_fnames[i % file_count], header, response
+        );
+        if (write_result != 0) {
+            printf("  FAIL: TCMD_resp_store_write_entry() -> %d\n", write_result);
+            return 1;
+        }
+    }
+    if (TCMD_resp_store_close_all() != 0) {
+        printf("  FAIL: TCMD_resp_store_close_all()\n");
+        return 1;
+    }
+
+    HOST_NAND_chip_stats_t stats;
+    HOST_NAND_get_total_stats(&stats);
+    result_out->page_program_count = stats.page_program_count;
+    result_out->block_erase_count = stats.block_erase_count;
+    result_out->busy_ms = (double)stats.modelled_busy_us / 1000.0;
+
+    for (uint8_t i = 0; i < file_count; i++) {
+        if (HOST_BENCH_resp_store_check_file(HOST_BENCH_resp_store_fnames[i], HOST_BENCH_RESP_STORE_RESPONSE_COUNT / file_count) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/// @brief Format the filesystem while a batched response file is open. The file must be closed
+///     first, rather than left for the handle to be dropped after the next mount.
+/// @return 0 on success, 1 on failure.
+static uint8_t HOST_BENCH_resp_store_check_format_closes_files(void) {
+    TCMD_resp_store_batching_enabled = 1;
+    TCMD_resp_store_reset_stats();
+    if (TCMD_resp_store_write_entry(HOST_BENCH_resp_store_fnames[0], "{}\n", "{}") != 0) {
+        printf("  FAIL: TCMD_resp_store_write_entry() before format\n");
+        return 1;
+    }
+
+    char response[128];
+    if (TCMDEXEC_fs_format_storage("", response, sizeof(response)) != 0) {
+        printf("  FAIL: fs_format_storage: %s\n", response);
+        return 1;
+    }
+    LFS_ensure_mounted();
+    TCMD_resp_store_close_all();
+    if ((TCMD_resp_store_stats.close_count != 1) || (TCMD_resp_store_stats.dropped_handle_count != 0)) {
+        printf(
+            "  FAIL: format left the response file open (closed %lu, dropped %lu)\n",
+            (unsigned long)TCMD_resp_store_stats.close_count,
+            (unsigned long)TCMD_resp_store_stats.dropped_handle_count
+        );
+        return 1;
+    }
+    return 0;
+}
+
+static void HOST_BENCH_resp_store_print_row(const char label[], const HOST_BENCH_resp_store_result_t *result) {
+    printf(
+        "  %-34s %10lu %10lu %10.1f\n",
+        label,
+        (unsigned long)result->page_program_count,
+        (unsigned long)result->block_erase_count,
+        result->busy_ms
+    );
+}
+
+uint8_t HOST_BENCH_tcmd_resp_store(void) {
+    const uint8_t original_to_stdout = HOST_umbilical_uart_to_stdout_enabled;
+    const uint32_t original_batching_enabled = TCMD_resp_store_batching_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+
+    HOST_BENCH_resp_store_result_t results[4];
+    uint8_t result = 0;
+    if (HOST_BENCH_reformat_filesystem() != 0) {
+        printf("  FAIL: reformat\n");
+        result = 1;
+    }
+    for (uint8_t run = 0; (result == 0) && (run < 4); run++) {
+        const uint8_t batching_enabled = run % 2;
+        const uint8_t file_count = (run < 2) ? 1 : 2;
+        result = HOST_BENCH_resp_store_run(batching_enabled, file_count, &results[run]);
+    }
+    if (result == 0) {
+        result = HOST_BENCH_resp_store_check_format_closes_files();
+    }
+
+    TCMD_resp_store_batching_enabled = original_batching_enabled;
+    HOST_umbilical_uart_to_stdout_enabled = original_to_stdout;
+    if (result != 0) {
+        return 1;
+    }
+
+    printf("  %u responses (~200 B each)\n", HOST_BENCH_RESP_STORE_RESPONSE_COUNT);
+    printf("  %-34s %10s %10s %10s\n", "", "pages prog", "erases", "flash ms");
+    HOST_BENCH_resp_store_print_row("1 file, open/close per response", &results[0]);
+    HOST_BENCH_resp_store_print_row("1 file, batched", &results[1]);
+    HOST_BENCH_resp_store_print_row("2 files, open/close per response", &results[2]);
+    HOST_BENCH_resp_store_print_row("2 files, batched", &results[3]);
+
+    if ((results[1].page_program_count >= results[0].page_program_count) || (results[3].page_program_count >= results[2].page_program_count)) {
+        printf("  FAIL: batching didn't reduce the pages programmed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+// bench_telecommand_parser.c
+// Host benchmarks and self-tests for the telecommand parser.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "telecommand_exec/telecommand_args_helpers.h"
+#include "telecommand_exec/telecommand_definitions.h"
+#include "telecommand_exec/telecommand_parser.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_BENCH_TCMD_NAME_LOOKUP_ROUNDS 200
+#define HOST_BENCH_TCMD_ARGS_ROUNDS 20000
+
+/// @brief The telecommand name lookup before the sorted name index: `strlen` and compare against
+///     every entry in the table.
+static int32_t HOST_BENCH_tcmd_name_linear_lookup(const char *name, uint16_t name_len) {
+    for (uint16_t tcmd_idx = 0; tcmd_idx < TCMD_NUM_TELECOMMANDS; tcmd_idx++) {
+        if (name_len != strlen(TCMD_telecommand_definitions[tcmd_idx].tcmd_name)) {
+            continue;
+        }
+        if (strncmp(name, TCMD_telecommand_definitions[tcmd_idx].tcmd_name, name_len) == 0) {
+            return tcmd_idx;
+        }
+    }
+    return -1;
+}
+
+/// @brief Look up every telecommand name (as the parser does for each uplinked or agenda-file
+///     telecommand), comparing the sorted name index against a linear scan of the table.
+uint8_t HOST_BENCH_tcmd_name_lookup(void) {
+    char tcmd_str[TCMD_MAX_FULL_LENGTH];
+
+    for (int16_t tcmd_idx = 0; tcmd_idx < TCMD_NUM_TELECOMMANDS; tcmd_idx++) {
+        const char *tcmd_name = TCMD_telecommand_definitions[tcmd_idx].tcmd_name;
+        snprintf(tcmd_str, sizeof(tcmd_str), "CTS1+%s()!", tcmd_name);
+        if (TCMD_parse_telecommand_get_index(tcmd_str, strlen(tcmd_str)) != tcmd_idx) {
+            printf("  FAIL: '%s' not found at index %d\n", tcmd_name, tcmd_idx);
+            return 1;
+        }
+    }
+
+    volatile int32_t sink = 0;
+    const uint64_t index_start_us = HOST_get_monotonic_time_us();
+    for (uint32_t round = 0; round < HOST_BENCH_TCMD_NAME_LOOKUP_ROUNDS; round++) {
+        for (int16_t tcmd_idx = 0; tcmd_idx < TCMD_NUM_TELECOMMANDS; tcmd_idx++) {
+            const char *tcmd_name = TCMD_telecommand_definitions[tcmd_idx].tcmd_name;
+            sink += TCMD_get_telecommand_idx_by_name(tcmd_name, strlen(tcmd_name));
+        }
+    }
+    const uint64_t index_us = HOST_get_monotonic_time_us() - index_start_us;
+
+    const uint64_t linear_start_us = HOST_get_monotonic_time_us();
+    for (uint32_t round = 0; round < HOST_BENCH_TCMD_NAME_LOOKUP_ROUNDS; round++) {
+        for (int16_t tcmd_idx = 0; tcmd_idx < TCMD_NUM_TELECOMMANDS; tcmd_idx++) {
+            const char *tcmd_name = TCMD_telecommand_definitions[tcmd_idx].tcmd_name;
+            sink += HOST_BENCH_tcmd_name_linear_lookup(tcmd_name, strlen(tcmd_name));
+        }
+    }
+    const uint64_t linear_us = HOST_get_monotonic_time_us() - linear_start_us;
+    (void)sink;
+
+    const uint32_t lookup_count = HOST_BENCH_TCMD_NAME_LOOKUP_ROUNDS * TCMD_NUM_TELECOMMANDS;
+    printf(
+        "  %d telecommands: sorted index %.1f ns/lookup, linear scan %.1f ns/lookup\n",
+        TCMD_NUM_TELECOMMANDS,
+        (double)index_us * 1000.0 / lookup_count,
+        (double)linear_us * 1000.0 / lookup_count
+    );
+    return 0;
+}
+
+/// @brief The argument extraction before the tokenizer: scan from the start of the args string to
+///     the requested argument on every call.
+static uint8_t HOST_BENCH_rescan_uint64_arg(
+    const char *str, uint32_t str_len, uint8_t arg_index, uint64_t *result
+) {
+    uint32_t arg_count = 0;
+    uint32_t i = 0;
+    uint32_t start_index = 0;
+    for (; i < str_len; i++) {
+        if (str[i] == ',') {
+            if (arg_count == arg_index) {
+                break;
+            }
+            arg_count++;
+            start_index = i + 1;
+        }
+    }
+    if (arg_count < arg_index) {
+        return 2;
+    }
+    return TCMD_ascii_to_uint64(&str[start_index], i - start_index, result);
+}
+
+/// @brief Extract every argument of multi-argument telecommands (the largest ADCS/GNSS-style
+///     commands have 10-20), comparing a single tokenize pass against rescanning per argument.
+uint8_t HOST_BENCH_tcmd_args_tokenizer(void) {
+    static const uint8_t arg_counts[] = {2, 6, 12, 20, 28};
+    char args_str[TCMD_MAX_FULL_LENGTH];
+
+    for (uint8_t count_idx = 0; count_idx < sizeof(arg_counts); count_idx++) {
+        const uint8_t arg_count = arg_counts[count_idx];
+        args_str[0] = '\0';
+        for (uint8_t arg_idx = 0; arg_idx < arg_count; arg_idx++) {
+            const size_t len = strlen(args_str);
+            snprintf(
+                &args_str[len], sizeof(args_str) - len, "%s%u",
+                (arg_idx == 0) ? "" : ",", 1000000u + arg_idx
+            );
+        }
+        const uint32_t args_str_len = strlen(args_str);
+
+        // Check that both give the same values, before timing.
+        TCMD_args_t args;
+        TCMD_tokenize_args(args_str, args_str_len, &args);
+        if (args.arg_count != arg_count) {
+            printf("  FAIL: tokenized %u args, expected %u\n", args.arg_count, arg_count);
+            return 1;
+        }
+        for (uint8_t arg_idx = 0; arg_idx < arg_count; arg_idx++) {
+            uint64_t value_tokenized = 0;
+            uint64_t value_rescan = 0;
+            const uint8_t tokenized_result = TCMD_args_get_uint64(&args, arg_idx, &value_tokenized);
+            const uint8_t rescan_result = HOST_BENCH_rescan_uint64_arg(
+                args_str, args_str_len, arg_idx, &value_rescan
+            );
+            if ((tokenized_result != 0) || (rescan_result != 0)
+                || (value_tokenized != 1000000u + arg_idx) || (value_tokenized != value_rescan)
+            ) {
+                printf("  FAIL: arg %u of %u mismatched\n", arg_idx, arg_count);
+                return 1;
+            }
+        }
+
+        volatile uint64_t sink = 0;
+        const uint64_t tokenized_start_us = HOST_get_monotonic_time_us();
+        for (uint32_t round = 0; round < HOST_BENCH_TCMD_ARGS_ROUNDS; round++) {
+            TCMD_tokenize_args(args_str, args_str_len, &args);
+            for (uint8_t arg_idx = 0; arg_idx < arg_count; arg_idx++) {
+                uint64_t value = 0;
+                TCMD_args_get_uint64(&args, arg_idx, &value);
+                sink += value;
+            }
+        }
+        const uint64_t tokenized_us = HOST_get_monotonic_time_us() - tokenized_start_us;
+
+        const uint64_t rescan_start_us = HOST_get_monotonic_time_us();
+        for (uint32_t round = 0; round < HOST_BENCH_TCMD_ARGS_ROUNDS; round++) {
+            for (uint8_t arg_idx = 0; arg_idx < arg_count; arg_idx++) {
+                uint64_t value = 0;
+                HOST_BENCH_rescan_uint64_arg(args_str, args_str_len, arg_idx, &value);
+                sink += value;
+            }
+        }
+        const uint64_t rescan_us = HOST_get_monotonic_time_us() - rescan_start_us;
+        (void)sink;
+
+        printf(
+            "  %2u args (%3lu chars): tokenized %7.1f ns/command, rescan per arg %7.1f ns/command\n",
+            arg_count, (unsigned long)args_str_len,
+            (double)tokenized_us * 1000.0 / HOST_BENCH_TCMD_ARGS_ROUNDS,
+            (double)rescan_us * 1000.0 / HOST_BENCH_TCMD_ARGS_ROUNDS
+        );
+    }
+    return 0;
+}
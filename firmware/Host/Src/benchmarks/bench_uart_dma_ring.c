@@ -0,0 +1,298 @@
+// bench_uart_dma_ring.c
+// Host benchmark of UART reception: byte-by-byte interrupts into a linear buffer (as the GNSS,
+// EPS and telecommand ports were received) vs. circular DMA with IDLE-line events into a
+// `UART_dma_ring_t`. The UART line is emulated one byte-time at a time at 115200 baud.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "uart_handler/uart_dma_ring.h"
+#include "littlefs/lfs_util.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// 115200 baud, 8N1: 10 bits per byte.
+#define HOST_BENCH_UART_BYTES_PER_SEC 11520
+#define HOST_BENCH_UART_DURATION_SEC 10
+
+// The CPU load estimate is for the flight configuration: SYSCLK is HSI (16 MHz). Each interrupt
+// (HAL IRQ handler, callback dispatch, and re-arm) is assumed to cost about 300 cycles, and each
+// byte the CPU copies out of or within a volatile buffer about 4 cycles.
+#define HOST_BENCH_UART_CPU_HZ 16000000.0
+#define HOST_BENCH_UART_CYCLES_PER_IRQ 300
+#define HOST_BENCH_UART_CYCLES_PER_BYTE_MOVED 4
+
+// Same size as the GNSS buffer, both before (`UART_gnss_buffer`) and after (`UART_gnss_rx_ring`).
+#define HOST_BENCH_UART_BUFFER_LEN 2048
+
+// `TASK_background_upkeep` stores the GNSS firehose data about once per 1.1 s.
+#define HOST_BENCH_UART_DRAIN_INTERVAL_BYTES (HOST_BENCH_UART_BYTES_PER_SEC * 11 / 10)
+
+typedef struct {
+    const char *name;
+
+    /// @brief Line contents, repeated every `period_bytes` byte-times. The rest of the period is idle.
+    const char *line;
+    uint16_t line_len;
+    uint16_t period_bytes;
+
+    /// @brief 1 if the consumer runs inside the ISR (telecommand port), else it runs periodically
+    ///     (GNSS firehose storage).
+    uint8_t is_consumer_in_isr;
+} HOST_BENCH_uart_scenario_t;
+
+typedef struct {
+    uint32_t irq_count;
+    uint32_t bytes_moved_by_cpu;
+    uint32_t bytes_received;
+    uint32_t bytes_lost;
+    uint32_t crc_of_bytes_received;
+    uint64_t isr_host_us;
+} HOST_BENCH_uart_result_t;
+
+static volatile uint8_t HOST_BENCH_uart_linear_buffer[HOST_BENCH_UART_BUFFER_LEN];
+static volatile uint8_t HOST_BENCH_uart_dma_buffer[HOST_BENCH_UART_BUFFER_LEN];
+
+static uint8_t HOST_BENCH_uart_scenario_byte(
+    const HOST_BENCH_uart_scenario_t *scenario, uint32_t byte_time, uint8_t *byte_out
+) {
+    const uint32_t pos_in_period = byte_time % scenario->period_bytes;
+    if (pos_in_period >= scenario->line_len) {
+        return 0;
+    }
+    *byte_out = (uint8_t)scenario->line[pos_in_period];
+    return 1;
+}
+
+/// @brief Copy of the byte-by-byte GNSS handler from before circular DMA: append, and if the
+///     buffer is full, shift everything left by one to make room.
+static void HOST_BENCH_uart_linear_isr(
+    uint8_t rx_byte, uint16_t *write_idx, HOST_BENCH_uart_result_t *result
+) {
+    if (*write_idx >= HOST_BENCH_UART_BUFFER_LEN) {
+        result->bytes_lost++;
+        for (uint16_t i = 1; i < HOST_BENCH_UART_BUFFER_LEN; i++) {
+            HOST_BENCH_uart_linear_buffer[i - 1] = HOST_BENCH_uart_linear_buffer[i];
+        }
+        result->bytes_moved_by_cpu += HOST_BENCH_UART_BUFFER_LEN - 1;
+        *write_idx = HOST_BENCH_UART_BUFFER_LEN - 1;
+    }
+    HOST_BENCH_uart_linear_buffer[(*write_idx)++] = rx_byte;
+    result->bytes_moved_by_cpu++;
+}
+
+static void HOST_BENCH_uart_linear_drain(uint16_t *write_idx, HOST_BENCH_uart_result_t *result) {
+    uint8_t chunk[HOST_BENCH_UART_BUFFER_LEN];
+    for (uint16_t i = 0; i < *write_idx; i++) {
+        chunk[i] = HOST_BENCH_uart_linear_buffer[i];
+    }
+    result->crc_of_bytes_received = lfs_crc(result->crc_of_bytes_received, chunk, *write_idx);
+    result->bytes_moved_by_cpu += *write_idx;
+    result->bytes_received += *write_idx;
+    *write_idx = 0;
+}
+
+static void HOST_BENCH_uart_run_linear(
+    const HOST_BENCH_uart_scenario_t *scenario, HOST_BENCH_uart_result_t *result
+) {
+    memset(result, 0, sizeof(*result));
+    uint16_t write_idx = 0;
+
+    const uint32_t total_byte_times = HOST_BENCH_UART_BYTES_PER_SEC * HOST_BENCH_UART_DURATION_SEC;
+    for (uint32_t byte_time = 0; byte_time < total_byte_times; byte_time++) {
+        uint8_t rx_byte;
+        if (HOST_BENCH_uart_scenario_byte(scenario, byte_time, &rx_byte)) {
+            const uint64_t isr_start_us = HOST_get_monotonic_time_us();
+            result->irq_count++;
+            HOST_BENCH_uart_linear_isr(rx_byte, &write_idx, result);
+            if (scenario->is_consumer_in_isr) {
+                HOST_BENCH_uart_linear_drain(&write_idx, result);
+            }
+            result->isr_host_us += HOST_get_monotonic_time_us() - isr_start_us;
+        }
+        if ((!scenario->is_consumer_in_isr) && ((byte_time % HOST_BENCH_UART_DRAIN_INTERVAL_BYTES) == 0)) {
+            HOST_BENCH_uart_linear_drain(&write_idx, result);
+        }
+    }
+    HOST_BENCH_uart_linear_drain(&write_idx, result);
+}
+
+/// @brief Read everything available out of the ring, as `GNSS_subtask_store_firehose_data_to_file` does.
+static void HOST_BENCH_uart_ring_drain(UART_dma_ring_t *ring, HOST_BENCH_uart_result_t *result) {
+    uint8_t chunk[512];
+    uint16_t chunk_len;
+    while ((chunk_len = UART_dma_ring_read(ring, chunk, sizeof(chunk))) > 0) {
+        result->crc_of_bytes_received = lfs_crc(result->crc_of_bytes_received, chunk, chunk_len);
+        result->bytes_moved_by_cpu += chunk_len;
+        result->bytes_received += chunk_len;
+    }
+}
+
+/// @brief An RX event interrupt: `HAL_UARTEx_RxEventCallback` with `size` (the DMA position).
+static void HOST_BENCH_uart_ring_event(
+    const HOST_BENCH_uart_scenario_t *scenario, UART_dma_ring_t *ring, uint16_t size,
+    HOST_BENCH_uart_result_t *result
+) {
+    const uint64_t isr_start_us = HOST_get_monotonic_time_us();
+    result->irq_count++;
+    UART_dma_ring_on_rx_event(ring, size);
+    if (scenario->is_consumer_in_isr) {
+        HOST_BENCH_uart_ring_drain(ring, result);
+    }
+    result->isr_host_us += HOST_get_monotonic_time_us() - isr_start_us;
+}
+
+static void HOST_BENCH_uart_run_dma_ring(
+    const HOST_BENCH_uart_scenario_t *scenario, HOST_BENCH_uart_result_t *result
+) {
+    memset(result, 0, sizeof(*result));
+    UART_dma_ring_t ring;
+    UART_dma_ring_init(&ring, HOST_BENCH_uart_dma_buffer, HOST_BENCH_UART_BUFFER_LEN);
+    UART_dma_ring_restart(&ring);
+
+    uint16_t dma_pos = 0;
+    uint8_t was_line_active = 0;
+    const uint32_t total_byte_times = HOST_BENCH_UART_BYTES_PER_SEC * HOST_BENCH_UART_DURATION_SEC;
+    for (uint32_t byte_time = 0; byte_time <= total_byte_times; byte_time++) {
+        uint8_t rx_byte;
+        const uint8_t is_line_active = (byte_time < total_byte_times)
+            && HOST_BENCH_uart_scenario_byte(scenario, byte_time, &rx_byte);
+
+        if (is_line_active) {
+            // The DMA stores the byte; no CPU involvement.
+            HOST_BENCH_uart_dma_buffer[dma_pos++] = rx_byte;
+            if (dma_pos == (HOST_BENCH_UART_BUFFER_LEN / 2)) {
+                HOST_BENCH_uart_ring_event(scenario, &ring, dma_pos, result); // Half-transfer.
+            }
+            else if (dma_pos == HOST_BENCH_UART_BUFFER_LEN) {
+                HOST_BENCH_uart_ring_event(scenario, &ring, dma_pos, result); // Transfer-complete.
+                dma_pos = 0;
+            }
+        }
+        else if (was_line_active) {
+            // IDLE line. The HAL only calls the callback if the DMA isn't at the start of the
+            // buffer (i.e., just after transfer-complete), but the interrupt happens either way.
+            if (dma_pos != 0) {
+                HOST_BENCH_uart_ring_event(scenario, &ring, dma_pos, result);
+            }
+            else {
+                result->irq_count++;
+            }
+        }
+        was_line_active = is_line_active;
+
+        if ((!scenario->is_consumer_in_isr) && ((byte_time % HOST_BENCH_UART_DRAIN_INTERVAL_BYTES) == 0)) {
+            HOST_BENCH_uart_ring_drain(&ring, result);
+        }
+    }
+    HOST_BENCH_uart_ring_drain(&ring, result);
+    result->bytes_lost = ring.overrun_bytes_lost;
+}
+
+static void HOST_BENCH_uart_print_result(const char label[], const HOST_BENCH_uart_result_t *result) {
+    const double cpu_cycles = ((double)result->irq_count * HOST_BENCH_UART_CYCLES_PER_IRQ)
+        + ((double)result->bytes_moved_by_cpu * HOST_BENCH_UART_CYCLES_PER_BYTE_MOVED);
+    printf(
+        "    %-15s %7lu IRQs (%6.1f/s), %6lu B lost, %9lu B moved by CPU, est. CPU load %6.2f%%, host ISR time %6.2f ms\n",
+        label,
+        (unsigned long)result->irq_count,
+        (double)result->irq_count / HOST_BENCH_UART_DURATION_SEC,
+        (unsigned long)result->bytes_lost,
+        (unsigned long)result->bytes_moved_by_cpu,
+        100.0 * cpu_cycles / (HOST_BENCH_UART_CPU_HZ * HOST_BENCH_UART_DURATION_SEC),
+        (double)result->isr_host_us / 1000.0
+    );
+}
+
+/// @brief Check that a DMA restart (e.g., re-arming after a UART error) discards the unread bytes
+///     and that reading continues from the start of the buffer.
+static uint8_t HOST_BENCH_uart_dma_ring_restart_check(void) {
+    UART_dma_ring_t ring;
+    if (UART_dma_ring_init(&ring, HOST_BENCH_uart_dma_buffer, 100) == 0) {
+        printf("  FAIL: ring accepted a length which is not a power of two\n");
+        return 1;
+    }
+    UART_dma_ring_init(&ring, HOST_BENCH_uart_dma_buffer, 64);
+
+    uint8_t out[64];
+    memset((void *)HOST_BENCH_uart_dma_buffer, 'a', 40);
+    UART_dma_ring_on_rx_event(&ring, 40);
+    if ((UART_dma_ring_read(&ring, out, 10) != 10) || (UART_dma_ring_available(&ring) != 30)) {
+        printf("  FAIL: ring read before restart\n");
+        return 2;
+    }
+
+    // Restart with 30 bytes unread, then receive 5 new bytes at the start of the buffer.
+    UART_dma_ring_restart(&ring);
+    memcpy((void *)HOST_BENCH_uart_dma_buffer, "fresh", 5);
+    UART_dma_ring_on_rx_event(&ring, 5);
+    const uint16_t read_len = UART_dma_ring_read(&ring, out, sizeof(out));
+    if ((read_len != 5) || (memcmp(out, "fresh", 5) != 0) || (ring.overrun_bytes_lost != 0)) {
+        printf("  FAIL: ring read after restart returned %u bytes\n", read_len);
+        return 3;
+    }
+    return 0;
+}
+
+/// @brief Compare the interrupt count and CPU load of byte-by-byte vs. circular-DMA reception.
+uint8_t HOST_BENCH_uart_dma_ring_firehose(void) {
+    const uint8_t restart_check_result = HOST_BENCH_uart_dma_ring_restart_check();
+    if (restart_check_result != 0) {
+        return restart_check_result;
+    }
+
+    static const char gnss_line[] =
+        "#BESTXYZA,COM1,0,72.5,FINESTEERING,2210,425000.000,02000000,d821,16809;SOL_COMPUTED,"
+        "NARROW_INT,-1634531.5683,-3664618.0326,4942496.3270,0.0099,0.0219,*5ea733a7\r\n";
+    static const char null_bytes[1] = { 0 };
+    static const char telecommand[] = "CTS1+agenda_delete_by_tssent(1763332496000)@tssent=1763332497000!";
+
+    const HOST_BENCH_uart_scenario_t scenarios[] = {
+        {
+            // `log bestxyza ontime 0.1`
+            .name = "GNSS firehose, 10 Hz BESTXYZA",
+            .line = gnss_line, .line_len = sizeof(gnss_line) - 1,
+            .period_bytes = HOST_BENCH_UART_BYTES_PER_SEC / 10,
+            .is_consumer_in_isr = 0,
+        },
+        {
+            // The failure mode where the GNSS streams null bytes at the full line rate.
+            .name = "GNSS null-byte spam, full line rate",
+            .line = null_bytes, .line_len = 1, .period_bytes = 1,
+            .is_consumer_in_isr = 0,
+        },
+        {
+            .name = "Umbilical telecommands, 50/s",
+            .line = telecommand, .line_len = sizeof(telecommand) - 1,
+            .period_bytes = HOST_BENCH_UART_BYTES_PER_SEC / 50,
+            .is_consumer_in_isr = 1,
+        },
+    };
+
+    for (uint8_t scenario_idx = 0; scenario_idx < sizeof(scenarios) / sizeof(scenarios[0]); scenario_idx++) {
+        const HOST_BENCH_uart_scenario_t *scenario = &scenarios[scenario_idx];
+        HOST_BENCH_uart_result_t linear_result;
+        HOST_BENCH_uart_result_t ring_result;
+        HOST_BENCH_uart_run_linear(scenario, &linear_result);
+        HOST_BENCH_uart_run_dma_ring(scenario, &ring_result);
+
+        const uint32_t bytes_sent = linear_result.bytes_received + linear_result.bytes_lost;
+        printf("  %s: %lu B in %d s\n", scenario->name, (unsigned long)bytes_sent, HOST_BENCH_UART_DURATION_SEC);
+        HOST_BENCH_uart_print_result("per-byte IRQ:", &linear_result);
+        HOST_BENCH_uart_print_result("circular DMA:", &ring_result);
+
+        if ((ring_result.bytes_received + ring_result.bytes_lost) != bytes_sent) {
+            printf("  FAIL: DMA ring received %lu + lost %lu != sent %lu\n",
+                (unsigned long)ring_result.bytes_received, (unsigned long)ring_result.bytes_lost,
+                (unsigned long)bytes_sent);
+            return 10 + scenario_idx;
+        }
+        if ((ring_result.bytes_lost == 0) && (linear_result.bytes_lost == 0)
+            && (ring_result.crc_of_bytes_received != linear_result.crc_of_bytes_received)
+        ) {
+            printf("  FAIL: DMA ring received different data than per-byte reception\n");
+            return 20 + scenario_idx;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// host_firmware_stand_ins.c
+// Definitions normally provided by firmware modules which are not part of the host build
+// (RTOS tasks, EPS/GNSS/MPI drivers, beacon). Defaults match the flight firmware's values.
+
+#include "comms_drivers/comms_tx.h"
+#include "comms_drivers/beacon.h"
+#include "rtos_tasks/rtos_bootup_operation_fsm_task.h"
+#include "rtos_tasks/rtos_logger_task.h"
+#include "rtos_tasks/rtos_task_helpers.h"
+#include "log/log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// From `rtos_bootup_operation_fsm_task.c`. Radio TX is enabled, so downlink paths are exercised.
+CTS1_operation_state_enum_t CTS1_operation_state = CTS1_OPERATION_STATE_NOMINAL_WITH_RADIO_TX;
+uint32_t COMMS_uptime_to_start_ant_deployment_sec = 60 * 60;
+
+// From `rf_antenna_switch.c`.
+uint8_t COMMS_active_rf_switch_antenna = 1;
+uint32_t COMMS_max_duration_without_uplink_before_setting_default_rf_switch_mode_sec = 15 * 60;
+
+// From `beacon.c`.
+char COMMS_beacon_friendly_message_str[COMMS_BEACON_FRIENDLY_MESSAGE_SIZE] = "Hello from CalgaryToSpace FrontierSat";
+
+// From `rtos_background_upkeep.c`.
+uint32_t COMMS_beacon_interval_ms = 20000;
+uint32_t EPS_max_time_deviation_for_sync_ms = 2000;
+uint32_t EPS_monitor_safety_adcs_interval_ms = 20000;
+uint32_t EPS_time_sync_period_sec = 600;
+uint32_t STM32_system_reset_interval_sec = 604800;
+uint32_t STM32_system_reset_no_uplink_interval_sec = 216000;
+uint32_t TCMD_enqueue_from_agenda_file_interval_ms = 45000;
+uint32_t TCMD_enqueue_grace_period_ms = 15000;
+
+// From `rtos_bulk_downlink_task.c`.
+uint32_t COMMS_bulk_downlink_delay_per_packet_ms = 208;
+
+// From `rtos_logger_task.c`.
+uint32_t LOG_logger_task_idle_poll_period_ms = 1000;
+
+// From `rtos_tasks.c`.
+uint32_t TASK_heartbeat_period_ms = 10990;
+uint32_t TCMD_max_consecutive_burst_execution_size = 3;
+
+// From `rtos_mpi_tasks.c`.
+uint32_t MPI_max_temperature_shutoff_celcius = 60;
+uint32_t MPI_max_recording_duration_sec = 900;
+
+// From `eps_internal_drivers.c`.
+uint32_t CONFIG_EPS_enable_uart_debug_print = 0;
+
+// From `gnss_internal_drivers.c`.
+uint32_t GNSS_write_cmd_mode_data_to_firehose_file = 1;
+
+// From `flash_driver.c`. Also read by the NAND emulator's timing model.
+uint32_t FLASH_cache_read_enabled = 1;
+
+/// @brief The beacon's sources (EPS, sensors, etc.) are not simulated, so it is sent zero-filled.
+void COMMS_fill_beacon_basic_packet(COMMS_beacon_basic_packet_t *beacon_packet) {
+    memset(beacon_packet, 0, sizeof(COMMS_beacon_basic_packet_t));
+}
+
+/// @brief There is no logger task on the host build; the benches drain the log queue themselves.
+void TASK_logger_wake(void) {
+}
+
+/// @brief Stands in for blocking until the logger task runs: write out one queued message.
+uint8_t TASK_logger_wait_for_queue_space(void) {
+    return (LOG_process_queued_messages(1) > 0) ? 0 : 1;
+}
+
+/// @brief Single-threaded on the host build, so the locks (e.g., the agenda file index) are no-ops.
+uint8_t TASK_HELP_lazy_mutex_lock(TASK_HELP_lazy_mutex_t *lazy_mutex) {
+    return 0;
+}
+
+uint8_t TASK_HELP_lazy_mutex_unlock(TASK_HELP_lazy_mutex_t *lazy_mutex) {
+    return 0;
+}
+
+/// @brief Substituted (at link time, by `Makefile.host.mk`) for each telecommand function whose
+///     module is not part of the host build.
+uint8_t HOST_tcmdexec_unavailable(
+    const char *args_str, char *response_output_buf, uint16_t response_output_buf_len
+) {
+    snprintf(
+        response_output_buf, response_output_buf_len,
+        "Telecommand not available in the host simulation build."
+    );
+    return 1;
+}
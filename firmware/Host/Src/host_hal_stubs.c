@@ -0,0 +1,243 @@
+// host_hal_stubs.c
+// Host implementations of the STM32 HAL and CMSIS-RTOS functions declared in `Host/Inc`.
+// The umbilical UART (hlpuart1) is written to stdout. All other peripherals accept and discard data.
+
+#include "main.h"
+#include "timekeeping/timekeeping.h"
+#include "host_sim/host_hal_stubs.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+ADC_HandleTypeDef hadc1 = {.host_peripheral_name = "hadc1"};
+I2C_HandleTypeDef hi2c1 = {.host_peripheral_name = "hi2c1"};
+I2C_HandleTypeDef hi2c2 = {.host_peripheral_name = "hi2c2"};
+I2C_HandleTypeDef hi2c3 = {.host_peripheral_name = "hi2c3"};
+I2C_HandleTypeDef hi2c4 = {.host_peripheral_name = "hi2c4"};
+
+UART_HandleTypeDef hlpuart1 = {.host_peripheral_name = "hlpuart1"};
+UART_HandleTypeDef huart1 = {.host_peripheral_name = "huart1"};
+UART_HandleTypeDef huart2 = {.host_peripheral_name = "huart2"};
+UART_HandleTypeDef huart3 = {.host_peripheral_name = "huart3"};
+UART_HandleTypeDef huart4 = {.host_peripheral_name = "huart4"};
+UART_HandleTypeDef huart5 = {.host_peripheral_name = "huart5"};
+
+SPI_HandleTypeDef hspi1 = {.host_peripheral_name = "hspi1"};
+
+TIM_HandleTypeDef htim16 = {.host_peripheral_name = "htim16"};
+
+GPIO_TypeDef HOST_gpio_ports[8] = {{0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}};
+
+// One 16-bit output register per port.
+static uint16_t HOST_gpio_output_state[8];
+
+HOST_peripheral_counters_t HOST_i2c_counters;
+HOST_peripheral_counters_t HOST_uart_counters;
+
+/// @brief Modelled I2C transfer time. When 0, transfers complete immediately (DMA transfers call
+///     the completion callback before returning).
+uint32_t HOST_i2c_transfer_us_per_byte = 0;
+
+/// @brief When 0, umbilical UART output (i.e., logs) is discarded instead of written to stdout.
+uint8_t HOST_umbilical_uart_to_stdout_enabled = 1;
+
+static pthread_t HOST_uptime_thread;
+static uint8_t HOST_uptime_thread_started = 0;
+
+uint64_t HOST_get_monotonic_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
+/// @brief Stand-in for the TIM6 1 ms interrupt, which increments `TIME_uptime_ms_from_tim6`.
+static void *HOST_uptime_thread_func(void *arg) {
+    const uint64_t start_us = HOST_get_monotonic_time_us();
+    while (1) {
+        TIME_uptime_ms_from_tim6 = (uint32_t)((HOST_get_monotonic_time_us() - start_us) / 1000);
+        usleep(500);
+    }
+    return NULL;
+}
+
+/// @brief Start the background stand-ins for the hardware timers. Call once at the start of `main()`.
+/// @return 0 on success, 1 if the uptime thread could not be started.
+uint8_t HOST_hal_init(void) {
+    if (HOST_uptime_thread_started) {
+        return 0;
+    }
+    if (pthread_create(&HOST_uptime_thread, NULL, HOST_uptime_thread_func, NULL) != 0) {
+        return 1;
+    }
+    HOST_uptime_thread_started = 1;
+    return 0;
+}
+
+uint32_t HAL_GetTick(void) {
+    return TIME_uptime_ms_from_tim6;
+}
+
+void HAL_Delay(uint32_t delay_ms) {
+    usleep(delay_ms * 1000);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    if (PinState == GPIO_PIN_SET) {
+        HOST_gpio_output_state[GPIOx->host_port_index] |= GPIO_Pin;
+    }
+    else {
+        HOST_gpio_output_state[GPIOx->host_port_index] &= ~GPIO_Pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    return (HOST_gpio_output_state[GPIOx->host_port_index] & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(
+    UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout
+) {
+    HOST_uart_counters.transfer_count++;
+    HOST_uart_counters.byte_count += Size;
+
+    if ((huart == &hlpuart1) && HOST_umbilical_uart_to_stdout_enabled) {
+        fwrite(pData, 1, Size, stdout);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(
+    I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout
+) {
+    HOST_i2c_counters.transfer_count++;
+    HOST_i2c_counters.byte_count += Size;
+    if (HOST_i2c_transfer_us_per_byte > 0) {
+        usleep(Size * HOST_i2c_transfer_us_per_byte);
+    }
+    return HAL_OK;
+}
+
+typedef struct {
+    I2C_HandleTypeDef *hi2c;
+    uint32_t duration_us;
+    uint8_t is_error;
+    volatile uint8_t is_aborted;
+} HOST_i2c_dma_transfer_t;
+
+static HOST_i2c_dma_transfer_t HOST_i2c_dma_transfer;
+static volatile HAL_I2C_StateTypeDef HOST_i2c_state = HAL_I2C_STATE_READY;
+
+/// @brief Number of the next DMA transfers which end with an error (e.g., NACKed by the AX100).
+uint32_t HOST_i2c_dma_error_transfer_count = 0;
+
+/// @brief Time from `HAL_I2C_Master_Abort_IT` until its abort-complete interrupt.
+uint32_t HOST_i2c_abort_duration_us = 1000;
+
+/// @brief Number of aborts which have completed.
+volatile uint32_t HOST_i2c_abort_count = 0;
+
+/// @brief Stand-in for the DMA transfer and its transfer-complete (or error) interrupt.
+static void *HOST_i2c_dma_thread_func(void *arg) {
+    HOST_i2c_dma_transfer_t *transfer = (HOST_i2c_dma_transfer_t *)arg;
+    usleep(transfer->duration_us);
+    if (transfer->is_aborted) {
+        return NULL;
+    }
+    HOST_i2c_state = HAL_I2C_STATE_READY;
+    if (transfer->is_error) {
+        HAL_I2C_ErrorCallback(transfer->hi2c);
+    }
+    else {
+        HAL_I2C_MasterTxCpltCallback(transfer->hi2c);
+    }
+    return NULL;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(
+    I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size
+) {
+    if (HOST_i2c_state != HAL_I2C_STATE_READY) {
+        return HAL_BUSY;
+    }
+    HOST_i2c_counters.transfer_count++;
+    HOST_i2c_counters.byte_count += Size;
+    const uint8_t is_error = (HOST_i2c_dma_error_transfer_count > 0);
+    if (is_error) {
+        HOST_i2c_dma_error_transfer_count--;
+    }
+    if (HOST_i2c_transfer_us_per_byte == 0) {
+        if (is_error) {
+            HAL_I2C_ErrorCallback(hi2c);
+        }
+        else {
+            HAL_I2C_MasterTxCpltCallback(hi2c);
+        }
+        return HAL_OK;
+    }
+
+    // One transfer at a time (as the firmware only starts one on an idle bus).
+    HOST_i2c_dma_transfer.hi2c = hi2c;
+    HOST_i2c_dma_transfer.duration_us = Size * HOST_i2c_transfer_us_per_byte;
+    HOST_i2c_dma_transfer.is_error = is_error;
+    HOST_i2c_dma_transfer.is_aborted = 0;
+    HOST_i2c_state = HAL_I2C_STATE_BUSY_TX;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, HOST_i2c_dma_thread_func, &HOST_i2c_dma_transfer) != 0) {
+        HOST_i2c_state = HAL_I2C_STATE_READY;
+        return HAL_ERROR;
+    }
+    pthread_detach(thread);
+    return HAL_OK;
+}
+
+/// @brief Stand-in for the abort's completion interrupt.
+static void *HOST_i2c_abort_thread_func(void *arg) {
+    I2C_HandleTypeDef *hi2c = (I2C_HandleTypeDef *)arg;
+    usleep(HOST_i2c_abort_duration_us);
+    HOST_i2c_state = HAL_I2C_STATE_READY;
+    HOST_i2c_abort_count++;
+    HAL_I2C_AbortCpltCallback(hi2c);
+    return NULL;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Abort_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress) {
+    if (HOST_i2c_state != HAL_I2C_STATE_BUSY_TX) {
+        return HAL_ERROR; // Like the HAL: nothing to abort.
+    }
+    HOST_i2c_dma_transfer.is_aborted = 1;
+    HOST_i2c_state = HAL_I2C_STATE_ABORT;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, HOST_i2c_abort_thread_func, hi2c) != 0) {
+        HOST_i2c_state = HAL_I2C_STATE_READY;
+        return HAL_ERROR;
+    }
+    pthread_detach(thread);
+    return HAL_OK;
+}
+
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c) {
+    return HOST_i2c_state;
+}
+
+osStatus_t osDelay(uint32_t ticks) {
+    usleep(ticks * 1000);
+    return osOK;
+}
+
+osStatus_t osThreadYield(void) {
+    sched_yield();
+    return osOK;
+}
+
+uint32_t osKernelGetTickCount(void) {
+    return TIME_uptime_ms_from_tim6;
+}
+
+void Error_Handler(void) {
+    fprintf(stderr, "Error_Handler() called\n");
+    abort();
+}
@@ -0,0 +1,234 @@
+// host_main.c
+// Entry point of the host simulation build. Sets up the emulated hardware, mounts LittleFS on the
+// NAND emulator, then runs the benchmarks named on the command line (or all of them).
+//
+// Usage: cts1_host_sim [-v] [benchmark_name ...]
+//   -v: Print firmware log messages (umbilical UART output) to stdout.
+//   Environment variable `CTS1_HOST_NAND_IMAGE`: Path to a NAND image file, to persist the
+//   filesystem between runs. By default, the NAND contents are discarded at exit.
+
+#include "host_sim/host_benchmarks.h"
+#include "host_sim/host_hal_stubs.h"
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/littlefs_helper.h"
+#include "littlefs/littlefs_driver.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const HOST_benchmark_t HOST_benchmarks[] = {
+    {
+        .bench_name = "nand_emulator_self_test",
+        .bench_func = HOST_BENCH_nand_emulator_self_test,
+        .description = "Check NAND semantics of the emulator (erase, program-only-clears-bits, bad blocks)",
+    },
+    {
+        .bench_name = "lfs_write_read",
+        .bench_func = HOST_BENCH_lfs_write_read,
+        .description = "Write and read back a 1 MiB file through LittleFS",
+    },
+    {
+        .bench_name = "lfs_chip_layouts",
+        .bench_func = HOST_BENCH_lfs_chip_layouts,
+        .description = "Compare the concatenate and stripe block-to-chip layouts",
+    },
+    {
+        .bench_name = "lfs_grow_from_single_chip",
+        .bench_func = HOST_BENCH_lfs_grow_from_single_chip,
+        .description = "Mount a single-chip filesystem, grow it to all chips, and fill past chip 0",
+    },
+    {
+        .bench_name = "lfs_bad_blocks",
+        .bench_func = HOST_BENCH_lfs_bad_blocks,
+        .description = "Factory-marked and runtime bad blocks are skipped/relocated without data loss",
+    },
+    {
+        .bench_name = "lfs_page_cache",
+        .bench_func = HOST_BENCH_lfs_page_cache,
+        .description = "Mount, dir listing, stat and small file reads with the block device page cache off/on",
+    },
+    {
+        .bench_name = "flash_cache_read",
+        .bench_func = HOST_BENCH_flash_cache_read,
+        .description = "Sequential page reads: one page read at a time vs. NAND cache read mode",
+    },
+    {
+        .bench_name = "flash_busy_wait",
+        .bench_func = HOST_BENCH_flash_busy_wait,
+        .description = "Program/erase waits: back-to-back status polls vs. backoff; busy time histograms",
+    },
+    {
+        .bench_name = "agenda_tick",
+        .bench_func = HOST_BENCH_agenda_tick,
+        .description = "Executor tick cost with 0, 375 and 750 queued telecommands; full agenda rejects",
+    },
+    {
+        .bench_name = "agenda_order",
+        .bench_func = HOST_BENCH_agenda_order,
+        .description = "Due telecommands come out by tsexec, then by arrival, including after deletes",
+    },
+    {
+        .bench_name = "tssent_dedup",
+        .bench_func = HOST_BENCH_tssent_dedup,
+        .description = "Replay a 750-command agenda file; tssent hash set vs. linear scan",
+    },
+    {
+        .bench_name = "agenda_arena",
+        .bench_func = HOST_BENCH_agenda_arena,
+        .description = "Agenda string arena: fill, delete, compact, and check strings; SRAM used",
+    },
+    {
+        .bench_name = "agenda_file_loader",
+        .bench_func = HOST_BENCH_agenda_file_loader,
+        .description = "Load a 3-day agenda file in 45 s windows: index and cursor vs. full scan",
+    },
+    {
+        .bench_name = "tcmd_name_lookup",
+        .bench_func = HOST_BENCH_tcmd_name_lookup,
+        .description = "Telecommand name lookup: sorted name index vs. linear scan of the table",
+    },
+    {
+        .bench_name = "tcmd_args_tokenizer",
+        .bench_func = HOST_BENCH_tcmd_args_tokenizer,
+        .description = "Extract all args of 2-28 arg commands: one tokenize pass vs. rescan per arg",
+    },
+    {
+        .bench_name = "uart_dma_ring_firehose",
+        .bench_func = HOST_BENCH_uart_dma_ring_firehose,
+        .description = "UART RX under firehose load: IRQ count and CPU load, per-byte IRQ vs. circular DMA",
+    },
+    {
+        .bench_name = "log_queue",
+        .bench_func = HOST_BENCH_log_queue,
+        .description = "LOG_message caller-side latency: format and write out directly vs. queue for the logger task",
+    },
+    {
+        .bench_name = "log_binary",
+        .bench_func = HOST_BENCH_log_binary,
+        .description = "Binary log records vs. text lines: bytes, CPU and UHF airtime per message; decode round trip",
+    },
+    {
+        .bench_name = "bulk_downlink_compressed",
+        .bench_func = HOST_BENCH_bulk_downlink_compressed,
+        .description = "Bulk downlink with on-the-fly heatshrink: packets, airtime, CPU and flash writes vs. raw",
+    },
+    {
+        .bench_name = "bulk_downlink_selective_repeat",
+        .bench_func = HOST_BENCH_bulk_downlink_selective_repeat,
+        .description = "Bulk downlink over a lossy link: goodput with NACKed resends vs. downlinking the whole file again",
+    },
+    {
+        .bench_name = "bulk_downlink_prefetch",
+        .bench_func = HOST_BENCH_bulk_downlink_prefetch,
+        .description = "Bulk downlink file reads: per-packet vs. page-sized read-ahead; flash on the packet path, packet period",
+    },
+    {
+        .bench_name = "ax100_tx_pacing",
+        .bench_func = HOST_BENCH_ax100_tx_pacing,
+        .description = "AX100 downlink pacing vs. fixed delay, on a simulated radio slower/faster than configured",
+    },
+    {
+        .bench_name = "ax100_tx_dma",
+        .bench_func = HOST_BENCH_ax100_tx_dma,
+        .description = "AX100 packets built in place and sent with blocking I2C vs. DMA; time the sender is blocked",
+    },
+    {
+        .bench_name = "lfs_dir_listing",
+        .bench_func = HOST_BENCH_lfs_dir_listing,
+        .description = "Page through a 200-file directory: re-read to each offset vs. cursor vs. in-RAM index",
+    },
+    {
+        .bench_name = "tcmd_resp_store",
+        .bench_func = HOST_BENCH_tcmd_resp_store,
+        .description = "Flash pages programmed per 100 @resp_fname responses: open/close each vs. batched open files",
+    },
+    {
+        .bench_name = "sha256",
+        .bench_func = HOST_BENCH_sha256,
+        .description = "SHA256 cycles/byte: byte-wise vs. word-wise unrolled; per-file digest cache in LFS attributes",
+    },
+    {
+        .bench_name = "mpi_science_ring",
+        .bench_func = HOST_BENCH_mpi_science_ring,
+        .description = "MPI science data at 230400 baud: ISR copy into ping-pong buffers vs. DMA into a woken ring",
+    },
+    {
+        .bench_name = "mpi_frame_index",
+        .bench_func = HOST_BENCH_mpi_frame_index,
+        .description = "MPI science frame range lookup and file validation: sync word search vs. frame index",
+    },
+};
+
+static const uint16_t HOST_benchmarks_count = sizeof(HOST_benchmarks) / sizeof(HOST_benchmark_t);
+
+static void HOST_print_usage(const char program_name[]) {
+    printf("Usage: %s [-v] [benchmark_name ...]\nBenchmarks:\n", program_name);
+    for (uint16_t i = 0; i < HOST_benchmarks_count; i++) {
+        printf("  %-32s %s\n", HOST_benchmarks[i].bench_name, HOST_benchmarks[i].description);
+    }
+}
+
+static uint8_t HOST_run_benchmark(const HOST_benchmark_t *benchmark) {
+    printf("=== %s ===\n", benchmark->bench_name);
+    const uint8_t result = benchmark->bench_func();
+    if (result != 0) {
+        printf("=== %s FAILED (%u) ===\n", benchmark->bench_name, result);
+    }
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    HOST_umbilical_uart_to_stdout_enabled = 0;
+    int first_name_arg = 1;
+    if ((argc > 1) && (strcmp(argv[1], "-v") == 0)) {
+        HOST_umbilical_uart_to_stdout_enabled = 1;
+        first_name_arg = 2;
+    }
+    if ((argc > first_name_arg) && (strcmp(argv[first_name_arg], "-h") == 0)) {
+        HOST_print_usage(argv[0]);
+        return 0;
+    }
+
+    if (HOST_hal_init() != 0) {
+        fprintf(stderr, "HOST_hal_init failed\n");
+        return 1;
+    }
+    if (HOST_NAND_init(getenv("CTS1_HOST_NAND_IMAGE")) != 0) {
+        fprintf(stderr, "HOST_NAND_init failed\n");
+        return 1;
+    }
+
+    // A fresh (blank) NAND must be formatted before `LFS_init()` can mount it.
+    LFS_block_device_init();
+    if (LFS_mount() != 0) {
+        LFS_format();
+    }
+    LFS_init();
+
+    uint16_t failure_count = 0;
+    if (argc <= first_name_arg) {
+        for (uint16_t i = 0; i < HOST_benchmarks_count; i++) {
+            failure_count += (HOST_run_benchmark(&HOST_benchmarks[i]) != 0);
+        }
+    }
+    for (int arg_idx = first_name_arg; arg_idx < argc; arg_idx++) {
+        uint8_t found = 0;
+        for (uint16_t i = 0; i < HOST_benchmarks_count; i++) {
+            if (strcmp(argv[arg_idx], HOST_benchmarks[i].bench_name) == 0) {
+                failure_count += (HOST_run_benchmark(&HOST_benchmarks[i]) != 0);
+                found = 1;
+                break;
+            }
+        }
+        if (!found) {
+            printf("Unknown benchmark: %s\n", argv[arg_idx]);
+            HOST_print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    LFS_ensure_unmounted();
+    HOST_NAND_deinit();
+    return (failure_count == 0) ? 0 : 1;
+}
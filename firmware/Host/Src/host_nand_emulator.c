@@ -0,0 +1,461 @@
+// host_nand_emulator.c
+// RAM-backed (or mmap'd file-backed) model of the 8 SPI NAND chips, implementing the
+// `flash_driver.h` API in place of `flash_driver.c`/`flash_internal_spi.c` on the host build.
+//
+// Each chip is 1024 blocks of 64 pages of 2048 bytes. The bytes are stored inverted, so that
+// zero-filled memory (fresh anonymous mapping, or a sparse image file) reads back as erased (0xFF).
+
+#include "host_sim/host_nand_emulator.h"
+#include "littlefs/flash_driver.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define HOST_NAND_TOTAL_SIZE_BYTES ((uint64_t)FLASH_CHIP_SIZE_BYTES * FLASH_NUMBER_OF_FLASH_DEVICES)
+#define HOST_NAND_PAGES_PER_CHIP (HOST_NAND_BLOCKS_PER_CHIP * FLASH_CHIP_PAGES_PER_BLOCK)
+
+HOST_NAND_timing_model_t HOST_NAND_timing_model = {
+    .page_read_to_cache_us = 25,
+    .cache_read_busy_us = 3,
+    .page_program_us = 200,
+    .block_erase_us = 2000,
+    .spi_clock_hz = 8000000,
+};
+
+static uint8_t *HOST_NAND_inverted_storage = NULL;
+static int HOST_NAND_image_fd = -1;
+
+static HOST_NAND_chip_stats_t HOST_NAND_chip_stats[FLASH_NUMBER_OF_FLASH_DEVICES];
+
+// Cache read mode state, as tracked by `flash_driver.c`. While a chip is in cache read mode, the
+// next page loads in the background during the SPI transfer of the current one, so only the part
+// of tRD which is longer than that transfer is added to `modelled_busy_us`.
+static uint8_t HOST_NAND_cache_read_active[FLASH_NUMBER_OF_FLASH_DEVICES];
+static uint32_t HOST_NAND_cache_read_loading_row[FLASH_NUMBER_OF_FLASH_DEVICES];
+static uint32_t HOST_NAND_cache_read_overlap_us[FLASH_NUMBER_OF_FLASH_DEVICES];
+static uint32_t HOST_NAND_last_read_row[FLASH_NUMBER_OF_FLASH_DEVICES];
+
+// Result of the last `FLASH_start_read_page()`, returned by `FLASH_wait_for_read_page()`.
+static FLASH_error_enum_t HOST_NAND_pending_read_result = FLASH_ERR_OK;
+static uint8_t HOST_NAND_bad_block_bitmap[FLASH_NUMBER_OF_FLASH_DEVICES][HOST_NAND_BLOCKS_PER_CHIP / 8];
+
+// Blocks which fail erase/program, but have no factory bad block marker (they went bad in use).
+static uint8_t HOST_NAND_worn_block_bitmap[FLASH_NUMBER_OF_FLASH_DEVICES][HOST_NAND_BLOCKS_PER_CHIP / 8];
+
+// Blocks whose bad block marker byte (the first spare byte of the first page) has been programmed.
+// The rest of the spare area isn't stored.
+static uint8_t HOST_NAND_marker_programmed_bitmap[FLASH_NUMBER_OF_FLASH_DEVICES][HOST_NAND_BLOCKS_PER_CHIP / 8];
+
+// From `flash_driver.c`. Filled in as the flight driver would, polling on the backoff schedule.
+FLASH_busy_time_stats_t FLASH_program_busy_time_stats[FLASH_NUMBER_OF_FLASH_DEVICES];
+FLASH_busy_time_stats_t FLASH_erase_busy_time_stats[FLASH_NUMBER_OF_FLASH_DEVICES];
+
+/// @brief Map the storage for all chips.
+/// @param image_file_path Path to a NAND image file to map (created sparse if missing), or NULL/empty
+///     to use anonymous memory which is discarded at exit.
+/// @return 0 on success, 1 if the image file could not be opened, 2 if mapping failed.
+uint8_t HOST_NAND_init(const char image_file_path[]) {
+    if (HOST_NAND_inverted_storage != NULL) {
+        return 0;
+    }
+
+    int mmap_flags = MAP_SHARED;
+    if ((image_file_path != NULL) && (image_file_path[0] != '\0')) {
+        HOST_NAND_image_fd = open(image_file_path, O_RDWR | O_CREAT, 0644);
+        if (HOST_NAND_image_fd < 0) {
+            perror("HOST_NAND_init: open");
+            return 1;
+        }
+        if (ftruncate(HOST_NAND_image_fd, (off_t)HOST_NAND_TOTAL_SIZE_BYTES) != 0) {
+            perror("HOST_NAND_init: ftruncate");
+            close(HOST_NAND_image_fd);
+            HOST_NAND_image_fd = -1;
+            return 1;
+        }
+    }
+    else {
+        // Pages are only backed by RAM once touched, so mapping the full 1 GiB is cheap.
+        mmap_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+    }
+
+    void *mapping = mmap(
+        NULL, HOST_NAND_TOTAL_SIZE_BYTES, PROT_READ | PROT_WRITE, mmap_flags, HOST_NAND_image_fd, 0
+    );
+    if (mapping == MAP_FAILED) {
+        perror("HOST_NAND_init: mmap");
+        if (HOST_NAND_image_fd >= 0) {
+            close(HOST_NAND_image_fd);
+            HOST_NAND_image_fd = -1;
+        }
+        return 2;
+    }
+
+    HOST_NAND_inverted_storage = (uint8_t *)mapping;
+    memset(HOST_NAND_bad_block_bitmap, 0, sizeof(HOST_NAND_bad_block_bitmap));
+    HOST_NAND_reset_stats();
+    return 0;
+}
+
+void HOST_NAND_deinit(void) {
+    if (HOST_NAND_inverted_storage != NULL) {
+        munmap(HOST_NAND_inverted_storage, HOST_NAND_TOTAL_SIZE_BYTES);
+        HOST_NAND_inverted_storage = NULL;
+    }
+    if (HOST_NAND_image_fd >= 0) {
+        close(HOST_NAND_image_fd);
+        HOST_NAND_image_fd = -1;
+    }
+}
+
+void HOST_NAND_reset_stats(void) {
+    memset(HOST_NAND_chip_stats, 0, sizeof(HOST_NAND_chip_stats));
+}
+
+const HOST_NAND_chip_stats_t *HOST_NAND_get_chip_stats(uint8_t chip_number) {
+    if (chip_number >= FLASH_NUMBER_OF_FLASH_DEVICES) {
+        return NULL;
+    }
+    return &HOST_NAND_chip_stats[chip_number];
+}
+
+/// @brief Sum the per-chip counters over all chips.
+void HOST_NAND_get_total_stats(HOST_NAND_chip_stats_t *total_stats_out) {
+    memset(total_stats_out, 0, sizeof(HOST_NAND_chip_stats_t));
+    for (uint8_t chip = 0; chip < FLASH_NUMBER_OF_FLASH_DEVICES; chip++) {
+        const HOST_NAND_chip_stats_t *s = &HOST_NAND_chip_stats[chip];
+        total_stats_out->page_read_count += s->page_read_count;
+        total_stats_out->cache_read_page_count += s->cache_read_page_count;
+        total_stats_out->page_program_count += s->page_program_count;
+        total_stats_out->block_erase_count += s->block_erase_count;
+        total_stats_out->bytes_read += s->bytes_read;
+        total_stats_out->bytes_programmed += s->bytes_programmed;
+        total_stats_out->program_without_erase_count += s->program_without_erase_count;
+        total_stats_out->modelled_busy_us += s->modelled_busy_us;
+    }
+}
+
+/// @brief Mark a block as bad, or good again. Bad blocks fail erase/program with a status register
+///     error, and carry the factory bad block marker in their spare area.
+/// @return 0 on success, 1 if the chip/block is out of range.
+uint8_t HOST_NAND_set_block_bad(uint8_t chip_number, uint32_t block_num, uint8_t is_bad) {
+    if ((chip_number >= FLASH_NUMBER_OF_FLASH_DEVICES) || (block_num >= HOST_NAND_BLOCKS_PER_CHIP)) {
+        return 1;
+    }
+    if (is_bad) {
+        HOST_NAND_bad_block_bitmap[chip_number][block_num / 8] |= (1 << (block_num % 8));
+    }
+    else {
+        HOST_NAND_bad_block_bitmap[chip_number][block_num / 8] &= ~(1 << (block_num % 8));
+    }
+    return 0;
+}
+
+/// @brief Mark a block as worn out, or good again. Worn blocks fail erase/program with a status
+///     register error like bad blocks, but have no factory bad block marker (it's up to the driver
+///     to program one).
+/// @return 0 on success, 1 if the chip/block is out of range.
+uint8_t HOST_NAND_set_block_worn(uint8_t chip_number, uint32_t block_num, uint8_t is_worn) {
+    if ((chip_number >= FLASH_NUMBER_OF_FLASH_DEVICES) || (block_num >= HOST_NAND_BLOCKS_PER_CHIP)) {
+        return 1;
+    }
+    if (is_worn) {
+        HOST_NAND_worn_block_bitmap[chip_number][block_num / 8] |= (1 << (block_num % 8));
+    }
+    else {
+        HOST_NAND_worn_block_bitmap[chip_number][block_num / 8] &= ~(1 << (block_num % 8));
+    }
+    return 0;
+}
+
+static uint8_t HOST_NAND_bitmap_get(const uint8_t bitmap[], uint32_t block_num) {
+    return (bitmap[block_num / 8] >> (block_num % 8)) & 1;
+}
+
+static uint8_t HOST_NAND_is_block_bad(uint8_t chip_number, uint32_t block_num) {
+    return HOST_NAND_bitmap_get(HOST_NAND_bad_block_bitmap[chip_number], block_num)
+        || HOST_NAND_bitmap_get(HOST_NAND_worn_block_bitmap[chip_number], block_num);
+}
+
+static uint8_t HOST_NAND_has_bad_block_marker(uint8_t chip_number, uint32_t block_num) {
+    return HOST_NAND_bitmap_get(HOST_NAND_bad_block_bitmap[chip_number], block_num)
+        || HOST_NAND_bitmap_get(HOST_NAND_marker_programmed_bitmap[chip_number], block_num);
+}
+
+static uint64_t HOST_NAND_spi_transfer_us(uint32_t byte_count) {
+    return ((uint64_t)byte_count * 8 * 1000000) / HOST_NAND_timing_model.spi_clock_hz;
+}
+
+/// @brief Record an operation which keeps the chip busy for `busy_us`, as
+///     `FLASH_wait_until_ready_with_backoff` would measure it: at the first status poll which finds
+///     the chip ready.
+static void HOST_NAND_record_busy_time(
+    FLASH_busy_time_stats_t *stats, const FLASH_busy_wait_timing_t *timing, uint32_t busy_us
+) {
+    uint32_t elapsed_us = 0;
+    uint32_t status_poll_count = 0;
+    while (elapsed_us < busy_us) {
+        elapsed_us += FLASH_busy_wait_next_poll_delay_us(timing, elapsed_us);
+        status_poll_count++;
+    }
+    FLASH_busy_time_stats_record(stats, elapsed_us, status_poll_count);
+}
+
+static uint8_t *HOST_NAND_page_ptr(uint8_t chip_number, uint32_t row_address) {
+    return &HOST_NAND_inverted_storage[
+        ((uint64_t)chip_number * FLASH_CHIP_SIZE_BYTES)
+        + ((uint64_t)row_address * FLASH_CHIP_PAGE_SIZE_BYTES)
+    ];
+}
+
+static FLASH_error_enum_t HOST_NAND_check_address(uint8_t chip_number, uint32_t row_address) {
+    if (HOST_NAND_inverted_storage == NULL) {
+        return FLASH_ERR_UNKNOWN;
+    }
+    if (chip_number >= FLASH_NUMBER_OF_FLASH_DEVICES) {
+        // On hardware, no chip select goes low, so the command is silently lost.
+        return FLASH_ERR_SPI_TRANSMIT_FAILED;
+    }
+    if (row_address >= HOST_NAND_PAGES_PER_CHIP) {
+        return FLASH_ERR_UNKNOWN;
+    }
+    return FLASH_ERR_OK;
+}
+
+/// @brief Time still to wait for the page loading in cache read mode, after the overlapping transfer.
+static uint32_t HOST_NAND_cache_read_remaining_load_us(uint8_t chip_number) {
+    const uint32_t overlap_us = HOST_NAND_cache_read_overlap_us[chip_number];
+    const uint32_t load_us = HOST_NAND_timing_model.page_read_to_cache_us;
+    return (load_us > overlap_us) ? (load_us - overlap_us) : 0;
+}
+
+/// @brief Model `FLASH_end_cache_read()`: wait for the background load, then Page Read Cache Last.
+static void HOST_NAND_end_cache_read(uint8_t chip_number) {
+    if ((chip_number >= FLASH_NUMBER_OF_FLASH_DEVICES) || !HOST_NAND_cache_read_active[chip_number]) {
+        return;
+    }
+    HOST_NAND_cache_read_active[chip_number] = 0;
+    HOST_NAND_chip_stats[chip_number].modelled_busy_us += (
+        HOST_NAND_cache_read_remaining_load_us(chip_number) + HOST_NAND_timing_model.cache_read_busy_us
+    );
+}
+
+/// @brief Model `FLASH_cache_read_advance()`: move the loaded page to the cache, start the next.
+static void HOST_NAND_cache_read_advance(uint8_t chip_number, uint32_t next_row_address, uint8_t is_loading) {
+    HOST_NAND_chip_stats_t *stats = &HOST_NAND_chip_stats[chip_number];
+    if (is_loading) {
+        stats->modelled_busy_us += HOST_NAND_cache_read_remaining_load_us(chip_number);
+    }
+    stats->modelled_busy_us += HOST_NAND_timing_model.cache_read_busy_us;
+    stats->cache_read_page_count++;
+
+    HOST_NAND_cache_read_active[chip_number] = (next_row_address < HOST_NAND_PAGES_PER_CHIP);
+    HOST_NAND_cache_read_loading_row[chip_number] = next_row_address;
+}
+
+// ----------------------------- flash_driver.h API -----------------------------
+
+FLASH_error_enum_t FLASH_init(uint8_t chip_number) {
+    if (chip_number >= FLASH_NUMBER_OF_FLASH_DEVICES) {
+        return FLASH_ERR_SPI_TRANSMIT_FAILED;
+    }
+    // Like the driver, end cache read mode in case the chip was left in it.
+    HOST_NAND_cache_read_active[chip_number] = 1;
+    HOST_NAND_end_cache_read(chip_number);
+    if (HOST_NAND_inverted_storage == NULL) {
+        return (HOST_NAND_init(NULL) == 0) ? FLASH_ERR_OK : FLASH_ERR_UNKNOWN;
+    }
+    return FLASH_ERR_OK;
+}
+
+FLASH_error_enum_t FLASH_read_status_register(uint8_t chip_number, uint8_t *response) {
+    if (chip_number >= FLASH_NUMBER_OF_FLASH_DEVICES) {
+        return FLASH_ERR_SPI_TRANSMIT_FAILED;
+    }
+    // Operations complete instantly on the host, so the chip is never busy.
+    *response = 0;
+    return FLASH_ERR_OK;
+}
+
+FLASH_error_enum_t FLASH_erase_block(uint8_t chip_number, FLASH_Physical_Address_t address) {
+    const FLASH_error_enum_t check_result = HOST_NAND_check_address(chip_number, address.row_address);
+    if (check_result != FLASH_ERR_OK) {
+        return check_result;
+    }
+
+    HOST_NAND_end_cache_read(chip_number);
+
+    const uint32_t block_num = address.row_address / FLASH_CHIP_PAGES_PER_BLOCK;
+    HOST_NAND_chip_stats_t *stats = &HOST_NAND_chip_stats[chip_number];
+    stats->block_erase_count++;
+    stats->modelled_busy_us += HOST_NAND_timing_model.block_erase_us;
+    HOST_NAND_record_busy_time(
+        &FLASH_erase_busy_time_stats[chip_number], &FLASH_BLOCK_ERASE_TIMING, HOST_NAND_timing_model.block_erase_us
+    );
+
+    if (HOST_NAND_is_block_bad(chip_number, block_num)) {
+        return FLASH_ERR_STATUS_REG_ERROR;
+    }
+
+    memset(
+        HOST_NAND_page_ptr(chip_number, block_num * FLASH_CHIP_PAGES_PER_BLOCK),
+        0,
+        FLASH_CHIP_BLOCK_SIZE_BYTES
+    );
+    HOST_NAND_marker_programmed_bitmap[chip_number][block_num / 8] &= ~(1 << (block_num % 8));
+    return FLASH_ERR_OK;
+}
+
+FLASH_error_enum_t FLASH_program_page(
+    uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *data, uint32_t data_len
+) {
+    const FLASH_error_enum_t check_result = HOST_NAND_check_address(chip_number, address.row_address);
+    if (check_result != FLASH_ERR_OK) {
+        return check_result;
+    }
+    if ((address.col_address + data_len) > (FLASH_CHIP_PAGE_SIZE_BYTES + HOST_NAND_SPARE_AREA_SIZE_BYTES)) {
+        return FLASH_ERR_UNKNOWN;
+    }
+
+    HOST_NAND_end_cache_read(chip_number);
+
+    HOST_NAND_chip_stats_t *stats = &HOST_NAND_chip_stats[chip_number];
+    stats->page_program_count++;
+    stats->bytes_programmed += data_len;
+    stats->modelled_busy_us += HOST_NAND_spi_transfer_us(data_len) + HOST_NAND_timing_model.page_program_us;
+    HOST_NAND_record_busy_time(
+        &FLASH_program_busy_time_stats[chip_number], &FLASH_PAGE_PROGRAM_TIMING, HOST_NAND_timing_model.page_program_us
+    );
+
+    // Only the bad block marker is stored from the spare area. It's written even to a bad block
+    // (which still reports the failure), as marking a block bad is what the datasheet asks for.
+    const uint32_t block_num = address.row_address / FLASH_CHIP_PAGES_PER_BLOCK;
+    uint32_t data_area_len = 0;
+    if (address.col_address < FLASH_CHIP_PAGE_SIZE_BYTES) {
+        data_area_len = FLASH_CHIP_PAGE_SIZE_BYTES - address.col_address;
+        if (data_len < data_area_len) {
+            data_area_len = data_len;
+        }
+    }
+    const uint32_t marker_index = FLASH_CHIP_PAGE_SIZE_BYTES - address.col_address;
+    if (
+        ((address.row_address % FLASH_CHIP_PAGES_PER_BLOCK) == 0)
+        && (address.col_address <= FLASH_CHIP_PAGE_SIZE_BYTES)
+        && (marker_index < data_len) && (data[marker_index] != 0xFF)
+    ) {
+        HOST_NAND_marker_programmed_bitmap[chip_number][block_num / 8] |= (1 << (block_num % 8));
+    }
+
+    if (HOST_NAND_is_block_bad(chip_number, block_num)) {
+        return FLASH_ERR_STATUS_REG_ERROR;
+    }
+
+    // NAND programming can only clear bits: new = old & data.
+    // Stored inverted, that's: stored_new = stored_old | ~data.
+    uint8_t *page = HOST_NAND_page_ptr(chip_number, address.row_address) + address.col_address;
+    uint8_t saw_program_without_erase = 0;
+    for (uint32_t i = 0; i < data_area_len; i++) {
+        const uint8_t old_value = (uint8_t)~page[i];
+        if ((old_value & data[i]) != data[i]) {
+            saw_program_without_erase = 1;
+        }
+        page[i] |= (uint8_t)~data[i];
+    }
+    if (saw_program_without_erase) {
+        stats->program_without_erase_count++;
+    }
+    return FLASH_ERR_OK;
+}
+
+FLASH_error_enum_t FLASH_read_page(
+    uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *rx_buffer, uint32_t rx_buffer_size
+) {
+    const FLASH_error_enum_t result = FLASH_start_read_page(chip_number, address, rx_buffer, rx_buffer_size);
+    if (result != FLASH_ERR_OK) {
+        return result;
+    }
+    return FLASH_wait_for_read_page();
+}
+
+/// @note Reads complete immediately on the host; the cache read mode decisions of
+///     `flash_driver.c` are replayed only for the timing model.
+FLASH_error_enum_t FLASH_start_read_page(
+    uint8_t chip_number, FLASH_Physical_Address_t address, uint8_t *rx_buffer, uint32_t rx_buffer_size
+) {
+    HOST_NAND_pending_read_result = FLASH_ERR_OK;
+    const FLASH_error_enum_t check_result = HOST_NAND_check_address(chip_number, address.row_address);
+    if (check_result != FLASH_ERR_OK) {
+        return check_result;
+    }
+    if ((address.col_address + rx_buffer_size) > (FLASH_CHIP_PAGE_SIZE_BYTES + HOST_NAND_SPARE_AREA_SIZE_BYTES)) {
+        HOST_NAND_pending_read_result = FLASH_ERR_SPI_RECEIVE_FAILED;
+        return FLASH_ERR_OK;
+    }
+
+    HOST_NAND_chip_stats_t *stats = &HOST_NAND_chip_stats[chip_number];
+    stats->page_read_count++;
+    stats->bytes_read += rx_buffer_size;
+
+    const uint32_t row_address = address.row_address;
+    if (
+        FLASH_cache_read_enabled && HOST_NAND_cache_read_active[chip_number]
+        && (HOST_NAND_cache_read_loading_row[chip_number] == row_address)
+    ) {
+        HOST_NAND_cache_read_advance(chip_number, row_address + 1, 1);
+    }
+    else {
+        HOST_NAND_end_cache_read(chip_number);
+        stats->modelled_busy_us += HOST_NAND_timing_model.page_read_to_cache_us;
+        if (FLASH_cache_read_enabled && (row_address == (HOST_NAND_last_read_row[chip_number] + 1))) {
+            HOST_NAND_cache_read_advance(chip_number, row_address + 1, 0);
+        }
+    }
+    HOST_NAND_last_read_row[chip_number] = row_address;
+
+    const uint32_t transfer_us = HOST_NAND_spi_transfer_us(rx_buffer_size);
+    stats->modelled_busy_us += transfer_us;
+    HOST_NAND_cache_read_overlap_us[chip_number] = transfer_us;
+
+    // Bad blocks carry the factory bad block marker (0x00) in the first spare byte of their first page.
+    const uint8_t has_bad_block_marker = (
+        ((address.row_address % FLASH_CHIP_PAGES_PER_BLOCK) == 0)
+        && HOST_NAND_has_bad_block_marker(chip_number, address.row_address / FLASH_CHIP_PAGES_PER_BLOCK)
+    );
+
+    const uint8_t *page = HOST_NAND_page_ptr(chip_number, address.row_address);
+    for (uint32_t i = 0; i < rx_buffer_size; i++) {
+        const uint32_t col = address.col_address + i;
+        if (col < FLASH_CHIP_PAGE_SIZE_BYTES) {
+            rx_buffer[i] = (uint8_t)~page[col];
+        }
+        else {
+            // Past the data area is the spare area, where only the bad block marker is stored.
+            rx_buffer[i] = ((col == FLASH_CHIP_PAGE_SIZE_BYTES) && has_bad_block_marker) ? 0x00 : 0xFF;
+        }
+    }
+    return FLASH_ERR_OK;
+}
+
+FLASH_error_enum_t FLASH_wait_for_read_page(void) {
+    const FLASH_error_enum_t result = HOST_NAND_pending_read_result;
+    HOST_NAND_pending_read_result = FLASH_ERR_OK;
+    return result;
+}
+
+FLASH_error_enum_t FLASH_is_reachable(uint8_t chip_number) {
+    HOST_NAND_end_cache_read(chip_number);
+    return (chip_number < FLASH_NUMBER_OF_FLASH_DEVICES) ? FLASH_ERR_OK : FLASH_ERR_UNKNOWN;
+}
+
+FLASH_error_enum_t FLASH_reset(uint8_t chip_number) {
+    if (chip_number < FLASH_NUMBER_OF_FLASH_DEVICES) {
+        HOST_NAND_cache_read_active[chip_number] = 0;
+    }
+    return (chip_number < FLASH_NUMBER_OF_FLASH_DEVICES) ? FLASH_ERR_OK : FLASH_ERR_SPI_TRANSMIT_FAILED;
+}
+
+void FLASH_enable_then_disable_chip_select(uint8_t chip_number) {
+    // No chip select lines on the host.
+}
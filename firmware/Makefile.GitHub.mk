@@ -85,7 +85,8 @@ AS_DEFS =
 # C defines
 C_DEFS =  \
 -DUSE_HAL_DRIVER \
--DSTM32L4R5xx
+-DSTM32L4R5xx \
+-DLFS_THREADSAFE
 
 
 # AS includes
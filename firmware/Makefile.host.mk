@@ -0,0 +1,112 @@
+# Makefile.host.mk
+# Host (Linux/POSIX) simulation build of the portable firmware modules, for benchmarks and
+# debugging without the flight hardware. The SPI NAND chips are replaced by a RAM-backed emulator.
+# See `docs/Host_Simulation_Build.md`.
+#
+# Usage:
+#   make -f Makefile.host.mk
+#   ./build/host/cts1_host_sim [benchmark_name]
+
+TARGET = cts1_host_sim
+
+BUILD_DIR = build/host
+
+CC = gcc
+
+# Modules from Core which build for the host unmodified.
+# `flash_driver.c` and `flash_internal_spi.c` are replaced by `Host/Src/host_nand_emulator.c`.
+CORE_C_SOURCES = \
+Core/Src/littlefs/flash_busy_wait.c \
+Core/Src/littlefs/lfs.c \
+Core/Src/littlefs/lfs_util.c \
+Core/Src/littlefs/littlefs_driver.c \
+Core/Src/littlefs/littlefs_page_cache.c \
+Core/Src/littlefs/littlefs_dir_listing.c \
+Core/Src/littlefs/littlefs_helper.c \
+Core/Src/littlefs/littlefs_benchmark.c \
+Core/Src/littlefs/littlefs_checksums.c \
+Core/Src/littlefs/littlefs_searching.c \
+Core/Src/littlefs/littlefs_telecommands.c \
+Core/Src/telecommand_exec/telecommand_args_helpers.c \
+Core/Src/telecommand_exec/telecommand_parser.c \
+Core/Src/telecommand_exec/telecommand_executor.c \
+Core/Src/telecommand_exec/telecommand_response_store.c \
+Core/Src/telecommand_exec/agenda_from_file.c \
+Core/Src/telecommand_exec/agenda_string_arena.c \
+Core/Src/telecommands/telecommand_definitions.c \
+Core/Src/telecommands/telecommand_name_index.c \
+Core/Src/telecommands/agenda_telecommand_defs.c \
+Core/Src/telecommands/lfs_telecommand_defs.c \
+Core/Src/telecommands/lfs_search_telecommand_defs.c \
+Core/Src/telecommands/log_telecommand_defs.c \
+Core/Src/config/configuration.c \
+Core/Src/comms_drivers/bulk_file_downlink.c \
+Core/Src/log/log.c \
+Core/Src/log/log_args.c \
+Core/Src/log/log_binary.c \
+Core/Src/log/log_queue.c \
+Core/Src/log/log_sinks.c \
+Core/Src/log/lazy_file_log_sink.c \
+Core/Src/log/log_a_logging_error.c \
+Core/Src/timekeeping/timekeeping.c \
+Core/Src/uart_handler/uart_dma_ring.c \
+Core/Src/mpi/mpi_science_ring.c \
+Core/Src/mpi/mpi_frame_index.c \
+Core/Src/mpi/mpi_data_files.c \
+Core/Src/debug_tools/debug_uart.c \
+Core/Src/transforms/arrays.c \
+Core/Src/transforms/byte_transforms.c \
+Core/Src/transforms/number_comparisons.c \
+Core/Src/crypto/sha256.c \
+Core/Src/crypto/random_number_generator.c \
+Core/Src/compression/heatshrink_helpers.c \
+$(wildcard Core/Src/compression/heatshrink_lib/*.c) \
+Core/Src/comms_drivers/comms_tx.c \
+Core/Src/comms_drivers/ax100_tx.c \
+Core/Src/comms_drivers/ax100_tx_pacing.c
+
+HOST_C_SOURCES = $(wildcard Host/Src/*.c) $(wildcard Host/Src/benchmarks/*.c)
+
+C_SOURCES = $(CORE_C_SOURCES) $(HOST_C_SOURCES)
+
+# Host/Inc must come before Core/Inc, so that the HAL/RTOS stand-ins are found first.
+C_INCLUDES = \
+-IHost/Inc \
+-ICore/Inc
+
+C_DEFS = -DCTS1_HOST_SIMULATION
+
+# The firmware uses `%lu` for `uint32_t` (which is `unsigned long` on the ARM target).
+CFLAGS = $(C_DEFS) $(C_INCLUDES) -O2 -g -Wall -Wextra -Wno-unused-parameter -Wno-format -std=gnu11
+CFLAGS += -MMD -MP -MF"$(@:%.o=%.d)"
+
+LDFLAGS = -lpthread -lm
+
+OBJECTS = $(addprefix $(BUILD_DIR)/,$(C_SOURCES:.c=.o))
+
+all: $(BUILD_DIR)/$(TARGET)
+
+$(BUILD_DIR)/%.o: %.c Makefile.host.mk
+	@mkdir -p $(dir $@)
+	$(CC) -c $(CFLAGS) $< -o $@
+
+# Telecommand functions from modules outside the host build are linked to a stub which responds
+# with an error, so that the real `TCMD_telecommand_definitions` table can be used unmodified.
+TCMDEXEC_DEFSYM_FILE = $(BUILD_DIR)/tcmdexec_unavailable.ldargs
+
+$(TCMDEXEC_DEFSYM_FILE): $(OBJECTS)
+	nm $(OBJECTS) | awk ' \
+		$$1 == "U" && $$2 ~ /^TCMDEXEC_/ { undefined[$$2] = 1 } \
+		NF == 3 && $$3 ~ /^TCMDEXEC_/ { defined[$$3] = 1 } \
+		END { for (s in undefined) if (!(s in defined)) print "-Wl,--defsym=" s "=HOST_tcmdexec_unavailable" } \
+	' > $@
+
+$(BUILD_DIR)/$(TARGET): $(OBJECTS) $(TCMDEXEC_DEFSYM_FILE) Makefile.host.mk
+	$(CC) $(OBJECTS) @$(TCMDEXEC_DEFSYM_FILE) $(LDFLAGS) -o $@
+
+clean:
+	-rm -fR $(BUILD_DIR)
+
+-include $(OBJECTS:.o=.d)
+
+.PHONY: all clean
@@ -0,0 +1,88 @@
+"""Check that the sorted telecommand name index matches the `telecommand_definitions.c` table.
+
+Run with `--fix` to regenerate `telecommand_name_index.c` after adding, removing, renaming, or
+reordering telecommands.
+"""
+
+import re
+import sys
+from pathlib import Path
+
+import git
+from loguru import logger
+
+GIT_REPO_ROOT_PATH = Path(git.Repo(__file__, search_parent_directories=True).working_tree_dir)
+TCMD_TABLE_FILE_PATH = "firmware/Core/Src/telecommands/telecommand_definitions.c"
+NAME_INDEX_FILE_PATH = "firmware/Core/Src/telecommands/telecommand_name_index.c"
+
+
+def get_tcmd_name_list() -> list[str]:
+    """Get the list of telecommand names, in the order of the `TCMD_telecommand_definitions`."""
+    # Matches like: `.tcmd_name = "hello_world",` (but not in `//` comments).
+    pattern = re.compile(r'^\s*\.tcmd_name = "(?P<name>\w+)",')
+
+    file_path = GIT_REPO_ROOT_PATH / TCMD_TABLE_FILE_PATH
+    with file_path.open("r") as f:
+        return [match.group("name") for line in f if (match := pattern.search(line))]
+
+
+def generate_name_index_file_contents(tcmd_name_list: list[str]) -> str:
+    """Generate `telecommand_name_index.c`: table indices sorted by name (like `strcmp`)."""
+    sorted_idx_list = sorted(
+        range(len(tcmd_name_list)), key=lambda idx: tcmd_name_list[idx].encode("ascii")
+    )
+    lines = [
+        "// GENERATED FILE - DO NOT EDIT.",
+        "// Regenerate with: `python firmware_checks/_04_check_tcmd_name_index.py --fix`",
+        "",
+        '#include "telecommand_exec/telecommand_definitions.h"',
+        "",
+        "// extern",
+        "const int16_t TCMD_telecommand_name_sorted_idx_count = "
+        f"{len(sorted_idx_list)};",
+        "",
+        "/// @brief Indices into `TCMD_telecommand_definitions`, sorted by `tcmd_name` "
+        "(like `strcmp`).",
+        "// extern",
+        "const uint8_t TCMD_telecommand_name_sorted_idx[] = {",
+        *[f"    {idx}, // {tcmd_name_list[idx]}" for idx in sorted_idx_list],
+        "};",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def validate_tcmd_name_index(fix: bool) -> None:
+    """Check (or regenerate) the sorted telecommand name index."""
+    tcmd_name_list = get_tcmd_name_list()
+    logger.info(f"Found {len(tcmd_name_list)} telecommand names in the table.")
+
+    if len(set(tcmd_name_list)) != len(tcmd_name_list):
+        duplicate_names = {x for x in tcmd_name_list if tcmd_name_list.count(x) > 1}
+        logger.error(f"There are duplicate telecommand names: {list(duplicate_names)}")
+        sys.exit(1)
+
+    if len(tcmd_name_list) > 256:  # noqa: PLR2004
+        logger.error("Too many telecommands for the `uint8_t` name index (and `tcmd_idx`).")
+        sys.exit(1)
+
+    expected_contents = generate_name_index_file_contents(tcmd_name_list)
+    index_file_path = GIT_REPO_ROOT_PATH / NAME_INDEX_FILE_PATH
+
+    if fix:
+        index_file_path.write_text(expected_contents)
+        logger.success(f"Wrote {NAME_INDEX_FILE_PATH}.")
+        return
+
+    if (not index_file_path.exists()) or (index_file_path.read_text() != expected_contents):
+        logger.error(
+            f"`{NAME_INDEX_FILE_PATH}` is out of sync with the telecommand table. "
+            "Regenerate it with: `python firmware_checks/_04_check_tcmd_name_index.py --fix`"
+        )
+        sys.exit(1)
+
+    logger.success("Telecommand name index is in sync with the table.")
+
+
+if __name__ == "__main__":
+    validate_tcmd_name_index(fix="--fix" in sys.argv[1:])
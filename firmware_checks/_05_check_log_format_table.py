@@ -0,0 +1,239 @@
+"""Check that the binary log format table matches the `LOG_message` calls in the firmware.
+
+Binary log records (see `firmware/Core/Src/log/log_binary.c`) hold a 32-bit ID (FNV-1a hash)
+of their format string instead of the text. The ground decoder
+(`misc_tools/binary_logs/decode_binary_logs.py`) looks the IDs up in the generated table.
+
+Run with `--fix` to regenerate the table after adding or changing log messages.
+"""
+
+import json
+import sys
+from pathlib import Path
+
+import git
+from loguru import logger
+
+GIT_REPO_ROOT_PATH = Path(git.Repo(__file__, search_parent_directories=True).working_tree_dir)
+FIRMWARE_SOURCE_DIR_PATHS = ["firmware/Core/Src", "firmware/Core/Inc"]
+FORMAT_TABLE_FILE_PATH = "misc_tools/binary_logs/log_format_table.json"
+
+# Argument index of `fmt` in `LOG_message(system, severity, sink_mask, fmt, ...)`.
+LOG_MESSAGE_FMT_ARG_INDEX = 3
+
+C_SIMPLE_ESCAPES = {
+    "n": "\n",
+    "t": "\t",
+    "r": "\r",
+    "0": "\0",
+    "\\": "\\",
+    '"': '"',
+    "'": "'",
+    "a": "\a",
+    "b": "\b",
+    "f": "\f",
+    "v": "\v",
+    "?": "?",
+}
+
+
+def fnv1a_32(data: bytes) -> int:
+    """Get the 32-bit FNV-1a hash, as `LOG_binary_format_id()`."""
+    hash_value = 2166136261
+    for byte in data:
+        hash_value ^= byte
+        hash_value = (hash_value * 16777619) & 0xFFFFFFFF
+    return hash_value
+
+
+def decode_c_string_literal_body(body: str) -> str:
+    """Decode the escapes in the body of a C string literal (without the quotes)."""
+    out: list[str] = []
+    idx = 0
+    while idx < len(body):
+        char = body[idx]
+        if char != "\\":
+            out.append(char)
+            idx += 1
+            continue
+        next_char = body[idx + 1]
+        if next_char == "x":
+            hex_digits = ""
+            idx += 2
+            while idx < len(body) and body[idx] in "0123456789abcdefABCDEF":
+                hex_digits += body[idx]
+                idx += 1
+            out.append(chr(int(hex_digits, 16)))
+        elif next_char in "01234567" and body[idx + 2 : idx + 3] in tuple("01234567"):
+            octal_digits = next_char
+            idx += 2
+            while idx < len(body) and len(octal_digits) < 3 and body[idx] in "01234567":  # noqa: PLR2004
+                octal_digits += body[idx]
+                idx += 1
+            out.append(chr(int(octal_digits, 8)))
+        else:
+            out.append(C_SIMPLE_ESCAPES[next_char])
+            idx += 2
+    return "".join(out)
+
+
+def strip_c_comments(source: str) -> str:
+    """Replace comments with spaces, leaving string and character literals alone."""
+    out: list[str] = []
+    idx = 0
+    while idx < len(source):
+        if source.startswith("//", idx):
+            end = source.find("\n", idx)
+            idx = len(source) if end == -1 else end
+        elif source.startswith("/*", idx):
+            end = source.find("*/", idx + 2)
+            idx = len(source) if end == -1 else end + 2
+            out.append(" ")
+        elif source[idx] in "\"'":
+            quote = source[idx]
+            end = idx + 1
+            while source[end] != quote:
+                end += 2 if source[end] == "\\" else 1
+            out.append(source[idx : end + 1])
+            idx = end + 1
+        else:
+            out.append(source[idx])
+            idx += 1
+    return "".join(out)
+
+
+def split_call_args(source: str, open_paren_idx: int) -> list[str]:
+    """Split the arguments of the call whose `(` is at `open_paren_idx` (top-level commas only)."""
+    args: list[str] = []
+    depth = 0
+    current: list[str] = []
+    idx = open_paren_idx
+    while True:
+        char = source[idx]
+        if char in "\"'":
+            end = idx + 1
+            while source[end] != char:
+                end += 2 if source[end] == "\\" else 1
+            current.append(source[idx : end + 1])
+            idx = end + 1
+            continue
+        if char in "([{":
+            depth += 1
+            if depth == 1:
+                idx += 1
+                continue
+        elif char in ")]}":
+            depth -= 1
+            if depth == 0:
+                args.append("".join(current).strip())
+                return args
+        elif char == "," and depth == 1:
+            args.append("".join(current).strip())
+            current = []
+            idx += 1
+            continue
+        current.append(char)
+        idx += 1
+
+
+def parse_string_literal_concatenation(arg: str) -> str | None:
+    """Get the value of an argument made only of adjacent string literals, or None."""
+    parts: list[str] = []
+    idx = 0
+    while idx < len(arg):
+        if arg[idx].isspace():
+            idx += 1
+            continue
+        if arg[idx] != '"':
+            return None
+        end = idx + 1
+        while arg[end] != '"':
+            end += 2 if arg[end] == "\\" else 1
+        parts.append(decode_c_string_literal_body(arg[idx + 1 : end]))
+        idx = end + 1
+    return "".join(parts) if parts else None
+
+
+def get_log_format_strings() -> tuple[set[str], list[str]]:
+    """Get the format strings of every `LOG_message` call, and the call sites which are not literals."""
+    format_strings: set[str] = set()
+    non_literal_call_sites: list[str] = []
+
+    for source_dir in FIRMWARE_SOURCE_DIR_PATHS:
+        for file_path in sorted((GIT_REPO_ROOT_PATH / source_dir).rglob("*.[ch]")):
+            source = strip_c_comments(file_path.read_text(encoding="utf-8", errors="replace"))
+            search_start = 0
+            while (call_idx := source.find("LOG_message(", search_start)) != -1:
+                search_start = call_idx + 1
+                # Skip other identifiers ending in `LOG_message`, and the definition/declaration.
+                if call_idx > 0 and (source[call_idx - 1].isalnum() or source[call_idx - 1] == "_"):
+                    continue
+                args = split_call_args(source, call_idx + len("LOG_message"))
+                if len(args) <= LOG_MESSAGE_FMT_ARG_INDEX or args[0].startswith("LOG_system_enum_t"):
+                    continue
+
+                fmt = parse_string_literal_concatenation(args[LOG_MESSAGE_FMT_ARG_INDEX])
+                if fmt is None:
+                    line_num = source.count("\n", 0, call_idx) + 1
+                    non_literal_call_sites.append(
+                        f"{file_path.relative_to(GIT_REPO_ROOT_PATH)}:{line_num}: "
+                        f"{args[LOG_MESSAGE_FMT_ARG_INDEX]}"
+                    )
+                    continue
+                format_strings.add(fmt)
+
+    return format_strings, non_literal_call_sites
+
+
+def generate_format_table_contents(format_strings: set[str]) -> str:
+    """Generate the table: format ID (as 8 hex digits) -> format string, sorted by ID."""
+    table = {
+        f"{fnv1a_32(fmt.encode('utf-8')):08x}": fmt
+        for fmt in sorted(format_strings, key=lambda fmt: fnv1a_32(fmt.encode("utf-8")))
+    }
+    return json.dumps(table, indent=2, ensure_ascii=False) + "\n"
+
+
+def validate_log_format_table(fix: bool) -> None:
+    """Check (or regenerate) the binary log format table."""
+    format_strings, non_literal_call_sites = get_log_format_strings()
+    logger.info(f"Found {len(format_strings)} distinct LOG_message format strings.")
+
+    # Messages with a non-literal format are still logged, but can't be decoded on the ground.
+    for call_site in non_literal_call_sites:
+        logger.warning(f"LOG_message format is not a string literal: {call_site}")
+
+    format_ids: dict[int, str] = {}
+    for fmt in format_strings:
+        format_id = fnv1a_32(fmt.encode("utf-8"))
+        if format_id in format_ids:
+            logger.error(
+                f"Format ID collision (0x{format_id:08x}): {format_ids[format_id]!r} and {fmt!r}. "
+                "Reword one of the messages."
+            )
+            sys.exit(1)
+        format_ids[format_id] = fmt
+
+    expected_contents = generate_format_table_contents(format_strings)
+    table_file_path = GIT_REPO_ROOT_PATH / FORMAT_TABLE_FILE_PATH
+
+    if fix:
+        table_file_path.parent.mkdir(parents=True, exist_ok=True)
+        table_file_path.write_text(expected_contents, encoding="utf-8")
+        logger.success(f"Wrote {FORMAT_TABLE_FILE_PATH}.")
+        return
+
+    if (not table_file_path.exists()) or (
+        table_file_path.read_text(encoding="utf-8") != expected_contents
+    ):
+        logger.error(
+            f"`{FORMAT_TABLE_FILE_PATH}` is out of sync with the LOG_message calls. "
+            "Regenerate it with: `python firmware_checks/_05_check_log_format_table.py --fix`"
+        )
+        sys.exit(1)
+
+    logger.success("Binary log format table is in sync with the LOG_message calls.")
+
+
+if __name__ == "__main__":
+    validate_log_format_table(fix="--fix" in sys.argv[1:])
@@ -0,0 +1,257 @@
+# /// script
+# requires-python = ">=3.10"
+# dependencies = [
+#   "loguru",
+# ]
+# ///
+
+"""Decode binary log records (`.blog` files, or UHF binary log packets) into text log lines.
+
+The record layout is documented in `firmware/Core/Src/log/log_binary.c`. Format strings are
+looked up by ID in `log_format_table.json`, which is generated from the firmware source with:
+`python firmware_checks/_05_check_log_format_table.py --fix`
+
+Use the table generated from the same firmware version as the satellite runs; records whose
+format ID is missing are printed as hex.
+
+Examples:
+    uv run decode_binary_logs.py 2026-10-17T120000.blog
+    uv run decode_binary_logs.py --hex --skip-bytes 5 radio_packets.txt
+"""
+
+import argparse
+import datetime
+import json
+import re
+import struct
+import sys
+from collections.abc import Iterator
+from pathlib import Path
+
+from loguru import logger
+
+DEFAULT_FORMAT_TABLE_PATH = Path(__file__).parent / "log_format_table.json"
+
+RECORD_FIXED_HEADER_LENGTH = 7
+
+# Same order as the enums in `log.h` and `timekeeping.h` (indexed by bit number / value).
+LOG_SYSTEM_NAMES = [
+    "OBC", "RADIO", "UART", "GNSS", "MPI", "EPS", "BOOM", "ADCS",
+    "LFS", "FLASH", "ANTS", "LOG", "TCMD", "TEST", "UNK",
+]  # fmt: skip
+LOG_SEVERITY_NAMES = ["DEBUG", "INFO", "WARN", "ERR", "CRIT"]
+LOG_CONTEXT_CHARS = ["A", "T", "S"]
+TIME_SYNC_SOURCE_CHARS = ["N", "G", "P", "T", "C", "E"]
+
+# One printf conversion, as walked by `LOG_args_next_conversion()`.
+PRINTF_CONVERSION_PATTERN = re.compile(
+    r"%(?P<flags>[-+ #0']*)(?P<width>\*|\d+)?(?:\.(?P<precision>\*|\d*))?"
+    r"(?P<length>hh|h|ll|l|j|z|t|L)?(?P<conversion>.?)",
+    re.DOTALL,
+)
+
+
+class RecordDecodeError(Exception):
+    """Raised when a record is truncated or corrupt."""
+
+
+class RecordReader:
+    """Reads the fields of one record."""
+
+    def __init__(self, data: bytes) -> None:
+        self.data = data
+        self.index = RECORD_FIXED_HEADER_LENGTH
+
+    def varint(self) -> int:
+        value = 0
+        for shift in range(0, 70, 7):
+            if self.index >= len(self.data):
+                raise RecordDecodeError("varint runs past the end of the record")
+            byte = self.data[self.index]
+            self.index += 1
+            value |= (byte & 0x7F) << shift
+            if not byte & 0x80:
+                return value
+        raise RecordDecodeError("varint is too long")
+
+    def signed_varint(self) -> int:
+        zigzag = self.varint()
+        return (zigzag >> 1) ^ -(zigzag & 1)
+
+    def double(self) -> float:
+        if self.index + 8 > len(self.data):
+            raise RecordDecodeError("double runs past the end of the record")
+        (value,) = struct.unpack_from("<d", self.data, self.index)
+        self.index += 8
+        return value
+
+    def string(self) -> str:
+        length = self.varint()
+        if self.index + length > len(self.data):
+            raise RecordDecodeError("string runs past the end of the record")
+        value = self.data[self.index : self.index + length].decode("utf-8", errors="replace")
+        self.index += length
+        return value
+
+
+def render_message(fmt: str, reader: RecordReader) -> str:
+    """Render the message from the format string and the record's arguments, like `printf`."""
+    out: list[str] = []
+    last_end = 0
+    for match in PRINTF_CONVERSION_PATTERN.finditer(fmt):
+        out.append(fmt[last_end : match.start()])
+        last_end = match.end()
+        conversion = match.group("conversion")
+        if conversion == "%":
+            out.append("%")
+            continue
+
+        width = match.group("width")
+        precision = match.group("precision")
+        if width == "*":
+            width = str(reader.signed_varint())
+        if precision == "*":
+            precision = str(reader.signed_varint())
+            # A negative precision is taken as if omitted.
+            precision = None if int(precision) < 0 else precision
+
+        # Python's `%` has no length modifiers, and no `'` flag.
+        spec = "%" + match.group("flags").replace("'", "")
+        if width is not None:
+            # A negative width is the `-` flag.
+            spec += ("-" + width.lstrip("-")) if width.startswith("-") else width
+        if precision is not None:
+            spec += "." + (precision or "0")
+
+        if conversion in "di":
+            out.append((spec + "d") % reader.signed_varint())
+        elif conversion in "uoxX":
+            value = reader.varint()
+            out.append((spec + ("d" if conversion == "u" else conversion)) % value)
+        elif conversion == "c":
+            out.append((spec + "c") % chr(reader.signed_varint() & 0xFF))
+        elif conversion in "fFeEgG":
+            out.append((spec + conversion) % reader.double())
+        elif conversion in "aA":
+            out.append(reader.double().hex())
+        elif conversion == "p":
+            out.append(f"0x{reader.varint():x}")
+        elif conversion == "s":
+            out.append((spec + "s") % reader.string())
+        else:
+            raise RecordDecodeError(f"unsupported conversion in format: {match.group(0)!r}")
+    out.append(fmt[last_end:])
+    return "".join(out)
+
+
+def format_timestamp(resync_ms: int, ms_since_resync: int, sync_source_char: str, utc: bool) -> str:
+    """Format the timestamp like `LOG_timestamp_prefix_format` 0 (default) or 1 (`utc`)."""
+    if not utc:
+        return f"{resync_ms:013d}+{ms_since_resync:010d}_{sync_source_char}"
+    timestamp = datetime.datetime.fromtimestamp(
+        (resync_ms + ms_since_resync) / 1000, tz=datetime.timezone.utc
+    )
+    return timestamp.strftime("%Y-%m-%dT%H%M%S.") + f"{timestamp.microsecond // 1000:03d}Z_{sync_source_char}"
+
+
+def decode_record(record: bytes, format_table: dict[int, str], utc: bool) -> str:
+    """Decode one record (starting at its length byte) into a log line, without the newline."""
+    format_id = int.from_bytes(record[1:5], "little")
+    system_byte = record[5]
+    system_name = LOG_SYSTEM_NAMES[min(system_byte & 0x0F, len(LOG_SYSTEM_NAMES) - 1)]
+    severity_num = (system_byte >> 4) & 0x07
+    severity_name = LOG_SEVERITY_NAMES[severity_num] if severity_num < len(LOG_SEVERITY_NAMES) else "UNK"
+    is_preformatted = bool(system_byte & 0x80)
+    sync_source_num = record[6] & 0x07
+    sync_source_char = (
+        TIME_SYNC_SOURCE_CHARS[sync_source_num] if sync_source_num < len(TIME_SYNC_SOURCE_CHARS) else "?"
+    )
+    context_num = (record[6] >> 3) & 0x03
+    context_char = LOG_CONTEXT_CHARS[context_num] if context_num < len(LOG_CONTEXT_CHARS) else "?"
+
+    reader = RecordReader(record)
+    resync_ms = reader.varint()
+    ms_since_resync = reader.varint()
+    prefix = (
+        f"{format_timestamp(resync_ms, ms_since_resync, sync_source_char, utc)} "
+        f"[{context_char}:{system_name}:{severity_name}]: "
+    )
+
+    if is_preformatted:
+        return prefix + reader.string()
+    fmt = format_table.get(format_id)
+    if fmt is None:
+        return prefix + f"<unknown format 0x{format_id:08x}> {record[reader.index :].hex(' ')}"
+    return prefix + render_message(fmt, reader)
+
+
+def iter_records_from_blog(data: bytes) -> Iterator[bytes]:
+    """Split a `.blog` file into records (each starts with its length byte)."""
+    index = 0
+    while index < len(data):
+        record_len = data[index] + 1
+        if index + record_len > len(data):
+            logger.warning(f"Truncated record at offset {index} (file ends mid-record).")
+            return
+        yield data[index : index + record_len]
+        index += record_len
+
+
+def iter_records_from_hex_lines(text: str, skip_bytes: int) -> Iterator[bytes]:
+    """Get one record per line of hex (e.g., UHF packets, after skipping their headers)."""
+    for line in text.splitlines():
+        hex_str = re.sub(r"[^0-9a-fA-F]", "", line)
+        if not hex_str:
+            continue
+        packet = bytes.fromhex(hex_str)[skip_bytes:]
+        if len(packet) < RECORD_FIXED_HEADER_LENGTH:
+            logger.warning(f"Skipping short line: {line!r}")
+            continue
+        yield packet[: packet[0] + 1]
+
+
+def load_format_table(path: Path) -> dict[int, str]:
+    """Load the format table generated by `_05_check_log_format_table.py`."""
+    with path.open("r", encoding="utf-8") as f:
+        return {int(format_id, 16): fmt for format_id, fmt in json.load(f).items()}
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input_path", type=Path, help="A `.blog` file, or a text file of hex records")
+    parser.add_argument(
+        "--format-table",
+        type=Path,
+        default=DEFAULT_FORMAT_TABLE_PATH,
+        help="Format table JSON (default: the one next to this script)",
+    )
+    parser.add_argument("--hex", action="store_true", help="Input is one hex record/packet per line")
+    parser.add_argument(
+        "--skip-bytes",
+        type=int,
+        default=0,
+        help="With --hex, bytes to skip before each record (5 for CSP header + packet type)",
+    )
+    parser.add_argument("--utc", action="store_true", help="Print UTC datetimes instead of resync+offset")
+    args = parser.parse_args()
+
+    format_table = load_format_table(args.format_table)
+    if args.hex:
+        records = iter_records_from_hex_lines(args.input_path.read_text(), args.skip_bytes)
+    else:
+        records = iter_records_from_blog(args.input_path.read_bytes())
+
+    error_count = 0
+    for record in records:
+        try:
+            print(decode_record(record, format_table, args.utc))
+        except (RecordDecodeError, IndexError, TypeError, ValueError) as e:
+            logger.warning(f"Could not decode record {record.hex(' ')}: {e}")
+            error_count += 1
+
+    if error_count > 0:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -82,11 +82,6 @@ def send_file_over_uart(
             ser, "CTS1+config_set_int_var(AX100_enable_downlink_inhibited_uart_logs,0)!"
         )
         _send_simple_slow_command(ser, "CTS1+config_set_int_var(TASK_heartbeat_period_ms,0)!")
-        _send_simple_slow_command(
-            # Equivalent on-orbit: TCMD_handle_ax100_tcmds_interval_ms
-            ser,
-            "CTS1+config_set_int_var(TCMD_handle_umbilical_tcmds_interval_ms,20)!",
-        )
         _send_simple_slow_command(ser, "CTS1+log_set_sink_enabled_state(4,0)!")  # Disable UART.
 
         with (
@@ -1,5 +1,7 @@
+import base64
 import hashlib
 import re
+import struct
 import sys
 from pathlib import Path
 
@@ -28,34 +30,179 @@ def extract_radio_packets_from_logs(packet_type: int, log_file_path: Path) -> li
     return packets
 
 
-def reconstruct_bulk_downlinked_file(log_file_path: Path, output_file_path: Path) -> None:
+# Data bytes per bulk downlink packet (`COMMS_BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET`).
+BULK_DOWNLINK_PACKET_DATA_BYTES = 195
+
+# Max bitmap bytes per `comms_bulk_file_downlink_nack` telecommand (fits in a 255-char telecommand).
+NACK_BITMAP_MAX_BYTES = 150
+
+
+def reconstruct_bulk_downlinked_file(log_file_path: Path, output_file_path: Path) -> list[int]:
     """Reconstructs a bulk downlinked file from the log file.
 
+    Packets are placed at their file offsets, so resent packets (selective repeat) can arrive in any
+    order. The first packet of the transfer must have been received (its offset is the start offset).
+
     Args:
         log_file_path: Path to the log file.
         output_file_path: Path to save the reconstructed file.
+
+    Returns:
+        The sequence numbers of the missing packets (first packet is 1), up to the last one received.
     """
-    byte_offset_list: list[int] = []
-    with open(output_file_path, "wb") as output_file:
-        for packet in extract_radio_packets_from_logs(0x10, log_file_path):
-            # Read the offset in the file from bytes 5,6,7,8.
-            offset = int.from_bytes(packet[5:9], "little")
-            byte_offset_list.append(offset)
+    chunks: dict[int, bytes] = {}
+    for packet in extract_radio_packets_from_logs(0x10, log_file_path):
+        # Read the offset in the file from bytes 5,6,7,8.
+        offset = int.from_bytes(packet[5:9], "little")
+        if offset in chunks:
+            print(f"Note: Duplicate packet at offset {offset} (resent).")
+        chunks[offset] = packet[9:]
 
-            # Write the packet to the output file.
-            output_file.write(packet[9:])
+    if not chunks:
+        print("Warning: No bulk downlink packets found.")
+        return []
 
-            if len(byte_offset_list) == 1:
-                print(f"First packet data: offset_bytes={offset}, length_bytes={len(packet[9:])}")
+    start_offset = min(chunks)
+    print(f"First packet data: offset_bytes={start_offset}, length_bytes={len(chunks[start_offset])}")
+    received_seq_nums = {
+        (offset - start_offset) // BULK_DOWNLINK_PACKET_DATA_BYTES + 1 for offset in chunks
+    }
+    missing_seq_nums = [
+        seq_num for seq_num in range(1, max(received_seq_nums) + 1) if seq_num not in received_seq_nums
+    ]
 
-    # Check if all packets are present
-    if len(byte_offset_list) != len(set(byte_offset_list)):
-        print("Warning: Duplicate packet byte offsets found.")
+    with open(output_file_path, "wb") as output_file:
+        for offset in sorted(chunks):
+            output_file.seek(offset - start_offset)
+            output_file.write(chunks[offset])
 
-    if byte_offset_list != sorted(byte_offset_list):
-        print("Warning: Packet byte offsets are not in order.")
+    if missing_seq_nums:
+        print(f"Warning: {len(missing_seq_nums)} packets missing (zero-filled): {missing_seq_nums}")
 
     # TODO: Validate the entire file size.
+    return missing_seq_nums
+
+
+def make_nack_telecommands(transfer_id: int, missing_seq_nums: list[int]) -> list[str]:
+    """Makes the `comms_bulk_file_downlink_nack` telecommands to request the missing packets.
+
+    Args:
+        transfer_id: The transfer ID, from the `comms_bulk_file_downlink_start` response.
+        missing_seq_nums: The sequence numbers of the missing packets.
+
+    Returns:
+        The telecommand strings.
+    """
+    telecommands: list[str] = []
+    remaining = sorted(missing_seq_nums)
+    while remaining:
+        first_seq_num = remaining[0]
+        bitmap = bytearray(NACK_BITMAP_MAX_BYTES)
+        used_len = 0
+        while remaining and remaining[0] - first_seq_num < NACK_BITMAP_MAX_BYTES * 8:
+            bit_index = remaining.pop(0) - first_seq_num
+            bitmap[bit_index // 8] |= 1 << (bit_index % 8)
+            used_len = bit_index // 8 + 1
+        bitmap_base64 = base64.b64encode(bytes(bitmap[:used_len])).decode("ascii")
+        telecommands.append(
+            f"CTS1+comms_bulk_file_downlink_nack({transfer_id},{first_seq_num},{bitmap_base64})!"
+        )
+    return telecommands
+
+
+# Header at the start of the compressed stream. See `COMMS_bulk_file_downlink_compressed_header_t`.
+COMPRESSED_HEADER_FORMAT = "<2sBBBBII"
+COMPRESSED_HEADER_LENGTH = struct.calcsize(COMPRESSED_HEADER_FORMAT)
+
+
+def heatshrink_decompress(data: bytes, window_sz2: int, lookahead_sz2: int) -> bytes:
+    """Decompresses a heatshrink stream (as from `heatshrink_encoder`, without index limits).
+
+    Args:
+        data: The compressed stream.
+        window_sz2: The window size, as a power of two (the encoder's -w arg).
+        lookahead_sz2: The lookahead size, as a power of two (the encoder's -l arg).
+
+    Returns:
+        The decompressed bytes.
+    """
+    out = bytearray()
+    bit_index = 0
+    total_bits = len(data) * 8
+
+    def read_bits(count: int) -> int | None:
+        nonlocal bit_index
+        if bit_index + count > total_bits:
+            return None
+        value = 0
+        for _ in range(count):
+            byte = data[bit_index // 8]
+            value = (value << 1) | ((byte >> (7 - (bit_index % 8))) & 1)
+            bit_index += 1
+        return value
+
+    while True:
+        tag = read_bits(1)
+        if tag is None:
+            break
+        if tag == 1:
+            literal = read_bits(8)
+            if literal is None:
+                break
+            out.append(literal)
+            continue
+        backref_index = read_bits(window_sz2)
+        backref_count = read_bits(lookahead_sz2)
+        if backref_index is None or backref_count is None:
+            break
+        backref_index += 1
+        if backref_index > len(out):
+            raise ValueError(f"Back-reference before the start of the output (at {len(out)} bytes).")
+        for _ in range(backref_count + 1):
+            out.append(out[-backref_index])
+    return bytes(out)
+
+
+def reconstruct_compressed_bulk_downlinked_file(log_file_path: Path, output_file_path: Path) -> None:
+    """Reconstructs a file sent with `comms_bulk_file_downlink_start_compressed` from the log file.
+
+    Args:
+        log_file_path: Path to the log file.
+        output_file_path: Path to save the decompressed file.
+    """
+    # Place each packet at its offset in the compressed stream (retransmits overwrite).
+    stream_chunks: dict[int, bytes] = {}
+    for packet in extract_radio_packets_from_logs(0x11, log_file_path):
+        offset = int.from_bytes(packet[5:9], "little")
+        stream_chunks[offset] = packet[9:]
+
+    stream = bytearray()
+    for offset in sorted(stream_chunks):
+        if offset != len(stream):
+            print(f"Warning: Missing compressed data at stream offsets {len(stream)} to {offset}.")
+            break
+        stream += stream_chunks[offset]
+
+    if len(stream) < COMPRESSED_HEADER_LENGTH:
+        print("Error: No compressed stream header found.")
+        sys.exit(1)
+
+    magic, version, window_sz2, lookahead_sz2, _reserved, start_offset, byte_count = struct.unpack(
+        COMPRESSED_HEADER_FORMAT, stream[:COMPRESSED_HEADER_LENGTH]
+    )
+    if magic != b"HS" or version != 1:
+        print(f"Error: Unknown compressed stream header: magic={magic!r}, version={version}")
+        sys.exit(1)
+    print(
+        f"Compressed stream: window_sz2={window_sz2}, lookahead_sz2={lookahead_sz2}, "
+        f"file_offset={start_offset}, max_bytes={byte_count}, compressed_bytes={len(stream):,}"
+    )
+
+    decompressed = heatshrink_decompress(
+        bytes(stream[COMPRESSED_HEADER_LENGTH:]), window_sz2, lookahead_sz2
+    )
+    with open(output_file_path, "wb") as output_file:
+        output_file.write(decompressed)
 
 
 def calculate_sha256(file_path: Path) -> str:
@@ -75,9 +222,10 @@ def calculate_sha256(file_path: Path) -> str:
 
 
 def main() -> None:
-    if len(sys.argv) != 3:
+    if len(sys.argv) not in (3, 4):
         print(
-            "Usage: python extract_radio_packets_from_logs.py <log_file_path> <output_file_path>"
+            "Usage: python extract_radio_packets_from_logs.py <log_file_path> <output_file_path> "
+            "[transfer_id (to print NACK telecommands for missing packets)]"
         )
         sys.exit(1)
 
@@ -88,7 +236,14 @@ def main() -> None:
         print(f"Log file does not exist: {log_file_path}")
         sys.exit(1)
 
-    reconstruct_bulk_downlinked_file(log_file_path, output_file_path)
+    if extract_radio_packets_from_logs(0x11, log_file_path):
+        reconstruct_compressed_bulk_downlinked_file(log_file_path, output_file_path)
+    else:
+        missing_seq_nums = reconstruct_bulk_downlinked_file(log_file_path, output_file_path)
+        if missing_seq_nums and len(sys.argv) == 4:
+            print("Uplink these to resend the missing packets:")
+            for telecommand in make_nack_telecommands(int(sys.argv[3]), missing_seq_nums):
+                print(telecommand)
     print(f"Reconstructed file saved to: {output_file_path}")
 
     print(f"Output file size: {output_file_path.stat().st_size:,} bytes")